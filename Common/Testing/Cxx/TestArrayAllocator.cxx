@@ -0,0 +1,277 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestArrayAllocator.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+#include "vtkAlignedArrayAllocator.h"
+#include "vtkArenaArrayAllocator.h"
+#include "vtkArrayAllocator.h"
+#include "vtkDoubleArray.h"
+#include "vtkFloatArray.h"
+#include "vtkHugePageArrayAllocator.h"
+#include "vtkIntArray.h"
+#include "vtkMultiThreader.h"
+#include "vtkSmartPointer.h"
+
+// Fill an array through its allocator, growing and squeezing it, and check
+// the values and the byte counts along the way.
+static int ExerciseAllocator(vtkArrayAllocator* allocator, int alignment)
+{
+  vtkTypeInt64 initialBytes = vtkArrayAllocator::GetAllocatedBytes(VTK_FLOAT);
+
+  vtkFloatArray* array = vtkFloatArray::New();
+  array->SetAllocator(allocator);
+  array->SetNumberOfComponents(3);
+  const vtkIdType numTuples = 100000;
+  for (vtkIdType i = 0; i < numTuples; ++i)
+    {
+    array->InsertNextTuple3(i, 2 * i, 3 * i);
+    }
+  if (alignment &&
+      reinterpret_cast<size_t>(array->GetPointer(0)) % alignment)
+    {
+    cerr << "Storage is not aligned on " << alignment << " bytes" << endl;
+    array->Delete();
+    return 0;
+    }
+  vtkTypeInt64 bytes = vtkArrayAllocator::GetAllocatedBytes(VTK_FLOAT);
+  vtkTypeInt64 expected = initialBytes +
+    static_cast<vtkTypeInt64>(array->GetSize()) * sizeof(float);
+  if (bytes != expected)
+    {
+    cerr << "Allocated bytes: " << bytes << ", expected " << expected << endl;
+    array->Delete();
+    return 0;
+    }
+
+  array->Squeeze();
+
+  // Switching allocator moves the storage at the next resize.
+  array->SetAllocator(0);
+  array->InsertNextTuple3(numTuples, 2 * numTuples, 3 * numTuples);
+
+  for (vtkIdType i = 0; i <= numTuples; ++i)
+    {
+    double* t = array->GetTuple3(i);
+    if (t[0] != i || t[1] != 2 * i || t[2] != 3 * i)
+      {
+      cerr << "Wrong value at tuple " << i << endl;
+      array->Delete();
+      return 0;
+      }
+    }
+
+  vtkDoubleArray* copy = vtkDoubleArray::New();
+  copy->SetAllocator(allocator);
+  copy->DeepCopy(array);
+  array->Delete();
+  if (copy->GetNumberOfTuples() != numTuples + 1 ||
+      copy->GetComponent(numTuples, 2) != 3 * numTuples)
+    {
+    cerr << "Wrong deep copy" << endl;
+    copy->Delete();
+    return 0;
+    }
+  copy->Delete();
+
+  if (vtkArrayAllocator::GetAllocatedBytes(VTK_FLOAT) != initialBytes)
+    {
+    cerr << "Storage not accounted for when released" << endl;
+    return 0;
+    }
+  return 1;
+}
+
+// Each thread creates and deletes arrays. The byte counts must come back to
+// their initial values.
+static VTK_THREAD_RETURN_TYPE CreateAndDeleteArrays(void *)
+{
+  for (int i = 0; i < 200; ++i)
+    {
+    vtkDoubleArray* array = vtkDoubleArray::New();
+    array->SetNumberOfComponents(3);
+    for (vtkIdType j = 0; j < 1000 + i; ++j)
+      {
+      array->InsertNextTuple3(j, j, j);
+      }
+    array->Delete();
+    }
+  return VTK_THREAD_RETURN_VALUE;
+}
+
+static int TestConcurrentStatistics()
+{
+  vtkTypeInt64 initialBytes = vtkArrayAllocator::GetAllocatedBytes(VTK_DOUBLE);
+  vtkMultiThreader* threader = vtkMultiThreader::New();
+  threader->SetSingleMethod(CreateAndDeleteArrays, 0);
+  threader->SingleMethodExecute();
+  threader->Delete();
+  if (vtkArrayAllocator::GetAllocatedBytes(VTK_DOUBLE) != initialBytes)
+    {
+    cerr << "Concurrent allocations were not all accounted for" << endl;
+    return 0;
+    }
+  return 1;
+}
+
+// Storage acquired while the statistics are off must not be subtracted
+// when it is released, and counted storage must be subtracted even if the
+// statistics were turned off in the meantime.
+static int TestStatisticsToggle()
+{
+  vtkTypeInt64 initialBytes = vtkArrayAllocator::GetAllocatedBytes(VTK_INT);
+
+  vtkArrayAllocator::AllocationStatisticsOff();
+  vtkIntArray* uncounted = vtkIntArray::New();
+  uncounted->SetNumberOfValues(1000);
+  vtkArrayAllocator::AllocationStatisticsOn();
+  uncounted->SetNumberOfValues(2000);
+  vtkTypeInt64 bytes = vtkArrayAllocator::GetAllocatedBytes(VTK_INT);
+  uncounted->Delete();
+  if (vtkArrayAllocator::GetAllocatedBytes(VTK_INT) != initialBytes ||
+      bytes != initialBytes + 2000 * static_cast<vtkTypeInt64>(sizeof(int)))
+    {
+    cerr << "Storage acquired without statistics was miscounted" << endl;
+    return 0;
+    }
+
+  vtkIntArray* counted = vtkIntArray::New();
+  counted->SetNumberOfValues(1000);
+  vtkArrayAllocator::AllocationStatisticsOff();
+  counted->Delete();
+  vtkArrayAllocator::AllocationStatisticsOn();
+  if (vtkArrayAllocator::GetAllocatedBytes(VTK_INT) != initialBytes)
+    {
+    cerr << "Counted storage released without statistics was not "
+         << "subtracted" << endl;
+    return 0;
+    }
+  return 1;
+}
+
+static int TestAllocators()
+{
+  if (!TestConcurrentStatistics() || !TestStatisticsToggle())
+    {
+    return EXIT_FAILURE;
+    }
+
+  vtkSmartPointer<vtkArrayAllocator> plain =
+    vtkSmartPointer<vtkArrayAllocator>::New();
+  if (!ExerciseAllocator(plain, 0))
+    {
+    cerr << "vtkArrayAllocator failed" << endl;
+    return EXIT_FAILURE;
+    }
+
+  vtkSmartPointer<vtkAlignedArrayAllocator> aligned =
+    vtkSmartPointer<vtkAlignedArrayAllocator>::New();
+  aligned->SetAlignment(100);
+  if (aligned->GetAlignment() != 128 || !ExerciseAllocator(aligned, 128))
+    {
+    cerr << "vtkAlignedArrayAllocator failed" << endl;
+    return EXIT_FAILURE;
+    }
+
+  vtkSmartPointer<vtkHugePageArrayAllocator> hugePages =
+    vtkSmartPointer<vtkHugePageArrayAllocator>::New();
+  // Small enough for the test arrays to move between both kinds of storage.
+  hugePages->SetMinimumSize(256 << 10);
+  hugePages->SetFirstTouchNumberOfThreads(
+    vtkMultiThreader::GetGlobalDefaultNumberOfThreads());
+  if (!ExerciseAllocator(hugePages, 64) || hugePages->GetMappedBytes() != 0)
+    {
+    cerr << "vtkHugePageArrayAllocator failed" << endl;
+    return EXIT_FAILURE;
+    }
+
+  // Mapped blocks stay on huge page boundaries when they grow and move, and
+  // keep their content.
+  const size_t hugePage = static_cast<size_t>(2) << 20;
+  size_t size = 3 * hugePage;
+  char* block = static_cast<char*>(hugePages->Allocate(size));
+  for (size_t b = 0; b < 3 * hugePage; b += 4096)
+    {
+    block[b] = static_cast<char>(b >> 12);
+    }
+  for (size_t newSize = 8 * hugePage; newSize <= 64 * hugePage; newSize *= 2)
+    {
+    block = static_cast<char*>(hugePages->Reallocate(block, size, newSize));
+    size = newSize;
+    int ok = (block != 0);
+    for (size_t b = 0; ok && b < 3 * hugePage; b += 4096)
+      {
+      ok = (block[b] == static_cast<char>(b >> 12));
+      }
+    if (!ok || (hugePages->GetMappedBytes() &&
+                reinterpret_cast<size_t>(block) % hugePage))
+      {
+      cerr << "vtkHugePageArrayAllocator lost a block of " << newSize
+           << " bytes" << endl;
+      return EXIT_FAILURE;
+      }
+    }
+  hugePages->Free(block, size);
+
+  vtkSmartPointer<vtkArenaArrayAllocator> arena =
+    vtkSmartPointer<vtkArenaArrayAllocator>::New();
+  if (!ExerciseAllocator(arena, 16))
+    {
+    cerr << "vtkArenaArrayAllocator failed" << endl;
+    return EXIT_FAILURE;
+    }
+
+  // Many tiny arrays share the arena blocks.
+  vtkArrayAllocator::SetGlobalAllocator(arena);
+  vtkIntArray* tiny[100];
+  int i;
+  for (i = 0; i < 100; ++i)
+    {
+    tiny[i] = vtkIntArray::New();
+    for (int j = 0; j < 10; ++j)
+      {
+      tiny[i]->InsertNextValue(i + j);
+      }
+    }
+  vtkArrayAllocator::SetGlobalAllocator(0);
+  int ok = (arena->GetNumberOfBlocks() > 0);
+  for (i = 0; i < 100; ++i)
+    {
+    ok = ok && tiny[i]->GetAllocator() == 0 &&
+      tiny[i]->GetValue(9) == i + 9;
+    tiny[i]->Delete();
+    }
+  if (!ok)
+    {
+    cerr << "Global arena allocation failed" << endl;
+    return EXIT_FAILURE;
+    }
+
+  vtkArrayAllocator::PrintAllocationStatistics(cout);
+
+  return EXIT_SUCCESS;
+}
+
+int TestArrayAllocator(int, char *[])
+{
+  // the pages are touched, and the arrays created, on several threads
+  int defaultThreads = vtkMultiThreader::GetGlobalDefaultNumberOfThreads();
+  vtkMultiThreader::SetGlobalDefaultNumberOfThreads(4);
+  vtkArrayAllocator::AllocationStatisticsOn();
+
+  int status = TestAllocators();
+
+  vtkArrayAllocator::AllocationStatisticsOff();
+  vtkMultiThreader::SetGlobalDefaultNumberOfThreads(defaultThreads);
+
+  return status;
+}
@@ -0,0 +1,209 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestIndexedPriorityQueue.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Checks vtkIndexedPriorityQueue against a plain array of priorities, then
+// against vtkPriorityQueue on a decimation-like workload: pop the cheapest
+// item and update the priority of a few others. Both queues must pop the
+// same items in the same order.
+
+#include "vtkIndexedPriorityQueue.h"
+#include "vtkMath.h"
+#include "vtkPriorityQueue.h"
+#include "vtkSmartPointer.h"
+
+#include <vtkstd/vector>
+
+static int CheckQueue()
+{
+  const vtkIdType numIds = 5000;
+  // The priority of each id, VTK_DOUBLE_MAX when not queued.
+  vtkstd::vector<double> reference(numIds, VTK_DOUBLE_MAX);
+  vtkSmartPointer<vtkIndexedPriorityQueue> queue =
+    vtkSmartPointer<vtkIndexedPriorityQueue>::New();
+  queue->Allocate(100, 100); // grows as needed
+  vtkIdType numItems = 0;
+
+  vtkMath::RandomSeed(4321);
+  for (int step = 0; step < 50000; ++step)
+    {
+    vtkIdType id = static_cast<vtkIdType>(vtkMath::Random(0, numIds - 0.01));
+    double priority = vtkMath::Random(0.0, 100.0);
+    int op = static_cast<int>(vtkMath::Random(0, 5.99));
+    switch (op)
+      {
+      case 0:
+      case 1:
+        queue->Insert(priority, id);
+        if (reference[id] == VTK_DOUBLE_MAX)
+          {
+          reference[id] = priority;
+          ++numItems;
+          }
+        break;
+      case 2:
+        if (queue->DeleteId(id) != reference[id])
+          {
+          cerr << "DeleteId returned a wrong priority" << endl;
+          return 0;
+          }
+        numItems -= (reference[id] != VTK_DOUBLE_MAX);
+        reference[id] = VTK_DOUBLE_MAX;
+        break;
+      case 3:
+        queue->SetPriority(id, priority);
+        numItems += (reference[id] == VTK_DOUBLE_MAX);
+        reference[id] = priority;
+        break;
+      case 4:
+        if (reference[id] != VTK_DOUBLE_MAX && priority < reference[id])
+          {
+          queue->DecreasePriority(id, priority);
+          reference[id] = priority;
+          }
+        else if (reference[id] != VTK_DOUBLE_MAX)
+          {
+          queue->IncreasePriority(id, priority);
+          reference[id] = priority;
+          }
+        break;
+      case 5:
+        {
+        double popped;
+        vtkIdType top = queue->Pop(0, popped);
+        if (numItems == 0)
+          {
+          if (top >= 0)
+            {
+            cerr << "Pop from an empty queue returned " << top << endl;
+            return 0;
+            }
+          break;
+          }
+        for (vtkIdType i = 0; i < numIds; ++i)
+          {
+          if (reference[i] < popped)
+            {
+            cerr << "Pop did not return the smallest priority" << endl;
+            return 0;
+            }
+          }
+        if (top < 0 || reference[top] != popped)
+          {
+          cerr << "Pop returned a wrong item" << endl;
+          return 0;
+          }
+        reference[top] = VTK_DOUBLE_MAX;
+        --numItems;
+        }
+        break;
+      }
+    if (queue->GetNumberOfItems() != numItems ||
+        queue->GetPriority(id) != reference[id])
+      {
+      cerr << "Queue out of sync at step " << step << endl;
+      return 0;
+      }
+    }
+
+  // Reset() forgets everything.
+  queue->Reset();
+  if (queue->GetNumberOfItems() != 0 || queue->Peek() != -1 ||
+      queue->GetPriority(0) != VTK_DOUBLE_MAX)
+    {
+    cerr << "Reset failed" << endl;
+    return 0;
+    }
+  queue->Insert(1.0, 0);
+  if (queue->GetNumberOfItems() != 1)
+    {
+    cerr << "Insert after Reset failed" << endl;
+    return 0;
+    }
+  return 1;
+}
+
+// The way each queue changes the priority of an id.
+static void UpdatePriority(vtkPriorityQueue *queue, vtkIdType id,
+                           double priority)
+{
+  queue->DeleteId(id);
+  queue->Insert(priority, id);
+}
+
+static void UpdatePriority(vtkIndexedPriorityQueue *queue, vtkIdType id,
+                           double priority)
+{
+  queue->SetPriority(id, priority);
+}
+
+// Decimation-like workload: every popped item changes the priority of a
+// few other items, to a priority no lower than that of the popped item.
+// The popped ids are appended to order.
+template <class TQueue>
+void RunWorkload(TQueue *queue, vtkIdType numIds,
+                 vtkstd::vector<vtkIdType> &order)
+{
+  vtkMath::RandomSeed(1234);
+  queue->Allocate(numIds);
+  vtkIdType i;
+  for (i = 0; i < numIds; ++i)
+    {
+    queue->Insert(vtkMath::Random(0.0, 1.0), i);
+    }
+  double priority;
+  vtkIdType id;
+  while ((id = queue->Pop(0, priority)) >= 0)
+    {
+    order.push_back(id);
+    for (int k = 1; k <= 6; ++k)
+      {
+      vtkIdType other = (id + k * 7919) % numIds;
+      if (queue->GetPriority(other) == VTK_DOUBLE_MAX)
+        {
+        continue;
+        }
+      UpdatePriority(queue, other, priority + vtkMath::Random(0.0, 0.1));
+      }
+    }
+}
+
+int TestIndexedPriorityQueue(int, char *[])
+{
+  if (!CheckQueue())
+    {
+    return EXIT_FAILURE;
+    }
+
+  // The random priorities have no ties, so the pop order is unique.
+  const vtkIdType numIds = 20000;
+  vtkstd::vector<vtkIdType> binaryOrder;
+  vtkSmartPointer<vtkPriorityQueue> binary =
+    vtkSmartPointer<vtkPriorityQueue>::New();
+  RunWorkload(binary.GetPointer(), numIds, binaryOrder);
+
+  vtkstd::vector<vtkIdType> indexedOrder;
+  vtkSmartPointer<vtkIndexedPriorityQueue> indexed =
+    vtkSmartPointer<vtkIndexedPriorityQueue>::New();
+  RunWorkload(indexed.GetPointer(), numIds, indexedOrder);
+
+  if (binaryOrder.size() != static_cast<size_t>(numIds) ||
+      indexedOrder != binaryOrder)
+    {
+    cerr << "vtkIndexedPriorityQueue popped " << indexedOrder.size()
+         << " items in a different order than vtkPriorityQueue" << endl;
+    return EXIT_FAILURE;
+    }
+
+  return EXIT_SUCCESS;
+}
@@ -24,9 +24,14 @@
 // -*- c++ -*- *******************************************************
 
 #include "vtkSortDataArray.h"
+#include "vtkDoubleArray.h"
+#include "vtkIdList.h"
 #include "vtkIntArray.h"
 #include "vtkMath.h"
+#include "vtkMultiThreader.h"
+#include "vtkStringArray.h"
 #include "vtkTimerLog.h"
+#include "vtkVariant.h"
 
 #define ARRAY_SIZE (2*1024*1024)
 //  #define ARRAY_SIZE 128
@@ -36,6 +41,10 @@ int TestSortDataArray(int, char *[])
   vtkIdType i;
   vtkTimerLog *timer = vtkTimerLog::New();
 
+  // the arrays are large enough to be sorted and merged on several threads
+  int defaultThreads = vtkMultiThreader::GetGlobalDefaultNumberOfThreads();
+  vtkMultiThreader::SetGlobalDefaultNumberOfThreads(4);
+
   cout << "Building array" << endl;
   vtkIntArray *keys = vtkIntArray::New();
   keys->SetNumberOfComponents(1);
@@ -151,11 +160,102 @@ int TestSortDataArray(int, char *[])
     }
   cout << "Array consistency check finished\n" << endl;
 
+  cout << "Computing sort permutation" << endl;
+  int status = 0;
+  for (i = 0; i < ARRAY_SIZE; i++)
+    {
+    // lots of equal keys
+    keys->SetComponent(i, 0, static_cast<int>(vtkMath::Random(0, 100)));
+    }
+  saveKeys->DeepCopy(keys);
+  vtkIdList *permutation = vtkIdList::New();
+  timer->StartTimer();
+  vtkSortDataArray::GetSortPermutation(keys, permutation);
+  timer->StopTimer();
+
+  cout << "Time to compute permutation: " << timer->GetElapsedTime()
+       << " sec" << endl;
+
+  for (i = 0; i < ARRAY_SIZE-1; i++)
+    {
+    vtkIdType p0 = permutation->GetId(i);
+    vtkIdType p1 = permutation->GetId(i+1);
+    if (keys->GetValue(p0) > keys->GetValue(p1) ||
+        (keys->GetValue(p0) == keys->GetValue(p1) && p0 >= p1))
+      {
+      cout << "Permutation not a stable sort!" << endl;
+      status = 1;
+      break;
+      }
+    }
+
+  cout << "Sorting keys with several value arrays" << endl;
+  vtkDoubleArray *doubles = vtkDoubleArray::New();
+  doubles->SetNumberOfComponents(3);
+  doubles->SetNumberOfTuples(ARRAY_SIZE);
+  vtkStringArray *strings = vtkStringArray::New();
+  strings->SetNumberOfValues(ARRAY_SIZE);
+  for (i = 0; i < ARRAY_SIZE; i++)
+    {
+    doubles->SetTuple3(i, i, -i, 0.5*i);
+    strings->SetValue(i, vtkVariant(i).ToString());
+    }
+  vtkAbstractArray *valueArrays[2] = { doubles, strings };
+  timer->StartTimer();
+  vtkSortDataArray::Sort(keys, valueArrays, 2);
+  timer->StopTimer();
+
+  cout << "Time to sort arrays: " << timer->GetElapsedTime() << " sec" << endl;
+
+  for (i = 0; i < ARRAY_SIZE; i++)
+    {
+    vtkIdType p = permutation->GetId(i);
+    if (keys->GetValue(i) != saveKeys->GetValue(p) ||
+        doubles->GetComponent(i, 0) != p ||
+        doubles->GetComponent(i, 1) != -p ||
+        strings->GetValue(i) != vtkVariant(p).ToString())
+      {
+      cout << "Value arrays not consistent with the permutation!" << endl;
+      status = 1;
+      break;
+      }
+    }
+  cout << "Array consistency check finished\n" << endl;
+
+  cout << "Sorting small key/value arrays" << endl;
+  // too small to be sorted by several threads, but still stable
+  vtkIntArray *smallKeys = vtkIntArray::New();
+  vtkIntArray *smallValues = vtkIntArray::New();
+  for (i = 0; i < 1000; i++)
+    {
+    smallKeys->InsertNextValue(static_cast<int>(vtkMath::Random(0, 10)));
+    smallValues->InsertNextValue(i);
+    }
+  vtkSortDataArray::Sort(smallKeys, smallValues);
+  for (i = 0; i < 999; i++)
+    {
+    if (smallKeys->GetValue(i) > smallKeys->GetValue(i+1) ||
+        (smallKeys->GetValue(i) == smallKeys->GetValue(i+1) &&
+         smallValues->GetValue(i) >= smallValues->GetValue(i+1)))
+      {
+      cout << "Key/value sort not stable!" << endl;
+      status = 1;
+      break;
+      }
+    }
+  smallKeys->Delete();
+  smallValues->Delete();
+  cout << "Array consistency check finished\n" << endl;
+
   timer->Delete();
   keys->Delete();
   values->Delete();
   saveKeys->Delete();
   saveValues->Delete();
+  permutation->Delete();
+  doubles->Delete();
+  strings->Delete();
+  vtkMultiThreader::SetGlobalDefaultNumberOfThreads(defaultThreads);
 
-  return 0;
+  return status;
 }
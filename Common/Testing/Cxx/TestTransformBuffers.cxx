@@ -0,0 +1,178 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestTransformBuffers.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Checks that transforming whole float and double arrays gives exactly
+// the same result as transforming them one tuple at a time.
+
+#include "vtkDoubleArray.h"
+#include "vtkFloatArray.h"
+#include "vtkMath.h"
+#include "vtkMultiThreader.h"
+#include "vtkPerspectiveTransform.h"
+#include "vtkPoints.h"
+#include "vtkSmartPointer.h"
+#include "vtkTransform.h"
+
+// Large enough for the buffers to be split across threads.
+static const vtkIdType NumberOfTuples = 200000;
+
+static void FillArray(vtkDataArray* array)
+{
+  array->SetNumberOfComponents(3);
+  array->SetNumberOfTuples(NumberOfTuples);
+  for (vtkIdType i = 0; i < NumberOfTuples; ++i)
+    {
+    array->SetTuple3(i, vtkMath::Random(-10.0, 10.0),
+                     vtkMath::Random(-10.0, 10.0),
+                     vtkMath::Random(-10.0, 10.0));
+    }
+}
+
+// The output holds one tuple before the appended results.
+static int CompareArrays(vtkDataArray* expected, vtkDataArray* result,
+                         const char* what)
+{
+  if (result->GetNumberOfTuples() != expected->GetNumberOfTuples() + 1)
+    {
+    cerr << what << ": wrong number of tuples" << endl;
+    return 0;
+    }
+  for (vtkIdType i = 0; i < expected->GetNumberOfTuples(); ++i)
+    {
+    for (int c = 0; c < 3; ++c)
+      {
+      if (expected->GetComponent(i, c) != result->GetComponent(i + 1, c))
+        {
+        cerr << what << ": mismatch at tuple " << i << endl;
+        return 0;
+        }
+      }
+    }
+  return 1;
+}
+
+static int TestArrayType(int dataType)
+{
+  vtkSmartPointer<vtkTransform> transform =
+    vtkSmartPointer<vtkTransform>::New();
+  transform->Translate(1.0, -2.0, 3.0);
+  transform->RotateWXYZ(30.0, 1.0, 2.0, 3.0);
+  transform->Scale(2.0, 0.5, 1.5);
+
+  vtkSmartPointer<vtkPerspectiveTransform> perspective =
+    vtkSmartPointer<vtkPerspectiveTransform>::New();
+  perspective->Frustum(-1.0, 1.0, -1.0, 1.0, 20.0, 100.0);
+  perspective->Translate(0.5, 0.5, -50.0);
+
+  vtkSmartPointer<vtkDataArray> in;
+  in.TakeReference(vtkDataArray::CreateDataArray(dataType));
+  FillArray(in);
+  vtkSmartPointer<vtkPoints> inPts = vtkSmartPointer<vtkPoints>::New();
+  inPts->SetData(in);
+
+  vtkSmartPointer<vtkDataArray> expected;
+  expected.TakeReference(vtkDataArray::CreateDataArray(dataType));
+  expected->SetNumberOfComponents(3);
+  vtkSmartPointer<vtkDataArray> result;
+  result.TakeReference(vtkDataArray::CreateDataArray(dataType));
+  result->SetNumberOfComponents(3);
+  vtkSmartPointer<vtkPoints> outPts = vtkSmartPointer<vtkPoints>::New();
+  outPts->SetData(result);
+
+  double t[3];
+  vtkIdType i;
+
+  // points
+  for (i = 0; i < NumberOfTuples; ++i)
+    {
+    transform->TransformPoint(in->GetTuple3(i), t);
+    expected->InsertNextTuple(t);
+    }
+  result->InsertNextTuple3(0.0, 0.0, 0.0);
+  transform->TransformPoints(inPts, outPts);
+  if (!CompareArrays(expected, result, "points"))
+    {
+    return 0;
+    }
+
+  // normals
+  expected->Reset();
+  result->Reset();
+  for (i = 0; i < NumberOfTuples; ++i)
+    {
+    transform->TransformNormal(in->GetTuple3(i), t);
+    expected->InsertNextTuple(t);
+    }
+  result->InsertNextTuple3(0.0, 0.0, 0.0);
+  transform->TransformNormals(in, result);
+  if (!CompareArrays(expected, result, "normals"))
+    {
+    return 0;
+    }
+
+  // vectors
+  expected->Reset();
+  result->Reset();
+  for (i = 0; i < NumberOfTuples; ++i)
+    {
+    transform->TransformVector(in->GetTuple3(i), t);
+    expected->InsertNextTuple(t);
+    }
+  result->InsertNextTuple3(0.0, 0.0, 0.0);
+  transform->TransformVectors(in, result);
+  if (!CompareArrays(expected, result, "vectors"))
+    {
+    return 0;
+    }
+
+  // perspective points
+  expected->Reset();
+  result->Reset();
+  for (i = 0; i < NumberOfTuples; ++i)
+    {
+    perspective->TransformPoint(in->GetTuple3(i), t);
+    expected->InsertNextTuple(t);
+    }
+  result->InsertNextTuple3(0.0, 0.0, 0.0);
+  perspective->TransformPoints(inPts, outPts);
+  if (!CompareArrays(expected, result, "perspective points"))
+    {
+    return 0;
+    }
+
+  return 1;
+}
+
+int TestTransformBuffers(int, char *[])
+{
+  // the buffers are large enough to be split over the threads
+  int defaultThreads = vtkMultiThreader::GetGlobalDefaultNumberOfThreads();
+  vtkMultiThreader::SetGlobalDefaultNumberOfThreads(4);
+  vtkMath::RandomSeed(4321);
+
+  int status = 1;
+  if (!TestArrayType(VTK_FLOAT))
+    {
+    cerr << "Transforming float arrays failed." << endl;
+    status = 0;
+    }
+  if (status && !TestArrayType(VTK_DOUBLE))
+    {
+    cerr << "Transforming double arrays failed." << endl;
+    status = 0;
+    }
+
+  vtkMultiThreader::SetGlobalDefaultNumberOfThreads(defaultThreads);
+  return status ? EXIT_SUCCESS : EXIT_FAILURE;
+}
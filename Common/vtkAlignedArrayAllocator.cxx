@@ -0,0 +1,92 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkAlignedArrayAllocator.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+#include "vtkAlignedArrayAllocator.h"
+
+#include "vtkObjectFactory.h"
+
+vtkStandardNewMacro(vtkAlignedArrayAllocator);
+
+//----------------------------------------------------------------------------
+vtkAlignedArrayAllocator::vtkAlignedArrayAllocator()
+{
+  this->Alignment = 64;
+}
+
+//----------------------------------------------------------------------------
+vtkAlignedArrayAllocator::~vtkAlignedArrayAllocator()
+{
+}
+
+//----------------------------------------------------------------------------
+void vtkAlignedArrayAllocator::SetAlignment(int alignment)
+{
+  int a = static_cast<int>(sizeof(void*));
+  while (a < alignment)
+    {
+    a *= 2;
+    }
+  if (a != this->Alignment)
+    {
+    this->Alignment = a;
+    this->Modified();
+    }
+}
+
+//----------------------------------------------------------------------------
+// The block is over-allocated by Alignment bytes. The address returned by
+// malloc is stored just before the aligned address handed out, so that it
+// can be recovered by Free(). This works the same on all platforms.
+void* vtkAlignedArrayAllocator::Allocate(size_t size)
+{
+  size_t alignment = static_cast<size_t>(this->Alignment);
+  char* base = static_cast<char*>(malloc(size + alignment));
+  if (!base)
+    {
+    return 0;
+    }
+  size_t address = reinterpret_cast<size_t>(base) + alignment;
+  char* aligned = reinterpret_cast<char*>(address & ~(alignment - 1));
+  reinterpret_cast<void**>(aligned)[-1] = base;
+  return aligned;
+}
+
+//----------------------------------------------------------------------------
+void* vtkAlignedArrayAllocator::Reallocate(void* ptr, size_t oldSize,
+                                           size_t newSize)
+{
+  void* newPtr = this->Allocate(newSize);
+  if (newPtr)
+    {
+    memcpy(newPtr, ptr, oldSize < newSize ? oldSize : newSize);
+    this->Free(ptr, oldSize);
+    }
+  return newPtr;
+}
+
+//----------------------------------------------------------------------------
+void vtkAlignedArrayAllocator::Free(void* ptr, size_t)
+{
+  if (ptr)
+    {
+    free(static_cast<void**>(ptr)[-1]);
+    }
+}
+
+//----------------------------------------------------------------------------
+void vtkAlignedArrayAllocator::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os,indent);
+  os << indent << "Alignment: " << this->Alignment << "\n";
+}
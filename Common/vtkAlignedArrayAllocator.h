@@ -0,0 +1,61 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkAlignedArrayAllocator.h
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// .NAME vtkAlignedArrayAllocator - array allocator returning aligned storage
+// .SECTION Description
+// vtkAlignedArrayAllocator returns storage whose address is a multiple of
+// Alignment bytes (64 by default, the size of a cache line and of the
+// widest SIMD registers), so that loops over the values of an array can
+// use aligned vector loads.
+//
+// .SECTION See Also
+// vtkArrayAllocator vtkDataArrayTemplate
+
+#ifndef __vtkAlignedArrayAllocator_h
+#define __vtkAlignedArrayAllocator_h
+
+#include "vtkArrayAllocator.h"
+
+class VTK_COMMON_EXPORT vtkAlignedArrayAllocator : public vtkArrayAllocator
+{
+public:
+  static vtkAlignedArrayAllocator *New();
+  vtkTypeMacro(vtkAlignedArrayAllocator,vtkArrayAllocator);
+  void PrintSelf(ostream& os, vtkIndent indent);
+
+  // Description:
+  // Set/Get the alignment in bytes. It is rounded up to a power of two
+  // which is at least the size of a pointer. Changing the alignment does
+  // not affect storage which is already allocated.
+  virtual void SetAlignment(int alignment);
+  vtkGetMacro(Alignment, int);
+
+//BTX
+  virtual void* Allocate(size_t size);
+  virtual void* Reallocate(void* ptr, size_t oldSize, size_t newSize);
+  virtual void Free(void* ptr, size_t size);
+//ETX
+
+protected:
+  vtkAlignedArrayAllocator();
+  ~vtkAlignedArrayAllocator();
+
+  int Alignment;
+
+private:
+  vtkAlignedArrayAllocator(const vtkAlignedArrayAllocator&);  // Not implemented.
+  void operator=(const vtkAlignedArrayAllocator&);  // Not implemented.
+};
+
+#endif
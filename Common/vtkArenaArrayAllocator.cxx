@@ -0,0 +1,216 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkArenaArrayAllocator.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+#include "vtkArenaArrayAllocator.h"
+
+#include "vtkCriticalSection.h"
+#include "vtkObjectFactory.h"
+
+#include <vtkstd/map>
+
+vtkStandardNewMacro(vtkArenaArrayAllocator);
+
+// Alignment of the storage carved out of the blocks.
+#define VTK_ARENA_ALIGNMENT static_cast<size_t>(16)
+
+class vtkArenaArrayAllocator::vtkInternals
+{
+public:
+  vtkInternals() : Current(0), End(0), Last(0), ReservedBytes(0) {}
+  ~vtkInternals()
+    {
+    vtkstd::map<char*, size_t>::iterator it;
+    for (it = this->Blocks.begin(); it != this->Blocks.end(); ++it)
+      {
+      free(it->first);
+      }
+    }
+
+  // Return true if ptr was carved out of one of the blocks.
+  bool Owns(void* ptr)
+    {
+    char* p = static_cast<char*>(ptr);
+    vtkstd::map<char*, size_t>::iterator it = this->Blocks.upper_bound(p);
+    if (it == this->Blocks.begin())
+      {
+      return false;
+      }
+    --it;
+    return p < it->first + it->second;
+    }
+
+  // Blocks and their size, by address.
+  vtkstd::map<char*, size_t> Blocks;
+  // Free space of the current block, and last storage carved out of it.
+  char* Current;
+  char* End;
+  char* Last;
+  vtkTypeInt64 ReservedBytes;
+  vtkSimpleCriticalSection Lock;
+};
+
+//----------------------------------------------------------------------------
+static size_t vtkArenaArrayAllocatorRoundUp(size_t size)
+{
+  return (size + VTK_ARENA_ALIGNMENT - 1) & ~(VTK_ARENA_ALIGNMENT - 1);
+}
+
+//----------------------------------------------------------------------------
+vtkArenaArrayAllocator::vtkArenaArrayAllocator()
+{
+  this->BlockSize = 1 << 20;
+  this->MaximumArenaSize = 64 << 10;
+  this->Internals = new vtkInternals;
+}
+
+//----------------------------------------------------------------------------
+vtkArenaArrayAllocator::~vtkArenaArrayAllocator()
+{
+  delete this->Internals;
+}
+
+//----------------------------------------------------------------------------
+void* vtkArenaArrayAllocator::Allocate(size_t size)
+{
+  vtkIdType maxSize = this->MaximumArenaSize < this->BlockSize ?
+    this->MaximumArenaSize : this->BlockSize;
+  if (size > static_cast<size_t>(maxSize))
+    {
+    return malloc(size);
+    }
+
+  size = vtkArenaArrayAllocatorRoundUp(size > 0 ? size : 1);
+  vtkInternals* internals = this->Internals;
+  internals->Lock.Lock();
+  if (internals->Current + size > internals->End)
+    {
+    // Start a new block. What is left of the current one is lost.
+    size_t blockSize = static_cast<size_t>(this->BlockSize);
+    char* block = static_cast<char*>(malloc(blockSize + VTK_ARENA_ALIGNMENT));
+    if (!block)
+      {
+      internals->Lock.Unlock();
+      return 0;
+      }
+    internals->Blocks[block] = blockSize + VTK_ARENA_ALIGNMENT;
+    internals->ReservedBytes +=
+      static_cast<vtkTypeInt64>(blockSize + VTK_ARENA_ALIGNMENT);
+    internals->Current = reinterpret_cast<char*>(
+      vtkArenaArrayAllocatorRoundUp(reinterpret_cast<size_t>(block)));
+    internals->End = internals->Current + blockSize;
+    }
+  char* ptr = internals->Current;
+  internals->Current += size;
+  internals->Last = ptr;
+  internals->Lock.Unlock();
+  return ptr;
+}
+
+//----------------------------------------------------------------------------
+void* vtkArenaArrayAllocator::Reallocate(void* ptr, size_t oldSize,
+                                         size_t newSize)
+{
+  vtkInternals* internals = this->Internals;
+  internals->Lock.Lock();
+  bool owned = internals->Owns(ptr);
+  if (!owned)
+    {
+    internals->Lock.Unlock();
+    vtkIdType maxSize = this->MaximumArenaSize < this->BlockSize ?
+      this->MaximumArenaSize : this->BlockSize;
+    if (newSize > static_cast<size_t>(maxSize))
+      {
+      return realloc(ptr, newSize);
+      }
+    }
+  else
+    {
+    // The last storage carved out of the current block is resized in place.
+    char* p = static_cast<char*>(ptr);
+    size_t size = vtkArenaArrayAllocatorRoundUp(newSize > 0 ? newSize : 1);
+    if (p == internals->Last && p + size <= internals->End &&
+        newSize <= static_cast<size_t>(this->MaximumArenaSize))
+      {
+      internals->Current = p + size;
+      internals->Lock.Unlock();
+      return ptr;
+      }
+    internals->Lock.Unlock();
+    }
+
+  void* newPtr = this->Allocate(newSize);
+  if (newPtr)
+    {
+    memcpy(newPtr, ptr, oldSize < newSize ? oldSize : newSize);
+    this->Free(ptr, oldSize);
+    }
+  return newPtr;
+}
+
+//----------------------------------------------------------------------------
+void vtkArenaArrayAllocator::Free(void* ptr, size_t)
+{
+  if (!ptr)
+    {
+    return;
+    }
+  vtkInternals* internals = this->Internals;
+  internals->Lock.Lock();
+  if (!internals->Owns(ptr))
+    {
+    internals->Lock.Unlock();
+    free(ptr);
+    return;
+    }
+  // Only the last storage of the current block can be given back.
+  if (ptr == internals->Last)
+    {
+    internals->Current = internals->Last;
+    internals->Last = 0;
+    }
+  internals->Lock.Unlock();
+}
+
+//----------------------------------------------------------------------------
+vtkIdType vtkArenaArrayAllocator::GetExtendedSize(vtkIdType currentSize,
+                                                  vtkIdType requestedSize)
+{
+  return requestedSize + currentSize / 2;
+}
+
+//----------------------------------------------------------------------------
+int vtkArenaArrayAllocator::GetNumberOfBlocks()
+{
+  this->Internals->Lock.Lock();
+  int num = static_cast<int>(this->Internals->Blocks.size());
+  this->Internals->Lock.Unlock();
+  return num;
+}
+
+//----------------------------------------------------------------------------
+vtkTypeInt64 vtkArenaArrayAllocator::GetReservedBytes()
+{
+  this->Internals->Lock.Lock();
+  vtkTypeInt64 bytes = this->Internals->ReservedBytes;
+  this->Internals->Lock.Unlock();
+  return bytes;
+}
+
+//----------------------------------------------------------------------------
+void vtkArenaArrayAllocator::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os,indent);
+  os << indent << "BlockSize: " << this->BlockSize << "\n";
+  os << indent << "MaximumArenaSize: " << this->MaximumArenaSize << "\n";
+}
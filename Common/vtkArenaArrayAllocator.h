@@ -0,0 +1,94 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkArenaArrayAllocator.h
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// .NAME vtkArenaArrayAllocator - array allocator carving small arrays out of large blocks
+// .SECTION Description
+// vtkArenaArrayAllocator serves requests of at most MaximumArenaSize
+// bytes by bumping a pointer in large blocks of BlockSize bytes. This is
+// much cheaper than malloc when many tiny arrays are created, for example
+// the attribute arrays of the many blocks of a composite dataset. The
+// space of a released array is only reused when it was the last one
+// carved out of the current block; all blocks are returned to the system
+// when the allocator is destroyed, which happens once the last array using
+// it is gone since arrays keep a reference to their allocator. Larger
+// requests go to malloc.
+//
+// Use one arena per group of arrays with a similar lifetime, by setting it
+// on each array with vtkDataArrayTemplate::SetAllocator(), or globally
+// while the group is created.
+//
+// .SECTION See Also
+// vtkArrayAllocator vtkDataArrayTemplate
+
+#ifndef __vtkArenaArrayAllocator_h
+#define __vtkArenaArrayAllocator_h
+
+#include "vtkArrayAllocator.h"
+
+class VTK_COMMON_EXPORT vtkArenaArrayAllocator : public vtkArrayAllocator
+{
+public:
+  static vtkArenaArrayAllocator *New();
+  vtkTypeMacro(vtkArenaArrayAllocator,vtkArrayAllocator);
+  void PrintSelf(ostream& os, vtkIndent indent);
+
+  // Description:
+  // Size in bytes of the blocks allocated from the system.
+  // The default is 1MB.
+  vtkSetClampMacro(BlockSize, vtkIdType, 4096, VTK_LARGE_ID);
+  vtkGetMacro(BlockSize, vtkIdType);
+
+  // Description:
+  // Largest request, in bytes, served from the blocks. Larger requests
+  // use malloc. The default is 64kB. It is clamped to BlockSize.
+  vtkSetMacro(MaximumArenaSize, vtkIdType);
+  vtkGetMacro(MaximumArenaSize, vtkIdType);
+
+//BTX
+  virtual void* Allocate(size_t size);
+  virtual void* Reallocate(void* ptr, size_t oldSize, size_t newSize);
+  virtual void Free(void* ptr, size_t size);
+//ETX
+
+  // Description:
+  // Tiny arrays grow a lot through InsertNextValue(); in an arena, growth
+  // goes to the end of the block so only grow by half of the current size
+  // to waste less space.
+  virtual vtkIdType GetExtendedSize(vtkIdType currentSize,
+                                    vtkIdType requestedSize);
+
+  // Description:
+  // Number of blocks allocated from the system, and total size of the
+  // blocks in bytes.
+  int GetNumberOfBlocks();
+  vtkTypeInt64 GetReservedBytes();
+
+protected:
+  vtkArenaArrayAllocator();
+  ~vtkArenaArrayAllocator();
+
+  vtkIdType BlockSize;
+  vtkIdType MaximumArenaSize;
+
+//BTX
+  class vtkInternals;
+  vtkInternals* Internals;
+//ETX
+
+private:
+  vtkArenaArrayAllocator(const vtkArenaArrayAllocator&);  // Not implemented.
+  void operator=(const vtkArenaArrayAllocator&);  // Not implemented.
+};
+
+#endif
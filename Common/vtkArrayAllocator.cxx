@@ -0,0 +1,233 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkArrayAllocator.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+#include "vtkArrayAllocator.h"
+
+#include "vtkCriticalSection.h"
+#include "vtkObjectFactory.h"
+
+vtkStandardNewMacro(vtkArrayAllocator);
+
+// Large enough for all the VTK_* data type constants.
+#define VTK_ARRAY_ALLOCATOR_MAX_TYPES 32
+
+static vtkArrayAllocator* vtkArrayAllocatorGlobalAllocator = 0;
+
+// The statistics are off by default so that threads allocating arrays do
+// not contend for the lock.
+static int vtkArrayAllocatorStatistics = 0;
+static vtkSimpleCriticalSection vtkArrayAllocatorStatisticsLock;
+static vtkTypeInt64
+  vtkArrayAllocatorAllocatedBytes[VTK_ARRAY_ALLOCATOR_MAX_TYPES];
+static vtkTypeInt64
+  vtkArrayAllocatorPeakAllocatedBytes[VTK_ARRAY_ALLOCATOR_MAX_TYPES];
+
+//----------------------------------------------------------------------------
+vtkArrayAllocator::vtkArrayAllocator()
+{
+}
+
+//----------------------------------------------------------------------------
+vtkArrayAllocator::~vtkArrayAllocator()
+{
+}
+
+//----------------------------------------------------------------------------
+void* vtkArrayAllocator::Allocate(size_t size)
+{
+  return malloc(size);
+}
+
+//----------------------------------------------------------------------------
+void* vtkArrayAllocator::Reallocate(void* ptr, size_t oldSize,
+                                    size_t newSize)
+{
+#if defined __APPLE__
+  // OS X's realloc does not free memory if the new block is smaller.
+  void* newPtr = malloc(newSize);
+  if (newPtr)
+    {
+    memcpy(newPtr, ptr, oldSize < newSize ? oldSize : newSize);
+    free(ptr);
+    }
+  return newPtr;
+#else
+  (void)oldSize;
+  return realloc(ptr, newSize);
+#endif
+}
+
+//----------------------------------------------------------------------------
+void vtkArrayAllocator::Free(void* ptr, size_t)
+{
+  free(ptr);
+}
+
+//----------------------------------------------------------------------------
+vtkIdType vtkArrayAllocator::GetExtendedSize(vtkIdType currentSize,
+                                             vtkIdType requestedSize)
+{
+  return requestedSize + currentSize;
+}
+
+//----------------------------------------------------------------------------
+void vtkArrayAllocator::SetGlobalAllocator(vtkArrayAllocator* allocator)
+{
+  if (allocator == vtkArrayAllocatorGlobalAllocator)
+    {
+    return;
+    }
+  if (allocator)
+    {
+    allocator->Register(0);
+    }
+  if (vtkArrayAllocatorGlobalAllocator)
+    {
+    vtkArrayAllocatorGlobalAllocator->UnRegister(0);
+    }
+  vtkArrayAllocatorGlobalAllocator = allocator;
+}
+
+//----------------------------------------------------------------------------
+vtkArrayAllocator* vtkArrayAllocator::GetGlobalAllocator()
+{
+  return vtkArrayAllocatorGlobalAllocator;
+}
+
+//----------------------------------------------------------------------------
+void vtkArrayAllocator::SetAllocationStatistics(int enable)
+{
+  vtkArrayAllocatorStatistics = (enable != 0);
+}
+
+//----------------------------------------------------------------------------
+int vtkArrayAllocator::GetAllocationStatistics()
+{
+  return vtkArrayAllocatorStatistics;
+}
+
+//----------------------------------------------------------------------------
+void vtkArrayAllocator::AllocationStatisticsOn()
+{
+  vtkArrayAllocator::SetAllocationStatistics(1);
+}
+
+//----------------------------------------------------------------------------
+void vtkArrayAllocator::AllocationStatisticsOff()
+{
+  vtkArrayAllocator::SetAllocationStatistics(0);
+}
+
+//----------------------------------------------------------------------------
+int vtkArrayAllocator::ReportAllocation(int dataType, vtkTypeInt64 bytes)
+{
+  if (!vtkArrayAllocatorStatistics || bytes <= 0 ||
+      dataType < 0 || dataType >= VTK_ARRAY_ALLOCATOR_MAX_TYPES)
+    {
+    return 0;
+    }
+  vtkArrayAllocatorStatisticsLock.Lock();
+  bytes += vtkArrayAllocatorAllocatedBytes[dataType];
+  vtkArrayAllocatorAllocatedBytes[dataType] = bytes;
+  if (bytes > vtkArrayAllocatorPeakAllocatedBytes[dataType])
+    {
+    vtkArrayAllocatorPeakAllocatedBytes[dataType] = bytes;
+    }
+  vtkArrayAllocatorStatisticsLock.Unlock();
+  return 1;
+}
+
+//----------------------------------------------------------------------------
+void vtkArrayAllocator::ReportRelease(int dataType, vtkTypeInt64 bytes)
+{
+  if (dataType < 0 || dataType >= VTK_ARRAY_ALLOCATOR_MAX_TYPES)
+    {
+    return;
+    }
+  vtkArrayAllocatorStatisticsLock.Lock();
+  vtkArrayAllocatorAllocatedBytes[dataType] -= bytes;
+  vtkArrayAllocatorStatisticsLock.Unlock();
+}
+
+//----------------------------------------------------------------------------
+vtkTypeInt64 vtkArrayAllocator::GetAllocatedBytes(int dataType)
+{
+  if (dataType < 0 || dataType >= VTK_ARRAY_ALLOCATOR_MAX_TYPES)
+    {
+    return 0;
+    }
+  vtkArrayAllocatorStatisticsLock.Lock();
+  vtkTypeInt64 bytes = vtkArrayAllocatorAllocatedBytes[dataType];
+  vtkArrayAllocatorStatisticsLock.Unlock();
+  return bytes;
+}
+
+//----------------------------------------------------------------------------
+vtkTypeInt64 vtkArrayAllocator::GetPeakAllocatedBytes(int dataType)
+{
+  if (dataType < 0 || dataType >= VTK_ARRAY_ALLOCATOR_MAX_TYPES)
+    {
+    return 0;
+    }
+  vtkArrayAllocatorStatisticsLock.Lock();
+  vtkTypeInt64 bytes = vtkArrayAllocatorPeakAllocatedBytes[dataType];
+  vtkArrayAllocatorStatisticsLock.Unlock();
+  return bytes;
+}
+
+//----------------------------------------------------------------------------
+vtkTypeInt64 vtkArrayAllocator::GetTotalAllocatedBytes()
+{
+  vtkTypeInt64 total = 0;
+  vtkArrayAllocatorStatisticsLock.Lock();
+  for (int i = 0; i < VTK_ARRAY_ALLOCATOR_MAX_TYPES; ++i)
+    {
+    total += vtkArrayAllocatorAllocatedBytes[i];
+    }
+  vtkArrayAllocatorStatisticsLock.Unlock();
+  return total;
+}
+
+//----------------------------------------------------------------------------
+void vtkArrayAllocator::ResetPeakAllocatedBytes()
+{
+  vtkArrayAllocatorStatisticsLock.Lock();
+  for (int i = 0; i < VTK_ARRAY_ALLOCATOR_MAX_TYPES; ++i)
+    {
+    vtkArrayAllocatorPeakAllocatedBytes[i] =
+      vtkArrayAllocatorAllocatedBytes[i];
+    }
+  vtkArrayAllocatorStatisticsLock.Unlock();
+}
+
+//----------------------------------------------------------------------------
+void vtkArrayAllocator::PrintAllocationStatistics(ostream& os)
+{
+  for (int i = 0; i < VTK_ARRAY_ALLOCATOR_MAX_TYPES; ++i)
+    {
+    vtkTypeInt64 peak = vtkArrayAllocator::GetPeakAllocatedBytes(i);
+    if (peak)
+      {
+      os << vtkImageScalarTypeNameMacro(i) << ": "
+         << vtkArrayAllocator::GetAllocatedBytes(i) << " bytes (peak "
+         << peak << " bytes)\n";
+      }
+    }
+}
+
+//----------------------------------------------------------------------------
+void vtkArrayAllocator::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os,indent);
+}
@@ -0,0 +1,135 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkArrayAllocator.h
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// .NAME vtkArrayAllocator - memory allocator for data array storage
+// .SECTION Description
+// vtkArrayAllocator is the hook through which vtkDataArrayTemplate
+// allocates, grows and releases the memory holding its values. This base
+// class uses malloc/realloc/free, which is also what arrays do when no
+// allocator is set at all. Subclasses provide aligned, huge page and arena
+// storage.
+//
+// An allocator may be set on a single array with
+// vtkDataArrayTemplate::SetAllocator(), or for all arrays with
+// SetGlobalAllocator(). An array keeps a reference to the allocator that
+// allocated its current storage, so the storage is always released by the
+// right allocator even if the allocators are changed in the meantime.
+//
+// The allocator also decides how much an array grows when values are
+// inserted past its end (see GetExtendedSize()).
+//
+// Finally, vtkArrayAllocator can keep track of the number of bytes held by
+// data arrays for each data type (VTK_FLOAT, VTK_INT...), whatever the
+// allocator used. This takes a process-wide lock at every allocation, so it
+// is off by default. See SetAllocationStatistics() and GetAllocatedBytes().
+//
+// .SECTION See Also
+// vtkDataArrayTemplate vtkAlignedArrayAllocator vtkHugePageArrayAllocator
+// vtkArenaArrayAllocator
+
+#ifndef __vtkArrayAllocator_h
+#define __vtkArrayAllocator_h
+
+#include "vtkObject.h"
+
+class VTK_COMMON_EXPORT vtkArrayAllocator : public vtkObject
+{
+public:
+  static vtkArrayAllocator *New();
+  vtkTypeMacro(vtkArrayAllocator,vtkObject);
+  void PrintSelf(ostream& os, vtkIndent indent);
+
+//BTX
+  // Description:
+  // Allocate size bytes. Return 0 on failure.
+  virtual void* Allocate(size_t size);
+
+  // Description:
+  // Resize a block returned by Allocate() from oldSize to newSize bytes,
+  // preserving min(oldSize,newSize) bytes of its content. Return 0 on
+  // failure, in which case ptr is left untouched.
+  virtual void* Reallocate(void* ptr, size_t oldSize, size_t newSize);
+
+  // Description:
+  // Release a block of size bytes returned by Allocate() or Reallocate().
+  virtual void Free(void* ptr, size_t size);
+//ETX
+
+  // Description:
+  // Return the number of values an array currently holding currentSize
+  // values should be resized to so that it can hold requestedSize values
+  // (requestedSize > currentSize). The default is to grow to
+  // requestedSize + currentSize, i.e. to (more than) double the storage.
+  virtual vtkIdType GetExtendedSize(vtkIdType currentSize,
+                                    vtkIdType requestedSize);
+
+  // Description:
+  // Set/Get the allocator used by the arrays which have no allocator of
+  // their own. The default is NULL, which means malloc/realloc/free.
+  static void SetGlobalAllocator(vtkArrayAllocator* allocator);
+  static vtkArrayAllocator* GetGlobalAllocator();
+
+  // Description:
+  // Turn on/off the counting of the bytes held by data arrays. The default
+  // is off, since every allocation then serializes on a global lock. Only
+  // the storage acquired while it is on is counted, so turn it on before
+  // creating the arrays of interest. The release of counted storage is
+  // always counted, even after the statistics are turned off.
+  static void SetAllocationStatistics(int enable);
+  static int GetAllocationStatistics();
+  static void AllocationStatisticsOn();
+  static void AllocationStatisticsOff();
+
+  // Description:
+  // Bytes currently held by data arrays of the given data type in the
+  // storage they acquired while the statistics were on, and the highest
+  // value this count ever reached. Storage supplied by the user through
+  // SetArray() with save set is not counted.
+  static vtkTypeInt64 GetAllocatedBytes(int dataType);
+  static vtkTypeInt64 GetPeakAllocatedBytes(int dataType);
+
+  // Description:
+  // Bytes currently held by data arrays of all types.
+  static vtkTypeInt64 GetTotalAllocatedBytes();
+
+  // Description:
+  // Reset the peak counts to the current counts.
+  static void ResetPeakAllocatedBytes();
+
+  // Description:
+  // Print the allocation counts of all data types which have some.
+  static void PrintAllocationStatistics(ostream& os);
+
+  // Description:
+  // Used by the arrays to report that they acquired storage of the given
+  // number of bytes. Does nothing and returns 0 unless the statistics are
+  // on. Returns 1 if the storage was counted, in which case its release
+  // must be reported with ReportRelease().
+  static int ReportAllocation(int dataType, vtkTypeInt64 bytes);
+
+  // Description:
+  // Used by the arrays to report the release of storage whose acquisition
+  // was counted by ReportAllocation().
+  static void ReportRelease(int dataType, vtkTypeInt64 bytes);
+
+protected:
+  vtkArrayAllocator();
+  ~vtkArrayAllocator();
+
+private:
+  vtkArrayAllocator(const vtkArrayAllocator&);  // Not implemented.
+  void operator=(const vtkArrayAllocator&);  // Not implemented.
+};
+
+#endif
@@ -23,6 +23,8 @@
 
 #include "vtkDataArray.h"
 
+class vtkArrayAllocator;
+
 template <class T>
 class vtkDataArrayTemplateLookup;
 
@@ -226,6 +228,15 @@ public:
       this->SetArray(static_cast<T*>(array), size, save, deleteMethod);
     }
 
+  // Description:
+  // Set/Get the allocator through which the storage of this array is
+  // allocated from now on. When NULL (the default), the global allocator
+  // of vtkArrayAllocator is used, and malloc/realloc/free if there is none.
+  // The current storage, if any, is moved to the new allocator the next
+  // time the array is resized.
+  void SetAllocator(vtkArrayAllocator* allocator);
+  vtkArrayAllocator* GetAllocator() { return this->Allocator; }
+
   // Description:
   // This method copies the array data to the void pointer specified
   // by the user.  It is up to the user to allocate enough memory for
@@ -279,6 +290,17 @@ protected:
   int SaveUserArray;
   int DeleteMethod;
 
+  // Allocator requested for this array, and allocator which allocated the
+  // current storage (NULL if it came from malloc or from the user).
+  vtkArrayAllocator* Allocator;
+  vtkArrayAllocator* StorageAllocator;
+
+  // Data type the current storage was reported under, and whether it was
+  // counted by the allocation statistics. GetDataType() cannot be used to
+  // report its release from the destructor.
+  int StorageDataType;
+  int StorageCounted;
+
   virtual void ComputeScalarRange(int comp);
   virtual void ComputeVectorRange();
 private:
@@ -289,6 +311,16 @@ private:
   void UpdateLookup();
 
   void DeleteArray();
+
+  // Allocate storage for sz values through the allocator in effect for this
+  // array. On success, allocator is set to the (registered) allocator used,
+  // or to NULL if malloc was used.
+  T* AllocateStorage(vtkIdType sz, vtkArrayAllocator*& allocator);
+  vtkArrayAllocator* GetEffectiveAllocator();
+
+  // Report the acquisition of the current storage, of sz values, to the
+  // allocation statistics.
+  void ReportStorage(vtkIdType sz);
 };
 
 #if !defined(VTK_NO_EXPLICIT_TEMPLATE_INSTANTIATION)
@@ -17,6 +17,7 @@
 
 #include "vtkDataArrayTemplate.h"
 
+#include "vtkArrayAllocator.h"
 #include "vtkArrayIteratorTemplate.h"
 #include "vtkIdList.h"
 #include "vtkInformation.h"
@@ -76,6 +77,10 @@ vtkDataArrayTemplate<T>::vtkDataArrayTemplate(vtkIdType numComp):
   this->TupleSize = 0;
   this->SaveUserArray = 0;
   this->DeleteMethod = VTK_DATA_ARRAY_FREE;
+  this->Allocator = 0;
+  this->StorageAllocator = 0;
+  this->StorageDataType = -1;
+  this->StorageCounted = 0;
   this->Lookup = 0;
   this->ValueRange[0] = 0;
   this->ValueRange[1] = 1;
@@ -94,6 +99,76 @@ vtkDataArrayTemplate<T>::~vtkDataArrayTemplate()
     {
     delete this->Lookup;
     }
+  if(this->Allocator)
+    {
+    this->Allocator->UnRegister(this);
+    }
+}
+
+//----------------------------------------------------------------------------
+template <class T>
+void vtkDataArrayTemplate<T>::SetAllocator(vtkArrayAllocator* allocator)
+{
+  if (this->Allocator == allocator)
+    {
+    return;
+    }
+  if (allocator)
+    {
+    allocator->Register(this);
+    }
+  if (this->Allocator)
+    {
+    this->Allocator->UnRegister(this);
+    }
+  this->Allocator = allocator;
+  this->Modified();
+}
+
+//----------------------------------------------------------------------------
+template <class T>
+vtkArrayAllocator* vtkDataArrayTemplate<T>::GetEffectiveAllocator()
+{
+  return this->Allocator ? this->Allocator :
+    vtkArrayAllocator::GetGlobalAllocator();
+}
+
+//----------------------------------------------------------------------------
+template <class T>
+T* vtkDataArrayTemplate<T>::AllocateStorage(vtkIdType sz,
+                                            vtkArrayAllocator*& allocator)
+{
+  size_t bytes = static_cast<size_t>(sz) * sizeof(T);
+  allocator = this->GetEffectiveAllocator();
+  T* array;
+  if (allocator)
+    {
+    array = static_cast<T*>(allocator->Allocate(bytes));
+    }
+  else
+    {
+    array = static_cast<T*>(malloc(bytes));
+    }
+  if (!array)
+    {
+    allocator = 0;
+    return 0;
+    }
+  if (allocator)
+    {
+    allocator->Register(this);
+    }
+  return array;
+}
+
+//----------------------------------------------------------------------------
+template <class T>
+void vtkDataArrayTemplate<T>::ReportStorage(vtkIdType sz)
+{
+  this->StorageDataType = this->GetDataType();
+  this->StorageCounted = vtkArrayAllocator::ReportAllocation(
+    this->StorageDataType,
+    static_cast<vtkTypeInt64>(sz) * static_cast<vtkTypeInt64>(sizeof(T)));
 }
 
 //----------------------------------------------------------------------------
@@ -118,6 +193,11 @@ void vtkDataArrayTemplate<T>::SetArray(T* array,
   this->MaxId = size-1;
   this->SaveUserArray = save;
   this->DeleteMethod = deleteMethod;
+  if (array && !save)
+    {
+    // We own the array from now on.
+    this->ReportStorage(size);
+    }
   this->DataChanged();
 }
 
@@ -135,8 +215,7 @@ int vtkDataArrayTemplate<T>::Allocate(vtkIdType sz, vtkIdType)
     this->Size = 0;
 
     vtkIdType newSize = (sz > 0 ? sz : 1);
-    this->Array = static_cast<T*>(malloc(static_cast<size_t>(newSize)
-                                         * sizeof(T)));
+    this->Array = this->AllocateStorage(newSize, this->StorageAllocator);
     if(this->Array==0)
       {
       vtkErrorMacro("Unable to allocate " << newSize
@@ -154,6 +233,7 @@ int vtkDataArrayTemplate<T>::Allocate(vtkIdType sz, vtkIdType)
       #endif
       }
     this->Size = newSize;
+    this->ReportStorage(newSize);
     }
   this->DataChanged();
 
@@ -206,8 +286,7 @@ void vtkDataArrayTemplate<T>::DeepCopy(vtkDataArray* fa)
   this->Size = fa->GetSize();
 
   this->Size = (this->Size > 0 ? this->Size : 1);
-  this->Array = static_cast<T* >(
-    malloc(static_cast<size_t>(this->Size) * sizeof(T)));
+  this->Array = this->AllocateStorage(this->Size, this->StorageAllocator);
   if(this->Array==0)
     {
     vtkErrorMacro("Unable to allocate " << this->Size
@@ -228,6 +307,7 @@ void vtkDataArrayTemplate<T>::DeepCopy(vtkDataArray* fa)
     return;
     #endif
     }
+  this->ReportStorage(this->Size);
   if (fa->GetSize() > 0)
     {
     memcpy(this->Array, fa->GetVoidPointer(0),
@@ -251,6 +331,14 @@ void vtkDataArrayTemplate<T>::PrintSelf(ostream& os, vtkIndent indent)
     {
     osw << indent << "Array: (null)\n";
     }
+  if(this->Allocator)
+    {
+    osw << indent << "Allocator: " << this->Allocator->GetClassName() << "\n";
+    }
+  else
+    {
+    osw << indent << "Allocator: (none)\n";
+    }
 }
 
 //----------------------------------------------------------------------------
@@ -259,7 +347,12 @@ void vtkDataArrayTemplate<T>::DeleteArray()
 {
   if ((this->Array) && (!this->SaveUserArray))
     {
-    if (this->DeleteMethod == VTK_DATA_ARRAY_FREE)
+    size_t bytes = static_cast<size_t>(this->Size) * sizeof(T);
+    if (this->StorageAllocator)
+      {
+      this->StorageAllocator->Free(this->Array, bytes);
+      }
+    else if (this->DeleteMethod == VTK_DATA_ARRAY_FREE)
       {
       free(this->Array);
       }
@@ -267,6 +360,17 @@ void vtkDataArrayTemplate<T>::DeleteArray()
       {
       delete[] this->Array;
       }
+    if (this->StorageCounted)
+      {
+      vtkArrayAllocator::ReportRelease(this->StorageDataType,
+                                       static_cast<vtkTypeInt64>(bytes));
+      }
+    }
+  this->StorageCounted = 0;
+  if (this->StorageAllocator)
+    {
+    this->StorageAllocator->UnRegister(this);
+    this->StorageAllocator = 0;
     }
   this->SaveUserArray = 0;
   this->DeleteMethod = VTK_DATA_ARRAY_FREE;
@@ -279,13 +383,26 @@ T* vtkDataArrayTemplate<T>::ResizeAndExtend(vtkIdType sz, bool useExactSize)
 {
   T* newArray;
   vtkIdType newSize;
+  vtkArrayAllocator* allocator = this->GetEffectiveAllocator();
 
   if(sz > this->Size)
     {
     // Requested size is bigger than current size.  Allocate enough
-    // memory to fit the requested size and be more than double the
-    // currently allocated memory.
-    newSize = sz + (useExactSize ? 0 : this->Size);
+    // memory to fit the requested size and, unless the allocator has its
+    // own growth policy, be more than double the currently allocated memory.
+    if (useExactSize)
+      {
+      newSize = sz;
+      }
+    else if (allocator)
+      {
+      newSize = allocator->GetExtendedSize(this->Size, sz);
+      newSize = (newSize < sz ? sz : newSize);
+      }
+    else
+      {
+      newSize = sz + this->Size;
+      }
     }
   else if (sz == this->Size)
     {
@@ -315,14 +432,16 @@ T* vtkDataArrayTemplate<T>::ResizeAndExtend(vtkIdType sz, bool useExactSize)
   dontUseRealloc=true;
   #endif
 
-  // Allocate the new array or reallocate the old.
-  if (this->Array
-      &&
-      (this->SaveUserArray
-       || this->DeleteMethod==VTK_DATA_ARRAY_DELETE
-       || dontUseRealloc ))
+  // Allocate the new array or reallocate the old. Storage moves to another
+  // allocator by allocating the new array from it.
+  if (!this->Array
+      || this->SaveUserArray
+      || this->StorageAllocator != allocator
+      || (!allocator
+          && (this->DeleteMethod==VTK_DATA_ARRAY_DELETE || dontUseRealloc)))
     {
-    newArray = static_cast<T*>(malloc(static_cast<size_t>(newSize)*sizeof(T)));
+    vtkArrayAllocator* newAllocator;
+    newArray = this->AllocateStorage(newSize, newAllocator);
     if(!newArray)
       {
       vtkErrorMacro("Unable to allocate " << newSize
@@ -341,19 +460,42 @@ T* vtkDataArrayTemplate<T>::ResizeAndExtend(vtkIdType sz, bool useExactSize)
       }
 
     // Copy the data from the old array.
-    memcpy(newArray, this->Array,
-           static_cast<size_t>(newSize < this->Size ? newSize : this->Size)
-           * sizeof(T));
+    if (this->Array)
+      {
+      memcpy(newArray, this->Array,
+             static_cast<size_t>(newSize < this->Size ? newSize : this->Size)
+             * sizeof(T));
+      }
 
     // Realease old array if we own
     this->DeleteArray();
+    this->StorageAllocator = newAllocator;
+    this->ReportStorage(newSize);
     }
   else
     {
     // Try to reallocate with minimal memory usage and possibly avoid
     // copying.
-    newArray = static_cast<T*>(
-      realloc(this->Array,static_cast<size_t>(newSize)*sizeof(T)));
+    size_t oldBytes = static_cast<size_t>(this->Size)*sizeof(T);
+    size_t newBytes = static_cast<size_t>(newSize)*sizeof(T);
+    if (allocator)
+      {
+      newArray = static_cast<T*>(
+        allocator->Reallocate(this->Array, oldBytes, newBytes));
+      }
+    else
+      {
+      newArray = static_cast<T*>(realloc(this->Array, newBytes));
+      }
+    if (newArray)
+      {
+      if (this->StorageCounted)
+        {
+        vtkArrayAllocator::ReportRelease(this->StorageDataType,
+                                         static_cast<vtkTypeInt64>(oldBytes));
+        }
+      this->ReportStorage(newSize);
+      }
     if(!newArray)
       {
       vtkErrorMacro("Unable to allocate " << newSize
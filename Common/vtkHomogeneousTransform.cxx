@@ -14,10 +14,16 @@
 =========================================================================*/
 #include "vtkHomogeneousTransform.h"
 
+#include "vtkDataArray.h"
 #include "vtkMath.h"
 #include "vtkMatrix4x4.h"
+#include "vtkMultiThreader.h"
 #include "vtkPoints.h"
 
+// Buffers are only split across threads when each thread gets at least
+// this many tuples, otherwise starting the threads costs more than it saves.
+#define VTK_HOMOGENEOUS_TRANSFORM_TUPLES_PER_THREAD 65536
+
 
 //----------------------------------------------------------------------------
 vtkHomogeneousTransform::vtkHomogeneousTransform()
@@ -110,6 +116,150 @@ void vtkHomogeneousTransform::InternalTransformDerivative(const double in[3],
   vtkHomogeneousTransformDerivative(this->Matrix->Element,in,out,derivative);
 }
 
+//------------------------------------------------------------------------
+// The same arithmetic as vtkHomogeneousTransformPoint(), written as a
+// plain loop over the buffer with the matrix kept in locals so that the
+// compiler can vectorize it.
+template <class T>
+void vtkHomogeneousTransformPoints(double M[4][4], const T *in, T *out,
+                                   vtkIdType n)
+{
+  const double m00 = M[0][0], m01 = M[0][1], m02 = M[0][2], m03 = M[0][3];
+  const double m10 = M[1][0], m11 = M[1][1], m12 = M[1][2], m13 = M[1][3];
+  const double m20 = M[2][0], m21 = M[2][1], m22 = M[2][2], m23 = M[2][3];
+  const double m30 = M[3][0], m31 = M[3][1], m32 = M[3][2], m33 = M[3][3];
+
+  for (vtkIdType i = 0; i < n; i++, in += 3, out += 3)
+    {
+    double x = in[0];
+    double y = in[1];
+    double z = in[2];
+    double f = 1.0/(m30*x + m31*y + m32*z + m33);
+    out[0] = static_cast<T>((m00*x + m01*y + m02*z + m03)*f);
+    out[1] = static_cast<T>((m10*x + m11*y + m12*z + m13)*f);
+    out[2] = static_cast<T>((m20*x + m21*y + m22*z + m23)*f);
+    }
+}
+
+//------------------------------------------------------------------------
+template <class T>
+void vtkHomogeneousTransformPointsKernel(double M[4][4], const void *in,
+                                         void *out, vtkIdType n)
+{
+  vtkHomogeneousTransformPoints(M, static_cast<const T *>(in),
+                                static_cast<T *>(out), n);
+}
+
+//------------------------------------------------------------------------
+struct vtkHomogeneousTransformBufferStruct
+{
+  void (*Kernel)(double matrix[4][4], const void *in, void *out,
+                 vtkIdType n);
+  double (*Matrix)[4];
+  const char *In;
+  char *Out;
+  vtkIdType NumberOfTuples;
+  int TupleSize;
+};
+
+//------------------------------------------------------------------------
+static VTK_THREAD_RETURN_TYPE vtkHomogeneousTransformBufferThread(void *arg)
+{
+  vtkMultiThreader::ThreadInfo *info =
+    static_cast<vtkMultiThreader::ThreadInfo *>(arg);
+  vtkHomogeneousTransformBufferStruct *str =
+    static_cast<vtkHomogeneousTransformBufferStruct *>(info->UserData);
+
+  vtkIdType n = str->NumberOfTuples;
+  vtkIdType begin = n*info->ThreadID/info->NumberOfThreads;
+  vtkIdType end = n*(info->ThreadID + 1)/info->NumberOfThreads;
+  if (end > begin)
+    {
+    str->Kernel(str->Matrix, str->In + begin*str->TupleSize,
+                str->Out + begin*str->TupleSize, end - begin);
+    }
+
+  return VTK_THREAD_RETURN_VALUE;
+}
+
+//----------------------------------------------------------------------------
+void vtkHomogeneousTransform::ExecuteBufferKernel(BufferKernel kernel,
+                                                  double matrix[4][4],
+                                                  const void *in, void *out,
+                                                  vtkIdType n, int dataType)
+{
+  vtkIdType numThreads = n/VTK_HOMOGENEOUS_TRANSFORM_TUPLES_PER_THREAD;
+  if (numThreads > vtkMultiThreader::GetGlobalDefaultNumberOfThreads())
+    {
+    numThreads = vtkMultiThreader::GetGlobalDefaultNumberOfThreads();
+    }
+  if (numThreads <= 1)
+    {
+    kernel(matrix, in, out, n);
+    return;
+    }
+
+  vtkHomogeneousTransformBufferStruct str;
+  str.Kernel = kernel;
+  str.Matrix = matrix;
+  str.In = static_cast<const char *>(in);
+  str.Out = static_cast<char *>(out);
+  str.NumberOfTuples = n;
+  str.TupleSize = 3*(dataType == VTK_FLOAT ? sizeof(float) : sizeof(double));
+
+  vtkMultiThreader *threader = vtkMultiThreader::New();
+  threader->SetNumberOfThreads(static_cast<int>(numThreads));
+  threader->SetSingleMethod(vtkHomogeneousTransformBufferThread, &str);
+  threader->SingleMethodExecute();
+  threader->Delete();
+}
+
+//----------------------------------------------------------------------------
+int vtkHomogeneousTransform::PrepareBuffers(vtkDataArray *in,
+                                            vtkDataArray *out,
+                                            void *&inPtr, void *&outPtr)
+{
+  int dataType = in->GetDataType();
+  if ((dataType != VTK_FLOAT && dataType != VTK_DOUBLE) ||
+      out->GetDataType() != dataType ||
+      in->GetNumberOfComponents() != 3 || out->GetNumberOfComponents() != 3)
+    {
+    return 0;
+    }
+
+  vtkIdType n = in->GetNumberOfTuples();
+  vtkIdType start = out->GetNumberOfTuples();
+  // in may be out, so only take its pointer once out has been resized
+  outPtr = out->WriteVoidPointer(3*start, 3*n);
+  if (!outPtr)
+    {
+    return 0;
+    }
+  inPtr = in->GetVoidPointer(0);
+
+  return dataType;
+}
+
+//----------------------------------------------------------------------------
+void vtkHomogeneousTransform::InternalTransformPoints(const float *in,
+                                                      float *out,
+                                                      vtkIdType n)
+{
+  vtkHomogeneousTransform::ExecuteBufferKernel(
+    vtkHomogeneousTransformPointsKernel<float>, this->Matrix->Element,
+    in, out, n, VTK_FLOAT);
+}
+
+//----------------------------------------------------------------------------
+void vtkHomogeneousTransform::InternalTransformPoints(const double *in,
+                                                      double *out,
+                                                      vtkIdType n)
+{
+  vtkHomogeneousTransform::ExecuteBufferKernel(
+    vtkHomogeneousTransformPointsKernel<double>, this->Matrix->Element,
+    in, out, n, VTK_DOUBLE);
+}
+
 //----------------------------------------------------------------------------
 void vtkHomogeneousTransform::TransformPoints(vtkPoints *inPts, 
                                               vtkPoints *outPts)
@@ -120,6 +270,21 @@ void vtkHomogeneousTransform::TransformPoints(vtkPoints *inPts,
 
   this->Update();
 
+  void *inPtr, *outPtr;
+  switch (vtkHomogeneousTransform::PrepareBuffers(inPts->GetData(),
+                                                  outPts->GetData(),
+                                                  inPtr, outPtr))
+    {
+    case VTK_FLOAT:
+      this->InternalTransformPoints(static_cast<float *>(inPtr),
+                                    static_cast<float *>(outPtr), n);
+      return;
+    case VTK_DOUBLE:
+      this->InternalTransformPoints(static_cast<double *>(inPtr),
+                                    static_cast<double *>(outPtr), n);
+      return;
+    }
+
   for (int i = 0; i < n; i++)
     {
     inPts->GetPoint(i,point);
@@ -86,12 +86,45 @@ public:
   void InternalTransformDerivative(const double in[3], double out[3],
                                    double derivative[3][3]);
 
+//BTX
+  // Description:
+  // Transform n points stored as consecutive (x,y,z) triples, writing
+  // the results to out, which may be the same buffer as in.  Large
+  // buffers are split across threads.  This will calculate the
+  // transformation without calling Update.  Meant for use only within
+  // other VTK classes.
+  virtual void InternalTransformPoints(const float *in, float *out,
+                                       vtkIdType n);
+  virtual void InternalTransformPoints(const double *in, double *out,
+                                       vtkIdType n);
+//ETX
+
 protected:
   vtkHomogeneousTransform();
   ~vtkHomogeneousTransform();
 
   void InternalDeepCopy(vtkAbstractTransform *transform);
 
+//BTX
+  // Description:
+  // A kernel transforming n tuples of 3 floats or doubles with the
+  // given matrix, and the function which runs it over a buffer using
+  // as many threads as the buffer size justifies.
+  typedef void (*BufferKernel)(double matrix[4][4], const void *in,
+                               void *out, vtkIdType n);
+  static void ExecuteBufferKernel(BufferKernel kernel, double matrix[4][4],
+                                  const void *in, void *out, vtkIdType n,
+                                  int dataType);
+
+  // Description:
+  // If in and out both hold 3-component float or double tuples of the
+  // same type, append as many tuples to out as there are in in, and
+  // return the data type along with pointers to the input tuples and to
+  // the appended ones.  Otherwise return 0 and leave out untouched.
+  static int PrepareBuffers(vtkDataArray *in, vtkDataArray *out,
+                            void *&inPtr, void *&outPtr);
+//ETX
+
   vtkMatrix4x4 *Matrix;
 
 private:
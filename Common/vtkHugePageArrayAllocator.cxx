@@ -0,0 +1,368 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkHugePageArrayAllocator.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+#include "vtkHugePageArrayAllocator.h"
+
+#include "vtkCriticalSection.h"
+#include "vtkMultiThreader.h"
+#include "vtkObjectFactory.h"
+
+#include <vtkstd/map>
+
+#if defined(__linux__)
+# include <sys/mman.h>
+# include <unistd.h>
+# define VTK_HUGE_PAGE_ARRAY_ALLOCATOR_USE_MMAP
+#endif
+
+vtkStandardNewMacro(vtkHugePageArrayAllocator);
+
+// Size of a huge page on x86-64 and most other platforms.
+#define VTK_HUGE_PAGE_SIZE (static_cast<size_t>(2) << 20)
+
+class vtkHugePageArrayAllocator::vtkInternals
+{
+public:
+  vtkInternals() : MappedBytes(0) {}
+
+  // Mapped blocks and their mapped length.
+  vtkstd::map<void*, size_t> Blocks;
+  vtkTypeInt64 MappedBytes;
+  vtkSimpleCriticalSection Lock;
+};
+
+//----------------------------------------------------------------------------
+vtkHugePageArrayAllocator::vtkHugePageArrayAllocator()
+{
+  this->MinimumSize = 32 << 20;
+  this->FirstTouchNumberOfThreads = 0;
+  this->Internals = new vtkInternals;
+}
+
+//----------------------------------------------------------------------------
+vtkHugePageArrayAllocator::~vtkHugePageArrayAllocator()
+{
+  // Arrays keep a reference to the allocator of their storage, so all
+  // blocks have been released by now.
+  delete this->Internals;
+}
+
+//----------------------------------------------------------------------------
+static size_t vtkHugePageArrayAllocatorRoundUp(size_t size)
+{
+  return (size + VTK_HUGE_PAGE_SIZE - 1) & ~(VTK_HUGE_PAGE_SIZE - 1);
+}
+
+#if defined(VTK_HUGE_PAGE_ARRAY_ALLOCATOR_USE_MMAP)
+//----------------------------------------------------------------------------
+// Map length bytes (a multiple of the huge page size) starting on a huge
+// page boundary.
+static char* vtkHugePageArrayAllocatorMapAligned(size_t length)
+{
+  // Map an extra huge page so that an aligned region can be carved out.
+  size_t mapLength = length + VTK_HUGE_PAGE_SIZE;
+  void* base = mmap(0, mapLength, PROT_READ | PROT_WRITE,
+                    MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if (base == MAP_FAILED)
+    {
+    return 0;
+    }
+  char* begin = static_cast<char*>(base);
+  char* aligned = reinterpret_cast<char*>(
+    (reinterpret_cast<size_t>(begin) + VTK_HUGE_PAGE_SIZE - 1) &
+    ~(VTK_HUGE_PAGE_SIZE - 1));
+  if (aligned > begin)
+    {
+    munmap(begin, aligned - begin);
+    }
+  char* end = aligned + length;
+  if (begin + mapLength > end)
+    {
+    munmap(end, begin + mapLength - end);
+    }
+  return aligned;
+}
+#endif
+
+//----------------------------------------------------------------------------
+void* vtkHugePageArrayAllocator::MapBlock(size_t size)
+{
+#if defined(VTK_HUGE_PAGE_ARRAY_ALLOCATOR_USE_MMAP)
+  size_t length = vtkHugePageArrayAllocatorRoundUp(size);
+  char* aligned = vtkHugePageArrayAllocatorMapAligned(length);
+  if (!aligned)
+    {
+    return 0;
+    }
+# if defined(MADV_HUGEPAGE)
+  madvise(aligned, length, MADV_HUGEPAGE);
+# endif
+
+  this->Internals->Lock.Lock();
+  this->Internals->Blocks[aligned] = length;
+  this->Internals->MappedBytes += length;
+  this->Internals->Lock.Unlock();
+  return aligned;
+#else
+  (void)size;
+  return 0;
+#endif
+}
+
+//----------------------------------------------------------------------------
+void* vtkHugePageArrayAllocator::RemapBlock(void* ptr, size_t,
+                                            size_t newSize)
+{
+#if defined(VTK_HUGE_PAGE_ARRAY_ALLOCATOR_USE_MMAP) && \
+    defined(MREMAP_MAYMOVE) && defined(MREMAP_FIXED)
+  this->Internals->Lock.Lock();
+  size_t oldLength = this->Internals->Blocks[ptr];
+  this->Internals->Lock.Unlock();
+  size_t newLength = vtkHugePageArrayAllocatorRoundUp(newSize);
+
+  // Resize in place if possible. Otherwise move the pages to a new aligned
+  // region: letting the kernel pick the address would lose the alignment.
+  void* newPtr = mremap(ptr, oldLength, newLength, 0);
+  if (newPtr == MAP_FAILED)
+    {
+    char* target = vtkHugePageArrayAllocatorMapAligned(newLength);
+    if (!target)
+      {
+      return 0;
+      }
+    newPtr = mremap(ptr, oldLength, newLength,
+                    MREMAP_MAYMOVE | MREMAP_FIXED, target);
+    if (newPtr == MAP_FAILED)
+      {
+      munmap(target, newLength);
+      return 0;
+      }
+    }
+# if defined(MADV_HUGEPAGE)
+  madvise(newPtr, newLength, MADV_HUGEPAGE);
+# endif
+
+  this->Internals->Lock.Lock();
+  this->Internals->Blocks.erase(ptr);
+  this->Internals->Blocks[newPtr] = newLength;
+  this->Internals->MappedBytes +=
+    static_cast<vtkTypeInt64>(newLength) - static_cast<vtkTypeInt64>(oldLength);
+  this->Internals->Lock.Unlock();
+  return newPtr;
+#else
+  (void)ptr;
+  (void)newSize;
+  return 0;
+#endif
+}
+
+//----------------------------------------------------------------------------
+void vtkHugePageArrayAllocator::UnmapBlock(void* ptr, size_t size)
+{
+#if defined(VTK_HUGE_PAGE_ARRAY_ALLOCATOR_USE_MMAP)
+  munmap(ptr, size);
+#else
+  (void)ptr;
+  (void)size;
+#endif
+}
+
+//----------------------------------------------------------------------------
+struct vtkHugePageArrayAllocatorTouchStruct
+{
+  char* Begin;
+  size_t Size;
+  size_t PageSize;
+  const char* Source;
+  size_t SourceSize;
+};
+
+//----------------------------------------------------------------------------
+static VTK_THREAD_RETURN_TYPE vtkHugePageArrayAllocatorTouch(void *arg)
+{
+  vtkMultiThreader::ThreadInfo* info =
+    static_cast<vtkMultiThreader::ThreadInfo*>(arg);
+  vtkHugePageArrayAllocatorTouchStruct* str =
+    static_cast<vtkHugePageArrayAllocatorTouchStruct*>(info->UserData);
+
+  // Same split as a vtkMultiThreader dividing the array in equal parts.
+  // The part of the block that receives old content is touched by copying
+  // it, the rest by writing the first byte of each page.
+  size_t numPages = (str->Size + str->PageSize - 1) / str->PageSize;
+  size_t first = numPages * info->ThreadID / info->NumberOfThreads;
+  size_t last = numPages * (info->ThreadID + 1) / info->NumberOfThreads;
+  size_t begin = first * str->PageSize;
+  size_t end = last * str->PageSize;
+  if (end > str->Size)
+    {
+    end = str->Size;
+    }
+  size_t copyEnd = (str->SourceSize < end ? str->SourceSize : end);
+  if (copyEnd > begin)
+    {
+    memcpy(str->Begin + begin, str->Source + begin, copyEnd - begin);
+    begin = copyEnd;
+    }
+  for (size_t page = first; page < last; ++page)
+    {
+    size_t offset = page * str->PageSize;
+    if (offset >= begin)
+      {
+      str->Begin[offset] = 0;
+      }
+    }
+  return VTK_THREAD_RETURN_VALUE;
+}
+
+//----------------------------------------------------------------------------
+void vtkHugePageArrayAllocator::FirstTouch(void* ptr, size_t size,
+                                           const void* source,
+                                           size_t sourceSize)
+{
+  if (this->FirstTouchNumberOfThreads <= 1)
+    {
+    if (sourceSize)
+      {
+      memcpy(ptr, source, sourceSize);
+      }
+    return;
+    }
+  vtkHugePageArrayAllocatorTouchStruct str;
+  str.Begin = static_cast<char*>(ptr);
+  str.Size = size;
+#if defined(VTK_HUGE_PAGE_ARRAY_ALLOCATOR_USE_MMAP)
+  str.PageSize = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+#else
+  str.PageSize = 4096;
+#endif
+  str.Source = static_cast<const char*>(source);
+  str.SourceSize = sourceSize;
+
+  vtkMultiThreader* threader = vtkMultiThreader::New();
+  threader->SetNumberOfThreads(this->FirstTouchNumberOfThreads);
+  threader->SetSingleMethod(vtkHugePageArrayAllocatorTouch, &str);
+  threader->SingleMethodExecute();
+  threader->Delete();
+}
+
+//----------------------------------------------------------------------------
+void* vtkHugePageArrayAllocator::Allocate(size_t size)
+{
+  if (size >= static_cast<size_t>(this->MinimumSize))
+    {
+    void* ptr = this->MapBlock(size);
+    if (ptr)
+      {
+      this->FirstTouch(ptr, size, 0, 0);
+      return ptr;
+      }
+    }
+  return this->Superclass::Allocate(size);
+}
+
+//----------------------------------------------------------------------------
+void* vtkHugePageArrayAllocator::Reallocate(void* ptr, size_t oldSize,
+                                            size_t newSize)
+{
+  this->Internals->Lock.Lock();
+  bool mapped =
+    this->Internals->Blocks.find(ptr) != this->Internals->Blocks.end();
+  this->Internals->Lock.Unlock();
+
+  if (mapped && newSize >= static_cast<size_t>(this->MinimumSize))
+    {
+    void* newPtr = this->RemapBlock(ptr, oldSize, newSize);
+    if (newPtr)
+      {
+      return newPtr;
+      }
+    }
+  else if (!mapped && newSize < static_cast<size_t>(this->MinimumSize))
+    {
+    return this->Superclass::Reallocate(ptr, oldSize, newSize);
+    }
+
+  // Moving between mapped and regular storage. A new mapped block is
+  // filled by the first touch threads, so that each of them owns the pages
+  // of its part.
+  size_t copySize = (oldSize < newSize ? oldSize : newSize);
+  void* newPtr = 0;
+  if (newSize >= static_cast<size_t>(this->MinimumSize))
+    {
+    newPtr = this->MapBlock(newSize);
+    if (newPtr)
+      {
+      this->FirstTouch(newPtr, newSize, ptr, copySize);
+      }
+    }
+  if (!newPtr)
+    {
+    newPtr = this->Superclass::Allocate(newSize);
+    if (newPtr)
+      {
+      memcpy(newPtr, ptr, copySize);
+      }
+    }
+  if (newPtr)
+    {
+    this->Free(ptr, oldSize);
+    }
+  return newPtr;
+}
+
+//----------------------------------------------------------------------------
+void vtkHugePageArrayAllocator::Free(void* ptr, size_t size)
+{
+  if (!ptr)
+    {
+    return;
+    }
+  this->Internals->Lock.Lock();
+  vtkstd::map<void*, size_t>::iterator it = this->Internals->Blocks.find(ptr);
+  size_t length = 0;
+  if (it != this->Internals->Blocks.end())
+    {
+    length = it->second;
+    this->Internals->MappedBytes -= static_cast<vtkTypeInt64>(length);
+    this->Internals->Blocks.erase(it);
+    }
+  this->Internals->Lock.Unlock();
+
+  if (length)
+    {
+    this->UnmapBlock(ptr, length);
+    }
+  else
+    {
+    this->Superclass::Free(ptr, size);
+    }
+}
+
+//----------------------------------------------------------------------------
+vtkTypeInt64 vtkHugePageArrayAllocator::GetMappedBytes()
+{
+  this->Internals->Lock.Lock();
+  vtkTypeInt64 bytes = this->Internals->MappedBytes;
+  this->Internals->Lock.Unlock();
+  return bytes;
+}
+
+//----------------------------------------------------------------------------
+void vtkHugePageArrayAllocator::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os,indent);
+  os << indent << "MinimumSize: " << this->MinimumSize << "\n";
+  os << indent << "FirstTouchNumberOfThreads: "
+     << this->FirstTouchNumberOfThreads << "\n";
+}
@@ -0,0 +1,105 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkHugePageArrayAllocator.h
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// .NAME vtkHugePageArrayAllocator - array allocator for very large arrays
+// .SECTION Description
+// vtkHugePageArrayAllocator maps blocks of at least MinimumSize bytes
+// directly from the operating system, aligned on huge page boundaries, and
+// asks for them to be backed by transparent huge pages. This reduces TLB
+// misses when traversing multi-gigabyte arrays, and lets such arrays grow
+// without copying (the pages are remapped instead). Smaller blocks are
+// handled as in vtkAlignedArrayAllocator.
+//
+// Pages of a freshly mapped block are not touched, so on NUMA systems
+// they end up on the memory node of the thread which first writes them.
+// If the data is going to be processed by a vtkMultiThreader splitting the
+// array in equal contiguous parts, set FirstTouchNumberOfThreads to the
+// number of threads: each part is then touched by its own thread at
+// allocation time, and when the array moves into a mapped block, each
+// part of its content is copied by that thread rather than by the thread
+// resizing the array.
+//
+// .SECTION Caveats
+// Huge pages are only requested on Linux. On other platforms large blocks
+// are allocated as small ones.
+//
+// .SECTION See Also
+// vtkArrayAllocator vtkAlignedArrayAllocator vtkDataArrayTemplate
+
+#ifndef __vtkHugePageArrayAllocator_h
+#define __vtkHugePageArrayAllocator_h
+
+#include "vtkAlignedArrayAllocator.h"
+
+class VTK_COMMON_EXPORT vtkHugePageArrayAllocator :
+  public vtkAlignedArrayAllocator
+{
+public:
+  static vtkHugePageArrayAllocator *New();
+  vtkTypeMacro(vtkHugePageArrayAllocator,vtkAlignedArrayAllocator);
+  void PrintSelf(ostream& os, vtkIndent indent);
+
+  // Description:
+  // Blocks of at least this many bytes are mapped with huge pages.
+  // The default is 32MB.
+  vtkSetMacro(MinimumSize, vtkIdType);
+  vtkGetMacro(MinimumSize, vtkIdType);
+
+  // Description:
+  // Number of threads touching the pages of a newly mapped block, each one
+  // a contiguous part of it. 0 or 1 (the default) leaves the pages
+  // untouched until the array is written, except for the old content of
+  // an array moving into the block, which is then copied by the calling
+  // thread.
+  vtkSetClampMacro(FirstTouchNumberOfThreads, int, 0, VTK_MAX_THREADS);
+  vtkGetMacro(FirstTouchNumberOfThreads, int);
+
+//BTX
+  virtual void* Allocate(size_t size);
+  virtual void* Reallocate(void* ptr, size_t oldSize, size_t newSize);
+  virtual void Free(void* ptr, size_t size);
+//ETX
+
+  // Description:
+  // Number of bytes currently mapped with huge pages by this allocator.
+  vtkTypeInt64 GetMappedBytes();
+
+protected:
+  vtkHugePageArrayAllocator();
+  ~vtkHugePageArrayAllocator();
+
+  vtkIdType MinimumSize;
+  int FirstTouchNumberOfThreads;
+
+  // Map, remap and unmap large blocks. Return 0 when not supported.
+  void* MapBlock(size_t size);
+  void* RemapBlock(void* ptr, size_t oldSize, size_t newSize);
+  void UnmapBlock(void* ptr, size_t size);
+
+  // Touch the pages of a new mapped block from FirstTouchNumberOfThreads
+  // threads, copying the first sourceSize bytes from source.
+  void FirstTouch(void* ptr, size_t size, const void* source,
+                  size_t sourceSize);
+
+//BTX
+  class vtkInternals;
+  vtkInternals* Internals;
+//ETX
+
+private:
+  vtkHugePageArrayAllocator(const vtkHugePageArrayAllocator&);  // Not implemented.
+  void operator=(const vtkHugePageArrayAllocator&);  // Not implemented.
+};
+
+#endif
@@ -16,6 +16,7 @@
 
 #include "vtkMath.h"
 #include "vtkAbstractTransform.h"
+#include "vtkDoubleArray.h"
 #include "vtkTransform.h"
 
 vtkCxxSetObjectMacro(vtkImplicitFunction,Transform,vtkAbstractTransform);
@@ -72,6 +73,50 @@ double vtkImplicitFunction::FunctionValue(const double x[3])
   */
 }
 
+// Evaluate function at the points of the input array. The points are
+// transformed through transform (if provided) before they are evaluated.
+void vtkImplicitFunction::FunctionValue(vtkDataArray *input,
+                                        vtkDataArray *output)
+{
+  if ( ! this->Transform )
+    {
+    this->EvaluateFunctions(input, output);
+    }
+  else //pass points through transform
+    {
+    vtkIdType numPts = input->GetNumberOfTuples();
+    vtkDoubleArray *points = vtkDoubleArray::New();
+    points->SetNumberOfComponents(3);
+    points->SetNumberOfTuples(numPts);
+    double *pt = points->GetPointer(0);
+    double x[3];
+    this->Transform->Update();
+    for (vtkIdType i = 0; i < numPts; i++, pt += 3)
+      {
+      input->GetTuple(i, x);
+      this->Transform->InternalTransformPoint(x, pt);
+      }
+    this->EvaluateFunctions(points, output);
+    points->Delete();
+    }
+}
+
+// Evaluate function at the points of the input array, one at a time.
+void vtkImplicitFunction::EvaluateFunctions(vtkDataArray *input,
+                                            vtkDataArray *output)
+{
+  vtkIdType numPts = input->GetNumberOfTuples();
+  output->SetNumberOfComponents(1);
+  output->SetNumberOfTuples(numPts);
+
+  double x[3];
+  for (vtkIdType i = 0; i < numPts; i++)
+    {
+    input->GetTuple(i, x);
+    output->SetComponent(i, 0, this->EvaluateFunction(x));
+    }
+}
+
 // Evaluate function gradient at position x-y-z and pass back vector. Point
 // x[3] is transformed through transform (if provided).
 void vtkImplicitFunction::FunctionGradient(const double x[3], double g[3])
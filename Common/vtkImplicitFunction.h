@@ -50,6 +50,7 @@
 #include "vtkObject.h"
 
 class vtkAbstractTransform;
+class vtkDataArray;
 
 class VTK_COMMON_EXPORT vtkImplicitFunction : public vtkObject
 {
@@ -69,6 +70,15 @@ public:
   double FunctionValue(double x, double y, double z) {
     double xyz[3] = {x, y, z}; return this->FunctionValue(xyz); };
 
+  // Description:
+  // Evaluate function at each of the x-y-z points of the input array and
+  // store the values in the output array, which is resized to one
+  // component per point.  The points are transformed through transform
+  // (if provided).  The function is evaluated for all of the points with
+  // a single virtual call, which is much faster than calling
+  // FunctionValue() for each point.
+  void FunctionValue(vtkDataArray *input, vtkDataArray *output);
+
   // Description:
   // Evaluate function gradient at position x-y-z and pass back vector. Point
   // x[3] is transformed through transform (if provided).
@@ -95,6 +105,14 @@ public:
   double EvaluateFunction(double x, double y, double z) {
     double xyz[3] = {x, y, z}; return this->EvaluateFunction(xyz); };
 
+  // Description:
+  // Evaluate function at each of the x-y-z points of the input array and
+  // store the values in the output array.  You should generally not call
+  // this method directly, you should use FunctionValue() instead.  The
+  // default implementation calls EvaluateFunction() for each point, and
+  // derived classes can override it to evaluate many points faster.
+  virtual void EvaluateFunctions(vtkDataArray *input, vtkDataArray *output);
+
   // Description:
   // Evaluate function gradient at position x-y-z and pass back vector. 
   // You should generally not call this method directly, you should use 
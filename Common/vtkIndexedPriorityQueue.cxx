@@ -0,0 +1,344 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkIndexedPriorityQueue.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+#include "vtkIndexedPriorityQueue.h"
+#include "vtkObjectFactory.h"
+
+vtkStandardNewMacro(vtkIndexedPriorityQueue);
+
+// Number of children of each node of the heap.
+#define VTK_HEAP_ARITY 4
+
+//----------------------------------------------------------------------------
+// Instantiate priority queue with default size and extension size of 1000.
+vtkIndexedPriorityQueue::vtkIndexedPriorityQueue()
+{
+  this->Priorities = NULL;
+  this->Ids = NULL;
+  this->Size = 0;
+  this->MaxId = -1;
+  this->Extend = 1000;
+  this->Locations = NULL;
+  this->NumberOfLocations = 0;
+}
+
+//----------------------------------------------------------------------------
+vtkIndexedPriorityQueue::~vtkIndexedPriorityQueue()
+{
+  delete [] this->Priorities;
+  delete [] this->Ids;
+  delete [] this->Locations;
+}
+
+//----------------------------------------------------------------------------
+// Allocate priority queue with specified size and amount to extend
+// queue (if reallocation required).
+void vtkIndexedPriorityQueue::Allocate(const vtkIdType sz,
+                                       const vtkIdType ext)
+{
+  delete [] this->Priorities;
+  delete [] this->Ids;
+  delete [] this->Locations;
+
+  this->Size = ( sz > 0 ? sz : 1 );
+  this->Priorities = new double[this->Size];
+  this->Ids = new vtkIdType[this->Size];
+  this->NumberOfLocations = this->Size;
+  this->Locations = new vtkIdType[this->NumberOfLocations];
+  for (vtkIdType i=0; i < this->NumberOfLocations; i++)
+    {
+    this->Locations[i] = -1;
+    }
+  this->Extend = ( ext > 0 ? ext : 1 );
+  this->MaxId = -1;
+}
+
+//----------------------------------------------------------------------------
+// Protected method reallocates the heap to hold sz items.
+void vtkIndexedPriorityQueue::Resize(const vtkIdType sz)
+{
+  vtkIdType newSize;
+
+  if ( sz >= this->Size )
+    {
+    newSize = this->Size + ( sz > this->Extend ? sz : this->Extend );
+    }
+  else
+    {
+    newSize = sz;
+    }
+  if ( newSize <= 0 )
+    {
+    newSize = 1;
+    }
+
+  double *newPriorities = new double[newSize];
+  vtkIdType *newIds = new vtkIdType[newSize];
+  vtkIdType numItems = this->MaxId + 1;
+  if ( numItems > newSize )
+    {
+    numItems = newSize;
+    }
+  if ( this->Priorities )
+    {
+    memcpy(newPriorities, this->Priorities, numItems * sizeof(double));
+    memcpy(newIds, this->Ids, numItems * sizeof(vtkIdType));
+    delete [] this->Priorities;
+    delete [] this->Ids;
+    }
+  this->Priorities = newPriorities;
+  this->Ids = newIds;
+  this->Size = newSize;
+}
+
+//----------------------------------------------------------------------------
+// Protected method makes room for the location of ids up to numIds-1.
+void vtkIndexedPriorityQueue::ResizeLocations(const vtkIdType numIds)
+{
+  vtkIdType newNumber = this->NumberOfLocations + this->Extend;
+  if ( newNumber < numIds )
+    {
+    newNumber = numIds;
+    }
+  if ( newNumber < 2*this->NumberOfLocations )
+    {
+    newNumber = 2*this->NumberOfLocations;
+    }
+
+  vtkIdType *newLocations = new vtkIdType[newNumber];
+  if ( this->Locations )
+    {
+    memcpy(newLocations, this->Locations,
+           this->NumberOfLocations * sizeof(vtkIdType));
+    delete [] this->Locations;
+    }
+  for (vtkIdType i=this->NumberOfLocations; i < newNumber; i++)
+    {
+    newLocations[i] = -1;
+    }
+  this->Locations = newLocations;
+  this->NumberOfLocations = newNumber;
+}
+
+//----------------------------------------------------------------------------
+// Move the item at location towards the top of the heap. The items it
+// passes are shifted down rather than swapped.
+void vtkIndexedPriorityQueue::SiftUp(vtkIdType location)
+{
+  double priority = this->Priorities[location];
+  vtkIdType id = this->Ids[location];
+
+  while ( location > 0 )
+    {
+    vtkIdType parent = (location - 1) / VTK_HEAP_ARITY;
+    if ( !(priority < this->Priorities[parent]) )
+      {
+      break;
+      }
+    this->Priorities[location] = this->Priorities[parent];
+    this->Ids[location] = this->Ids[parent];
+    this->Locations[this->Ids[location]] = location;
+    location = parent;
+    }
+
+  this->Priorities[location] = priority;
+  this->Ids[location] = id;
+  this->Locations[id] = location;
+}
+
+//----------------------------------------------------------------------------
+// Move the item at location towards the bottom of the heap.
+void vtkIndexedPriorityQueue::SiftDown(vtkIdType location)
+{
+  double priority = this->Priorities[location];
+  vtkIdType id = this->Ids[location];
+  vtkIdType numItems = this->MaxId + 1;
+  vtkIdType child;
+
+  while ( (child = VTK_HEAP_ARITY*location + 1) < numItems )
+    {
+    // Find the smallest child.
+    vtkIdType last = child + VTK_HEAP_ARITY;
+    if ( last > numItems )
+      {
+      last = numItems;
+      }
+    vtkIdType smallest = child;
+    double smallestPriority = this->Priorities[child];
+    for (++child; child < last; ++child)
+      {
+      if ( this->Priorities[child] < smallestPriority )
+        {
+        smallest = child;
+        smallestPriority = this->Priorities[child];
+        }
+      }
+
+    if ( !(smallestPriority < priority) )
+      {
+      break;
+      }
+    this->Priorities[location] = smallestPriority;
+    this->Ids[location] = this->Ids[smallest];
+    this->Locations[this->Ids[location]] = location;
+    location = smallest;
+    }
+
+  this->Priorities[location] = priority;
+  this->Ids[location] = id;
+  this->Locations[id] = location;
+}
+
+//----------------------------------------------------------------------------
+// Insert id with priority specified.
+void vtkIndexedPriorityQueue::Insert(double priority, vtkIdType id)
+{
+  if ( id < 0 )
+    {
+    return;
+    }
+  if ( id >= this->NumberOfLocations )
+    {
+    this->ResizeLocations(id + 1);
+    }
+  // check and make sure item hasn't been inserted before
+  else if ( this->Locations[id] != -1 )
+    {
+    return;
+    }
+
+  // start by placing new entry at bottom of the heap
+  if ( ++this->MaxId >= this->Size )
+    {
+    this->Resize(this->MaxId + 1);
+    }
+  this->Priorities[this->MaxId] = priority;
+  this->Ids[this->MaxId] = id;
+  this->SiftUp(this->MaxId);
+}
+
+//----------------------------------------------------------------------------
+// Simplified call for easier wrapping for Tcl.
+vtkIdType vtkIndexedPriorityQueue::Pop(vtkIdType location)
+{
+  double priority;
+  return this->Pop(location, priority);
+}
+
+//----------------------------------------------------------------------------
+// Removes item at specified location from the heap.
+vtkIdType vtkIndexedPriorityQueue::Pop(vtkIdType location, double &priority)
+{
+  if ( this->MaxId < 0 )
+    {
+    return -1;
+    }
+
+  vtkIdType id = this->Ids[location];
+  priority = this->Priorities[location];
+  this->Locations[id] = -1;
+
+  // move the last item to the location specified and restore the heap
+  // around it
+  vtkIdType last = this->MaxId--;
+  if ( location != last )
+    {
+    this->Priorities[location] = this->Priorities[last];
+    this->Ids[location] = this->Ids[last];
+    if ( location > 0 && this->Priorities[location] <
+         this->Priorities[(location - 1) / VTK_HEAP_ARITY] )
+      {
+      this->SiftUp(location);
+      }
+    else
+      {
+      this->SiftDown(location);
+      }
+    }
+
+  return id;
+}
+
+//----------------------------------------------------------------------------
+void vtkIndexedPriorityQueue::SetPriority(vtkIdType id, double priority)
+{
+  vtkIdType loc;
+  if ( id < 0 || id >= this->NumberOfLocations ||
+       (loc=this->Locations[id]) == -1 )
+    {
+    this->Insert(priority, id);
+    return;
+    }
+
+  double old = this->Priorities[loc];
+  this->Priorities[loc] = priority;
+  if ( priority < old )
+    {
+    this->SiftUp(loc);
+    }
+  else if ( old < priority )
+    {
+    this->SiftDown(loc);
+    }
+}
+
+//----------------------------------------------------------------------------
+void vtkIndexedPriorityQueue::DecreasePriority(vtkIdType id, double priority)
+{
+  vtkIdType loc;
+  if ( id < 0 || id >= this->NumberOfLocations ||
+       (loc=this->Locations[id]) == -1 )
+    {
+    this->Insert(priority, id);
+    return;
+    }
+  this->Priorities[loc] = priority;
+  this->SiftUp(loc);
+}
+
+//----------------------------------------------------------------------------
+void vtkIndexedPriorityQueue::IncreasePriority(vtkIdType id, double priority)
+{
+  vtkIdType loc;
+  if ( id < 0 || id >= this->NumberOfLocations ||
+       (loc=this->Locations[id]) == -1 )
+    {
+    this->Insert(priority, id);
+    return;
+    }
+  this->Priorities[loc] = priority;
+  this->SiftDown(loc);
+}
+
+//----------------------------------------------------------------------------
+// Reset all of the entries in the queue so they don not have a priority
+void vtkIndexedPriorityQueue::Reset()
+{
+  // Only the ids in the queue have a location to clear.
+  for (vtkIdType i=0; i <= this->MaxId; i++)
+    {
+    this->Locations[this->Ids[i]] = -1;
+    }
+  this->MaxId = -1;
+}
+
+//----------------------------------------------------------------------------
+void vtkIndexedPriorityQueue::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os,indent);
+
+  os << indent << "Number Of Entries: " << this->MaxId + 1 << "\n";
+  os << indent << "Size: " << this->Size << "\n";
+  os << indent << "Extend size: " << this->Extend << "\n";
+}
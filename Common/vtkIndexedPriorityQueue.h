@@ -0,0 +1,198 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkIndexedPriorityQueue.h
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// .NAME vtkIndexedPriorityQueue - a list of ids arranged in priority order, with mutable priorities
+// .SECTION Description
+// vtkIndexedPriorityQueue is a drop-in replacement for vtkPriorityQueue:
+// it holds object ids (e.g., point or edge ids) sorted according to a
+// priority, where entries at the top of the queue have the smallest values.
+// Any id in the queue may also be removed or looked up.
+//
+// In addition, the priority of an id already in the queue can be changed
+// in place with SetPriority(), DecreasePriority() or IncreasePriority(),
+// which is much cheaper than DeleteId() followed by Insert().
+//
+// .SECTION Caveats
+// The queue is a 4-ary heap. The priorities and the ids are stored in
+// separate arrays, so that the four children of a node, which are compared
+// together, share a cache line, and the tree is half as deep as a binary
+// heap. The location of each id in the heap is kept in a plain array
+// indexed by id, so ids should be reasonably dense.
+//
+// Entries of equal priority may come out in a different order than with
+// vtkPriorityQueue.
+//
+// .SECTION See Also
+// vtkPriorityQueue
+
+#ifndef __vtkIndexedPriorityQueue_h
+#define __vtkIndexedPriorityQueue_h
+
+#include "vtkObject.h"
+
+class VTK_COMMON_EXPORT vtkIndexedPriorityQueue : public vtkObject
+{
+public:
+  // Description:
+  // Instantiate priority queue with default size and extension size of 1000.
+  static vtkIndexedPriorityQueue *New();
+
+  vtkTypeMacro(vtkIndexedPriorityQueue,vtkObject);
+  void PrintSelf(ostream& os, vtkIndent indent);
+
+  // Description:
+  // Allocate initial space for priority queue. sz is the number of entries
+  // and the range of ids expected, ext the amount by which the queue grows
+  // when it has to.
+  void Allocate(const vtkIdType sz, const vtkIdType ext=1000);
+
+  // Description:
+  // Insert id with priority specified. The id is generally an
+  // index like a point id or cell id. Nothing is done if the id is already
+  // in the queue.
+  void Insert(double priority, vtkIdType id);
+
+//BTX
+  // Description:
+  // Removes item at specified location from the heap. The location == 0
+  // is the top of the queue. If queue is exhausted, then a value < 0 is
+  // returned. (Note: the location is not the same as deleting an id; id is
+  // mapped to location.)
+  vtkIdType Pop(vtkIdType location, double &priority);
+//ETX
+
+  // Description:
+  // Same as above but simplified for easier wrapping into interpreted
+  // languages.
+  vtkIdType Pop(vtkIdType location=0);
+
+//BTX
+  // Description:
+  // Peek into the queue without actually removing anything. Returns the
+  // id and the priority.
+  vtkIdType Peek(vtkIdType location, double &priority);
+//ETX
+
+  // Description:
+  // Peek into the queue without actually removing anything. Returns the
+  // id.
+  vtkIdType Peek(vtkIdType location=0);
+
+  // Description:
+  // Delete entry in queue with specified id. Returns priority value
+  // associated with that id; or VTK_DOUBLE_MAX if not in queue.
+  double DeleteId(vtkIdType id);
+
+  // Description:
+  // Get the priority of an entry in the queue with specified id. Returns
+  // priority value of that id or VTK_DOUBLE_MAX if not in queue.
+  double GetPriority(vtkIdType id);
+
+  // Description:
+  // Change the priority of id in place, moving it up or down the heap as
+  // needed. The id is inserted if it is not in the queue yet.
+  void SetPriority(vtkIdType id, double priority);
+
+  // Description:
+  // Same as SetPriority(), when the new priority is known to be lower
+  // (respectively higher) than the current one. Only one direction of the
+  // heap is then searched.
+  void DecreasePriority(vtkIdType id, double priority);
+  void IncreasePriority(vtkIdType id, double priority);
+
+  // Description:
+  // Return the number of items in this queue.
+  vtkIdType GetNumberOfItems() {return this->MaxId+1;};
+
+  // Description:
+  // Empty the queue but without releasing memory. This avoids the
+  // overhead of memory allocation/deletion.
+  void Reset();
+
+protected:
+  vtkIndexedPriorityQueue();
+  ~vtkIndexedPriorityQueue();
+
+  void Resize(const vtkIdType sz);
+  void ResizeLocations(const vtkIdType numIds);
+  void SiftUp(vtkIdType location);
+  void SiftDown(vtkIdType location);
+
+  double *Priorities;
+  vtkIdType *Ids;
+  vtkIdType Size;
+  vtkIdType MaxId;
+  vtkIdType Extend;
+
+  // Location of each id in the heap, -1 if the id is not in the queue.
+  vtkIdType *Locations;
+  vtkIdType NumberOfLocations;
+
+private:
+  vtkIndexedPriorityQueue(const vtkIndexedPriorityQueue&);  // Not implemented.
+  void operator=(const vtkIndexedPriorityQueue&);  // Not implemented.
+};
+
+inline double vtkIndexedPriorityQueue::DeleteId(vtkIdType id)
+{
+  double priority=VTK_DOUBLE_MAX;
+  vtkIdType loc;
+
+  if ( id >= 0 && id < this->NumberOfLocations &&
+       (loc=this->Locations[id]) != -1 )
+    {
+    this->Pop(loc,priority);
+    }
+  return priority;
+}
+
+inline double vtkIndexedPriorityQueue::GetPriority(vtkIdType id)
+{
+  vtkIdType loc;
+
+  if ( id >= 0 && id < this->NumberOfLocations &&
+       (loc=this->Locations[id]) != -1 )
+    {
+    return this->Priorities[loc];
+    }
+  return VTK_DOUBLE_MAX;
+}
+
+inline vtkIdType vtkIndexedPriorityQueue::Peek(vtkIdType location,
+                                               double &priority)
+{
+  if ( this->MaxId < 0 )
+    {
+    return -1;
+    }
+  else
+    {
+    priority = this->Priorities[location];
+    return this->Ids[location];
+    }
+}
+
+inline vtkIdType vtkIndexedPriorityQueue::Peek(vtkIdType location)
+{
+  if ( this->MaxId < 0 )
+    {
+    return -1;
+    }
+  else
+    {
+    return this->Ids[location];
+    }
+}
+
+#endif
@@ -92,6 +92,108 @@ inline void vtkLinearTransformNormal(T1 mat[4][4],
   vtkMath::Normalize(out);
 }
 
+//------------------------------------------------------------------------
+// The buffer kernels below do the same arithmetic as the functions above,
+// written as plain loops with the matrix kept in locals so that the
+// compiler can vectorize them.
+template <class T>
+void vtkLinearTransformPoints(double matrix[4][4], const T *in, T *out,
+                              vtkIdType n)
+{
+  const double m00 = matrix[0][0], m01 = matrix[0][1], m02 = matrix[0][2];
+  const double m10 = matrix[1][0], m11 = matrix[1][1], m12 = matrix[1][2];
+  const double m20 = matrix[2][0], m21 = matrix[2][1], m22 = matrix[2][2];
+  const double m03 = matrix[0][3], m13 = matrix[1][3], m23 = matrix[2][3];
+
+  for (vtkIdType i = 0; i < n; i++, in += 3, out += 3)
+    {
+    double x = in[0];
+    double y = in[1];
+    double z = in[2];
+    out[0] = static_cast<T>(m00*x + m01*y + m02*z + m03);
+    out[1] = static_cast<T>(m10*x + m11*y + m12*z + m13);
+    out[2] = static_cast<T>(m20*x + m21*y + m22*z + m23);
+    }
+}
+
+//------------------------------------------------------------------------
+template <class T>
+void vtkLinearTransformVectors(double matrix[4][4], const T *in, T *out,
+                               vtkIdType n)
+{
+  const double m00 = matrix[0][0], m01 = matrix[0][1], m02 = matrix[0][2];
+  const double m10 = matrix[1][0], m11 = matrix[1][1], m12 = matrix[1][2];
+  const double m20 = matrix[2][0], m21 = matrix[2][1], m22 = matrix[2][2];
+
+  for (vtkIdType i = 0; i < n; i++, in += 3, out += 3)
+    {
+    double x = in[0];
+    double y = in[1];
+    double z = in[2];
+    out[0] = static_cast<T>(m00*x + m01*y + m02*z);
+    out[1] = static_cast<T>(m10*x + m11*y + m12*z);
+    out[2] = static_cast<T>(m20*x + m21*y + m22*z);
+    }
+}
+
+//------------------------------------------------------------------------
+// matrix must already be the transposed inverse
+template <class T>
+void vtkLinearTransformNormals(double matrix[4][4], const T *in, T *out,
+                               vtkIdType n)
+{
+  const double m00 = matrix[0][0], m01 = matrix[0][1], m02 = matrix[0][2];
+  const double m10 = matrix[1][0], m11 = matrix[1][1], m12 = matrix[1][2];
+  const double m20 = matrix[2][0], m21 = matrix[2][1], m22 = matrix[2][2];
+
+  for (vtkIdType i = 0; i < n; i++, in += 3, out += 3)
+    {
+    double x = in[0];
+    double y = in[1];
+    double z = in[2];
+    double nx = m00*x + m01*y + m02*z;
+    double ny = m10*x + m11*y + m12*z;
+    double nz = m20*x + m21*y + m22*z;
+    double den = sqrt(nx*nx + ny*ny + nz*nz);
+    if (den != 0.0)
+      {
+      nx /= den;
+      ny /= den;
+      nz /= den;
+      }
+    out[0] = static_cast<T>(nx);
+    out[1] = static_cast<T>(ny);
+    out[2] = static_cast<T>(nz);
+    }
+}
+
+//------------------------------------------------------------------------
+template <class T>
+void vtkLinearTransformPointsKernel(double matrix[4][4], const void *in,
+                                    void *out, vtkIdType n)
+{
+  vtkLinearTransformPoints(matrix, static_cast<const T *>(in),
+                           static_cast<T *>(out), n);
+}
+
+//------------------------------------------------------------------------
+template <class T>
+void vtkLinearTransformVectorsKernel(double matrix[4][4], const void *in,
+                                     void *out, vtkIdType n)
+{
+  vtkLinearTransformVectors(matrix, static_cast<const T *>(in),
+                            static_cast<T *>(out), n);
+}
+
+//------------------------------------------------------------------------
+template <class T>
+void vtkLinearTransformNormalsKernel(double matrix[4][4], const void *in,
+                                     void *out, vtkIdType n)
+{
+  vtkLinearTransformNormals(matrix, static_cast<const T *>(in),
+                            static_cast<T *>(out), n);
+}
+
 //------------------------------------------------------------------------
 void vtkLinearTransform::InternalTransformPoint(const float in[3], 
                                                 float out[3])
@@ -150,6 +252,69 @@ void vtkLinearTransform::InternalTransformDerivative(const double in[3],
   vtkLinearTransformDerivative(this->Matrix->Element,in,out,derivative);
 }
 
+//----------------------------------------------------------------------------
+void vtkLinearTransform::InternalTransformPoints(const float *in,
+                                                 float *out, vtkIdType n)
+{
+  vtkLinearTransform::ExecuteBufferKernel(
+    vtkLinearTransformPointsKernel<float>, this->Matrix->Element,
+    in, out, n, VTK_FLOAT);
+}
+
+//----------------------------------------------------------------------------
+void vtkLinearTransform::InternalTransformPoints(const double *in,
+                                                 double *out, vtkIdType n)
+{
+  vtkLinearTransform::ExecuteBufferKernel(
+    vtkLinearTransformPointsKernel<double>, this->Matrix->Element,
+    in, out, n, VTK_DOUBLE);
+}
+
+//----------------------------------------------------------------------------
+void vtkLinearTransform::InternalTransformNormals(const float *in,
+                                                  float *out, vtkIdType n)
+{
+  // to transform the normal, multiply by the transposed inverse matrix
+  double matrix[4][4];
+  vtkMatrix4x4::DeepCopy(*matrix,this->Matrix);
+  vtkMatrix4x4::Invert(*matrix,*matrix);
+  vtkMatrix4x4::Transpose(*matrix,*matrix);
+
+  vtkLinearTransform::ExecuteBufferKernel(
+    vtkLinearTransformNormalsKernel<float>, matrix, in, out, n, VTK_FLOAT);
+}
+
+//----------------------------------------------------------------------------
+void vtkLinearTransform::InternalTransformNormals(const double *in,
+                                                  double *out, vtkIdType n)
+{
+  double matrix[4][4];
+  vtkMatrix4x4::DeepCopy(*matrix,this->Matrix);
+  vtkMatrix4x4::Invert(*matrix,*matrix);
+  vtkMatrix4x4::Transpose(*matrix,*matrix);
+
+  vtkLinearTransform::ExecuteBufferKernel(
+    vtkLinearTransformNormalsKernel<double>, matrix, in, out, n, VTK_DOUBLE);
+}
+
+//----------------------------------------------------------------------------
+void vtkLinearTransform::InternalTransformVectors(const float *in,
+                                                  float *out, vtkIdType n)
+{
+  vtkLinearTransform::ExecuteBufferKernel(
+    vtkLinearTransformVectorsKernel<float>, this->Matrix->Element,
+    in, out, n, VTK_FLOAT);
+}
+
+//----------------------------------------------------------------------------
+void vtkLinearTransform::InternalTransformVectors(const double *in,
+                                                  double *out, vtkIdType n)
+{
+  vtkLinearTransform::ExecuteBufferKernel(
+    vtkLinearTransformVectorsKernel<double>, this->Matrix->Element,
+    in, out, n, VTK_DOUBLE);
+}
+
 //----------------------------------------------------------------------------
 // Transform the normals and vectors using the derivative of the 
 // transformation.  Either inNms or inVrs can be set to NULL.
@@ -185,6 +350,22 @@ void vtkLinearTransform::TransformPoints(vtkPoints *inPts,
 
   this->Update();
 
+  // float and double points are transformed directly in their buffers
+  void *inPtr, *outPtr;
+  switch (vtkLinearTransform::PrepareBuffers(inPts->GetData(),
+                                             outPts->GetData(),
+                                             inPtr, outPtr))
+    {
+    case VTK_FLOAT:
+      this->InternalTransformPoints(static_cast<float *>(inPtr),
+                                    static_cast<float *>(outPtr), n);
+      return;
+    case VTK_DOUBLE:
+      this->InternalTransformPoints(static_cast<double *>(inPtr),
+                                    static_cast<double *>(outPtr), n);
+      return;
+    }
+
   for (vtkIdType i = 0; i < n; i++)
     {
     inPts->GetPoint(i,point);
@@ -205,6 +386,19 @@ void vtkLinearTransform::TransformNormals(vtkDataArray *inNms,
   
   this->Update();
 
+  void *inPtr, *outPtr;
+  switch (vtkLinearTransform::PrepareBuffers(inNms, outNms, inPtr, outPtr))
+    {
+    case VTK_FLOAT:
+      this->InternalTransformNormals(static_cast<float *>(inPtr),
+                                     static_cast<float *>(outPtr), n);
+      return;
+    case VTK_DOUBLE:
+      this->InternalTransformNormals(static_cast<double *>(inPtr),
+                                     static_cast<double *>(outPtr), n);
+      return;
+    }
+
   // to transform the normal, multiply by the transposed inverse matrix
   vtkMatrix4x4::DeepCopy(*matrix,this->Matrix);  
   vtkMatrix4x4::Invert(*matrix,*matrix);
@@ -231,6 +425,19 @@ void vtkLinearTransform::TransformVectors(vtkDataArray *inNms,
   
   this->Update();
 
+  void *inPtr, *outPtr;
+  switch (vtkLinearTransform::PrepareBuffers(inNms, outNms, inPtr, outPtr))
+    {
+    case VTK_FLOAT:
+      this->InternalTransformVectors(static_cast<float *>(inPtr),
+                                     static_cast<float *>(outPtr), n);
+      return;
+    case VTK_DOUBLE:
+      this->InternalTransformVectors(static_cast<double *>(inPtr),
+                                     static_cast<double *>(outPtr), n);
+      return;
+    }
+
   double (*matrix)[4] = this->Matrix->Element;
 
   for (vtkIdType i = 0; i < n; i++)
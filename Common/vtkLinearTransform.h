@@ -180,6 +180,23 @@ public:
   void InternalTransformDerivative(const double in[3], double out[3],
                                    double derivative[3][3]);
 
+//BTX
+  // Description:
+  // Transform n points, normals or vectors stored as consecutive
+  // (x,y,z) triples, writing the results to out, which may be the same
+  // buffer as in.  Large buffers are split across threads.  This will
+  // calculate the transformation without calling Update.  Meant for use
+  // only within other VTK classes.
+  void InternalTransformPoints(const float *in, float *out, vtkIdType n);
+  void InternalTransformPoints(const double *in, double *out, vtkIdType n);
+  void InternalTransformNormals(const float *in, float *out, vtkIdType n);
+  void InternalTransformNormals(const double *in, double *out,
+                                vtkIdType n);
+  void InternalTransformVectors(const float *in, float *out, vtkIdType n);
+  void InternalTransformVectors(const double *in, double *out,
+                                vtkIdType n);
+//ETX
+
 protected:
   vtkLinearTransform() {};
   ~vtkLinearTransform() {};
@@ -17,8 +17,19 @@
 #include "vtkObjectFactory.h"
 #include "vtkMath.h"
 #include "vtkMathConfigure.h"
+#include "vtkMultiThreader.h"
 #include <assert.h>
 
+#include <vtkstd/vector>
+
+// Scalars are only mapped by several threads when each thread gets at
+// least this many values, otherwise starting the threads costs more than
+// it saves.
+#define VTK_LOOKUP_TABLE_VALUES_PER_THREAD 262144
+
+// Number of values mapped at a time by the RGBA kernels below.
+#define VTK_LOOKUP_TABLE_BLOCK_SIZE 512
+
 vtkStandardNewMacro(vtkLookupTable);
 
 // Construct with range=(0,1); and hsv ranges set up for rainbow color table 
@@ -796,6 +807,250 @@ void vtkLookupTableMapData(vtkLookupTable *self, T *input,
     }//alpha blending
 }
 
+//----------------------------------------------------------------------------
+// Everything needed to map a range of the scalars, shared by all threads.
+// For RGBA output of float, double and unsigned char scalars the table
+// is baked once into Colors: one 32-bit RGBA value per table entry with
+// the alpha blending already applied, followed by the NaN color.  The
+// kernels below then only have to compute indices and copy 32-bit words.
+struct vtkLookupTableMapStruct
+{
+  vtkLookupTable *Self;
+  void *Input;
+  unsigned char *Output;
+  int DataType;
+  int DataTypeSize;
+  int InputIncrement;
+  int OutputFormat;
+  vtkIdType NumberOfValues;
+
+  int UseColors;
+  vtkstd::vector<vtkTypeUInt32> Colors;
+  // For unsigned char scalars, the color of each of the 256 values.
+  vtkstd::vector<vtkTypeUInt32> ByteColors;
+  int LogScale;
+  double Range[2];
+  double LogRange[2];
+  double Shift;
+  double Scale;
+  double MaxIndex;
+  int NanIndex;
+};
+
+//----------------------------------------------------------------------------
+// The same computation as vtkLinearLookup(), written so that the compiler
+// can vectorize it: a NaN goes through the clamping as 0 and is only then
+// replaced by the index of the NaN color.
+static void vtkLookupTableComputeIndices(const double *values, int *indices,
+                                         int n,
+                                         const vtkLookupTableMapStruct *str)
+{
+  const double shift = str->Shift;
+  const double scale = str->Scale;
+  const double maxIndex = str->MaxIndex;
+  const int nanIndex = str->NanIndex;
+
+  for (int j = 0; j < n; j++)
+    {
+    // NaN is replaced before the clamp, where it would raise an invalid
+    // operation exception
+    double v = values[j];
+    int isNan = !(v == v);
+    double findx = ((isNan ? 0.0 : v) + shift)*scale;
+    findx = (findx > 0 ? findx : 0);
+    findx = (findx < maxIndex ? findx : maxIndex);
+    indices[j] = (isNan ? nanIndex : static_cast<int>(findx));
+    }
+}
+
+//----------------------------------------------------------------------------
+template<class T>
+void vtkLookupTableMapToRGBA(const vtkLookupTableMapStruct *str,
+                             const T *input, unsigned char *output,
+                             vtkIdType length)
+{
+  double values[VTK_LOOKUP_TABLE_BLOCK_SIZE];
+  int indices[VTK_LOOKUP_TABLE_BLOCK_SIZE];
+  const vtkTypeUInt32 *colors = &str->Colors[0];
+  const int inIncr = str->InputIncrement;
+
+  while (length > 0)
+    {
+    int n = (length < VTK_LOOKUP_TABLE_BLOCK_SIZE ?
+             static_cast<int>(length) : VTK_LOOKUP_TABLE_BLOCK_SIZE);
+    int j;
+    if (str->LogScale)
+      {
+      for (j = 0; j < n; j++)
+        {
+        values[j] = vtkApplyLogScale(input[j*inIncr], str->Range,
+                                     str->LogRange);
+        }
+      }
+    else
+      {
+      for (j = 0; j < n; j++)
+        {
+        values[j] = input[j*inIncr];
+        }
+      }
+    vtkLookupTableComputeIndices(values, indices, n, str);
+    for (j = 0; j < n; j++)
+      {
+      memcpy(output + 4*j, colors + indices[j], 4);
+      }
+    input += n*inIncr;
+    output += 4*n;
+    length -= n;
+    }
+}
+
+//----------------------------------------------------------------------------
+// Every unsigned char value has its color baked in ByteColors.
+static void vtkLookupTableMapToRGBA(const vtkLookupTableMapStruct *str,
+                                    const unsigned char *input,
+                                    unsigned char *output, vtkIdType length)
+{
+  const vtkTypeUInt32 *colors = &str->ByteColors[0];
+  const int inIncr = str->InputIncrement;
+
+  for (vtkIdType i = 0; i < length; i++)
+    {
+    memcpy(output + 4*i, colors + input[i*inIncr], 4);
+    }
+}
+
+//----------------------------------------------------------------------------
+// Bake the table for the RGBA kernels.
+static void vtkLookupTableBakeColors(vtkLookupTableMapStruct *str)
+{
+  vtkLookupTable *self = str->Self;
+  double alpha = self->GetAlpha();
+  vtkIdType numColors = self->GetNumberOfColors();
+
+  unsigned char nanColor[4];
+  const double *nanColord = self->GetNanColor();
+  for (int c = 0; c < 4; c++)
+    {
+    double v = nanColord[c];
+    if (v < 0.0) { v = 0.0; }
+    else if (v > 1.0) { v = 1.0; }
+    nanColor[c] = static_cast<unsigned char>(v*255.0 + 0.5);
+    }
+
+  str->Colors.resize(numColors + 1);
+  for (vtkIdType i = 0; i <= numColors; i++)
+    {
+    unsigned char rgba[4];
+    memcpy(rgba, (i < numColors ? self->GetPointer(i) : nanColor), 4);
+    if (alpha < 1.0)
+      {
+      rgba[3] = static_cast<unsigned char>(rgba[3]*alpha + 0.5);
+      }
+    memcpy(&str->Colors[i], rgba, 4);
+    }
+
+  str->MaxIndex = numColors - 1;
+  str->NanIndex = static_cast<int>(numColors);
+  str->LogScale = (self->GetScale() == VTK_SCALE_LOG10);
+  str->Range[0] = self->GetTableRange()[0];
+  str->Range[1] = self->GetTableRange()[1];
+  if (str->LogScale)
+    {
+    vtkLookupTableLogRange(str->Range, str->LogRange);
+    str->Shift = -str->LogRange[0];
+    if (str->LogRange[1] <= str->LogRange[0])
+      {
+      str->Scale = VTK_DOUBLE_MAX;
+      }
+    else
+      {
+      str->Scale = (str->MaxIndex + 1)/(str->LogRange[1] - str->LogRange[0]);
+      }
+    }
+  else
+    {
+    str->Shift = -str->Range[0];
+    if (str->Range[1] <= str->Range[0])
+      {
+      str->Scale = VTK_DOUBLE_MAX;
+      }
+    else
+      {
+      str->Scale = (str->MaxIndex + 1)/(str->Range[1] - str->Range[0]);
+      }
+    }
+
+  if (str->DataType == VTK_UNSIGNED_CHAR)
+    {
+    unsigned char values[256];
+    for (int v = 0; v < 256; v++)
+      {
+      values[v] = static_cast<unsigned char>(v);
+      }
+    str->ByteColors.resize(256);
+    vtkLookupTableMapStruct byteStr = *str;
+    byteStr.InputIncrement = 1;
+    vtkLookupTableMapToRGBA<unsigned char>(
+      &byteStr, values, reinterpret_cast<unsigned char *>(&str->ByteColors[0]),
+      256);
+    }
+}
+
+//----------------------------------------------------------------------------
+// Map the values [begin,end) of the scalars.
+static void vtkLookupTableMapRange(vtkLookupTableMapStruct *str,
+                                   vtkIdType begin, vtkIdType end)
+{
+  void *input = static_cast<char *>(str->Input) +
+    begin*str->InputIncrement*str->DataTypeSize;
+  unsigned char *output = str->Output + begin*str->OutputFormat;
+  vtkIdType length = end - begin;
+
+  if (str->UseColors)
+    {
+    switch (str->DataType)
+      {
+      case VTK_FLOAT:
+        vtkLookupTableMapToRGBA(str, static_cast<float *>(input), output,
+                                length);
+        return;
+      case VTK_DOUBLE:
+        vtkLookupTableMapToRGBA(str, static_cast<double *>(input), output,
+                                length);
+        return;
+      case VTK_UNSIGNED_CHAR:
+        vtkLookupTableMapToRGBA(str, static_cast<unsigned char *>(input),
+                                output, length);
+        return;
+      }
+    }
+
+  switch (str->DataType)
+    {
+    vtkTemplateMacro(
+      vtkLookupTableMapData(str->Self,static_cast<VTK_TT*>(input),output,
+                            static_cast<int>(length),str->InputIncrement,
+                            str->OutputFormat)
+      );
+    }
+}
+
+//----------------------------------------------------------------------------
+static VTK_THREAD_RETURN_TYPE vtkLookupTableMapThread(void *arg)
+{
+  vtkMultiThreader::ThreadInfo *info =
+    static_cast<vtkMultiThreader::ThreadInfo *>(arg);
+  vtkLookupTableMapStruct *str =
+    static_cast<vtkLookupTableMapStruct *>(info->UserData);
+
+  vtkIdType n = str->NumberOfValues;
+  vtkLookupTableMapRange(str, n*info->ThreadID/info->NumberOfThreads,
+                         n*(info->ThreadID + 1)/info->NumberOfThreads);
+
+  return VTK_THREAD_RETURN_VALUE;
+}
+
 //----------------------------------------------------------------------------
 void vtkLookupTable::MapScalarsThroughTable2(void *input, 
                                              unsigned char *output,
@@ -804,6 +1059,8 @@ void vtkLookupTable::MapScalarsThroughTable2(void *input,
                                              int inputIncrement,
                                              int outputFormat)
 {
+  vtkLookupTableMapStruct str;
+
   switch (inputDataType)
     {
     case VTK_BIT:
@@ -824,16 +1081,46 @@ void vtkLookupTable::MapScalarsThroughTable2(void *input,
       newInput->Delete();
       bitArray->Delete();
       }
-      break;
+      return;
 
-    vtkTemplateMacro(
-      vtkLookupTableMapData(this,static_cast<VTK_TT*>(input),output,
-                            numberOfValues,inputIncrement,outputFormat)
-      );
+    vtkTemplateMacro(str.DataTypeSize = static_cast<int>(sizeof(VTK_TT)));
     default:
       vtkErrorMacro(<< "MapImageThroughTable: Unknown input ScalarType");
       return;
     }
+
+  str.Self = this;
+  str.Input = input;
+  str.Output = output;
+  str.DataType = inputDataType;
+  str.InputIncrement = inputIncrement;
+  str.OutputFormat = outputFormat;
+  str.NumberOfValues = numberOfValues;
+  str.UseColors = (outputFormat == VTK_RGBA && this->NumberOfColors > 0 &&
+                   (inputDataType == VTK_FLOAT ||
+                    inputDataType == VTK_DOUBLE ||
+                    inputDataType == VTK_UNSIGNED_CHAR));
+  if (str.UseColors)
+    {
+    vtkLookupTableBakeColors(&str);
+    }
+
+  int numThreads = numberOfValues/VTK_LOOKUP_TABLE_VALUES_PER_THREAD;
+  if (numThreads > vtkMultiThreader::GetGlobalDefaultNumberOfThreads())
+    {
+    numThreads = vtkMultiThreader::GetGlobalDefaultNumberOfThreads();
+    }
+  if (numThreads <= 1)
+    {
+    vtkLookupTableMapRange(&str, 0, numberOfValues);
+    return;
+    }
+
+  vtkMultiThreader *threader = vtkMultiThreader::New();
+  threader->SetNumberOfThreads(numThreads);
+  threader->SetSingleMethod(vtkLookupTableMapThread, &str);
+  threader->SingleMethodExecute();
+  threader->Delete();
 }  
 
 //----------------------------------------------------------------------------
@@ -13,6 +13,7 @@
 
 =========================================================================*/
 #include "vtkPlane.h"
+#include "vtkDoubleArray.h"
 #include "vtkMath.h"
 #include "vtkObjectFactory.h"
 
@@ -137,6 +138,31 @@ double vtkPlane::EvaluateFunction(double x[3])
            this->Normal[2]*(x[2]-this->Origin[2]) );
 }
 
+// Evaluate plane equation for each of the points of the input array.
+void vtkPlane::EvaluateFunctions(vtkDataArray *input, vtkDataArray *output)
+{
+  vtkDoubleArray *points = vtkDoubleArray::SafeDownCast(input);
+  vtkDoubleArray *values = vtkDoubleArray::SafeDownCast(output);
+  if ( !points || !values || points->GetNumberOfComponents() != 3 )
+    {
+    this->Superclass::EvaluateFunctions(input, output);
+    return;
+    }
+
+  vtkIdType numPts = points->GetNumberOfTuples();
+  values->SetNumberOfComponents(1);
+  values->SetNumberOfTuples(numPts);
+  const double *x = points->GetPointer(0);
+  double *s = values->GetPointer(0);
+
+  for (vtkIdType i = 0; i < numPts; i++, x += 3)
+    {
+    s[i] = ( this->Normal[0]*(x[0]-this->Origin[0]) + 
+             this->Normal[1]*(x[1]-this->Origin[1]) + 
+             this->Normal[2]*(x[2]-this->Origin[2]) );
+    }
+}
+
 // Evaluate function gradient at point x[3].
 void vtkPlane::EvaluateGradient(double vtkNotUsed(x)[3], double n[3])
 {
@@ -40,6 +40,10 @@ public:
   double EvaluateFunction(double x, double y, double z)
     {return this->vtkImplicitFunction::EvaluateFunction(x, y, z); } ;
 
+  // Description
+  // Evaluate plane equation for each of the points of the input array.
+  void EvaluateFunctions(vtkDataArray *input, vtkDataArray *output);
+
   // Description
   // Evaluate function gradient at point x[3].
   void EvaluateGradient(double x[3], double g[3]);
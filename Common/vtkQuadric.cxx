@@ -13,6 +13,7 @@
 
 =========================================================================*/
 #include "vtkQuadric.h"
+#include "vtkDoubleArray.h"
 #include "vtkObjectFactory.h"
 
 #include <math.h>
@@ -67,6 +68,32 @@ double vtkQuadric::EvaluateFunction(double x[3])
            a[6]*x[0] + a[7]*x[1] + a[8]*x[2] + a[9] );
 }
 
+// Evaluate quadric equation for each of the points of the input array.
+void vtkQuadric::EvaluateFunctions(vtkDataArray *input, vtkDataArray *output)
+{
+  vtkDoubleArray *points = vtkDoubleArray::SafeDownCast(input);
+  vtkDoubleArray *values = vtkDoubleArray::SafeDownCast(output);
+  if ( !points || !values || points->GetNumberOfComponents() != 3 )
+    {
+    this->Superclass::EvaluateFunctions(input, output);
+    return;
+    }
+
+  vtkIdType numPts = points->GetNumberOfTuples();
+  values->SetNumberOfComponents(1);
+  values->SetNumberOfTuples(numPts);
+  const double *x = points->GetPointer(0);
+  double *s = values->GetPointer(0);
+  double *a = this->Coefficients;
+
+  for (vtkIdType i = 0; i < numPts; i++, x += 3)
+    {
+    s[i] = ( a[0]*x[0]*x[0] + a[1]*x[1]*x[1] + a[2]*x[2]*x[2] +
+             a[3]*x[0]*x[1] + a[4]*x[1]*x[2] + a[5]*x[0]*x[2] +
+             a[6]*x[0] + a[7]*x[1] + a[8]*x[2] + a[9] );
+    }
+}
+
 // Evaluate the gradient to the quadric equation.
 void vtkQuadric::EvaluateGradient(double x[3], double n[3])
 {
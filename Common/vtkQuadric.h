@@ -39,6 +39,10 @@ public:
   double EvaluateFunction(double x, double y, double z)
     {return this->vtkImplicitFunction::EvaluateFunction(x, y, z); } ;
 
+  // Description
+  // Evaluate quadric equation for each of the points of the input array.
+  void EvaluateFunctions(vtkDataArray *input, vtkDataArray *output);
+
   // Description
   // Evaluate the gradient to the quadric equation.
   void EvaluateGradient(double x[3], double g[3]);
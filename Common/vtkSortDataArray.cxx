@@ -26,6 +26,7 @@
 
 #include "vtkAbstractArray.h"
 #include "vtkMath.h"
+#include "vtkMultiThreader.h"
 #include "vtkObjectFactory.h"
 #include "vtkIdList.h"
 #include "vtkStdString.h"
@@ -34,6 +35,11 @@
 #include "vtkVariantArray.h"
 
 #include <vtkstd/algorithm>
+#include <vtkstd/vector>
+
+// Arrays are only sorted by several threads when each thread gets at
+// least this many values.
+#define VTK_SORT_DATA_ARRAY_VALUES_PER_THREAD 65536
 
 // -------------------------------------------------------------------------
 
@@ -184,38 +190,243 @@ void vtkSortDataArrayQuickSort(TKey *keys, TValue *values,
 }
 
 // ---------------------------------------------------------------------------
-// Data array to raw array template helper functions
+// Parallel merge sort: each thread sorts a chunk of the data, then the
+// sorted chunks are merged two by two, with all the merges of a round
+// running in parallel, until a single chunk remains.
 
-template<class TKey, class TValue, class TComp>
-inline void vtkSortDataArraySort00(TKey *keys, TValue *values,
-                                   vtkIdType array_size, int tuple_size, TComp comp)
+static int vtkSortDataArrayNumberOfThreads(vtkIdType size)
 {
-  vtkSortDataArrayQuickSort(keys, values, array_size, tuple_size, comp);
+  vtkIdType numThreads = size/VTK_SORT_DATA_ARRAY_VALUES_PER_THREAD;
+  if (numThreads > vtkMultiThreader::GetGlobalDefaultNumberOfThreads())
+    {
+    numThreads = vtkMultiThreader::GetGlobalDefaultNumberOfThreads();
+    }
+  return numThreads < 1 ? 1 : static_cast<int>(numThreads);
 }
 
-template<class TKey, class TValue>
-inline void vtkSortDataArraySort00(TKey *keys, TValue *values,
-                                   vtkIdType array_size, int tuple_size)
+static void vtkSortDataArrayExecute(vtkThreadFunctionType function,
+                                    void *data, int numThreads)
 {
-  vtkSortDataArrayQuickSort(keys, values, array_size, tuple_size);
+  vtkMultiThreader *threader = vtkMultiThreader::New();
+  threader->SetNumberOfThreads(numThreads);
+  threader->SetSingleMethod(function, data);
+  threader->SingleMethodExecute();
+  threader->Delete();
 }
 
-template<class TKey, class TComp>
-void vtkSortDataArraySort01(TKey *keys, vtkAbstractArray *values, vtkIdType array_size,
-                            TComp comp)
+struct vtkSortDataArrayLess
 {
-  if (array_size != values->GetNumberOfTuples())
+  template<class T>
+  bool operator()(const T &a, const T &b) const
     {
-    vtkGenericWarningMacro("Could not sort arrays.  Key and value arrays have different sizes.");
+    return a < b;
+    }
+};
+
+template<class T, class TComp>
+struct vtkSortDataArrayMergeSortInfo
+{
+  T *Source;
+  T *Destination;
+  vtkIdType Size;
+  int NumberOfChunks;
+  // number of chunks already merged together at this round
+  int Width;
+  TComp Comp;
+
+  vtkIdType ChunkBegin(int chunk) const
+    {
+    if (chunk > this->NumberOfChunks)
+      {
+      chunk = this->NumberOfChunks;
+      }
+    return this->Size*chunk/this->NumberOfChunks;
+    }
+};
+
+template<class T, class TComp>
+VTK_THREAD_RETURN_TYPE vtkSortDataArraySortChunk(void *arg)
+{
+  vtkMultiThreader::ThreadInfo *info =
+    static_cast<vtkMultiThreader::ThreadInfo *>(arg);
+  vtkSortDataArrayMergeSortInfo<T, TComp> *str =
+    static_cast<vtkSortDataArrayMergeSortInfo<T, TComp> *>(info->UserData);
+
+  vtkstd::sort(str->Source + str->ChunkBegin(info->ThreadID),
+               str->Source + str->ChunkBegin(info->ThreadID + 1), str->Comp);
+
+  return VTK_THREAD_RETURN_VALUE;
+}
+
+template<class T, class TComp>
+VTK_THREAD_RETURN_TYPE vtkSortDataArrayMergeChunks(void *arg)
+{
+  vtkMultiThreader::ThreadInfo *info =
+    static_cast<vtkMultiThreader::ThreadInfo *>(arg);
+  vtkSortDataArrayMergeSortInfo<T, TComp> *str =
+    static_cast<vtkSortDataArrayMergeSortInfo<T, TComp> *>(info->UserData);
+
+  int first = 2*str->Width*info->ThreadID;
+  vtkIdType begin = str->ChunkBegin(first);
+  vtkIdType middle = str->ChunkBegin(first + str->Width);
+  vtkIdType end = str->ChunkBegin(first + 2*str->Width);
+  vtkstd::merge(str->Source + begin, str->Source + middle,
+                str->Source + middle, str->Source + end,
+                str->Destination + begin, str->Comp);
+
+  return VTK_THREAD_RETURN_VALUE;
+}
+
+template<class T, class TComp>
+void vtkSortDataArrayParallelSort(T *data, vtkIdType size, TComp comp)
+{
+  int numChunks = vtkSortDataArrayNumberOfThreads(size);
+  if (numChunks <= 1)
+    {
+    vtkstd::sort(data, data + size, comp);
     return;
     }
 
-  switch (values->GetDataType())
+  vtkstd::vector<T> buffer(size);
+  vtkSortDataArrayMergeSortInfo<T, TComp> str;
+  str.Source = data;
+  str.Destination = &buffer[0];
+  str.Size = size;
+  str.NumberOfChunks = numChunks;
+  str.Comp = comp;
+
+  vtkSortDataArrayExecute(vtkSortDataArraySortChunk<T, TComp>, &str,
+                          numChunks);
+
+  for (str.Width = 1; str.Width < numChunks; str.Width *= 2)
     {
-    vtkExtraExtendedTemplateMacro(
-      vtkSortDataArraySort00(keys, static_cast<VTK_TT *>(values->GetVoidPointer(0)),
-                             array_size, values->GetNumberOfComponents(), comp));
+    int numMerges = (numChunks + 2*str.Width - 1)/(2*str.Width);
+    vtkSortDataArrayExecute(vtkSortDataArrayMergeChunks<T, TComp>, &str,
+                            numMerges);
+    vtkstd::swap(str.Source, str.Destination);
+    }
+
+  if (str.Source != data)
+    {
+    vtkstd::copy(str.Source, str.Source + size, data);
+    }
+}
+
+template<class T>
+void vtkSortDataArrayParallelSort(T *data, vtkIdType size)
+{
+  vtkSortDataArrayParallelSort(data, size, vtkSortDataArrayLess());
+}
+
+// ---------------------------------------------------------------------------
+// Stable sort permutation: the keys are sorted along with their index,
+// which breaks the ties.
+
+template<class TKey>
+struct vtkSortDataArrayIndexedKey
+{
+  TKey Key;
+  vtkIdType Index;
+};
+
+template<class TKey, class TComp>
+struct vtkSortDataArrayIndexedKeyLess
+{
+  TComp Comp;
+
+  bool operator()(const vtkSortDataArrayIndexedKey<TKey> &a,
+                  const vtkSortDataArrayIndexedKey<TKey> &b) const
+    {
+    if (this->Comp(a.Key, b.Key))
+      {
+      return true;
+      }
+    if (this->Comp(b.Key, a.Key))
+      {
+      return false;
+      }
+    return a.Index < b.Index;
+    }
+};
+
+template<class TKey, class TComp>
+void vtkSortDataArrayPermutation(const TKey *keys, vtkIdType size,
+                                 vtkIdType *permutation, TComp comp)
+{
+  vtkstd::vector<vtkSortDataArrayIndexedKey<TKey> > indexed(size);
+  for (vtkIdType i = 0; i < size; i++)
+    {
+    indexed[i].Key = keys[i];
+    indexed[i].Index = i;
+    }
+
+  vtkSortDataArrayIndexedKeyLess<TKey, TComp> less;
+  less.Comp = comp;
+  if (size > 0)
+    {
+    vtkSortDataArrayParallelSort(&indexed[0], size, less);
+    }
+
+  for (vtkIdType i = 0; i < size; i++)
+    {
+    permutation[i] = indexed[i].Index;
+    }
+}
+
+template<class TKey>
+void vtkSortDataArrayPermutation(const TKey *keys, vtkIdType size,
+                                 vtkIdType *permutation)
+{
+  vtkSortDataArrayPermutation(keys, size, permutation,
+                              vtkSortDataArrayLess());
+}
+
+// ---------------------------------------------------------------------------
+// Gathering of the tuples of plain data arrays, in parallel.
+
+struct vtkSortDataArrayPermuteInfo
+{
+  const vtkIdType *Permutation;
+  vtkIdType Size;
+  const char *Source;
+  char *Destination;
+  int TupleSize;
+};
+
+static VTK_THREAD_RETURN_TYPE vtkSortDataArrayPermuteThread(void *arg)
+{
+  vtkMultiThreader::ThreadInfo *info =
+    static_cast<vtkMultiThreader::ThreadInfo *>(arg);
+  vtkSortDataArrayPermuteInfo *str =
+    static_cast<vtkSortDataArrayPermuteInfo *>(info->UserData);
+
+  vtkIdType begin = str->Size*info->ThreadID/info->NumberOfThreads;
+  vtkIdType end = str->Size*(info->ThreadID + 1)/info->NumberOfThreads;
+  const size_t tupleSize = static_cast<size_t>(str->TupleSize);
+  for (vtkIdType i = begin; i < end; i++)
+    {
+    memcpy(str->Destination + i*tupleSize,
+           str->Source + str->Permutation[i]*tupleSize, tupleSize);
     }
+
+  return VTK_THREAD_RETURN_VALUE;
+}
+
+// ---------------------------------------------------------------------------
+// Data array to raw array template helper functions
+
+template<class TKey, class TValue, class TComp>
+inline void vtkSortDataArraySort00(TKey *keys, TValue *values,
+                                   vtkIdType array_size, int tuple_size, TComp comp)
+{
+  vtkSortDataArrayQuickSort(keys, values, array_size, tuple_size, comp);
+}
+
+template<class TKey, class TValue>
+inline void vtkSortDataArraySort00(TKey *keys, TValue *values,
+                                   vtkIdType array_size, int tuple_size)
+{
+  vtkSortDataArrayQuickSort(keys, values, array_size, tuple_size);
 }
 
 template<class TKey>
@@ -259,17 +470,6 @@ void vtkSortDataArraySort10(vtkAbstractArray *keys, TValue *values,
     }
 }
 
-void vtkSortDataArraySort11(vtkAbstractArray *keys, vtkAbstractArray *values)
-{
-  switch (values->GetDataType())
-    {
-    vtkExtraExtendedTemplateMacro(
-      vtkSortDataArraySort10(keys, static_cast<VTK_TT *>(values->GetVoidPointer(0)),
-                             values->GetNumberOfTuples(),
-                             values->GetNumberOfComponents()));
-    }
-}
-
 // The component that qsort should use to compare tuples.
 // This is ugly and not thread-safe but it works.
 static int vtkSortDataArrayComp = 0;
@@ -398,7 +598,7 @@ void vtkSortDataArray::Sort(vtkIdList *keys)
 {
   vtkIdType *data = keys->GetPointer(0);
   vtkIdType numKeys = keys->GetNumberOfIds();
-  vtkstd::sort(data, data + numKeys);
+  vtkSortDataArrayParallelSort(data, numKeys);
 }
 
 void vtkSortDataArray::Sort(vtkAbstractArray *keys)
@@ -414,7 +614,7 @@ void vtkSortDataArray::Sort(vtkAbstractArray *keys)
 
   switch (keys->GetDataType())
     {
-    vtkExtendedTemplateMacro(vtkstd::sort(static_cast<VTK_TT *>(data), static_cast<VTK_TT *>(data) + numKeys));
+    vtkExtendedTemplateMacro(vtkSortDataArrayParallelSort(static_cast<VTK_TT *>(data), numKeys));
     }
 }
 
@@ -583,14 +783,124 @@ void vtkSortDataArray::Sort(vtkAbstractArray *keys, vtkIdList *values)
 
 void vtkSortDataArray::Sort(vtkAbstractArray *keys, vtkAbstractArray *values)
 {
-  if (keys->GetDataType() == VTK_VARIANT)
+  // Sort through a stable permutation, which is computed and applied in
+  // parallel for large arrays, so that equal keys keep the order of their
+  // values whatever the size of the arrays.
+  vtkSortDataArray::Sort(keys, &values, 1);
+}
+
+void vtkSortDataArray::Sort(vtkAbstractArray *keys, vtkAbstractArray **values,
+                            int numberOfValueArrays)
+{
+  if (keys->GetNumberOfComponents() != 1)
     {
-    vtkVariantLessThan comp;
-    vtkSortDataArraySort01(
-      static_cast<vtkVariant*>(keys->GetVoidPointer(0)), values, keys->GetNumberOfTuples(), comp);
+    vtkGenericWarningMacro("Could not sort arrays.  Keys must be 1-tuples.");
+    return;
     }
-  else
+  for (int i = 0; i < numberOfValueArrays; i++)
+    {
+    if (values[i]->GetNumberOfTuples() != keys->GetNumberOfTuples())
+      {
+      vtkGenericWarningMacro("Could not sort arrays.  Key and value arrays have different sizes.");
+      return;
+      }
+    }
+
+  vtkIdList *permutation = vtkIdList::New();
+  vtkSortDataArray::GetSortPermutation(keys, permutation);
+  vtkSortDataArray::ApplyPermutation(permutation, &keys, 1);
+  vtkSortDataArray::ApplyPermutation(permutation, values, numberOfValueArrays);
+  permutation->Delete();
+}
+
+void vtkSortDataArray::GetSortPermutation(vtkAbstractArray *keys,
+                                          vtkIdList *permutation)
+{
+  if (keys->GetNumberOfComponents() != 1)
+    {
+    vtkGenericWarningMacro("Can only sort keys that are 1-tuples.");
+    return;
+    }
+
+  vtkIdType numKeys = keys->GetNumberOfTuples();
+  permutation->SetNumberOfIds(numKeys);
+  if (numKeys == 0)
+    {
+    return;
+    }
+
+  void *data = keys->GetVoidPointer(0);
+  switch (keys->GetDataType())
     {
-    vtkSortDataArraySort11(keys, values);
+    vtkExtendedTemplateMacro(
+      vtkSortDataArrayPermutation(static_cast<VTK_TT *>(data), numKeys,
+                                  permutation->GetPointer(0)));
+    case VTK_VARIANT:
+      vtkSortDataArrayPermutation(static_cast<vtkVariant *>(data), numKeys,
+                                  permutation->GetPointer(0),
+                                  vtkVariantLessThan());
+      break;
+    default:
+      vtkGenericWarningMacro("Cannot sort keys of type "
+                             << keys->GetDataTypeAsString());
+      for (vtkIdType i = 0; i < numKeys; i++)
+        {
+        permutation->SetId(i, i);
+        }
+    }
+}
+
+void vtkSortDataArray::ApplyPermutation(vtkIdList *permutation,
+                                        vtkAbstractArray *array)
+{
+  vtkSortDataArray::ApplyPermutation(permutation, &array, 1);
+}
+
+void vtkSortDataArray::ApplyPermutation(vtkIdList *permutation,
+                                        vtkAbstractArray **arrays,
+                                        int numberOfArrays)
+{
+  vtkIdType size = permutation->GetNumberOfIds();
+  for (int a = 0; a < numberOfArrays; a++)
+    {
+    vtkAbstractArray *array = arrays[a];
+    if (array->GetNumberOfTuples() != size)
+      {
+      vtkGenericWarningMacro("Cannot permute " << array->GetClassName()
+                             << ": it does not have " << size << " tuples.");
+      continue;
+      }
+    if (size == 0)
+      {
+      continue;
+      }
+
+    if (array->IsNumeric() && array->GetDataType() != VTK_BIT)
+      {
+      // plain data: gather copies of the tuples in parallel
+      vtkSortDataArrayPermuteInfo str;
+      str.TupleSize =
+        array->GetDataTypeSize()*array->GetNumberOfComponents();
+      vtkstd::vector<char> source(
+        static_cast<size_t>(size)*static_cast<size_t>(str.TupleSize));
+      memcpy(&source[0], array->GetVoidPointer(0), source.size());
+      str.Permutation = permutation->GetPointer(0);
+      str.Size = size;
+      str.Source = &source[0];
+      str.Destination = static_cast<char *>(array->GetVoidPointer(0));
+      vtkSortDataArrayExecute(vtkSortDataArrayPermuteThread, &str,
+                              vtkSortDataArrayNumberOfThreads(size));
+      array->DataChanged();
+      }
+    else
+      {
+      vtkAbstractArray *source = array->NewInstance();
+      source->DeepCopy(array);
+      for (vtkIdType i = 0; i < size; i++)
+        {
+        array->SetTuple(i, permutation->GetId(i), source);
+        }
+      source->Delete();
+      }
     }
 }
@@ -23,6 +23,9 @@
  */
 
 // .NAME vtkSortDataArray - Provides several methods for sorting vtk arrays.
+// .SECTION Description
+// Large arrays are sorted by several threads: each sorts a part of the
+// array, and the sorted parts are then merged.
 
 #ifndef __vtkSortDataArray_h
 #define __vtkSortDataArray_h
@@ -55,12 +58,44 @@ public:
   // Description:
   // Sorts the given key/value pairs based on the keys.  A pair is given
   // as the entries at a given index of each of the arrays.  Obviously,
-  // the two arrays must be of equal size.
+  // the two arrays must be of equal size.  When both are abstract arrays,
+  // the sort is stable: where two keys are equal, the corresponding values
+  // keep their relative order.  Otherwise that order is unspecified.
   static void Sort(vtkIdList *keys, vtkIdList *values);
   static void Sort(vtkIdList *keys, vtkAbstractArray *values);
   static void Sort(vtkAbstractArray *keys, vtkIdList *values);
   static void Sort(vtkAbstractArray *keys, vtkAbstractArray *values);
 
+//BTX
+  // Description:
+  // Sorts the given keys along with any number of value arrays, each of
+  // which must have as many tuples as there are keys.  Where two keys are
+  // equal, the corresponding tuples keep their relative order.
+  static void Sort(vtkAbstractArray *keys, vtkAbstractArray **values,
+                   int numberOfValueArrays);
+//ETX
+
+  // Description:
+  // Computes the permutation that sorts the given keys (an "argsort"):
+  // on return, the i-th id of permutation is the index of the i-th
+  // smallest key.  The sort is stable: equal keys are listed in
+  // increasing index order.  The keys are left untouched.
+  static void GetSortPermutation(vtkAbstractArray *keys,
+                                 vtkIdList *permutation);
+
+  // Description:
+  // Reorders the tuples of the given array so that tuple i becomes the
+  // tuple permutation->GetId(i) of the original array, for instance to
+  // apply a permutation computed by GetSortPermutation() to attribute
+  // arrays.  The array must have as many tuples as there are ids.
+  static void ApplyPermutation(vtkIdList *permutation,
+                               vtkAbstractArray *array);
+//BTX
+  static void ApplyPermutation(vtkIdList *permutation,
+                               vtkAbstractArray **arrays,
+                               int numberOfArrays);
+//ETX
+
 protected:
   vtkSortDataArray();
   virtual ~vtkSortDataArray();
@@ -0,0 +1,165 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestCellLinks.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Builds the links of a triangle grid with one and several threads, checks
+// them against the cells, and edits them afterwards.
+
+#include "vtkCellArray.h"
+#include "vtkCellLinks.h"
+#include "vtkIdList.h"
+#include "vtkMultiThreader.h"
+#include "vtkPoints.h"
+#include "vtkPolyData.h"
+#include "vtkSmartPointer.h"
+#include "vtkUnstructuredGrid.h"
+
+#include <vtkstd/vector>
+
+static vtkSmartPointer<vtkPolyData> MakeGrid(int res)
+{
+  vtkSmartPointer<vtkPoints> points = vtkSmartPointer<vtkPoints>::New();
+  for (int j = 0; j <= res; j++)
+    {
+    for (int i = 0; i <= res; i++)
+      {
+      points->InsertNextPoint(i, j, 0.0);
+      }
+    }
+  vtkSmartPointer<vtkCellArray> polys = vtkSmartPointer<vtkCellArray>::New();
+  for (int j = 0; j < res; j++)
+    {
+    for (int i = 0; i < res; i++)
+      {
+      vtkIdType p = j * (res + 1) + i;
+      vtkIdType tri1[3] = { p, p + 1, p + res + 2 };
+      vtkIdType tri2[3] = { p, p + res + 2, p + res + 1 };
+      polys->InsertNextCell(3, tri1);
+      polys->InsertNextCell(3, tri2);
+      }
+    }
+  vtkSmartPointer<vtkPolyData> grid = vtkSmartPointer<vtkPolyData>::New();
+  grid->SetPoints(points);
+  grid->SetPolys(polys);
+  return grid;
+}
+
+// The list of each point must hold the cells using it, in increasing order.
+static int CheckLinks(vtkDataSet *data, vtkCellLinks *links)
+{
+  vtkIdType numPts = data->GetNumberOfPoints();
+  vtkstd::vector<vtkstd::vector<vtkIdType> > expected(numPts);
+  vtkSmartPointer<vtkIdList> ptIds = vtkSmartPointer<vtkIdList>::New();
+  for (vtkIdType cellId = 0; cellId < data->GetNumberOfCells(); cellId++)
+    {
+    data->GetCellPoints(cellId, ptIds);
+    for (vtkIdType j = 0; j < ptIds->GetNumberOfIds(); j++)
+      {
+      expected[ptIds->GetId(j)].push_back(cellId);
+      }
+    }
+  for (vtkIdType ptId = 0; ptId < numPts; ptId++)
+    {
+    unsigned short ncells = links->GetNcells(ptId);
+    vtkIdType *cells = links->GetCells(ptId);
+    if (ncells != expected[ptId].size())
+      {
+      cerr << "Point " << ptId << " has " << ncells << " cells instead of "
+           << expected[ptId].size() << endl;
+      return 0;
+      }
+    for (unsigned short i = 0; i < ncells; i++)
+      {
+      if (cells[i] != expected[ptId][i])
+        {
+        cerr << "Wrong cell " << cells[i] << " for point " << ptId << endl;
+        return 0;
+        }
+      }
+    }
+  return 1;
+}
+
+int TestCellLinks(int, char *[])
+{
+  vtkSmartPointer<vtkPolyData> grid = MakeGrid(300);
+
+  // Enough cells for the links to be built by several threads.
+  int defaultThreads = vtkMultiThreader::GetGlobalDefaultNumberOfThreads();
+  int status = 1;
+  for (int threads = 1; threads <= 4 && status; threads += 3)
+    {
+    vtkMultiThreader::SetGlobalDefaultNumberOfThreads(threads);
+    grid->BuildCells();
+    vtkSmartPointer<vtkCellLinks> links = vtkSmartPointer<vtkCellLinks>::New();
+    links->Allocate(grid->GetNumberOfPoints());
+    links->BuildLinks(grid);
+    status = CheckLinks(grid, links);
+
+    vtkSmartPointer<vtkUnstructuredGrid> ugrid =
+      vtkSmartPointer<vtkUnstructuredGrid>::New();
+    ugrid->SetPoints(grid->GetPoints());
+    ugrid->Allocate(grid->GetNumberOfCells());
+    vtkIdType npts, *pts;
+    for (grid->GetPolys()->InitTraversal();
+         grid->GetPolys()->GetNextCell(npts, pts); )
+      {
+      ugrid->InsertNextCell(VTK_TRIANGLE, npts, pts);
+      }
+    ugrid->BuildLinks();
+    status = status && CheckLinks(ugrid, ugrid->GetCellLinks());
+    }
+  vtkMultiThreader::SetGlobalDefaultNumberOfThreads(defaultThreads);
+  if (!status)
+    {
+    return EXIT_FAILURE;
+    }
+
+  // Edit the links of a small grid, which live in a single block.
+  vtkSmartPointer<vtkPolyData> small = MakeGrid(4);
+  small->BuildCells();
+  vtkSmartPointer<vtkCellLinks> links = vtkSmartPointer<vtkCellLinks>::New();
+  links->Allocate(small->GetNumberOfPoints());
+  links->BuildLinks(small);
+
+  vtkSmartPointer<vtkCellLinks> copy = vtkSmartPointer<vtkCellLinks>::New();
+  copy->DeepCopy(links);
+
+  links->ResizeCellList(2, 1);
+  links->AddCellReference(99, 2);
+  if (links->GetNcells(2) != 4 || links->GetCells(2)[3] != 99)
+    {
+    cerr << "Wrong list after resizing" << endl;
+    return EXIT_FAILURE;
+    }
+  links->RemoveCellReference(99, 2);
+  links->DeletePoint(24);
+  vtkIdType ptId = links->InsertNextPoint(2);
+  links->InsertNextCellReference(ptId, 7);
+  if (links->GetNcells(2) != 3 || links->GetNcells(24) != 0 ||
+      links->GetNcells(ptId) != 1 || links->GetCells(ptId)[0] != 7 ||
+      links->GetNcells(0) != 2 || links->GetCells(0)[1] != 1)
+    {
+    cerr << "Wrong links after editing" << endl;
+    return EXIT_FAILURE;
+    }
+
+  // The copy does not share the lists of the original.
+  if (!CheckLinks(small, copy))
+    {
+    cerr << "Wrong links in the copy" << endl;
+    return EXIT_FAILURE;
+    }
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,226 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestDataSetAttributesBatchInterpolation.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Checks that batched interpolation gives exactly the same result as
+// interpolating one tuple at a time, for a small batch and for one that is
+// large enough to be split over several threads.
+
+#include "vtkBitArray.h"
+#include "vtkDoubleArray.h"
+#include "vtkFloatArray.h"
+#include "vtkIdList.h"
+#include "vtkIntArray.h"
+#include "vtkMath.h"
+#include "vtkMultiThreader.h"
+#include "vtkPointData.h"
+#include "vtkSmartPointer.h"
+#include "vtkUnsignedCharArray.h"
+
+#include <vtkstd/vector>
+
+// Compares the tuples listed in toIds, or all tuples if toIds is 0.
+static int CompareArrays(vtkPointData* a, vtkPointData* b,
+                         vtkstd::vector<vtkIdType>* toIds)
+{
+  if (a->GetNumberOfArrays() != b->GetNumberOfArrays())
+    {
+    cerr << "Number of arrays differ" << endl;
+    return 0;
+    }
+  for (int i = 0; i < a->GetNumberOfArrays(); ++i)
+    {
+    vtkDataArray* da = a->GetArray(i);
+    vtkDataArray* db = b->GetArray(i);
+    if (da->GetNumberOfTuples() != db->GetNumberOfTuples())
+      {
+      cerr << "Number of tuples differ for " << da->GetName() << endl;
+      return 0;
+      }
+    vtkIdType num = toIds ? static_cast<vtkIdType>(toIds->size()) :
+      da->GetNumberOfTuples();
+    for (vtkIdType n = 0; n < num; ++n)
+      {
+      vtkIdType t = toIds ? (*toIds)[n] : n;
+      for (int c = 0; c < da->GetNumberOfComponents(); ++c)
+        {
+        if (da->GetComponent(t, c) != db->GetComponent(t, c))
+          {
+          cerr << "Value mismatch in " << da->GetName() << " at tuple " << t
+               << ": " << da->GetComponent(t, c) << " != "
+               << db->GetComponent(t, c) << endl;
+          return 0;
+          }
+        }
+      }
+    }
+  return 1;
+}
+
+static int CheckBatch(vtkIdType numIn, vtkIdType numOut)
+{
+
+  vtkSmartPointer<vtkPointData> in = vtkSmartPointer<vtkPointData>::New();
+  vtkSmartPointer<vtkFloatArray> vectors =
+    vtkSmartPointer<vtkFloatArray>::New();
+  vectors->SetName("vectors");
+  vectors->SetNumberOfComponents(3);
+  vectors->SetNumberOfTuples(numIn);
+  vtkSmartPointer<vtkIntArray> labels = vtkSmartPointer<vtkIntArray>::New();
+  labels->SetName("labels");
+  labels->SetNumberOfTuples(numIn);
+  vtkSmartPointer<vtkDoubleArray> pairs =
+    vtkSmartPointer<vtkDoubleArray>::New();
+  pairs->SetName("pairs");
+  pairs->SetNumberOfComponents(2);
+  pairs->SetNumberOfTuples(numIn);
+  vtkSmartPointer<vtkUnsignedCharArray> colors =
+    vtkSmartPointer<vtkUnsignedCharArray>::New();
+  colors->SetName("colors");
+  colors->SetNumberOfComponents(4);
+  colors->SetNumberOfTuples(numIn);
+  vtkSmartPointer<vtkBitArray> bits = vtkSmartPointer<vtkBitArray>::New();
+  bits->SetName("bits");
+  bits->SetNumberOfTuples(numIn);
+  for (vtkIdType i = 0; i < numIn; ++i)
+    {
+    for (int c = 0; c < 4; ++c)
+      {
+      if (c < 3)
+        {
+        vectors->SetComponent(i, c, vtkMath::Random(-10.0, 10.0));
+        }
+      if (c < 2)
+        {
+        pairs->SetComponent(i, c, vtkMath::Random(-1e3, 1e3));
+        }
+      colors->SetComponent(i, c, static_cast<int>(vtkMath::Random(0, 255)));
+      }
+    labels->SetValue(i, static_cast<int>(vtkMath::Random(-500, 500)));
+    bits->SetValue(i, i % 3 == 0);
+    }
+  in->AddArray(labels);
+  in->AddArray(pairs);
+  in->AddArray(bits);
+  in->SetVectors(vectors);
+  in->SetScalars(colors);
+
+  vtkSmartPointer<vtkPointData> reference =
+    vtkSmartPointer<vtkPointData>::New();
+  vtkSmartPointer<vtkPointData> deferred =
+    vtkSmartPointer<vtkPointData>::New();
+  vtkSmartPointer<vtkPointData> batched =
+    vtkSmartPointer<vtkPointData>::New();
+  reference->InterpolateAllocate(in, numOut);
+  deferred->InterpolateAllocate(in, numOut);
+  batched->InterpolateAllocate(in, numOut);
+  // exercise nearest neighbor interpolation of edges
+  reference->SetCopyVectors(2, vtkDataSetAttributes::INTERPOLATE);
+  deferred->SetCopyVectors(2, vtkDataSetAttributes::INTERPOLATE);
+
+  vtkstd::vector<vtkIdType> toIds;
+  vtkstd::vector<vtkIdType> offsets(1, 0);
+  vtkstd::vector<vtkIdType> ids;
+  vtkstd::vector<double> weights;
+
+  vtkSmartPointer<vtkIdList> ptIds = vtkSmartPointer<vtkIdList>::New();
+  double w[8];
+
+  deferred->BeginInterpolationBatch(in);
+  for (vtkIdType i = 0; i < numOut; ++i)
+    {
+    // output ids are written in a scrambled order
+    vtkIdType toId = (i * 7) % numOut;
+    if (i % 2)
+      {
+      vtkIdType p1 = static_cast<vtkIdType>(vtkMath::Random(0, numIn - 1));
+      vtkIdType p2 = static_cast<vtkIdType>(vtkMath::Random(0, numIn - 1));
+      double t = vtkMath::Random(0.0, 1.0);
+      reference->InterpolateEdge(in, toId, p1, p2, t);
+      deferred->InterpolateEdge(in, toId, p1, p2, t);
+      }
+    else
+      {
+      int numIds = 1 + static_cast<int>(vtkMath::Random(0, 7.99));
+      double sum = 0.0;
+      ptIds->SetNumberOfIds(numIds);
+      for (int k = 0; k < numIds; ++k)
+        {
+        ptIds->SetId(k, static_cast<vtkIdType>(
+                       vtkMath::Random(0, numIn - 1)));
+        w[k] = vtkMath::Random(0.0, 1.0);
+        sum += w[k];
+        }
+      for (int k = 0; k < numIds; ++k)
+        {
+        w[k] /= sum;
+        }
+      reference->InterpolatePoint(in, toId, ptIds, w);
+      deferred->InterpolatePoint(in, toId, ptIds, w);
+
+      toIds.push_back(toId);
+      for (int k = 0; k < numIds; ++k)
+        {
+        ids.push_back(ptIds->GetId(k));
+        weights.push_back(w[k]);
+        }
+      offsets.push_back(static_cast<vtkIdType>(ids.size()));
+      }
+    }
+  deferred->EndInterpolationBatch();
+
+  if (!CompareArrays(reference, deferred, 0))
+    {
+    cerr << "Deferred interpolation differs from the reference." << endl;
+    return 0;
+    }
+
+  // Only the point requests went into the explicit batch, so compare with
+  // a reference made of point requests only.
+  vtkSmartPointer<vtkPointData> pointReference =
+    vtkSmartPointer<vtkPointData>::New();
+  pointReference->InterpolateAllocate(in, numOut);
+  for (size_t r = 0; r < toIds.size(); ++r)
+    {
+    ptIds->SetNumberOfIds(offsets[r+1] - offsets[r]);
+    for (vtkIdType k = offsets[r]; k < offsets[r+1]; ++k)
+      {
+      ptIds->SetId(k - offsets[r], ids[k]);
+      }
+    pointReference->InterpolatePoint(in, toIds[r], ptIds,
+                                     &weights[offsets[r]]);
+    }
+  batched->InterpolatePoints(in, static_cast<vtkIdType>(toIds.size()),
+                             &toIds[0], &offsets[0], &ids[0], &weights[0]);
+  if (!CompareArrays(pointReference, batched, &toIds))
+    {
+    cerr << "Batched interpolation differs from the reference." << endl;
+    return 0;
+    }
+
+  return 1;
+}
+
+int TestDataSetAttributesBatchInterpolation(int, char *[])
+{
+  int defaultThreads = vtkMultiThreader::GetGlobalDefaultNumberOfThreads();
+  vtkMultiThreader::SetGlobalDefaultNumberOfThreads(4);
+  vtkMath::RandomSeed(1234);
+
+  int status = CheckBatch(1000, 3000);
+  // five arrays of 200000 tuples are split over all four threads
+  status &= CheckBatch(20000, 200000);
+
+  vtkMultiThreader::SetGlobalDefaultNumberOfThreads(defaultThreads);
+  return status ? EXIT_SUCCESS : EXIT_FAILURE;
+}
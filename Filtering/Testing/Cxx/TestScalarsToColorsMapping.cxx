@@ -0,0 +1,201 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestScalarsToColorsMapping.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Checks the RGBA mapping kernels of vtkLookupTable against its generic
+// mapping, and the baked table of vtkColorTransferFunction against the
+// exact evaluation of the function.
+
+#include "vtkColorTransferFunction.h"
+#include "vtkDoubleArray.h"
+#include "vtkFloatingPointExceptions.h"
+#include "vtkFloatArray.h"
+#include "vtkIntArray.h"
+#include "vtkLookupTable.h"
+#include "vtkMath.h"
+#include "vtkMultiThreader.h"
+#include "vtkSmartPointer.h"
+#include "vtkUnsignedCharArray.h"
+
+#include <vtkstd/vector>
+
+// Large enough to be mapped by several threads.
+static const int NumberOfValues = 600000;
+
+static void FillArray(vtkDataArray* array, double min, double max)
+{
+  array->SetNumberOfTuples(NumberOfValues);
+  for (int i = 0; i < NumberOfValues; ++i)
+    {
+    array->SetTuple1(i, vtkMath::Random(min, max));
+    }
+  if (array->GetDataType() == VTK_FLOAT || array->GetDataType() == VTK_DOUBLE)
+    {
+    array->SetTuple1(7, vtkMath::Nan());
+    array->SetTuple1(NumberOfValues - 1, vtkMath::Nan());
+    }
+}
+
+// RGBA output goes through the new kernels, RGB output through the
+// generic code: the colors must be identical.
+static int TestLookupTable(vtkLookupTable* lut, vtkDataArray* array)
+{
+  vtkstd::vector<unsigned char> rgba(4*NumberOfValues);
+  vtkstd::vector<unsigned char> rgb(3*NumberOfValues);
+  lut->MapScalarsThroughTable2(array->GetVoidPointer(0), &rgba[0],
+                               array->GetDataType(), NumberOfValues, 1,
+                               VTK_RGBA);
+  lut->MapScalarsThroughTable2(array->GetVoidPointer(0), &rgb[0],
+                               array->GetDataType(), NumberOfValues, 1,
+                               VTK_RGB);
+
+  const double* nanColor = lut->GetNanColor();
+  unsigned char nanAlpha = static_cast<unsigned char>(nanColor[3]*255.0 + 0.5);
+  for (int i = 0; i < NumberOfValues; ++i)
+    {
+    double v = array->GetTuple1(i);
+    // the log scale maps NaN to the bottom of the range
+    unsigned char alpha =
+      (vtkMath::IsNan(v) && lut->GetScale() == VTK_SCALE_LINEAR) ?
+      nanAlpha : lut->MapValue(v)[3];
+    if (lut->GetAlpha() < 1.0)
+      {
+      alpha = static_cast<unsigned char>(alpha*lut->GetAlpha() + 0.5);
+      }
+    if (rgba[4*i] != rgb[3*i] || rgba[4*i+1] != rgb[3*i+1] ||
+        rgba[4*i+2] != rgb[3*i+2] || rgba[4*i+3] != alpha)
+      {
+      cerr << "Wrong color for " << v << " in "
+           << array->GetClassName() << endl;
+      return 0;
+      }
+    }
+  return 1;
+}
+
+// Compare the baked mapping with the exact one.
+static int TestColorTransferFunction(vtkColorTransferFunction* ctf,
+                                     vtkDataArray* array, int tolerance)
+{
+  vtkstd::vector<unsigned char> exact(4*NumberOfValues);
+  vtkstd::vector<unsigned char> baked(4*NumberOfValues);
+  ctf->UseBakedTableOff();
+  ctf->MapScalarsThroughTable2(array->GetVoidPointer(0), &exact[0],
+                               array->GetDataType(), NumberOfValues, 1,
+                               VTK_RGBA);
+  ctf->UseBakedTableOn();
+  ctf->MapScalarsThroughTable2(array->GetVoidPointer(0), &baked[0],
+                               array->GetDataType(), NumberOfValues, 1,
+                               VTK_RGBA);
+
+  for (int i = 0; i < 4*NumberOfValues; ++i)
+    {
+    int diff = static_cast<int>(exact[i]) - static_cast<int>(baked[i]);
+    if (diff > tolerance || diff < -tolerance)
+      {
+      cerr << "Baked color differs by " << diff << " for "
+           << array->GetTuple1(i/4) << " in " << array->GetClassName()
+           << endl;
+      return 0;
+      }
+    }
+  return 1;
+}
+
+static int TestMappings()
+{
+
+  vtkSmartPointer<vtkFloatArray> floats =
+    vtkSmartPointer<vtkFloatArray>::New();
+  FillArray(floats, -20.0, 120.0);
+  vtkSmartPointer<vtkDoubleArray> doubles =
+    vtkSmartPointer<vtkDoubleArray>::New();
+  FillArray(doubles, -20.0, 120.0);
+  vtkSmartPointer<vtkUnsignedCharArray> bytes =
+    vtkSmartPointer<vtkUnsignedCharArray>::New();
+  FillArray(bytes, 0.0, 255.0);
+  vtkSmartPointer<vtkIntArray> ints = vtkSmartPointer<vtkIntArray>::New();
+  FillArray(ints, -20.0, 1200.0);
+
+  vtkSmartPointer<vtkLookupTable> lut = vtkSmartPointer<vtkLookupTable>::New();
+  lut->SetAlphaRange(0.2, 1.0);
+  lut->SetNanColor(0.1, 0.2, 0.3, 0.4);
+  lut->SetTableRange(0.0, 100.0);
+  lut->Build();
+  vtkDataArray* arrays[3] = { floats, doubles, bytes };
+  int i;
+  for (i = 0; i < 3; ++i)
+    {
+    lut->SetScaleToLinear();
+    lut->SetAlpha(1.0);
+    if (!TestLookupTable(lut, arrays[i]))
+      {
+      return EXIT_FAILURE;
+      }
+    lut->SetAlpha(0.5);
+    if (!TestLookupTable(lut, arrays[i]))
+      {
+      return EXIT_FAILURE;
+      }
+    lut->SetScaleToLog10();
+    if (!TestLookupTable(lut, arrays[i]))
+      {
+      return EXIT_FAILURE;
+      }
+    }
+
+  vtkSmartPointer<vtkColorTransferFunction> ctf =
+    vtkSmartPointer<vtkColorTransferFunction>::New();
+  ctf->AddRGBPoint(0.0, 0.0, 0.0, 1.0);
+  ctf->AddRGBPoint(40.0, 0.0, 1.0, 0.0);
+  ctf->AddRGBPoint(1000.0, 1.0, 0.0, 0.0);
+  ctf->SetNanColor(1.0, 1.0, 0.0);
+  ctf->SetBakedTableSize(8192);
+  for (int clamping = 0; clamping < 2; ++clamping)
+    {
+    ctf->SetClamping(clamping);
+    if (!TestColorTransferFunction(ctf, floats, 1) ||
+        !TestColorTransferFunction(ctf, doubles, 1) ||
+        !TestColorTransferFunction(ctf, ints, 1))
+      {
+      return EXIT_FAILURE;
+      }
+    }
+  // the log scale needs a positive range
+  ctf->RemovePoint(0.0);
+  ctf->AddRGBPoint(1.0, 0.0, 0.0, 1.0);
+  ctf->SetScaleToLog10();
+  if (!TestColorTransferFunction(ctf, doubles, 1) ||
+      !TestColorTransferFunction(ctf, ints, 1))
+    {
+    cerr << "Log scale mapping failed." << endl;
+    return EXIT_FAILURE;
+    }
+
+  return EXIT_SUCCESS;
+}
+
+int TestScalarsToColorsMapping(int, char *[])
+{
+  // NaN values are mapped on purpose.
+  vtkFloatingPointExceptions::Disable();
+  vtkMath::RandomSeed(5678);
+
+  // the arrays are large enough to be split over the threads
+  int defaultThreads = vtkMultiThreader::GetGlobalDefaultNumberOfThreads();
+  vtkMultiThreader::SetGlobalDefaultNumberOfThreads(4);
+  int status = TestMappings();
+  vtkMultiThreader::SetGlobalDefaultNumberOfThreads(defaultThreads);
+
+  return status;
+}
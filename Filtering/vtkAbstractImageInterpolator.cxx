@@ -87,6 +87,8 @@ vtkAbstractImageInterpolator::vtkAbstractImageInterpolator()
     &(vtkInterpolateNOP<double>::RowInterpolationFunc);
   this->RowInterpolationFuncFloat =
     &(vtkInterpolateNOP<float>::RowInterpolationFunc);
+  this->RowIJKInterpolationFuncDouble = NULL;
+  this->RowIJKInterpolationFuncFloat = NULL;
 }
 
 //----------------------------------------------------------------------------
@@ -293,6 +295,8 @@ void vtkAbstractImageInterpolator::Update()
       &(vtkInterpolateNOP<double>::RowInterpolationFunc);
     this->RowInterpolationFuncFloat =
       &(vtkInterpolateNOP<float>::RowInterpolationFunc);
+    this->RowIJKInterpolationFuncDouble = NULL;
+    this->RowIJKInterpolationFuncFloat = NULL;
 
     return;
     }
@@ -369,6 +373,10 @@ void vtkAbstractImageInterpolator::Update()
   this->GetInterpolationFunc(&this->InterpolationFuncFloat);
   this->GetRowInterpolationFunc(&this->RowInterpolationFuncDouble);
   this->GetRowInterpolationFunc(&this->RowInterpolationFuncFloat);
+  this->RowIJKInterpolationFuncDouble = NULL;
+  this->RowIJKInterpolationFuncFloat = NULL;
+  this->GetRowIJKInterpolationFunc(&this->RowIJKInterpolationFuncDouble);
+  this->GetRowIJKInterpolationFunc(&this->RowIJKInterpolationFuncFloat);
 }
 
 //----------------------------------------------------------------------------
@@ -429,6 +437,67 @@ double vtkAbstractImageInterpolator::Interpolate(
   return value;
 }
 
+//----------------------------------------------------------------------------
+// Interpolate a row one point at a time, for interpolators without a row
+// function
+namespace {
+
+template<class F>
+void vtkInterpolateRowIJKByPoint(
+  vtkInterpolationInfo *info,
+  void (*interpolate)(vtkInterpolationInfo *, const F [3], F *),
+  const F origin[3], const F step[3], int idX, F *value, int n)
+{
+  int numscalars = info->NumberOfComponents;
+  for (int i = 0; i < n; i++)
+    {
+    F point[3];
+    point[0] = origin[0] + (idX + i)*step[0];
+    point[1] = origin[1] + (idX + i)*step[1];
+    point[2] = origin[2] + (idX + i)*step[2];
+    interpolate(info, point, value);
+    value += numscalars;
+    }
+}
+
+} // end anonymous namespace
+
+//----------------------------------------------------------------------------
+void vtkAbstractImageInterpolator::InterpolateRowIJK(
+  const double origin[3], const double step[3], int idX,
+  double *value, int n)
+{
+  if (this->RowIJKInterpolationFuncDouble)
+    {
+    this->RowIJKInterpolationFuncDouble(
+      this->InterpolationInfo, origin, step, idX, value, n);
+    }
+  else
+    {
+    vtkInterpolateRowIJKByPoint(
+      this->InterpolationInfo, this->InterpolationFuncDouble,
+      origin, step, idX, value, n);
+    }
+}
+
+//----------------------------------------------------------------------------
+void vtkAbstractImageInterpolator::InterpolateRowIJK(
+  const float origin[3], const float step[3], int idX,
+  float *value, int n)
+{
+  if (this->RowIJKInterpolationFuncFloat)
+    {
+    this->RowIJKInterpolationFuncFloat(
+      this->InterpolationInfo, origin, step, idX, value, n);
+    }
+  else
+    {
+    vtkInterpolateRowIJKByPoint(
+      this->InterpolationInfo, this->InterpolationFuncFloat,
+      origin, step, idX, value, n);
+    }
+}
+
 //----------------------------------------------------------------------------
 void vtkAbstractImageInterpolator::GetInterpolationFunc(
   void (**)(vtkInterpolationInfo *, const double [3], double *))
@@ -453,6 +522,20 @@ void vtkAbstractImageInterpolator::GetRowInterpolationFunc(
 {
 }
 
+//----------------------------------------------------------------------------
+void vtkAbstractImageInterpolator::GetRowIJKInterpolationFunc(
+  void (**)(vtkInterpolationInfo *, const double [3], const double [3], int,
+            double *, int))
+{
+}
+
+//----------------------------------------------------------------------------
+void vtkAbstractImageInterpolator::GetRowIJKInterpolationFunc(
+  void (**)(vtkInterpolationInfo *, const float [3], const float [3], int,
+            float *, int))
+{
+}
+
 //----------------------------------------------------------------------------
 void vtkAbstractImageInterpolator::PrecomputeWeightsForExtent(
   const double [16], const int [6], int [6], vtkInterpolationWeights *&)
@@ -197,6 +197,20 @@ public:
     vtkInterpolationWeights *&weights, int xIdx, int yIdx, int zIdx,
     float *value, int n);
 
+  // Description:
+  // Get a row of samples at structured coords that are not on a regular
+  // grid of the input, i.e. at the n points origin + i*step for i from
+  // idX to idX + n - 1.  Every one of these points must be within the
+  // bounds checked by CheckBoundsIJK.  The result is the same as calling
+  // InterpolateIJK for each point, but interpolators that provide a row
+  // function will compute the whole row at once.
+  void InterpolateRowIJK(
+    const double origin[3], const double step[3], int idX,
+    double *value, int n);
+  void InterpolateRowIJK(
+    const float origin[3], const float step[3], int idX,
+    float *value, int n);
+
   // Description:
   // Get the spacing of the data being interpolated.
   vtkGetVector3Macro(Spacing, double);
@@ -239,6 +253,19 @@ protected:
     void (**floatfunc)(
       vtkInterpolationWeights *, int, int, int, float *, int));
 
+  // Description:
+  // Get the functions that interpolate a row of structured coords.  The
+  // default is to leave them null, which makes InterpolateRowIJK call the
+  // point interpolation function for each point of the row.
+  virtual void GetRowIJKInterpolationFunc(
+    void (**doublefunc)(
+      vtkInterpolationInfo *, const double [3], const double [3], int,
+      double *, int));
+  virtual void GetRowIJKInterpolationFunc(
+    void (**floatfunc)(
+      vtkInterpolationInfo *, const float [3], const float [3], int,
+      float *, int));
+
   vtkDataArray *Scalars;
   double StructuredBoundsDouble[6];
   float StructuredBoundsFloat[6];
@@ -266,6 +293,13 @@ protected:
     vtkInterpolationWeights *weights, int idX, int idY, int idZ,
     float *outPtr, int n);
 
+  void (*RowIJKInterpolationFuncDouble)(
+    vtkInterpolationInfo *info, const double origin[3],
+    const double step[3], int idX, double *outPtr, int n);
+  void (*RowIJKInterpolationFuncFloat)(
+    vtkInterpolationInfo *info, const float origin[3],
+    const float step[3], int idX, float *outPtr, int n);
+
 private:
 
   vtkAbstractImageInterpolator(const vtkAbstractImageInterpolator&);  // Not implemented.
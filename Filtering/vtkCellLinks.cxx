@@ -17,11 +17,214 @@
 #include "vtkCellArray.h"
 #include "vtkDataSet.h"
 #include "vtkGenericCell.h"
+#include "vtkMultiThreader.h"
 #include "vtkObjectFactory.h"
 #include "vtkPolyData.h"
 
+#include <vtkstd/vector>
+
 vtkStandardNewMacro(vtkCellLinks);
 
+// Minimum number of cells per thread when building the links.
+#define VTK_CELL_LINKS_CELLS_PER_THREAD 50000
+
+//----------------------------------------------------------------------------
+// Counts, then fills, the cell lists. The cells are split in consecutive
+// ranges, one per thread. Each range first counts the uses of each point
+// by its own cells. A prefix sum per point over the ranges then gives the
+// position in the list of the point where each range writes its first
+// cell, so the ranges fill the lists without sharing any location, and
+// each list comes out in increasing cell order.
+class vtkCellLinksBuilder
+{
+public:
+  enum { COUNT, SUM, FILL };
+
+  vtkCellLinks::Link *Array;
+  vtkIdType NumberOfPoints;
+  // Either the cells of a vtkPolyData, or a connectivity array.
+  vtkPolyData *PolyData;
+  vtkIdType NumberOfCells;
+  vtkIdType *Connectivity;
+  vtkIdType ConnectivitySize;
+  int Pass;
+
+  int NumberOfRanges;
+  // First cell of each range, and its location in the connectivity array.
+  vtkstd::vector<vtkIdType> CellBegin;
+  vtkstd::vector<vtkIdType> ConnectivityBegin;
+  // Uses of point p by the cells of range r at Counts[r*NumberOfPoints+p],
+  // then the position of the next cell of range r in the list of p.
+  vtkstd::vector<unsigned short> Counts;
+
+  void Run(int range)
+    {
+    if ( this->Pass == SUM )
+      {
+      this->Sum(this->NumberOfPoints * range / this->NumberOfRanges,
+                this->NumberOfPoints * (range + 1) / this->NumberOfRanges);
+      return;
+      }
+    unsigned short *counts = (this->NumberOfRanges > 1 ?
+      &this->Counts[range * this->NumberOfPoints] : NULL);
+    vtkIdType cellId, j, npts, *pts;
+    vtkIdType endId = this->CellBegin[range + 1];
+    if ( this->PolyData )
+      {
+      for (cellId=this->CellBegin[range]; cellId < endId; cellId++)
+        {
+        this->PolyData->GetCellPoints(cellId, npts, pts);
+        for (j=0; j < npts; j++)
+          {
+          this->Add(counts, pts[j], cellId);
+          }
+        }
+      }
+    else
+      {
+      vtkIdType *cell = this->Connectivity + this->ConnectivityBegin[range];
+      for (cellId=this->CellBegin[range]; cellId < endId;
+           cellId++, cell += npts + 1)
+        {
+        npts = cell[0];
+        for (j=1; j <= npts; j++)
+          {
+          this->Add(counts, cell[j], cellId);
+          }
+        }
+      }
+    }
+
+  void Add(unsigned short *counts, vtkIdType ptId, vtkIdType cellId)
+    {
+    vtkCellLinks::Link &link = this->Array[ptId];
+    if ( counts == NULL )
+      {
+      if ( this->Pass == FILL )
+        {
+        link.cells[link.ncells] = cellId;
+        }
+      link.ncells++;
+      }
+    else if ( this->Pass == FILL )
+      {
+      link.cells[counts[ptId]++] = cellId;
+      }
+    else
+      {
+      counts[ptId]++;
+      }
+    }
+
+  // Total the counts of the ranges for points [begin,end), and turn them
+  // into the position of the first cell of each range in the lists.
+  void Sum(vtkIdType begin, vtkIdType end)
+    {
+    for (vtkIdType ptId=begin; ptId < end; ptId++)
+      {
+      unsigned short total = 0;
+      for (int range=0; range < this->NumberOfRanges; range++)
+        {
+        unsigned short &count = this->Counts[range*this->NumberOfPoints+ptId];
+        unsigned short first = total;
+        total = static_cast<unsigned short>(total + count);
+        count = first;
+        }
+      this->Array[ptId].ncells = total;
+      }
+    }
+
+  // After the fill, the position of the last range is past the end of
+  // the list of each point.
+  void Finish()
+    {
+    if ( this->NumberOfRanges > 1 )
+      {
+      unsigned short *last =
+        &this->Counts[(this->NumberOfRanges - 1) * this->NumberOfPoints];
+      for (vtkIdType ptId=0; ptId < this->NumberOfPoints; ptId++)
+        {
+        this->Array[ptId].ncells = last[ptId];
+        }
+      }
+    }
+
+  void Initialize();
+  void Execute(int pass);
+};
+
+//----------------------------------------------------------------------------
+static VTK_THREAD_RETURN_TYPE vtkCellLinksBuilderThread(void *arg)
+{
+  vtkMultiThreader::ThreadInfo *info =
+    static_cast<vtkMultiThreader::ThreadInfo *>(arg);
+  vtkCellLinksBuilder *builder =
+    static_cast<vtkCellLinksBuilder *>(info->UserData);
+  builder->Run(info->ThreadID);
+  return VTK_THREAD_RETURN_VALUE;
+}
+
+//----------------------------------------------------------------------------
+// Split the cells in ranges, one per thread.
+void vtkCellLinksBuilder::Initialize()
+{
+  vtkIdType numRanges = this->NumberOfCells / VTK_CELL_LINKS_CELLS_PER_THREAD;
+  if ( numRanges > vtkMultiThreader::GetGlobalDefaultNumberOfThreads() )
+    {
+    numRanges = vtkMultiThreader::GetGlobalDefaultNumberOfThreads();
+    }
+  this->NumberOfRanges = (numRanges > 1 ? static_cast<int>(numRanges) : 1);
+
+  this->CellBegin.resize(this->NumberOfRanges + 1);
+  this->ConnectivityBegin.resize(this->NumberOfRanges + 1);
+  int range;
+  for (range=0; range <= this->NumberOfRanges; range++)
+    {
+    this->CellBegin[range] =
+      this->NumberOfCells * range / this->NumberOfRanges;
+    }
+  this->ConnectivityBegin[0] = 0;
+  this->ConnectivityBegin[this->NumberOfRanges] = this->ConnectivitySize;
+  if ( !this->PolyData && this->NumberOfRanges > 1 )
+    {
+    // find where the ranges start by hopping from cell to cell
+    vtkIdType cellId = 0, loc = 0;
+    for (range=1; range < this->NumberOfRanges; range++)
+      {
+      for (; cellId < this->CellBegin[range]; cellId++)
+        {
+        loc += this->Connectivity[loc] + 1;
+        }
+      this->ConnectivityBegin[range] = loc;
+      }
+    }
+
+  if ( this->NumberOfRanges > 1 )
+    {
+    this->Counts.assign(static_cast<size_t>(this->NumberOfRanges) *
+                        static_cast<size_t>(this->NumberOfPoints), 0);
+    }
+}
+
+//----------------------------------------------------------------------------
+void vtkCellLinksBuilder::Execute(int pass)
+{
+  this->Pass = pass;
+  if ( this->NumberOfRanges <= 1 )
+    {
+    if ( pass != SUM )
+      {
+      this->Run(0);
+      }
+    return;
+    }
+  vtkMultiThreader *threader = vtkMultiThreader::New();
+  threader->SetNumberOfThreads(this->NumberOfRanges);
+  threader->SetSingleMethod(vtkCellLinksBuilderThread, this);
+  threader->SingleMethodExecute();
+  threader->Delete();
+}
+
 //----------------------------------------------------------------------------
 void vtkCellLinks::Allocate(vtkIdType sz, vtkIdType ext)
 {
@@ -32,6 +235,12 @@ void vtkCellLinks::Allocate(vtkIdType sz, vtkIdType ext)
     {
     delete [] this->Array;
     }
+  if ( this->Storage != NULL )
+    {
+    delete [] this->Storage;
+    this->Storage = NULL;
+    this->StorageSize = 0;
+    }
   this->Array = new vtkCellLinks::Link[sz];
   this->Extend = ext;
   this->MaxId = -1;
@@ -52,22 +261,37 @@ vtkCellLinks::~vtkCellLinks()
 
   for (vtkIdType i=0; i<=this->MaxId; i++)
     {
-    if ( this->Array[i].cells != NULL )
+    if ( this->Array[i].cells != NULL &&
+         !this->IsInStorage(this->Array[i].cells) )
       {
       delete [] this->Array[i].cells;
       }
     }
 
   delete [] this->Array;
+  delete [] this->Storage;
 }
 
 //----------------------------------------------------------------------------
-// Allocate memory for the list of lists of cell ids.
-void vtkCellLinks::AllocateLinks(vtkIdType n)
+// Allocate memory for the list of lists of cell ids, as a single block.
+void vtkCellLinks::AllocateStorage(vtkIdType numPts)
 {
-  for (vtkIdType i=0; i < n; i++)
+  vtkIdType i, size = 0;
+  for (i=0; i < numPts; i++)
     {
-    this->Array[i].cells = new vtkIdType[this->Array[i].ncells];
+    size += this->Array[i].ncells;
+    }
+
+  delete [] this->Storage;
+  this->Storage = new vtkIdType[size > 0 ? size : 1];
+  this->StorageSize = size;
+
+  vtkIdType *cells = this->Storage;
+  for (i=0; i < numPts; i++)
+    {
+    this->Array[i].cells = (this->Array[i].ncells > 0 ? cells : NULL);
+    cells += this->Array[i].ncells;
+    this->Array[i].ncells = 0;
     }
 }
 
@@ -132,40 +356,29 @@ void vtkCellLinks::BuildLinks(vtkDataSet *data)
   vtkIdType numCells = data->GetNumberOfCells();
   int j;
   vtkIdType cellId;
-  unsigned short *linkLoc;
-
-  // fill out lists with number of references to cells
-  linkLoc = new unsigned short[numPts];
-  memset(linkLoc, 0, numPts*sizeof(unsigned short));
 
   // Use fast path if polydata
   if ( data->GetDataObjectType() == VTK_POLY_DATA )
     {
-    vtkIdType *pts, npts;
-    
-    vtkPolyData *pdata = static_cast<vtkPolyData *>(data);
+    vtkCellLinksBuilder builder;
+    builder.Array = this->Array;
+    builder.NumberOfPoints = numPts;
+    builder.PolyData = static_cast<vtkPolyData *>(data);
+    builder.NumberOfCells = numCells;
+    builder.Connectivity = NULL;
+    builder.ConnectivitySize = 0;
+    builder.Initialize();
+
     // traverse data to determine number of uses of each point
-    for (cellId=0; cellId < numCells; cellId++)
-      {
-      pdata->GetCellPoints(cellId, npts, pts);
-      for (j=0; j < npts; j++)
-        {
-        this->IncrementLinkCount(pts[j]);      
-        }      
-      }
+    builder.Execute(vtkCellLinksBuilder::COUNT);
+    builder.Execute(vtkCellLinksBuilder::SUM);
 
     // now allocate storage for the links
-    this->AllocateLinks(numPts);
+    this->AllocateStorage(numPts);
     this->MaxId = numPts - 1;
 
-    for (cellId=0; cellId < numCells; cellId++)
-      {
-      pdata->GetCellPoints(cellId, npts, pts);
-      for (j=0; j < npts; j++)
-        {
-        this->InsertCellReference(pts[j], (linkLoc[pts[j]])++, cellId);      
-        }      
-      }
+    builder.Execute(vtkCellLinksBuilder::FILL);
+    builder.Finish();
     }
 
   else //any other type of dataset
@@ -185,7 +398,7 @@ void vtkCellLinks::BuildLinks(vtkDataSet *data)
       }
 
     // now allocate storage for the links
-    this->AllocateLinks(numPts);
+    this->AllocateStorage(numPts);
     this->MaxId = numPts - 1;
 
     for (cellId=0; cellId < numCells; cellId++)
@@ -195,13 +408,11 @@ void vtkCellLinks::BuildLinks(vtkDataSet *data)
       for (j=0; j < numberOfPoints; j++)
         {
         ptId = cell->PointIds->GetId(j);
-        this->InsertCellReference(ptId, (linkLoc[ptId])++, cellId);      
+        this->InsertNextCellReference(ptId, cellId);
         }      
       }
     cell->Delete();
     }//end else
-
-  delete [] linkLoc;
 }
 
 //----------------------------------------------------------------------------
@@ -209,41 +420,27 @@ void vtkCellLinks::BuildLinks(vtkDataSet *data)
 void vtkCellLinks::BuildLinks(vtkDataSet *data, vtkCellArray *Connectivity)
 {
   vtkIdType numPts = data->GetNumberOfPoints();
-  vtkIdType j, cellId;
-  unsigned short *linkLoc;
-  vtkIdType npts=0;
-  vtkIdType *pts=0;
-  vtkIdType loc = Connectivity->GetTraversalLocation();
-  
+
+  vtkCellLinksBuilder builder;
+  builder.Array = this->Array;
+  builder.NumberOfPoints = numPts;
+  builder.PolyData = NULL;
+  builder.NumberOfCells = Connectivity->GetNumberOfCells();
+  builder.Connectivity = Connectivity->GetPointer();
+  builder.ConnectivitySize = Connectivity->GetNumberOfConnectivityEntries();
+  builder.Initialize();
+
   // traverse data to determine number of uses of each point
-  for (Connectivity->InitTraversal(); 
-       Connectivity->GetNextCell(npts,pts);)
-    {
-    for (j=0; j < npts; j++)
-      {
-      this->IncrementLinkCount(pts[j]);      
-      }      
-    }
+  builder.Execute(vtkCellLinksBuilder::COUNT);
+  builder.Execute(vtkCellLinksBuilder::SUM);
 
   // now allocate storage for the links
-  this->AllocateLinks(numPts);
+  this->AllocateStorage(numPts);
   this->MaxId = numPts - 1;
 
   // fill out lists with references to cells
-  linkLoc = new unsigned short[numPts];
-  memset(linkLoc, 0, numPts*sizeof(unsigned short));
-
-  cellId = 0;
-  for (Connectivity->InitTraversal(); 
-       Connectivity->GetNextCell(npts,pts); cellId++)
-    {
-    for (j=0; j < npts; j++)
-      {
-      this->InsertCellReference(pts[j], (linkLoc[pts[j]])++, cellId);      
-      }      
-    }
-  delete [] linkLoc;
-  Connectivity->SetTraversalLocation(loc);
+  builder.Execute(vtkCellLinksBuilder::FILL);
+  builder.Finish();
 }
 
 //----------------------------------------------------------------------------
@@ -272,6 +469,7 @@ unsigned long vtkCellLinks::GetActualMemorySize()
 
   size *= sizeof(int *); //references to cells
   size += (this->MaxId+1) * sizeof(vtkCellLinks::Link); //list of cell lists
+  size += this->StorageSize * sizeof(vtkIdType); //block of cell lists
 
   return static_cast<unsigned long>( ceil(size/1024.0)); //kilobytes
 }
@@ -279,9 +477,25 @@ unsigned long vtkCellLinks::GetActualMemorySize()
 //----------------------------------------------------------------------------
 void vtkCellLinks::DeepCopy(vtkCellLinks *src)
 {
+  vtkIdType ptId;
   this->Allocate(src->Size, src->Extend);
-  memcpy(this->Array, src->Array, this->Size * sizeof(vtkCellLinks::Link));
   this->MaxId = src->MaxId;
+
+  // Copy the cell lists into a single block.
+  for (ptId=0; ptId <= this->MaxId; ptId++)
+    {
+    this->Array[ptId].ncells = src->Array[ptId].ncells;
+    }
+  this->AllocateStorage(this->MaxId + 1);
+  for (ptId=0; ptId <= this->MaxId; ptId++)
+    {
+    this->Array[ptId].ncells = src->Array[ptId].ncells;
+    if ( this->Array[ptId].ncells > 0 )
+      {
+      memcpy(this->Array[ptId].cells, src->Array[ptId].cells,
+             this->Array[ptId].ncells * sizeof(vtkIdType));
+      }
+    }
 }
 
 //----------------------------------------------------------------------------
@@ -292,4 +506,5 @@ void vtkCellLinks::PrintSelf(ostream& os, vtkIndent indent)
   os << indent << "Size: " << this->Size << "\n";
   os << indent << "MaxId: " << this->MaxId << "\n";
   os << indent << "Extend: " << this->Extend << "\n";
+  os << indent << "Storage Size: " << this->StorageSize << "\n";
 }
@@ -19,6 +19,12 @@
 // a list of Links, each link represents a dynamic list of cell id's using the 
 // point. The information provided by this object can be used to determine 
 // neighbors and construct other local topological information.
+//
+// BuildLinks() stores all the lists in a single block of memory, in the
+// order of the points, instead of allocating a list per point. The lists of
+// a large dataset are counted and filled by several threads. The editing
+// methods (ResizeCellList(), DeletePoint(), InsertNextPoint()...) still
+// work: a list that has to grow is then moved to its own allocation.
 // .SECTION See Also
 // vtkCellArray vtkCellTypes
 
@@ -125,25 +131,38 @@ public:
   void DeepCopy(vtkCellLinks *src);
 
 protected:
-  vtkCellLinks():Array(NULL),Size(0),MaxId(-1),Extend(1000) {};
+  vtkCellLinks():Array(NULL),Size(0),MaxId(-1),Extend(1000),
+                 Storage(NULL),StorageSize(0) {};
   ~vtkCellLinks();
 
   // Description:
   // Increment the count of the number of cells using the point.
   void IncrementLinkCount(vtkIdType ptId) { this->Array[ptId].ncells++;};
 
-  void AllocateLinks(vtkIdType n);
-
   // Description:
   // Insert a cell id into the list of cells using the point.
   void InsertCellReference(vtkIdType ptId, unsigned short pos,
                            vtkIdType cellId);
 
+  // Description:
+  // Allocate the block holding the cell lists of all the points, sized
+  // from the counts in ncells, and point each list into it. The counts are
+  // reset to zero.
+  void AllocateStorage(vtkIdType numPts);
+
+  // Description:
+  // Return whether a cell list lives in the shared block, in which case it
+  // must not be deleted on its own.
+  int IsInStorage(const vtkIdType *cells)
+    {return cells >= this->Storage && cells < this->Storage+this->StorageSize;}
+
   Link *Array;   // pointer to data
   vtkIdType Size;       // allocated size of data
   vtkIdType MaxId;     // maximum index inserted thus far
   vtkIdType Extend;     // grow array by this point
   Link *Resize(vtkIdType sz);  // function to resize data
+  vtkIdType *Storage;     // cell lists built by BuildLinks
+  vtkIdType StorageSize;
 private:
   vtkCellLinks(const vtkCellLinks&);  // Not implemented.
   void operator=(const vtkCellLinks&);  // Not implemented.
@@ -161,7 +180,10 @@ inline void vtkCellLinks::InsertCellReference(vtkIdType ptId,
 inline void vtkCellLinks::DeletePoint(vtkIdType ptId)
 {
   this->Array[ptId].ncells = 0;
-  delete [] this->Array[ptId].cells;
+  if ( !this->IsInStorage(this->Array[ptId].cells) )
+    {
+    delete [] this->Array[ptId].cells;
+    }
   this->Array[ptId].cells = NULL;
 }
 
@@ -206,9 +228,15 @@ inline void vtkCellLinks::ResizeCellList(vtkIdType ptId, int size)
   
   newSize = this->Array[ptId].ncells + size;
   cells = new vtkIdType[newSize];
-  memcpy(cells, this->Array[ptId].cells,
-         this->Array[ptId].ncells*sizeof(vtkIdType));
-  delete [] this->Array[ptId].cells;
+  if ( this->Array[ptId].ncells > 0 )
+    {
+    memcpy(cells, this->Array[ptId].cells,
+           this->Array[ptId].ncells*sizeof(vtkIdType));
+    }
+  if ( !this->IsInStorage(this->Array[ptId].cells) )
+    {
+    delete [] this->Array[ptId].cells;
+    }
   this->Array[ptId].cells = cells;
 }
 
@@ -15,6 +15,7 @@
 #include "vtkColorTransferFunction.h"
 
 #include "vtkMath.h"
+#include "vtkMultiThreader.h"
 #include "vtkObjectFactory.h"
 #include <vtkstd/vector>
 #include <vtkstd/set>
@@ -237,6 +238,9 @@ vtkColorTransferFunction::vtkColorTransferFunction()
 
   this->Scale = VTK_CTF_LINEAR;
 
+  this->UseBakedTable = 0;
+  this->BakedTableSize = 4096;
+
   this->NanColor[0] = 0.5;
   this->NanColor[1] = 0.0;
   this->NanColor[2] = 0.0;
@@ -1224,6 +1228,8 @@ void vtkColorTransferFunction::DeepCopy( vtkScalarsToColors *o )
     this->ColorSpace   = f->ColorSpace;
     this->HSVWrap      = f->HSVWrap;
     this->Scale        = f->Scale;
+    this->UseBakedTable  = f->UseBakedTable;
+    this->BakedTableSize = f->BakedTableSize;
 
     int i;
     this->RemoveAllPoints();
@@ -1248,6 +1254,8 @@ void vtkColorTransferFunction::ShallowCopy( vtkColorTransferFunction *f )
     this->ColorSpace   = f->ColorSpace;
     this->HSVWrap      = f->HSVWrap;
     this->Scale        = f->Scale;
+    this->UseBakedTable  = f->UseBakedTable;
+    this->BakedTableSize = f->BakedTableSize;
 
     int i;
     this->RemoveAllPoints();
@@ -1440,6 +1448,352 @@ void vtkColorTransferFunctionMapData(vtkColorTransferFunction* self,
     }  
 }
 
+//----------------------------------------------------------------------------
+// Everything needed to map a range of the scalars, shared by all threads.
+// When a baked table is used, Colors holds the RGBA value and Luminance
+// the luminance of each of the TableSize samples of the function,
+// followed by the colors below the range, above the range and of NaN.
+struct vtkColorTransferFunctionMapStruct
+{
+  vtkColorTransferFunction *Self;
+  void *Input;
+  unsigned char *Output;
+  int DataType;
+  int DataTypeSize;
+  int InputIncrement;
+  int OutputFormat;
+  vtkIdType NumberOfValues;
+
+  int UseTable;
+  vtkstd::vector<vtkTypeUInt32> Colors;
+  vtkstd::vector<unsigned char> Luminance;
+  int TableSize;
+  int LogScale;
+  double Range[2];
+  double Start;
+  double Scale;
+
+  // fixed-point mapping of integer scalars, see below
+  int UseFixedPoint;
+  vtkTypeInt64 FixedStart;
+  vtkTypeInt64 FixedBelow;
+  vtkTypeInt64 FixedEnd;
+  vtkTypeInt64 FixedScale;
+  vtkTypeInt64 FixedOffset;
+};
+
+// Number of fractional bits of the fixed-point mapping.
+#define VTK_CTF_FIXED_POINT_BITS 16
+
+// Number of values mapped at a time by the baked table kernels.
+#define VTK_CTF_BLOCK_SIZE 512
+
+// Scalars are only mapped by several threads when each thread gets at
+// least this many values.
+#define VTK_CTF_VALUES_PER_THREAD 65536
+
+//----------------------------------------------------------------------------
+// Write the colors of the table entries listed in indices.
+static void vtkColorTransferFunctionWriteColors(
+  const vtkColorTransferFunctionMapStruct *str, const int *indices, int n,
+  unsigned char *output)
+{
+  const vtkTypeUInt32 *colors = &str->Colors[0];
+  const unsigned char *luminance = &str->Luminance[0];
+  int j;
+
+  switch (str->OutputFormat)
+    {
+    case VTK_RGBA:
+      for (j = 0; j < n; j++)
+        {
+        memcpy(output + 4*j, colors + indices[j], 4);
+        }
+      break;
+    case VTK_RGB:
+      for (j = 0; j < n; j++)
+        {
+        memcpy(output + 3*j, colors + indices[j], 3);
+        }
+      break;
+    case VTK_LUMINANCE_ALPHA:
+      for (j = 0; j < n; j++)
+        {
+        output[2*j] = luminance[indices[j]];
+        output[2*j+1] = reinterpret_cast<const unsigned char *>(
+          colors + indices[j])[3];
+        }
+      break;
+    default: // VTK_LUMINANCE
+      for (j = 0; j < n; j++)
+        {
+        output[j] = luminance[indices[j]];
+        }
+      break;
+    }
+}
+
+//----------------------------------------------------------------------------
+// Map scalars through the baked table. The index computation is branch
+// free so that the compiler can vectorize it. As with the exact mapping,
+// a value equal to the start of the range counts as below the range.
+template <class T>
+void vtkColorTransferFunctionMapThroughTable(
+  const vtkColorTransferFunctionMapStruct *str, const T *input,
+  unsigned char *output, vtkIdType length)
+{
+  double values[VTK_CTF_BLOCK_SIZE];
+  int indices[VTK_CTF_BLOCK_SIZE];
+  const int inIncr = str->InputIncrement;
+  const int outIncr = str->OutputFormat;
+  const double rmin = str->Range[0];
+  const double rmax = str->Range[1];
+  const double start = str->Start;
+  const double scale = str->Scale;
+  const double maxIndex = str->TableSize - 1;
+  const int below = str->TableSize;
+  const int above = str->TableSize + 1;
+  const int nan = str->TableSize + 2;
+
+  while (length > 0)
+    {
+    int n = (length < VTK_CTF_BLOCK_SIZE ?
+             static_cast<int>(length) : VTK_CTF_BLOCK_SIZE);
+    int j;
+    for (j = 0; j < n; j++)
+      {
+      values[j] = static_cast<double>(input[j*inIncr]);
+      }
+    if (str->LogScale)
+      {
+      // the range is positive, so values outside of it need no log
+      for (j = 0; j < n; j++)
+        {
+        double x = values[j];
+        double t = (x > 0 ? log10(x) : start);
+        t = (t - start)*scale + 0.5;
+        t = (t > 0 ? t : 0);
+        t = (t < maxIndex ? t : maxIndex);
+        int idx = static_cast<int>(t);
+        idx = (x <= rmin ? below : idx);
+        idx = (x > rmax ? above : idx);
+        indices[j] = (x == x ? idx : nan);
+        }
+      }
+    else
+      {
+      for (j = 0; j < n; j++)
+        {
+        double x = values[j];
+        double t = (x - start)*scale + 0.5;
+        t = (t > 0 ? t : 0);
+        t = (t < maxIndex ? t : maxIndex);
+        int idx = static_cast<int>(t);
+        idx = (x <= rmin ? below : idx);
+        idx = (x > rmax ? above : idx);
+        indices[j] = (x == x ? idx : nan);
+        }
+      }
+    vtkColorTransferFunctionWriteColors(str, indices, n, output);
+    input += n*inIncr;
+    output += n*outIncr;
+    length -= n;
+    }
+}
+
+//----------------------------------------------------------------------------
+// Map integer scalars through the baked table with fixed-point
+// arithmetic: the index of x is
+// ((x - FixedStart)*FixedScale + FixedOffset) >> VTK_CTF_FIXED_POINT_BITS.
+template <class T>
+void vtkColorTransferFunctionMapThroughTableFixed(
+  const vtkColorTransferFunctionMapStruct *str, const T *input,
+  unsigned char *output, vtkIdType length)
+{
+  int indices[VTK_CTF_BLOCK_SIZE];
+  const int inIncr = str->InputIncrement;
+  const int outIncr = str->OutputFormat;
+  const vtkTypeInt64 fixedStart = str->FixedStart;
+  const vtkTypeInt64 fixedBelow = str->FixedBelow;
+  const vtkTypeInt64 fixedEnd = str->FixedEnd;
+  const vtkTypeInt64 fixedScale = str->FixedScale;
+  const vtkTypeInt64 fixedOffset = str->FixedOffset;
+  const vtkTypeInt64 maxIndex = str->TableSize - 1;
+  const int below = str->TableSize;
+  const int above = str->TableSize + 1;
+
+  while (length > 0)
+    {
+    int n = (length < VTK_CTF_BLOCK_SIZE ?
+             static_cast<int>(length) : VTK_CTF_BLOCK_SIZE);
+    for (int j = 0; j < n; j++)
+      {
+      vtkTypeInt64 x = static_cast<vtkTypeInt64>(input[j*inIncr]);
+      vtkTypeInt64 idx = ((x - fixedStart)*fixedScale + fixedOffset) >>
+        VTK_CTF_FIXED_POINT_BITS;
+      idx = (idx < maxIndex ? idx : maxIndex);
+      idx = (x <= fixedBelow ? below : idx);
+      idx = (x > fixedEnd ? above : idx);
+      indices[j] = static_cast<int>(idx);
+      }
+    vtkColorTransferFunctionWriteColors(str, indices, n, output);
+    input += n*inIncr;
+    output += n*outIncr;
+    length -= n;
+    }
+}
+
+//----------------------------------------------------------------------------
+// Sample the function into the baked table.
+static void vtkColorTransferFunctionBakeTable(
+  vtkColorTransferFunctionMapStruct *str, int tableSize, double nanColor[3],
+  int logScale, int clamping)
+{
+  vtkColorTransferFunction *self = str->Self;
+  unsigned char alpha = static_cast<unsigned char>(self->GetAlpha()*255.0);
+  const double *range = self->GetRange();
+
+  str->TableSize = tableSize;
+  str->LogScale = logScale;
+  str->Range[0] = range[0];
+  str->Range[1] = range[1];
+
+  vtkstd::vector<double> rgb(3*(tableSize + 3));
+  self->GetTable(range[0], range[1], tableSize, &rgb[0]);
+  double node[6];
+  double *extra = &rgb[3*tableSize];
+  self->GetNodeValue(0, node);
+  if (!clamping)
+    {
+    // GetTable() samples the first node as if it were out of range, as
+    // the exact mapping does for values equal to it (see the kernels)
+    rgb[0] = node[1];
+    rgb[1] = node[2];
+    rgb[2] = node[3];
+    }
+  extra[0] = (clamping ? node[1] : 0.0);
+  extra[1] = (clamping ? node[2] : 0.0);
+  extra[2] = (clamping ? node[3] : 0.0);
+  self->GetNodeValue(self->GetSize() - 1, node);
+  extra[3] = (clamping ? node[1] : 0.0);
+  extra[4] = (clamping ? node[2] : 0.0);
+  extra[5] = (clamping ? node[3] : 0.0);
+  extra[6] = nanColor[0];
+  extra[7] = nanColor[1];
+  extra[8] = nanColor[2];
+
+  str->Colors.resize(tableSize + 3);
+  str->Luminance.resize(tableSize + 3);
+  for (int i = 0; i < tableSize + 3; i++)
+    {
+    const double *c = &rgb[3*i];
+    unsigned char rgba[4];
+    rgba[0] = static_cast<unsigned char>(c[0]*255.0 + 0.5);
+    rgba[1] = static_cast<unsigned char>(c[1]*255.0 + 0.5);
+    rgba[2] = static_cast<unsigned char>(c[2]*255.0 + 0.5);
+    rgba[3] = alpha;
+    memcpy(&str->Colors[i], rgba, 4);
+    str->Luminance[i] = static_cast<unsigned char>(c[0]*76.5 + c[1]*150.45 +
+                                                   c[2]*28.05 + 0.5);
+    }
+
+  double start = range[0];
+  double end = range[1];
+  if (logScale)
+    {
+    start = log10(start);
+    end = log10(end);
+    }
+  str->Start = start;
+  str->Scale = (end > start ? (tableSize - 1)/(end - start) : 0.0);
+
+  // Integer scalars of at most 32 bits whose range is small enough for
+  // the rounding of the fixed-point scale to stay below half an entry.
+  str->UseFixedPoint = 0;
+  if (!logScale && range[1] - range[0] <= 65536.0)
+    {
+    switch (str->DataType)
+      {
+      case VTK_CHAR:
+      case VTK_SIGNED_CHAR:
+      case VTK_SHORT:
+      case VTK_INT:
+      case VTK_UNSIGNED_INT:
+        str->UseFixedPoint = 1;
+        break;
+      }
+    }
+  if (str->UseFixedPoint)
+    {
+    double one = static_cast<double>(1 << VTK_CTF_FIXED_POINT_BITS);
+    double fixedStart = ceil(range[0]);
+    str->FixedStart = static_cast<vtkTypeInt64>(fixedStart);
+    str->FixedBelow = str->FixedStart - (fixedStart > range[0] ? 1 : 0);
+    str->FixedEnd = static_cast<vtkTypeInt64>(floor(range[1]));
+    str->FixedScale = static_cast<vtkTypeInt64>(str->Scale*one + 0.5);
+    str->FixedOffset = static_cast<vtkTypeInt64>(
+      ((fixedStart - range[0])*str->Scale + 0.5)*one + 0.5);
+    }
+}
+
+//----------------------------------------------------------------------------
+// Map the values [begin,end) of the scalars.
+static void vtkColorTransferFunctionMapRange(
+  vtkColorTransferFunctionMapStruct *str, vtkIdType begin, vtkIdType end)
+{
+  void *input = static_cast<char *>(str->Input) +
+    begin*str->InputIncrement*str->DataTypeSize;
+  unsigned char *output = str->Output + begin*str->OutputFormat;
+  vtkIdType length = end - begin;
+
+  if (str->UseFixedPoint)
+    {
+    switch (str->DataType)
+      {
+      vtkTemplateMacro(
+        vtkColorTransferFunctionMapThroughTableFixed(
+          str, static_cast<VTK_TT*>(input), output, length));
+      }
+    }
+  else if (str->UseTable)
+    {
+    switch (str->DataType)
+      {
+      vtkTemplateMacro(
+        vtkColorTransferFunctionMapThroughTable(
+          str, static_cast<VTK_TT*>(input), output, length));
+      }
+    }
+  else
+    {
+    switch (str->DataType)
+      {
+      vtkTemplateMacro(
+        vtkColorTransferFunctionMapData(str->Self,
+                                        static_cast<VTK_TT*>(input),
+                                        output, static_cast<int>(length),
+                                        str->InputIncrement,
+                                        str->OutputFormat, 1));
+      }
+    }
+}
+
+//----------------------------------------------------------------------------
+static VTK_THREAD_RETURN_TYPE vtkColorTransferFunctionMapThread(void *arg)
+{
+  vtkMultiThreader::ThreadInfo *info =
+    static_cast<vtkMultiThreader::ThreadInfo *>(arg);
+  vtkColorTransferFunctionMapStruct *str =
+    static_cast<vtkColorTransferFunctionMapStruct *>(info->UserData);
+
+  vtkIdType n = str->NumberOfValues;
+  vtkColorTransferFunctionMapRange(
+    str, n*info->ThreadID/info->NumberOfThreads,
+    n*(info->ThreadID + 1)/info->NumberOfThreads);
+
+  return VTK_THREAD_RETURN_VALUE;
+}
+
 //----------------------------------------------------------------------------
 void vtkColorTransferFunction::MapScalarsThroughTable2(void *input, 
                                                        unsigned char *output,
@@ -1448,17 +1802,71 @@ void vtkColorTransferFunction::MapScalarsThroughTable2(void *input,
                                                        int inputIncrement,
                                                        int outputFormat)
 {
+  vtkColorTransferFunctionMapStruct str;
+
   switch (inputDataType)
     {
-    vtkTemplateMacro(
-      vtkColorTransferFunctionMapData(this, static_cast<VTK_TT*>(input),
-                                      output, numberOfValues, inputIncrement,
-                                      outputFormat, 1)
-      );
+    vtkTemplateMacro(str.DataTypeSize = static_cast<int>(sizeof(VTK_TT)));
     default:
       vtkErrorMacro(<< "MapImageThroughTable: Unknown input ScalarType");
       return;
     }
+
+  // These already go through a table with an entry per value, which
+  // they build themselves, so they are not threaded.
+  if (inputDataType == VTK_UNSIGNED_CHAR)
+    {
+    vtkColorTransferFunctionMapData(this, static_cast<unsigned char*>(input),
+                                    output, numberOfValues, inputIncrement,
+                                    outputFormat, 1);
+    return;
+    }
+  if (inputDataType == VTK_UNSIGNED_SHORT)
+    {
+    vtkColorTransferFunctionMapData(this, static_cast<unsigned short*>(input),
+                                    output, numberOfValues, inputIncrement,
+                                    outputFormat, 1);
+    return;
+    }
+
+  if (this->GetSize() == 0)
+    {
+    vtkWarningMacro("Transfer Function Has No Points!");
+    return;
+    }
+
+  str.Self = this;
+  str.Input = input;
+  str.Output = output;
+  str.DataType = inputDataType;
+  str.InputIncrement = inputIncrement;
+  str.OutputFormat = outputFormat;
+  str.NumberOfValues = numberOfValues;
+  str.UseTable = this->UseBakedTable;
+  str.UseFixedPoint = 0;
+  if (str.UseTable)
+    {
+    vtkColorTransferFunctionBakeTable(
+      &str, this->BakedTableSize, this->NanColor,
+      this->Scale == VTK_CTF_LOG10 && this->Range[0] > 0.0, this->Clamping);
+    }
+
+  int numThreads = numberOfValues/VTK_CTF_VALUES_PER_THREAD;
+  if (numThreads > vtkMultiThreader::GetGlobalDefaultNumberOfThreads())
+    {
+    numThreads = vtkMultiThreader::GetGlobalDefaultNumberOfThreads();
+    }
+  if (numThreads <= 1)
+    {
+    vtkColorTransferFunctionMapRange(&str, 0, numberOfValues);
+    return;
+    }
+
+  vtkMultiThreader *threader = vtkMultiThreader::New();
+  threader->SetNumberOfThreads(numThreads);
+  threader->SetSingleMethod(vtkColorTransferFunctionMapThread, &str);
+  threader->SingleMethodExecute();
+  threader->Delete();
 }
 
 //----------------------------------------------------------------------------
@@ -1604,6 +2012,8 @@ void vtkColorTransferFunction::PrintSelf(ostream& os, vtkIndent indent)
      << this->Range[1] << endl;
 
   os << indent << "AllowDuplicateScalars: " << this->AllowDuplicateScalars << endl;
+  os << indent << "UseBakedTable: " << this->UseBakedTable << endl;
+  os << indent << "BakedTableSize: " << this->BakedTableSize << endl;
 
   os << indent << "NanColor: "
      << this->NanColor[0] << ", " << this->NanColor[1] << ", "
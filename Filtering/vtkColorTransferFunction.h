@@ -193,6 +193,25 @@ public:
   // Get the number of available colors for mapping to.
   virtual vtkIdType GetNumberOfAvailableColors();
 
+  // Description:
+  // When on, MapScalarsThroughTable2() samples the function once into a
+  // table of BakedTableSize colors spanning the range of the nodes and
+  // maps each scalar to the nearest entry, instead of evaluating the
+  // function for every scalar. Integer scalars with a small range are
+  // mapped to the table with fixed-point arithmetic. This is much faster
+  // for large arrays, but the colors are quantized to the table
+  // resolution. Unsigned char and unsigned short scalars always go
+  // through a table with one entry per value. Off by default.
+  vtkSetMacro(UseBakedTable, int);
+  vtkGetMacro(UseBakedTable, int);
+  vtkBooleanMacro(UseBakedTable, int);
+
+  // Description:
+  // The number of colors in the table used when UseBakedTable is on.
+  // The default is 4096.
+  vtkSetClampMacro(BakedTableSize, int, 2, 1048576);
+  vtkGetMacro(BakedTableSize, int);
+
 protected:
   vtkColorTransferFunction();
   ~vtkColorTransferFunction();
@@ -227,6 +246,9 @@ protected:
 
   int AllowDuplicateScalars;
 
+  int UseBakedTable;
+  int BakedTableSize;
+
   vtkTimeStamp BuildTime;
   unsigned char *Table;
   int TableSize;
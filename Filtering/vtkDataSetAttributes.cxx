@@ -30,6 +30,8 @@
 #include "vtkIdTypeArray.h"
 #include "vtkObjectFactory.h"
 #include "vtkInformation.h"
+#include "vtkIdList.h"
+#include "vtkMultiThreader.h"
 
 #include <vtkstd/vector>
 
@@ -39,6 +41,27 @@ namespace
 }
 class vtkDataSetAttributes::vtkInternalComponentNames : public vtkInternalComponentNameBase {};
 
+// Minimum amount of work (tuples times arrays) given to each thread by the
+// batched interpolation.
+#define VTK_DATA_SET_ATTRIBUTES_TUPLES_PER_THREAD 65536
+
+//--------------------------------------------------------------------------
+// Requests recorded between BeginInterpolationBatch() and
+// EndInterpolationBatch(). Tuple i is interpolated from
+// Ids[Offsets[i]..Offsets[i+1]) and Weights[Offsets[i]..Offsets[i+1]).
+// Edges[i] is set for requests that came from InterpolateEdge(), which
+// truncates instead of rounding and honors nearest neighbor interpolation.
+class vtkDataSetAttributes::vtkInterpolationBatch
+{
+public:
+  vtkDataSetAttributes* Source;
+  vtkstd::vector<vtkIdType> ToIds;
+  vtkstd::vector<vtkIdType> Offsets;
+  vtkstd::vector<vtkIdType> Ids;
+  vtkstd::vector<double> Weights;
+  vtkstd::vector<unsigned char> Edges;
+};
+
 vtkStandardNewMacro(vtkDataSetAttributes);
 
 //--------------------------------------------------------------------------
@@ -90,7 +113,7 @@ vtkDataSetAttributes::vtkDataSetAttributes()
   this->CopyAttributeFlags[INTERPOLATE][PEDIGREEIDS] = 0;
 
   this->TargetIndices=0;
-
+  this->InterpolationBatch=0;
 }
 
 //--------------------------------------------------------------------------
@@ -271,6 +294,10 @@ void vtkDataSetAttributes::Initialize()
   this->CopyAttributeFlags[INTERPOLATE][GLOBALIDS] = 0;
   
   this->CopyAttributeFlags[INTERPOLATE][PEDIGREEIDS] = 0;
+
+  // Any pending batch refers to arrays which are gone now.
+  delete this->InterpolationBatch;
+  this->InterpolationBatch = 0;
 }
 
 //--------------------------------------------------------------------------
@@ -729,6 +756,271 @@ void vtkDataSetAttributes::InterpolateAllocate(vtkDataSetAttributes* pd,
   this->InternalCopyAllocate(pd, INTERPOLATE, sze, ext, shallowCopyArrays);
 }
 
+//--------------------------------------------------------------------------
+// Batched interpolation. A pair couples an input array with the output
+// array it is interpolated into.
+struct vtkDataSetAttributesBatchPair
+{
+  vtkAbstractArray* From;
+  vtkAbstractArray* To;
+  int Nearest;
+};
+
+struct vtkDataSetAttributesBatchStruct
+{
+  vtkstd::vector<vtkDataSetAttributesBatchPair>* Pairs;
+  vtkIdType NumberOfTuples;
+  const vtkIdType* ToIds;
+  const vtkIdType* Offsets;
+  const vtkIdType* Ids;
+  const double* Weights;
+  const unsigned char* Edges;
+};
+
+//--------------------------------------------------------------------------
+template <class T>
+inline void vtkDataSetAttributesRoundIfNecessary(double val, T* retVal)
+{
+  *retVal = static_cast<T>((val>=0.0)?(val + 0.5):(val - 0.5));
+}
+
+//--------------------------------------------------------------------------
+VTK_TEMPLATE_SPECIALIZE
+inline void vtkDataSetAttributesRoundIfNecessary(double val, double* retVal)
+{
+  *retVal = val;
+}
+
+//--------------------------------------------------------------------------
+VTK_TEMPLATE_SPECIALIZE
+inline void vtkDataSetAttributesRoundIfNecessary(double val, float* retVal)
+{
+  *retVal = static_cast<float>(val);
+}
+
+//--------------------------------------------------------------------------
+// Interpolate tuples [begin,end) of the batch for one array. The arithmetic
+// (summation order, rounding of point requests, truncation of edge
+// requests) matches vtkDataArray::InterpolateTuple() exactly. The inner
+// loops run over contiguous components so that the compiler can vectorize
+// them.
+template <class T>
+void vtkDataSetAttributesInterpolateRange(const T* from, T* to, int numComp,
+                                          int nearest,
+                                          vtkDataSetAttributesBatchStruct* b,
+                                          vtkIdType begin, vtkIdType end,
+                                          double* sum)
+{
+  for (vtkIdType r = begin; r < end; ++r)
+    {
+    T* out = to + b->ToIds[r]*numComp;
+    vtkIdType first = b->Offsets[r];
+    vtkIdType last = b->Offsets[r+1];
+    int c;
+    if (b->Edges && b->Edges[r])
+      {
+      double t = b->Weights[first+1];
+      if (nearest)
+        {
+        t = (t < 0.5) ? 0.0 : 1.0;
+        }
+      const T* p1 = from + b->Ids[first]*numComp;
+      const T* p2 = from + b->Ids[first+1]*numComp;
+      for (c = 0; c < numComp; ++c)
+        {
+        out[c] = static_cast<T>((1.0 - t) * static_cast<double>(p1[c])
+                                + t * static_cast<double>(p2[c]));
+        }
+      continue;
+      }
+    for (c = 0; c < numComp; ++c)
+      {
+      sum[c] = 0.0;
+      }
+    for (vtkIdType k = first; k < last; ++k)
+      {
+      double w = b->Weights[k];
+      const T* in = from + b->Ids[k]*numComp;
+      for (c = 0; c < numComp; ++c)
+        {
+        sum[c] += w*static_cast<double>(in[c]);
+        }
+      }
+    for (c = 0; c < numComp; ++c)
+      {
+      vtkDataSetAttributesRoundIfNecessary(sum[c], out + c);
+      }
+    }
+}
+
+//--------------------------------------------------------------------------
+// Returns true if the pair can be handled by the raw pointer kernels.
+static bool vtkDataSetAttributesIsFastPair(vtkDataSetAttributesBatchPair& p)
+{
+  vtkDataArray* from = vtkDataArray::SafeDownCast(p.From);
+  vtkDataArray* to = vtkDataArray::SafeDownCast(p.To);
+  if (!from || !to || from == to ||
+      from->GetDataType() != to->GetDataType() ||
+      from->GetNumberOfComponents() != to->GetNumberOfComponents())
+    {
+    return false;
+    }
+  switch (from->GetDataType())
+    {
+    vtkTemplateMacro(return true);
+    }
+  return false;
+}
+
+//--------------------------------------------------------------------------
+// Interpolate tuples [begin,end) of the batch for all (fast) arrays, one
+// array after the other.
+static void vtkDataSetAttributesInterpolateBatchRange(
+  vtkDataSetAttributesBatchStruct* b, vtkIdType begin, vtkIdType end)
+{
+  vtkstd::vector<double> sum;
+  vtkstd::vector<vtkDataSetAttributesBatchPair>::iterator it;
+  for (it = b->Pairs->begin(); it != b->Pairs->end(); ++it)
+    {
+    vtkDataArray* from = static_cast<vtkDataArray*>(it->From);
+    vtkDataArray* to = static_cast<vtkDataArray*>(it->To);
+    int numComp = to->GetNumberOfComponents();
+    sum.resize(numComp);
+    switch (to->GetDataType())
+      {
+      vtkTemplateMacro(
+        vtkDataSetAttributesInterpolateRange(
+          static_cast<VTK_TT*>(from->GetVoidPointer(0)),
+          static_cast<VTK_TT*>(to->GetVoidPointer(0)),
+          numComp, it->Nearest, b, begin, end, &sum[0]));
+      }
+    }
+}
+
+//--------------------------------------------------------------------------
+static VTK_THREAD_RETURN_TYPE vtkDataSetAttributesInterpolateBatchExecute(
+  void *arg)
+{
+  vtkMultiThreader::ThreadInfo* info =
+    static_cast<vtkMultiThreader::ThreadInfo*>(arg);
+  vtkDataSetAttributesBatchStruct* b =
+    static_cast<vtkDataSetAttributesBatchStruct*>(info->UserData);
+
+  vtkIdType num = b->NumberOfTuples;
+  vtkIdType begin = num * info->ThreadID / info->NumberOfThreads;
+  vtkIdType end = num * (info->ThreadID + 1) / info->NumberOfThreads;
+  vtkDataSetAttributesInterpolateBatchRange(b, begin, end);
+
+  return VTK_THREAD_RETURN_VALUE;
+}
+
+//--------------------------------------------------------------------------
+// Interpolate a batch for the given array pairs. Arrays which cannot be
+// accessed through raw pointers (bit arrays, string arrays, in place
+// interpolation...) go through the regular InterpolateTuple() calls.
+static void vtkDataSetAttributesInterpolateBatch(
+  vtkstd::vector<vtkDataSetAttributesBatchPair>& pairs,
+  vtkIdType numTuples, const vtkIdType* toIds, const vtkIdType* offsets,
+  const vtkIdType* ids, const double* weights, const unsigned char* edges)
+{
+  if (numTuples <= 0 || pairs.empty())
+    {
+    return;
+    }
+
+  vtkIdType maxId = 0;
+  vtkIdType r;
+  for (r = 0; r < numTuples; ++r)
+    {
+    if (toIds[r] > maxId)
+      {
+      maxId = toIds[r];
+      }
+    }
+
+  vtkstd::vector<vtkDataSetAttributesBatchPair> fast;
+  vtkIdList* ptIds = 0;
+  vtkstd::vector<vtkDataSetAttributesBatchPair>::iterator it;
+  for (it = pairs.begin(); it != pairs.end(); ++it)
+    {
+    if (vtkDataSetAttributesIsFastPair(*it))
+      {
+      // Grow the output once, up front. Threads must not reallocate.
+      int numComp = it->To->GetNumberOfComponents();
+      static_cast<vtkDataArray*>(it->To)->WriteVoidPointer(
+        maxId*numComp, numComp);
+      fast.push_back(*it);
+      continue;
+      }
+    if (!ptIds)
+      {
+      ptIds = vtkIdList::New();
+      }
+    for (r = 0; r < numTuples; ++r)
+      {
+      vtkIdType first = offsets[r];
+      if (edges && edges[r])
+        {
+        double t = weights[first+1];
+        if (it->Nearest)
+          {
+          t = (t < 0.5) ? 0.0 : 1.0;
+          }
+        it->To->InterpolateTuple(toIds[r], ids[first], it->From,
+                                 ids[first+1], it->From, t);
+        }
+      else
+        {
+        vtkIdType numIds = offsets[r+1] - first;
+        ptIds->SetNumberOfIds(numIds);
+        for (vtkIdType k = 0; k < numIds; ++k)
+          {
+          ptIds->SetId(k, ids[first+k]);
+          }
+        it->To->InterpolateTuple(toIds[r], ptIds, it->From,
+                                 const_cast<double*>(weights + first));
+        }
+      }
+    }
+  if (ptIds)
+    {
+    ptIds->Delete();
+    }
+  if (fast.empty())
+    {
+    return;
+    }
+
+  vtkDataSetAttributesBatchStruct b;
+  b.Pairs = &fast;
+  b.NumberOfTuples = numTuples;
+  b.ToIds = toIds;
+  b.Offsets = offsets;
+  b.Ids = ids;
+  b.Weights = weights;
+  b.Edges = edges;
+
+  // Small batches are not worth the cost of spawning threads.
+  int numThreads = vtkMultiThreader::GetGlobalDefaultNumberOfThreads();
+  vtkIdType maxThreads = numTuples * static_cast<vtkIdType>(fast.size()) /
+    VTK_DATA_SET_ATTRIBUTES_TUPLES_PER_THREAD;
+  if (maxThreads < numThreads)
+    {
+    numThreads = static_cast<int>(maxThreads);
+    }
+  if (numThreads <= 1)
+    {
+    vtkDataSetAttributesInterpolateBatchRange(&b, 0, numTuples);
+    return;
+    }
+
+  vtkMultiThreader* threader = vtkMultiThreader::New();
+  threader->SetNumberOfThreads(numThreads);
+  threader->SetSingleMethod(vtkDataSetAttributesInterpolateBatchExecute, &b);
+  threader->SingleMethodExecute();
+  threader->Delete();
+}
+
 //--------------------------------------------------------------------------
 // Interpolate data from points and interpolation weights. Make sure that the 
 // method InterpolateAllocate() has been invoked before using this method.
@@ -736,6 +1028,19 @@ void vtkDataSetAttributes::InterpolatePoint(vtkDataSetAttributes *fromPd,
                                             vtkIdType toId, vtkIdList *ptIds, 
                                             double *weights)
 {
+  if (this->InterpolationBatch && this->InterpolationBatch->Source == fromPd)
+    {
+    vtkInterpolationBatch* batch = this->InterpolationBatch;
+    vtkIdType numIds = ptIds->GetNumberOfIds();
+    batch->ToIds.push_back(toId);
+    batch->Ids.insert(batch->Ids.end(), ptIds->GetPointer(0),
+                      ptIds->GetPointer(0) + numIds);
+    batch->Weights.insert(batch->Weights.end(), weights, weights + numIds);
+    batch->Offsets.push_back(static_cast<vtkIdType>(batch->Ids.size()));
+    batch->Edges.push_back(0);
+    return;
+    }
+
   int i;
   for(i=this->RequiredArrays.BeginIndex(); !this->RequiredArrays.End(); 
       i=this->RequiredArrays.NextIndex())
@@ -754,6 +1059,19 @@ void vtkDataSetAttributes::InterpolateEdge(vtkDataSetAttributes *fromPd,
                                            vtkIdType toId, vtkIdType p1,
                                            vtkIdType p2, double t)
 {
+  if (this->InterpolationBatch && this->InterpolationBatch->Source == fromPd)
+    {
+    vtkInterpolationBatch* batch = this->InterpolationBatch;
+    batch->ToIds.push_back(toId);
+    batch->Ids.push_back(p1);
+    batch->Ids.push_back(p2);
+    batch->Weights.push_back(1.0 - t);
+    batch->Weights.push_back(t);
+    batch->Offsets.push_back(static_cast<vtkIdType>(batch->Ids.size()));
+    batch->Edges.push_back(1);
+    return;
+    }
+
   int i;
   for(i=this->RequiredArrays.BeginIndex(); !this->RequiredArrays.End(); 
       i=this->RequiredArrays.NextIndex())
@@ -813,6 +1131,215 @@ void vtkDataSetAttributes::InterpolateTime(vtkDataSetAttributes *from1,
     }
 }
 
+//--------------------------------------------------------------------------
+void vtkDataSetAttributes::InterpolatePoints(vtkDataSetAttributes *fromPd,
+                                             vtkIdType numTuples,
+                                             const vtkIdType *toIds,
+                                             const vtkIdType *offsets,
+                                             const vtkIdType *ids,
+                                             const double *weights)
+{
+  vtkstd::vector<vtkDataSetAttributesBatchPair> pairs;
+  int i;
+  for(i=this->RequiredArrays.BeginIndex(); !this->RequiredArrays.End(); 
+      i=this->RequiredArrays.NextIndex())
+    {
+    vtkDataSetAttributesBatchPair pair;
+    pair.From = fromPd->Data[i];
+    pair.To = this->Data[this->TargetIndices[i]];
+    int attributeIndex = this->IsArrayAnAttribute(this->TargetIndices[i]);
+    pair.Nearest = (attributeIndex != -1 &&
+      this->CopyAttributeFlags[INTERPOLATE][attributeIndex]==2);
+    pairs.push_back(pair);
+    }
+
+  vtkDataSetAttributesInterpolateBatch(pairs, numTuples, toIds, offsets,
+                                       ids, weights, 0);
+}
+
+//--------------------------------------------------------------------------
+// Batched copy. Tuple i of the output is copied from tuple FromIds[i] of
+// the input, starting at ToId.
+struct vtkDataSetAttributesCopyBatchStruct
+{
+  vtkstd::vector<vtkDataSetAttributesBatchPair>* Pairs;
+  vtkIdType NumberOfTuples;
+  const vtkIdType* FromIds;
+  vtkIdType ToId;
+};
+
+//--------------------------------------------------------------------------
+template <class T>
+void vtkDataSetAttributesCopyRange(const T* from, T* to, int numComp,
+                                   const vtkIdType* fromIds,
+                                   vtkIdType begin, vtkIdType end)
+{
+  for (vtkIdType r = begin; r < end; ++r)
+    {
+    const T* in = from + fromIds[r]*numComp;
+    T* out = to + r*numComp;
+    for (int c = 0; c < numComp; ++c)
+      {
+      out[c] = in[c];
+      }
+    }
+}
+
+//--------------------------------------------------------------------------
+static void vtkDataSetAttributesCopyBatchRange(
+  vtkDataSetAttributesCopyBatchStruct* b, vtkIdType begin, vtkIdType end)
+{
+  vtkstd::vector<vtkDataSetAttributesBatchPair>::iterator it;
+  for (it = b->Pairs->begin(); it != b->Pairs->end(); ++it)
+    {
+    vtkDataArray* from = static_cast<vtkDataArray*>(it->From);
+    vtkDataArray* to = static_cast<vtkDataArray*>(it->To);
+    int numComp = to->GetNumberOfComponents();
+    switch (to->GetDataType())
+      {
+      vtkTemplateMacro(
+        vtkDataSetAttributesCopyRange(
+          static_cast<VTK_TT*>(from->GetVoidPointer(0)),
+          static_cast<VTK_TT*>(to->GetVoidPointer(b->ToId*numComp)),
+          numComp, b->FromIds, begin, end));
+      }
+    }
+}
+
+//--------------------------------------------------------------------------
+static VTK_THREAD_RETURN_TYPE vtkDataSetAttributesCopyBatchExecute(void *arg)
+{
+  vtkMultiThreader::ThreadInfo* info =
+    static_cast<vtkMultiThreader::ThreadInfo*>(arg);
+  vtkDataSetAttributesCopyBatchStruct* b =
+    static_cast<vtkDataSetAttributesCopyBatchStruct*>(info->UserData);
+
+  vtkIdType num = b->NumberOfTuples;
+  vtkIdType begin = num * info->ThreadID / info->NumberOfThreads;
+  vtkIdType end = num * (info->ThreadID + 1) / info->NumberOfThreads;
+  vtkDataSetAttributesCopyBatchRange(b, begin, end);
+
+  return VTK_THREAD_RETURN_VALUE;
+}
+
+//--------------------------------------------------------------------------
+void vtkDataSetAttributes::CopyData(vtkDataSetAttributes *fromPd,
+                                    vtkIdType numTuples,
+                                    const vtkIdType *fromIds,
+                                    vtkIdType toId)
+{
+  if (numTuples <= 0)
+    {
+    return;
+    }
+
+  vtkstd::vector<vtkDataSetAttributesBatchPair> fast;
+  vtkIdType r;
+  int i;
+  for(i=this->RequiredArrays.BeginIndex(); !this->RequiredArrays.End(); 
+      i=this->RequiredArrays.NextIndex())
+    {
+    vtkDataSetAttributesBatchPair pair;
+    pair.From = fromPd->Data[i];
+    pair.To = this->Data[this->TargetIndices[i]];
+    pair.Nearest = 0;
+    if (vtkDataSetAttributesIsFastPair(pair))
+      {
+      // Grow the output once, up front. Threads must not reallocate.
+      int numComp = pair.To->GetNumberOfComponents();
+      static_cast<vtkDataArray*>(pair.To)->WriteVoidPointer(
+        (toId + numTuples - 1)*numComp, numComp);
+      fast.push_back(pair);
+      continue;
+      }
+    for (r = 0; r < numTuples; ++r)
+      {
+      this->CopyTuple(pair.From, pair.To, fromIds[r], toId + r);
+      }
+    }
+  if (fast.empty())
+    {
+    return;
+    }
+
+  vtkDataSetAttributesCopyBatchStruct b;
+  b.Pairs = &fast;
+  b.NumberOfTuples = numTuples;
+  b.FromIds = fromIds;
+  b.ToId = toId;
+
+  int numThreads = vtkMultiThreader::GetGlobalDefaultNumberOfThreads();
+  vtkIdType maxThreads = numTuples * static_cast<vtkIdType>(fast.size()) /
+    VTK_DATA_SET_ATTRIBUTES_TUPLES_PER_THREAD;
+  if (maxThreads < numThreads)
+    {
+    numThreads = static_cast<int>(maxThreads);
+    }
+  if (numThreads <= 1)
+    {
+    vtkDataSetAttributesCopyBatchRange(&b, 0, numTuples);
+    return;
+    }
+
+  vtkMultiThreader* threader = vtkMultiThreader::New();
+  threader->SetNumberOfThreads(numThreads);
+  threader->SetSingleMethod(vtkDataSetAttributesCopyBatchExecute, &b);
+  threader->SingleMethodExecute();
+  threader->Delete();
+}
+
+//--------------------------------------------------------------------------
+void vtkDataSetAttributes::BeginInterpolationBatch(
+  vtkDataSetAttributes *fromPd)
+{
+  if (this->InterpolationBatch)
+    {
+    this->EndInterpolationBatch();
+    }
+  if (!fromPd || fromPd == this)
+    {
+    return;
+    }
+  this->InterpolationBatch = new vtkInterpolationBatch;
+  this->InterpolationBatch->Source = fromPd;
+  this->InterpolationBatch->Offsets.push_back(0);
+}
+
+//--------------------------------------------------------------------------
+void vtkDataSetAttributes::EndInterpolationBatch()
+{
+  vtkInterpolationBatch* batch = this->InterpolationBatch;
+  if (!batch)
+    {
+    return;
+    }
+  // Detach first so that the fallback path interpolates right away.
+  this->InterpolationBatch = 0;
+
+  vtkIdType numTuples = static_cast<vtkIdType>(batch->ToIds.size());
+  if (numTuples > 0)
+    {
+    vtkstd::vector<vtkDataSetAttributesBatchPair> pairs;
+    int i;
+    for(i=this->RequiredArrays.BeginIndex(); !this->RequiredArrays.End(); 
+        i=this->RequiredArrays.NextIndex())
+      {
+      vtkDataSetAttributesBatchPair pair;
+      pair.From = batch->Source->Data[i];
+      pair.To = this->Data[this->TargetIndices[i]];
+      int attributeIndex = this->IsArrayAnAttribute(this->TargetIndices[i]);
+      pair.Nearest = (attributeIndex != -1 &&
+        this->CopyAttributeFlags[INTERPOLATE][attributeIndex]==2);
+      pairs.push_back(pair);
+      }
+    vtkDataSetAttributesInterpolateBatch(pairs, numTuples, &batch->ToIds[0],
+                                         &batch->Offsets[0], &batch->Ids[0],
+                                         &batch->Weights[0],
+                                         &batch->Edges[0]);
+    }
+  delete batch;
+}
+
 //--------------------------------------------------------------------------
 // Copy a tuple of data from one data array to another. This method (and
 // following ones) assume that the fromData and toData objects are of the
@@ -1612,6 +2139,30 @@ void vtkDataSetAttributes::InterpolatePoint(
     }
 }
 
+//--------------------------------------------------------------------------
+void vtkDataSetAttributes::InterpolatePoints(
+  vtkDataSetAttributes::FieldList& list,
+  vtkDataSetAttributes *fromPd,
+  int idx, vtkIdType numTuples, const vtkIdType *toIds,
+  const vtkIdType *offsets, const vtkIdType *ids, const double *weights)
+{
+  vtkstd::vector<vtkDataSetAttributesBatchPair> pairs;
+  for (int i=0; i < list.NumberOfFields; i++)
+    {
+    if ( list.FieldIndices[i] >= 0 && list.DSAIndices[idx][i] >= 0 )
+      {
+      vtkDataSetAttributesBatchPair pair;
+      pair.To = this->GetAbstractArray(list.FieldIndices[i]);
+      pair.From = fromPd->GetAbstractArray(list.DSAIndices[idx][i]);
+      pair.Nearest = 0;
+      pairs.push_back(pair);
+      }
+    }
+
+  vtkDataSetAttributesInterpolateBatch(pairs, numTuples, toIds, offsets,
+                                       ids, weights, 0);
+}
+
 //--------------------------------------------------------------------------
 const char* vtkDataSetAttributes::GetAttributeTypeAsString(int attributeType)
 {
@@ -450,6 +450,15 @@ public:
   // CopyAllOn/Off
   void CopyData(vtkDataSetAttributes *fromPd, vtkIdType fromId, vtkIdType toId);
 
+  // Description:
+  // Copy a batch of tuples: tuple fromIds[i] is copied to toId+i, for i
+  // from 0 to numTuples-1. The same copy rules as above apply. The arrays
+  // are processed one at a time and large batches are split over several
+  // threads. Make sure CopyAllocate() has been invoked before using this
+  // method.
+  void CopyData(vtkDataSetAttributes *fromPd, vtkIdType numTuples,
+                const vtkIdType *fromIds, vtkIdType toId);
+
 
   // Description:
   // Copy a tuple of data from one data array to another. This method
@@ -512,6 +521,31 @@ public:
                        vtkDataSetAttributes *from2,
                        vtkIdType id, double t);
 
+  // Description:
+  // Interpolate a batch of tuples in a single pass. Tuple toIds[i] is
+  // interpolated from the input ids ids[offsets[i]] to ids[offsets[i+1]-1]
+  // with the matching weights, so offsets must hold numTuples+1 entries.
+  // The arrays are processed one at a time (column by column) rather than
+  // tuple by tuple, and large batches are split over several threads.
+  // The result is identical to calling InterpolatePoint() for each tuple.
+  // The toIds must be unique. Make sure that the method InterpolateAllocate()
+  // has been invoked before using this method.
+  void InterpolatePoints(vtkDataSetAttributes *fromPd, vtkIdType numTuples,
+                         const vtkIdType *toIds, const vtkIdType *offsets,
+                         const vtkIdType *ids, const double *weights);
+
+  // Description:
+  // Defer interpolation from fromPd. Between these calls, InterpolatePoint()
+  // and InterpolateEdge() requests whose source is fromPd are only recorded;
+  // EndInterpolationBatch() then interpolates all of them at once as
+  // InterpolatePoints() does. Requests from any other source are executed
+  // immediately. The tuples written by a batch must not be accessed or
+  // written by other means before EndInterpolationBatch() is called, and
+  // fromPd must not be modified in between. This lets filters that
+  // interpolate through vtkCell::Contour() and friends use the batched path.
+  void BeginInterpolationBatch(vtkDataSetAttributes *fromPd);
+  void EndInterpolationBatch();
+
 //BTX
   class FieldList;
 
@@ -551,6 +585,15 @@ public:
     int idx, vtkIdType toId, 
     vtkIdList *ids, double *weights);
 
+  // Description:
+  // Batched form of the FieldList InterpolatePoint(). See the other
+  // InterpolatePoints() signature for the layout of the arguments.
+  void InterpolatePoints(
+    vtkDataSetAttributes::FieldList& list,
+    vtkDataSetAttributes *fromPd,
+    int idx, vtkIdType numTuples, const vtkIdType *toIds,
+    const vtkIdType *offsets, const vtkIdType *ids, const double *weights);
+
   friend class vtkDataSetAttributes::FieldList;
 //ETX
 
@@ -581,6 +624,11 @@ protected:
 
   int* TargetIndices;
 
+  // Pending requests between BeginInterpolationBatch() and
+  // EndInterpolationBatch().
+  class vtkInterpolationBatch;
+  vtkInterpolationBatch* InterpolationBatch;
+
   static const int NumberOfAttributeComponents[NUM_ATTRIBUTES];
   static const int AttributeLimits[NUM_ATTRIBUTES];
   static const char AttributeNames[NUM_ATTRIBUTES][12];
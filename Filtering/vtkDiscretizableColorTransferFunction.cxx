@@ -175,6 +175,25 @@ vtkUnsignedCharArray* vtkDiscretizableColorTransferFunction::MapScalars(vtkDataA
   return this->Superclass::MapScalars(scalars, colorMode, component);
 }
 
+//-----------------------------------------------------------------------------
+void vtkDiscretizableColorTransferFunction::MapScalarsThroughTable2(
+  void *input, unsigned char *output, int inputDataType, int numberOfValues,
+  int inputIncrement, int outputFormat)
+{
+  this->Build();
+  if (this->Discretize)
+    {
+    this->LookupTable->MapScalarsThroughTable2(input, output, inputDataType,
+                                               numberOfValues, inputIncrement,
+                                               outputFormat);
+    return;
+    }
+
+  this->Superclass::MapScalarsThroughTable2(input, output, inputDataType,
+                                            numberOfValues, inputIncrement,
+                                            outputFormat);
+}
+
 //-----------------------------------------------------------------------------
 double* vtkDiscretizableColorTransferFunction::GetRGBPoints()
 {
@@ -88,6 +88,14 @@ public:
   virtual vtkUnsignedCharArray *MapScalars(vtkDataArray *scalars, int colorMode,
                                    int component);
 
+  // Description:
+  // Map a set of scalars through the function. When Discretize is on,
+  // the scalars are mapped through the internal lookup table, as they are
+  // by MapScalars().
+  virtual void MapScalarsThroughTable2(void *input, unsigned char *output,
+                                       int inputDataType, int numberOfValues,
+                                       int inputIncrement, int outputFormat);
+
   // Description:
   // Returns the (x, r, g, b) values as an array.
   double* GetRGBPoints();
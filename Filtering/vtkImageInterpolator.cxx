@@ -549,6 +549,364 @@ void vtkImageInterpolatorGetInterpolationFunc(
     }
 }
 
+//----------------------------------------------------------------------------
+// Interpolation for rows of structured coords that are not on the input
+// grid, as for oblique reslicing.  The rows are done in batches: first the
+// indices and weights along each axis are computed for the whole batch,
+// then the samples are gathered and combined exactly as for one point.
+
+// The number of points in a batch
+#define VTK_IMAGE_INTERPOLATOR_ROW_BATCH 32
+
+template <class F, class T>
+struct vtkImageNLCRowIJKInterpolate
+{
+  static void Nearest(
+    vtkInterpolationInfo *info, const F origin[3], const F step[3],
+    int idX, F *outPtr, int n);
+
+  static void Trilinear(
+    vtkInterpolationInfo *info, const F origin[3], const F step[3],
+    int idX, F *outPtr, int n);
+
+  static void Tricubic(
+    vtkInterpolationInfo *info, const F origin[3], const F step[3],
+    int idX, F *outPtr, int n);
+};
+
+//----------------------------------------------------------------------------
+// Apply the border mode to a batch of indices along one axis
+inline void vtkImageNLCRowIJKBorder(
+  int *ids, int m, int minId, int maxId, int borderMode)
+{
+  switch (borderMode)
+    {
+    case VTK_IMAGE_BORDER_REPEAT:
+      for (int i = 0; i < m; i++)
+        {
+        ids[i] = vtkInterpolateWrap(ids[i], minId, maxId);
+        }
+      break;
+
+    case VTK_IMAGE_BORDER_MIRROR:
+      for (int i = 0; i < m; i++)
+        {
+        ids[i] = vtkInterpolateMirror(ids[i], minId, maxId);
+        }
+      break;
+
+    default:
+      for (int i = 0; i < m; i++)
+        {
+        ids[i] = vtkInterpolateClamp(ids[i], minId, maxId);
+        }
+      break;
+    }
+}
+
+//----------------------------------------------------------------------------
+template <class F, class T>
+void vtkImageNLCRowIJKInterpolate<F, T>::Nearest(
+  vtkInterpolationInfo *info, const F origin[3], const F step[3],
+  int idX, F *outPtr, int n)
+{
+  const T *inPtr = static_cast<const T *>(info->Pointer);
+  int *inExt = info->Extent;
+  vtkIdType *inInc = info->Increments;
+  int numscalars = info->NumberOfComponents;
+
+  int ids[3][VTK_IMAGE_INTERPOLATOR_ROW_BATCH];
+  vtkIdType offsets[VTK_IMAGE_INTERPOLATOR_ROW_BATCH];
+
+  for (int i0 = 0; i0 < n; i0 += VTK_IMAGE_INTERPOLATOR_ROW_BATCH)
+    {
+    int m = n - i0;
+    m = (m < VTK_IMAGE_INTERPOLATOR_ROW_BATCH ?
+         m : VTK_IMAGE_INTERPOLATOR_ROW_BATCH);
+    int base = idX + i0;
+
+    for (int j = 0; j < 3; j++)
+      {
+      F o = origin[j];
+      F d = step[j];
+      int *id = ids[j];
+      for (int i = 0; i < m; i++)
+        {
+        F x = o + (base + i)*d;
+        id[i] = vtkInterpolateRound(x);
+        }
+      vtkImageNLCRowIJKBorder(id, m, inExt[2*j], inExt[2*j+1],
+                              info->BorderMode);
+      }
+
+    for (int i = 0; i < m; i++)
+      {
+      offsets[i] = (ids[0][i]*inInc[0] + ids[1][i]*inInc[1] +
+                    ids[2][i]*inInc[2]);
+      }
+
+    if (numscalars == 1)
+      {
+      for (int i = 0; i < m; i++)
+        {
+        outPtr[i] = inPtr[offsets[i]];
+        }
+      outPtr += m;
+      }
+    else
+      {
+      for (int i = 0; i < m; i++)
+        {
+        const T *tmpPtr = inPtr + offsets[i];
+        int c = numscalars;
+        do
+          {
+          *outPtr++ = *tmpPtr++;
+          }
+        while (--c);
+        }
+      }
+    }
+}
+
+//----------------------------------------------------------------------------
+template <class F, class T>
+void vtkImageNLCRowIJKInterpolate<F, T>::Trilinear(
+  vtkInterpolationInfo *info, const F origin[3], const F step[3],
+  int idX, F *outPtr, int n)
+{
+  const T *inPtr = static_cast<const T *>(info->Pointer);
+  int *inExt = info->Extent;
+  vtkIdType *inInc = info->Increments;
+  int numscalars = info->NumberOfComponents;
+
+  int ids0[3][VTK_IMAGE_INTERPOLATOR_ROW_BATCH];
+  int ids1[3][VTK_IMAGE_INTERPOLATOR_ROW_BATCH];
+  F fracs[3][VTK_IMAGE_INTERPOLATOR_ROW_BATCH];
+
+  for (int i0 = 0; i0 < n; i0 += VTK_IMAGE_INTERPOLATOR_ROW_BATCH)
+    {
+    int m = n - i0;
+    m = (m < VTK_IMAGE_INTERPOLATOR_ROW_BATCH ?
+         m : VTK_IMAGE_INTERPOLATOR_ROW_BATCH);
+    int base = idX + i0;
+
+    for (int j = 0; j < 3; j++)
+      {
+      F o = origin[j];
+      F d = step[j];
+      int *id0 = ids0[j];
+      int *id1 = ids1[j];
+      F *f = fracs[j];
+      for (int i = 0; i < m; i++)
+        {
+        F x = o + (base + i)*d;
+        id0[i] = vtkInterpolateFloor(x, f[i]);
+        id1[i] = id0[i] + (f[i] != 0);
+        }
+      vtkImageNLCRowIJKBorder(id0, m, inExt[2*j], inExt[2*j+1],
+                              info->BorderMode);
+      vtkImageNLCRowIJKBorder(id1, m, inExt[2*j], inExt[2*j+1],
+                              info->BorderMode);
+      }
+
+    for (int i = 0; i < m; i++)
+      {
+      vtkIdType factX0 = ids0[0][i]*inInc[0];
+      vtkIdType factX1 = ids1[0][i]*inInc[0];
+      vtkIdType factY0 = ids0[1][i]*inInc[1];
+      vtkIdType factY1 = ids1[1][i]*inInc[1];
+      vtkIdType factZ0 = ids0[2][i]*inInc[2];
+      vtkIdType factZ1 = ids1[2][i]*inInc[2];
+
+      vtkIdType i00 = factY0 + factZ0;
+      vtkIdType i01 = factY0 + factZ1;
+      vtkIdType i10 = factY1 + factZ0;
+      vtkIdType i11 = factY1 + factZ1;
+
+      F fx = fracs[0][i];
+      F fy = fracs[1][i];
+      F fz = fracs[2][i];
+
+      F rx = 1 - fx;
+      F ry = 1 - fy;
+      F rz = 1 - fz;
+
+      F ryrz = ry*rz;
+      F fyrz = fy*rz;
+      F ryfz = ry*fz;
+      F fyfz = fy*fz;
+
+      const T *inPtr0 = inPtr + factX0;
+      const T *inPtr1 = inPtr + factX1;
+
+      int c = numscalars;
+      do
+        {
+        *outPtr++ = (rx*(ryrz*inPtr0[i00] + ryfz*inPtr0[i01] +
+                         fyrz*inPtr0[i10] + fyfz*inPtr0[i11]) +
+                     fx*(ryrz*inPtr1[i00] + ryfz*inPtr1[i01] +
+                         fyrz*inPtr1[i10] + fyfz*inPtr1[i11]));
+        inPtr0++;
+        inPtr1++;
+        }
+      while (--c);
+      }
+    }
+}
+
+//----------------------------------------------------------------------------
+template <class F, class T>
+void vtkImageNLCRowIJKInterpolate<F, T>::Tricubic(
+  vtkInterpolationInfo *info, const F origin[3], const F step[3],
+  int idX, F *outPtr, int n)
+{
+  const T *inPtr = static_cast<const T *>(info->Pointer);
+  int *inExt = info->Extent;
+  vtkIdType *inInc = info->Increments;
+  int numscalars = info->NumberOfComponents;
+
+  // the memory offsets, weights and limits along each axis
+  int ids[VTK_IMAGE_INTERPOLATOR_ROW_BATCH];
+  int tmpIds[VTK_IMAGE_INTERPOLATOR_ROW_BATCH];
+  vtkIdType facts[3][VTK_IMAGE_INTERPOLATOR_ROW_BATCH][4];
+  F weights[3][VTK_IMAGE_INTERPOLATOR_ROW_BATCH][4];
+  int lows[3][VTK_IMAGE_INTERPOLATOR_ROW_BATCH];
+  int highs[3][VTK_IMAGE_INTERPOLATOR_ROW_BATCH];
+
+  for (int i0 = 0; i0 < n; i0 += VTK_IMAGE_INTERPOLATOR_ROW_BATCH)
+    {
+    int m = n - i0;
+    m = (m < VTK_IMAGE_INTERPOLATOR_ROW_BATCH ?
+         m : VTK_IMAGE_INTERPOLATOR_ROW_BATCH);
+    int base = idX + i0;
+
+    for (int j = 0; j < 3; j++)
+      {
+      F o = origin[j];
+      F d = step[j];
+      int minId = inExt[2*j];
+      int maxId = inExt[2*j+1];
+      // check if only one slice in this direction
+      int multiple = (minId != maxId);
+      for (int i = 0; i < m; i++)
+        {
+        F x = o + (base + i)*d;
+        F f;
+        ids[i] = vtkInterpolateFloor(x, f);
+        // if not b-spline, can use an even better rule
+        int multipleI = (multiple & (f != 0));
+        lows[j][i] = 1 - multipleI;
+        highs[j][i] = 1 + 2*multipleI;
+        vtkTricubicInterpWeights(weights[j][i], lows[j][i], highs[j][i], f);
+        }
+      for (int l = 0; l < 4; l++)
+        {
+        for (int i = 0; i < m; i++)
+          {
+          tmpIds[i] = ids[i] - 1 + l;
+          }
+        vtkImageNLCRowIJKBorder(tmpIds, m, minId, maxId, info->BorderMode);
+        for (int i = 0; i < m; i++)
+          {
+          facts[j][i][l] = tmpIds[i]*inInc[j];
+          }
+        }
+      }
+
+    for (int i = 0; i < m; i++)
+      {
+      const vtkIdType *factX = facts[0][i];
+      const vtkIdType *factY = facts[1][i];
+      const vtkIdType *factZ = facts[2][i];
+      const F *fX = weights[0][i];
+      const F *fY = weights[1][i];
+      const F *fZ = weights[2][i];
+      int j1 = lows[1][i];
+      int j2 = highs[1][i];
+      int k1 = lows[2][i];
+      int k2 = highs[2][i];
+
+      const T *inPtr0 = inPtr;
+      int c = numscalars;
+      do // loop over components
+        {
+        F val = 0;
+        int k = k1;
+        do // loop over z
+          {
+          F ifz = fZ[k];
+          vtkIdType factz = factZ[k];
+          int j = j1;
+          do // loop over y
+            {
+            F ify = fY[j];
+            F fzy = ifz*ify;
+            vtkIdType factzy = factz + factY[j];
+            const T *tmpPtr = inPtr0 + factzy;
+            val += fzy*(fX[0]*tmpPtr[factX[0]] +
+                        fX[1]*tmpPtr[factX[1]] +
+                        fX[2]*tmpPtr[factX[2]] +
+                        fX[3]*tmpPtr[factX[3]]);
+            }
+          while (++j <= j2);
+          }
+        while (++k <= k2);
+
+        *outPtr++ = val;
+        inPtr0++;
+        }
+      while (--c);
+      }
+    }
+}
+
+//----------------------------------------------------------------------------
+// Get the row interpolation function for structured coords
+template<class F>
+void vtkImageInterpolatorGetRowIJKInterpolationFunc(
+  void (**interpolate)(vtkInterpolationInfo *, const F [3], const F [3],
+                       int, F *, int),
+  int dataType, int interpolationMode)
+{
+  switch (interpolationMode)
+    {
+    case VTK_NEAREST_INTERPOLATION:
+      switch (dataType)
+        {
+        vtkTemplateAliasMacro(
+          *interpolate =
+            &(vtkImageNLCRowIJKInterpolate<F, VTK_TT>::Nearest)
+          );
+        default:
+          *interpolate = 0;
+        }
+      break;
+    case VTK_LINEAR_INTERPOLATION:
+      switch (dataType)
+        {
+        vtkTemplateAliasMacro(
+          *interpolate =
+            &(vtkImageNLCRowIJKInterpolate<F, VTK_TT>::Trilinear)
+          );
+        default:
+          *interpolate = 0;
+        }
+      break;
+    case VTK_CUBIC_INTERPOLATION:
+      switch (dataType)
+        {
+        vtkTemplateAliasMacro(
+          *interpolate =
+            &(vtkImageNLCRowIJKInterpolate<F, VTK_TT>::Tricubic)
+          );
+        default:
+          *interpolate = 0;
+        }
+      break;
+    }
+}
+
 //----------------------------------------------------------------------------
 // Interpolation for precomputed weights
 
@@ -584,16 +942,27 @@ void vtkImageNLCRowInterpolate<F, T>::Nearest(
   int numscalars = weights->NumberOfComponents;
 
   // This is a hot loop.
-  for (int i = n; i > 0; --i)
+  if (numscalars == 1)
     {
-    const T *tmpPtr = &inPtr0[iX[0]];
-    iX++;
-    int m = numscalars;
-    do
+    // a simple loop over the row, which the compiler can vectorize
+    for (int i = 0; i < n; i++)
       {
-      *outPtr++ = *tmpPtr++;
+      outPtr[i] = inPtr0[iX[i]];
+      }
+    }
+  else
+    {
+    for (int i = n; i > 0; --i)
+      {
+      const T *tmpPtr = &inPtr0[iX[0]];
+      iX++;
+      int m = numscalars;
+      do
+        {
+        *outPtr++ = *tmpPtr++;
+        }
+      while (--m);
       }
-    while (--m);
     }
 }
 
@@ -658,7 +1027,67 @@ void vtkImageNLCRowInterpolate<F, T>::Trilinear(
   F fyrz = fy*rz;
   F fyfz = fy*fz;
 
-  if (stepX == 1)
+  // For one component, the loops over the row are simple enough for the
+  // compiler to vectorize them, and give the same values as the loops for
+  // several components.
+  if (numscalars == 1)
+    {
+    if (stepX == 1)
+      {
+      if (fy == 0 && fz == 0)
+        { // no interpolation needed at all
+        const T *inPtr1 = inPtr + i00;
+        for (int i = 0; i < n; i++)
+          {
+          outPtr[i] = inPtr1[iX[i]];
+          }
+        }
+      else if (fy == 0)
+        { // only need linear z interpolation
+        for (int i = 0; i < n; i++)
+          {
+          const T *inPtr0 = inPtr + iX[i];
+          outPtr[i] = (rz*inPtr0[i00] + fz*inPtr0[i01]);
+          }
+        }
+      else
+        { // interpolate in y and z but not in x
+        for (int i = 0; i < n; i++)
+          {
+          const T *inPtr0 = inPtr + iX[i];
+          outPtr[i] = (ryrz*inPtr0[i00] + ryfz*inPtr0[i01] +
+                       fyrz*inPtr0[i10] + fyfz*inPtr0[i11]);
+          }
+        }
+      }
+    else if (fz == 0)
+      { // bilinear interpolation in x,y
+      for (int i = 0; i < n; i++)
+        {
+        F rx = fX[2*i];
+        F fx = fX[2*i + 1];
+        const T *inPtr0 = inPtr + iX[2*i];
+        const T *inPtr1 = inPtr + iX[2*i + 1];
+        outPtr[i] = (rx*(ry*inPtr0[i00] + fy*inPtr0[i10]) +
+                     fx*(ry*inPtr1[i00] + fy*inPtr1[i10]));
+        }
+      }
+    else
+      { // do full trilinear interpolation
+      for (int i = 0; i < n; i++)
+        {
+        F rx = fX[2*i];
+        F fx = fX[2*i + 1];
+        const T *inPtr0 = inPtr + iX[2*i];
+        const T *inPtr1 = inPtr + iX[2*i + 1];
+        outPtr[i] = (rx*(ryrz*inPtr0[i00] + ryfz*inPtr0[i01] +
+                         fyrz*inPtr0[i10] + fyfz*inPtr0[i11]) +
+                     fx*(ryrz*inPtr1[i00] + ryfz*inPtr1[i01] +
+                         fyrz*inPtr1[i10] + fyfz*inPtr1[i11]));
+        }
+      }
+    }
+  else if (stepX == 1)
     {
     if (fy == 0 && fz == 0)
       { // no interpolation needed at all
@@ -782,6 +1211,51 @@ void vtkImageNLCRowInterpolate<F, T>::Tricubic(
   // get the number of components per pixel
   int numscalars = weights->NumberOfComponents;
 
+  if (stepX == 4)
+    {
+    // Apply the kernel to the whole row one (y,z) term at a time, so that
+    // the loop over the row is simple enough for the compiler to vectorize.
+    // The terms are summed in the same order as below.
+    for (int c = 0; c < numscalars; c++)
+      {
+      F *tmpOutPtr = outPtr + c;
+      for (int i = 0; i < n; i++)
+        {
+        tmpOutPtr[i*numscalars] = 0;
+        }
+
+      int k = 0;
+      do
+        { // loop over z
+        F fz = fZ[k];
+        if (fz != 0)
+          {
+          vtkIdType iz = iZ[k];
+          int j = 0;
+          do
+            { // loop over y
+            F fy = fY[j];
+            F fzy = fz*fy;
+            const T *tmpPtr = inPtr + c + iz + iY[j];
+            for (int i = 0; i < n; i++)
+              { // loop over the row, with the loop over x unrolled
+              const vtkIdType *tmpIX = iX + 4*i;
+              const F *tmpFX = fX + 4*i;
+              tmpOutPtr[i*numscalars] += fzy*(tmpFX[0]*tmpPtr[tmpIX[0]] +
+                                              tmpFX[1]*tmpPtr[tmpIX[1]] +
+                                              tmpFX[2]*tmpPtr[tmpIX[2]] +
+                                              tmpFX[3]*tmpPtr[tmpIX[3]]);
+              }
+            }
+          while (++j < stepY);
+          }
+        }
+      while (++k < stepZ);
+      }
+
+    return;
+    }
+
   for (int i = n; i > 0; --i)
     {
     vtkIdType iX0 = iX[0];
@@ -1117,6 +1591,24 @@ void vtkImageInterpolator::GetRowInterpolationFunc(
     func, this->InterpolationInfo->ScalarType, this->InterpolationMode);
 }
 
+//----------------------------------------------------------------------------
+void vtkImageInterpolator::GetRowIJKInterpolationFunc(
+  void (**func)(vtkInterpolationInfo *, const double [3], const double [3],
+                int, double *, int))
+{
+  vtkImageInterpolatorGetRowIJKInterpolationFunc(
+    func, this->InterpolationInfo->ScalarType, this->InterpolationMode);
+}
+
+//----------------------------------------------------------------------------
+void vtkImageInterpolator::GetRowIJKInterpolationFunc(
+  void (**func)(vtkInterpolationInfo *, const float [3], const float [3],
+                int, float *, int))
+{
+  vtkImageInterpolatorGetRowIJKInterpolationFunc(
+    func, this->InterpolationInfo->ScalarType, this->InterpolationMode);
+}
+
 //----------------------------------------------------------------------------
 void vtkImageInterpolator::PrecomputeWeightsForExtent(
   const double matrix[16], const int extent[6], int newExtent[6],
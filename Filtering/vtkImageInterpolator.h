@@ -110,6 +110,17 @@ protected:
     void (**floatfunc)(
       vtkInterpolationWeights *, int, int, int, float *, int));
 
+  // Description:
+  // Get the functions that interpolate rows of structured coords.
+  virtual void GetRowIJKInterpolationFunc(
+    void (**doublefunc)(
+      vtkInterpolationInfo *, const double [3], const double [3], int,
+      double *, int));
+  virtual void GetRowIJKInterpolationFunc(
+    void (**floatfunc)(
+      vtkInterpolationInfo *, const float [3], const float [3], int,
+      float *, int));
+
   int InterpolationMode;
 
 private:
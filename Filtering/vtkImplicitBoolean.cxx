@@ -14,6 +14,7 @@
 =========================================================================*/
 #include "vtkImplicitBoolean.h"
 
+#include "vtkDoubleArray.h"
 #include "vtkImplicitFunctionCollection.h"
 #include "vtkObjectFactory.h"
 
@@ -146,6 +147,103 @@ double vtkImplicitBoolean::EvaluateFunction(double x[3])
   return value;
 }
 
+// Evaluate boolean combinations of implicit function for each of the points
+// of the input array.
+void vtkImplicitBoolean::EvaluateFunctions(vtkDataArray *input,
+                                           vtkDataArray *output)
+{
+  vtkDoubleArray *values = vtkDoubleArray::SafeDownCast(output);
+  if ( !values )
+    {
+    this->Superclass::EvaluateFunctions(input, output);
+    return;
+    }
+
+  vtkIdType i, numPts = input->GetNumberOfTuples();
+  values->SetNumberOfComponents(1);
+  values->SetNumberOfTuples(numPts);
+  double *value = values->GetPointer(0);
+  vtkImplicitFunction *f;
+
+  if (this->FunctionList->GetNumberOfItems() == 0)
+    {
+    for (i = 0; i < numPts; i++)
+      {
+      value[i] = 0;
+      }
+    return;
+    }
+
+  double initial = 0;
+  if ( this->OperationType == VTK_UNION ||
+       this->OperationType == VTK_UNION_OF_MAGNITUDES )
+    {
+    initial = VTK_DOUBLE_MAX;
+    }
+  else if ( this->OperationType == VTK_INTERSECTION )
+    {
+    initial = -VTK_DOUBLE_MAX;
+    }
+  for (i = 0; i < numPts; i++)
+    {
+    value[i] = initial;
+    }
+
+  vtkDoubleArray *fValues = vtkDoubleArray::New();
+  vtkImplicitFunction *firstF = NULL;
+  vtkCollectionSimpleIterator sit;
+  for (this->FunctionList->InitTraversal(sit); 
+       (f=this->FunctionList->GetNextImplicitFunction(sit)); )
+    {
+    f->FunctionValue(input, fValues);
+    double *v = fValues->GetPointer(0);
+
+    if ( this->OperationType == VTK_UNION )
+      { //take minimum value
+      for (i = 0; i < numPts; i++)
+        {
+        value[i] = (v[i] < value[i] ? v[i] : value[i]);
+        }
+      }
+
+    else if ( this->OperationType == VTK_INTERSECTION )
+      { //take maximum value
+      for (i = 0; i < numPts; i++)
+        {
+        value[i] = (v[i] > value[i] ? v[i] : value[i]);
+        }
+      }
+
+    else if ( this->OperationType == VTK_UNION_OF_MAGNITUDES )
+      { //take minimum absolute value
+      for (i = 0; i < numPts; i++)
+        {
+        double a = fabs(v[i]);
+        value[i] = (a < value[i] ? a : value[i]);
+        }
+      }
+
+    else if ( firstF == NULL ) //difference
+      {
+      firstF = f;
+      for (i = 0; i < numPts; i++)
+        {
+        value[i] = v[i];
+        }
+      }
+
+    else if ( f != firstF )
+      {
+      for (i = 0; i < numPts; i++)
+        {
+        double d = (-1.0)*v[i];
+        value[i] = (d > value[i] ? d : value[i]);
+        }
+      }
+    }
+  fValues->Delete();
+}
+
 // Evaluate gradient of boolean combination.
 void vtkImplicitBoolean::EvaluateGradient(double x[3], double g[3])
 {
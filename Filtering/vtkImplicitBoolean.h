@@ -57,6 +57,12 @@ public:
   double EvaluateFunction(double x, double y, double z)
     {return this->vtkImplicitFunction::EvaluateFunction(x, y, z); } ;
 
+  // Description:
+  // Evaluate boolean combinations of implicit function for each of the
+  // points of the input array.  Each function is evaluated for all of
+  // the points at once, and the values are combined.
+  void EvaluateFunctions(vtkDataArray *input, vtkDataArray *output);
+
   // Description:
   // Evaluate gradient of boolean combination.
   void EvaluateGradient(double x[3], double g[3]);
@@ -13,6 +13,7 @@
 
 =========================================================================*/
 #include "vtkSphere.h"
+#include "vtkDoubleArray.h"
 #include "vtkMath.h"
 #include "vtkObjectFactory.h"
 
@@ -39,6 +40,33 @@ double vtkSphere::EvaluateFunction(double x[3])
            this->Radius*this->Radius );
 }
 
+//----------------------------------------------------------------------------
+// Evaluate sphere equation for each of the points of the input array.
+void vtkSphere::EvaluateFunctions(vtkDataArray *input, vtkDataArray *output)
+{
+  vtkDoubleArray *points = vtkDoubleArray::SafeDownCast(input);
+  vtkDoubleArray *values = vtkDoubleArray::SafeDownCast(output);
+  if ( !points || !values || points->GetNumberOfComponents() != 3 )
+    {
+    this->Superclass::EvaluateFunctions(input, output);
+    return;
+    }
+
+  vtkIdType numPts = points->GetNumberOfTuples();
+  values->SetNumberOfComponents(1);
+  values->SetNumberOfTuples(numPts);
+  const double *x = points->GetPointer(0);
+  double *s = values->GetPointer(0);
+  double r2 = this->Radius*this->Radius;
+
+  for (vtkIdType i = 0; i < numPts; i++, x += 3)
+    {
+    s[i] = ( ((x[0] - this->Center[0]) * (x[0] - this->Center[0]) + 
+              (x[1] - this->Center[1]) * (x[1] - this->Center[1]) + 
+              (x[2] - this->Center[2]) * (x[2] - this->Center[2])) - r2 );
+    }
+}
+
 //----------------------------------------------------------------------------
 // Evaluate sphere gradient.
 void vtkSphere::EvaluateGradient(double x[3], double n[3])
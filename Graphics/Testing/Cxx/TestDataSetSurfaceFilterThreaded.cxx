@@ -0,0 +1,224 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestDataSetSurfaceFilterThreaded.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Checks that the threaded face extraction of vtkDataSetSurfaceFilter gives
+// exactly the same surface as the serial face hash.
+
+#include "vtkCellArray.h"
+#include "vtkCellData.h"
+#include "vtkDataSetSurfaceFilter.h"
+#include "vtkIdTypeArray.h"
+#include "vtkIntArray.h"
+#include "vtkMultiThreader.h"
+#include "vtkPointData.h"
+#include "vtkPoints.h"
+#include "vtkPolyData.h"
+#include "vtkSmartPointer.h"
+#include "vtkUnstructuredGrid.h"
+
+// A grid of cubes split into various cell types. The cells do not always
+// share whole faces with their neighbors, which makes for plenty of
+// visible faces inside the grid as well.
+static vtkSmartPointer<vtkUnstructuredGrid> MakeGrid(int dim)
+{
+  vtkSmartPointer<vtkUnstructuredGrid> grid =
+    vtkSmartPointer<vtkUnstructuredGrid>::New();
+  vtkSmartPointer<vtkPoints> points = vtkSmartPointer<vtkPoints>::New();
+  int i, j, k;
+  for (k = 0; k <= dim; ++k)
+    {
+    for (j = 0; j <= dim; ++j)
+      {
+      for (i = 0; i <= dim; ++i)
+        {
+        points->InsertNextPoint(i, j, k);
+        }
+      }
+    }
+  grid->SetPoints(points);
+  grid->Allocate(6 * dim * dim * dim);
+
+  vtkSmartPointer<vtkIntArray> labels = vtkSmartPointer<vtkIntArray>::New();
+  labels->SetName("labels");
+  vtkIdType n = dim + 1;
+  for (k = 0; k < dim; ++k)
+    {
+    for (j = 0; j < dim; ++j)
+      {
+      for (i = 0; i < dim; ++i)
+        {
+        vtkIdType p0 = i + n * (j + n * k);
+        vtkIdType c[8] = { p0, p0 + 1, p0 + 1 + n, p0 + n,
+                           p0 + n * n, p0 + 1 + n * n, p0 + 1 + n + n * n,
+                           p0 + n + n * n };
+        switch ((i + 2 * j + 3 * k) % 5)
+          {
+          case 0:
+            grid->InsertNextCell(VTK_HEXAHEDRON, 8, c);
+            break;
+          case 1:
+            {
+            vtkIdType v[8] = { c[0], c[1], c[3], c[2],
+                               c[4], c[5], c[7], c[6] };
+            grid->InsertNextCell(VTK_VOXEL, 8, v);
+            }
+            break;
+          case 2:
+            {
+            static const int tets[5][4] = { {0,1,3,4}, {1,2,3,6}, {1,4,5,6},
+                                            {3,4,6,7}, {1,3,4,6} };
+            for (int t = 0; t < 5; ++t)
+              {
+              vtkIdType tet[4] = { c[tets[t][0]], c[tets[t][1]],
+                                   c[tets[t][2]], c[tets[t][3]] };
+              grid->InsertNextCell(VTK_TETRA, 4, tet);
+              }
+            }
+            break;
+          case 3:
+            {
+            vtkIdType w1[6] = { c[0], c[1], c[3], c[4], c[5], c[7] };
+            vtkIdType w2[6] = { c[1], c[2], c[3], c[5], c[6], c[7] };
+            grid->InsertNextCell(VTK_WEDGE, 6, w1);
+            grid->InsertNextCell(VTK_WEDGE, 6, w2);
+            }
+            break;
+          case 4:
+            {
+            vtkIdType pyr[5] = { c[0], c[1], c[2], c[3], c[6] };
+            vtkIdType tet1[4] = { c[0], c[4], c[5], c[6] };
+            vtkIdType tet2[4] = { c[0], c[6], c[7], c[4] };
+            grid->InsertNextCell(VTK_PYRAMID, 5, pyr);
+            grid->InsertNextCell(VTK_TETRA, 4, tet1);
+            grid->InsertNextCell(VTK_TETRA, 4, tet2);
+            }
+            break;
+          }
+        }
+      }
+    }
+
+  // A few lower dimensional cells and a prism sticking out of the grid.
+  vtkIdType line[2] = { 0, n * n * n - 1 };
+  grid->InsertNextCell(VTK_LINE, 2, line);
+  vtkIdType tri[3] = { 0, 1, n };
+  grid->InsertNextCell(VTK_TRIANGLE, 3, tri);
+  vtkIdType vertex = 5;
+  grid->InsertNextCell(VTK_VERTEX, 1, &vertex);
+  vtkIdType prism[10];
+  for (i = 0; i < 5; ++i)
+    {
+    prism[i] = points->InsertNextPoint(-1 - i % 2, i, 0);
+    }
+  for (i = 0; i < 5; ++i)
+    {
+    prism[i + 5] = points->InsertNextPoint(-1 - i % 2, i, -1);
+    }
+  grid->InsertNextCell(VTK_PENTAGONAL_PRISM, 10, prism);
+
+  for (vtkIdType cellId = 0; cellId < grid->GetNumberOfCells(); ++cellId)
+    {
+    labels->InsertNextValue(static_cast<int>(cellId % 7));
+    }
+  grid->GetCellData()->AddArray(labels);
+  return grid;
+}
+
+static int SameArrays(vtkDataArray* a, vtkDataArray* b)
+{
+  if (!a || !b || a->GetNumberOfTuples() != b->GetNumberOfTuples() ||
+      a->GetNumberOfComponents() != b->GetNumberOfComponents())
+    {
+    return 0;
+    }
+  for (vtkIdType t = 0; t < a->GetNumberOfTuples(); ++t)
+    {
+    for (int c = 0; c < a->GetNumberOfComponents(); ++c)
+      {
+      if (a->GetComponent(t, c) != b->GetComponent(t, c))
+        {
+        return 0;
+        }
+      }
+    }
+  return 1;
+}
+
+int TestDataSetSurfaceFilterThreaded(int, char *[])
+{
+  vtkSmartPointer<vtkUnstructuredGrid> grid = MakeGrid(40);
+
+  // Make sure the threaded path is taken even on a single processor.
+  int defaultThreads = vtkMultiThreader::GetGlobalDefaultNumberOfThreads();
+  vtkMultiThreader::SetGlobalDefaultNumberOfThreads(4);
+
+  vtkSmartPointer<vtkPolyData> surfaces[2];
+  for (int threaded = 0; threaded < 2; ++threaded)
+    {
+    vtkSmartPointer<vtkDataSetSurfaceFilter> surface =
+      vtkSmartPointer<vtkDataSetSurfaceFilter>::New();
+    surface->SetInput(grid);
+    surface->PassThroughCellIdsOn();
+    surface->PassThroughPointIdsOn();
+    surface->SetThreadedFaceExtraction(threaded);
+    surface->Update();
+    surfaces[threaded] = surface->GetOutput();
+    }
+
+  vtkMultiThreader::SetGlobalDefaultNumberOfThreads(defaultThreads);
+
+  vtkPolyData* serial = surfaces[0];
+  vtkPolyData* threaded = surfaces[1];
+  cout << serial->GetNumberOfPolys() << " polygons, "
+       << serial->GetNumberOfPoints() << " points" << endl;
+  if (serial->GetNumberOfPolys() == 0)
+    {
+    cerr << "Empty surface" << endl;
+    return EXIT_FAILURE;
+    }
+  if (!SameArrays(serial->GetPoints()->GetData(),
+                  threaded->GetPoints()->GetData()))
+    {
+    cerr << "Points differ" << endl;
+    return EXIT_FAILURE;
+    }
+  if (!SameArrays(serial->GetPolys()->GetData(),
+                  threaded->GetPolys()->GetData()) ||
+      !SameArrays(serial->GetLines()->GetData(),
+                  threaded->GetLines()->GetData()) ||
+      !SameArrays(serial->GetVerts()->GetData(),
+                  threaded->GetVerts()->GetData()))
+    {
+    cerr << "Cells differ" << endl;
+    return EXIT_FAILURE;
+    }
+  const char* cellArrays[2] = { "vtkOriginalCellIds", "labels" };
+  for (int a = 0; a < 2; ++a)
+    {
+    if (!SameArrays(serial->GetCellData()->GetArray(cellArrays[a]),
+                    threaded->GetCellData()->GetArray(cellArrays[a])))
+      {
+      cerr << "Cell data " << cellArrays[a] << " differs" << endl;
+      return EXIT_FAILURE;
+      }
+    }
+  if (!SameArrays(serial->GetPointData()->GetArray("vtkOriginalPointIds"),
+                  threaded->GetPointData()->GetArray("vtkOriginalPointIds")))
+    {
+    cerr << "Original point ids differ" << endl;
+    return EXIT_FAILURE;
+    }
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,222 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestInterpolationBatchFilters.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Runs vtkContourGrid, vtkCutter and vtkProbeFilter, which interpolate their
+// point data in batches, on inputs whose arrays are linear functions of the
+// point coordinates.  Linear interpolation reproduces them, so each output
+// point must carry the values of the functions at its own coordinates.
+
+#include "vtkCellArray.h"
+#include "vtkContourGrid.h"
+#include "vtkCutter.h"
+#include "vtkDataArray.h"
+#include "vtkDoubleArray.h"
+#include "vtkFloatArray.h"
+#include "vtkMath.h"
+#include "vtkMultiThreader.h"
+#include "vtkPlane.h"
+#include "vtkPlaneSource.h"
+#include "vtkPointData.h"
+#include "vtkPoints.h"
+#include "vtkPolyData.h"
+#include "vtkProbeFilter.h"
+#include "vtkSmartPointer.h"
+#include "vtkUnstructuredGrid.h"
+
+#include <math.h>
+
+static void LinearFunctions(const double x[3], double values[5])
+{
+  values[0] = x[0] + 2.0*x[1] - x[2];
+  values[1] = 2.0*x[0];
+  values[2] = x[1] - x[2];
+  values[3] = 3.0*x[2] + 1.0;
+  values[4] = 0.5*x[0] - x[1];
+}
+
+// Adds the arrays "a" (active scalars), "v" and "f" to the points
+static void AddLinearArrays(vtkDataSet *data)
+{
+  vtkIdType n = data->GetNumberOfPoints();
+  vtkSmartPointer<vtkDoubleArray> a = vtkSmartPointer<vtkDoubleArray>::New();
+  a->SetName("a");
+  a->SetNumberOfTuples(n);
+  vtkSmartPointer<vtkDoubleArray> v = vtkSmartPointer<vtkDoubleArray>::New();
+  v->SetName("v");
+  v->SetNumberOfComponents(3);
+  v->SetNumberOfTuples(n);
+  vtkSmartPointer<vtkFloatArray> f = vtkSmartPointer<vtkFloatArray>::New();
+  f->SetName("f");
+  f->SetNumberOfTuples(n);
+  for (vtkIdType i = 0; i < n; i++)
+    {
+    double values[5];
+    LinearFunctions(data->GetPoint(i), values);
+    a->SetValue(i, values[0]);
+    v->SetTuple(i, values + 1);
+    f->SetValue(i, values[4]);
+    }
+  data->GetPointData()->SetScalars(a);
+  data->GetPointData()->AddArray(v);
+  data->GetPointData()->AddArray(f);
+}
+
+static int CheckLinearArrays(vtkDataSet *data, const char *name,
+                             vtkIdType minPoints)
+{
+  vtkIdType n = data->GetNumberOfPoints();
+  vtkDataArray *a = data->GetPointData()->GetArray("a");
+  vtkDataArray *v = data->GetPointData()->GetArray("v");
+  vtkDataArray *f = data->GetPointData()->GetArray("f");
+  if (n < minPoints || !a || !v || !f || a->GetNumberOfTuples() != n ||
+      v->GetNumberOfTuples() != n || f->GetNumberOfTuples() != n)
+    {
+    cerr << name << " produced " << n << " points and incomplete arrays"
+         << endl;
+    return 0;
+    }
+  for (vtkIdType i = 0; i < n; i++)
+    {
+    double values[5];
+    LinearFunctions(data->GetPoint(i), values);
+    double *vec = v->GetTuple3(i);
+    double diff = fabs(a->GetComponent(i, 0) - values[0]);
+    diff += fabs(vec[0] - values[1]);
+    diff += fabs(vec[1] - values[2]);
+    diff += fabs(vec[2] - values[3]);
+    diff += fabs(f->GetComponent(i, 0) - values[4]);
+    if (diff > 1e-3)
+      {
+      cerr << name << " point " << i << " has values that differ by "
+           << diff << " from those at its coordinates" << endl;
+      return 0;
+      }
+    }
+  return 1;
+}
+
+// An unstructured grid of dim^3 points and (dim-1)^3 hexahedra
+static vtkUnstructuredGrid *NewHexahedra(int dim)
+{
+  vtkSmartPointer<vtkPoints> points = vtkSmartPointer<vtkPoints>::New();
+  points->SetDataTypeToDouble();
+  for (int k = 0; k < dim; k++)
+    {
+    for (int j = 0; j < dim; j++)
+      {
+      for (int i = 0; i < dim; i++)
+        {
+        points->InsertNextPoint(i, j, 0.9*k);
+        }
+      }
+    }
+  vtkUnstructuredGrid *grid = vtkUnstructuredGrid::New();
+  grid->SetPoints(points);
+  grid->Allocate((dim-1)*(dim-1)*(dim-1));
+  for (int k = 0; k < dim-1; k++)
+    {
+    for (int j = 0; j < dim-1; j++)
+      {
+      for (int i = 0; i < dim-1; i++)
+        {
+        vtkIdType p = i + dim*(j + dim*k);
+        vtkIdType s = dim*dim;
+        vtkIdType ids[8] = { p, p+1, p+1+dim, p+dim,
+                             p+s, p+1+s, p+1+dim+s, p+dim+s };
+        grid->InsertNextCell(VTK_HEXAHEDRON, 8, ids);
+        }
+      }
+    }
+  AddLinearArrays(grid);
+  return grid;
+}
+
+int TestInterpolationBatchFilters(int, char *[])
+{
+  // the batches below are large enough to be split over the threads
+  int defaultThreads = vtkMultiThreader::GetGlobalDefaultNumberOfThreads();
+  vtkMultiThreader::SetGlobalDefaultNumberOfThreads(4);
+  vtkMath::RandomSeed(4321);
+
+  int status = 1;
+  vtkUnstructuredGrid *grid = NewHexahedra(40);
+
+  vtkSmartPointer<vtkContourGrid> contour =
+    vtkSmartPointer<vtkContourGrid>::New();
+  contour->SetInput(grid);
+  contour->GenerateValues(20, 0.0, 60.0);
+  contour->Update();
+  status &= CheckLinearArrays(contour->GetOutput(), "vtkContourGrid", 50000);
+
+  vtkSmartPointer<vtkPlane> plane = vtkSmartPointer<vtkPlane>::New();
+  plane->SetOrigin(19.5, 19.5, 17.0);
+  plane->SetNormal(0.3, -0.5, 1.0);
+  vtkSmartPointer<vtkCutter> cutter = vtkSmartPointer<vtkCutter>::New();
+  cutter->SetInput(grid);
+  cutter->SetCutFunction(plane);
+  cutter->GenerateValues(15, -14.0, 14.0);
+  cutter->Update();
+  status &= CheckLinearArrays(cutter->GetOutput(), "vtkCutter", 20000);
+
+  // polygons go through the general data set cutter
+  vtkSmartPointer<vtkPlaneSource> planeSource =
+    vtkSmartPointer<vtkPlaneSource>::New();
+  planeSource->SetOrigin(0.0, 0.0, 0.0);
+  planeSource->SetPoint1(30.0, 0.0, 5.0);
+  planeSource->SetPoint2(0.0, 30.0, 10.0);
+  planeSource->SetResolution(200, 200);
+  planeSource->Update();
+  vtkSmartPointer<vtkPolyData> surface = vtkSmartPointer<vtkPolyData>::New();
+  surface->DeepCopy(planeSource->GetOutput());
+  surface->GetPointData()->Initialize();
+  AddLinearArrays(surface);
+  vtkSmartPointer<vtkCutter> surfaceCutter =
+    vtkSmartPointer<vtkCutter>::New();
+  surfaceCutter->SetInput(surface);
+  surfaceCutter->SetCutFunction(plane);
+  surfaceCutter->GenerateValues(15, -14.0, 14.0);
+  surfaceCutter->Update();
+  status &= CheckLinearArrays(surfaceCutter->GetOutput(),
+                              "vtkCutter on polygons", 1000);
+
+  vtkSmartPointer<vtkPoints> probePoints = vtkSmartPointer<vtkPoints>::New();
+  probePoints->SetDataTypeToDouble();
+  for (int i = 0; i < 60000; i++)
+    {
+    probePoints->InsertNextPoint(vtkMath::Random(0.0, 39.0),
+                                 vtkMath::Random(0.0, 39.0),
+                                 vtkMath::Random(0.0, 35.1));
+    }
+  vtkSmartPointer<vtkPolyData> probeInput =
+    vtkSmartPointer<vtkPolyData>::New();
+  probeInput->SetPoints(probePoints);
+  vtkSmartPointer<vtkProbeFilter> probe =
+    vtkSmartPointer<vtkProbeFilter>::New();
+  probe->SetInput(probeInput);
+  probe->SetSource(grid);
+  probe->Update();
+  if (probe->GetValidPoints()->GetNumberOfTuples() != 60000)
+    {
+    cerr << "vtkProbeFilter found only "
+         << probe->GetValidPoints()->GetNumberOfTuples()
+         << " of the points" << endl;
+    status = 0;
+    }
+  status &= CheckLinearArrays(probe->GetOutput(), "vtkProbeFilter", 60000);
+
+  grid->Delete();
+  vtkMultiThreader::SetGlobalDefaultNumberOfThreads(defaultThreads);
+
+  return status ? EXIT_SUCCESS : EXIT_FAILURE;
+}
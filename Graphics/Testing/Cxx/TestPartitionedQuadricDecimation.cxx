@@ -0,0 +1,163 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestPartitionedQuadricDecimation.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Decimates a sphere in pieces and checks that the pieces are stitched
+// together, that the target reduction is reached, and that the result
+// does not depend on the number of threads.
+
+#include "vtkCellArray.h"
+#include "vtkFeatureEdges.h"
+#include "vtkIdTypeArray.h"
+#include "vtkMath.h"
+#include "vtkMultiThreader.h"
+#include "vtkPartitionedQuadricDecimation.h"
+#include "vtkPointData.h"
+#include "vtkPoints.h"
+#include "vtkPolyData.h"
+#include "vtkSmartPointer.h"
+#include "vtkSphereSource.h"
+
+static int CheckOutput(vtkPartitionedQuadricDecimation *decimate,
+                       vtkIdType numInputTris, double radius)
+{
+  vtkPolyData *output = decimate->GetOutput();
+  vtkIdType numTris = output->GetNumberOfPolys();
+  cout << numTris << " triangles left, actual reduction "
+       << decimate->GetActualReduction() << endl;
+  double reduction = 1.0 - static_cast<double>(numTris) / numInputTris;
+  if (numTris == 0 || reduction < decimate->GetTargetReduction() - 0.05 ||
+      fabs(reduction - decimate->GetActualReduction()) > 1e-6)
+    {
+    cerr << "Wrong reduction " << reduction << endl;
+    return 0;
+    }
+
+  // The sphere is closed: the seams must not open.
+  vtkSmartPointer<vtkFeatureEdges> edges =
+    vtkSmartPointer<vtkFeatureEdges>::New();
+  edges->SetInput(output);
+  edges->BoundaryEdgesOn();
+  edges->FeatureEdgesOff();
+  edges->NonManifoldEdgesOn();
+  edges->ManifoldEdgesOff();
+  edges->Update();
+  if (edges->GetOutput()->GetNumberOfLines() != 0)
+    {
+    cerr << edges->GetOutput()->GetNumberOfLines()
+         << " boundary or non-manifold edges" << endl;
+    return 0;
+    }
+
+  double x[3], center[3] = { 0.0, 0.0, 0.0 };
+  for (vtkIdType i = 0; i < output->GetNumberOfPoints(); i++)
+    {
+    output->GetPoint(i, x);
+    double r = sqrt(vtkMath::Distance2BetweenPoints(x, center));
+    if (fabs(r - radius) > 0.02 * radius)
+      {
+      cerr << "Point " << i << " is off the sphere" << endl;
+      return 0;
+      }
+    }
+  return 1;
+}
+
+static int SamePolyData(vtkPolyData *a, vtkPolyData *b)
+{
+  if (a->GetNumberOfPoints() != b->GetNumberOfPoints() ||
+      a->GetNumberOfPolys() != b->GetNumberOfPolys())
+    {
+    return 0;
+    }
+  double x[3], y[3];
+  for (vtkIdType i = 0; i < a->GetNumberOfPoints(); i++)
+    {
+    a->GetPoint(i, x);
+    b->GetPoint(i, y);
+    if (x[0] != y[0] || x[1] != y[1] || x[2] != y[2])
+      {
+      return 0;
+      }
+    }
+  vtkIdTypeArray *ca = a->GetPolys()->GetData();
+  vtkIdTypeArray *cb = b->GetPolys()->GetData();
+  for (vtkIdType i = 0; i < ca->GetNumberOfTuples(); i++)
+    {
+    if (ca->GetValue(i) != cb->GetValue(i))
+      {
+      return 0;
+      }
+    }
+  return 1;
+}
+
+int TestPartitionedQuadricDecimation(int, char *[])
+{
+  const double radius = 2.0;
+  vtkSmartPointer<vtkSphereSource> sphere =
+    vtkSmartPointer<vtkSphereSource>::New();
+  sphere->SetRadius(radius);
+  sphere->SetThetaResolution(240);
+  sphere->SetPhiResolution(120);
+  sphere->Update();
+  vtkIdType numInputTris = sphere->GetOutput()->GetNumberOfPolys();
+
+  int defaultThreads = vtkMultiThreader::GetGlobalDefaultNumberOfThreads();
+  vtkSmartPointer<vtkPolyData> outputs[2];
+  int status = 1;
+  for (int threaded = 0; threaded < 2 && status; threaded++)
+    {
+    vtkMultiThreader::SetGlobalDefaultNumberOfThreads(threaded ? 4 : 1);
+    vtkSmartPointer<vtkPartitionedQuadricDecimation> decimate =
+      vtkSmartPointer<vtkPartitionedQuadricDecimation>::New();
+    decimate->SetInputConnection(sphere->GetOutputPort());
+    decimate->SetTargetReduction(0.9);
+    decimate->SetNumberOfPieces(8);
+    decimate->Update();
+    status = CheckOutput(decimate, numInputTris, radius);
+    outputs[threaded] = decimate->GetOutput();
+    }
+  vtkMultiThreader::SetGlobalDefaultNumberOfThreads(defaultThreads);
+  if (!status)
+    {
+    return EXIT_FAILURE;
+    }
+  if (!SamePolyData(outputs[0], outputs[1]))
+    {
+    cerr << "The output depends on the number of threads" << endl;
+    return EXIT_FAILURE;
+    }
+
+  // With the attribute error metric, the normals are decimated too.
+  vtkSmartPointer<vtkPartitionedQuadricDecimation> decimate =
+    vtkSmartPointer<vtkPartitionedQuadricDecimation>::New();
+  decimate->SetInputConnection(sphere->GetOutputPort());
+  decimate->SetTargetReduction(0.75);
+  decimate->SetNumberOfPieces(4);
+  decimate->AttributeErrorMetricOn();
+  decimate->Update();
+  if (!CheckOutput(decimate, numInputTris, radius))
+    {
+    return EXIT_FAILURE;
+    }
+  vtkDataArray *normals = decimate->GetOutput()->GetPointData()->GetNormals();
+  if (!normals || normals->GetNumberOfTuples() !=
+      decimate->GetOutput()->GetNumberOfPoints())
+    {
+    cerr << "Missing normals" << endl;
+    return EXIT_FAILURE;
+    }
+
+  return EXIT_SUCCESS;
+}
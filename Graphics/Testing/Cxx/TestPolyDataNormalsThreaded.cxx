@@ -0,0 +1,122 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestPolyDataNormalsThreaded.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Checks that the threaded normals, computed when Consistency and Splitting
+// are off, match the normals of the topological traversal on a mesh that
+// is already consistently ordered.
+
+#include "vtkCellData.h"
+#include "vtkDataArray.h"
+#include "vtkMultiThreader.h"
+#include "vtkPointData.h"
+#include "vtkPolyData.h"
+#include "vtkPolyDataNormals.h"
+#include "vtkSmartPointer.h"
+#include "vtkSphereSource.h"
+#include "vtkStripper.h"
+#include "vtkTimerLog.h"
+
+static int SameArrays(vtkDataArray *a, vtkDataArray *b, double sign)
+{
+  if (!a || !b || a->GetNumberOfTuples() != b->GetNumberOfTuples())
+    {
+    return 0;
+    }
+  for (vtkIdType i = 0; i < a->GetNumberOfTuples(); i++)
+    {
+    for (int j = 0; j < 3; j++)
+      {
+      if (a->GetComponent(i, j) != sign * b->GetComponent(i, j))
+        {
+        return 0;
+        }
+      }
+    }
+  return 1;
+}
+
+static vtkSmartPointer<vtkPolyData> Normals(vtkAlgorithmOutput *input,
+                                            int consistency, int flip)
+{
+  vtkSmartPointer<vtkPolyDataNormals> normals =
+    vtkSmartPointer<vtkPolyDataNormals>::New();
+  normals->SetInputConnection(input);
+  normals->SplittingOff();
+  normals->SetConsistency(consistency);
+  normals->SetFlipNormals(flip);
+  normals->ComputeCellNormalsOn();
+  vtkSmartPointer<vtkTimerLog> timer = vtkSmartPointer<vtkTimerLog>::New();
+  timer->StartTimer();
+  normals->Update();
+  timer->StopTimer();
+  cout << (consistency ? "Traversal: " : "Threaded: ")
+       << timer->GetElapsedTime() << " s" << endl;
+  vtkSmartPointer<vtkPolyData> output = vtkSmartPointer<vtkPolyData>::New();
+  output->ShallowCopy(normals->GetOutput());
+  return output;
+}
+
+static int Compare(vtkPolyData *a, vtkPolyData *b, double sign)
+{
+  if (a->GetNumberOfPoints() != b->GetNumberOfPoints() ||
+      a->GetNumberOfPolys() != b->GetNumberOfPolys())
+    {
+    cerr << "Different meshes" << endl;
+    return 0;
+    }
+  if (!SameArrays(a->GetPointData()->GetNormals(),
+                  b->GetPointData()->GetNormals(), sign))
+    {
+    cerr << "Different point normals" << endl;
+    return 0;
+    }
+  if (!SameArrays(a->GetCellData()->GetNormals(),
+                  b->GetCellData()->GetNormals(), 1.0))
+    {
+    cerr << "Different cell normals" << endl;
+    return 0;
+    }
+  return 1;
+}
+
+int TestPolyDataNormalsThreaded(int, char *[])
+{
+  vtkSmartPointer<vtkSphereSource> sphere =
+    vtkSmartPointer<vtkSphereSource>::New();
+  sphere->SetThetaResolution(400);
+  sphere->SetPhiResolution(200);
+
+  vtkSmartPointer<vtkStripper> stripper = vtkSmartPointer<vtkStripper>::New();
+  stripper->SetInputConnection(sphere->GetOutputPort());
+
+  int defaultThreads = vtkMultiThreader::GetGlobalDefaultNumberOfThreads();
+  int status = 1;
+  for (int strips = 0; strips < 2 && status; strips++)
+    {
+    vtkAlgorithmOutput *input =
+      (strips ? stripper->GetOutputPort() : sphere->GetOutputPort());
+    vtkMultiThreader::SetGlobalDefaultNumberOfThreads(1);
+    vtkSmartPointer<vtkPolyData> reference = Normals(input, 1, 0);
+    vtkSmartPointer<vtkPolyData> serial = Normals(input, 0, 0);
+    vtkMultiThreader::SetGlobalDefaultNumberOfThreads(4);
+    vtkSmartPointer<vtkPolyData> threaded = Normals(input, 0, 0);
+    vtkSmartPointer<vtkPolyData> flipped = Normals(input, 0, 1);
+    status = Compare(reference, serial, 1.0) &&
+      Compare(reference, threaded, 1.0) &&
+      Compare(reference, flipped, -1.0);
+    }
+  vtkMultiThreader::SetGlobalDefaultNumberOfThreads(defaultThreads);
+
+  return status ? EXIT_SUCCESS : EXIT_FAILURE;
+}
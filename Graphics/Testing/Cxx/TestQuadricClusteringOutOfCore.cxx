@@ -0,0 +1,185 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestQuadricClusteringOutOfCore.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Clusters a sphere with the dense bins, with the sparse bins, and streamed
+// in pieces with the bin quadrics written to disk, and checks that all of
+// them give the same mesh, and that no file is left in the spill directory.
+
+#include "vtkCellArray.h"
+#include "vtkIdTypeArray.h"
+#include "vtkMath.h"
+#include "vtkMultiThreader.h"
+#include "vtkPoints.h"
+#include "vtkPolyData.h"
+#include "vtkQuadricClustering.h"
+#include "vtkSmartPointer.h"
+#include "vtkSphereSource.h"
+
+#include <vtksys/Directory.hxx>
+#include <vtksys/SystemTools.hxx>
+
+static vtkSmartPointer<vtkPolyData> Cluster(vtkSphereSource *sphere,
+                                            int sparse, vtkIdType maxBins,
+                                            int numDivisions,
+                                            const char *spillDirectory = 0)
+{
+  vtkSmartPointer<vtkQuadricClustering> cluster =
+    vtkSmartPointer<vtkQuadricClustering>::New();
+  cluster->SetInputConnection(sphere->GetOutputPort());
+  cluster->SetDivisionOrigin(0.0, 0.0, 0.0);
+  cluster->SetDivisionSpacing(0.05, 0.05, 0.05);
+  cluster->SetUseSparseBins(sparse);
+  cluster->SetMaximumNumberOfBinsInMemory(maxBins);
+  cluster->SetNumberOfStreamDivisions(numDivisions);
+  cluster->SetSpillDirectory(spillDirectory);
+  cluster->Update();
+  vtkSmartPointer<vtkPolyData> output = vtkSmartPointer<vtkPolyData>::New();
+  output->ShallowCopy(cluster->GetOutput());
+  return output;
+}
+
+static int SamePolyData(vtkPolyData *a, vtkPolyData *b)
+{
+  if (a->GetNumberOfPoints() != b->GetNumberOfPoints() ||
+      a->GetNumberOfPolys() != b->GetNumberOfPolys())
+    {
+    return 0;
+    }
+  double x[3], y[3];
+  for (vtkIdType i = 0; i < a->GetNumberOfPoints(); i++)
+    {
+    a->GetPoint(i, x);
+    b->GetPoint(i, y);
+    if (x[0] != y[0] || x[1] != y[1] || x[2] != y[2])
+      {
+      return 0;
+      }
+    }
+  vtkIdTypeArray *ca = a->GetPolys()->GetData();
+  vtkIdTypeArray *cb = b->GetPolys()->GetData();
+  for (vtkIdType i = 0; i < ca->GetNumberOfTuples(); i++)
+    {
+    if (ca->GetValue(i) != cb->GetValue(i))
+      {
+      return 0;
+      }
+    }
+  return 1;
+}
+
+// The pieces are appended in another order than the whole input, which
+// numbers the output points differently and changes the rounding of the
+// quadric sums: compare the point sets with a tolerance.
+static int SamePoints(vtkPolyData *a, vtkPolyData *b)
+{
+  if (a->GetNumberOfPoints() != b->GetNumberOfPoints() ||
+      a->GetNumberOfPolys() != b->GetNumberOfPolys())
+    {
+    return 0;
+    }
+  double x[3], y[3];
+  for (vtkIdType i = 0; i < a->GetNumberOfPoints(); i++)
+    {
+    a->GetPoint(i, x);
+    double minDist2 = VTK_DOUBLE_MAX;
+    for (vtkIdType j = 0; j < b->GetNumberOfPoints(); j++)
+      {
+      b->GetPoint(j, y);
+      double dist2 = vtkMath::Distance2BetweenPoints(x, y);
+      minDist2 = (dist2 < minDist2 ? dist2 : minDist2);
+      }
+    if (minDist2 > 1e-12)
+      {
+      return 0;
+      }
+    }
+  return 1;
+}
+
+// Number of files left by the filter in a directory
+static int CountSpillFiles(const char *directory)
+{
+  vtksys::Directory dir;
+  dir.Load(directory);
+  int count = 0;
+  for (unsigned long i = 0; i < dir.GetNumberOfFiles(); i++)
+    {
+    count += (vtksys::SystemTools::StringStartsWith(
+                dir.GetFile(i), "vtkQuadricClustering_") ? 1 : 0);
+    }
+  return count;
+}
+
+int TestQuadricClusteringOutOfCore(int, char *[])
+{
+  vtkSmartPointer<vtkSphereSource> sphere =
+    vtkSmartPointer<vtkSphereSource>::New();
+  sphere->SetThetaResolution(400);
+  sphere->SetPhiResolution(200);
+  sphere->Update();
+  vtkIdType numInputTris = sphere->GetOutput()->GetNumberOfPolys();
+
+  int defaultThreads = vtkMultiThreader::GetGlobalDefaultNumberOfThreads();
+  vtkMultiThreader::SetGlobalDefaultNumberOfThreads(1);
+  vtkSmartPointer<vtkPolyData> dense = Cluster(sphere, 0, 0, 1);
+  vtkMultiThreader::SetGlobalDefaultNumberOfThreads(4);
+  vtkSmartPointer<vtkPolyData> sparse = Cluster(sphere, 1, 0, 1);
+  vtkSmartPointer<vtkPolyData> streamed = Cluster(sphere, 1, 500, 8);
+  vtkMultiThreader::SetGlobalDefaultNumberOfThreads(1);
+  vtkSmartPointer<vtkPolyData> serialStreamed = Cluster(sphere, 1, 500, 8);
+  vtkMultiThreader::SetGlobalDefaultNumberOfThreads(defaultThreads);
+  vtksys::SystemTools::MakeDirectory("QuadricClusteringSpill");
+  vtkSmartPointer<vtkPolyData> spilledHere =
+    Cluster(sphere, 1, 500, 8, "QuadricClusteringSpill");
+  int numSpillFiles = CountSpillFiles("QuadricClusteringSpill");
+
+  cout << numInputTris << " triangles clustered to "
+       << dense->GetNumberOfPolys() << endl;
+  if (dense->GetNumberOfPolys() == 0 ||
+      dense->GetNumberOfPolys() >= numInputTris)
+    {
+    cerr << "The sphere was not clustered" << endl;
+    return EXIT_FAILURE;
+    }
+  if (!SamePolyData(dense, sparse))
+    {
+    cerr << "Sparse bins give another output than dense bins" << endl;
+    return EXIT_FAILURE;
+    }
+  if (sphere->GetOutput()->GetNumberOfPolys() >= numInputTris)
+    {
+    cerr << "The input was not streamed" << endl;
+    return EXIT_FAILURE;
+    }
+  if (!SamePoints(dense, streamed))
+    {
+    cerr << "Streamed output differs: " << streamed->GetNumberOfPoints()
+         << " points, " << streamed->GetNumberOfPolys() << " triangles"
+         << endl;
+    return EXIT_FAILURE;
+    }
+  if (!SamePolyData(streamed, serialStreamed))
+    {
+    cerr << "The output depends on the number of threads" << endl;
+    return EXIT_FAILURE;
+    }
+  if (!SamePolyData(serialStreamed, spilledHere) || numSpillFiles != 0)
+    {
+    cerr << "Spilling to a directory gives another output or leaves "
+         << numSpillFiles << " files" << endl;
+    return EXIT_FAILURE;
+    }
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,182 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestSelectEnclosedPointsRayParity.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Checks the ray parity classification of vtkSelectEnclosedPoints, for
+// scattered points and for the rows of image data, against a sphere.
+
+#include "vtkCallbackCommand.h"
+#include "vtkCommand.h"
+#include "vtkDataArray.h"
+#include "vtkImageData.h"
+#include "vtkMath.h"
+#include "vtkMultiThreader.h"
+#include "vtkPointData.h"
+#include "vtkPoints.h"
+#include "vtkPolyData.h"
+#include "vtkSelectEnclosedPoints.h"
+#include "vtkSmartPointer.h"
+#include "vtkSphereSource.h"
+
+static const double Center[3] = { 4.5, 5.5, 5.0 };
+static const double Radius = 2.5;
+
+// The faceted sphere lies between these radii, in which points may be
+// classified either way.
+static int ExpectedInside(const double x[3], int &sure)
+{
+  double r = sqrt(vtkMath::Distance2BetweenPoints(x, Center));
+  sure = (r < Radius - 0.1 || r > Radius + 0.01);
+  return r < Radius;
+}
+
+static int CheckMarks(vtkDataSet *data, int insideOut, const char *what)
+{
+  vtkDataArray *marks = data->GetPointData()->GetArray("SelectedPoints");
+  if (!marks || marks->GetNumberOfTuples() != data->GetNumberOfPoints())
+    {
+    cerr << what << ": missing marks" << endl;
+    return 0;
+    }
+  vtkIdType numInside = 0;
+  double x[3];
+  for (vtkIdType i = 0; i < data->GetNumberOfPoints(); ++i)
+    {
+    data->GetPoint(i, x);
+    int sure;
+    int inside = ExpectedInside(x, sure);
+    int mark = static_cast<int>(marks->GetComponent(i, 0));
+    if (sure && mark != (insideOut ? !inside : inside))
+      {
+      cerr << what << ": wrong mark for point " << x[0] << " " << x[1]
+           << " " << x[2] << endl;
+      return 0;
+      }
+    numInside += (mark != insideOut);
+    }
+  cout << what << ": " << numInside << " of " << data->GetNumberOfPoints()
+       << " points inside" << endl;
+  return numInside > 0;
+}
+
+// Count the progress events of a filter.
+static void CountProgress(vtkObject *, unsigned long, void *clientData,
+                          void *)
+{
+  ++*static_cast<int*>(clientData);
+}
+
+int TestSelectEnclosedPointsRayParity(int, char *[])
+{
+  vtkSmartPointer<vtkSphereSource> sphere =
+    vtkSmartPointer<vtkSphereSource>::New();
+  sphere->SetPhiResolution(25);
+  sphere->SetThetaResolution(38);
+  sphere->SetCenter(Center[0], Center[1], Center[2]);
+  sphere->SetRadius(Radius);
+
+  // Make sure several threads are used even on a single processor.
+  int defaultThreads = vtkMultiThreader::GetGlobalDefaultNumberOfThreads();
+  vtkMultiThreader::SetGlobalDefaultNumberOfThreads(4);
+
+  // Scattered points. Seen from the center of the sphere, the x axis runs
+  // through a vertex, which needs a second ray direction.
+  vtkMath::RandomSeed(1177);
+  vtkSmartPointer<vtkPoints> points = vtkSmartPointer<vtkPoints>::New();
+  for (int i = 0; i < 20000; ++i)
+    {
+    points->InsertNextPoint(vtkMath::Random(1.0, 8.0),
+                            vtkMath::Random(2.0, 9.0),
+                            vtkMath::Random(1.5, 8.5));
+    }
+  points->SetPoint(0, Center[0], Center[1], Center[2]);
+  vtkSmartPointer<vtkPolyData> cloud = vtkSmartPointer<vtkPolyData>::New();
+  cloud->SetPoints(points);
+
+  int status = 1;
+  for (int insideOut = 0; insideOut < 2; ++insideOut)
+    {
+    vtkSmartPointer<vtkSelectEnclosedPoints> select =
+      vtkSmartPointer<vtkSelectEnclosedPoints>::New();
+    select->SetInput(cloud);
+    select->SetSurfaceConnection(sphere->GetOutputPort());
+    select->SetInsideOut(insideOut);
+    select->UseRayParityOn();
+    select->Update();
+    status = status && CheckMarks(select->GetOutput(), insideOut, "points");
+    }
+
+  // Image data, classified row by row. Some rows run along the equator,
+  // through the vertices of the sphere.
+  vtkSmartPointer<vtkImageData> image = vtkSmartPointer<vtkImageData>::New();
+  image->SetDimensions(61, 57, 50);
+  image->SetOrigin(1.5, 2.5, 2.0);
+  image->SetSpacing(0.1, 0.125, 0.125);
+  vtkSmartPointer<vtkSelectEnclosedPoints> select =
+    vtkSmartPointer<vtkSelectEnclosedPoints>::New();
+  select->SetInput(image);
+  select->SetSurfaceConnection(sphere->GetOutputPort());
+  select->UseRayParityOn();
+  int numProgressEvents = 0;
+  vtkSmartPointer<vtkCallbackCommand> progress =
+    vtkSmartPointer<vtkCallbackCommand>::New();
+  progress->SetCallback(CountProgress);
+  progress->SetClientData(&numProgressEvents);
+  select->AddObserver(vtkCommand::ProgressEvent, progress);
+  select->Update();
+  status = status && CheckMarks(select->GetOutput(), 0, "image");
+  // Besides the events at the start and the end of the execution, the rows
+  // report their progress.
+  if (numProgressEvents <= 2)
+    {
+    cerr << "Only " << numProgressEvents << " progress events" << endl;
+    status = 0;
+    }
+
+  // The same points, with an extent that does not start at 0.
+  vtkSmartPointer<vtkImageData> shifted =
+    vtkSmartPointer<vtkImageData>::New();
+  shifted->SetExtent(-30, 30, -28, 28, -25, 24);
+  shifted->SetWholeExtent(-30, 30, -28, 28, -25, 24);
+  shifted->SetOrigin(4.5, 6.0, 5.125);
+  shifted->SetSpacing(0.1, 0.125, 0.125);
+  vtkSmartPointer<vtkSelectEnclosedPoints> selectShifted =
+    vtkSmartPointer<vtkSelectEnclosedPoints>::New();
+  selectShifted->SetInput(shifted);
+  selectShifted->SetSurfaceConnection(sphere->GetOutputPort());
+  selectShifted->UseRayParityOn();
+  selectShifted->Update();
+  status = status &&
+    CheckMarks(selectShifted->GetOutput(), 0, "shifted image");
+
+  vtkMultiThreader::SetGlobalDefaultNumberOfThreads(defaultThreads);
+
+  // The backdoor gives the same answers.
+  sphere->Update();
+  select->Initialize(sphere->GetOutput());
+  double x[3];
+  for (int i = 0; i < 1000 && status; ++i)
+    {
+    points->GetPoint(i, x);
+    int sure;
+    int inside = ExpectedInside(x, sure);
+    if (sure && select->IsInsideSurface(x) != inside)
+      {
+      cerr << "IsInsideSurface() is wrong" << endl;
+      status = 0;
+      }
+    }
+  select->Complete();
+
+  return status ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,141 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestSmoothPolyDataThreaded.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Smooths a noisy plane with vtkSmoothPolyDataFilter and
+// vtkWindowedSincPolyDataFilter on one and several threads, and checks that
+// the noise is reduced and that the results do not depend on the number of
+// threads.
+
+#include "vtkDoubleArray.h"
+#include "vtkMath.h"
+#include "vtkMultiThreader.h"
+#include "vtkPlaneSource.h"
+#include "vtkPoints.h"
+#include "vtkPolyData.h"
+#include "vtkSmartPointer.h"
+#include "vtkSmoothPolyDataFilter.h"
+#include "vtkWindowedSincPolyDataFilter.h"
+
+static double Roughness(vtkPolyData *pd)
+{
+  double x[3], sum = 0.0;
+  for (vtkIdType i = 0; i < pd->GetNumberOfPoints(); i++)
+    {
+    pd->GetPoint(i, x);
+    sum += x[2] * x[2];
+    }
+  return sqrt(sum / pd->GetNumberOfPoints());
+}
+
+static int SamePoints(vtkPolyData *a, vtkPolyData *b)
+{
+  if (a->GetNumberOfPoints() != b->GetNumberOfPoints())
+    {
+    return 0;
+    }
+  double x[3], y[3];
+  for (vtkIdType i = 0; i < a->GetNumberOfPoints(); i++)
+    {
+    a->GetPoint(i, x);
+    b->GetPoint(i, y);
+    if (x[0] != y[0] || x[1] != y[1] || x[2] != y[2])
+      {
+      return 0;
+      }
+    }
+  return 1;
+}
+
+static vtkSmartPointer<vtkPolyData> Smooth(vtkPolyData *input, int sinc,
+                                           int threads)
+{
+  vtkMultiThreader::SetGlobalDefaultNumberOfThreads(threads);
+  vtkSmartPointer<vtkPolyDataAlgorithm> filter;
+  if (sinc)
+    {
+    vtkSmartPointer<vtkWindowedSincPolyDataFilter> windowedSinc =
+      vtkSmartPointer<vtkWindowedSincPolyDataFilter>::New();
+    windowedSinc->SetNumberOfIterations(15);
+    filter = windowedSinc;
+    }
+  else
+    {
+    vtkSmartPointer<vtkSmoothPolyDataFilter> smooth =
+      vtkSmartPointer<vtkSmoothPolyDataFilter>::New();
+    smooth->SetNumberOfIterations(30);
+    smooth->SetRelaxationFactor(0.1);
+    smooth->SimultaneousUpdateOn();
+    filter = smooth;
+    }
+  filter->SetInput(input);
+  filter->Update();
+  vtkSmartPointer<vtkPolyData> output = vtkSmartPointer<vtkPolyData>::New();
+  output->ShallowCopy(filter->GetOutput());
+  return output;
+}
+
+int TestSmoothPolyDataThreaded(int, char *[])
+{
+  vtkSmartPointer<vtkPlaneSource> plane =
+    vtkSmartPointer<vtkPlaneSource>::New();
+  plane->SetResolution(300, 300);
+  plane->Update();
+
+  // Add noise along the normal of the plane, in double precision.
+  vtkSmartPointer<vtkPoints> points = vtkSmartPointer<vtkPoints>::New();
+  points->SetDataTypeToDouble();
+  points->DeepCopy(plane->GetOutput()->GetPoints());
+  vtkMath::RandomSeed(8775070);
+  double x[3];
+  for (vtkIdType i = 0; i < points->GetNumberOfPoints(); i++)
+    {
+    points->GetPoint(i, x);
+    x[2] = vtkMath::Random(-0.002, 0.002);
+    points->SetPoint(i, x);
+    }
+  vtkSmartPointer<vtkPolyData> noisy = vtkSmartPointer<vtkPolyData>::New();
+  noisy->CopyStructure(plane->GetOutput());
+  noisy->SetPoints(points);
+  double noise = Roughness(noisy);
+
+  int defaultThreads = vtkMultiThreader::GetGlobalDefaultNumberOfThreads();
+  int status = 1;
+  for (int sinc = 0; sinc < 2 && status; sinc++)
+    {
+    const char *name = (sinc ? "vtkWindowedSincPolyDataFilter" :
+                        "vtkSmoothPolyDataFilter");
+    vtkSmartPointer<vtkPolyData> serial = Smooth(noisy, sinc, 1);
+    vtkSmartPointer<vtkPolyData> threaded = Smooth(noisy, sinc, 4);
+    double roughness = Roughness(threaded);
+    cout << name << ": roughness " << noise << " -> " << roughness << endl;
+    if (threaded->GetPoints()->GetDataType() != VTK_DOUBLE)
+      {
+      cerr << name << " did not keep double precision points" << endl;
+      status = 0;
+      }
+    else if (roughness > 0.5 * noise)
+      {
+      cerr << name << " did not smooth the plane" << endl;
+      status = 0;
+      }
+    else if (!SamePoints(serial, threaded))
+      {
+      cerr << name << " depends on the number of threads" << endl;
+      status = 0;
+      }
+    }
+  vtkMultiThreader::SetGlobalDefaultNumberOfThreads(defaultThreads);
+
+  return status ? EXIT_SUCCESS : EXIT_FAILURE;
+}
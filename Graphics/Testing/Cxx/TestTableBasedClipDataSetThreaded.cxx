@@ -0,0 +1,213 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestTableBasedClipDataSetThreaded.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Clips an image, a structured grid, an unstructured grid and a polydata
+// with vtkTableBasedClipDataSet on one and several threads, and checks that
+// the outputs are identical and lie on the kept side of the clip surface.
+
+#include "vtkAppendFilter.h"
+#include "vtkCellArray.h"
+#include "vtkCellData.h"
+#include "vtkDataArray.h"
+#include "vtkIdTypeArray.h"
+#include "vtkImageData.h"
+#include "vtkMultiThreader.h"
+#include "vtkPointData.h"
+#include "vtkPoints.h"
+#include "vtkSmartPointer.h"
+#include "vtkSphere.h"
+#include "vtkSphereSource.h"
+#include "vtkStructuredGrid.h"
+#include "vtkTableBasedClipDataSet.h"
+#include "vtkUnstructuredGrid.h"
+
+static vtkSmartPointer<vtkUnstructuredGrid> Clip(vtkDataSet *input,
+                                                 int threads, int scalars)
+{
+  vtkMultiThreader::SetGlobalDefaultNumberOfThreads(threads);
+  vtkSmartPointer<vtkTableBasedClipDataSet> clip =
+    vtkSmartPointer<vtkTableBasedClipDataSet>::New();
+  clip->SetInput(input);
+  if (scalars)
+    {
+    clip->SetValue(0.0);
+    }
+  else
+    {
+    vtkSmartPointer<vtkSphere> sphere = vtkSmartPointer<vtkSphere>::New();
+    sphere->SetCenter(0.1, 0.2, 0.3);
+    sphere->SetRadius(0.7);
+    clip->SetClipFunction(sphere);
+    clip->InsideOutOn();
+    }
+  clip->Update();
+  vtkSmartPointer<vtkUnstructuredGrid> output =
+    vtkSmartPointer<vtkUnstructuredGrid>::New();
+  output->ShallowCopy(clip->GetOutput());
+  return output;
+}
+
+static int SameArrays(vtkDataArray *a, vtkDataArray *b)
+{
+  if (!a || !b || a->GetNumberOfTuples() != b->GetNumberOfTuples() ||
+      a->GetNumberOfComponents() != b->GetNumberOfComponents())
+    {
+    return 0;
+    }
+  for (vtkIdType i = 0; i < a->GetNumberOfTuples(); i++)
+    {
+    for (int j = 0; j < a->GetNumberOfComponents(); j++)
+      {
+      if (a->GetComponent(i, j) != b->GetComponent(i, j))
+        {
+        return 0;
+        }
+      }
+    }
+  return 1;
+}
+
+static int SameGrids(vtkUnstructuredGrid *a, vtkUnstructuredGrid *b)
+{
+  if (a->GetNumberOfPoints() != b->GetNumberOfPoints() ||
+      a->GetNumberOfCells() != b->GetNumberOfCells())
+    {
+    return 0;
+    }
+  for (vtkIdType i = 0; i < a->GetNumberOfCells(); i++)
+    {
+    if (a->GetCellType(i) != b->GetCellType(i))
+      {
+      return 0;
+      }
+    }
+  return SameArrays(a->GetPoints()->GetData(), b->GetPoints()->GetData()) &&
+    SameArrays(a->GetCells()->GetData(), b->GetCells()->GetData()) &&
+    SameArrays(a->GetPointData()->GetScalars(),
+               b->GetPointData()->GetScalars()) &&
+    SameArrays(a->GetCellData()->GetArray("cellIds"),
+               b->GetCellData()->GetArray("cellIds"));
+}
+
+static int Check(const char *name, vtkDataSet *input, int scalars)
+{
+  vtkSmartPointer<vtkUnstructuredGrid> serial = Clip(input, 1, scalars);
+  vtkSmartPointer<vtkUnstructuredGrid> threaded = Clip(input, 4, scalars);
+  cout << name << ": " << input->GetNumberOfCells() << " cells clipped to "
+       << threaded->GetNumberOfCells() << endl;
+  if (threaded->GetNumberOfCells() == 0 ||
+      threaded->GetNumberOfCells() >= input->GetNumberOfCells())
+    {
+    cerr << name << " was not clipped" << endl;
+    return 0;
+    }
+  if (!SameGrids(serial, threaded))
+    {
+    cerr << name << " depends on the number of threads" << endl;
+    return 0;
+    }
+
+  // The points are inside the sphere, or have non negative scalars.
+  vtkSmartPointer<vtkSphere> sphere = vtkSmartPointer<vtkSphere>::New();
+  sphere->SetCenter(0.1, 0.2, 0.3);
+  sphere->SetRadius(0.7);
+  vtkDataArray *values = threaded->GetPointData()->GetScalars();
+  for (vtkIdType i = 0; i < threaded->GetNumberOfPoints(); i++)
+    {
+    double value = (scalars ? values->GetComponent(i, 0) :
+                    -sphere->EvaluateFunction(threaded->GetPoint(i)));
+    if (value < -1e-6)
+      {
+      cerr << name << " kept point " << i << " on the wrong side" << endl;
+      return 0;
+      }
+    }
+  return 1;
+}
+
+static void AddArrays(vtkDataSet *data)
+{
+  vtkSmartPointer<vtkSphere> sphere = vtkSmartPointer<vtkSphere>::New();
+  sphere->SetCenter(0.2, 0.0, 0.0);
+  sphere->SetRadius(0.5);
+  vtkSmartPointer<vtkDataArray> scalars;
+  scalars.TakeReference(vtkDataArray::CreateDataArray(VTK_FLOAT));
+  scalars->SetNumberOfTuples(data->GetNumberOfPoints());
+  for (vtkIdType i = 0; i < data->GetNumberOfPoints(); i++)
+    {
+    scalars->SetTuple1(i, sphere->EvaluateFunction(data->GetPoint(i)));
+    }
+  data->GetPointData()->SetScalars(scalars);
+
+  vtkSmartPointer<vtkIdTypeArray> cellIds =
+    vtkSmartPointer<vtkIdTypeArray>::New();
+  cellIds->SetName("cellIds");
+  cellIds->SetNumberOfTuples(data->GetNumberOfCells());
+  for (vtkIdType i = 0; i < data->GetNumberOfCells(); i++)
+    {
+    cellIds->SetValue(i, i);
+    }
+  data->GetCellData()->AddArray(cellIds);
+}
+
+int TestTableBasedClipDataSetThreaded(int, char *[])
+{
+  vtkSmartPointer<vtkImageData> image = vtkSmartPointer<vtkImageData>::New();
+  image->SetDimensions(61, 61, 61);
+  image->SetOrigin(-1.0, -1.0, -1.0);
+  image->SetSpacing(2.0 / 60, 2.0 / 60, 2.0 / 60);
+  AddArrays(image);
+
+  vtkSmartPointer<vtkPoints> points = vtkSmartPointer<vtkPoints>::New();
+  points->SetNumberOfPoints(image->GetNumberOfPoints());
+  for (vtkIdType i = 0; i < image->GetNumberOfPoints(); i++)
+    {
+    double x[3];
+    image->GetPoint(i, x);
+    x[0] += 0.1 * x[1] * x[2];
+    points->SetPoint(i, x);
+    }
+  vtkSmartPointer<vtkStructuredGrid> sgrid =
+    vtkSmartPointer<vtkStructuredGrid>::New();
+  sgrid->SetDimensions(image->GetDimensions());
+  sgrid->SetPoints(points);
+  AddArrays(sgrid);
+
+  vtkSmartPointer<vtkAppendFilter> append =
+    vtkSmartPointer<vtkAppendFilter>::New();
+  append->AddInput(sgrid);
+  append->Update();
+  vtkUnstructuredGrid *ugrid = append->GetOutput();
+
+  vtkSmartPointer<vtkSphereSource> source =
+    vtkSmartPointer<vtkSphereSource>::New();
+  source->SetThetaResolution(400);
+  source->SetPhiResolution(200);
+  source->Update();
+  vtkPolyData *polyData = source->GetOutput();
+  AddArrays(polyData);
+
+  int defaultThreads = vtkMultiThreader::GetGlobalDefaultNumberOfThreads();
+  int status = 1;
+  for (int scalars = 0; scalars < 2 && status; scalars++)
+    {
+    status = Check("vtkImageData", image, scalars) &&
+      Check("vtkStructuredGrid", sgrid, scalars) &&
+      Check("vtkUnstructuredGrid", ugrid, scalars) &&
+      Check("vtkPolyData", polyData, scalars);
+    }
+  vtkMultiThreader::SetGlobalDefaultNumberOfThreads(defaultThreads);
+
+  return status ? EXIT_SUCCESS : EXIT_FAILURE;
+}
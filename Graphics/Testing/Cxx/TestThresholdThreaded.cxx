@@ -0,0 +1,302 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestThresholdThreaded.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Thresholds an image and extracts cells from it and from an unstructured
+// grid with one and several threads. Each output cell is checked against
+// the input cell it comes from, and the outputs must not depend on the
+// number of threads.
+
+#include "vtkCellArray.h"
+#include "vtkCellData.h"
+#include "vtkDoubleArray.h"
+#include "vtkExtractCells.h"
+#include "vtkIdList.h"
+#include "vtkIdTypeArray.h"
+#include "vtkImageData.h"
+#include "vtkMultiThreader.h"
+#include "vtkPointData.h"
+#include "vtkPoints.h"
+#include "vtkSmartPointer.h"
+#include "vtkThreshold.h"
+#include "vtkUnstructuredGrid.h"
+
+#include <math.h>
+
+// The output cells must have the type, point coordinates and data of the
+// input cells whose ids are in "CellId", and the points must keep the
+// order of the input points.
+static int CheckExtraction(vtkDataSet *input, vtkUnstructuredGrid *output)
+{
+  vtkIdTypeArray *cellIds = vtkIdTypeArray::SafeDownCast(
+    output->GetCellData()->GetArray("CellId"));
+  vtkIdTypeArray *pointIds = vtkIdTypeArray::SafeDownCast(
+    output->GetPointData()->GetArray("PointId"));
+  vtkDataArray *inScalars = input->GetPointData()->GetScalars();
+  vtkDataArray *outScalars = output->GetPointData()->GetScalars();
+  if (!cellIds || !pointIds || !outScalars ||
+      cellIds->GetNumberOfTuples() != output->GetNumberOfCells() ||
+      pointIds->GetNumberOfTuples() != output->GetNumberOfPoints())
+    {
+    cerr << "Missing data arrays" << endl;
+    return 0;
+    }
+  for (vtkIdType i = 1; i < output->GetNumberOfPoints(); i++)
+    {
+    if (pointIds->GetValue(i) <= pointIds->GetValue(i - 1))
+      {
+      cerr << "Points out of order" << endl;
+      return 0;
+      }
+    }
+
+  vtkSmartPointer<vtkIdList> inPts = vtkSmartPointer<vtkIdList>::New();
+  vtkSmartPointer<vtkIdList> outPts = vtkSmartPointer<vtkIdList>::New();
+  double x[3], y[3];
+  for (vtkIdType i = 0; i < output->GetNumberOfCells(); i++)
+    {
+    vtkIdType cellId = cellIds->GetValue(i);
+    input->GetCellPoints(cellId, inPts);
+    output->GetCellPoints(i, outPts);
+    if (input->GetCellType(cellId) != output->GetCellType(i) ||
+        inPts->GetNumberOfIds() != outPts->GetNumberOfIds())
+      {
+      cerr << "Wrong cell " << i << endl;
+      return 0;
+      }
+    for (vtkIdType j = 0; j < inPts->GetNumberOfIds(); j++)
+      {
+      vtkIdType inPt = inPts->GetId(j);
+      vtkIdType outPt = outPts->GetId(j);
+      input->GetPoint(inPt, x);
+      output->GetPoint(outPt, y);
+      if (x[0] != y[0] || x[1] != y[1] || x[2] != y[2] ||
+          pointIds->GetValue(outPt) != inPt ||
+          inScalars->GetComponent(inPt, 0) != outScalars->GetComponent(outPt, 0))
+        {
+        cerr << "Wrong point " << j << " in cell " << i << endl;
+        return 0;
+        }
+      }
+    }
+  return 1;
+}
+
+static int SameGrids(vtkUnstructuredGrid *a, vtkUnstructuredGrid *b)
+{
+  if (a->GetNumberOfPoints() != b->GetNumberOfPoints() ||
+      a->GetNumberOfCells() != b->GetNumberOfCells())
+    {
+    return 0;
+    }
+  double x[3], y[3];
+  for (vtkIdType i = 0; i < a->GetNumberOfPoints(); i++)
+    {
+    a->GetPoint(i, x);
+    b->GetPoint(i, y);
+    if (x[0] != y[0] || x[1] != y[1] || x[2] != y[2])
+      {
+      return 0;
+      }
+    }
+  vtkIdTypeArray *ca = a->GetCells()->GetData();
+  vtkIdTypeArray *cb = b->GetCells()->GetData();
+  for (vtkIdType i = 0; i < ca->GetNumberOfTuples(); i++)
+    {
+    if (ca->GetValue(i) != cb->GetValue(i))
+      {
+      return 0;
+      }
+    }
+  return 1;
+}
+
+static vtkSmartPointer<vtkUnstructuredGrid> Threshold(vtkDataSet *input,
+                                                      int allScalars)
+{
+  vtkSmartPointer<vtkThreshold> threshold =
+    vtkSmartPointer<vtkThreshold>::New();
+  threshold->SetInput(input);
+  threshold->ThresholdByUpper(0.5);
+  threshold->SetAllScalars(allScalars);
+  threshold->Update();
+  vtkSmartPointer<vtkUnstructuredGrid> output =
+    vtkSmartPointer<vtkUnstructuredGrid>::New();
+  output->ShallowCopy(threshold->GetOutput());
+  return output;
+}
+
+static vtkSmartPointer<vtkUnstructuredGrid> Extract(vtkDataSet *input)
+{
+  vtkSmartPointer<vtkExtractCells> extract =
+    vtkSmartPointer<vtkExtractCells>::New();
+  extract->SetInput(input);
+  // Every third cell, and ids past the last cell which are skipped.
+  for (vtkIdType i = 0; i < input->GetNumberOfCells() + 10; i += 3)
+    {
+    extract->AddCellRange(i, i);
+    }
+  extract->Update();
+  vtkSmartPointer<vtkUnstructuredGrid> output =
+    vtkSmartPointer<vtkUnstructuredGrid>::New();
+  output->ShallowCopy(extract->GetOutput());
+  return output;
+}
+
+int TestThresholdThreaded(int, char *[])
+{
+  // A 60x60x60 voxel image with a smooth point scalar field.
+  vtkSmartPointer<vtkImageData> image = vtkSmartPointer<vtkImageData>::New();
+  image->SetDimensions(61, 61, 61);
+  vtkIdType numPts = image->GetNumberOfPoints();
+  vtkSmartPointer<vtkDoubleArray> scalars =
+    vtkSmartPointer<vtkDoubleArray>::New();
+  scalars->SetNumberOfTuples(numPts);
+  vtkSmartPointer<vtkIdTypeArray> pointIds =
+    vtkSmartPointer<vtkIdTypeArray>::New();
+  pointIds->SetName("PointId");
+  pointIds->SetNumberOfTuples(numPts);
+  double x[3];
+  for (vtkIdType i = 0; i < numPts; i++)
+    {
+    image->GetPoint(i, x);
+    scalars->SetValue(i, 0.5 + 0.5 * sin(0.2 * x[0]) * cos(0.15 * x[1]) *
+                      sin(0.1 * x[2] + 0.3));
+    pointIds->SetValue(i, i);
+    }
+  image->GetPointData()->SetScalars(scalars);
+  image->GetPointData()->AddArray(pointIds);
+  vtkSmartPointer<vtkIdTypeArray> cellIds =
+    vtkSmartPointer<vtkIdTypeArray>::New();
+  cellIds->SetName("CellId");
+  cellIds->SetNumberOfTuples(image->GetNumberOfCells());
+  for (vtkIdType i = 0; i < image->GetNumberOfCells(); i++)
+    {
+    cellIds->SetValue(i, i);
+    }
+  image->GetCellData()->AddArray(cellIds);
+
+  // Count the voxels that satisfy the criterion.
+  vtkIdType expected[2] = { 0, 0 };
+  vtkSmartPointer<vtkIdList> ptIds = vtkSmartPointer<vtkIdList>::New();
+  for (vtkIdType i = 0; i < image->GetNumberOfCells(); i++)
+    {
+    image->GetCellPoints(i, ptIds);
+    int all = 1, any = 0;
+    for (vtkIdType j = 0; j < ptIds->GetNumberOfIds(); j++)
+      {
+      int in = (scalars->GetValue(ptIds->GetId(j)) >= 0.5);
+      all = all && in;
+      any = any || in;
+      }
+    expected[0] += any;
+    expected[1] += all;
+    }
+
+  int defaultThreads = vtkMultiThreader::GetGlobalDefaultNumberOfThreads();
+  int status = 1;
+  for (int allScalars = 0; allScalars < 2 && status; allScalars++)
+    {
+    vtkMultiThreader::SetGlobalDefaultNumberOfThreads(1);
+    vtkSmartPointer<vtkUnstructuredGrid> serial = Threshold(image, allScalars);
+    vtkMultiThreader::SetGlobalDefaultNumberOfThreads(4);
+    vtkSmartPointer<vtkUnstructuredGrid> threaded =
+      Threshold(image, allScalars);
+    cout << "vtkThreshold: " << threaded->GetNumberOfCells() << " of "
+         << image->GetNumberOfCells() << " cells" << endl;
+    if (threaded->GetNumberOfCells() != expected[allScalars])
+      {
+      cerr << "vtkThreshold kept " << threaded->GetNumberOfCells()
+           << " cells instead of " << expected[allScalars] << endl;
+      status = 0;
+      }
+    else if (threaded->GetPoints()->GetDataType() != VTK_FLOAT)
+      {
+      cerr << "vtkThreshold did not honor PointsDataType" << endl;
+      status = 0;
+      }
+    else if (!CheckExtraction(image, threaded))
+      {
+      status = 0;
+      }
+    else if (!SameGrids(serial, threaded))
+      {
+      cerr << "vtkThreshold depends on the number of threads" << endl;
+      status = 0;
+      }
+    }
+
+  // Extract cells from the image and from an unstructured grid with double
+  // precision points.
+  vtkMultiThreader::SetGlobalDefaultNumberOfThreads(1);
+  vtkSmartPointer<vtkUnstructuredGrid> ugrid = Threshold(image, 0);
+  vtkSmartPointer<vtkPoints> points = vtkSmartPointer<vtkPoints>::New();
+  points->SetDataTypeToDouble();
+  points->DeepCopy(ugrid->GetPoints());
+  ugrid->SetPoints(points);
+  for (int i = 0; i < 2 && status; i++)
+    {
+    vtkDataSet *input = (i ? static_cast<vtkDataSet*>(ugrid) :
+                         static_cast<vtkDataSet*>(image));
+    vtkMultiThreader::SetGlobalDefaultNumberOfThreads(1);
+    vtkSmartPointer<vtkUnstructuredGrid> serial = Extract(input);
+    vtkMultiThreader::SetGlobalDefaultNumberOfThreads(4);
+    vtkSmartPointer<vtkUnstructuredGrid> threaded = Extract(input);
+    vtkIdTypeArray *origIds = vtkIdTypeArray::SafeDownCast(
+      threaded->GetCellData()->GetArray("vtkOriginalCellIds"));
+    vtkIdTypeArray *copiedIds = vtkIdTypeArray::SafeDownCast(
+      threaded->GetCellData()->GetArray("CellId"));
+    if (threaded->GetNumberOfCells() != (input->GetNumberOfCells() + 2) / 3)
+      {
+      cerr << "vtkExtractCells extracted " << threaded->GetNumberOfCells()
+           << " cells" << endl;
+      status = 0;
+      }
+    else if (threaded->GetPoints()->GetDataType() !=
+             (i ? VTK_DOUBLE : VTK_FLOAT))
+      {
+      cerr << "vtkExtractCells did not keep the point type" << endl;
+      status = 0;
+      }
+    // The ids and scalars copied from the image identify the input cells.
+    else if (!CheckExtraction(image, threaded))
+      {
+      status = 0;
+      }
+    else if (!SameGrids(serial, threaded))
+      {
+      cerr << "vtkExtractCells depends on the number of threads" << endl;
+      status = 0;
+      }
+    else if (!origIds || !copiedIds)
+      {
+      cerr << "Missing vtkOriginalCellIds" << endl;
+      status = 0;
+      }
+    else
+      {
+      for (vtkIdType j = 0; j < origIds->GetNumberOfTuples() && status; j++)
+        {
+        if (origIds->GetValue(j) != 3 * j ||
+            (i == 0 && copiedIds->GetValue(j) != 3 * j))
+          {
+          cerr << "Wrong vtkOriginalCellIds" << endl;
+          status = 0;
+          }
+        }
+      }
+    }
+  vtkMultiThreader::SetGlobalDefaultNumberOfThreads(defaultThreads);
+
+  return status ? EXIT_SUCCESS : EXIT_FAILURE;
+}
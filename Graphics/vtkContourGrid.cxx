@@ -154,6 +154,8 @@ void vtkContourGridExecute(vtkContourGrid *self, vtkDataSet *input,
     }
   outPd->InterpolateAllocate(inPd,estimatedSize,estimatedSize);
   outCd->CopyAllocate(inCd,estimatedSize,estimatedSize);
+  // edge interpolation is deferred and done for all arrays at the end
+  outPd->BeginInterpolationBatch(inPd);
 
   // If enabled, build a scalar tree to accelerate search
   //
@@ -288,6 +290,8 @@ void vtkContourGridExecute(vtkContourGrid *self, vtkDataSet *input,
       } //for all contour values
     } //using scalar tree
 
+  outPd->EndInterpolationBatch();
+
   //
   // Update ourselves.  Because we don't know up front how many verts, lines,
   // polys we've created, take care to reclaim memory. 
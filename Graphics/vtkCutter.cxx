@@ -472,6 +472,8 @@ void vtkCutter::DataSetCutter(vtkDataSet *input, vtkPolyData *output)
   outPD = output->GetPointData();
   outPD->InterpolateAllocate(inPD,estimatedSize,estimatedSize/2);
   outCD->CopyAllocate(inCD,estimatedSize,estimatedSize/2);
+  // edge interpolation is deferred and done for all arrays at the end
+  outPD->BeginInterpolationBatch(inPD);
 
   // locator used to merge potentially duplicate points
   if ( this->Locator == NULL )
@@ -607,6 +609,8 @@ void vtkCutter::DataSetCutter(vtkDataSet *input, vtkPolyData *output)
       } // for all dimensions.
     } // sort by value
 
+  outPD->EndInterpolationBatch();
+
   // Update ourselves.  Because we don't know upfront how many verts, lines,
   // polys we've created, take care to reclaim memory. 
   //
@@ -701,6 +705,8 @@ void vtkCutter::UnstructuredGridCutter(vtkDataSet *input, vtkPolyData *output)
   outPD = output->GetPointData();
   outPD->InterpolateAllocate(inPD,estimatedSize,estimatedSize/2);
   outCD->CopyAllocate(inCD,estimatedSize,estimatedSize/2);
+  // edge interpolation is deferred and done for all arrays at the end
+  outPD->BeginInterpolationBatch(inPD);
     
   // locator used to merge potentially duplicate points
   if ( this->Locator == NULL )
@@ -905,6 +911,8 @@ void vtkCutter::UnstructuredGridCutter(vtkDataSet *input, vtkPolyData *output)
       } // for all dimensions (1,2,3).
     } // sort by value
 
+  outPD->EndInterpolationBatch();
+
   // Update ourselves.  Because we don't know upfront how many verts, lines,
   // polys we've created, take care to reclaim memory.
   //
@@ -23,6 +23,7 @@
 #include "vtkInformation.h"
 #include "vtkInformationVector.h"
 #include "vtkMergePoints.h"
+#include "vtkMultiThreader.h"
 #include "vtkNew.h"
 #include "vtkObjectFactory.h"
 #include "vtkPointData.h"
@@ -43,6 +44,7 @@
 #include "vtkWedge.h"
 
 #include <vtkstd/algorithm>
+#include <vtkstd/vector>
 #include <vtksys/hash_map.hxx>
 
 static int sizeofFastQuad(int numPts)
@@ -51,6 +53,169 @@ static int sizeofFastQuad(int numPts)
   return static_cast<int>(sizeof(vtkFastGeomQuad)+(numPts-4)*sizeof(vtkIdType));
 }
 
+// Number of cells each thread should at least get before the faces of an
+// unstructured grid are extracted by several threads.
+#define VTK_DATA_SET_SURFACE_FILTER_CELLS_PER_THREAD 20000
+
+// The faces are keyed by their smallest point id, which is moved first while
+// keeping the orientation of the face. The matching rules below are the
+// ones of the face hash: they are shared by the serial and threaded paths
+// so that both hide exactly the same faces.
+
+//----------------------------------------------------------------------------
+static inline void vtkDataSetSurfaceFilterOrderQuad(vtkIdType ids[4])
+{
+  vtkIdType tmp;
+  if (ids[1] < ids[0] && ids[1] < ids[2] && ids[1] < ids[3])
+    {
+    tmp = ids[0];
+    ids[0] = ids[1];
+    ids[1] = ids[2];
+    ids[2] = ids[3];
+    ids[3] = tmp;
+    }
+  else if (ids[2] < ids[0] && ids[2] < ids[1] && ids[2] < ids[3])
+    {
+    tmp = ids[0];
+    ids[0] = ids[2];
+    ids[2] = tmp;
+    tmp = ids[1];
+    ids[1] = ids[3];
+    ids[3] = tmp;
+    }
+  else if (ids[3] < ids[0] && ids[3] < ids[1] && ids[3] < ids[2])
+    {
+    tmp = ids[0];
+    ids[0] = ids[3];
+    ids[3] = ids[2];
+    ids[2] = ids[1];
+    ids[1] = tmp;
+    }
+}
+
+//----------------------------------------------------------------------------
+static inline void vtkDataSetSurfaceFilterOrderTri(vtkIdType ids[3])
+{
+  vtkIdType tmp;
+  if (ids[1] < ids[0] && ids[1] < ids[2])
+    {
+    tmp = ids[0];
+    ids[0] = ids[1];
+    ids[1] = ids[2];
+    ids[2] = tmp;
+    }
+  else if (ids[2] < ids[0] && ids[2] < ids[1])
+    {
+    tmp = ids[0];
+    ids[0] = ids[2];
+    ids[2] = ids[1];
+    ids[1] = tmp;
+    }
+  // We can't put the second smallest in ids[1] because it might change the
+  // order of the vertices in the final triangle.
+}
+
+//----------------------------------------------------------------------------
+static inline void vtkDataSetSurfaceFilterOrderPolygon(const vtkIdType *ids,
+                                                       int numPts,
+                                                       vtkIdType *tab)
+{
+  // find the index to the smallest id
+  int offset = 0;
+  for (int i = 1; i < numPts; i++)
+    {
+    if (ids[i] < ids[offset])
+      {
+      offset = i;
+      }
+    }
+  // copy ids into ordered array with smallest id first
+  for (int i = 0; i < numPts; i++)
+    {
+    tab[i] = ids[(offset+i)%numPts];
+    }
+}
+
+//----------------------------------------------------------------------------
+// Does the ordered quad ids match the face (numPts, ptArray) of its bin?
+static inline bool vtkDataSetSurfaceFilterMatchQuad(const vtkIdType ids[4],
+                                                    int numPts,
+                                                    const vtkIdType *ptArray)
+{
+  // ids[0] has to match in this bin.
+  // ids[2] should be independant of point order.
+  return numPts == 4 && ids[2] == ptArray[2] &&
+    ((ids[1] == ptArray[1] && ids[3] == ptArray[3]) ||
+     (ids[1] == ptArray[3] && ids[3] == ptArray[1]));
+}
+
+//----------------------------------------------------------------------------
+static inline bool vtkDataSetSurfaceFilterMatchTri(const vtkIdType ids[3],
+                                                   int numPts,
+                                                   const vtkIdType *ptArray)
+{
+  return numPts == 3 &&
+    ((ids[1] == ptArray[1] && ids[2] == ptArray[2]) ||
+     (ids[1] == ptArray[2] && ids[2] == ptArray[1]));
+}
+
+//----------------------------------------------------------------------------
+static inline bool vtkDataSetSurfaceFilterMatchPolygon(const vtkIdType *tab,
+                                                       int tabNumPts,
+                                                       int numPts,
+                                                       const vtkIdType *ptArray)
+{
+  if (tabNumPts != numPts)
+    {
+    return false;
+    }
+  if (tab[1] == ptArray[1])
+    {
+    // if the first two points match loop through forwards
+    // checking all points
+    for (int i = 2; i < numPts; i++)
+      {
+      if (tab[i] != ptArray[i])
+        {
+        return false;
+        }
+      }
+    return true;
+    }
+  if (tab[numPts-1] == ptArray[1])
+    {
+    // the first two points match with the opposite sense.
+    // loop though comparing the correct sense
+    for (int i = 2; i < numPts; i++)
+      {
+      if (tab[numPts - i] != ptArray[i])
+        {
+        return false;
+        }
+      }
+    return true;
+    }
+  return false;
+}
+
+//----------------------------------------------------------------------------
+// Can the unstructured grid cells of this type be handled when the faces
+// of the 3D cells are extracted by threads?
+static int vtkDataSetSurfaceFilterIsThreadedFaceCell(int cellType)
+{
+  switch (cellType)
+    {
+    case VTK_TETRA:
+    case VTK_HEXAHEDRON:
+    case VTK_VOXEL:
+    case VTK_WEDGE:
+    case VTK_PYRAMID:
+    case VTK_PENTAGONAL_PRISM:
+    case VTK_HEXAGONAL_PRISM:
+      return 1;
+    }
+  return 0;
+}
 
 class vtkDataSetSurfaceFilter::vtkEdgeInterpolationMap
 {
@@ -115,6 +280,8 @@ vtkDataSetSurfaceFilter::vtkDataSetSurfaceFilter()
 
   this->NonlinearSubdivisionLevel = 1;
 
+  this->ThreadedFaceExtraction = 0;
+
   this->GetInformation()->Set(vtkAlgorithm::PRESERVES_BOUNDS(), 1);
   this->GetInformation()->Set(vtkAlgorithm::PRESERVES_RANGES(), 1);
 
@@ -952,6 +1119,8 @@ void vtkDataSetSurfaceFilter::PrintSelf(ostream& os, vtkIndent indent)
 
   os << indent << "NonlinearSubdivisionLevel: "
      << this->NonlinearSubdivisionLevel << endl;
+  os << indent << "ThreadedFaceExtraction: "
+     << (this->ThreadedFaceExtraction ? "On\n" : "Off\n");
 }
 
 //========================================================================
@@ -1114,6 +1283,40 @@ int vtkDataSetSurfaceFilter::UnstructuredGridExecute(vtkDataSet *dataSetInput,
       }
     }
   
+  // Decide whether the faces of the 3D cells are extracted by threads.
+  // This is only possible if none of the cells goes through the hash in
+  // a way the threads do not reproduce.
+  int numThreads = 0;
+  if (this->ThreadedFaceExtraction)
+    {
+    numThreads = static_cast<int>(
+      numCells / VTK_DATA_SET_SURFACE_FILTER_CELLS_PER_THREAD);
+    int maxThreads = vtkMultiThreader::GetGlobalDefaultNumberOfThreads();
+    if (numThreads > maxThreads)
+      {
+      numThreads = maxThreads;
+      }
+    for (cellId = 0; cellId < numCells && numThreads > 1; cellId++)
+      {
+      cellType = cellTypes[cellId];
+      if (!vtkDataSetSurfaceFilterIsThreadedFaceCell(cellType) &&
+          cellType != VTK_VERTEX && cellType != VTK_POLY_VERTEX &&
+          cellType != VTK_LINE && cellType != VTK_POLY_LINE &&
+          cellType != VTK_PIXEL && cellType != VTK_QUAD &&
+          cellType != VTK_TRIANGLE && cellType != VTK_POLYGON &&
+          cellType != VTK_TRIANGLE_STRIP &&
+          cellType != VTK_QUADRATIC_TRIANGLE &&
+          cellType != VTK_BIQUADRATIC_TRIANGLE &&
+          cellType != VTK_QUADRATIC_QUAD &&
+          cellType != VTK_QUADRATIC_LINEAR_QUAD &&
+          cellType != VTK_BIQUADRATIC_QUAD)
+        {
+        numThreads = 0;
+        }
+      }
+    }
+  int threadedFaces = (numThreads > 1);
+
   // Traverse cells to extract geometry
   //
   progressCount = 0;
@@ -1160,6 +1363,11 @@ int vtkDataSetSurfaceFilter::UnstructuredGridExecute(vtkDataSet *dataSetInput,
       this->RecordOrigCellId(this->NumberOfNewCells, cellId);
       outputCD->CopyData(cd, cellId, this->NumberOfNewCells++);
       }
+    else if (threadedFaces &&
+             vtkDataSetSurfaceFilterIsThreadedFaceCell(cellType))
+      {
+      // The faces are extracted by the threads after the 2D cells.
+      }
     else if (cellType == VTK_HEXAHEDRON)
       {
       this->InsertQuadInHash(ids[0], ids[1], ids[5], ids[4], cellId);
@@ -1523,6 +1731,12 @@ int vtkDataSetSurfaceFilter::UnstructuredGridExecute(vtkDataSet *dataSetInput,
     } // for all cells.
 
 
+  if (threadedFaces && !abort)
+    {
+    this->ThreadedFaceExtractionExecute(input, numThreads, newPts, newPolys,
+                                        outputPD, outputCD);
+    }
+
   // Now transfer geometry from hash to output (only triangles and quads).
   this->InitQuadHashTraversal();
   while ( (q = this->GetNextVisibleQuadFromHash()) )
@@ -1645,54 +1859,24 @@ void vtkDataSetSurfaceFilter::InsertQuadInHash(vtkIdType a, vtkIdType b,
                                                vtkIdType c, vtkIdType d, 
                                                vtkIdType sourceId)
 {
-  vtkIdType tmp;
   vtkFastGeomQuad *quad, **end;
+  vtkIdType ids[4] = { a, b, c, d };
 
-  // Reorder to get smallest id in a.
-  if (b < a && b < c && b < d)
-    {
-    tmp = a;
-    a = b;
-    b = c;
-    c = d;
-    d = tmp;
-    }
-  else if (c < a && c < b && c < d)
-    {
-    tmp = a;
-    a = c;
-    c = tmp;
-    tmp = b;
-    b = d;
-    d = tmp;
-    }
-  else if (d < a && d < b && d < c)
-    {
-    tmp = a;
-    a = d;
-    d = c;
-    c = b;
-    b = tmp;
-    }
+  // Reorder to get smallest id in ids[0].
+  vtkDataSetSurfaceFilterOrderQuad(ids);
 
   // Look for existing quad in the hash;
-  end = this->QuadHash + a;
+  end = this->QuadHash + ids[0];
   quad = *end;
   while (quad)
     {
     end = &(quad->Next);
-    // a has to match in this bin.
-    // c should be independant of point order.
-    if (quad->numPts == 4 && c == quad->ptArray[2])
-      { 
-      // Check boh orders for b and d.
-      if ((b == quad->ptArray[1] && d == quad->ptArray[3]) || (b == quad->ptArray[3] && d == quad->ptArray[1]))
-        {
-        // We have a match.
-        quad->SourceId = -1;
-        // That is all we need to do.  Hide any quad shared by two or more cells.
-        return;
-        }
+    if (vtkDataSetSurfaceFilterMatchQuad(ids, quad->numPts, quad->ptArray))
+      {
+      // We have a match.
+      quad->SourceId = -1;
+      // That is all we need to do.  Hide any quad shared by two or more cells.
+      return;
       }
     quad = *end;
     }
@@ -1701,10 +1885,10 @@ void vtkDataSetSurfaceFilter::InsertQuadInHash(vtkIdType a, vtkIdType b,
   quad = this->NewFastGeomQuad(4);
   quad->Next = NULL;
   quad->SourceId = sourceId;
-  quad->ptArray[0] = a;
-  quad->ptArray[1] = b;
-  quad->ptArray[2] = c;
-  quad->ptArray[3] = d;
+  quad->ptArray[0] = ids[0];
+  quad->ptArray[1] = ids[1];
+  quad->ptArray[2] = ids[2];
+  quad->ptArray[3] = ids[3];
   *end = quad;
 }
 
@@ -1713,43 +1897,24 @@ void vtkDataSetSurfaceFilter::InsertTriInHash(vtkIdType a, vtkIdType b,
                                               vtkIdType c, vtkIdType sourceId,
                                               vtkIdType vtkNotUsed(faceId)/*= -1*/)
 {
-  vtkIdType tmp;
   vtkFastGeomQuad *quad, **end;
+  vtkIdType ids[3] = { a, b, c };
 
-  // Reorder to get smallest id in a.
-  if (b < a && b < c)
-    {
-    tmp = a;
-    a = b;
-    b = c;
-    c = tmp;
-    }
-  else if (c < a && c < b)
-    {
-    tmp = a;
-    a = c;
-    c = b;
-    b = tmp;
-    }
-  // We can't put the second smnallest in b because it might change the order
-  // of the vertices in the final triangle.
+  // Reorder to get smallest id in ids[0].
+  vtkDataSetSurfaceFilterOrderTri(ids);
 
   // Look for existing tri in the hash;
-  end = this->QuadHash + a;
+  end = this->QuadHash + ids[0];
   quad = *end;
   while (quad)
     {
     end = &(quad->Next);
-    // a has to match in this bin.
-    if (quad->numPts == 3)
-      { 
-      if ((b == quad->ptArray[1] && c == quad->ptArray[2]) || (b == quad->ptArray[2] && c == quad->ptArray[1]))
-        {
-        // We have a match.
-        quad->SourceId = -1;
-        // That is all we need to do. Hide any tri shared by two or more cells.
-        return;
-        }
+    if (vtkDataSetSurfaceFilterMatchTri(ids, quad->numPts, quad->ptArray))
+      {
+      // We have a match.
+      quad->SourceId = -1;
+      // That is all we need to do. Hide any tri shared by two or more cells.
+      return;
       }
     quad = *end;
     }
@@ -1758,9 +1923,9 @@ void vtkDataSetSurfaceFilter::InsertTriInHash(vtkIdType a, vtkIdType b,
   quad = this->NewFastGeomQuad(3);
   quad->Next = NULL;
   quad->SourceId = sourceId;
-  quad->ptArray[0] = a;
-  quad->ptArray[1] = b;
-  quad->ptArray[2] = c;
+  quad->ptArray[0] = ids[0];
+  quad->ptArray[1] = ids[1];
+  quad->ptArray[2] = ids[2];
   *end = quad;
 }
 
@@ -1775,22 +1940,9 @@ void vtkDataSetSurfaceFilter::InsertPolygonInHash(vtkIdType* ids,
 {
   vtkFastGeomQuad *quad, **end;
 
-  // find the index to the smallest id
-  vtkIdType offset = 0;
-  for(int i=1; i<numPts; i++)
-    {
-    if(ids[i] < ids[offset])
-      {
-      offset = i;
-      }
-    }
-
   // copy ids into ordered array with smallest id first
   vtkIdType* tab = new vtkIdType[numPts];
-  for(int i=0; i<numPts; i++)
-    {
-    tab[i] = ids[(offset+i)%numPts];
-    }
+  vtkDataSetSurfaceFilterOrderPolygon(ids, numPts, tab);
   
   // Look for existing hex in the hash;
   end = this->QuadHash + tab[0];
@@ -1799,54 +1951,15 @@ void vtkDataSetSurfaceFilter::InsertPolygonInHash(vtkIdType* ids,
     {
     end = &(quad->Next);
     // a has to match in this bin.
-    // first just check the polygon size.
-    bool match = true;
-    if (numPts == quad->numPts)
-      {
-      if ( tab[1] == quad->ptArray[1])
-        {
-        // if the first two points match loop through forwards
-        // checking all points
-        for (int i = 2; i < numPts; i++)
-          {
-          if ( tab[i] != quad->ptArray[i])
-            {
-            match = false;
-            break;
-            }
-          }
-        }
-      else if (tab[numPts-1] == quad->ptArray[1])
-        {
-        // the first two points match with the opposite sense.
-        // loop though comparing the correct sense
-        for (int i = 2; i < numPts; i++)
-          {
-          if ( tab[numPts - i] != quad->ptArray[i])
-            {
-            match = false;
-            break;
-            }
-          }
-        }
-      else
-        {
-        match = false;
-        }
-      }
-    else
+    if (vtkDataSetSurfaceFilterMatchPolygon(tab, numPts, quad->numPts,
+                                            quad->ptArray))
       {
-      match = false;
+      // We have a match.
+      quad->SourceId = -1;
+      // That is all we need to do. Hide any tri shared by two or more cells.
+      delete [] tab;
+      return;
       }
-
-      if (match)
-        {
-        // We have a match.
-        quad->SourceId = -1;
-        // That is all we need to do. Hide any tri shared by two or more cells.
-        delete [] tab;
-        return;
-        }
     quad = *end;
     }
   
@@ -2014,6 +2127,326 @@ vtkFastGeomQuad *vtkDataSetSurfaceFilter::GetNextVisibleQuadFromHash()
   return quad;
 }
 
+//----------------------------------------------------------------------------
+// Face tables of the cells handled by the threaded face extraction. They
+// list the faces in the order the serial code inserts them in the hash.
+static const int vtkDataSetSurfaceFilterHexFaces[6][4] =
+  { {0,1,5,4}, {0,3,2,1}, {0,4,7,3}, {1,2,6,5}, {2,3,7,6}, {4,5,6,7} };
+static const int vtkDataSetSurfaceFilterVoxelFaces[6][4] =
+  { {0,1,5,4}, {0,2,3,1}, {0,4,6,2}, {1,3,7,5}, {2,6,7,3}, {4,5,7,6} };
+static const int vtkDataSetSurfaceFilterTetFaces[4][3] =
+  { {0,1,3}, {0,2,1}, {0,3,2}, {1,2,3} };
+
+//----------------------------------------------------------------------------
+// The faces are stored as records of 2 + numPts ids in per thread lists:
+// (numPts << 1 | isPolygon), the source cell id and the ordered point ids.
+// There is one list per thread and partition of the point ids, so that
+// the lists of a partition, taken in thread order, hold its faces in the
+// order the serial code would have inserted them in the hash.
+struct vtkDataSetSurfaceFilterFaces
+{
+  const unsigned char *CellTypes;
+  const vtkIdType *Locations;
+  const vtkIdType *Connectivity;
+  vtkIdType NumberOfCells;
+  vtkIdType NumberOfPoints;
+  vtkIdType PartitionSize;
+  int NumberOfPartitions;
+  int NumberOfThreads;
+  // Faces[threadId*NumberOfPartitions + partition]
+  vtkstd::vector<vtkIdType> *Faces;
+  // The faces of each partition which belong to a single cell, in the
+  // order of the hash traversal.
+  vtkstd::vector<const vtkIdType*> *Visible;
+};
+
+//----------------------------------------------------------------------------
+static inline void vtkDataSetSurfaceFilterAddFace(
+  vtkDataSetSurfaceFilterFaces *faces, vtkstd::vector<vtkIdType> *lists,
+  const vtkIdType *ids, int numPts, int polygon, vtkIdType cellId)
+{
+  vtkIdType ordered[6];
+  if (polygon)
+    {
+    vtkDataSetSurfaceFilterOrderPolygon(ids, numPts, ordered);
+    }
+  else if (numPts == 4)
+    {
+    ordered[0] = ids[0]; ordered[1] = ids[1];
+    ordered[2] = ids[2]; ordered[3] = ids[3];
+    vtkDataSetSurfaceFilterOrderQuad(ordered);
+    }
+  else
+    {
+    ordered[0] = ids[0]; ordered[1] = ids[1]; ordered[2] = ids[2];
+    vtkDataSetSurfaceFilterOrderTri(ordered);
+    }
+  vtkstd::vector<vtkIdType> &list = lists[ordered[0] / faces->PartitionSize];
+  list.push_back((static_cast<vtkIdType>(numPts) << 1) | polygon);
+  list.push_back(cellId);
+  list.insert(list.end(), ordered, ordered + numPts);
+}
+
+//----------------------------------------------------------------------------
+// Collect the faces of a range of cells.
+static VTK_THREAD_RETURN_TYPE vtkDataSetSurfaceFilterCollectFaces(void *arg)
+{
+  vtkMultiThreader::ThreadInfo *info =
+    static_cast<vtkMultiThreader::ThreadInfo*>(arg);
+  vtkDataSetSurfaceFilterFaces *faces =
+    static_cast<vtkDataSetSurfaceFilterFaces*>(info->UserData);
+  vtkstd::vector<vtkIdType> *lists =
+    faces->Faces + info->ThreadID * faces->NumberOfPartitions;
+  vtkIdType begin = faces->NumberOfCells * info->ThreadID /
+    info->NumberOfThreads;
+  vtkIdType end = faces->NumberOfCells * (info->ThreadID + 1) /
+    info->NumberOfThreads;
+  vtkIdType face[4];
+  int i, j;
+
+  for (vtkIdType cellId = begin; cellId < end; ++cellId)
+    {
+    const vtkIdType *ids = faces->Connectivity + faces->Locations[cellId] + 1;
+    switch (faces->CellTypes[cellId])
+      {
+      case VTK_HEXAHEDRON:
+      case VTK_VOXEL:
+        {
+        const int (*table)[4] =
+          faces->CellTypes[cellId] == VTK_HEXAHEDRON ?
+          vtkDataSetSurfaceFilterHexFaces : vtkDataSetSurfaceFilterVoxelFaces;
+        for (i = 0; i < 6; ++i)
+          {
+          for (j = 0; j < 4; ++j)
+            {
+            face[j] = ids[table[i][j]];
+            }
+          vtkDataSetSurfaceFilterAddFace(faces, lists, face, 4, 0, cellId);
+          }
+        }
+        break;
+      case VTK_TETRA:
+        for (i = 0; i < 4; ++i)
+          {
+          for (j = 0; j < 3; ++j)
+            {
+            face[j] = ids[vtkDataSetSurfaceFilterTetFaces[i][j]];
+            }
+          vtkDataSetSurfaceFilterAddFace(faces, lists, face, 3, 0, cellId);
+          }
+        break;
+      case VTK_WEDGE:
+      case VTK_PYRAMID:
+        for (i = 0; i < 5; ++i)
+          {
+          int *verts = faces->CellTypes[cellId] == VTK_WEDGE ?
+            vtkWedge::GetFaceArray(i) : vtkPyramid::GetFaceArray(i);
+          int numFacePts = (verts[3] == -1 ? 3 : 4);
+          for (j = 0; j < numFacePts; ++j)
+            {
+            face[j] = ids[verts[j]];
+            }
+          vtkDataSetSurfaceFilterAddFace(faces, lists, face, numFacePts, 0,
+                                         cellId);
+          }
+        break;
+      case VTK_PENTAGONAL_PRISM:
+      case VTK_HEXAGONAL_PRISM:
+        {
+        // The quads, then both polygons.
+        int n = (faces->CellTypes[cellId] == VTK_PENTAGONAL_PRISM ? 5 : 6);
+        for (i = 0; i < n; ++i)
+          {
+          face[0] = ids[i];
+          face[1] = ids[(i + 1) % n];
+          face[2] = ids[(i + 1) % n + n];
+          face[3] = ids[i + n];
+          vtkDataSetSurfaceFilterAddFace(faces, lists, face, 4, 0, cellId);
+          }
+        vtkDataSetSurfaceFilterAddFace(faces, lists, ids, n, 1, cellId);
+        vtkDataSetSurfaceFilterAddFace(faces, lists, ids + n, n, 1, cellId);
+        }
+        break;
+      }
+    }
+  return VTK_THREAD_RETURN_VALUE;
+}
+
+//----------------------------------------------------------------------------
+// Hide the faces shared by several cells in a partition of the point ids,
+// the way the face hash does it bin after bin.
+static void vtkDataSetSurfaceFilterResolvePartition(
+  vtkDataSetSurfaceFilterFaces *faces, int partition)
+{
+  vtkIdType lo = partition * faces->PartitionSize;
+  vtkIdType hi = lo + faces->PartitionSize;
+  if (hi > faces->NumberOfPoints)
+    {
+    hi = faces->NumberOfPoints;
+    }
+  if (lo >= hi)
+    {
+    return;
+    }
+  int t;
+
+  // Sort the faces by bin, keeping their insertion order within a bin.
+  vtkstd::vector<vtkIdType> binEnds(hi - lo + 1, 0);
+  vtkIdType numFaces = 0;
+  for (t = 0; t < faces->NumberOfThreads; ++t)
+    {
+    const vtkstd::vector<vtkIdType> &list =
+      faces->Faces[t * faces->NumberOfPartitions + partition];
+    for (size_t r = 0; r < list.size(); r += 2 + (list[r] >> 1))
+      {
+      ++binEnds[list[r + 2] - lo + 1];
+      ++numFaces;
+      }
+    }
+  vtkIdType bin;
+  for (bin = 1; bin <= hi - lo; ++bin)
+    {
+    binEnds[bin] += binEnds[bin - 1];
+    }
+  vtkstd::vector<const vtkIdType*> sorted(numFaces);
+  for (t = 0; t < faces->NumberOfThreads; ++t)
+    {
+    const vtkstd::vector<vtkIdType> &list =
+      faces->Faces[t * faces->NumberOfPartitions + partition];
+    for (size_t r = 0; r < list.size(); r += 2 + (list[r] >> 1))
+      {
+      sorted[binEnds[list[r + 2] - lo]++] = &list[r];
+      }
+    }
+
+  // Each bin now spans [binEnds[bin-1], binEnds[bin]).
+  vtkstd::vector<const vtkIdType*> &visible = faces->Visible[partition];
+  vtkstd::vector<const vtkIdType*> distinct;
+  vtkstd::vector<char> hidden;
+  vtkIdType first = 0;
+  for (bin = 0; bin < hi - lo; ++bin)
+    {
+    distinct.clear();
+    hidden.clear();
+    for (vtkIdType f = first; f < binEnds[bin]; ++f)
+      {
+      const vtkIdType *rec = sorted[f];
+      int numPts = static_cast<int>(rec[0] >> 1);
+      size_t k;
+      for (k = 0; k < distinct.size(); ++k)
+        {
+        int otherNumPts = static_cast<int>(distinct[k][0] >> 1);
+        const vtkIdType *other = distinct[k] + 2;
+        bool match;
+        if (rec[0] & 1)
+          {
+          match = vtkDataSetSurfaceFilterMatchPolygon(rec + 2, numPts,
+                                                      otherNumPts, other);
+          }
+        else if (numPts == 4)
+          {
+          match = vtkDataSetSurfaceFilterMatchQuad(rec + 2, otherNumPts,
+                                                   other);
+          }
+        else
+          {
+          match = vtkDataSetSurfaceFilterMatchTri(rec + 2, otherNumPts,
+                                                  other);
+          }
+        if (match)
+          {
+          hidden[k] = 1;
+          break;
+          }
+        }
+      if (k == distinct.size())
+        {
+        distinct.push_back(rec);
+        hidden.push_back(0);
+        }
+      }
+    for (size_t k = 0; k < distinct.size(); ++k)
+      {
+      if (!hidden[k])
+        {
+        visible.push_back(distinct[k]);
+        }
+      }
+    first = binEnds[bin];
+    }
+}
+
+//----------------------------------------------------------------------------
+static VTK_THREAD_RETURN_TYPE vtkDataSetSurfaceFilterResolveFaces(void *arg)
+{
+  vtkMultiThreader::ThreadInfo *info =
+    static_cast<vtkMultiThreader::ThreadInfo*>(arg);
+  vtkDataSetSurfaceFilterFaces *faces =
+    static_cast<vtkDataSetSurfaceFilterFaces*>(info->UserData);
+  for (int p = info->ThreadID; p < faces->NumberOfPartitions;
+       p += info->NumberOfThreads)
+    {
+    vtkDataSetSurfaceFilterResolvePartition(faces, p);
+    }
+  return VTK_THREAD_RETURN_VALUE;
+}
+
+//----------------------------------------------------------------------------
+void vtkDataSetSurfaceFilter::ThreadedFaceExtractionExecute(
+  vtkUnstructuredGrid *input, int numThreads, vtkPoints *newPts,
+  vtkCellArray *newPolys, vtkPointData *outputPD, vtkCellData *outputCD)
+{
+  vtkDataSetSurfaceFilterFaces faces;
+  faces.CellTypes = input->GetCellTypesArray()->GetPointer(0);
+  faces.Locations = input->GetCellLocationsArray()->GetPointer(0);
+  faces.Connectivity = input->GetCells()->GetPointer();
+  faces.NumberOfCells = input->GetNumberOfCells();
+  faces.NumberOfPoints = input->GetNumberOfPoints();
+  faces.NumberOfThreads = numThreads;
+  // A few partitions per thread even out the work of the resolution pass.
+  faces.NumberOfPartitions = 4 * numThreads;
+  faces.PartitionSize = (faces.NumberOfPoints + faces.NumberOfPartitions - 1)
+    / faces.NumberOfPartitions;
+  if (faces.PartitionSize < 1)
+    {
+    faces.PartitionSize = 1;
+    }
+  vtkstd::vector<vtkstd::vector<vtkIdType> > lists(
+    numThreads * faces.NumberOfPartitions);
+  vtkstd::vector<vtkstd::vector<const vtkIdType*> > visible(
+    faces.NumberOfPartitions);
+  faces.Faces = &lists[0];
+  faces.Visible = &visible[0];
+
+  vtkMultiThreader *threader = vtkMultiThreader::New();
+  threader->SetNumberOfThreads(numThreads);
+  threader->SetSingleMethod(vtkDataSetSurfaceFilterCollectFaces, &faces);
+  threader->SingleMethodExecute();
+  threader->SetSingleMethod(vtkDataSetSurfaceFilterResolveFaces, &faces);
+  threader->SingleMethodExecute();
+  threader->Delete();
+
+  // The output points are numbered in the order they are first used, so
+  // the faces are appended serially, in the order of the hash traversal.
+  vtkCellData *inputCD = input->GetCellData();
+  vtkIdType pts[6];
+  for (int p = 0; p < faces.NumberOfPartitions; ++p)
+    {
+    for (size_t f = 0; f < visible[p].size(); ++f)
+      {
+      const vtkIdType *rec = visible[p][f];
+      int numPts = static_cast<int>(rec[0] >> 1);
+      for (int i = 0; i < numPts; ++i)
+        {
+        pts[i] = this->GetOutputPointId(rec[i + 2], input, newPts, outputPD);
+        }
+      newPolys->InsertNextCell(numPts, pts);
+      this->RecordOrigCellId(this->NumberOfNewCells, rec[1]);
+      outputCD->CopyData(inputCD, rec[1], this->NumberOfNewCells++);
+      }
+    }
+}
+
 //----------------------------------------------------------------------------
 vtkIdType vtkDataSetSurfaceFilter::GetOutputPointId(vtkIdType inPtId,
                                                     vtkDataSet *input,
@@ -28,9 +28,12 @@
 #include "vtkPolyDataAlgorithm.h"
 
 
+class vtkCellArray;
+class vtkCellData;
 class vtkPointData;
 class vtkPoints;
 class vtkIdTypeArray;
+class vtkUnstructuredGrid;
 
 //BTX
 // Helper structure for hashing faces.
@@ -109,6 +112,20 @@ public:
   vtkSetMacro(NonlinearSubdivisionLevel, int);
   vtkGetMacro(NonlinearSubdivisionLevel, int);
 
+  // Description:
+  // If on, the faces of the 3D cells of an unstructured grid are collected
+  // and resolved by several threads instead of going through the face hash
+  // one at a time. The faces are bucketed by their smallest point id, so the
+  // output (including the original cell and point ids) is exactly the same
+  // as the one produced with this option off. Every face is stored before
+  // the shared ones are removed, so this takes more memory than the serial
+  // hash. It is only used when the grid holds nothing but linear cells
+  // (tetrahedra, hexahedra, voxels, wedges, pyramids and prisms for the 3D
+  // ones) and has enough cells to be worth it. Off by default.
+  vtkSetMacro(ThreadedFaceExtraction, int);
+  vtkGetMacro(ThreadedFaceExtraction, int);
+  vtkBooleanMacro(ThreadedFaceExtraction, int);
+
   // Description:
   // Direct access methods that can be used to use the this class as an
   // algorithm without using it as a filter.
@@ -163,6 +180,16 @@ protected:
   void InitQuadHashTraversal();
   vtkFastGeomQuad *GetNextVisibleQuadFromHash();
 
+  // Description:
+  // Threaded counterpart of the face hash: extract the faces of the 3D
+  // cells of input which belong to a single cell, and append them to the
+  // output in the order the hash traversal would have.
+  void ThreadedFaceExtractionExecute(vtkUnstructuredGrid *input,
+                                     int numThreads, vtkPoints *newPts,
+                                     vtkCellArray *newPolys,
+                                     vtkPointData *outputPD,
+                                     vtkCellData *outputCD);
+
   vtkFastGeomQuad **QuadHash;
   vtkIdType QuadHashLength;
   vtkFastGeomQuad *QuadHashTraversal;
@@ -209,6 +236,8 @@ protected:
 
   int NonlinearSubdivisionLevel;
 
+  int ThreadedFaceExtraction;
+
 private:
   vtkDataSetSurfaceFilter(const vtkDataSetSurfaceFilter&);  // Not implemented.
   void operator=(const vtkDataSetSurfaceFilter&);  // Not implemented.
@@ -22,7 +22,7 @@
 #include "vtkObjectFactory.h"
 #include "vtkPlane.h"
 #include "vtkPolyData.h"
-#include "vtkPriorityQueue.h"
+#include "vtkIndexedPriorityQueue.h"
 #include "vtkTriangle.h"
 #include "vtkCellArray.h"
 #include "vtkPointData.h"
@@ -67,7 +67,7 @@ vtkDecimatePro::vtkDecimatePro()
   this->Neighbors->Allocate(VTK_MAX_TRIS_PER_VERTEX);
   this->V = new vtkDecimatePro::VertexArray(VTK_MAX_TRIS_PER_VERTEX+1);
   this->T = new vtkDecimatePro::TriArray(VTK_MAX_TRIS_PER_VERTEX+1);
-  this->EdgeLengths = vtkPriorityQueue::New();
+  this->EdgeLengths = vtkIndexedPriorityQueue::New();
   this->EdgeLengths->Allocate(VTK_MAX_TRIS_PER_VERTEX);
   
   this->InflectionPoints = vtkDoubleArray::New();
@@ -1436,7 +1436,6 @@ int vtkDecimatePro::CollapseEdge(int type, vtkIdType ptId,
     }
   for ( i=0; i < nverts; i++ )
     {
-    this->DeleteId(verts[i]);
     this->Insert(verts[i]);
     }
 
@@ -1490,7 +1489,7 @@ void vtkDecimatePro::InitializeQueue(vtkIdType numPts)
     numPts = static_cast<vtkIdType>(numPts*1.25);
     }
 
-  this->Queue = vtkPriorityQueue::New();
+  this->Queue = vtkIndexedPriorityQueue::New();
   this->Queue->Allocate(numPts, static_cast<vtkIdType>(0.25*numPts));
 }
 
@@ -1572,7 +1571,8 @@ int vtkDecimatePro::Pop(double &error)
 }
 
 //----------------------------------------------------------------------------
-// Computes error and inserts point into priority queue.
+// Computes error and inserts point into priority queue. A point already in
+// the queue has its priority updated in place.
 void vtkDecimatePro::Insert(vtkIdType ptId, double error)
 {
   int type, simpleType;
@@ -1621,18 +1621,27 @@ void vtkDecimatePro::Insert(vtkIdType ptId, double error)
           {
             error += this->VertexError->GetValue(ptId);
           }
-        this->Queue->Insert(error,ptId);
+        this->Queue->SetPriority(ptId,error);
         }
 
       // Type is complex so we break it up (if splitting allowed). A 
       // side-effect of splitting a vertex is that it inserts it and any 
       // new vertices into queue.
-      else if ( this->SplitState == VTK_STATE_SPLIT && type != VTK_DEGENERATE_VERTEX )
+      else
         {
-        this->SplitVertex(ptId, type, ncells, cells, 1);
+        // a vertex already queued loses its old priority
+        this->Queue->DeleteId(ptId);
+        if ( this->SplitState == VTK_STATE_SPLIT && type != VTK_DEGENERATE_VERTEX )
+          {
+          this->SplitVertex(ptId, type, ncells, cells, 1);
+          }
         } //not a simple type
 
       } //if cells attached to vertex
+    else
+      {
+      this->Queue->DeleteId(ptId);
+      }
     } //need to compute the error
 
   // If point is being recycled, see whether we want to split it
@@ -1658,7 +1667,7 @@ void vtkDecimatePro::Insert(vtkIdType ptId, double error)
       {
         error += this->VertexError->GetValue(ptId);
       }
-    this->Queue->Insert(error,ptId);
+    this->Queue->SetPriority(ptId,error);
     }
 }
 
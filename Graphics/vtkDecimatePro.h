@@ -81,7 +81,7 @@
 #include "vtkCell.h" // Needed for VTK_CELL_SIZE
 
 class vtkDoubleArray;
-class vtkPriorityQueue;
+class vtkIndexedPriorityQueue;
 
 class VTK_GRAPHICS_EXPORT vtkDecimatePro : public vtkPolyDataAlgorithm
 {
@@ -251,7 +251,7 @@ protected:
 
   // to replace a static object
   vtkIdList *Neighbors;
-  vtkPriorityQueue *EdgeLengths;
+  vtkIndexedPriorityQueue *EdgeLengths;
 
   void SplitMesh();
   int EvaluateVertex(vtkIdType ptId, unsigned short int numTris,
@@ -348,7 +348,7 @@ private:
   double DeleteId(vtkIdType id);
   void Reset();
 
-  vtkPriorityQueue *Queue;
+  vtkIndexedPriorityQueue *Queue;
   vtkDoubleArray *VertexError;
 
   VertexArray *V;
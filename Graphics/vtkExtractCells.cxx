@@ -25,11 +25,11 @@
 #include "vtkUnsignedCharArray.h"
 #include "vtkUnstructuredGrid.h"
 #include "vtkModelMetadata.h"
+#include "vtkMultiThreader.h"
 #include "vtkCell.h"
 #include "vtkPoints.h"
 #include "vtkPointData.h"
 #include "vtkCellData.h"
-#include "vtkIntArray.h"
 #include "vtkInformation.h"
 #include "vtkInformationVector.h"
 #include "vtkObjectFactory.h"
@@ -37,7 +37,7 @@
 vtkStandardNewMacro(vtkExtractCells);
 
 #include <vtkstd/set>
-#include <vtkstd/algorithm>
+#include <vtkstd/vector>
 
 class vtkExtractCellsSTLCloak
 {
@@ -48,7 +48,6 @@ public:
 //----------------------------------------------------------------------------
 vtkExtractCells::vtkExtractCells()
 { 
-  this->SubSetUGridCellArraySize = 0;
   this->InputIsUgrid = 0;
   this->CellList = new vtkExtractCellsSTLCloak;
 }
@@ -183,49 +182,40 @@ int vtkExtractCells::RequestData(
 
     return 1;
     }
-  vtkPointData *newPD = output->GetPointData();
-  vtkCellData *newCD  = output->GetCellData();
-
-  vtkIdList *ptIdMap = reMapPointIds(input);
-
-  vtkIdType numPoints = ptIdMap->GetNumberOfIds();
-
-  newPD->CopyGlobalIdsOn();
-  newPD->CopyAllocate(PD, numPoints);
-
-  newCD->CopyGlobalIdsOn();
-  newCD->CopyAllocate(CD, numCells);
 
-  vtkPoints *pts = vtkPoints::New();
-  if(vtkPointSet* inputPS = vtkPointSet::SafeDownCast(input))
+  // Skip the ids which are not in the input.
+  vtkstd::vector<unsigned char> cellMask(numCellsInput + 1, 0);
+  vtkstd::set<vtkIdType>::iterator cellPtr;
+  for (cellPtr = this->CellList->IdTypeSet.begin();
+       cellPtr != this->CellList->IdTypeSet.end() && *cellPtr < numCellsInput;
+       ++cellPtr)
     {
-    // preserve input datatype
-    pts->SetDataType(inputPS->GetPoints()->GetDataType());
+    if (*cellPtr >= 0)
+      {
+      cellMask[*cellPtr] = 1;
+      }
     }
-  pts->SetNumberOfPoints(numPoints);
 
-  for (vtkIdType newId =0; newId<numPoints; newId++)  
+  int pointsDataType = VTK_FLOAT;
+  vtkPointSet *inputPS = vtkPointSet::SafeDownCast(input);
+  if (inputPS && inputPS->GetPoints())
     {
-    vtkIdType oldId = ptIdMap->GetId(newId);
-
-    pts->SetPoint(newId, input->GetPoint(oldId));
-
-    newPD->CopyData(PD, oldId, newId);
+    // preserve input datatype
+    pointsDataType = inputPS->GetPoints()->GetDataType();
     }
 
-  output->SetPoints(pts);
-  pts->Delete();
-
-  if (this->InputIsUgrid)  
-    {
-    this->CopyCellsUnstructuredGrid(ptIdMap, input, output);
-    }
-  else  
+  // We only create vtkOriginalCellIds for the output data set if it does not
+  // exist in the input data set.  If it is in the input data set then we
+  // let CopyData() take care of copying it over.
+  vtkIdTypeArray *origMap = vtkIdTypeArray::New();
+  vtkExtractCells::ExtractMaskedCells(input, &cellMask[0], output,
+                                      pointsDataType, origMap);
+  if (CD->GetArray("vtkOriginalCellIds") == 0)
     {
-    this->CopyCellsDataSet(ptIdMap, input, output);
+    origMap->SetName("vtkOriginalCellIds");
+    output->GetCellData()->AddArray(origMap);
     }
-
-  ptIdMap->Delete();
+  origMap->Delete();
 
   output->Squeeze();
 
@@ -361,298 +351,348 @@ void vtkExtractCells::Copy(vtkDataSet *input, vtkUnstructuredGrid *output)
 }
 
 //----------------------------------------------------------------------------
-vtkIdType vtkExtractCells::findInSortedList(vtkIdList *idList, vtkIdType id)
+// Extraction of the masked cells. The cells are split in one range per
+// thread, and the points in as many ranges. The passes are:
+//   1. count the kept cells and their connectivity size in each cell range,
+//      and flag the points they use;
+//   2. count the flagged points in each point range;
+//   3. number the flagged points in increasing id order;
+//   4. write the types, locations and renumbered connectivity of the kept
+//      cells, each cell range starting at the offsets summed from pass 1;
+//   5. copy the coordinates of the kept points (point sets only: the
+//      other data sets compute their points in a shared buffer).
+// Between the passes, the per-range counts are summed into offsets.
+#define VTK_EXTRACT_CELLS_CELLS_PER_THREAD 50000
+
+class vtkExtractCellsBuilder
 {
-  vtkIdType numids = idList->GetNumberOfIds();
-
-  if (numids < 8) return idList->IsId(id);
-
-  int L, R, M;
-  L=0;
-  R=numids-1;
-
-  vtkIdType *ids = idList->GetPointer(0);
-
-  int loc = -1;
-
-  while (R > L)  
+public:
+  vtkDataSet *Input;
+  const unsigned char *Mask;
+  vtkIdType NumberOfCells;
+  vtkIdType NumberOfPoints;
+  int NumberOfThreads;
+  int Pass;
+
+  // Flag, then new id (or -1) of each input point.
+  vtkIdType *PointMap;
+  // Input id of each kept point.
+  vtkIdType *KeptPoints;
+  vtkPoints *InputPoints;
+  vtkPoints *NewPoints;
+
+  // Per range counts, turned into offsets before the fill passes.
+  vtkstd::vector<vtkIdType> CellOffsets;
+  vtkstd::vector<vtkIdType> ConnectivityOffsets;
+  vtkstd::vector<vtkIdType> PointOffsets;
+
+  unsigned char *Types;
+  vtkIdType *Locations;
+  vtkIdType *Connectivity;
+  vtkIdType *CellIds;
+
+  void Execute(int pass);
+  void Run(int range);
+
+  static VTK_THREAD_RETURN_TYPE ThreadedExecute(void *arg)
     {
-    if (R == L+1)  
-      {
-      if (ids[R] == id)  
-        {
-        loc = R;
-        }
-      else if (ids[L] == id)  
-        {
-        loc = L;
-        }
-      break;
-      }
-
-    M = (R + L) / 2;
-
-    if (ids[M] > id)  
-      {
-      R = M;
-      continue;
-      }
-    else if (ids[M] < id)  
-      {
-      L = M;
-      continue;
-      }
-    else  
-      {
-      loc = M;
-      break;
-      }
+    vtkMultiThreader::ThreadInfo *info =
+      static_cast<vtkMultiThreader::ThreadInfo*>(arg);
+    static_cast<vtkExtractCellsBuilder*>(info->UserData)->Run(info->ThreadID);
+    return VTK_THREAD_RETURN_VALUE;
     }
-  return loc;
-}
+};
 
 //----------------------------------------------------------------------------
-vtkIdList *vtkExtractCells::reMapPointIds(vtkDataSet *grid)
+void vtkExtractCellsBuilder::Execute(int pass)
 {
-  int totalPoints = grid->GetNumberOfPoints();
-
-  char *temp = new char [totalPoints];
-
-  if (!temp)  
+  this->Pass = pass;
+  if (this->NumberOfThreads <= 1)
     {
-    vtkErrorMacro(<< "vtkExtractCells::reMapPointIds memory allocation");
-    return NULL;
+    this->Run(0);
+    return;
     }
-  memset(temp, 0, totalPoints);
+  vtkMultiThreader *threader = vtkMultiThreader::New();
+  threader->SetNumberOfThreads(this->NumberOfThreads);
+  threader->SetSingleMethod(vtkExtractCellsBuilder::ThreadedExecute, this);
+  threader->SingleMethodExecute();
+  threader->Delete();
+}
 
-  int numberOfIds = 0;
-  int i;
-  vtkIdType id;
+//----------------------------------------------------------------------------
+void vtkExtractCellsBuilder::Run(int range)
+{
+  vtkIdType numThreads = this->NumberOfThreads;
+  vtkIdType beginCell = this->NumberOfCells * range / numThreads;
+  vtkIdType endCell = this->NumberOfCells * (range + 1) / numThreads;
+  vtkIdType beginPt = this->NumberOfPoints * range / numThreads;
+  vtkIdType endPt = this->NumberOfPoints * (range + 1) / numThreads;
   vtkIdList *ptIds = vtkIdList::New();
-  vtkstd::set<vtkIdType>::iterator cellPtr;
+  vtkIdType cellId, ptId, i, npts;
 
-  if (!this->InputIsUgrid)  
+  switch (this->Pass)
     {
-    for (cellPtr = this->CellList->IdTypeSet.begin(); 
-         cellPtr != this->CellList->IdTypeSet.end();
-         ++cellPtr)
+    case 1:
       {
-      grid->GetCellPoints(*cellPtr, ptIds);
-
-      vtkIdType nIds = ptIds->GetNumberOfIds();
-
-      vtkIdType *ptId = ptIds->GetPointer(0);
-
-      for (i=0; i<nIds; i++)  
+      vtkIdType numCells = 0, connSize = 0;
+      for (cellId = beginCell; cellId < endCell; cellId++)
         {
-        id = *ptId++;
-
-        if (temp[id] == 0)  
+        if (!this->Mask[cellId])
+          {
+          continue;
+          }
+        this->Input->GetCellPoints(cellId, ptIds);
+        npts = ptIds->GetNumberOfIds();
+        numCells++;
+        connSize += npts + 1;
+        for (i = 0; i < npts; i++)
           {
-          numberOfIds++;
-          temp[id] = 1;
+          // Threads sharing a point all write the same value.
+          this->PointMap[ptIds->GetId(i)] = 1;
           }
         }
+      this->CellOffsets[range] = numCells;
+      this->ConnectivityOffsets[range] = connSize;
       }
-    }
-  else  
-    {
-    vtkUnstructuredGrid *ugrid = vtkUnstructuredGrid::SafeDownCast(grid);
-  
-    this->SubSetUGridCellArraySize = 0;
-  
-    vtkIdType *cellArray = ugrid->GetCells()->GetPointer();
-    vtkIdType *locs = ugrid->GetCellLocationsArray()->GetPointer(0);
-
-    this->SubSetUGridCellArraySize = 0;
-    vtkIdType maxid = ugrid->GetCellLocationsArray()->GetMaxId();
-         
-    for (cellPtr = this->CellList->IdTypeSet.begin(); 
-         cellPtr != this->CellList->IdTypeSet.end();
-         ++cellPtr)  
-      {
-      if (*cellPtr > maxid) continue;
-        
-      int loc = locs[*cellPtr];
+      break;
 
-      vtkIdType nIds = cellArray[loc++];
+    case 2:
+      {
+      vtkIdType numPts = 0;
+      for (ptId = beginPt; ptId < endPt; ptId++)
+        {
+        numPts += (this->PointMap[ptId] != 0);
+        }
+      this->PointOffsets[range] = numPts;
+      }
+      break;
 
-      this->SubSetUGridCellArraySize += (1 + nIds);
-        
-      for (i=0; i<nIds; i++)  
+    case 3:
+      {
+      vtkIdType newId = this->PointOffsets[range];
+      for (ptId = beginPt; ptId < endPt; ptId++)
         {
-        id = cellArray[loc++];
-          
-        if (temp[id] == 0)  
+        if (this->PointMap[ptId])
+          {
+          this->KeptPoints[newId] = ptId;
+          this->PointMap[ptId] = newId++;
+          }
+        else
           {
-          numberOfIds++;
-          temp[id] = 1;
+          this->PointMap[ptId] = -1;
           }
         }
       }
-    }
-
-  ptIds->SetNumberOfIds(numberOfIds);
-  int next=0;
-    
-  for (id=0; id<totalPoints; id++)  
-    {
-    if (temp[id]) ptIds->SetId(next++, id);
-    } 
-
-  delete [] temp;
-
-  return ptIds;
-}
-
-//----------------------------------------------------------------------------
-void vtkExtractCells::CopyCellsDataSet(vtkIdList *ptMap, vtkDataSet *input,
-                                       vtkUnstructuredGrid *output)
-{ 
-  output->Allocate(this->CellList->IdTypeSet.size());
-
-  vtkCellData *oldCD = input->GetCellData();
-  vtkCellData *newCD = output->GetCellData();
-
-  // We only create vtkOriginalCellIds for the output data set if it does not
-  // exist in the input data set.  If it is in the input data set then we
-  // let CopyData() take care of copying it over.
-  vtkIdTypeArray *origMap = 0;
-  if(oldCD->GetArray("vtkOriginalCellIds") == 0)
-    {
-    origMap = vtkIdTypeArray::New();
-    origMap->SetNumberOfComponents(1);
-    origMap->SetName("vtkOriginalCellIds");
-    newCD->AddArray(origMap);
-    origMap->Delete();
-    }
-
-  vtkIdList *cellPoints = vtkIdList::New();
-
-  vtkstd::set<vtkIdType>::iterator cellPtr;
-
-  for (cellPtr = this->CellList->IdTypeSet.begin();
-       cellPtr != this->CellList->IdTypeSet.end(); 
-       ++cellPtr)  
-    {
-    vtkIdType cellId = *cellPtr;
-
-    input->GetCellPoints(cellId, cellPoints);
+      break;
 
-    for (int i=0; i < cellPoints->GetNumberOfIds(); i++)  
+    case 4:
       {
-      vtkIdType oldId = cellPoints->GetId(i);
-
-      vtkIdType newId = vtkExtractCells::findInSortedList(ptMap, oldId);
-
-      cellPoints->SetId(i, newId);
+      vtkIdType newCellId = this->CellOffsets[range];
+      vtkIdType loc = this->ConnectivityOffsets[range];
+      for (cellId = beginCell; cellId < endCell; cellId++)
+        {
+        if (!this->Mask[cellId])
+          {
+          continue;
+          }
+        this->Input->GetCellPoints(cellId, ptIds);
+        npts = ptIds->GetNumberOfIds();
+        this->Types[newCellId] =
+          static_cast<unsigned char>(this->Input->GetCellType(cellId));
+        this->Locations[newCellId] = loc;
+        this->CellIds[newCellId] = cellId;
+        this->Connectivity[loc++] = npts;
+        for (i = 0; i < npts; i++)
+          {
+          this->Connectivity[loc++] = this->PointMap[ptIds->GetId(i)];
+          }
+        newCellId++;
+        }
       }
-    int newId = output->InsertNextCell(input->GetCellType(cellId), cellPoints);
+      break;
 
-    newCD->CopyData(oldCD, cellId, newId);
-    if(origMap)
+    case 5:
       {
-      origMap->InsertNextValue(cellId);
+      double x[3];
+      for (i = this->PointOffsets[range];
+           i < this->PointOffsets[range + 1]; i++)
+        {
+        this->InputPoints->GetPoint(this->KeptPoints[i], x);
+        this->NewPoints->SetPoint(i, x);
+        }
       }
+      break;
     }
 
-  cellPoints->Delete();
-
-  return;
+  ptIds->Delete();
 }
 
 //----------------------------------------------------------------------------
-void vtkExtractCells::CopyCellsUnstructuredGrid(vtkIdList *ptMap,
-                                                vtkDataSet *input,
-                                                vtkUnstructuredGrid *output)
+// Turn per range counts into offsets, with the total at the end.
+static void vtkExtractCellsSumOffsets(vtkstd::vector<vtkIdType> &counts)
 {
-  vtkUnstructuredGrid *ugrid = vtkUnstructuredGrid::SafeDownCast(input);
-  if (ugrid == NULL)  
+  vtkIdType sum = 0;
+  for (size_t i = 0; i < counts.size(); i++)
     {
-    this->CopyCellsDataSet(ptMap, input, output);
-    return;
+    vtkIdType count = counts[i];
+    counts[i] = sum;
+    sum += count;
     }
+  counts.back() = sum;
+}
 
-  vtkCellData *oldCD = input->GetCellData();
-  vtkCellData *newCD = output->GetCellData();
-
-  // We only create vtkOriginalCellIds for the output data set if it does not
-  // exist in the input data set.  If it is in the input data set then we
-  // let CopyData() take care of copying it over.
-  vtkIdTypeArray *origMap = 0;
-  if(oldCD->GetArray("vtkOriginalCellIds") == 0)
+//----------------------------------------------------------------------------
+void vtkExtractCells::ExtractMaskedCells(vtkDataSet *input,
+                                         const unsigned char *cellMask,
+                                         vtkUnstructuredGrid *output,
+                                         int pointsDataType,
+                                         vtkIdTypeArray *cellIds)
+{
+  vtkPointData *pd = input->GetPointData(), *outPD = output->GetPointData();
+  vtkCellData *cd = input->GetCellData(), *outCD = output->GetCellData();
+  vtkIdType numCells = input->GetNumberOfCells();
+  vtkIdType numPts = input->GetNumberOfPoints();
+
+  vtkExtractCellsBuilder builder;
+  builder.Input = input;
+  builder.Mask = cellMask;
+  builder.NumberOfCells = numCells;
+  builder.NumberOfPoints = numPts;
+
+  int numThreads = vtkMultiThreader::GetGlobalDefaultNumberOfThreads();
+  vtkIdType maxThreads = numCells / VTK_EXTRACT_CELLS_CELLS_PER_THREAD;
+  if (maxThreads < numThreads)
     {
-    origMap = vtkIdTypeArray::New();
-    origMap->SetNumberOfComponents(1);
-    origMap->SetName("vtkOriginalCellIds");
-    newCD->AddArray(origMap);
-    origMap->Delete();
+    numThreads = (maxThreads > 1 ? static_cast<int>(maxThreads) : 1);
     }
-      
-  int numCells = static_cast<int>(this->CellList->IdTypeSet.size());
-
-  vtkCellArray *cellArray = vtkCellArray::New();                 // output
-  vtkIdTypeArray *newcells = vtkIdTypeArray::New();
-  newcells->SetNumberOfValues(this->SubSetUGridCellArraySize);
-  cellArray->SetCells(numCells, newcells);
-  int cellArrayIdx = 0;
-
-  vtkIdTypeArray *locationArray = vtkIdTypeArray::New();
-  locationArray->SetNumberOfValues(numCells);
-
-  vtkUnsignedCharArray *typeArray = vtkUnsignedCharArray::New();
-  typeArray->SetNumberOfValues(numCells);
-
-  int nextCellId = 0;
-
-  vtkstd::set<vtkIdType>::iterator cellPtr;                           // input
-  vtkIdType *cells = ugrid->GetCells()->GetPointer();
-  vtkIdType maxid = ugrid->GetCellLocationsArray()->GetMaxId();
-  vtkIdType *locs = ugrid->GetCellLocationsArray()->GetPointer(0);
-  vtkUnsignedCharArray *types = ugrid->GetCellTypesArray();
-
-  for (cellPtr = this->CellList->IdTypeSet.begin();
-       cellPtr != this->CellList->IdTypeSet.end(); 
-       ++cellPtr)  
+  builder.NumberOfThreads = numThreads;
+  // The extra entry receives the totals.
+  builder.CellOffsets.resize(numThreads + 1, 0);
+  builder.ConnectivityOffsets.resize(numThreads + 1, 0);
+  builder.PointOffsets.resize(numThreads + 1, 0);
+
+  // These methods are thread safe once they have been called from a single
+  // thread (polydata for instance builds its cells on the first call).
+  if (numCells > 0)
     {
-    if (*cellPtr > maxid) continue;
-      
-    int oldCellId = *cellPtr;
-
-    int loc = locs[oldCellId];
-    int size = static_cast<int>(cells[loc]);
-    vtkIdType *pts = cells + loc + 1;
-    unsigned char type = types->GetValue(oldCellId);
-
-    locationArray->SetValue(nextCellId, cellArrayIdx);
-    typeArray->SetValue(nextCellId, type);
-
-    newcells->SetValue(cellArrayIdx++, size);
-
-    for (int i=0; i<size; i++)  
+    vtkIdList *ptIds = vtkIdList::New();
+    input->GetCellPoints(0, ptIds);
+    input->GetCellType(0);
+    ptIds->Delete();
+    }
+  vtkstd::vector<vtkIdType> pointMap(numPts + 1, 0);
+  builder.PointMap = &pointMap[0];
+  builder.Execute(1);
+  vtkExtractCellsSumOffsets(builder.CellOffsets);
+  vtkExtractCellsSumOffsets(builder.ConnectivityOffsets);
+  builder.Execute(2);
+  vtkExtractCellsSumOffsets(builder.PointOffsets);
+  vtkIdType numNewCells = builder.CellOffsets.back();
+  vtkIdType numNewPts = builder.PointOffsets.back();
+
+  vtkstd::vector<vtkIdType> keptPoints(numNewPts + 1);
+  builder.KeptPoints = &keptPoints[0];
+  builder.Execute(3);
+
+  vtkPoints *newPoints = vtkPoints::New();
+  newPoints->SetDataType(pointsDataType);
+  newPoints->SetNumberOfPoints(numNewPts);
+  vtkPointSet *inputPS = vtkPointSet::SafeDownCast(input);
+  if (inputPS && inputPS->GetPoints())
+    {
+    builder.InputPoints = inputPS->GetPoints();
+    builder.NewPoints = newPoints;
+    builder.Execute(5);
+    }
+  else
+    {
+    double x[3];
+    for (vtkIdType i = 0; i < numNewPts; i++)
       {
-      vtkIdType oldId = *pts++;
-      vtkIdType newId = vtkExtractCells::findInSortedList(ptMap, oldId);
-
-      newcells->SetValue(cellArrayIdx++, newId);
+      input->GetPoint(keptPoints[i], x);
+      newPoints->SetPoint(i, x);
       }
+    }
+  output->SetPoints(newPoints);
+  newPoints->Delete();
 
-    newCD->CopyData(oldCD, oldCellId, nextCellId);
-    if(origMap)
+  outPD->CopyGlobalIdsOn();
+  outPD->CopyAllocate(pd, numNewPts);
+  outPD->CopyData(pd, numNewPts, builder.KeptPoints, 0);
+
+  vtkIdTypeArray *keptCells = cellIds;
+  if (keptCells)
+    {
+    keptCells->Register(0);
+    }
+  else
+    {
+    keptCells = vtkIdTypeArray::New();
+    }
+  keptCells->SetNumberOfComponents(1);
+  keptCells->SetNumberOfTuples(numNewCells);
+
+  // Polyhedra carry a face stream besides their points: insert them one at
+  // a time.
+  vtkUnstructuredGrid *ugrid = vtkUnstructuredGrid::SafeDownCast(input);
+  if (ugrid && ugrid->GetFaces())
+    {
+    vtkIdList *ptIds = vtkIdList::New();
+    output->Allocate(numNewCells);
+    vtkIdType newCellId = 0;
+    for (vtkIdType cellId = 0; cellId < numCells; cellId++)
       {
-      origMap->InsertNextValue(oldCellId);
+      if (!cellMask[cellId])
+        {
+        continue;
+        }
+      int cellType = ugrid->GetCellType(cellId);
+      if (cellType == VTK_POLYHEDRON)
+        {
+        ugrid->GetFaceStream(cellId, ptIds);
+        vtkUnstructuredGrid::ConvertFaceStreamPointIds(ptIds,
+                                                       builder.PointMap);
+        }
+      else
+        {
+        ugrid->GetCellPoints(cellId, ptIds);
+        for (vtkIdType i = 0; i < ptIds->GetNumberOfIds(); i++)
+          {
+          ptIds->SetId(i, builder.PointMap[ptIds->GetId(i)]);
+          }
+        }
+      output->InsertNextCell(cellType, ptIds);
+      keptCells->SetValue(newCellId++, cellId);
       }
-    nextCellId++;
+    ptIds->Delete();
+    }
+  else
+    {
+    vtkUnsignedCharArray *types = vtkUnsignedCharArray::New();
+    types->SetNumberOfValues(numNewCells);
+    vtkIdTypeArray *locations = vtkIdTypeArray::New();
+    locations->SetNumberOfValues(numNewCells);
+    vtkIdTypeArray *connectivity = vtkIdTypeArray::New();
+    connectivity->SetNumberOfValues(builder.ConnectivityOffsets.back());
+    builder.Types = types->GetPointer(0);
+    builder.Locations = locations->GetPointer(0);
+    builder.Connectivity = connectivity->GetPointer(0);
+    builder.CellIds = keptCells->GetPointer(0);
+    builder.Execute(4);
+
+    vtkCellArray *cells = vtkCellArray::New();
+    cells->SetCells(numNewCells, connectivity);
+    output->SetCells(types, locations, cells);
+    types->Delete();
+    locations->Delete();
+    connectivity->Delete();
+    cells->Delete();
     }
 
-  output->SetCells(typeArray, locationArray, cellArray);
-
-  typeArray->Delete();
-  locationArray->Delete();
-  newcells->Delete();
-  cellArray->Delete();
-
-  return;
+  outCD->CopyGlobalIdsOn();
+  outCD->CopyAllocate(cd, numNewCells);
+  outCD->CopyData(cd, numNewCells, keptCells->GetPointer(0), 0);
+  keptCells->UnRegister(0);
 }
 
 //----------------------------------------------------------------------------
@@ -24,6 +24,11 @@
 //    composed of these cells.  If the cell list is empty when vtkExtractCells 
 //    executes, it will set up the ugrid, point and cell arrays, with no points, 
 //    cells or data.
+//
+//    The extraction first counts the kept cells and marks the points they
+//    use, then numbers the kept points and copies the cells, the points and
+//    their data. Each pass is split over several threads on large inputs.
+//    ExtractMaskedCells() makes this available to other extraction filters.
 
 #ifndef __vtkExtractCells_h
 #define __vtkExtractCells_h
@@ -31,6 +36,7 @@
 #include "vtkUnstructuredGridAlgorithm.h"
 
 class vtkIdList;
+class vtkIdTypeArray;
 class vtkExtractCellsSTLCloak;
 class vtkModelMetadata;
 
@@ -61,6 +67,22 @@ public:
 
   void AddCellRange(vtkIdType from, vtkIdType to);
 
+//BTX
+  // Description:
+  // Copy the cells of input whose entry in cellMask is not zero into
+  // output, in increasing id order, together with the points they use,
+  // also in increasing id order. The new points are stored with the given
+  // data type. The point and cell data are copied as with CopyAllocate()
+  // and CopyData(), global ids included. If cellIds is not NULL, it is
+  // filled with the input id of each output cell. Large inputs are
+  // processed by several threads.
+  static void ExtractMaskedCells(vtkDataSet *input,
+                                 const unsigned char *cellMask,
+                                 vtkUnstructuredGrid *output,
+                                 int pointsDataType,
+                                 vtkIdTypeArray *cellIds);
+//ETX
+
 protected:
 
   virtual int RequestData(vtkInformation *, vtkInformationVector **, vtkInformationVector *);
@@ -72,19 +94,11 @@ protected:
 private:
 
   void Copy(vtkDataSet *input, vtkUnstructuredGrid *output);
-  static vtkIdType findInSortedList(vtkIdList *idList, vtkIdType id);
-  vtkIdList *reMapPointIds(vtkDataSet *grid);
 
   vtkModelMetadata *ExtractMetadata(vtkDataSet *input);
 
-  void CopyCellsDataSet(vtkIdList *ptMap, vtkDataSet *input,
-                        vtkUnstructuredGrid *output);
-  void CopyCellsUnstructuredGrid(vtkIdList *ptMap, vtkDataSet *input,
-                                 vtkUnstructuredGrid *output);
-
   vtkExtractCellsSTLCloak *CellList;
 
-  int SubSetUGridCellArraySize;
   char InputIsUgrid;
 
   vtkExtractCells(const vtkExtractCells&); // Not implemented
@@ -0,0 +1,555 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkPartitionedQuadricDecimation.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+#include "vtkPartitionedQuadricDecimation.h"
+
+#include "vtkCellArray.h"
+#include "vtkDataArray.h"
+#include "vtkIdTypeArray.h"
+#include "vtkInformation.h"
+#include "vtkInformationVector.h"
+#include "vtkKdTree.h"
+#include "vtkMath.h"
+#include "vtkMultiThreader.h"
+#include "vtkObjectFactory.h"
+#include "vtkPointData.h"
+#include "vtkPoints.h"
+#include "vtkPolyData.h"
+
+#include <vtkstd/vector>
+
+vtkStandardNewMacro(vtkPartitionedQuadricDecimation);
+
+// Below this many triangles per thread, fewer pieces are used.
+#define VTK_PARTITIONED_QUADRIC_DECIMATION_TRIS_PER_THREAD 100000
+
+//----------------------------------------------------------------------------
+// A piece of the mesh, decimated by its own worker filter.
+struct vtkPartitionedQuadricDecimationPiece
+{
+  vtkPolyData *Input;
+  // Global id of each point of Input, and whether it is locked.
+  vtkstd::vector<vtkIdType> GlobalIds;
+  vtkstd::vector<unsigned char> Locked;
+  vtkPartitionedQuadricDecimation *Worker;
+  vtkIdType NumberOfDeletedTriangles;
+};
+
+//----------------------------------------------------------------------------
+// The pieces being decimated. A friend of vtkPartitionedQuadricDecimation
+// so that it can drive the decimation of each worker.
+class vtkPartitionedQuadricDecimationPieces
+{
+public:
+  vtkPartitionedQuadricDecimationPieces(vtkPoints *points, vtkPointData *pd)
+    {
+    this->Points = points;
+    this->PointData = pd;
+    this->LocalIds.resize(points->GetNumberOfPoints(), -1);
+    }
+
+  ~vtkPartitionedQuadricDecimationPieces()
+    {
+    for (size_t i = 0; i < this->Pieces.size(); i++)
+      {
+      this->Pieces[i].Input->Delete();
+      this->Pieces[i].Worker->Delete();
+      }
+    }
+
+  void AddPiece(const vtkIdType *tris, const vtkIdType *triIds,
+                vtkIdType numTris, const unsigned char *locked,
+                vtkPartitionedQuadricDecimation *parent, double reduction);
+  void DecimatePiece(size_t i);
+  vtkIdType MergePiece(size_t i, vtkstd::vector<vtkIdType> &tris);
+
+  vtkstd::vector<vtkPartitionedQuadricDecimationPiece> Pieces;
+
+protected:
+  vtkPoints *Points;
+  vtkPointData *PointData;
+  // Scratch map from global to piece point ids, all -1 between pieces.
+  vtkstd::vector<vtkIdType> LocalIds;
+};
+
+//----------------------------------------------------------------------------
+// Make a piece out of the triangles listed in triIds (or of the first
+// numTris triangles when triIds is NULL). Empty pieces are skipped.
+void vtkPartitionedQuadricDecimationPieces::AddPiece(
+  const vtkIdType *tris, const vtkIdType *triIds, vtkIdType numTris,
+  const unsigned char *locked, vtkPartitionedQuadricDecimation *parent,
+  double reduction)
+{
+  if ( numTris <= 0 )
+    {
+    return;
+    }
+
+  vtkPartitionedQuadricDecimationPiece piece;
+  vtkCellArray *polys = vtkCellArray::New();
+  polys->Allocate(4*numTris);
+  vtkIdType i, pts[3];
+  int j;
+  for (i = 0; i < numTris; i++)
+    {
+    const vtkIdType *tri = tris + 3*(triIds ? triIds[i] : i);
+    for (j = 0; j < 3; j++)
+      {
+      if ( this->LocalIds[tri[j]] < 0 )
+        {
+        this->LocalIds[tri[j]] =
+          static_cast<vtkIdType>(piece.GlobalIds.size());
+        piece.GlobalIds.push_back(tri[j]);
+        piece.Locked.push_back(locked[tri[j]]);
+        }
+      pts[j] = this->LocalIds[tri[j]];
+      }
+    polys->InsertNextCell(3, pts);
+    }
+
+  vtkIdType numPts = static_cast<vtkIdType>(piece.GlobalIds.size());
+  vtkPoints *points = vtkPoints::New(this->Points->GetDataType());
+  points->SetNumberOfPoints(numPts);
+  for (i = 0; i < numPts; i++)
+    {
+    points->SetPoint(i, this->Points->GetPoint(piece.GlobalIds[i]));
+    this->LocalIds[piece.GlobalIds[i]] = -1;
+    }
+
+  piece.Input = vtkPolyData::New();
+  piece.Input->SetPoints(points);
+  piece.Input->SetPolys(polys);
+  points->Delete();
+  polys->Delete();
+
+  // The arrays of the piece match those of PointData one to one, so that
+  // they can be merged back by index.
+  if ( this->PointData )
+    {
+    vtkPointData *pd = piece.Input->GetPointData();
+    for (int a = 0; a < this->PointData->GetNumberOfArrays(); a++)
+      {
+      vtkAbstractArray *from = this->PointData->GetAbstractArray(a);
+      vtkAbstractArray *to = from->NewInstance();
+      to->SetNumberOfComponents(from->GetNumberOfComponents());
+      to->SetName(from->GetName());
+      to->SetNumberOfTuples(numPts);
+      for (i = 0; i < numPts; i++)
+        {
+        to->SetTuple(i, piece.GlobalIds[i], from);
+        }
+      int idx = pd->AddArray(to);
+      to->Delete();
+      int attribute = this->PointData->IsArrayAnAttribute(a);
+      if ( attribute >= 0 )
+        {
+        pd->SetActiveAttribute(idx, attribute);
+        }
+      }
+    }
+
+  piece.Worker = vtkPartitionedQuadricDecimation::New();
+  parent->CopyParameters(piece.Worker);
+  piece.Worker->SetTargetReduction(reduction);
+  piece.NumberOfDeletedTriangles = 0;
+  this->Pieces.push_back(piece);
+}
+
+//----------------------------------------------------------------------------
+void vtkPartitionedQuadricDecimationPieces::DecimatePiece(size_t i)
+{
+  vtkPartitionedQuadricDecimationPiece &piece = this->Pieces[i];
+  piece.Worker->LockedPoints = &piece.Locked[0];
+  piece.NumberOfDeletedTriangles = piece.Worker->Decimate(piece.Input);
+  piece.Worker->LockedPoints = NULL;
+}
+
+//----------------------------------------------------------------------------
+// Append the remaining triangles of piece i to tris, in global ids, and
+// copy the new position and attributes of its points. Returns the number
+// of triangles deleted from the piece.
+vtkIdType vtkPartitionedQuadricDecimationPieces::MergePiece(
+  size_t i, vtkstd::vector<vtkIdType> &tris)
+{
+  vtkPartitionedQuadricDecimationPiece &piece = this->Pieces[i];
+  vtkPolyData *mesh = piece.Worker->Mesh;
+  vtkIdType cellId, npts, *pts;
+  for (cellId = 0; cellId < mesh->GetNumberOfCells(); cellId++)
+    {
+    if ( mesh->GetCellType(cellId) != VTK_EMPTY_CELL )
+      {
+      mesh->GetCellPoints(cellId, npts, pts);
+      for (int j = 0; j < 3; j++)
+        {
+        tris.push_back(piece.GlobalIds[pts[j]]);
+        }
+      }
+    }
+
+  vtkIdType numPts = static_cast<vtkIdType>(piece.GlobalIds.size());
+  vtkIdType ptId;
+  for (ptId = 0; ptId < numPts; ptId++)
+    {
+    if ( !piece.Locked[ptId] )
+      {
+      this->Points->SetPoint(piece.GlobalIds[ptId],
+                             mesh->GetPoints()->GetPoint(ptId));
+      }
+    }
+  if ( this->PointData )
+    {
+    vtkPointData *pd = mesh->GetPointData();
+    for (int a = 0; a < this->PointData->GetNumberOfArrays(); a++)
+      {
+      vtkAbstractArray *to = this->PointData->GetAbstractArray(a);
+      vtkAbstractArray *from = pd->GetAbstractArray(a);
+      for (ptId = 0; ptId < numPts; ptId++)
+        {
+        if ( !piece.Locked[ptId] )
+          {
+          to->SetTuple(piece.GlobalIds[ptId], ptId, from);
+          }
+        }
+      }
+    }
+
+  mesh->DeleteLinks();
+  mesh->Delete();
+  piece.Worker->Mesh = NULL;
+  return piece.NumberOfDeletedTriangles;
+}
+
+//----------------------------------------------------------------------------
+static VTK_THREAD_RETURN_TYPE vtkPartitionedQuadricDecimationThread(void *arg)
+{
+  vtkMultiThreader::ThreadInfo *info =
+    static_cast<vtkMultiThreader::ThreadInfo*>(arg);
+  vtkPartitionedQuadricDecimationPieces *pieces =
+    static_cast<vtkPartitionedQuadricDecimationPieces*>(info->UserData);
+
+  // The k-d tree balances the pieces, so deal them out in turn.
+  for (size_t i = info->ThreadID; i < pieces->Pieces.size();
+       i += info->NumberOfThreads)
+    {
+    pieces->DecimatePiece(i);
+    }
+  return VTK_THREAD_RETURN_VALUE;
+}
+
+//----------------------------------------------------------------------------
+vtkPartitionedQuadricDecimation::vtkPartitionedQuadricDecimation()
+{
+  this->NumberOfPieces = 0;
+}
+
+//----------------------------------------------------------------------------
+vtkPartitionedQuadricDecimation::~vtkPartitionedQuadricDecimation()
+{
+}
+
+//----------------------------------------------------------------------------
+void vtkPartitionedQuadricDecimation::CopyParameters(
+  vtkPartitionedQuadricDecimation *worker)
+{
+  worker->TargetReduction = this->TargetReduction;
+  worker->AttributeErrorMetric = this->AttributeErrorMetric;
+  worker->ScalarsAttribute = this->ScalarsAttribute;
+  worker->VectorsAttribute = this->VectorsAttribute;
+  worker->NormalsAttribute = this->NormalsAttribute;
+  worker->TCoordsAttribute = this->TCoordsAttribute;
+  worker->TensorsAttribute = this->TensorsAttribute;
+  worker->ScalarsWeight = this->ScalarsWeight;
+  worker->VectorsWeight = this->VectorsWeight;
+  worker->NormalsWeight = this->NormalsWeight;
+  worker->TCoordsWeight = this->TCoordsWeight;
+  worker->TensorsWeight = this->TensorsWeight;
+}
+
+//----------------------------------------------------------------------------
+int vtkPartitionedQuadricDecimation::RequestData(
+  vtkInformation *request,
+  vtkInformationVector **inputVector,
+  vtkInformationVector *outputVector)
+{
+  // get the info objects
+  vtkInformation *inInfo = inputVector[0]->GetInformationObject(0);
+  vtkInformation *outInfo = outputVector->GetInformationObject(0);
+
+  // get the input and output
+  vtkPolyData *input = vtkPolyData::SafeDownCast(
+    inInfo->Get(vtkDataObject::DATA_OBJECT()));
+  vtkPolyData *output = vtkPolyData::SafeDownCast(
+    outInfo->Get(vtkDataObject::DATA_OBJECT()));
+
+  if (input->GetPolys() == NULL || input->GetPoints() == NULL)
+    {
+    vtkErrorMacro("Nothing to decimate");
+    return 1;
+    }
+  if (input->GetPolys()->GetMaxCellSize() > 3)
+    {
+    vtkErrorMacro("Can only decimate triangles");
+    return 1;
+    }
+
+  vtkIdType numPts = input->GetNumberOfPoints();
+  vtkIdType numTris = input->GetNumberOfPolys();
+  int numThreads = vtkMultiThreader::GetGlobalDefaultNumberOfThreads();
+  int numPieces = this->NumberOfPieces;
+  if ( numPieces == 0 )
+    {
+    vtkIdType maxPieces =
+      numTris / VTK_PARTITIONED_QUADRIC_DECIMATION_TRIS_PER_THREAD;
+    numPieces = (maxPieces < numThreads ? static_cast<int>(maxPieces) :
+                 numThreads);
+    }
+  if ( numPieces <= 1 )
+    {
+    return this->Superclass::RequestData(request, inputVector, outputVector);
+    }
+
+  // Gather the triangles and their centroids.
+  vtkstd::vector<vtkIdType> tris;
+  tris.reserve(3*numTris);
+  vtkPoints *centroids = vtkPoints::New();
+  centroids->Allocate(numTris);
+  vtkCellArray *inPolys = input->GetPolys();
+  vtkIdType npts, *pts, i;
+  double x[3], c[3];
+  int j;
+  for (inPolys->InitTraversal(); inPolys->GetNextCell(npts, pts); )
+    {
+    if ( npts != 3 )
+      {
+      continue;
+      }
+    c[0] = c[1] = c[2] = 0.0;
+    for (j = 0; j < 3; j++)
+      {
+      tris.push_back(pts[j]);
+      input->GetPoint(pts[j], x);
+      c[0] += x[0]; c[1] += x[1]; c[2] += x[2];
+      }
+    centroids->InsertNextPoint(c[0]/3.0, c[1]/3.0, c[2]/3.0);
+    }
+  numTris = static_cast<vtkIdType>(tris.size()/3);
+
+  vtkKdTree *kdTree = vtkKdTree::New();
+  kdTree->SetNumberOfRegionsOrMore(numPieces);
+  if ( numTris > 0 )
+    {
+    kdTree->BuildLocatorFromPoints(centroids);
+    }
+  centroids->Delete();
+  int numRegions = kdTree->GetNumberOfRegions();
+  if ( numRegions <= 1 )
+    {
+    kdTree->Delete();
+    return this->Superclass::RequestData(request, inputVector, outputVector);
+    }
+
+  // Lock the points shared by pieces.
+  vtkstd::vector<vtkIdTypeArray*> regionTris(numRegions);
+  vtkstd::vector<int> pointRegion(numPts, -1);
+  vtkstd::vector<unsigned char> locked(numPts, 0);
+  int r;
+  for (r = 0; r < numRegions; r++)
+    {
+    regionTris[r] = kdTree->GetPointsInRegion(r);
+    for (i = 0; i < regionTris[r]->GetNumberOfTuples(); i++)
+      {
+      const vtkIdType *tri = &tris[3*regionTris[r]->GetValue(i)];
+      for (j = 0; j < 3; j++)
+        {
+        if ( pointRegion[tri[j]] < 0 )
+          {
+          pointRegion[tri[j]] = r;
+          }
+        else if ( pointRegion[tri[j]] != r )
+          {
+          locked[tri[j]] = 1;
+          }
+        }
+      }
+    }
+  kdTree->Delete();
+  vtkstd::vector<int>().swap(pointRegion);
+
+  // Work on copies of the points and, if they take part in the error
+  // metric, of the point attributes.
+  vtkPoints *points = vtkPoints::New(input->GetPoints()->GetDataType());
+  points->DeepCopy(input->GetPoints());
+  vtkPointData *pointData = NULL;
+  if ( this->AttributeErrorMetric )
+    {
+    pointData = vtkPointData::New();
+    pointData->DeepCopy(input->GetPointData());
+    }
+
+  vtkPartitionedQuadricDecimationPieces *pieces =
+    new vtkPartitionedQuadricDecimationPieces(points, pointData);
+  for (r = 0; r < numRegions; r++)
+    {
+    pieces->AddPiece(&tris[0], regionTris[r]->GetPointer(0),
+                     regionTris[r]->GetNumberOfTuples(), &locked[0], this,
+                     this->TargetReduction);
+    regionTris[r]->Delete();
+    }
+  this->UpdateProgress(0.1);
+
+  int numPiecesMade = static_cast<int>(pieces->Pieces.size());
+  if ( numThreads > numPiecesMade )
+    {
+    numThreads = numPiecesMade;
+    }
+  if ( numThreads > 1 )
+    {
+    vtkMultiThreader *threader = vtkMultiThreader::New();
+    threader->SetNumberOfThreads(numThreads);
+    threader->SetSingleMethod(vtkPartitionedQuadricDecimationThread, pieces);
+    threader->SingleMethodExecute();
+    threader->Delete();
+    }
+  else
+    {
+    for (r = 0; r < numPiecesMade; r++)
+      {
+      pieces->DecimatePiece(r);
+      }
+    }
+  this->UpdateProgress(0.8);
+
+  vtkstd::vector<vtkIdType> decimatedTris;
+  decimatedTris.reserve(tris.size());
+  vtkIdType numDeletedTris = 0;
+  for (r = 0; r < numPiecesMade; r++)
+    {
+    numDeletedTris += pieces->MergePiece(r, decimatedTris);
+    }
+  delete pieces;
+  tris.swap(decimatedTris);
+  vtkstd::vector<vtkIdType>().swap(decimatedTris);
+
+  // The seams: the points locked so far and their neighbors are free to
+  // move now, and the triangles using them are decimated further with the
+  // rest of the mesh locked.
+  vtkIdType numTarget = static_cast<vtkIdType>(this->TargetReduction*numTris);
+  vtkIdType numLeft = static_cast<vtkIdType>(tris.size()/3);
+  if ( numDeletedTris < numTarget )
+    {
+    vtkstd::vector<unsigned char> seamLocked(numPts, 1);
+    for (i = 0; i < numLeft; i++)
+      {
+      const vtkIdType *tri = &tris[3*i];
+      if ( locked[tri[0]] || locked[tri[1]] || locked[tri[2]] )
+        {
+        seamLocked[tri[0]] = seamLocked[tri[1]] = seamLocked[tri[2]] = 0;
+        }
+      }
+    vtkstd::vector<vtkIdType> seamTris;
+    vtkstd::vector<vtkIdType> otherTris;
+    otherTris.reserve(tris.size());
+    for (i = 0; i < numLeft; i++)
+      {
+      const vtkIdType *tri = &tris[3*i];
+      if ( !seamLocked[tri[0]] || !seamLocked[tri[1]] || !seamLocked[tri[2]] )
+        {
+        seamTris.push_back(i);
+        }
+      else
+        {
+        otherTris.insert(otherTris.end(), tri, tri + 3);
+        }
+      }
+
+    if ( !seamTris.empty() )
+      {
+      double reduction = static_cast<double>(numTarget - numDeletedTris) /
+        static_cast<double>(seamTris.size());
+      pieces = new vtkPartitionedQuadricDecimationPieces(points, pointData);
+      pieces->AddPiece(&tris[0], &seamTris[0],
+                       static_cast<vtkIdType>(seamTris.size()),
+                       &seamLocked[0], this,
+                       (reduction < 1.0 ? reduction : 1.0));
+      pieces->DecimatePiece(0);
+      numDeletedTris += pieces->MergePiece(0, otherTris);
+      delete pieces;
+      tris.swap(otherTris);
+      numLeft = static_cast<vtkIdType>(tris.size()/3);
+      }
+    }
+  this->UpdateProgress(0.9);
+
+  // Copy the remaining triangles to the output, numbering the points in
+  // the order they are used.
+  vtkstd::vector<vtkIdType> outIds(numPts, -1);
+  vtkPoints *newPts = vtkPoints::New(points->GetDataType());
+  newPts->Allocate(numLeft/2 + 1);
+  vtkCellArray *newPolys = vtkCellArray::New();
+  newPolys->Allocate(4*numLeft);
+  vtkPointData *outPD = output->GetPointData();
+  if ( pointData )
+    {
+    outPD->CopyAllocate(pointData, numLeft/2 + 1);
+    }
+  for (i = 0; i < numLeft; i++)
+    {
+    newPolys->InsertNextCell(3);
+    for (j = 0; j < 3; j++)
+      {
+      vtkIdType ptId = tris[3*i + j];
+      if ( outIds[ptId] < 0 )
+        {
+        outIds[ptId] = newPts->InsertNextPoint(points->GetPoint(ptId));
+        if ( pointData )
+          {
+          outPD->CopyData(pointData, ptId, outIds[ptId]);
+          }
+        }
+      newPolys->InsertCellPoint(outIds[ptId]);
+      }
+    }
+  output->SetPoints(newPts);
+  output->SetPolys(newPolys);
+  newPts->Delete();
+  newPolys->Delete();
+  points->Delete();
+  if ( pointData )
+    {
+    pointData->Delete();
+    }
+
+  // renormalize, as vtkQuadricDecimation does
+  vtkDataArray *normals = outPD->GetNormals();
+  if ( this->AttributeErrorMetric && normals )
+    {
+    for (i = 0; i < normals->GetNumberOfTuples(); i++)
+      {
+      vtkMath::Normalize(normals->GetTuple3(i));
+      }
+    }
+
+  this->ActualReduction = (numTris > 0 ?
+    static_cast<double>(numDeletedTris) / numTris : 0.0);
+
+  return 1;
+}
+
+//----------------------------------------------------------------------------
+void vtkPartitionedQuadricDecimation::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os,indent);
+
+  os << indent << "Number Of Pieces: " << this->NumberOfPieces << "\n";
+}
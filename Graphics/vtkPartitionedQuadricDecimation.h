@@ -0,0 +1,88 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkPartitionedQuadricDecimation.h
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// .NAME vtkPartitionedQuadricDecimation - quadric decimation of large meshes, one spatial piece per thread
+// .SECTION Description
+// vtkPartitionedQuadricDecimation reduces the number of triangles of a
+// triangle mesh with the same quadric error metric as its superclass,
+// vtkQuadricDecimation, but decimates several pieces of the mesh
+// concurrently.
+//
+// The triangles are split into spatial pieces with a k-d tree built on
+// their centroids. Each piece is decimated on its own, with the points it
+// shares with other pieces locked in place, which keeps the pieces
+// connected. A final serial pass then decimates the band of triangles
+// around the seams, with the rest of the mesh locked, to bring the overall
+// reduction to TargetReduction.
+//
+// TargetReduction and the attribute error options have the same meaning
+// as in vtkQuadricDecimation. As there, only triangles are treated and
+// the output point data is only passed when AttributeErrorMetric is on.
+//
+// .SECTION Caveats
+// The result depends on the partition, and therefore on NumberOfPieces.
+// Set NumberOfPieces explicitly to get the same output whatever the number
+// of processors. When AttributeErrorMetric is on, the attributes are
+// normalized by their range over each piece rather than over the whole
+// mesh, and all point data arrays are passed to the output.
+//
+// .SECTION See Also
+// vtkQuadricDecimation vtkKdTree
+
+#ifndef __vtkPartitionedQuadricDecimation_h
+#define __vtkPartitionedQuadricDecimation_h
+
+#include "vtkQuadricDecimation.h"
+
+//BTX
+class vtkPartitionedQuadricDecimationPieces;
+//ETX
+
+class VTK_GRAPHICS_EXPORT vtkPartitionedQuadricDecimation : public vtkQuadricDecimation
+{
+public:
+  vtkTypeMacro(vtkPartitionedQuadricDecimation, vtkQuadricDecimation);
+  void PrintSelf(ostream& os, vtkIndent indent);
+  static vtkPartitionedQuadricDecimation *New();
+
+  // Description:
+  // Set/Get the number of spatial pieces the mesh is split into. The k-d
+  // tree rounds it up to a power of two. When 0 (the default), one piece
+  // is used per thread, provided the mesh is large enough; otherwise the
+  // mesh is decimated as a whole, as by vtkQuadricDecimation.
+  vtkSetClampMacro(NumberOfPieces, int, 0, VTK_LARGE_INTEGER);
+  vtkGetMacro(NumberOfPieces, int);
+
+protected:
+  vtkPartitionedQuadricDecimation();
+  ~vtkPartitionedQuadricDecimation();
+
+  int RequestData(vtkInformation *, vtkInformationVector **, vtkInformationVector *);
+
+  // Description:
+  // Copy the decimation parameters of this filter to worker.
+  void CopyParameters(vtkPartitionedQuadricDecimation *worker);
+
+  int NumberOfPieces;
+
+private:
+  //BTX
+  friend class vtkPartitionedQuadricDecimationPieces;
+  //ETX
+
+  vtkPartitionedQuadricDecimation(const vtkPartitionedQuadricDecimation&);  // Not implemented.
+  void operator=(const vtkPartitionedQuadricDecimation&);  // Not implemented.
+};
+
+#endif
@@ -20,6 +20,7 @@
 #include "vtkMath.h"
 #include "vtkInformation.h"
 #include "vtkInformationVector.h"
+#include "vtkMultiThreader.h"
 #include "vtkObjectFactory.h"
 #include "vtkPointData.h"
 #include "vtkPolyData.h"
@@ -27,8 +28,137 @@
 #include "vtkTriangleStrip.h"
 #include "vtkPriorityQueue.h"
 
+#include <vtkstd/vector>
+
 vtkStandardNewMacro(vtkPolyDataNormals);
 
+// Minimum number of polygons (or points) per thread when computing normals
+// without a topological traversal.
+#define VTK_POLYDATA_NORMALS_ITEMS_PER_THREAD 20000
+
+//----------------------------------------------------------------------------
+// Shared by the threads of ComputeNormalsInParallel. The polygons are
+// accessed through the offset of each cell in the connectivity array, and
+// the polygons using each point through a compressed (offsets + ids) point
+// to cell table, so that each point normal is the sum of its polygon
+// normals taken in cell order, exactly as in the serial traversal.
+class vtkPolyDataNormalsFastPath
+{
+public:
+  vtkPoints *Points;
+  vtkIdType *Connectivity;
+  vtkstd::vector<vtkIdType> CellLocations;
+  vtkstd::vector<vtkIdType> PointCellOffsets;
+  vtkstd::vector<vtkIdType> PointCells;
+  float *PolyNormals;
+  float *PointNormals;
+  double FlipDirection;
+
+  void ComputePolyNormals(vtkIdType begin, vtkIdType end)
+    {
+    double n[3];
+    for (vtkIdType cellId = begin; cellId < end; ++cellId)
+      {
+      vtkIdType *cell = this->Connectivity + this->CellLocations[cellId];
+      vtkPolygon::ComputeNormal(this->Points, static_cast<int>(cell[0]),
+                                cell + 1, n);
+      float *polyNormal = this->PolyNormals + 3*cellId;
+      polyNormal[0] = static_cast<float>(n[0]);
+      polyNormal[1] = static_cast<float>(n[1]);
+      polyNormal[2] = static_cast<float>(n[2]);
+      }
+    }
+
+  void ComputePointNormals(vtkIdType begin, vtkIdType end)
+    {
+    int j;
+    float sum[3];
+    double length;
+    for (vtkIdType ptId = begin; ptId < end; ++ptId)
+      {
+      sum[0] = sum[1] = sum[2] = 0.0f;
+      for (vtkIdType k = this->PointCellOffsets[ptId];
+           k < this->PointCellOffsets[ptId+1]; ++k)
+        {
+        float *polyNormal = this->PolyNormals + 3*this->PointCells[k];
+        for (j = 0; j < 3; j++)
+          {
+          sum[j] = static_cast<float>(static_cast<double>(sum[j]) +
+                                      static_cast<double>(polyNormal[j]));
+          }
+        }
+      length = sqrt(static_cast<double>(sum[0])*sum[0] +
+                    static_cast<double>(sum[1])*sum[1] +
+                    static_cast<double>(sum[2])*sum[2]);
+      float *pointNormal = this->PointNormals + 3*ptId;
+      for (j = 0; j < 3; j++)
+        {
+        pointNormal[j] = (length != 0.0 ?
+          static_cast<float>(sum[j] / length * this->FlipDirection) : 0.0f);
+        }
+      }
+    }
+};
+
+//----------------------------------------------------------------------------
+static VTK_THREAD_RETURN_TYPE vtkPolyDataNormalsPolyThread(void *arg)
+{
+  vtkMultiThreader::ThreadInfo *info =
+    static_cast<vtkMultiThreader::ThreadInfo *>(arg);
+  vtkPolyDataNormalsFastPath *fast =
+    static_cast<vtkPolyDataNormalsFastPath *>(info->UserData);
+  vtkIdType numCells = static_cast<vtkIdType>(fast->CellLocations.size());
+  fast->ComputePolyNormals(numCells * info->ThreadID / info->NumberOfThreads,
+                           numCells * (info->ThreadID + 1) /
+                           info->NumberOfThreads);
+  return VTK_THREAD_RETURN_VALUE;
+}
+
+//----------------------------------------------------------------------------
+static VTK_THREAD_RETURN_TYPE vtkPolyDataNormalsPointThread(void *arg)
+{
+  vtkMultiThreader::ThreadInfo *info =
+    static_cast<vtkMultiThreader::ThreadInfo *>(arg);
+  vtkPolyDataNormalsFastPath *fast =
+    static_cast<vtkPolyDataNormalsFastPath *>(info->UserData);
+  vtkIdType numPts = static_cast<vtkIdType>(fast->PointCellOffsets.size()) - 1;
+  fast->ComputePointNormals(numPts * info->ThreadID / info->NumberOfThreads,
+                            numPts * (info->ThreadID + 1) /
+                            info->NumberOfThreads);
+  return VTK_THREAD_RETURN_VALUE;
+}
+
+//----------------------------------------------------------------------------
+// Run method over numItems items with as many threads as useful.
+static void vtkPolyDataNormalsExecute(vtkThreadFunctionType method,
+                                      vtkPolyDataNormalsFastPath *fast,
+                                      vtkIdType numItems)
+{
+  vtkIdType numThreads = numItems / VTK_POLYDATA_NORMALS_ITEMS_PER_THREAD;
+  if (numThreads > vtkMultiThreader::GetGlobalDefaultNumberOfThreads())
+    {
+    numThreads = vtkMultiThreader::GetGlobalDefaultNumberOfThreads();
+    }
+  if (numThreads < 1)
+    {
+    numThreads = 1;
+    }
+  vtkMultiThreader::ThreadInfo info;
+  if (numThreads == 1)
+    {
+    info.ThreadID = 0;
+    info.NumberOfThreads = 1;
+    info.UserData = fast;
+    method(&info);
+    return;
+    }
+  vtkMultiThreader *threader = vtkMultiThreader::New();
+  threader->SetNumberOfThreads(static_cast<int>(numThreads));
+  threader->SetSingleMethod(method, fast);
+  threader->SingleMethodExecute();
+  threader->Delete();
+}
+
 // Construct with feature angle=30, splitting and consistency turned on, 
 // flipNormals turned off, and non-manifold traversal turned on.
 vtkPolyDataNormals::vtkPolyDataNormals()
@@ -107,6 +237,14 @@ int vtkPolyDataNormals::RequestData(
   output->GetCellData()->PassData(input->GetCellData());
   output->SetFieldData(input->GetFieldData());
 
+  // Without reordering nor splitting, the mesh topology is not needed.
+  if ( !this->Consistency && !this->Splitting && !this->AutoOrientNormals )
+    {
+    this->NumFlips = 0;
+    this->ComputeNormalsInParallel(input, output);
+    return 1;
+    }
+
   // Load data into cell structure.  We need two copies: one is a 
   // non-writable mesh used to perform topological queries.  The other 
   // is used to write into and modify the connectivity of the mesh.
@@ -480,6 +618,128 @@ int vtkPolyDataNormals::RequestData(
   return 1;
 }
 
+//----------------------------------------------------------------------------
+void vtkPolyDataNormals::ComputeNormalsInParallel(vtkPolyData *input,
+                                                  vtkPolyData *output)
+{
+  vtkIdType npts = 0;
+  vtkIdType *pts = 0;
+  vtkIdType cellId, ptId, i;
+  vtkIdType numPts = input->GetNumberOfPoints();
+  vtkPoints *inPts = input->GetPoints();
+  vtkCellArray *inStrips = input->GetStrips();
+  vtkCellArray *polys;
+
+  // Strips are decomposed into triangles, as in the general case.
+  if ( input->GetNumberOfStrips() > 0 )
+    {
+    polys = vtkCellArray::New();
+    if ( input->GetNumberOfPolys() > 0 )
+      {
+      polys->DeepCopy(input->GetPolys());
+      }
+    else
+      {
+      polys->Allocate(polys->EstimateSize(input->GetNumberOfStrips(),5));
+      }
+    for ( inStrips->InitTraversal(); inStrips->GetNextCell(npts,pts); )
+      {
+      vtkTriangleStrip::DecomposeStrip(npts, pts, polys);
+      }
+    }
+  else
+    {
+    polys = input->GetPolys();
+    polys->Register(this);
+    }
+  vtkIdType numPolys = polys->GetNumberOfCells();
+
+  vtkPolyDataNormalsFastPath fast;
+  fast.Points = inPts;
+  fast.Connectivity = polys->GetPointer();
+  fast.FlipDirection = (this->FlipNormals ? -1.0 : 1.0);
+
+  // Locate the cells in the connectivity array.
+  fast.CellLocations.resize(numPolys);
+  vtkIdType loc = 0;
+  for (cellId = 0; cellId < numPolys; cellId++)
+    {
+    fast.CellLocations[cellId] = loc;
+    loc += fast.Connectivity[loc] + 1;
+    }
+
+  vtkFloatArray *polyNormals = vtkFloatArray::New();
+  polyNormals->SetNumberOfComponents(3);
+  polyNormals->SetNumberOfTuples(numPolys);
+  polyNormals->SetName("Normals");
+  fast.PolyNormals = polyNormals->GetPointer(0);
+  vtkPolyDataNormalsExecute(vtkPolyDataNormalsPolyThread, &fast, numPolys);
+  this->UpdateProgress(0.5);
+
+  vtkFloatArray *newNormals = NULL;
+  if (this->ComputePointNormals)
+    {
+    // Invert the connectivity: count the uses of each point, then scatter
+    // the cell ids in increasing order.
+    fast.PointCellOffsets.assign(numPts + 1, 0);
+    fast.PointCells.resize(loc - numPolys);
+    for (cellId = 0; cellId < numPolys; cellId++)
+      {
+      pts = fast.Connectivity + fast.CellLocations[cellId];
+      for (i = 1; i <= pts[0]; i++)
+        {
+        fast.PointCellOffsets[pts[i] + 1]++;
+        }
+      }
+    for (ptId = 0; ptId < numPts; ptId++)
+      {
+      fast.PointCellOffsets[ptId + 1] += fast.PointCellOffsets[ptId];
+      }
+    vtkstd::vector<vtkIdType> next(fast.PointCellOffsets.begin(),
+                                   fast.PointCellOffsets.end() - 1);
+    for (cellId = 0; cellId < numPolys; cellId++)
+      {
+      pts = fast.Connectivity + fast.CellLocations[cellId];
+      for (i = 1; i <= pts[0]; i++)
+        {
+        fast.PointCells[next[pts[i]]++] = cellId;
+        }
+      }
+    this->UpdateProgress(0.75);
+
+    newNormals = vtkFloatArray::New();
+    newNormals->SetNumberOfComponents(3);
+    newNormals->SetNumberOfTuples(numPts);
+    newNormals->SetName("Normals");
+    fast.PointNormals = newNormals->GetPointer(0);
+    vtkPolyDataNormalsExecute(vtkPolyDataNormalsPointThread, &fast, numPts);
+    }
+
+  vtkPointData *outPD = output->GetPointData();
+  outPD->CopyNormalsOff();
+  outPD->PassData(input->GetPointData());
+  output->SetPoints(inPts);
+
+  if (this->ComputeCellNormals)
+    {
+    output->GetCellData()->SetNormals(polyNormals);
+    }
+  polyNormals->Delete();
+
+  if (newNormals)
+    {
+    outPD->SetNormals(newNormals);
+    newNormals->Delete();
+    }
+
+  output->SetPolys(polys);
+  polys->UnRegister(this);
+
+  // copy the original vertices and lines to the output
+  output->SetVerts(input->GetVerts());
+  output->SetLines(input->GetLines());
+}
+
 //  Propagate wave of consistently ordered polygons.
 //
 void vtkPolyDataNormals::TraverseAndOrder (void)
@@ -24,6 +24,11 @@
 // averaging them at shared points. When sharp edges are present, the edges
 // are split and new points generated to prevent blurry edges (due to 
 // Gouraud shading).
+//
+// When Consistency, Splitting and AutoOrientNormals are all off, for
+// instance to update the normals of a consistently ordered mesh as it
+// deforms, no topological traversal is needed: the polygon normals and
+// their sums at the points are then computed by several threads.
 
 // .SECTION Caveats
 // Normals are computed only for polygons and triangle strips. Normals are
@@ -122,6 +127,11 @@ protected:
   // Usual data generation method
   int RequestData(vtkInformation *, vtkInformationVector **, vtkInformationVector *);
 
+  // Description:
+  // Compute the normals without reordering the polygons nor splitting
+  // sharp edges. The output is the same as with the general algorithm.
+  void ComputeNormalsInParallel(vtkPolyData *input, vtkPolyData *output);
+
   double FeatureAngle;
   int Splitting;
   int Consistency;
@@ -268,6 +268,13 @@ void vtkProbeFilter::ProbeEmptyPoints(vtkDataSet *input,
   double minRes2 = minRes * minRes;
   tol2 = tol2 > minRes2 ? minRes2 : tol2;
 
+  // Interpolation requests are collected and the point data is interpolated
+  // for all of them at once, array by array, after the loop.
+  vtkstd::vector<vtkIdType> toIds;
+  vtkstd::vector<vtkIdType> offsets(1, 0);
+  vtkstd::vector<vtkIdType> ids;
+  vtkstd::vector<double> interpWeights;
+
   // Loop over all input points, interpolating source data
   //
   int abort=0;
@@ -302,9 +309,14 @@ void vtkProbeFilter::ProbeEmptyPoints(vtkDataSet *input,
       }
     if (cell)
       {
-      // Interpolate the point data
-      outPD->InterpolatePoint((*this->PointList), pd, srcIdx, ptId,
-        cell->PointIds, weights);
+      // Record the point data interpolation
+      vtkIdType numCellPts = cell->PointIds->GetNumberOfIds();
+      vtkIdType *cellPts = cell->PointIds->GetPointer(0);
+      toIds.push_back(ptId);
+      ids.insert(ids.end(), cellPts, cellPts + numCellPts);
+      interpWeights.insert(interpWeights.end(), weights,
+                           weights + numCellPts);
+      offsets.push_back(static_cast<vtkIdType>(ids.size()));
       this->ValidPoints->InsertNextValue(ptId);
       this->NumberOfValidPoints++;
       vtkVectorOfArrays::iterator iter;
@@ -328,6 +340,13 @@ void vtkProbeFilter::ProbeEmptyPoints(vtkDataSet *input,
       }
     }
 
+  if (!toIds.empty())
+    {
+    outPD->InterpolatePoints((*this->PointList), pd, srcIdx,
+      static_cast<vtkIdType>(toIds.size()), &toIds[0], &offsets[0],
+      &ids[0], &interpWeights[0]);
+    }
+
   if (mcs>256)
     {
     delete [] weights;
@@ -21,12 +21,41 @@
 #include "vtkInformation.h"
 #include "vtkInformationVector.h"
 #include "vtkMath.h"
+#include "vtkMultiThreader.h"
 #include "vtkObjectFactory.h"
 #include "vtkPointData.h"
 #include "vtkPolyData.h"
+#include "vtkStreamingDemandDrivenPipeline.h"
 #include "vtkTimerLog.h"
 #include "vtkTriangle.h"
 #include <vtksys/hash_set.hxx> // keep track of inserted triangles
+#include <vtksys/hash_map.hxx> // sparse bins
+
+#include <vtkstd/string>
+#include <vtkstd/vector>
+
+#include <stdio.h>
+#include <fcntl.h>
+#if defined(_WIN32)
+# include <io.h>
+# include <process.h>
+# include <sys/stat.h>
+#else
+# include <stdlib.h>
+# include <unistd.h>
+#endif
+
+// Number of temporary files the sparse bins are written to. Each file holds
+// a slab of the binning, so that merging them back only needs to hold one
+// slab in memory.
+#define VTK_QUADRIC_CLUSTERING_SPILL_FILES 16
+
+// Polygons are read in batches of this many cells, and the bins and
+// quadrics of the triangles of a batch are computed by several threads
+// when each thread gets at least VTK_QUADRIC_CLUSTERING_TRIS_PER_THREAD
+// triangles.
+#define VTK_QUADRIC_CLUSTERING_BATCH_SIZE 65536
+#define VTK_QUADRIC_CLUSTERING_TRIS_PER_THREAD 8192
 
 vtkStandardNewMacro(vtkQuadricClustering);
 
@@ -38,6 +67,324 @@ struct vtkQuadricClusteringIdTypeHash {
 class vtkQuadricClusteringCellSet : public vtksys::hash_set<vtkIdType, vtkQuadricClusteringIdTypeHash> {};
 typedef vtkQuadricClusteringCellSet::iterator vtkQuadricClusteringCellSetIterator;
 
+//----------------------------------------------------------------------------
+// Hash table of the used bins, with the quadrics moved to temporary files
+// when there are too many of them. The output point ids are kept apart
+// since they are needed to build the output cells as the input is read.
+class vtkQuadricClusteringBinStore
+{
+public:
+  struct Bin
+  {
+    Bin():Dimension(255) {}
+    unsigned char Dimension;
+    double Quadric[9];
+  };
+  struct Record
+  {
+    vtkIdType BinId;
+    int Dimension;
+    double Quadric[9];
+  };
+  typedef vtksys::hash_map<vtkIdType, Bin,
+                           vtkQuadricClusteringIdTypeHash> BinMap;
+  typedef vtksys::hash_map<vtkIdType, vtkIdType,
+                           vtkQuadricClusteringIdTypeHash> VertexIdMap;
+
+  BinMap Bins;
+  VertexIdMap VertexIds;
+  vtkIdType BinsPerFile;
+  int Spilled;
+  int SpillFailed;
+  FILE *Files[VTK_QUADRIC_CLUSTERING_SPILL_FILES];
+  // Number of complete records in each file. Anything past them was left
+  // by a failed spill and is overwritten by the next one.
+  vtkIdType NumberOfRecords[VTK_QUADRIC_CLUSTERING_SPILL_FILES];
+
+  vtkQuadricClusteringBinStore(vtkIdType numBins)
+    {
+    this->BinsPerFile = numBins / VTK_QUADRIC_CLUSTERING_SPILL_FILES + 1;
+    this->Spilled = 0;
+    this->SpillFailed = 0;
+    for (int i = 0; i < VTK_QUADRIC_CLUSTERING_SPILL_FILES; ++i)
+      {
+      this->Files[i] = NULL;
+      this->NumberOfRecords[i] = 0;
+      }
+    }
+  ~vtkQuadricClusteringBinStore()
+    {
+    for (int i = 0; i < VTK_QUADRIC_CLUSTERING_SPILL_FILES; ++i)
+      {
+      if (this->Files[i])
+        {
+        fclose(this->Files[i]);
+        }
+      }
+    }
+
+  // Create a temporary file in the given directory, or in the system one
+  // if directory is NULL. The file is created with a unique name that
+  // cannot be an existing file or link, and is deleted when closed.
+  static FILE *OpenTemporaryFile(const char *directory)
+    {
+    if (!directory)
+      {
+      return tmpfile();
+      }
+#if defined(_WIN32)
+    static int counter = 0;
+    for (int attempt = 0; attempt < 100; ++attempt)
+      {
+      char name[64];
+      sprintf(name, "\\vtkQuadricClustering_%d_%d.bin", _getpid(),
+              counter++);
+      vtkstd::string path = vtkstd::string(directory) + name;
+      int fd = _open(path.c_str(), _O_CREAT | _O_EXCL | _O_RDWR | _O_BINARY |
+                     _O_TEMPORARY, _S_IREAD | _S_IWRITE);
+      if (fd != -1)
+        {
+        return _fdopen(fd, "w+b");
+        }
+      }
+    return NULL;
+#else
+    vtkstd::string path =
+      vtkstd::string(directory) + "/vtkQuadricClustering_XXXXXX";
+    vtkstd::vector<char> name(path.begin(), path.end());
+    name.push_back('\0');
+    int fd = mkstemp(&name[0]);
+    if (fd == -1)
+      {
+      return NULL;
+      }
+    unlink(&name[0]);
+    FILE *fp = fdopen(fd, "w+b");
+    if (!fp)
+      {
+      close(fd);
+      }
+    return fp;
+#endif
+    }
+
+  // Combine the quadric of a bin with another partial quadric of the same
+  // bin, keeping the lowest dimension as AddQuadric does.
+  static void MergeBin(Bin &bin, int dimension, const double quadric[9])
+    {
+    if (dimension < bin.Dimension)
+      {
+      bin.Dimension = static_cast<unsigned char>(dimension);
+      for (int i = 0; i < 9; ++i)
+        {
+        bin.Quadric[i] = quadric[i];
+        }
+      }
+    else if (dimension == bin.Dimension)
+      {
+      for (int i = 0; i < 9; ++i)
+        {
+        bin.Quadric[i] += quadric[i];
+        }
+      }
+    }
+
+  // Position a file after its first numRecords records. The files can
+  // grow past 2 GB, which a long cannot hold on Windows or on 32-bit
+  // systems, so the offset is 64-bit. Returns 0 if the offset cannot be
+  // represented by the system or the file cannot be positioned.
+  static int SeekRecord(FILE *fp, vtkIdType numRecords)
+    {
+    vtkTypeInt64 offset = static_cast<vtkTypeInt64>(numRecords) *
+      static_cast<vtkTypeInt64>(sizeof(Record));
+#if defined(_WIN32)
+    return _fseeki64(fp, offset, SEEK_SET) == 0;
+#else
+    off_t pos = static_cast<off_t>(offset);
+    if (static_cast<vtkTypeInt64>(pos) != offset)
+      {
+      return 0;
+      }
+    return fseeko(fp, pos, SEEK_SET) == 0;
+#endif
+    }
+
+  // Append the quadrics in memory to the files and free them. Returns 0 if
+  // a file could not be created, positioned or written, in which case the
+  // quadrics stay in memory and the files keep only what previous spills
+  // wrote.
+  int Spill(const char *directory)
+    {
+    int i;
+    for (i = 0; i < VTK_QUADRIC_CLUSTERING_SPILL_FILES; ++i)
+      {
+      if (!this->Files[i] &&
+          !(this->Files[i] = OpenTemporaryFile(directory)))
+        {
+        return 0;
+        }
+      // Overwrite whatever a failed spill left after the complete records.
+      clearerr(this->Files[i]);
+      if (!SeekRecord(this->Files[i], this->NumberOfRecords[i]))
+        {
+        return 0;
+        }
+      }
+    vtkIdType numRecords[VTK_QUADRIC_CLUSTERING_SPILL_FILES];
+    for (i = 0; i < VTK_QUADRIC_CLUSTERING_SPILL_FILES; ++i)
+      {
+      numRecords[i] = this->NumberOfRecords[i];
+      }
+    Record record;
+    int ok = 1;
+    for (BinMap::iterator it = this->Bins.begin();
+         ok && it != this->Bins.end(); ++it)
+      {
+      if (it->second.Dimension > 2)
+        {
+        continue;
+        }
+      record.BinId = it->first;
+      record.Dimension = it->second.Dimension;
+      for (i = 0; i < 9; ++i)
+        {
+        record.Quadric[i] = it->second.Quadric[i];
+        }
+      int file = static_cast<int>(it->first / this->BinsPerFile);
+      ok = (fwrite(&record, sizeof(Record), 1, this->Files[file]) == 1);
+      numRecords[file]++;
+      }
+    for (i = 0; i < VTK_QUADRIC_CLUSTERING_SPILL_FILES; ++i)
+      {
+      ok = (fflush(this->Files[i]) == 0) && ok;
+      }
+    if (!ok)
+      {
+      // Forget the records of this spill; the next spill overwrites them.
+      return 0;
+      }
+    for (i = 0; i < VTK_QUADRIC_CLUSTERING_SPILL_FILES; ++i)
+      {
+      this->NumberOfRecords[i] = numRecords[i];
+      }
+    this->Bins.clear();
+    this->Spilled = 1;
+    return 1;
+    }
+
+  // Merge the quadrics written to one file into bins. Returns 0 if the
+  // file could not be read back entirely.
+  int Load(int file, BinMap &bins)
+    {
+    FILE *fp = this->Files[file];
+    if (!fp)
+      {
+      return 1;
+      }
+    Record record;
+    vtkIdType numRecords = 0;
+    rewind(fp);
+    while (numRecords < this->NumberOfRecords[file] &&
+           fread(&record, sizeof(Record), 1, fp) == 1)
+      {
+      MergeBin(bins[record.BinId], record.Dimension, record.Quadric);
+      ++numRecords;
+      }
+    return numRecords == this->NumberOfRecords[file];
+    }
+
+  // Merge the quadrics of all the files into the bins in memory.
+  int LoadAll()
+    {
+    int ok = 1;
+    for (int file = 0; file < VTK_QUADRIC_CLUSTERING_SPILL_FILES; ++file)
+      {
+      ok = this->Load(file, this->Bins) && ok;
+      }
+    return ok;
+    }
+};
+
+//----------------------------------------------------------------------------
+// Computes the quadric of a triangle, in the 9 coefficient form used by the
+// bins.
+static void vtkQuadricClusteringTriangleQuadric(double *pt0, double *pt1,
+                                                double *pt2,
+                                                double quadric[9])
+{
+  double quadric4x4[4][4];
+  vtkTriangle::ComputeQuadric(pt0, pt1, pt2, quadric4x4);
+  quadric[0] = quadric4x4[0][0];
+  quadric[1] = quadric4x4[0][1];
+  quadric[2] = quadric4x4[0][2];
+  quadric[3] = quadric4x4[0][3];
+  quadric[4] = quadric4x4[1][1];
+  quadric[5] = quadric4x4[1][2];
+  quadric[6] = quadric4x4[1][3];
+  quadric[7] = quadric4x4[2][2];
+  quadric[8] = quadric4x4[2][3];
+}
+
+//----------------------------------------------------------------------------
+// A batch of polygons, fan triangulated. The bins and quadrics of the
+// triangles are computed by several threads; they are then added to the
+// bins in order by a single thread, so the result does not depend on the
+// number of threads.
+class vtkQuadricClusteringTriangleBatch
+{
+public:
+  vtkQuadricClustering *Self;
+  vtkPoints *Points;
+  vtkstd::vector<vtkIdType*> CellPoints;
+  vtkstd::vector<vtkIdType> CellSizes;
+  // Index of the first triangle of each cell, plus the total at the end.
+  vtkstd::vector<vtkIdType> FirstTriangle;
+  vtkstd::vector<vtkIdType> BinIds;
+  vtkstd::vector<double> Quadrics;
+
+  void ComputeCells(vtkIdType begin, vtkIdType end)
+    {
+    double pts0[3], pts1[3], pts2[3];
+    for (vtkIdType cellId = begin; cellId < end; ++cellId)
+      {
+      vtkIdType *ptIds = this->CellPoints[cellId];
+      vtkIdType numPts = this->CellSizes[cellId];
+      vtkIdType tri = this->FirstTriangle[cellId];
+      if (numPts < 3)
+        {
+        continue;
+        }
+      this->Points->GetPoint(ptIds[0], pts0);
+      vtkIdType binId0 = this->Self->HashPoint(pts0);
+      for (vtkIdType j = 0; j < numPts-2; ++j, ++tri)
+        {
+        this->Points->GetPoint(ptIds[j+1], pts1);
+        this->Points->GetPoint(ptIds[j+2], pts2);
+        vtkIdType *binIds = &this->BinIds[3*tri];
+        binIds[0] = binId0;
+        binIds[1] = this->Self->HashPoint(pts1);
+        binIds[2] = this->Self->HashPoint(pts2);
+        vtkQuadricClusteringTriangleQuadric(pts0, pts1, pts2,
+                                            &this->Quadrics[9*tri]);
+        }
+      }
+    }
+};
+
+//----------------------------------------------------------------------------
+static VTK_THREAD_RETURN_TYPE vtkQuadricClusteringTriangleThread(void *arg)
+{
+  vtkMultiThreader::ThreadInfo *info =
+    static_cast<vtkMultiThreader::ThreadInfo *>(arg);
+  vtkQuadricClusteringTriangleBatch *batch =
+    static_cast<vtkQuadricClusteringTriangleBatch *>(info->UserData);
+  vtkIdType numCells = static_cast<vtkIdType>(batch->CellSizes.size());
+  vtkIdType begin = numCells * info->ThreadID / info->NumberOfThreads;
+  vtkIdType end = numCells * (info->ThreadID + 1) / info->NumberOfThreads;
+  batch->ComputeCells(begin, end);
+  return VTK_THREAD_RETURN_VALUE;
+}
+
 
 //----------------------------------------------------------------------------
 // Construct with default NumberOfDivisions to 50, DivisionSpacing to 1
@@ -80,6 +427,17 @@ vtkQuadricClustering::vtkQuadricClustering()
   this->OutputTriangleArray = NULL;
   this->OutputLines = NULL;
 
+  this->UseSparseBins = 0;
+  this->MaximumNumberOfBinsInMemory = 0;
+  this->SpillDirectory = NULL;
+  this->BinStore = NULL;
+
+  this->NumberOfStreamDivisions = 1;
+  this->CurrentStreamDivision = 0;
+  this->StreamingPass = 0;
+  this->StreamedNumberOfPoints = 0;
+  this->StreamedVertexBins = NULL;
+
   // Used for matching boundaries.
   this->FeatureEdges = vtkFeatureEdges::New();
   this->FeatureEdges->FeatureEdgesOff();
@@ -120,11 +478,22 @@ vtkQuadricClustering::~vtkQuadricClustering()
     this->OutputLines->Delete();
     this->OutputLines = NULL;
     }
+  if (this->BinStore)
+    {
+    delete this->BinStore;
+    this->BinStore = NULL;
+    }
+  if (this->StreamedVertexBins)
+    {
+    this->StreamedVertexBins->Delete();
+    this->StreamedVertexBins = NULL;
+    }
+  this->SetSpillDirectory(NULL);
 }
 
 //----------------------------------------------------------------------------
 int vtkQuadricClustering::RequestData(
-  vtkInformation *vtkNotUsed(request),
+  vtkInformation *request,
   vtkInformationVector **inputVector,
   vtkInformationVector *outputVector)
 {
@@ -144,6 +513,11 @@ int vtkQuadricClustering::RequestData(
 
   vtkTimerLog *tlog=NULL;
 
+  if (input && this->NumberOfStreamDivisions > 1)
+    {
+    return this->RequestStreamedData(request, inInfo, input);
+    }
+
   if (!input || (input->GetNumberOfPoints() == 0))
     {
     // The user may be calling StartAppend, Append, and EndAppend explicitly.
@@ -162,36 +536,12 @@ int vtkQuadricClustering::RequestData(
     tlog->StartTimer();
     }
 
-  // Lets limit the number of divisions based on 
-  // the number of points in the input.
-  int target = input->GetNumberOfPoints();
-  int numDiv = (this->NumberOfXDivisions * this->NumberOfYDivisions
-                  * this->NumberOfZDivisions) / 2;
-  if (this->AutoAdjustNumberOfDivisions && numDiv > target) 
-    {
-    double factor = pow(((double)numDiv/(double)target),0.33333);
-    this->NumberOfDivisions[0] = 
-      (int)(0.5+(double)(this->NumberOfXDivisions)/factor);  
-    this->NumberOfDivisions[0] = (this->NumberOfDivisions[0] > 0 ? this->NumberOfDivisions[0] : 1);
-    this->NumberOfDivisions[1] = 
-      (int)(0.5+(double)(this->NumberOfYDivisions)/factor);  
-    this->NumberOfDivisions[1] = (this->NumberOfDivisions[1] > 0 ? this->NumberOfDivisions[1] : 1);
-    this->NumberOfDivisions[2] = 
-      (int)(0.5+(double)(this->NumberOfZDivisions)/factor);  
-    this->NumberOfDivisions[2] = (this->NumberOfDivisions[2] > 0 ? this->NumberOfDivisions[2] : 1);
-    }
-  else
-    {
-    this->NumberOfDivisions[0] = this->NumberOfXDivisions;
-    this->NumberOfDivisions[1] = this->NumberOfYDivisions;
-    this->NumberOfDivisions[2] = this->NumberOfZDivisions;
-    }
+  this->AdjustNumberOfDivisions(input->GetNumberOfPoints());
 
   this->UpdateProgress(.01);
 
   this->StartAppend(input->GetBounds());
   this->UpdateProgress(.2);
-  this->SliceSize = this->NumberOfDivisions[0]*this->NumberOfDivisions[1];
 
   this->Append(input);
   if (this->UseFeatureEdges)
@@ -214,6 +564,11 @@ int vtkQuadricClustering::RequestData(
     delete [] this->QuadricArray;
     this->QuadricArray = NULL;
     } 
+  if (this->BinStore)
+    {
+    delete this->BinStore;
+    this->BinStore = NULL;
+    }
 
   if ( this->Debug )
     {
@@ -225,6 +580,207 @@ int vtkQuadricClustering::RequestData(
   return 1;
 }
 
+//----------------------------------------------------------------------------
+int vtkQuadricClustering::RequestUpdateExtent(
+  vtkInformation *request,
+  vtkInformationVector **inputVector,
+  vtkInformationVector *outputVector)
+{
+  if (this->NumberOfStreamDivisions <= 1 ||
+      inputVector[0]->GetNumberOfInformationObjects() == 0)
+    {
+    return this->Superclass::RequestUpdateExtent(request, inputVector,
+                                                 outputVector);
+    }
+
+  vtkInformation *inInfo = inputVector[0]->GetInformationObject(0);
+  vtkInformation *outInfo = outputVector->GetInformationObject(0);
+
+  // Divide the piece requested downstream into NumberOfStreamDivisions
+  // pieces, and request the one RequestData is about to process.
+  int piece = 0;
+  int numPieces = 1;
+  if (outInfo->Has(vtkStreamingDemandDrivenPipeline::UPDATE_PIECE_NUMBER()))
+    {
+    piece = outInfo->Get(
+      vtkStreamingDemandDrivenPipeline::UPDATE_PIECE_NUMBER());
+    numPieces = outInfo->Get(
+      vtkStreamingDemandDrivenPipeline::UPDATE_NUMBER_OF_PIECES());
+    }
+  inInfo->Set(vtkStreamingDemandDrivenPipeline::UPDATE_PIECE_NUMBER(),
+              piece*this->NumberOfStreamDivisions + this->CurrentStreamDivision);
+  inInfo->Set(vtkStreamingDemandDrivenPipeline::UPDATE_NUMBER_OF_PIECES(),
+              numPieces*this->NumberOfStreamDivisions);
+  inInfo->Set(vtkStreamingDemandDrivenPipeline::UPDATE_NUMBER_OF_GHOST_LEVELS(),
+              0);
+
+  return 1;
+}
+
+//----------------------------------------------------------------------------
+int vtkQuadricClustering::RequestStreamedData(vtkInformation *request,
+                                              vtkInformation *inInfo,
+                                              vtkPolyData *input)
+{
+  int i;
+  double bounds[6];
+
+  if (this->StreamingPass == 0)
+    {
+    // First piece. The bounds of the whole input are needed before the
+    // first piece can be appended; read all the pieces once to compute
+    // them, unless the pipeline already knows them.
+    this->StreamingPass = 1;
+    this->CurrentStreamDivision = 0;
+    this->StreamedNumberOfPoints = 0;
+    vtkMath::UninitializeBounds(this->StreamedBounds);
+    if (inInfo->Has(vtkStreamingDemandDrivenPipeline::WHOLE_BOUNDING_BOX()))
+      {
+      inInfo->Get(vtkStreamingDemandDrivenPipeline::WHOLE_BOUNDING_BOX(),
+                  bounds);
+      if (bounds[0] <= bounds[1] && bounds[2] <= bounds[3] &&
+          bounds[4] <= bounds[5])
+        {
+        for (i = 0; i < 6; ++i)
+          {
+          this->StreamedBounds[i] = bounds[i];
+          }
+        this->StreamingPass = 2;
+        }
+      }
+    if (this->StreamingPass == 2)
+      {
+      // The number of points is not known: use the divisions as given.
+      this->AdjustNumberOfDivisions(VTK_LARGE_ID);
+      this->StartAppend(this->StreamedBounds);
+      this->StreamedVertexBins = vtkCellArray::New();
+      }
+    }
+
+  if (this->StreamingPass == 1)
+    {
+    if (input->GetNumberOfPoints() > 0)
+      {
+      input->GetBounds(bounds);
+      if (!vtkMath::AreBoundsInitialized(this->StreamedBounds))
+        {
+        for (i = 0; i < 6; ++i)
+          {
+          this->StreamedBounds[i] = bounds[i];
+          }
+        }
+      for (i = 0; i < 3; ++i)
+        {
+        this->StreamedBounds[2*i] = 
+          (bounds[2*i] < this->StreamedBounds[2*i] ?
+           bounds[2*i] : this->StreamedBounds[2*i]);
+        this->StreamedBounds[2*i+1] = 
+          (bounds[2*i+1] > this->StreamedBounds[2*i+1] ?
+           bounds[2*i+1] : this->StreamedBounds[2*i+1]);
+        }
+      this->StreamedNumberOfPoints += input->GetNumberOfPoints();
+      }
+    this->UpdateProgress(0.5 * (this->CurrentStreamDivision + 1) /
+                         this->NumberOfStreamDivisions);
+    if (++this->CurrentStreamDivision < this->NumberOfStreamDivisions)
+      {
+      request->Set(vtkStreamingDemandDrivenPipeline::CONTINUE_EXECUTING(), 1);
+      return 1;
+      }
+    this->CurrentStreamDivision = 0;
+    if (this->StreamedNumberOfPoints == 0)
+      {
+      // Nothing to cluster.
+      this->StreamingPass = 0;
+      request->Remove(vtkStreamingDemandDrivenPipeline::CONTINUE_EXECUTING());
+      return 1;
+      }
+    this->AdjustNumberOfDivisions(this->StreamedNumberOfPoints);
+    this->StartAppend(this->StreamedBounds);
+    this->StreamedVertexBins = vtkCellArray::New();
+    this->StreamingPass = 2;
+    request->Set(vtkStreamingDemandDrivenPipeline::CONTINUE_EXECUTING(), 1);
+    return 1;
+    }
+
+  // Clustering pass: append the piece. The vertex cells are only added to
+  // the output at the end, so save them as lists of bins.
+  if (input->GetNumberOfPoints() > 0)
+    {
+    this->Append(input);
+    vtkCellArray *verts = input->GetVerts();
+    vtkIdType numPts = 0;
+    vtkIdType *ptIds = 0;
+    double pt[3];
+    for (verts->InitTraversal(); verts->GetNextCell(numPts, ptIds); )
+      {
+      this->StreamedVertexBins->InsertNextCell(static_cast<int>(numPts));
+      for (vtkIdType j = 0; j < numPts; ++j)
+        {
+        input->GetPoint(ptIds[j], pt);
+        this->StreamedVertexBins->InsertCellPoint(this->HashPoint(pt));
+        }
+      }
+    }
+  this->UpdateProgress(0.5 + 0.5 * (this->CurrentStreamDivision + 1) /
+                       this->NumberOfStreamDivisions);
+  if (++this->CurrentStreamDivision < this->NumberOfStreamDivisions)
+    {
+    request->Set(vtkStreamingDemandDrivenPipeline::CONTINUE_EXECUTING(), 1);
+    return 1;
+    }
+
+  // Last piece.
+  this->EndAppend();
+  if (this->QuadricArray)
+    {
+    delete [] this->QuadricArray;
+    this->QuadricArray = NULL;
+    }
+  if (this->BinStore)
+    {
+    delete this->BinStore;
+    this->BinStore = NULL;
+    }
+  this->StreamedVertexBins->Delete();
+  this->StreamedVertexBins = NULL;
+  this->CurrentStreamDivision = 0;
+  this->StreamingPass = 0;
+  request->Remove(vtkStreamingDemandDrivenPipeline::CONTINUE_EXECUTING());
+
+  return 1;
+}
+
+//----------------------------------------------------------------------------
+// Lets limit the number of divisions based on the number of points in the
+// input.
+void vtkQuadricClustering::AdjustNumberOfDivisions(vtkIdType numPoints)
+{
+  double target = static_cast<double>(numPoints);
+  double numDiv = floor((static_cast<double>(this->NumberOfXDivisions) *
+                         this->NumberOfYDivisions *
+                         this->NumberOfZDivisions) / 2);
+  if (this->AutoAdjustNumberOfDivisions && numDiv > target) 
+    {
+    double factor = pow((numDiv/target),0.33333);
+    this->NumberOfDivisions[0] = 
+      (int)(0.5+(double)(this->NumberOfXDivisions)/factor);  
+    this->NumberOfDivisions[0] = (this->NumberOfDivisions[0] > 0 ? this->NumberOfDivisions[0] : 1);
+    this->NumberOfDivisions[1] = 
+      (int)(0.5+(double)(this->NumberOfYDivisions)/factor);  
+    this->NumberOfDivisions[1] = (this->NumberOfDivisions[1] > 0 ? this->NumberOfDivisions[1] : 1);
+    this->NumberOfDivisions[2] = 
+      (int)(0.5+(double)(this->NumberOfZDivisions)/factor);  
+    this->NumberOfDivisions[2] = (this->NumberOfDivisions[2] > 0 ? this->NumberOfDivisions[2] : 1);
+    }
+  else
+    {
+    this->NumberOfDivisions[0] = this->NumberOfXDivisions;
+    this->NumberOfDivisions[1] = this->NumberOfYDivisions;
+    this->NumberOfDivisions[2] = this->NumberOfZDivisions;
+    }
+}
+
 //----------------------------------------------------------------------------
 void vtkQuadricClustering::StartAppend(double *bounds)
 {
@@ -235,7 +791,8 @@ void vtkQuadricClustering::StartAppend(double *bounds)
     {
     this->CellSet = new vtkQuadricClusteringCellSet;
     this->NumberOfBins = 
-      this->NumberOfDivisions[0]*this->NumberOfDivisions[1]*this->NumberOfDivisions[2];
+      static_cast<vtkIdType>(this->NumberOfDivisions[0])*
+      this->NumberOfDivisions[1]*this->NumberOfDivisions[2];
     }
 
   // Copy over the bounds.
@@ -299,6 +856,8 @@ void vtkQuadricClustering::StartAppend(double *bounds)
   this->XBinStep = (this->XBinSize > 0.0) ? (1.0/this->XBinSize) : 0.0;
   this->YBinStep = (this->YBinSize > 0.0) ? (1.0/this->YBinSize) : 0.0;
   this->ZBinStep = (this->ZBinSize > 0.0) ? (1.0/this->ZBinSize) : 0.0;
+  this->SliceSize =
+    static_cast<vtkIdType>(this->NumberOfDivisions[0])*this->NumberOfDivisions[1];
 
   this->NumberOfBinsUsed = 0;
   if (this->QuadricArray)
@@ -306,14 +865,26 @@ void vtkQuadricClustering::StartAppend(double *bounds)
     delete [] this->QuadricArray;
     this->QuadricArray = NULL;
     }
-  this->QuadricArray = 
-    new vtkQuadricClustering::PointQuadric[this->NumberOfDivisions[0] *
-                                          this->NumberOfDivisions[1] *
-                                          this->NumberOfDivisions[2]];
-  if (this->QuadricArray == NULL)
+  if (this->BinStore)
     {
-    vtkErrorMacro("Could not allocate quadric grid.");
-    return;
+    delete this->BinStore;
+    this->BinStore = NULL;
+    }
+  if (this->UseSparseBins)
+    {
+    this->BinStore = new vtkQuadricClusteringBinStore(
+      this->SliceSize*this->NumberOfDivisions[2]);
+    }
+  else
+    {
+    this->QuadricArray = 
+      new vtkQuadricClustering::PointQuadric[this->SliceSize *
+                                            this->NumberOfDivisions[2]];
+    if (this->QuadricArray == NULL)
+      {
+      vtkErrorMacro("Could not allocate quadric grid.");
+      return;
+      }
     }
 
   vtkInformation *inInfo = this->GetExecutive()->GetInputInformation(0, 0);
@@ -328,7 +899,7 @@ void vtkQuadricClustering::StartAppend(double *bounds)
     outInfo->Get(vtkDataObject::DATA_OBJECT()));
 
   // Allocate CellData here.
-  if (this->CopyCellData && input)
+  if (this->CopyCellData && input && !this->StreamingPass)
     {
     output->GetCellData()->CopyAllocate(
       input->GetCellData(), this->NumberOfBinsUsed);
@@ -354,31 +925,34 @@ void vtkQuadricClustering::Append(vtkPolyData *pd)
   vtkPolyData *output = vtkPolyData::SafeDownCast(
     outInfo->Get(vtkDataObject::DATA_OBJECT()));
 
+  // The cell data of streamed pieces is not copied.
+  vtkPolyData *input = (this->StreamingPass ? NULL : pd);
+
   inputVerts = pd->GetVerts();
   if (inputVerts)
     {
-    this->AddVertices(inputVerts, inputPoints, 1, pd, output);
+    this->AddVertices(inputVerts, inputPoints, 1, input, output);
     }
   this->UpdateProgress(.40);
 
   inputLines = pd->GetLines();
   if (inputLines)
     {
-    this->AddEdges(inputLines, inputPoints, 1, pd, output);
+    this->AddEdges(inputLines, inputPoints, 1, input, output);
     }
   this->UpdateProgress(.60);
 
   inputPolys = pd->GetPolys();
   if (inputPolys)
     {
-    this->AddPolygons(inputPolys, inputPoints, 1, pd, output);
+    this->AddPolygons(inputPolys, inputPoints, 1, input, output);
     }
   this->UpdateProgress(.80);
 
   inputStrips = pd->GetStrips();
   if (inputStrips)
     {
-    this->AddStrips(inputStrips, inputPoints, 1, pd, output);
+    this->AddStrips(inputStrips, inputPoints, 1, input, output);
     }
 }
 
@@ -387,11 +961,9 @@ void vtkQuadricClustering::AddPolygons(vtkCellArray *polys, vtkPoints *points,
                                        int geometryFlag,
                                        vtkPolyData *input, vtkPolyData *output)
 {
-  int j;
   vtkIdType *ptIds = 0;
   vtkIdType numPts = 0;
-  double pts0[3], pts1[3], pts2[3];
-  vtkIdType binIds[3];
+  vtkIdType cellId, tri;
 
   double total = polys->GetNumberOfCells();
   double curr = 0;
@@ -402,25 +974,78 @@ void vtkQuadricClustering::AddPolygons(vtkCellArray *polys, vtkPoints *points,
     }
   double cstep = step;
 
-  for ( polys->InitTraversal(); polys->GetNextCell(numPts, ptIds); )
-    {
-    points->GetPoint(ptIds[0],pts0);
-    binIds[0] = this->HashPoint(pts0);
-    for (j=0; j < numPts-2; j++)//creates triangles; assumes poly is convex
+  vtkQuadricClusteringTriangleBatch batch;
+  batch.Self = this;
+  batch.Points = points;
+
+  polys->InitTraversal();
+  int done = 0;
+  while (!done)
+    {
+    // Gather the next batch of cells.
+    batch.CellPoints.clear();
+    batch.CellSizes.clear();
+    batch.FirstTriangle.clear();
+    vtkIdType numTris = 0;
+    while (static_cast<int>(batch.CellSizes.size()) <
+           VTK_QUADRIC_CLUSTERING_BATCH_SIZE)
       {
-      points->GetPoint(ptIds[j+1],pts1);
-      binIds[1] = this->HashPoint(pts1);
-      points->GetPoint(ptIds[j+2],pts2);
-      binIds[2] = this->HashPoint(pts2);
-      this->AddTriangle(binIds, pts0, pts1, pts2, geometryFlag, input, output);
+      if (!polys->GetNextCell(numPts, ptIds))
+        {
+        done = 1;
+        break;
+        }
+      batch.CellPoints.push_back(ptIds);
+      batch.CellSizes.push_back(numPts);
+      batch.FirstTriangle.push_back(numTris);
+      numTris += (numPts > 2 ? numPts-2 : 0); // assumes poly is convex
       }
-    ++this->InCellCount;
-    if ( curr > cstep )
+    vtkIdType numCells = static_cast<vtkIdType>(batch.CellSizes.size());
+    if (numCells == 0)
       {
-      this->UpdateProgress(.6 + .2 * curr / total);
-      cstep += step;
+      break;
+      }
+    batch.FirstTriangle.push_back(numTris);
+    batch.BinIds.resize(3*numTris + 1);
+    batch.Quadrics.resize(9*numTris + 1);
+
+    // Compute the bins and quadrics of the triangles.
+    vtkIdType numThreads = numTris / VTK_QUADRIC_CLUSTERING_TRIS_PER_THREAD;
+    if (numThreads > vtkMultiThreader::GetGlobalDefaultNumberOfThreads())
+      {
+      numThreads = vtkMultiThreader::GetGlobalDefaultNumberOfThreads();
+      }
+    if (numThreads > 1)
+      {
+      vtkMultiThreader *threader = vtkMultiThreader::New();
+      threader->SetNumberOfThreads(static_cast<int>(numThreads));
+      threader->SetSingleMethod(vtkQuadricClusteringTriangleThread, &batch);
+      threader->SingleMethodExecute();
+      threader->Delete();
+      }
+    else
+      {
+      batch.ComputeCells(0, numCells);
+      }
+
+    // Add them to the bins, in order.
+    for (cellId = 0; cellId < numCells; ++cellId)
+      {
+      for (tri = batch.FirstTriangle[cellId];
+           tri < batch.FirstTriangle[cellId+1]; ++tri)
+        {
+        this->AddTriangleQuadric(&batch.BinIds[3*tri], &batch.Quadrics[9*tri],
+                                 geometryFlag, input, output);
+        }
+      ++this->InCellCount;
+      this->CheckBinMemory();
+      if ( curr > cstep )
+        {
+        this->UpdateProgress(.6 + .2 * curr / total);
+        cstep += step;
+        }
+      curr += 1;
       }
-    curr += 1;
     }//for all polygons
 }
 
@@ -458,6 +1083,7 @@ void vtkQuadricClustering::AddStrips(vtkCellArray *strips, vtkPoints *points,
       odd = odd ? 0 : 1;
       }
     ++this->InCellCount;
+    this->CheckBinMemory();
     }
 }
 
@@ -484,10 +1110,35 @@ inline void vtkQuadricClustering::InitializeQuadric(double quadric[9])
 void vtkQuadricClustering::AddTriangle(vtkIdType *binIds, double *pt0, double *pt1,
                                        double *pt2, int geometryFlag,
                                        vtkPolyData *input, vtkPolyData *output)
+{
+  double quadric[9];
+
+  // Special condition for fast execution.
+  // Only add triangles that traverse three bins to quadrics.
+  if (this->UseInternalTriangles == 0)
+    {
+    if (binIds[0] == binIds[1] || binIds[0] == binIds[2] ||
+        binIds[1] == binIds[2])
+      {
+      return;
+      }
+    }
+ 
+  // Compute the quadric.
+  vtkQuadricClusteringTriangleQuadric(pt0, pt1, pt2, quadric);
+  this->AddTriangleQuadric(binIds, quadric, geometryFlag, input, output);
+}
+
+//----------------------------------------------------------------------------
+// Same as AddTriangle, with the quadric of the triangle already computed.
+void vtkQuadricClustering::AddTriangleQuadric(vtkIdType *binIds,
+                                              double quadric[9],
+                                              int geometryFlag,
+                                              vtkPolyData *input,
+                                              vtkPolyData *output)
 {
   int i;
   vtkIdType triPtIds[3];
-  double quadric[9], quadric4x4[4][4];
   vtkIdType minIdx, midIdx, maxIdx, idx;
 
   // Special condition for fast execution.
@@ -500,33 +1151,12 @@ void vtkQuadricClustering::AddTriangle(vtkIdType *binIds, double *pt0, double *p
       return;
       }
     }
- 
-  // Compute the quadric.
-  vtkTriangle::ComputeQuadric(pt0, pt1, pt2, quadric4x4);
-  quadric[0] = quadric4x4[0][0];
-  quadric[1] = quadric4x4[0][1];
-  quadric[2] = quadric4x4[0][2];
-  quadric[3] = quadric4x4[0][3];
-  quadric[4] = quadric4x4[1][1];
-  quadric[5] = quadric4x4[1][2];
-  quadric[6] = quadric4x4[1][3];
-  quadric[7] = quadric4x4[2][2];
-  quadric[8] = quadric4x4[2][3];
 
   // Add the quadric to each of the three corner bins.
+  // Points and segments supercede triangles.
   for (i = 0; i < 3; ++i)
     {
-    // If the current quadric is not initialized, then clear it out.
-    if (this->QuadricArray[binIds[i]].Dimension > 2)
-      {
-      this->QuadricArray[binIds[i]].Dimension = 2; 
-      // Initialize the coeff
-      this->InitializeQuadric(this->QuadricArray[binIds[i]].Quadric);
-      }
-    if (this->QuadricArray[binIds[i]].Dimension == 2)
-      { // Points and segments supercede triangles.
-      this->AddQuadric(binIds[i], quadric);
-      }
+    this->AddQuadric(binIds[i], quadric, 2);
     }
 
   if (geometryFlag)
@@ -535,12 +1165,7 @@ void vtkQuadricClustering::AddTriangle(vtkIdType *binIds, double *pt0, double *p
     for (i = 0; i < 3; i++)
       {
       // Get the vertex from each bin.
-      if (this->QuadricArray[binIds[i]].VertexId == -1)
-        {
-        this->QuadricArray[binIds[i]].VertexId = this->NumberOfBinsUsed;
-        this->NumberOfBinsUsed++;
-        }
-      triPtIds[i] = this->QuadricArray[binIds[i]].VertexId;
+      triPtIds[i] = this->AddBinVertex(binIds[i]);
       }
     // This comparison could just as well be on triPtIds.
     if (binIds[0] != binIds[1] && binIds[0] != binIds[2] &&
@@ -652,6 +1277,7 @@ void vtkQuadricClustering::AddEdges(vtkCellArray *edges, vtkPoints *points,
         }
       }
     ++this->InCellCount;
+    this->CheckBinMemory();
     }
 }
 //----------------------------------------------------------------------------
@@ -721,19 +1347,10 @@ void vtkQuadricClustering::AddEdge(vtkIdType *binIds, double *pt0, double *pt1,
   q[7] = length2*(1.0 - d[2]*d[2]);
   q[8] = length2*(d[2]*md - m[2]);
 
+  // Points supercede segements.
   for (i = 0; i < 2; ++i)
     {
-    // If the current quadric is from triangles (or not initialized), then clear it out.
-    if (this->QuadricArray[binIds[i]].Dimension > 1)
-      {
-      this->QuadricArray[binIds[i]].Dimension = 1; 
-      // Initialize the coeff
-      this->InitializeQuadric(this->QuadricArray[binIds[i]].Quadric);
-      }
-    if (this->QuadricArray[binIds[i]].Dimension == 1)
-      { // Points supercede segements.
-      this->AddQuadric(binIds[i], q);
-      }
+    this->AddQuadric(binIds[i], q, 1);
     }
 
   if (geometryFlag)
@@ -742,12 +1359,7 @@ void vtkQuadricClustering::AddEdge(vtkIdType *binIds, double *pt0, double *pt1,
     for (i = 0; i < 2; i++)
       {
       // Get the vertex from each bin.
-      if (this->QuadricArray[binIds[i]].VertexId == -1)
-        {
-        this->QuadricArray[binIds[i]].VertexId = this->NumberOfBinsUsed;
-        this->NumberOfBinsUsed++;
-        }
-      edgePtIds[i] = this->QuadricArray[binIds[i]].VertexId;
+      edgePtIds[i] = this->AddBinVertex(binIds[i]);
       }
     // This comparison could just as well be on edgePtIds.
     if (binIds[0] != binIds[1])
@@ -796,6 +1408,7 @@ void vtkQuadricClustering::AddVertices(vtkCellArray *verts, vtkPoints *points,
       this->AddVertex(binId, pt, geometryFlag, input, output);
       }
     ++this->InCellCount;
+    this->CheckBinMemory();
 
     if ( curr > next )
       {
@@ -840,28 +1453,17 @@ void vtkQuadricClustering::AddVertex(vtkIdType binId, double *pt,
   q[7] = 1.0;
   q[8] = -pt[2];
 
-  // If the current quadric is from triangles, edges (or not initialized),
-  // then clear it out.
-  if (this->QuadricArray[binId].Dimension > 0)
-    {
-    this->QuadricArray[binId].Dimension = 0; 
-    // Initialize the coeff
-    this->InitializeQuadric(this->QuadricArray[binId].Quadric);
-    }
-  if (this->QuadricArray[binId].Dimension == 0)
-    { // Points supercede all other types of quadrics.
-    this->AddQuadric(binId, q);
-    }
+  // Points supercede all other types of quadrics.
+  this->AddQuadric(binId, q, 0);
 
   if (geometryFlag)
     {
     // Now add the vert to the geometry.
     // Get the vertex from the bin.
-    if (this->QuadricArray[binId].VertexId == -1)
+    vtkIdType numBinsUsed = this->NumberOfBinsUsed;
+    this->AddBinVertex(binId);
+    if (this->NumberOfBinsUsed > numBinsUsed)
       {
-      this->QuadricArray[binId].VertexId = this->NumberOfBinsUsed;
-      this->NumberOfBinsUsed++;
-
       if (this->CopyCellData && input)
         {
         output->GetCellData()->
@@ -873,9 +1475,34 @@ void vtkQuadricClustering::AddVertex(vtkIdType binId, double *pt,
 }
 
 //----------------------------------------------------------------------------
-void vtkQuadricClustering::AddQuadric(vtkIdType binId, double quadric[9])
+void vtkQuadricClustering::AddQuadric(vtkIdType binId, double quadric[9],
+                                      int dimension)
 {
-  double *q = this->QuadricArray[binId].Quadric;
+  unsigned char *binDimension;
+  double *q;
+  if (this->QuadricArray)
+    {
+    binDimension = &this->QuadricArray[binId].Dimension;
+    q = this->QuadricArray[binId].Quadric;
+    }
+  else
+    {
+    vtkQuadricClusteringBinStore::Bin &bin = this->BinStore->Bins[binId];
+    binDimension = &bin.Dimension;
+    q = bin.Quadric;
+    }
+
+  // If the current quadric is from cells of higher dimension (or not
+  // initialized), then clear it out.
+  if (*binDimension > dimension)
+    {
+    *binDimension = static_cast<unsigned char>(dimension);
+    this->InitializeQuadric(q);
+    }
+  if (*binDimension < dimension)
+    {
+    return;
+    }
   
   for (int i=0; i<9; i++)
     {
@@ -883,6 +1510,144 @@ void vtkQuadricClustering::AddQuadric(vtkIdType binId, double quadric[9])
     }
 }
 
+//----------------------------------------------------------------------------
+double *vtkQuadricClustering::GetBinQuadric(vtkIdType binId)
+{
+  if (this->QuadricArray)
+    {
+    return this->QuadricArray[binId].Quadric;
+    }
+  vtkQuadricClusteringBinStore::BinMap::iterator it =
+    this->BinStore->Bins.find(binId);
+  return (it == this->BinStore->Bins.end() ? NULL : it->second.Quadric);
+}
+
+//----------------------------------------------------------------------------
+vtkIdType vtkQuadricClustering::GetBinVertexId(vtkIdType binId)
+{
+  if (this->QuadricArray)
+    {
+    return this->QuadricArray[binId].VertexId;
+    }
+  vtkQuadricClusteringBinStore::VertexIdMap::iterator it =
+    this->BinStore->VertexIds.find(binId);
+  return (it == this->BinStore->VertexIds.end() ? -1 : it->second);
+}
+
+//----------------------------------------------------------------------------
+vtkIdType vtkQuadricClustering::AddBinVertex(vtkIdType binId)
+{
+  vtkIdType *vertexId;
+  if (this->QuadricArray)
+    {
+    vertexId = &this->QuadricArray[binId].VertexId;
+    }
+  else
+    {
+    vertexId = &this->BinStore->VertexIds.insert(
+      vtkQuadricClusteringBinStore::VertexIdMap::value_type(binId, -1)).
+      first->second;
+    }
+  if (*vertexId == -1)
+    {
+    *vertexId = this->NumberOfBinsUsed;
+    this->NumberOfBinsUsed++;
+    }
+  return *vertexId;
+}
+
+//----------------------------------------------------------------------------
+void vtkQuadricClustering::RemoveBinVertex(vtkIdType binId)
+{
+  if (this->QuadricArray)
+    {
+    this->QuadricArray[binId].VertexId = -1;
+    }
+  else
+    {
+    this->BinStore->VertexIds.erase(binId);
+    }
+}
+
+//----------------------------------------------------------------------------
+void vtkQuadricClustering::CheckBinMemory()
+{
+  if (!this->BinStore || this->BinStore->SpillFailed ||
+      this->MaximumNumberOfBinsInMemory <= 0 ||
+      static_cast<vtkIdType>(this->BinStore->Bins.size()) <=
+      this->MaximumNumberOfBinsInMemory)
+    {
+    return;
+    }
+  if (!this->BinStore->Spill(this->SpillDirectory))
+    {
+    vtkErrorMacro("Could not write the bin quadrics to disk; they are kept "
+                  "in memory.");
+    this->BinStore->SpillFailed = 1;
+    }
+}
+
+//----------------------------------------------------------------------------
+void vtkQuadricClustering::ComputeSparseRepresentativePoints(
+  vtkPoints *outputPoints)
+{
+  vtkQuadricClusteringBinStore *store = this->BinStore;
+  vtkQuadricClusteringBinStore::BinMap::iterator it;
+  vtkIdType vertexId;
+  double newPt[3];
+
+  if (!store->Spilled)
+    {
+    for (it = store->Bins.begin(); it != store->Bins.end(); ++it)
+      {
+      if ((vertexId = this->GetBinVertexId(it->first)) != -1)
+        {
+        this->ComputeRepresentativePoint(it->second.Quadric, it->first, newPt);
+        outputPoints->InsertPoint(vertexId, newPt);
+        }
+      }
+    return;
+    }
+
+  // Write the bins still in memory, then merge the files one at a time.
+  // If the bins cannot be written, merge the files into memory instead.
+  vtkQuadricClusteringBinStore::BinMap bins;
+  int numFiles = VTK_QUADRIC_CLUSTERING_SPILL_FILES;
+  if (!store->Spill(this->SpillDirectory))
+    {
+    vtkWarningMacro("Could not write the bin quadrics to disk; merging "
+                    "them in memory.");
+    if (!store->LoadAll())
+      {
+      vtkErrorMacro("Could not read the bin quadrics back from disk.");
+      return;
+      }
+    bins.swap(store->Bins);
+    numFiles = 1;
+    }
+  for (int file = 0; file < numFiles; ++file)
+    {
+    if (numFiles > 1)
+      {
+      bins.clear();
+      if (!store->Load(file, bins))
+        {
+        vtkErrorMacro("Could not read the bin quadrics back from disk.");
+        return;
+        }
+      }
+    for (it = bins.begin(); it != bins.end(); ++it)
+      {
+      if ((vertexId = this->GetBinVertexId(it->first)) != -1)
+        {
+        this->ComputeRepresentativePoint(it->second.Quadric, it->first, newPt);
+        outputPoints->InsertPoint(vertexId, newPt);
+        }
+      }
+    this->UpdateProgress(0.8 + 0.2*(file+1)/numFiles);
+    }
+}
+
 //----------------------------------------------------------------------------
 vtkIdType vtkQuadricClustering::HashPoint(double point[3])
 {
@@ -922,7 +1687,8 @@ vtkIdType vtkQuadricClustering::HashPoint(double point[3])
     }
   
   // vary x fastest, then y, then z
-  binId = xBinCoord + yBinCoord*this->NumberOfDivisions[0] + 
+  binId = xBinCoord +
+    static_cast<vtkIdType>(yBinCoord)*this->NumberOfDivisions[0] +
     zBinCoord*this->SliceSize;
 
   return binId;
@@ -946,8 +1712,7 @@ void vtkQuadricClustering::EndAppend()
   int abortExecute=0;
   vtkPoints *outputPoints;
   double newPt[3];
-  numBuckets = this->NumberOfDivisions[0] * this->NumberOfDivisions[1] * 
-                this->NumberOfDivisions[2];
+  numBuckets = this->SliceSize * this->NumberOfDivisions[2];
   double step = (double)numBuckets / 10.0;
   if (step < 1000.0)
     {
@@ -971,6 +1736,11 @@ void vtkQuadricClustering::EndAppend()
 
   // Compute the representative points for each bin
   outputPoints = vtkPoints::New();
+  if (this->BinStore)
+    {
+    this->ComputeSparseRepresentativePoints(outputPoints);
+    numBuckets = 0;
+    }
   for (i = 0; !abortExecute && i < numBuckets; i++ )
     {
     if (cstep > step)
@@ -1007,7 +1777,14 @@ void vtkQuadricClustering::EndAppend()
   this->OutputLines->Delete();
   this->OutputLines = NULL;
 
-  this->EndAppendVertexGeometry(input, output);
+  if (this->StreamedVertexBins)
+    {
+    this->EndAppendVertexBins(output);
+    }
+  else
+    {
+    this->EndAppendVertexGeometry(input, output);
+    }
 
   // Tell the data is is up to date 
   // (in case the user calls this method directly).
@@ -1019,6 +1796,11 @@ void vtkQuadricClustering::EndAppend()
     delete [] this->QuadricArray;
     this->QuadricArray = NULL;
     }
+  if (this->BinStore)
+    {
+    delete this->BinStore;
+    this->BinStore = NULL;
+    }
 }
 
 
@@ -1047,9 +1829,10 @@ void vtkQuadricClustering::ComputeRepresentativePoint(double quadric[9],
   quadric4x4[2][3] = quadric4x4[3][2] = quadric[8];
   quadric4x4[3][3] = 1;  // arbitrary value
   
-  x = binId % this->NumberOfDivisions[0];
-  y = (binId / this->NumberOfDivisions[0]) % this->NumberOfDivisions[1];
-  z = binId / this->SliceSize;
+  x = static_cast<int>(binId % this->NumberOfDivisions[0]);
+  y = static_cast<int>((binId / this->NumberOfDivisions[0]) %
+                       this->NumberOfDivisions[1]);
+  z = static_cast<int>(binId / this->SliceSize);
 
   cellBounds[0] = this->Bounds[0] + x * this->XBinSize;
   cellBounds[1] = this->Bounds[0] + (x+1) * this->XBinSize;
@@ -1271,6 +2054,8 @@ void vtkQuadricClustering::EndAppendUsingPoints(vtkPolyData *input,
   vtkIdType   binId;
   double       *minError, e, pt[3];
   double       *q;
+  vtksys::hash_map<vtkIdType, double,
+                   vtkQuadricClusteringIdTypeHash> sparseMinError;
 
   inputPoints = input->GetPoints();
   if (inputPoints == NULL)
@@ -1299,12 +2084,30 @@ void vtkQuadricClustering::EndAppendUsingPoints(vtkPolyData *input,
     CopyAllocate(input->GetPointData(), this->NumberOfBinsUsed);
 
   // Allocate and initialize an array to hold errors for each bin.
-  numBins = this->NumberOfDivisions[0] * this->NumberOfDivisions[1] 
-                  * this->NumberOfDivisions[2];
-  minError = new double[numBins];
-  for (i = 0; i < numBins; ++i)
+  // Sparse bins use a hash table instead, and need all their quadrics in
+  // memory.
+  minError = NULL;
+  if (this->BinStore)
+    {
+    // Bring the bins written to disk back into memory. If the last ones
+    // cannot be written first, the files are merged with them in memory.
+    if (this->BinStore->Spilled)
+      {
+      this->BinStore->Spill(this->SpillDirectory);
+      if (!this->BinStore->LoadAll())
+        {
+        vtkErrorMacro("Could not read the bin quadrics back from disk.");
+        }
+      }
+    }
+  else
     {
-    minError[i] = VTK_DOUBLE_MAX;
+    numBins = this->SliceSize * this->NumberOfDivisions[2];
+    minError = new double[numBins];
+    for (i = 0; i < numBins; ++i)
+      {
+      minError[i] = VTK_DOUBLE_MAX;
+      }
     }
 
   // Loop through the input points.
@@ -1313,7 +2116,7 @@ void vtkQuadricClustering::EndAppendUsingPoints(vtkPolyData *input,
     {
     inputPoints->GetPoint(i, pt);
     binId = this->HashPoint(pt);
-    outPtId = this->QuadricArray[binId].VertexId;
+    outPtId = this->GetBinVertexId(binId);
     // Sanity check.
     if (outPtId == -1)
       {
@@ -1326,13 +2129,22 @@ void vtkQuadricClustering::EndAppendUsingPoints(vtkPolyData *input,
     // Compute the error for this point.  Note: the constant term is ignored.
     // It will be the same for every point in this bin, and it
     // is not stored in the quadric array anyway.
-    q = this->QuadricArray[binId].Quadric;
+    q = this->GetBinQuadric(binId);
+    if (!q)
+      {
+      vtkErrorMacro("No quadric for bin " << binId << ".");
+      break;
+      }
     e = q[0]*pt[0]*pt[0] + 2.0*q[1]*pt[0]*pt[1] + 2.0*q[2]*pt[0]*pt[2] + 2.0*q[3]*pt[0]
           + q[4]*pt[1]*pt[1] + 2.0*q[5]*pt[1]*pt[2] + 2.0*q[6]*pt[1]
           + q[7]*pt[2]*pt[2] + 2.0*q[8]*pt[2];
-    if (e < minError[binId])
+    double &binError = (minError ? minError[binId] :
+      sparseMinError.insert(vtksys::hash_map<vtkIdType, double,
+        vtkQuadricClusteringIdTypeHash>::value_type(binId, VTK_DOUBLE_MAX)).
+        first->second);
+    if (e < binError)
       {
-      minError[binId] = e;
+      binError = e;
       outputPoints->InsertPoint(outPtId, pt);
 
       // Since this is the same point as the input point, copy point data here too.
@@ -1360,6 +2172,11 @@ void vtkQuadricClustering::EndAppendUsingPoints(vtkPolyData *input,
     delete [] this->QuadricArray;
     this->QuadricArray = NULL;
     }
+  if (this->BinStore)
+    {
+    delete this->BinStore;
+    this->BinStore = NULL;
+    }
 
   delete [] minError;
 }
@@ -1400,11 +2217,11 @@ void vtkQuadricClustering::EndAppendVertexGeometry(vtkPolyData *input,
       {
       input->GetPoint(ptIds[j], pt);
       binId = this->HashPoint(pt);
-      outPtId = this->QuadricArray[binId].VertexId;
+      outPtId = this->GetBinVertexId(binId);
       if (outPtId >= 0)
         {
         // Do not use this point.  Destroy infomration in Quadric array.
-        this->QuadricArray[binId].VertexId = -1;
+        this->RemoveBinVertex(binId);
         tmp[tmpIdx] = outPtId;
         ++tmpIdx;
         }
@@ -1431,6 +2248,43 @@ void vtkQuadricClustering::EndAppendVertexGeometry(vtkPolyData *input,
 }
 
 
+//----------------------------------------------------------------------------
+void vtkQuadricClustering::EndAppendVertexBins(vtkPolyData *output)
+{
+  vtkCellArray *outVerts = vtkCellArray::New();
+  vtkstd::vector<vtkIdType> ptIds;
+  vtkIdType *binIds = 0;
+  vtkIdType numBins = 0;
+  vtkIdType outPtId;
+
+  vtkCellArray *verts = this->StreamedVertexBins;
+  for (verts->InitTraversal(); verts->GetNextCell(numBins, binIds); )
+    {
+    ptIds.clear();
+    for (vtkIdType j = 0; j < numBins; ++j)
+      {
+      outPtId = this->GetBinVertexId(binIds[j]);
+      if (outPtId >= 0)
+        {
+        // Only the first vertex cell of a bin uses its point.
+        this->RemoveBinVertex(binIds[j]);
+        ptIds.push_back(outPtId);
+        }
+      }
+    if (!ptIds.empty())
+      {
+      outVerts->InsertNextCell(static_cast<vtkIdType>(ptIds.size()),
+                               &ptIds[0]);
+      }
+    }
+
+  if (outVerts->GetNumberOfCells() > 0)
+    {
+    output->SetVerts(outVerts);
+    }
+  outVerts->Delete();
+}
+
 //----------------------------------------------------------------------------
 // This method is called after the execution, but before the vertex array
 // is deleted. It changes some points to be based on the boundary edges.
@@ -1621,5 +2475,13 @@ void vtkQuadricClustering::PrintSelf(ostream& os, vtkIndent indent)
 
   os << indent << "Prevent Duplicate Cells : " 
      << (this->PreventDuplicateCells ? "On\n" : "Off\n");
+  os << indent << "Use Sparse Bins: " 
+     << (this->UseSparseBins ? "On\n" : "Off\n");
+  os << indent << "Maximum Number Of Bins In Memory: "
+     << this->MaximumNumberOfBinsInMemory << "\n";
+  os << indent << "Spill Directory: "
+     << (this->SpillDirectory ? this->SpillDirectory : "(none)") << "\n";
+  os << indent << "Number Of Stream Divisions: "
+     << this->NumberOfStreamDivisions << "\n";
 }
 
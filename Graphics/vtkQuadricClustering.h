@@ -56,6 +56,13 @@
 // this approach does not fit into the visualization architecture and requires
 // manual control, it has the advantage that extremely large data can be 
 // processed in pieces and appended to the filter piece-by-piece.
+//
+// The same can be done within the pipeline with NumberOfStreamDivisions:
+// the filter then requests the input one piece at a time and appends each
+// piece as it arrives. Combined with UseSparseBins and
+// MaximumNumberOfBinsInMemory, which keep only the used bins and move their
+// quadrics to temporary files when there are too many, the memory used no
+// longer depends on the size of the input.
 
 
 // .SECTION Caveats
@@ -86,6 +93,10 @@ class vtkCellArray;
 class vtkFeatureEdges;
 class vtkPoints;
 class vtkQuadricClusteringCellSet;
+//BTX
+class vtkQuadricClusteringBinStore;
+class vtkQuadricClusteringTriangleBatch;
+//ETX
 
 
 class VTK_GRAPHICS_EXPORT vtkQuadricClustering : public vtkPolyDataAlgorithm
@@ -213,13 +224,61 @@ public:
   vtkGetMacro(PreventDuplicateCells,int);
   vtkBooleanMacro(PreventDuplicateCells,int);
 
+  // Description:
+  // When this flag is on, only the bins that are used are stored, in a hash
+  // table, instead of all NumberOfXDivisions*NumberOfYDivisions*
+  // NumberOfZDivisions bins. The memory used then grows with the size of the
+  // output rather than with the number of divisions, which allows much finer
+  // binnings. This is off by default.
+  vtkSetMacro(UseSparseBins,int);
+  vtkGetMacro(UseSparseBins,int);
+  vtkBooleanMacro(UseSparseBins,int);
+
+  // Description:
+  // When UseSparseBins is on, the largest number of bin quadrics held in
+  // memory. Past this number, the quadrics are written to temporary files
+  // and merged back, one slab of bins at a time, when the output points are
+  // computed. The output point id of each used bin stays in memory. 0 (the
+  // default) means no limit.
+  vtkSetClampMacro(MaximumNumberOfBinsInMemory,vtkIdType,0,VTK_LARGE_ID);
+  vtkGetMacro(MaximumNumberOfBinsInMemory,vtkIdType);
+
+  // Description:
+  // Directory of the temporary files used when MaximumNumberOfBinsInMemory
+  // is exceeded. When not set, the files are created with tmpfile().
+  vtkSetStringMacro(SpillDirectory);
+  vtkGetStringMacro(SpillDirectory);
+
+  // Description:
+  // Number of pieces the input is requested in (through
+  // UPDATE_PIECE_NUMBER and UPDATE_NUMBER_OF_PIECES), one after the other,
+  // so that the whole input never has to be in memory. Unless the input
+  // information provides WHOLE_BOUNDING_BOX, the pieces are requested twice:
+  // once to compute the bounds and once to cluster them. UseInputPoints,
+  // UseFeatureEdges and CopyCellData are ignored when streaming. The default,
+  // 1, processes the input in one piece.
+  vtkSetClampMacro(NumberOfStreamDivisions,int,1,VTK_LARGE_INTEGER);
+  vtkGetMacro(NumberOfStreamDivisions,int);
+
 protected:
   vtkQuadricClustering();
   ~vtkQuadricClustering();
 
   int RequestData(vtkInformation *, vtkInformationVector **, vtkInformationVector *);
+  int RequestUpdateExtent(vtkInformation *, vtkInformationVector **, vtkInformationVector *);
   int FillInputPortInformation(int, vtkInformation *);
 
+  // Description:
+  // Process one piece of the input when NumberOfStreamDivisions > 1.
+  // Requests the next piece until all of them have been appended.
+  int RequestStreamedData(vtkInformation *request, vtkInformation *inInfo,
+                          vtkPolyData *input);
+
+  // Description:
+  // Set NumberOfDivisions from the user values, reduced when
+  // AutoAdjustNumberOfDivisions is on and the input has few points.
+  void AdjustNumberOfDivisions(vtkIdType numPoints);
+
   // Description:
   // Given a point, determine what bin it falls into.
   vtkIdType HashPoint(double point[3]);
@@ -238,6 +297,9 @@ protected:
                  vtkPolyData *input, vtkPolyData *output);
   void AddTriangle(vtkIdType *binIds, double *pt0, double *pt1, double *pt2,
                    int geometeryFlag, vtkPolyData *input, vtkPolyData *output);
+  void AddTriangleQuadric(vtkIdType *binIds, double quadric[9],
+                          int geometryFlag, vtkPolyData *input,
+                          vtkPolyData *output);
 
   // Description:
   // Add edges to the quadric array.  If geometry flag is on then
@@ -261,8 +323,30 @@ protected:
   void InitializeQuadric(double quadric[9]);
   
   // Description:
-  // Add this quadric to the quadric already associated with this bin.
-  void AddQuadric(vtkIdType binId, double quadric[9]);
+  // Add this quadric, computed from a cell of the given dimension, to the
+  // quadric already associated with this bin. Quadrics of lower dimension
+  // supersede the others: points replace edges, which replace triangles.
+  void AddQuadric(vtkIdType binId, double quadric[9], int dimension);
+
+  // Description:
+  // Access the quadric and the output point of a bin, whether the bins are
+  // dense or sparse. GetBinQuadric returns NULL and GetBinVertexId returns
+  // -1 for bins that are not used. AddBinVertex returns the output point of
+  // the bin, allocating one on first use.
+  double *GetBinQuadric(vtkIdType binId);
+  vtkIdType GetBinVertexId(vtkIdType binId);
+  vtkIdType AddBinVertex(vtkIdType binId);
+  void RemoveBinVertex(vtkIdType binId);
+
+  // Description:
+  // Write the sparse bin quadrics to disk if there are more than
+  // MaximumNumberOfBinsInMemory.
+  void CheckBinMemory();
+
+  // Description:
+  // Compute the output points of the sparse bins, reading back the
+  // quadrics written to disk.
+  void ComputeSparseRepresentativePoints(vtkPoints *outputPoints);
 
   // Description:
   // Find the feature points of a given set of edges.
@@ -282,6 +366,11 @@ protected:
   // It duplicates the structure of the input cells (but decimiated).
   void EndAppendVertexGeometry(vtkPolyData *input, vtkPolyData *output);
 
+  // Description:
+  // Same as EndAppendVertexGeometry for streamed input, for which the
+  // vertex cells of all the pieces were saved as lists of bins.
+  void EndAppendVertexBins(vtkPolyData *output);
+
   // Unfinished option to handle boundary edges differently.
   void AppendFeatureQuadrics(vtkPolyData *pd, vtkPolyData *output);
   int UseFeatureEdges;
@@ -336,6 +425,21 @@ protected:
   PointQuadric* QuadricArray;
   vtkIdType NumberOfBinsUsed;
 
+  // Sparse, out-of-core alternative to QuadricArray.
+  int UseSparseBins;
+  vtkIdType MaximumNumberOfBinsInMemory;
+  char *SpillDirectory;
+  vtkQuadricClusteringBinStore *BinStore;
+
+  // State of the streaming loop. StreamingPass is 0 when not streaming, 1
+  // while computing the bounds and 2 while appending the pieces.
+  int NumberOfStreamDivisions;
+  int CurrentStreamDivision;
+  int StreamingPass;
+  double StreamedBounds[6];
+  vtkIdType StreamedNumberOfPoints;
+  vtkCellArray *StreamedVertexBins;
+
   // Have to make these instance variables if we are going to allow
   // the algorithm to be driven by the Append methods.
   vtkCellArray *OutputTriangleArray;
@@ -350,6 +454,10 @@ protected:
   int OutCellCount;
 
 private:
+  //BTX
+  friend class vtkQuadricClusteringTriangleBatch;
+  //ETX
+
   vtkQuadricClustering(const vtkQuadricClustering&);  // Not implemented.
   void operator=(const vtkQuadricClustering&);  // Not implemented.
 };
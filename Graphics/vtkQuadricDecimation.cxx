@@ -52,7 +52,7 @@
 #include "vtkObjectFactory.h"
 #include "vtkPolyData.h"
 #include "vtkPointData.h"
-#include "vtkPriorityQueue.h"
+#include "vtkIndexedPriorityQueue.h"
 #include "vtkTriangle.h"
 
 vtkStandardNewMacro(vtkQuadricDecimation);
@@ -62,11 +62,12 @@ vtkStandardNewMacro(vtkQuadricDecimation);
 vtkQuadricDecimation::vtkQuadricDecimation()
 {
   this->Edges = vtkEdgeTable::New();
-  this->EdgeCosts = vtkPriorityQueue::New();
+  this->EdgeCosts = vtkIndexedPriorityQueue::New();
   this->EndPoint1List = vtkIdList::New();
   this->EndPoint2List = vtkIdList::New();
   this->ErrorQuadrics = NULL;
   this->TargetPoints = vtkDoubleArray::New();
+  this->LockedPoints = NULL;
   
   this->TargetReduction = 0.9;
   this->NumberOfEdgeCollapses = 0;
@@ -185,20 +186,9 @@ int vtkQuadricDecimation::RequestData(
   vtkPolyData *output = vtkPolyData::SafeDownCast(
     outInfo->Get(vtkDataObject::DATA_OBJECT()));
 
-  vtkIdType numPts = input->GetNumberOfPoints();
-  vtkIdType numTris = input->GetNumberOfPolys();
-  vtkIdType edgeId, i;
-  int j;
-  double cost;
-  double *x;
-  vtkCellArray *polys;
+  vtkIdType i;
   vtkDataArray *attrib;
-  vtkPoints *points;
-  vtkPointData *pointData;
-  vtkIdType endPtIds[2];
   vtkIdList *outputCellList;
-  vtkIdType npts, *pts;
-  vtkIdType numDeletedTris=0;
 
   // check some assuptiona about the data
   if (input->GetPolys() == NULL || input->GetPoints() == NULL || 
@@ -213,11 +203,63 @@ int vtkQuadricDecimation::RequestData(
     vtkErrorMacro("Can only decimate triangles");
     return 1;
     }
+
+  this->Decimate(input);
+  outputCellList = vtkIdList::New();
   
+  // copy the simplified mesh from the working mesh to the output mesh
+  for (i = 0; i < this->Mesh->GetNumberOfCells(); i++) 
+    {
+    if (this->Mesh->GetCell(i)->GetCellType() != VTK_EMPTY_CELL) 
+      {
+      outputCellList->InsertNextId(i);
+      }
+    } 
+
+  output->Reset();
+  output->Allocate(this->Mesh, outputCellList->GetNumberOfIds());
+  output->GetPointData()->CopyAllocate(this->Mesh->GetPointData(),1);
+  output->CopyCells(this->Mesh, outputCellList);
+
+  this->Mesh->DeleteLinks();
+  this->Mesh->Delete();
+  outputCellList->Delete();
+
+  // renormalize, clamp attributes
+  if (this->AttributeErrorMetric) 
+    {
+    if (NULL != (attrib = output->GetPointData()->GetNormals())) 
+      {
+      for (i = 0; i < attrib->GetNumberOfTuples(); i++) 
+        {
+        vtkMath::Normalize(attrib->GetTuple3(i));
+        }
+      }
+    // might want to add clamping texture coordinates??
+    }
+
+  return 1;
+}
+
+//----------------------------------------------------------------------------
+vtkIdType vtkQuadricDecimation::Decimate(vtkPolyData *input)
+{
+  vtkIdType numPts = input->GetNumberOfPoints();
+  vtkIdType numTris = input->GetNumberOfPolys();
+  vtkIdType edgeId, i;
+  int j;
+  double cost;
+  double *x;
+  vtkCellArray *polys;
+  vtkPoints *points;
+  vtkPointData *pointData;
+  vtkIdType endPtIds[2];
+  vtkIdType npts, *pts;
+  vtkIdType numDeletedTris=0;
+
   polys = vtkCellArray::New();
   points = vtkPoints::New();
   pointData = vtkPointData::New();
-  outputCellList = vtkIdList::New();
   
   // copy the input (only polys) to our working mesh
   this->Mesh = vtkPolyData::New();
@@ -370,39 +412,8 @@ int vtkQuadricDecimation::RequestData(
   delete [] this->TempB;
   delete [] this->TempA;
   delete [] this->TempData;
-  
-  // copy the simplified mesh from the working mesh to the output mesh
-  for (i = 0; i < this->Mesh->GetNumberOfCells(); i++) 
-    {
-    if (this->Mesh->GetCell(i)->GetCellType() != VTK_EMPTY_CELL) 
-      {
-      outputCellList->InsertNextId(i);
-      }
-    } 
-
-  output->Reset();
-  output->Allocate(this->Mesh, outputCellList->GetNumberOfIds());
-  output->GetPointData()->CopyAllocate(this->Mesh->GetPointData(),1);
-  output->CopyCells(this->Mesh, outputCellList);
 
-  this->Mesh->DeleteLinks();
-  this->Mesh->Delete();
-  outputCellList->Delete();
-
-  // renormalize, clamp attributes
-  if (this->AttributeErrorMetric) 
-    {
-    if (NULL != (attrib = output->GetPointData()->GetNormals())) 
-      {
-      for (i = 0; i < attrib->GetNumberOfTuples(); i++) 
-        {
-        vtkMath::Normalize(attrib->GetTuple3(i));
-        }
-      }
-    // might want to add clamping texture coordinates??
-    }
-
-  return 1;
+  return numDeletedTris;
 }
 
 //----------------------------------------------------------------------------
@@ -721,13 +732,12 @@ void vtkQuadricDecimation::UpdateEdgeData(vtkIdType pt0Id, vtkIdType pt1Id)
     edge[0] = this->EndPoint1List->GetId(changedEdges->GetId(i));
     edge[1] = this->EndPoint2List->GetId(changedEdges->GetId(i));
 
-    // Remove all affected edges from the priority queue. 
-    // This does not include collapsed edge.
-    this->EdgeCosts->DeleteId(changedEdges->GetId(i));
-
     // Determine the new set of edges
     if (edge[0] == pt1Id)
       {
+      // Remove the affected edge from the priority queue.
+      // This does not include collapsed edge.
+      this->EdgeCosts->DeleteId(changedEdges->GetId(i));
       if (this->Edges->IsEdge(edge[1], pt0Id) == -1)
         { // The edge will be completely new, add it.
         edgeId = this->Edges->GetNumberOfEdges();
@@ -749,6 +759,7 @@ void vtkQuadricDecimation::UpdateEdgeData(vtkIdType pt0Id, vtkIdType pt1Id)
       }
     else if (edge[1] == pt1Id)
       { // The edge will be completely new, add it.
+      this->EdgeCosts->DeleteId(changedEdges->GetId(i));
       if (this->Edges->IsEdge(edge[0], pt0Id) == -1)
         {
         edgeId = this->Edges->GetNumberOfEdges();
@@ -778,7 +789,8 @@ void vtkQuadricDecimation::UpdateEdgeData(vtkIdType pt0Id, vtkIdType pt1Id)
         {
         cost = this->ComputeCost(changedEdges->GetId(i), this->TempX);
         }
-      this->EdgeCosts->Insert(cost, changedEdges->GetId(i));
+      // Update its cost in place.
+      this->EdgeCosts->SetPriority(changedEdges->GetId(i), cost);
       this->TargetPoints->InsertTuple(changedEdges->GetId(i), this->TempX);
       }
     }
@@ -802,6 +814,14 @@ double vtkQuadricDecimation::ComputeCost(vtkIdType edgeId, double *x)
 
   pointIds[0] = this->EndPoint1List->GetId(edgeId);
   pointIds[1] = this->EndPoint2List->GetId(edgeId);
+
+  // edges touching a locked point are never collapsed
+  if (this->LockedPoints && (this->LockedPoints[pointIds[0]] ||
+                             this->LockedPoints[pointIds[1]]))
+    {
+    this->GetPointAttributeArray(pointIds[0], x);
+    return VTK_DOUBLE_MAX;
+    }
   
   for (i = 0; i < 11 + 4 * this->NumberOfComponents; i++)
     {
@@ -901,6 +921,14 @@ double vtkQuadricDecimation::ComputeCost2(vtkIdType edgeId, double *x)
   pointIds[0] = this->EndPoint1List->GetId(edgeId);
   pointIds[1] = this->EndPoint2List->GetId(edgeId);
 
+  // edges touching a locked point are never collapsed
+  if (this->LockedPoints && (this->LockedPoints[pointIds[0]] ||
+                             this->LockedPoints[pointIds[1]]))
+    {
+    this->GetPointAttributeArray(pointIds[0], x);
+    return VTK_DOUBLE_MAX;
+    }
+
   for (i = 0; i < 11 + 4 * this->NumberOfComponents; i++)  
     {
     this->TempQuad[i] = this->ErrorQuadrics[pointIds[0]].Quadric[i] +
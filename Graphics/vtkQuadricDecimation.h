@@ -58,7 +58,7 @@
 class vtkEdgeTable;
 class vtkIdList;
 class vtkPointData;
-class vtkPriorityQueue;
+class vtkIndexedPriorityQueue;
 class vtkDoubleArray;
 
 class VTK_GRAPHICS_EXPORT vtkQuadricDecimation : public vtkPolyDataAlgorithm
@@ -130,6 +130,13 @@ protected:
 
   int RequestData(vtkInformation *, vtkInformationVector **, vtkInformationVector *);
 
+  // Description:
+  // Copy the triangles of input to the working mesh (this->Mesh) and
+  // collapse edges until TargetReduction is reached. Deleted triangles are
+  // left in this->Mesh as empty cells; the caller is responsible for
+  // deleting this->Mesh. Returns the number of deleted triangles.
+  vtkIdType Decimate(vtkPolyData *input);
+
   // Description:
   // Do the dirty work of eliminating the edge; return the number of
   // triangles deleted.
@@ -204,11 +211,17 @@ protected:
   vtkEdgeTable     *Edges;
   vtkIdList        *EndPoint1List;
   vtkIdList        *EndPoint2List;
-  vtkPriorityQueue *EdgeCosts;
+  vtkIndexedPriorityQueue *EdgeCosts;
   vtkDoubleArray   *TargetPoints;
   int               NumberOfComponents;
   vtkPolyData      *Mesh;
 
+  // Description:
+  // Optional per-point flags, indexed like the points of the input. Edges
+  // with a flagged end point are never collapsed, so flagged points keep
+  // their position. Used by subclasses that decimate a mesh piecewise.
+  const unsigned char *LockedPoints;
+
   //BTX
   struct ErrorQuadric
   {
@@ -29,9 +29,601 @@
 #include "vtkGenericCell.h"
 #include "vtkMath.h"
 #include "vtkGarbageCollector.h"
+#include "vtkCellArray.h"
+#include "vtkImageData.h"
+#include "vtkMultiThreader.h"
+#include "vtkPoints.h"
+
+#include <vtkstd/algorithm>
+#include <vtkstd/vector>
 
 vtkStandardNewMacro(vtkSelectEnclosedPoints);
 
+//----------------------------------------------------------------------------
+// Number of points each thread should at least classify.
+#define VTK_SELECT_ENCLOSED_POINTS_PER_THREAD 4096
+
+// Maximum number of triangles in a leaf of the hierarchy.
+#define VTK_RAY_PARITY_LEAF_SIZE 4
+
+// Tolerance on the barycentric coordinates of a crossing below which the
+// ray is considered to graze an edge or a vertex.
+#define VTK_RAY_PARITY_EDGE_TOLERANCE 1.0e-9
+
+// Outcomes of a ray cast.
+#define VTK_RAY_PARITY_CLEAN 0
+#define VTK_RAY_PARITY_AMBIGUOUS 1
+#define VTK_RAY_PARITY_ON_SURFACE 2
+
+// Directions tried in turn when a ray is ambiguous. The first one is the
+// one used for the rows of image data; the others are skewed so that they
+// are unlikely to graze the edges of axis aligned or regular surfaces.
+static const double vtkRayParityDirections[][3] = {
+  { 1.0, 0.0, 0.0 },
+  { 0.8723, 0.3791, 0.3087 },
+  { -0.2813, 0.9107, 0.3025 },
+  { 0.4219, -0.2237, 0.8787 },
+  { -0.6712, -0.5534, 0.4932 },
+  { 0.3187, 0.7293, -0.6053 },
+  { -0.5119, 0.2961, -0.8064 },
+  { 0.1402, -0.8869, -0.4401 }
+};
+#define VTK_RAY_PARITY_NUMBER_OF_DIRECTIONS 8
+
+//----------------------------------------------------------------------------
+// A bounding volume hierarchy of the triangles of the surface.
+class vtkSelectEnclosedPointsTree
+{
+public:
+  struct Node
+  {
+    double Bounds[6];
+    // Leaves have Count > 0 triangles starting at Start. Inner nodes have
+    // their first child right after them and their second one at Start.
+    vtkIdType Start;
+    vtkIdType Count;
+  };
+
+  void Build(vtkPolyData *surface);
+
+  // Count the crossings of the ray (o,d) with the surface. If crossings is
+  // given, the ray parameters of the crossings are appended to it.
+  int CastRay(const double o[3], const double d[3], double tol,
+              int &numCrossings, vtkstd::vector<double> *crossings) const;
+
+  // Classify a point (which is within the bounds of the surface).
+  int IsInside(const double x[3], double tol) const;
+
+protected:
+  void AddTriangle(vtkPoints *pts, vtkIdType a, vtkIdType b, vtkIdType c);
+  vtkIdType BuildNode(vtkIdType start, vtkIdType count);
+  static int IntersectBox(const double b[6], const double o[3],
+                          const double d[3]);
+
+  vtkstd::vector<double> Triangles; // 9 coordinates per triangle
+  vtkstd::vector<vtkIdType> Order;
+  vtkstd::vector<double> Centers;
+  vtkstd::vector<Node> Nodes;
+};
+
+//----------------------------------------------------------------------------
+void vtkSelectEnclosedPointsTree::AddTriangle(
+  vtkPoints *pts, vtkIdType a, vtkIdType b, vtkIdType c)
+{
+  double x[3];
+  vtkIdType ids[3] = { a, b, c };
+  for (int i = 0; i < 3; ++i)
+    {
+    pts->GetPoint(ids[i], x);
+    this->Triangles.push_back(x[0]);
+    this->Triangles.push_back(x[1]);
+    this->Triangles.push_back(x[2]);
+    }
+}
+
+//----------------------------------------------------------------------------
+void vtkSelectEnclosedPointsTree::Build(vtkPolyData *surface)
+{
+  this->Triangles.clear();
+  this->Nodes.clear();
+  vtkPoints *pts = surface->GetPoints();
+  if (!pts)
+    {
+    return;
+    }
+
+  // Polygons are fanned (the surface is expected to be made of convex
+  // polygons, like the random ray intersection assumes), strips are split.
+  vtkIdType npts, *ids, i;
+  vtkCellArray *polys = surface->GetPolys();
+  for (polys->InitTraversal(); polys->GetNextCell(npts, ids); )
+    {
+    for (i = 2; i < npts; ++i)
+      {
+      this->AddTriangle(pts, ids[0], ids[i-1], ids[i]);
+      }
+    }
+  vtkCellArray *strips = surface->GetStrips();
+  for (strips->InitTraversal(); strips->GetNextCell(npts, ids); )
+    {
+    for (i = 2; i < npts; ++i)
+      {
+      this->AddTriangle(pts, ids[i-2], ids[i-1], ids[i]);
+      }
+    }
+
+  vtkIdType numTris = static_cast<vtkIdType>(this->Triangles.size() / 9);
+  if (numTris == 0)
+    {
+    return;
+    }
+  this->Order.resize(numTris);
+  this->Centers.resize(3 * numTris);
+  for (i = 0; i < numTris; ++i)
+    {
+    const double *t = &this->Triangles[9*i];
+    this->Order[i] = i;
+    for (int j = 0; j < 3; ++j)
+      {
+      this->Centers[3*i+j] = (t[j] + t[3+j] + t[6+j]) / 3.0;
+      }
+    }
+  this->Nodes.reserve(2 * numTris / VTK_RAY_PARITY_LEAF_SIZE + 1);
+  this->BuildNode(0, numTris);
+
+  // Store the triangles in leaf order.
+  vtkstd::vector<double> sorted(this->Triangles.size());
+  for (i = 0; i < numTris; ++i)
+    {
+    memcpy(&sorted[9*i], &this->Triangles[9*this->Order[i]],
+           9 * sizeof(double));
+    }
+  this->Triangles.swap(sorted);
+  this->Order.clear();
+  this->Centers.clear();
+}
+
+//----------------------------------------------------------------------------
+// Sorts triangle indices by the coordinate of their center along an axis.
+class vtkRayParityCenterLess
+{
+public:
+  vtkRayParityCenterLess(const double *centers, int axis)
+    : Centers(centers), Axis(axis) {}
+  bool operator()(vtkIdType a, vtkIdType b) const
+    {
+    return this->Centers[3*a+this->Axis] < this->Centers[3*b+this->Axis];
+    }
+  const double *Centers;
+  int Axis;
+};
+
+//----------------------------------------------------------------------------
+vtkIdType vtkSelectEnclosedPointsTree::BuildNode(
+  vtkIdType start, vtkIdType count)
+{
+  vtkIdType nodeId = static_cast<vtkIdType>(this->Nodes.size());
+  this->Nodes.push_back(Node());
+
+  double bounds[6] = { VTK_DOUBLE_MAX, -VTK_DOUBLE_MAX, VTK_DOUBLE_MAX,
+                       -VTK_DOUBLE_MAX, VTK_DOUBLE_MAX, -VTK_DOUBLE_MAX };
+  double cbounds[6] = { VTK_DOUBLE_MAX, -VTK_DOUBLE_MAX, VTK_DOUBLE_MAX,
+                        -VTK_DOUBLE_MAX, VTK_DOUBLE_MAX, -VTK_DOUBLE_MAX };
+  vtkIdType i;
+  int j;
+  for (i = start; i < start + count; ++i)
+    {
+    const double *t = &this->Triangles[9*this->Order[i]];
+    const double *c = &this->Centers[3*this->Order[i]];
+    for (j = 0; j < 3; ++j)
+      {
+      for (int v = 0; v < 3; ++v)
+        {
+        bounds[2*j] = vtkstd::min(bounds[2*j], t[3*v+j]);
+        bounds[2*j+1] = vtkstd::max(bounds[2*j+1], t[3*v+j]);
+        }
+      cbounds[2*j] = vtkstd::min(cbounds[2*j], c[j]);
+      cbounds[2*j+1] = vtkstd::max(cbounds[2*j+1], c[j]);
+      }
+    }
+  memcpy(this->Nodes[nodeId].Bounds, bounds, sizeof(bounds));
+
+  int axis = 0;
+  for (j = 1; j < 3; ++j)
+    {
+    if (cbounds[2*j+1] - cbounds[2*j] > cbounds[2*axis+1] - cbounds[2*axis])
+      {
+      axis = j;
+      }
+    }
+  if (count <= VTK_RAY_PARITY_LEAF_SIZE || cbounds[2*axis+1] <= cbounds[2*axis])
+    {
+    this->Nodes[nodeId].Start = start;
+    this->Nodes[nodeId].Count = count;
+    return nodeId;
+    }
+
+  // Split at the median center along the longest axis.
+  vtkIdType half = count / 2;
+  vtkstd::nth_element(this->Order.begin() + start,
+                      this->Order.begin() + start + half,
+                      this->Order.begin() + start + count,
+                      vtkRayParityCenterLess(&this->Centers[0], axis));
+  this->BuildNode(start, half);
+  vtkIdType second = this->BuildNode(start + half, count - half);
+  this->Nodes[nodeId].Start = second;
+  this->Nodes[nodeId].Count = 0;
+  return nodeId;
+}
+
+//----------------------------------------------------------------------------
+int vtkSelectEnclosedPointsTree::IntersectBox(
+  const double b[6], const double o[3], const double d[3])
+{
+  double tmin = 0.0;
+  double tmax = VTK_DOUBLE_MAX;
+  for (int j = 0; j < 3; ++j)
+    {
+    if (d[j] == 0.0)
+      {
+      if (o[j] < b[2*j] || o[j] > b[2*j+1])
+        {
+        return 0;
+        }
+      continue;
+      }
+    double t0 = (b[2*j] - o[j]) / d[j];
+    double t1 = (b[2*j+1] - o[j]) / d[j];
+    if (t0 > t1)
+      {
+      double tmp = t0;
+      t0 = t1;
+      t1 = tmp;
+      }
+    tmin = (t0 > tmin ? t0 : tmin);
+    tmax = (t1 < tmax ? t1 : tmax);
+    if (tmin > tmax)
+      {
+      return 0;
+      }
+    }
+  return 1;
+}
+
+//----------------------------------------------------------------------------
+int vtkSelectEnclosedPointsTree::CastRay(
+  const double o[3], const double d[3], double tol, int &numCrossings,
+  vtkstd::vector<double> *crossings) const
+{
+  numCrossings = 0;
+  if (this->Nodes.empty())
+    {
+    return VTK_RAY_PARITY_CLEAN;
+    }
+  int status = VTK_RAY_PARITY_CLEAN;
+  vtkIdType stack[128];
+  int top = 0;
+  stack[top++] = 0;
+  while (top > 0)
+    {
+    vtkIdType nodeId = stack[--top];
+    const Node &node = this->Nodes[nodeId];
+    // The box is enlarged by the tolerance so that points lying on the
+    // surface are always caught.
+    double b[6];
+    for (int j = 0; j < 3; ++j)
+      {
+      b[2*j] = node.Bounds[2*j] - tol;
+      b[2*j+1] = node.Bounds[2*j+1] + tol;
+      }
+    if (!IntersectBox(b, o, d))
+      {
+      continue;
+      }
+    if (node.Count == 0)
+      {
+      stack[top++] = node.Start;
+      stack[top++] = nodeId + 1;
+      continue;
+      }
+    for (vtkIdType i = node.Start; i < node.Start + node.Count; ++i)
+      {
+      // Moller-Trumbore ray/triangle intersection.
+      const double *v0 = &this->Triangles[9*i];
+      double e1[3], e2[3], p[3], s[3], q[3];
+      for (int j = 0; j < 3; ++j)
+        {
+        e1[j] = v0[3+j] - v0[j];
+        e2[j] = v0[6+j] - v0[j];
+        s[j] = o[j] - v0[j];
+        }
+      vtkMath::Cross(d, e2, p);
+      double det = vtkMath::Dot(e1, p);
+      if (det == 0.0)
+        {
+        // Parallel to the triangle. If the ray runs inside it, it also
+        // grazes the edges of the neighbors, which are reported.
+        continue;
+        }
+      double inv = 1.0 / det;
+      double u = vtkMath::Dot(s, p) * inv;
+      if (u < -VTK_RAY_PARITY_EDGE_TOLERANCE ||
+          u > 1.0 + VTK_RAY_PARITY_EDGE_TOLERANCE)
+        {
+        continue;
+        }
+      vtkMath::Cross(s, e1, q);
+      double v = vtkMath::Dot(d, q) * inv;
+      if (v < -VTK_RAY_PARITY_EDGE_TOLERANCE ||
+          u + v > 1.0 + VTK_RAY_PARITY_EDGE_TOLERANCE)
+        {
+        continue;
+        }
+      double t = vtkMath::Dot(e2, q) * inv;
+      if (t < -tol)
+        {
+        continue;
+        }
+      if (t <= tol && !crossings)
+        {
+        return VTK_RAY_PARITY_ON_SURFACE;
+        }
+      if (u < VTK_RAY_PARITY_EDGE_TOLERANCE ||
+          v < VTK_RAY_PARITY_EDGE_TOLERANCE ||
+          u + v > 1.0 - VTK_RAY_PARITY_EDGE_TOLERANCE)
+        {
+        status = VTK_RAY_PARITY_AMBIGUOUS;
+        if (!crossings)
+          {
+          return status;
+          }
+        }
+      ++numCrossings;
+      if (crossings)
+        {
+        crossings->push_back(t);
+        }
+      }
+    }
+  return status;
+}
+
+//----------------------------------------------------------------------------
+int vtkSelectEnclosedPointsTree::IsInside(const double x[3],
+                                                        double tol) const
+{
+  int numCrossings = 0;
+  for (int dir = 0; dir < VTK_RAY_PARITY_NUMBER_OF_DIRECTIONS; ++dir)
+    {
+    int status = this->CastRay(x, vtkRayParityDirections[dir], tol,
+                               numCrossings, 0);
+    if (status == VTK_RAY_PARITY_ON_SURFACE)
+      {
+      return 1;
+      }
+    if (status == VTK_RAY_PARITY_CLEAN)
+      {
+      return numCrossings % 2;
+      }
+    }
+  // Every direction grazed the surface: go with the last count.
+  return numCrossings % 2;
+}
+
+//----------------------------------------------------------------------------
+struct vtkSelectEnclosedPointsRayParityInfo
+{
+  vtkSelectEnclosedPoints *Self;
+  vtkSelectEnclosedPointsTree *Tree;
+  vtkDataSet *Input;
+  vtkImageData *Image;
+  double Bounds[6];
+  double Tolerance;
+  unsigned char Inside;
+  unsigned char Outside;
+  unsigned char *Marks;
+};
+
+//----------------------------------------------------------------------------
+static inline int vtkSelectEnclosedPointsInBounds(const double b[6],
+                                                  const double x[3])
+{
+  return x[0] >= b[0] && x[0] <= b[1] && x[1] >= b[2] && x[1] <= b[3] &&
+    x[2] >= b[4] && x[2] <= b[5];
+}
+
+//----------------------------------------------------------------------------
+// Classify a range of points, one ray each.
+static VTK_THREAD_RETURN_TYPE vtkSelectEnclosedPointsClassifyPoints(void *arg)
+{
+  vtkMultiThreader::ThreadInfo *info =
+    static_cast<vtkMultiThreader::ThreadInfo*>(arg);
+  vtkSelectEnclosedPointsRayParityInfo *rp =
+    static_cast<vtkSelectEnclosedPointsRayParityInfo*>(info->UserData);
+  vtkIdType numPts = rp->Input->GetNumberOfPoints();
+  vtkIdType begin = numPts * info->ThreadID / info->NumberOfThreads;
+  vtkIdType end = numPts * (info->ThreadID + 1) / info->NumberOfThreads;
+  double x[3];
+  int abort = 0;
+  vtkIdType progressInterval = (end - begin)/20 + 1;
+  for (vtkIdType ptId = begin; ptId < end && !abort; ++ptId)
+    {
+    if ( ! ((ptId - begin) % progressInterval) ) //manage progress / early abort
+      {
+      if (info->ThreadID == 0)
+        {
+        rp->Self->UpdateProgress(static_cast<double>(ptId - begin) /
+                                 (end - begin));
+        }
+      abort = rp->Self->GetAbortExecute();
+      }
+    rp->Input->GetPoint(ptId, x);
+    int inside = vtkSelectEnclosedPointsInBounds(rp->Bounds, x) &&
+      rp->Tree->IsInside(x, rp->Tolerance);
+    rp->Marks[ptId] = (inside ? rp->Inside : rp->Outside);
+    }
+  return VTK_THREAD_RETURN_VALUE;
+}
+
+//----------------------------------------------------------------------------
+// Classify a range of rows of image data. A ray cast along each row from
+// outside of the surface gives the crossings of the row, and the points
+// are inside when they follow an odd number of crossings.
+static VTK_THREAD_RETURN_TYPE vtkSelectEnclosedPointsClassifyRows(void *arg)
+{
+  vtkMultiThreader::ThreadInfo *info =
+    static_cast<vtkMultiThreader::ThreadInfo*>(arg);
+  vtkSelectEnclosedPointsRayParityInfo *rp =
+    static_cast<vtkSelectEnclosedPointsRayParityInfo*>(info->UserData);
+  int dims[3], extent[6];
+  double origin[3], spacing[3];
+  rp->Image->GetDimensions(dims);
+  rp->Image->GetExtent(extent);
+  rp->Image->GetOrigin(origin);
+  rp->Image->GetSpacing(spacing);
+  // The structured indices of the points start at the lower extent bounds.
+  for (int axis = 0; axis < 3; ++axis)
+    {
+    origin[axis] += extent[2*axis] * spacing[axis];
+    }
+  vtkIdType numRows = static_cast<vtkIdType>(dims[1]) * dims[2];
+  vtkIdType begin = numRows * info->ThreadID / info->NumberOfThreads;
+  vtkIdType end = numRows * (info->ThreadID + 1) / info->NumberOfThreads;
+
+  // The ray starts at the lower x bound, minus some margin, or at the
+  // first point of the row if it is further.
+  double start = rp->Bounds[0] - 2.0 * rp->Tolerance - 1.0;
+  if (origin[0] < start)
+    {
+    start = origin[0];
+    }
+  if (spacing[0] < 0.0 && origin[0] + (dims[0] - 1) * spacing[0] < start)
+    {
+    start = origin[0] + (dims[0] - 1) * spacing[0];
+    }
+
+  vtkstd::vector<double> crossings;
+  double x[3];
+  int abort = 0;
+  vtkIdType progressInterval = (end - begin)/20 + 1;
+  for (vtkIdType row = begin; row < end && !abort; ++row)
+    {
+    if ( ! ((row - begin) % progressInterval) ) //manage progress / early abort
+      {
+      if (info->ThreadID == 0)
+        {
+        rp->Self->UpdateProgress(static_cast<double>(row - begin) /
+                                 (end - begin));
+        }
+      abort = rp->Self->GetAbortExecute();
+      }
+    int j = static_cast<int>(row % dims[1]);
+    int k = static_cast<int>(row / dims[1]);
+    unsigned char *marks = rp->Marks + row * dims[0];
+    x[1] = origin[1] + j * spacing[1];
+    x[2] = origin[2] + k * spacing[2];
+    if (x[1] < rp->Bounds[2] || x[1] > rp->Bounds[3] ||
+        x[2] < rp->Bounds[4] || x[2] > rp->Bounds[5])
+      {
+      memset(marks, rp->Outside, dims[0]);
+      continue;
+      }
+
+    x[0] = start;
+    crossings.clear();
+    int numCrossings;
+    int status = rp->Tree->CastRay(x, vtkRayParityDirections[0],
+                                   rp->Tolerance, numCrossings, &crossings);
+    vtkstd::sort(crossings.begin(), crossings.end());
+    size_t next = 0;
+    for (int i = 0; i < dims[0]; ++i)
+      {
+      x[0] = origin[0] + i * spacing[0];
+      int inside;
+      if (x[0] < rp->Bounds[0] || x[0] > rp->Bounds[1])
+        {
+        inside = 0;
+        }
+      else if (status != VTK_RAY_PARITY_CLEAN)
+        {
+        // The row grazes the surface: classify its points one by one.
+        inside = rp->Tree->IsInside(x, rp->Tolerance);
+        }
+      else
+        {
+        double t = x[0] - start;
+        if (spacing[0] >= 0.0)
+          {
+          while (next < crossings.size() && crossings[next] < t - rp->Tolerance)
+            {
+            ++next;
+            }
+          }
+        else
+          {
+          next = vtkstd::lower_bound(crossings.begin(), crossings.end(),
+                                     t - rp->Tolerance) - crossings.begin();
+          }
+        if (next < crossings.size() && crossings[next] <= t + rp->Tolerance)
+          {
+          inside = 1; // on the surface
+          }
+        else
+          {
+          inside = static_cast<int>(next % 2);
+          }
+        }
+      marks[i] = (inside ? rp->Inside : rp->Outside);
+      }
+    }
+  return VTK_THREAD_RETURN_VALUE;
+}
+
+//----------------------------------------------------------------------------
+void vtkSelectEnclosedPoints::RayParityExecute(vtkDataSet *input,
+                                               vtkUnsignedCharArray *marks)
+{
+  vtkSelectEnclosedPointsRayParityInfo rp;
+  rp.Self = this;
+  rp.Tree = this->RayParityTree;
+  rp.Input = input;
+  rp.Image = vtkImageData::SafeDownCast(input);
+  memcpy(rp.Bounds, this->Bounds, sizeof(rp.Bounds));
+  rp.Tolerance = this->Tolerance * this->Length;
+  rp.Inside = (this->InsideOut ? 0 : 1);
+  rp.Outside = (this->InsideOut ? 1 : 0);
+  rp.Marks = marks->GetPointer(0);
+
+  vtkIdType numPts = input->GetNumberOfPoints();
+  int numThreads = static_cast<int>(
+    numPts / VTK_SELECT_ENCLOSED_POINTS_PER_THREAD);
+  int maxThreads = vtkMultiThreader::GetGlobalDefaultNumberOfThreads();
+  if (numThreads > maxThreads)
+    {
+    numThreads = maxThreads;
+    }
+  if (rp.Image)
+    {
+    int dims[3];
+    rp.Image->GetDimensions(dims);
+    if (numThreads > dims[1] * dims[2])
+      {
+      numThreads = dims[1] * dims[2];
+      }
+    }
+  if (numThreads < 1)
+    {
+    numThreads = 1;
+    }
+
+  vtkMultiThreader *threader = vtkMultiThreader::New();
+  threader->SetNumberOfThreads(numThreads);
+  threader->SetSingleMethod(rp.Image ? vtkSelectEnclosedPointsClassifyRows :
+                            vtkSelectEnclosedPointsClassifyPoints, &rp);
+  threader->SingleMethodExecute();
+  threader->Delete();
+}
+
 //----------------------------------------------------------------------------
 // Construct object.
 vtkSelectEnclosedPoints::vtkSelectEnclosedPoints()
@@ -41,12 +633,14 @@ vtkSelectEnclosedPoints::vtkSelectEnclosedPoints()
   this->CheckSurface = 0;
   this->InsideOut = 0;
   this->Tolerance = 0.001;
+  this->UseRayParity = 0;
 
   this->InsideOutsideArray = NULL;
   
   this->CellLocator = vtkCellLocator::New();
   this->CellIds = vtkIdList::New();
   this->Cell = vtkGenericCell::New();
+  this->RayParityTree = NULL;
 }
 
 //----------------------------------------------------------------------------
@@ -66,6 +660,7 @@ vtkSelectEnclosedPoints::~vtkSelectEnclosedPoints()
 
   this->CellIds->Delete();
   this->Cell->Delete();
+  delete this->RayParityTree;
 }
 
 //----------------------------------------------------------------------------
@@ -112,26 +707,33 @@ int vtkSelectEnclosedPoints::RequestData(
   marks->SetNumberOfValues(numPts);
   vtkIdType ptId;
   double x[3];
-  
-  int abort=0;
-  vtkIdType progressInterval=numPts/20+1;
-  for ( ptId=0; ptId < numPts && !abort; ptId++ )
+
+  if ( this->UseRayParity )
     {
-    if ( ! (ptId % progressInterval) ) //manage progress / early abort
+    this->RayParityExecute(input, marks);
+    }
+  else
+    {
+    int abort=0;
+    vtkIdType progressInterval=numPts/20+1;
+    for ( ptId=0; ptId < numPts && !abort; ptId++ )
       {
-      this->UpdateProgress ((double)ptId / numPts);
-      abort = this->GetAbortExecute();
-      }
+      if ( ! (ptId % progressInterval) ) //manage progress / early abort
+        {
+        this->UpdateProgress ((double)ptId / numPts);
+        abort = this->GetAbortExecute();
+        }
 
-    input->GetPoint(ptId,x);
+      input->GetPoint(ptId,x);
 
-    if ( this->IsInsideSurface(x) )
-      {
-      marks->SetValue(ptId,(this->InsideOut?0:1));
-      }
-    else
-      {
-      marks->SetValue(ptId,(this->InsideOut?1:0));
+      if ( this->IsInsideSurface(x) )
+        {
+        marks->SetValue(ptId,(this->InsideOut?0:1));
+        }
+      else
+        {
+        marks->SetValue(ptId,(this->InsideOut?1:0));
+        }
       }
     }
   
@@ -191,8 +793,21 @@ void vtkSelectEnclosedPoints::Initialize(vtkPolyData *surface)
   this->Length = surface->GetLength();
 
   // Set up structures for acceleration ray casting
-  this->CellLocator->SetDataSet(surface);
-  this->CellLocator->BuildLocator();
+  if ( this->UseRayParity )
+    {
+    if ( ! this->RayParityTree )
+      {
+      this->RayParityTree = new vtkSelectEnclosedPointsTree;
+      }
+    this->RayParityTree->Build(surface);
+    }
+  else
+    {
+    delete this->RayParityTree;
+    this->RayParityTree = NULL;
+    this->CellLocator->SetDataSet(surface);
+    this->CellLocator->BuildLocator();
+    }
 }
 
 //----------------------------------------------------------------------------
@@ -234,6 +849,11 @@ int vtkSelectEnclosedPoints::IsInsideSurface(double x[3])
     {
     return 0;
     }
+
+  if ( this->RayParityTree )
+    {
+    return this->RayParityTree->IsInside(x, this->Tolerance*this->Length);
+    }
   
   //  Perform in/out by shooting random rays. Multiple rays are fired
   //  to improve accuracy of the result.
@@ -366,6 +986,8 @@ int vtkSelectEnclosedPoints::FillInputPortInformation(int port, vtkInformation *
 void vtkSelectEnclosedPoints::Complete()
 {
   this->CellLocator->FreeSearchStructure();
+  delete this->RayParityTree;
+  this->RayParityTree = NULL;
 }
 
 //----------------------------------------------------------------------------
@@ -389,5 +1011,8 @@ void vtkSelectEnclosedPoints::PrintSelf(ostream& os, vtkIndent indent)
      << (this->InsideOut ? "On\n" : "Off\n");
   
   os << indent << "Tolerance: " << this->Tolerance << "\n";
+
+  os << indent << "Use Ray Parity: "
+     << (this->UseRayParity ? "On\n" : "Off\n");
 }
 
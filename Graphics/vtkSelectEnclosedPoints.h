@@ -22,6 +22,13 @@
 //
 // After running the filter, it is possible to query it as to whether a point 
 // is inside/outside by invoking the IsInside(ptId) method.
+//
+// By default the points are classified one at a time by firing random rays
+// at the surface until the votes settle. With UseRayParity on, the surface
+// is triangulated into a bounding volume hierarchy, and each point is
+// classified by the parity of the number of crossings of a single ray.
+// The points are split among several threads, and the points of an image
+// data input are classified a whole row at a time.
 
 // .SECTION Caveats
 // The filter assumes that the surface is closed and manifold. A boolean flag
@@ -45,6 +52,7 @@ class vtkUnsignedCharArray;
 class vtkCellLocator;
 class vtkIdList;
 class vtkGenericCell;
+class vtkSelectEnclosedPointsTree;
 
 
 class VTK_GRAPHICS_EXPORT vtkSelectEnclosedPoints : public vtkDataSetAlgorithm
@@ -97,6 +105,18 @@ public:
   vtkSetClampMacro(Tolerance,double,0.0,VTK_LARGE_FLOAT);
   vtkGetMacro(Tolerance,double);
 
+  // Description:
+  // If on, classify the points with rays cast through a bounding volume
+  // hierarchy of the surface triangles, by several threads, instead of
+  // voting with random rays. A ray which grazes an edge or a vertex of the
+  // surface is replaced by a ray in another direction. Points lying on the
+  // surface (within Tolerance) are considered inside. When the input is
+  // image data, a single ray along each row of points classifies the whole
+  // row. Off by default.
+  vtkSetMacro(UseRayParity,int);
+  vtkBooleanMacro(UseRayParity,int);
+  vtkGetMacro(UseRayParity,int);
+
   // Description:
   // This is a backdoor that can be used to test many points for containment.
   // First initialize the instance, then repeated calls to IsInsideSurface()
@@ -114,6 +134,7 @@ protected:
   int    CheckSurface;
   int    InsideOut;
   double Tolerance;
+  int    UseRayParity;
 
   int IsSurfaceClosed(vtkPolyData *surface);
   vtkUnsignedCharArray *InsideOutsideArray;
@@ -125,6 +146,10 @@ protected:
   vtkPolyData    *Surface;
   double          Bounds[6];
   double          Length;
+
+  // Ray parity classification.
+  vtkSelectEnclosedPointsTree *RayParityTree;
+  void RayParityExecute(vtkDataSet *input, vtkUnsignedCharArray *marks);
   
   virtual int RequestData(vtkInformation *, vtkInformationVector **, vtkInformationVector *);
   virtual int FillInputPortInformation(int, vtkInformation *);
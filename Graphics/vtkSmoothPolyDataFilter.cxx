@@ -21,6 +21,7 @@
 #include "vtkMath.h"
 #include "vtkInformation.h"
 #include "vtkInformationVector.h"
+#include "vtkMultiThreader.h"
 #include "vtkObjectFactory.h"
 #include "vtkPointData.h"
 #include "vtkPolyData.h"
@@ -28,6 +29,8 @@
 #include "vtkStreamingDemandDrivenPipeline.h"
 #include "vtkTriangleFilter.h"
 
+#include <vtkstd/vector>
+
 vtkStandardNewMacro(vtkSmoothPolyDataFilter);
 
 // The following code defines a helper class for performing mesh smoothing
@@ -120,6 +123,7 @@ vtkSmoothPolyDataFilter::vtkSmoothPolyDataFilter()
   this->NumberOfIterations = 20;
 
   this->RelaxationFactor = .01;
+  this->SimultaneousUpdate = 0;
 
   this->FeatureAngle = 45.0;
   this->EdgeAngle = 15.0;
@@ -159,7 +163,148 @@ typedef struct _vtkMeshVertex
   char      type;
   vtkIdList *edges; // connected edges (list of connected point ids)
 } vtkMeshVertex, *vtkMeshVertexPtr;
-    
+
+// Minimum number of points per thread in the smoothing iterations.
+#define VTK_SMOOTH_POINTS_PER_THREAD 20000
+
+//----------------------------------------------------------------------------
+// Performs one iteration with SimultaneousUpdate on, moving each point from
+// the previous positions of its neighbors. The connected vertices of point
+// i are Neighbors[Offsets[i]] to Neighbors[Offsets[i+1]-1].
+class vtkSmoothPolyDataFilterIteration
+{
+public:
+  vtkMeshVertex *Verts;
+  vtkIdType *Offsets;
+  vtkIdType *Neighbors;
+  vtkIdType NumberOfPoints;
+  double Factor;
+  vtkPoints *OldPoints;
+  vtkPoints *NewPoints;
+  vtkstd::vector<double> MaxDist; // per thread
+
+  void Execute(int numThreads);
+};
+
+//----------------------------------------------------------------------------
+template <class T>
+void vtkSmoothPolyDataFilterMovePoints(vtkSmoothPolyDataFilterIteration *self,
+                                       const T *oldPts, T *newPts,
+                                       vtkIdType begin, vtkIdType end,
+                                       double &maxDist)
+{
+  vtkIdType i, j, npts, *neighbors;
+  double deltaX[3], dist;
+  int k;
+
+  for (i=begin; i < end; i++)
+    {
+    const T *x = oldPts + 3*i;
+    T *xNew = newPts + 3*i;
+    npts = self->Offsets[i+1] - self->Offsets[i];
+    if ( self->Verts[i].type == VTK_FIXED_VERTEX || npts == 0 )
+      {
+      xNew[0] = x[0]; xNew[1] = x[1]; xNew[2] = x[2];
+      continue;
+      }
+
+    neighbors = self->Neighbors + self->Offsets[i];
+    deltaX[0] = deltaX[1] = deltaX[2] = 0.0;
+    for (j=0; j<npts; j++)
+      {
+      const T *y = oldPts + 3*neighbors[j];
+      for (k=0; k<3; k++)
+        {
+        deltaX[k] += (static_cast<double>(y[k]) - x[k]) / npts;
+        }
+      }
+    for (k=0; k<3; k++)
+      {
+      xNew[k] = static_cast<T>(x[k] + self->Factor * deltaX[k]);
+      }
+    if ( (dist = vtkMath::Norm(deltaX)) > maxDist )
+      {
+      maxDist = dist;
+      }
+    }
+}
+
+//----------------------------------------------------------------------------
+static VTK_THREAD_RETURN_TYPE vtkSmoothPolyDataFilterThread(void *arg)
+{
+  vtkMultiThreader::ThreadInfo *info =
+    static_cast<vtkMultiThreader::ThreadInfo *>(arg);
+  vtkSmoothPolyDataFilterIteration *self =
+    static_cast<vtkSmoothPolyDataFilterIteration *>(info->UserData);
+  vtkIdType numPts = self->NumberOfPoints;
+  vtkIdType begin = numPts * info->ThreadID / info->NumberOfThreads;
+  vtkIdType end = numPts * (info->ThreadID + 1) / info->NumberOfThreads;
+  double &maxDist = self->MaxDist[info->ThreadID];
+
+  if ( self->NewPoints->GetDataType() == VTK_DOUBLE )
+    {
+    vtkSmoothPolyDataFilterMovePoints(self,
+      static_cast<double *>(self->OldPoints->GetVoidPointer(0)),
+      static_cast<double *>(self->NewPoints->GetVoidPointer(0)),
+      begin, end, maxDist);
+    }
+  else
+    {
+    vtkSmoothPolyDataFilterMovePoints(self,
+      static_cast<float *>(self->OldPoints->GetVoidPointer(0)),
+      static_cast<float *>(self->NewPoints->GetVoidPointer(0)),
+      begin, end, maxDist);
+    }
+  return VTK_THREAD_RETURN_VALUE;
+}
+
+//----------------------------------------------------------------------------
+void vtkSmoothPolyDataFilterIteration::Execute(int numThreads)
+{
+  this->MaxDist.assign(numThreads, 0.0);
+  vtkMultiThreader::ThreadInfo info;
+  if ( numThreads <= 1 )
+    {
+    info.ThreadID = 0;
+    info.NumberOfThreads = 1;
+    info.UserData = this;
+    vtkSmoothPolyDataFilterThread(&info);
+    return;
+    }
+  vtkMultiThreader *threader = vtkMultiThreader::New();
+  threader->SetNumberOfThreads(numThreads);
+  threader->SetSingleMethod(vtkSmoothPolyDataFilterThread, this);
+  threader->SingleMethodExecute();
+  threader->Delete();
+}
+
+//----------------------------------------------------------------------------
+// Move a smoothed point to the closest point of the source surface.
+static void vtkSmoothPolyDataFilterConstrain(vtkSmoothPoint *sPtr,
+                                             vtkPolyData *source,
+                                             vtkCellLocator *cellLocator,
+                                             double *w, double xNew[3])
+{
+  vtkCell *cell=NULL;
+  double closestPt[3], dist2;
+
+  if ( sPtr->cellId >= 0 ) //in cell
+    {
+    cell = source->GetCell(sPtr->cellId);
+    }
+
+  if ( !cell || cell->EvaluatePosition(xNew, closestPt,
+  sPtr->subId, sPtr->p, dist2, w) == 0)
+    { // not in cell anymore
+    cellLocator->FindClosestPoint(xNew, closestPt, sPtr->cellId, 
+                                  sPtr->subId, dist2);
+    }
+  for (int k=0; k<3; k++)
+    {
+    xNew[k] = closestPt[k];
+    }
+}
+
 int vtkSmoothPolyDataFilter::RequestData(
   vtkInformation *vtkNotUsed(request),
   vtkInformationVector **inputVector,
@@ -512,11 +657,36 @@ int vtkSmoothPolyDataFilter::RequestData(
                 << numBEdges << " boundary edge vertices\n\t"
                 << numFixed << " fixed vertices\n\t");
 
+  // Pack the lists of connected vertices into a single array, which is
+  // what the smoothing iterations read.
+  vtkIdType *offsets = new vtkIdType[numPts+1];
+  offsets[0] = 0;
+  for (i=0; i<numPts; i++)
+    {
+    offsets[i+1] = offsets[i] +
+      (Verts[i].edges != NULL ? Verts[i].edges->GetNumberOfIds() : 0);
+    }
+  vtkIdType *neighbors = new vtkIdType[offsets[numPts] > 0 ? offsets[numPts] : 1];
+  for (i=0; i<numPts; i++)
+    {
+    if ( Verts[i].edges != NULL )
+      {
+      memcpy(neighbors + offsets[i], Verts[i].edges->GetPointer(0),
+             (offsets[i+1] - offsets[i]) * sizeof(vtkIdType));
+      Verts[i].edges->Delete();
+      Verts[i].edges = NULL;
+      }
+    }
+
   vtkDebugMacro(<<"Beginning smoothing iterations...");
 
   // We've setup the topology...now perform Laplacian smoothing
   //
   newPts = vtkPoints::New();
+  if ( inPts->GetDataType() == VTK_DOUBLE )
+    {
+    newPts->SetDataTypeToDouble();
+    }
   newPts->SetNumberOfPoints(numPts);
 
   // If Source defined, we do constrained smoothing (that is, points are 
@@ -547,6 +717,27 @@ int vtkSmoothPolyDataFilter::RequestData(
       }
     }
 
+  vtkSmoothPolyDataFilterIteration iteration;
+  vtkPoints *nextPts = NULL;
+  int numThreads = 1;
+  if ( this->SimultaneousUpdate )
+    {
+    iteration.Verts = Verts;
+    iteration.Offsets = offsets;
+    iteration.Neighbors = neighbors;
+    iteration.NumberOfPoints = numPts;
+    iteration.Factor = this->RelaxationFactor;
+    nextPts = vtkPoints::New();
+    nextPts->SetDataType(newPts->GetDataType());
+    nextPts->SetNumberOfPoints(numPts);
+    vtkIdType maxThreads = numPts / VTK_SMOOTH_POINTS_PER_THREAD;
+    numThreads = vtkMultiThreader::GetGlobalDefaultNumberOfThreads();
+    if ( maxThreads < numThreads )
+      {
+      numThreads = (maxThreads > 1 ? static_cast<int>(maxThreads) : 1);
+      }
+    }
+
   factor = this->RelaxationFactor;
   for ( maxDist=VTK_DOUBLE_MAX, iterationNumber=0, abortExecute=0; 
   maxDist > conv && iterationNumber < this->NumberOfIterations && !abortExecute;
@@ -564,16 +755,50 @@ int vtkSmoothPolyDataFilter::RequestData(
       }
 
     maxDist=0.0;
+    if ( this->SimultaneousUpdate )
+      {
+      iteration.OldPoints = newPts;
+      iteration.NewPoints = nextPts;
+      iteration.Execute(numThreads);
+      for (j=0; j<numThreads; j++)
+        {
+        if ( iteration.MaxDist[j] > maxDist )
+          {
+          maxDist = iteration.MaxDist[j];
+          }
+        }
+
+      // Constrain the moved points to the surface
+      if ( source )
+        {
+        for (i=0; i<numPts; i++)
+          {
+          if ( Verts[i].type != VTK_FIXED_VERTEX && offsets[i+1] > offsets[i] )
+            {
+            nextPts->GetPoint(i, xNew);
+            vtkSmoothPolyDataFilterConstrain(
+              this->SmoothPoints->GetSmoothPoint(i), source, cellLocator, w,
+              xNew);
+            nextPts->SetPoint(i, xNew);
+            }
+          }
+        }
+      vtkPoints *tmp = newPts;
+      newPts = nextPts;
+      nextPts = tmp;
+      continue;
+      }
+
     for (i=0; i<numPts; i++) 
       {
-      if ( Verts[i].type != VTK_FIXED_VERTEX && Verts[i].edges != NULL &&
-      (npts = Verts[i].edges->GetNumberOfIds()) > 0 )
+      if ( Verts[i].type != VTK_FIXED_VERTEX &&
+      (npts = offsets[i+1] - offsets[i]) > 0 )
         {
         newPts->GetPoint(i, x); //use current points
         deltaX[0] = deltaX[1] = deltaX[2] = 0.0;
         for (j=0; j<npts; j++)
           {
-          newPts->GetPoint(Verts[i].edges->GetId(j), y);
+          newPts->GetPoint(neighbors[offsets[i]+j], y);
           for (k=0; k<3; k++)
             {
             deltaX[k] += (y[k] - x[k]) / npts;
@@ -588,24 +813,9 @@ int vtkSmoothPolyDataFilter::RequestData(
         // Constrain point to surface
         if ( source ) 
           {
-          vtkSmoothPoint *sPtr = this->SmoothPoints->GetSmoothPoint(i);
-          vtkCell *cell=NULL;
-
-          if ( sPtr->cellId >= 0 ) //in cell
-            {
-            cell = source->GetCell(sPtr->cellId);
-            }
-
-          if ( !cell || cell->EvaluatePosition(xNew, closestPt,
-          sPtr->subId, sPtr->p, dist2, w) == 0)
-            { // not in cell anymore
-            cellLocator->FindClosestPoint(xNew, closestPt, sPtr->cellId, 
-                                          sPtr->subId, dist2);
-            }
-          for (k=0; k<3; k++)
-            {
-            xNew[k] = closestPt[k];
-            }
+          vtkSmoothPolyDataFilterConstrain(
+            this->SmoothPoints->GetSmoothPoint(i), source, cellLocator, w,
+            xNew);
           }
 
         newPts->SetPoint(i,xNew);
@@ -617,6 +827,13 @@ int vtkSmoothPolyDataFilter::RequestData(
       }//for all points
     } //for not converged or within iteration count
 
+  if ( nextPts )
+    {
+    nextPts->Delete();
+    }
+  delete [] offsets;
+  delete [] neighbors;
+
   vtkDebugMacro(<<"Performed " << iterationNumber << " smoothing passes");
   if ( source )
     {
@@ -673,15 +890,6 @@ int vtkSmoothPolyDataFilter::RequestData(
   output->SetPolys(input->GetPolys());
   output->SetStrips(input->GetStrips());
 
-  //free up connectivity storage
-  for (i=0; i<numPts; i++)
-    {
-    if ( Verts[i].edges != NULL ) 
-      {
-      Verts[i].edges->Delete();
-      Verts[i].edges = NULL;
-      }
-    }
   delete [] Verts;
 
   return 1;
@@ -709,6 +917,7 @@ void vtkSmoothPolyDataFilter::PrintSelf(ostream& os, vtkIndent indent)
   os << indent << "Convergence: " << this->Convergence << "\n";
   os << indent << "Number of Iterations: " << this->NumberOfIterations << "\n";
   os << indent << "Relaxation Factor: " << this->RelaxationFactor << "\n";
+  os << indent << "Simultaneous Update: " << (this->SimultaneousUpdate ? "On\n" : "Off\n");
   os << indent << "Feature Edge Smoothing: " << (this->FeatureEdgeSmoothing ? "On\n" : "Off\n");
   os << indent << "Feature Angle: " << this->FeatureAngle << "\n";
   os << indent << "Edge Angle: " << this->EdgeAngle << "\n";
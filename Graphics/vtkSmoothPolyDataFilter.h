@@ -65,6 +65,14 @@
 // smoothing process terminates. (Convergence is expressed as a fraction of 
 // the diagonal of the bounding box.)
 //
+// By default each vertex is moved in turn, and the vertices that follow it
+// in the same iteration see its new position. When SimultaneousUpdate is
+// on, all the vertices are instead moved at once from their positions at
+// the end of the previous iteration. This converges a little slower, but
+// the vertices of an iteration can then be moved by several threads.
+// Double precision input points are smoothed and output in double
+// precision.
+//
 // There are two instance variables that control the generation of error
 // data. If the ivar GenerateErrorScalars is on, then a scalar value indicating
 // the distance of each vertex from its original position is computed. If the
@@ -128,6 +136,15 @@ public:
   vtkSetMacro(RelaxationFactor,double);
   vtkGetMacro(RelaxationFactor,double);
 
+  // Description:
+  // Turn on/off moving all the vertices at once from their positions of
+  // the previous iteration, which lets the iterations run on several
+  // threads. When off (the default), the vertices are moved one after the
+  // other, each one from the current positions of its neighbors.
+  vtkSetMacro(SimultaneousUpdate,int);
+  vtkGetMacro(SimultaneousUpdate,int);
+  vtkBooleanMacro(SimultaneousUpdate,int);
+
   // Description:
   // Turn on/off smoothing along sharp interior edges.
   vtkSetMacro(FeatureEdgeSmoothing,int);
@@ -180,6 +197,7 @@ protected:
   double Convergence;
   int NumberOfIterations;
   double RelaxationFactor;
+  int SimultaneousUpdate;
   int FeatureEdgeSmoothing;
   double FeatureAngle;
   double EdgeAngle;
@@ -57,9 +57,12 @@
 #include "vtkRectilinearGrid.h"
 #include "vtkUnstructuredGrid.h"
 #include "vtkGenericCell.h"
+#include "vtkMultiThreader.h"
 
 #include "vtkTableBasedClipCases.h"
 
+#define VTK_TABLE_BASED_CLIP_CELLS_PER_THREAD 20000
+
 vtkStandardNewMacro( vtkTableBasedClipDataSet );
 vtkCxxSetObjectMacro( vtkTableBasedClipDataSet, ClipFunction, vtkImplicitFunction );
 
@@ -467,6 +470,7 @@ class vtkTableBasedClipperShapeList
     int            GetTotalNumberOfShapes() const;
     int            GetNumberOfLists() const;
     int            GetList(int, const int *& ) const;
+    void           AddShape( const int * );
   protected:
     int         ** list;
     int            currentList;
@@ -633,6 +637,10 @@ class  vtkTableBasedClipperVolumeFromVolume :
     void     AddVertex(int z, int v0)
              { this->vertices.AddVertex( z, v0 ); }
 
+    // Append the points and the shapes of another object built over the
+    // same input, as if its cells had been clipped by this object.
+    void     Append( const vtkTableBasedClipperVolumeFromVolume & part );
+
   protected:
     vtkTableBasedClipperCentroidPointList centroid_list;
     vtkTableBasedClipperHexList     hexes;
@@ -650,6 +658,20 @@ class  vtkTableBasedClipperVolumeFromVolume :
     void         ConstructDataSet
                  ( vtkPointData *, vtkCellData *, vtkUnstructuredGrid *, 
                    TableBasedClipperCommonPointsStructure & );
+
+    int          AppendedPointId( int id, const vtkstd::vector< int > & edgeIds,
+                                  const vtkstd::vector< int > & centroidIds )
+                 {
+                   if ( id < 0 )
+                     {
+                     return -1 - centroidIds[ -1 - id ];
+                     }
+                   if ( id >= numPrevPts )
+                     {
+                     return numPrevPts + edgeIds[ id - numPrevPts ];
+                     }
+                   return id;
+                 }
 };
 
 
@@ -827,6 +849,42 @@ int  vtkTableBasedClipperShapeList::GetTotalNumberOfShapes() const
   return numFullLists * shapesPerList + numExtra;
 }
 
+void vtkTableBasedClipperShapeList::AddShape( const int * shape )
+{
+  if ( currentShape >= shapesPerList )
+    {
+    if (  ( currentList + 1 ) >= listSize  )
+      {
+      int ** tmpList = new int * [ 2 * listSize ];
+      for ( int i = 0; i < listSize; i ++ )
+        {
+        tmpList[i] = list[i];
+        }
+        
+      for ( int i = listSize; i < listSize * 2; i ++ )
+        {
+        tmpList[i] = NULL;
+        }
+        
+      listSize *= 2;
+      delete [] list;
+      list = tmpList;
+      }
+ 
+    currentList ++;
+    list[ currentList ] = new int[  ( shapeSize + 1 ) * shapesPerList  ];
+    currentShape = 0;
+    }
+ 
+  // The entry holds the cell id followed by the point ids.
+  int idx = ( shapeSize + 1 ) * currentShape;
+  for ( int i = 0; i <= shapeSize; i ++ )
+    {
+    list[ currentList ][ idx + i ] = shape[i];
+    }
+  currentShape ++;
+}
+
 vtkTableBasedClipperHexList::vtkTableBasedClipperHexList()
     : vtkTableBasedClipperShapeList( 8 )
 {
@@ -1554,6 +1612,78 @@ void vtkTableBasedClipperVolumeFromVolume::
   delete [] ptLookup;
 }
 
+void vtkTableBasedClipperVolumeFromVolume::Append
+     ( const vtkTableBasedClipperVolumeFromVolume & part )
+{
+  int   i, j, k, l;
+
+  //
+  // Add the edge points through the hash table, so that the points on the
+  // edges shared with the cells already clipped are merged.
+  //
+  vtkstd::vector< int > edgeIds;
+  edgeIds.reserve( part.pt_list.GetTotalNumberOfPoints() );
+  int nLists = part.pt_list.GetNumberOfLists();
+  for ( i = 0; i < nLists; i ++ )
+    {
+    const TableBasedClipperPointEntry * pe_list = NULL;
+    int nPts = part.pt_list.GetList( i, pe_list );
+    for ( j = 0; j < nPts; j ++ )
+      {
+      edgeIds.push_back(  this->edges.AddPoint
+        ( pe_list[j].ptIds[0], pe_list[j].ptIds[1], pe_list[j].percent )  );
+      }
+    }
+
+  //
+  // The centroid points may refer to edge points and to previous centroids.
+  //
+  vtkstd::vector< int > centroidIds;
+  centroidIds.reserve( part.centroid_list.GetTotalNumberOfPoints() );
+  nLists = part.centroid_list.GetNumberOfLists();
+  for ( i = 0; i < nLists; i ++ )
+    {
+    const TableBasedClipperCentroidPointEntry * ce_list = NULL;
+    int nPts = part.centroid_list.GetList( i, ce_list );
+    for ( j = 0; j < nPts; j ++ )
+      {
+      int ptIds[8];
+      for ( k = 0; k < ce_list[j].nPts; k ++ )
+        {
+        ptIds[k] = this->AppendedPointId
+                   ( ce_list[j].ptIds[k], edgeIds, centroidIds );
+        }
+      centroidIds.push_back
+        (  this->centroid_list.AddPoint( ce_list[j].nPts, ptIds )  );
+      }
+    }
+
+  //
+  // Add the shapes after those of the same type.
+  //
+  int shape[9];
+  for ( i = 0; i < nshapes; i ++ )
+    {
+    int shapesize = part.shapes[i]->GetShapeSize();
+    nLists = part.shapes[i]->GetNumberOfLists();
+    for ( j = 0; j < nLists; j ++ )
+      {
+      const int * list;
+      int listSize = part.shapes[i]->GetList( j, list );
+      for ( k = 0; k < listSize; k ++ )
+        {
+        shape[0] = list[0];
+        for ( l = 1; l <= shapesize; l ++ )
+          {
+          shape[l] = this->AppendedPointId( list[l], edgeIds, centroidIds );
+          }
+        this->shapes[i]->AddShape( shape );
+        list += shapesize + 1;
+        }
+      }
+    }
+}
+
 inline void GetPoint( double * pt, const double * X, const double * Y,
                       const double * Z, const int * dims, const int & index )
 {
@@ -2075,26 +2205,166 @@ void vtkTableBasedClipDataSet::ClipImageData( vtkDataSet * inputGrd,
 }
 
 //-----------------------------------------------------------------------------
-void vtkTableBasedClipDataSet::ClipPolyData( vtkDataSet * inputGrd, 
-     vtkDataArray * clipAray, double isoValue, vtkUnstructuredGrid * outputUG )
+// Whether the case tables handle a cell type. Voxels and pixels only come
+// with the unstructured grids.
+static bool vtkTableBasedClipperCanClip( int cellType, bool withVoxels )
 {
-  vtkPolyData * polyData = vtkPolyData::SafeDownCast( inputGrd );
-  int           numCells = polyData->GetNumberOfCells();
+  switch ( cellType )
+    {
+    case VTK_TETRA:
+    case VTK_PYRAMID:
+    case VTK_WEDGE:
+    case VTK_HEXAHEDRON:
+    case VTK_TRIANGLE:
+    case VTK_QUAD:
+    case VTK_LINE:
+    case VTK_VERTEX:
+         return true;
 
-  vtkTableBasedClipperVolumeFromVolume   * visItVFV = new
-  vtkTableBasedClipperVolumeFromVolume(    polyData->GetNumberOfPoints(),
-     int(   pow(  double( numCells ),  double( 0.6667f )  )   ) * 5 + 100    );
+    case VTK_VOXEL:
+    case VTK_PIXEL:
+         return withVoxels;
 
-  vtkUnstructuredGrid * specials = vtkUnstructuredGrid::New();
-  specials->SetPoints( polyData->GetPoints() );
-  specials->GetPointData()->ShallowCopy( polyData->GetPointData() );
-  specials->Allocate( numCells );
+    default:
+         return false;
+    }
+}
+
+//-----------------------------------------------------------------------------
+// Clips ranges of cells in separate threads, each range into its own
+// vtkTableBasedClipperVolumeFromVolume.
+class vtkTableBasedClipperCellsWorker
+{
+public:
+  vtkTableBasedClipDataSet * Self;
+  vtkDataSet               * Input;
+  vtkDataArray             * ClipAray;
+  double                     IsoValue;
+  vtkIdType                  NumberOfCells;
+  vtkstd::vector< vtkTableBasedClipperVolumeFromVolume * > Parts;
+
+  void ClipCells( vtkIdType begin, vtkIdType end, 
+                  vtkTableBasedClipperVolumeFromVolume * visItVFV )
+    {
+    switch ( this->Input->GetDataObjectType() )
+      {
+      case VTK_POLY_DATA:
+           this->Self->ClipPolyDataCells
+             ( static_cast< vtkPolyData * >( this->Input ),
+               this->ClipAray, this->IsoValue, begin, end, visItVFV );
+           break;
+
+      case VTK_RECTILINEAR_GRID:
+           this->Self->ClipRectilinearGridCells
+             ( static_cast< vtkRectilinearGrid * >( this->Input ),
+               this->ClipAray, this->IsoValue, begin, end, visItVFV );
+           break;
 
+      case VTK_STRUCTURED_GRID:
+           this->Self->ClipStructuredGridCells
+             ( static_cast< vtkStructuredGrid * >( this->Input ),
+               this->ClipAray, this->IsoValue, begin, end, visItVFV );
+           break;
+
+      default:
+           this->Self->ClipUnstructuredGridCells
+             ( static_cast< vtkUnstructuredGrid * >( this->Input ),
+               this->ClipAray, this->IsoValue, begin, end, visItVFV );
+           break;
+      }
+    }
+
+  static VTK_THREAD_RETURN_TYPE ThreadedExecute( void * arg )
+    {
+    vtkMultiThreader::ThreadInfo * info =
+      static_cast< vtkMultiThreader::ThreadInfo * >( arg );
+    vtkTableBasedClipperCellsWorker * self =
+      static_cast< vtkTableBasedClipperCellsWorker * >( info->UserData );
+    vtkIdType num   = self->NumberOfCells;
+    vtkIdType begin = num * info->ThreadID / info->NumberOfThreads;
+    vtkIdType end   = num * ( info->ThreadID + 1 ) / info->NumberOfThreads;
+    self->ClipCells( begin, end, self->Parts[ info->ThreadID ] );
+    return VTK_THREAD_RETURN_VALUE;
+    }
+};
+
+//-----------------------------------------------------------------------------
+vtkTableBasedClipperVolumeFromVolume * vtkTableBasedClipDataSet::ClipCells
+  ( vtkDataSet * inputGrd, vtkDataArray * clipAray, double isoValue )
+{
+  int       i;
+  vtkIdType numCells = inputGrd->GetNumberOfCells();
+  int       numPnts  = static_cast< int >( inputGrd->GetNumberOfPoints() );
+
+  vtkTableBasedClipperCellsWorker worker;
+  worker.Self          = this;
+  worker.Input         = inputGrd;
+  worker.ClipAray      = clipAray;
+  worker.IsoValue      = isoValue;
+  worker.NumberOfCells = numCells;
+
+  // The first part receives the others, so its hash table is sized for the
+  // whole grid.
+  vtkTableBasedClipperVolumeFromVolume * visItVFV = new
+  vtkTableBasedClipperVolumeFromVolume(  numPnts,
+      int(   pow(  double( numCells ), double( 0.6667f )  )   ) * 5 + 100    );
+
+  int       numThreads = vtkMultiThreader::GetGlobalDefaultNumberOfThreads();
+  vtkIdType maxThreads = numCells / VTK_TABLE_BASED_CLIP_CELLS_PER_THREAD;
+  if ( maxThreads < numThreads )
+    {
+    numThreads = ( maxThreads > 1 ? static_cast< int >( maxThreads ) : 1 );
+    }
+  if ( numThreads <= 1 )
+    {
+    worker.ClipCells( 0, numCells, visItVFV );
+    return visItVFV;
+    }
+
+  // GetCellPoints() and GetCellType() are thread safe once they have been
+  // called from a single thread.
+  vtkIdList * ptIds = vtkIdList::New();
+  inputGrd->GetCellPoints( 0, ptIds );
+  inputGrd->GetCellType( 0 );
+  ptIds->Delete();
+
+  worker.Parts.resize( numThreads );
+  worker.Parts[0] = visItVFV;
+  for ( i = 1; i < numThreads; i ++ )
+    {
+    worker.Parts[i] = new vtkTableBasedClipperVolumeFromVolume(  numPnts,
+      int(   pow(  double( numCells / numThreads ), double( 0.6667f )  )   )
+      * 5 + 100    );
+    }
+
+  vtkMultiThreader * threader = vtkMultiThreader::New();
+  threader->SetNumberOfThreads( numThreads );
+  threader->SetSingleMethod
+            ( vtkTableBasedClipperCellsWorker::ThreadedExecute, &worker );
+  threader->SingleMethodExecute();
+  threader->Delete();
+
+  // Appending the parts in the order of the cell ranges gives the points and
+  // the shapes of a serial pass.
+  for ( i = 1; i < numThreads; i ++ )
+    {
+    visItVFV->Append( *worker.Parts[i] );
+    delete worker.Parts[i];
+    worker.Parts[i] = NULL;
+    }
+
+  return visItVFV;
+}
+
+//-----------------------------------------------------------------------------
+void vtkTableBasedClipDataSet::ClipPolyDataCells( vtkPolyData * polyData,
+     vtkDataArray * clipAray, double isoValue, vtkIdType begin,
+     vtkIdType end, vtkTableBasedClipperVolumeFromVolume * visItVFV )
+{
   vtkIdType   i, j;
   vtkIdType   numbPnts = 0;
-  int         numCants = 0;  // number of cells not clipped by this filter
-  
-  for ( i = 0; i < numCells; i ++ )
+
+  for ( i = begin; i < end; i ++ )
     {
     int         cellType = polyData->GetCellType( i );
     bool        bCanClip = false;
@@ -2362,20 +2632,51 @@ void vtkTableBasedClipDataSet::ClipPolyData( vtkDataSet * inputGrd,
       edgeVtxs = NULL;
       thisCase = NULL;
       }
-    else
+      
+    pntIndxs = NULL;
+    }
+}
+
+//-----------------------------------------------------------------------------
+void vtkTableBasedClipDataSet::ClipPolyData( vtkDataSet * inputGrd, 
+     vtkDataArray * clipAray, double isoValue, vtkUnstructuredGrid * outputUG )
+{
+  vtkPolyData * polyData = vtkPolyData::SafeDownCast( inputGrd );
+  int           numCells = polyData->GetNumberOfCells();
+
+  vtkUnstructuredGrid * specials = vtkUnstructuredGrid::New();
+  specials->SetPoints( polyData->GetPoints() );
+  specials->GetPointData()->ShallowCopy( polyData->GetPointData() );
+  specials->Allocate( numCells );
+
+  vtkIdType   i;
+  vtkIdType   numbPnts = 0;
+  int         numCants = 0;  // number of cells not clipped by this filter
+  
+  vtkTableBasedClipperVolumeFromVolume * visItVFV = 
+    this->ClipCells( polyData, clipAray, isoValue );
+
+  // The cells which the tables do not handle are clipped by vtkClipDataSet.
+  for ( i = 0; i < numCells; i ++ )
+    {
+    int         cellType = polyData->GetCellType( i );
+    vtkIdType * pntIndxs = NULL;
+    if (  vtkTableBasedClipperCanClip( cellType, false )  )
       {
-      if ( numCants == 0 )
-        {
-        specials->GetCellData()
-                ->CopyAllocate( polyData->GetCellData(), numCells );
-        }
+      continue;
+      }
 
-      specials->InsertNextCell( cellType, numbPnts, pntIndxs );
+    if ( numCants == 0 )
+      {
       specials->GetCellData()
-              ->CopyData( polyData->GetCellData(), i, numCants );
-      numCants ++;
+              ->CopyAllocate( polyData->GetCellData(), numCells );
       }
-      
+
+    polyData->GetCellPoints( i, numbPnts, pntIndxs );
+    specials->InsertNextCell( cellType, numbPnts, pntIndxs );
+    specials->GetCellData()
+            ->CopyData( polyData->GetCellData(), i, numCants );
+    numCants ++;
     pntIndxs = NULL;
     }
   
@@ -2443,22 +2744,15 @@ void vtkTableBasedClipDataSet::ClipPolyData( vtkDataSet * inputGrd,
 }
 
 //-----------------------------------------------------------------------------
-void vtkTableBasedClipDataSet::ClipRectilinearGridData( vtkDataSet * inputGrd, 
-     vtkDataArray * clipAray, double isoValue, vtkUnstructuredGrid * outputUG )
+void vtkTableBasedClipDataSet::ClipRectilinearGridCells( vtkRectilinearGrid * rectGrid,
+     vtkDataArray * clipAray, double isoValue, vtkIdType begin,
+     vtkIdType end, vtkTableBasedClipperVolumeFromVolume * visItVFV )
 {
-  vtkRectilinearGrid * rectGrid = vtkRectilinearGrid::SafeDownCast( inputGrd );
-  
   int   i, j;
-  int   numCells = 0;
   int   isTwoDim = 0;
   int   rectDims[3];
   rectGrid->GetDimensions( rectDims );
   isTwoDim = int( rectDims[2] <= 1 );
-  numCells = rectGrid->GetNumberOfCells();
-
-  vtkTableBasedClipperVolumeFromVolume   * visItVFV = new
-  vtkTableBasedClipperVolumeFromVolume(    rectGrid->GetNumberOfPoints(),
-      int(   pow(  double( numCells ), double( 0.6667f )  )   ) * 5 + 100    );
 
   int   shiftLUT[3][8] = { 
                            { 0, 1, 1, 0, 0, 1, 1, 0 },
@@ -2471,7 +2765,7 @@ void vtkTableBasedClipDataSet::ClipRectilinearGridData( vtkDataSet * inputGrd,
   int   pyStride    = rectDims[0];
   int   pzStride    = rectDims[0] * rectDims[1];
   
-  for ( i = 0; i < numCells; i ++ )
+  for ( i = static_cast< int >( begin ); i < end; i ++ )
     {     
     int    caseIndx = 0;   
     int    nCellPts = isTwoDim ? 4 : 8;
@@ -2711,7 +3005,20 @@ void vtkTableBasedClipDataSet::ClipRectilinearGridData( vtkDataSet * inputGrd,
       
     thisCase = NULL;
     }
+}
+
+//-----------------------------------------------------------------------------
+void vtkTableBasedClipDataSet::ClipRectilinearGridData( vtkDataSet * inputGrd, 
+     vtkDataArray * clipAray, double isoValue, vtkUnstructuredGrid * outputUG )
+{
+  vtkRectilinearGrid * rectGrid = vtkRectilinearGrid::SafeDownCast( inputGrd );
   
+  int   i, j;
+  int   rectDims[3];
+  rectGrid->GetDimensions( rectDims );
+
+  vtkTableBasedClipperVolumeFromVolume * visItVFV = 
+    this->ClipCells( rectGrid, clipAray, isoValue );
   
   int            toDelete    = 0;
   double       * theCords[3] = { NULL, NULL, NULL };
@@ -2765,24 +3072,16 @@ void vtkTableBasedClipDataSet::ClipRectilinearGridData( vtkDataSet * inputGrd,
 }
 
 //-----------------------------------------------------------------------------
-void vtkTableBasedClipDataSet::ClipStructuredGridData( vtkDataSet * inputGrd, 
-     vtkDataArray * clipAray, double isoValue, vtkUnstructuredGrid * outputUG )
+void vtkTableBasedClipDataSet::ClipStructuredGridCells( vtkStructuredGrid * strcGrid,
+     vtkDataArray * clipAray, double isoValue, vtkIdType begin,
+     vtkIdType end, vtkTableBasedClipperVolumeFromVolume * visItVFV )
 {
-  vtkStructuredGrid * strcGrid = vtkStructuredGrid::SafeDownCast( inputGrd );
-  
   int   i, j;
   int   isTwoDim    = 0;
-  int   numCells    = 0;
   int   gridDims[3] = { 0, 0, 0 };
   strcGrid->GetDimensions( gridDims );
   isTwoDim = int( gridDims[2] <= 1 );
-  numCells = strcGrid->GetNumberOfCells();
-
-  vtkTableBasedClipperVolumeFromVolume  *  visItVFV = new
-  vtkTableBasedClipperVolumeFromVolume(    strcGrid->GetNumberOfPoints(),
-      int(   pow(  double( numCells ), double( 0.6667f )  )   ) * 5 + 100    );
 
-  
   int   shiftLUT[3][8] = { 
                            { 0, 1, 1, 0, 0, 1, 1, 0 },
                            { 0, 0, 1, 1, 0, 0, 1, 1 },
@@ -2795,7 +3094,7 @@ void vtkTableBasedClipDataSet::ClipStructuredGridData( vtkDataSet * inputGrd,
   int   pyStride    = gridDims[0];
   int   pzStride    = gridDims[0] * gridDims[1];
   
-  for ( i = 0; i < numCells; i ++ )
+  for ( i = static_cast< int >( begin ); i < end; i ++ )
     {
     int    caseIndx = 0;
     int    theCellI = i % cellDims[0];
@@ -3011,6 +3310,19 @@ void vtkTableBasedClipDataSet::ClipStructuredGridData( vtkDataSet * inputGrd,
       
     thisCase = NULL;
     }
+}
+
+//-----------------------------------------------------------------------------
+void vtkTableBasedClipDataSet::ClipStructuredGridData( vtkDataSet * inputGrd, 
+     vtkDataArray * clipAray, double isoValue, vtkUnstructuredGrid * outputUG )
+{
+  vtkStructuredGrid * strcGrid = vtkStructuredGrid::SafeDownCast( inputGrd );
+  
+  int   i;
+  int   numbPnts = 0;
+
+  vtkTableBasedClipperVolumeFromVolume * visItVFV = 
+    this->ClipCells( strcGrid, clipAray, isoValue );
   
   int         toDelete = 0;
   double    * theCords = NULL;
@@ -3046,28 +3358,14 @@ void vtkTableBasedClipDataSet::ClipStructuredGridData( vtkDataSet * inputGrd,
 }
 
 //-----------------------------------------------------------------------------
-void vtkTableBasedClipDataSet::ClipUnstructuredGridData( vtkDataSet * inputGrd, 
-     vtkDataArray * clipAray, double isoValue, vtkUnstructuredGrid * outputUG )
-{ 
-  vtkUnstructuredGrid * unstruct = vtkUnstructuredGrid::SafeDownCast( inputGrd );
-  
+void vtkTableBasedClipDataSet::ClipUnstructuredGridCells( vtkUnstructuredGrid * unstruct,
+     vtkDataArray * clipAray, double isoValue, vtkIdType begin,
+     vtkIdType end, vtkTableBasedClipperVolumeFromVolume * visItVFV )
+{
   vtkIdType   i, j;
   vtkIdType   numbPnts = 0;
-  int         numCants = 0; // number of cells not clipped by this filter
-  int         numCells = unstruct->GetNumberOfCells();
-  
-  // volume from volume
-  vtkTableBasedClipperVolumeFromVolume   * visItVFV = new
-  vtkTableBasedClipperVolumeFromVolume(    unstruct->GetNumberOfPoints(), 
-      int(   pow(  double( numCells ), double( 0.6667f )  )   ) * 5 + 100    );
 
-  // the stuffs that can not be clipped by this filter
-  vtkUnstructuredGrid * specials = vtkUnstructuredGrid::New();
-  specials->SetPoints( unstruct->GetPoints() );
-  specials->GetPointData()->ShallowCopy( unstruct->GetPointData() );
-  specials->Allocate( numCells );
-
-  for ( i = 0; i < numCells; i ++ )
+  for ( i = begin; i < end; i ++ )
     {
     int         cellType = unstruct->GetCellType( i );
     vtkIdType * pntIndxs = NULL;
@@ -3360,33 +3658,61 @@ void vtkTableBasedClipDataSet::ClipUnstructuredGridData( vtkDataSet * inputGrd,
       edgeVtxs = NULL;
       thisCase = NULL;
       }
-    else if (cellType == VTK_POLYHEDRON)
+      
+    pntIndxs = NULL;
+    }
+}
+
+//-----------------------------------------------------------------------------
+void vtkTableBasedClipDataSet::ClipUnstructuredGridData( vtkDataSet * inputGrd, 
+     vtkDataArray * clipAray, double isoValue, vtkUnstructuredGrid * outputUG )
+{ 
+  vtkUnstructuredGrid * unstruct = vtkUnstructuredGrid::SafeDownCast( inputGrd );
+  
+  vtkIdType   i;
+  vtkIdType   numbPnts = 0;
+  int         numCants = 0; // number of cells not clipped by this filter
+  int         numCells = unstruct->GetNumberOfCells();
+  
+  // the stuffs that can not be clipped by this filter
+  vtkUnstructuredGrid * specials = vtkUnstructuredGrid::New();
+  specials->SetPoints( unstruct->GetPoints() );
+  specials->GetPointData()->ShallowCopy( unstruct->GetPointData() );
+  specials->Allocate( numCells );
+
+  vtkTableBasedClipperVolumeFromVolume * visItVFV = 
+    this->ClipCells( unstruct, clipAray, isoValue );
+
+  // The cells which the tables do not handle are clipped by vtkClipDataSet.
+  for ( i = 0; i < numCells; i ++ )
+    {
+    int         cellType = unstruct->GetCellType( i );
+    vtkIdType * pntIndxs = NULL;
+    if (  vtkTableBasedClipperCanClip( cellType, true )  )
+      {
+      continue;
+      }
+
+    if ( numCants == 0 )
+      {
+      specials->GetCellData()
+              ->CopyAllocate( unstruct->GetCellData(), numCells );
+      }
+
+    if ( cellType == VTK_POLYHEDRON )
       {
-      if ( numCants == 0 )
-        {
-          specials->GetCellData()
-                  ->CopyAllocate( unstruct->GetCellData(), numCells );
-        }
       vtkIdType nfaces, *facePtIds;
       unstruct->GetFaceStream(i, nfaces, facePtIds);
       specials->InsertNextCell(cellType, nfaces, facePtIds);
-      specials->GetCellData()
-              ->CopyData( unstruct->GetCellData(), i, numCants );
-      numCants ++;
       }
     else
       {
-      if ( numCants == 0 )
-        {
-          specials->GetCellData()
-                  ->CopyAllocate( unstruct->GetCellData(), numCells );
-        }
+      unstruct->GetCellPoints( i, numbPnts, pntIndxs );
       specials->InsertNextCell( cellType, numbPnts, pntIndxs );
-      specials->GetCellData()
-              ->CopyData( unstruct->GetCellData(), i, numCants );
-      numCants ++;
       }
-      
+    specials->GetCellData()
+            ->CopyData( unstruct->GetCellData(), i, numCants );
+    numCants ++;
     pntIndxs = NULL;
     }
   
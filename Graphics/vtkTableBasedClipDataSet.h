@@ -96,6 +96,10 @@
 class vtkCallbackCommand;
 class vtkImplicitFunction;
 class vtkIncrementalPointLocator;
+class vtkPolyData;
+class vtkRectilinearGrid;
+class vtkStructuredGrid;
+class vtkTableBasedClipperVolumeFromVolume;
 
 class VTK_GRAPHICS_EXPORT vtkTableBasedClipDataSet : public vtkUnstructuredGridAlgorithm
 {
@@ -244,6 +248,39 @@ protected:
   // (provided via SetClipFunction()). The clipping result is exported to outputUG.
   void ClipUnstructuredGridData( vtkDataSet * inputGrd, vtkDataArray * clipAray, 
                                  double isoValue, vtkUnstructuredGrid * outputUG );
+
+//BTX
+  // Description:
+  // This function runs the case tables over all the cells of inputGrd that
+  // they can clip. The cells are split into ranges that are clipped by
+  // separate threads, each with its own shape lists and edge hash table, and
+  // the partial results are then merged in the order of the ranges, which
+  // gives the output of a serial pass. The returned object is to be deleted
+  // by the caller.
+  vtkTableBasedClipperVolumeFromVolume * ClipCells( vtkDataSet * inputGrd,
+                                    vtkDataArray * clipAray, double isoValue );
+
+  // Description:
+  // These functions clip the cells [begin, end) of a grid with the case
+  // tables and add the resulting shapes to visItVFV. Cells that the tables
+  // do not handle are skipped.
+  void ClipPolyDataCells( vtkPolyData * polyData, vtkDataArray * clipAray,
+                          double isoValue, vtkIdType begin, vtkIdType end,
+                          vtkTableBasedClipperVolumeFromVolume * visItVFV );
+  void ClipRectilinearGridCells( vtkRectilinearGrid * rectGrid,
+                          vtkDataArray * clipAray, double isoValue,
+                          vtkIdType begin, vtkIdType end,
+                          vtkTableBasedClipperVolumeFromVolume * visItVFV );
+  void ClipStructuredGridCells( vtkStructuredGrid * strcGrid,
+                          vtkDataArray * clipAray, double isoValue,
+                          vtkIdType begin, vtkIdType end,
+                          vtkTableBasedClipperVolumeFromVolume * visItVFV );
+  void ClipUnstructuredGridCells( vtkUnstructuredGrid * unstruct,
+                          vtkDataArray * clipAray, double isoValue,
+                          vtkIdType begin, vtkIdType end,
+                          vtkTableBasedClipperVolumeFromVolume * visItVFV );
+  friend class vtkTableBasedClipperCellsWorker;
+//ETX
        
   
   // Description:
@@ -16,16 +16,78 @@
 
 #include "vtkCell.h"
 #include "vtkCellData.h"
+#include "vtkExtractCells.h"
 #include "vtkIdList.h"
 #include "vtkInformation.h"
 #include "vtkInformationVector.h"
+#include "vtkMultiThreader.h"
 #include "vtkObjectFactory.h"
 #include "vtkPointData.h"
 #include "vtkUnstructuredGrid.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
 
+#include <vtkstd/vector>
+
 vtkStandardNewMacro(vtkThreshold);
 
+//----------------------------------------------------------------------------
+// Evaluates the threshold criterion of the cells, one range of cells per
+// thread.
+#define VTK_THRESHOLD_CELLS_PER_THREAD 50000
+
+class vtkThresholdCellEvaluator
+{
+public:
+  vtkThreshold *Self;
+  vtkDataSet *Input;
+  vtkDataArray *Scalars;
+  unsigned char *Keep;
+  vtkIdType NumberOfCells;
+
+  void Execute()
+    {
+    int numThreads = vtkMultiThreader::GetGlobalDefaultNumberOfThreads();
+    vtkIdType maxThreads = this->NumberOfCells/VTK_THRESHOLD_CELLS_PER_THREAD;
+    if (maxThreads < numThreads)
+      {
+      numThreads = (maxThreads > 1 ? static_cast<int>(maxThreads) : 1);
+      }
+    if (numThreads <= 1)
+      {
+      this->Self->EvaluateCells(this->Input, this->Scalars, 0,
+                                this->NumberOfCells, this->Keep);
+      return;
+      }
+    // GetCellPoints() and GetCellType() are thread safe once they have been
+    // called from a single thread.
+    vtkIdList *ptIds = vtkIdList::New();
+    this->Input->GetCellPoints(0, ptIds);
+    this->Input->GetCellType(0);
+    ptIds->Delete();
+
+    vtkMultiThreader *threader = vtkMultiThreader::New();
+    threader->SetNumberOfThreads(numThreads);
+    threader->SetSingleMethod(vtkThresholdCellEvaluator::ThreadedExecute,
+                              this);
+    threader->SingleMethodExecute();
+    threader->Delete();
+    }
+
+  static VTK_THREAD_RETURN_TYPE ThreadedExecute(void *arg)
+    {
+    vtkMultiThreader::ThreadInfo *info =
+      static_cast<vtkMultiThreader::ThreadInfo*>(arg);
+    vtkThresholdCellEvaluator *self =
+      static_cast<vtkThresholdCellEvaluator*>(info->UserData);
+    vtkIdType num = self->NumberOfCells;
+    vtkIdType begin = num * info->ThreadID / info->NumberOfThreads;
+    vtkIdType end = num * (info->ThreadID + 1) / info->NumberOfThreads;
+    self->Self->EvaluateCells(self->Input, self->Scalars, begin, end,
+                              self->Keep);
+    return VTK_THREAD_RETURN_VALUE;
+    }
+};
+
 // Construct with lower threshold=0, upper threshold=1, and threshold 
 // function=upper AllScalars=1.
 vtkThreshold::vtkThreshold()
@@ -103,18 +165,6 @@ int vtkThreshold::RequestData(
   vtkUnstructuredGrid *output = vtkUnstructuredGrid::SafeDownCast(
     outInfo->Get(vtkDataObject::DATA_OBJECT()));
 
-  vtkIdType cellId, newCellId;
-  vtkIdList *cellPts, *pointMap;
-  vtkIdList *newCellPts;
-  vtkCell *cell;
-  vtkPoints *newPoints;
-  int i, ptId, newId, numPts;
-  int numCellPts;
-  double x[3];
-  vtkPointData *pd=input->GetPointData(), *outPD=output->GetPointData();
-  vtkCellData *cd=input->GetCellData(), *outCD=output->GetCellData();
-  int keepCell, usePointScalars;
-
   vtkDebugMacro(<< "Executing threshold filter");
   
   if (this->AttributeMode != -1)
@@ -131,36 +181,47 @@ int vtkThreshold::RequestData(
     return 1;
     }
 
-  outPD->CopyGlobalIdsOn();
-  outPD->CopyAllocate(pd);
-  outCD->CopyGlobalIdsOn();
-  outCD->CopyAllocate(cd);
+  // Check that the scalars of each cell satisfy the threshold criterion
+  vtkIdType numCells = input->GetNumberOfCells();
+  vtkstd::vector<unsigned char> keep(numCells + 1, 0);
 
-  numPts = input->GetNumberOfPoints();
-  output->Allocate(input->GetNumberOfCells());
+  vtkThresholdCellEvaluator evaluator;
+  evaluator.Self = this;
+  evaluator.Input = input;
+  evaluator.Scalars = inScalars;
+  evaluator.Keep = &keep[0];
+  evaluator.NumberOfCells = numCells;
+  evaluator.Execute();
 
-  newPoints = vtkPoints::New();
-  newPoints->SetDataType( this->PointsDataType );
-  newPoints->Allocate(numPts);
+  // Copy the cells which satisfied thresholding
+  vtkExtractCells::ExtractMaskedCells(input, &keep[0], output,
+                                      this->PointsDataType, NULL);
 
-  pointMap = vtkIdList::New(); //maps old point ids into new
-  pointMap->SetNumberOfIds(numPts);
-  for (i=0; i < numPts; i++)
-    {
-    pointMap->SetId(i,-1);
-    }
+  vtkDebugMacro(<< "Extracted " << output->GetNumberOfCells() 
+                << " number of cells.");
+
+  output->Squeeze();
+
+  return 1;
+}
 
-  newCellPts = vtkIdList::New();     
+//----------------------------------------------------------------------------
+void vtkThreshold::EvaluateCells(vtkDataSet *input, vtkDataArray *inScalars,
+                                 vtkIdType beginCell, vtkIdType endCell,
+                                 unsigned char *keep)
+{
+  vtkIdList *cellPts = vtkIdList::New();
+  vtkIdType cellId, ptId;
+  int i, numCellPts, keepCell;
 
   // are we using pointScalars?
-  usePointScalars = (inScalars->GetNumberOfTuples() == numPts);
-  
-  // Check that the scalars of each cell satisfy the threshold criterion
-  for (cellId=0; cellId < input->GetNumberOfCells(); cellId++)
+  int usePointScalars =
+    (inScalars->GetNumberOfTuples() == input->GetNumberOfPoints());
+
+  for (cellId=beginCell; cellId < endCell; cellId++)
     {
-    cell = input->GetCell(cellId);
-    cellPts = cell->GetPointIds();
-    numCellPts = cell->GetNumberOfPoints();
+    input->GetCellPoints(cellId, cellPts);
+    numCellPts = cellPts->GetNumberOfIds();
     
     if ( usePointScalars )
       {
@@ -188,50 +249,12 @@ int vtkThreshold::RequestData(
       keepCell = this->EvaluateComponents( inScalars, cellId );
       }
     
-    if (  numCellPts > 0 && keepCell )
-      {
-      // satisfied thresholding (also non-empty cell, i.e. not VTK_EMPTY_CELL)
-      for (i=0; i < numCellPts; i++)
-        {
-        ptId = cellPts->GetId(i);
-        if ( (newId = pointMap->GetId(ptId)) < 0 )
-          {
-          input->GetPoint(ptId, x);
-          newId = newPoints->InsertNextPoint(x);
-          pointMap->SetId(ptId,newId);
-          outPD->CopyData(pd,ptId,newId);
-          }
-        newCellPts->InsertId(i,newId);
-        }
-      // special handling for polyhedron cells
-      if (vtkUnstructuredGrid::SafeDownCast(input) &&
-          input->GetCellType(cellId) == VTK_POLYHEDRON)
-        {
-        newCellPts->Reset();
-        vtkUnstructuredGrid::SafeDownCast(input)->
-          GetFaceStream(cellId, newCellPts);
-        vtkUnstructuredGrid::ConvertFaceStreamPointIds(
-          newCellPts, pointMap->GetPointer(0));
-        }
-      newCellId = output->InsertNextCell(cell->GetCellType(),newCellPts);
-      outCD->CopyData(cd,cellId,newCellId);
-      newCellPts->Reset();
-      } // satisfied thresholding
-    } // for all cells
-
-  vtkDebugMacro(<< "Extracted " << output->GetNumberOfCells() 
-                << " number of cells.");
-
-  // now clean up / update ourselves
-  pointMap->Delete();
-  newCellPts->Delete();
-  
-  output->SetPoints(newPoints);
-  newPoints->Delete();
-
-  output->Squeeze();
+    // also non-empty cell, i.e. not VTK_EMPTY_CELL
+    keep[cellId] = ( numCellPts > 0 && keepCell &&
+                     input->GetCellType(cellId) != VTK_EMPTY_CELL );
+    }
 
-  return 1;
+  cellPts->Delete();
 }
 
 int vtkThreshold::EvaluateComponents( vtkDataArray *scalars, vtkIdType id )
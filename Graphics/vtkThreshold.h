@@ -27,6 +27,10 @@
 //
 // By default only the first scalar value is used in the decision. Use the ComponentMode
 // and SelectedComponent ivars to control this behavior.
+//
+// The cells are evaluated, and the kept cells and points copied, by several
+// threads on large inputs (see vtkExtractCells::ExtractMaskedCells()). The
+// output points are in the order of the input points.
 
 // .SECTION See Also
 // vtkThresholdPoints vtkThresholdTextureCoords
@@ -161,6 +165,18 @@ protected:
 
   int EvaluateComponents( vtkDataArray *scalars, vtkIdType id );
 
+  // Description:
+  // Set keep[cellId] to 1 for the cells in [beginCell,endCell) which
+  // satisfy the threshold criterion, and to 0 for the others. Several
+  // threads call it at once on disjoint ranges.
+  void EvaluateCells(vtkDataSet *input, vtkDataArray *scalars,
+                     vtkIdType beginCell, vtkIdType endCell,
+                     unsigned char *keep);
+
+  //BTX
+  friend class vtkThresholdCellEvaluator;
+  //ETX
+
 private:
   vtkThreshold(const vtkThreshold&);  // Not implemented.
   void operator=(const vtkThreshold&);  // Not implemented.
@@ -20,6 +20,7 @@
 #include "vtkMath.h"
 #include "vtkInformation.h"
 #include "vtkInformationVector.h"
+#include "vtkMultiThreader.h"
 #include "vtkObjectFactory.h"
 #include "vtkPointData.h"
 #include "vtkPolyData.h"
@@ -63,7 +64,193 @@ typedef struct _vtkMeshVertex
   char      type;
   vtkIdList *edges; // connected edges (list of connected point ids)
 } vtkMeshVertex, *vtkMeshVertexPtr;
-    
+
+// Minimum number of points per thread in the smoothing iterations.
+#define VTK_WINDOWED_SINC_POINTS_PER_THREAD 20000
+
+//----------------------------------------------------------------------------
+// Performs one iteration of the filter. Each point only depends on the
+// positions of the previous iterations, so the points are split among the
+// threads. The connected vertices of point i are Neighbors[Offsets[i]] to
+// Neighbors[Offsets[i+1]-1].
+class vtkWindowedSincPolyDataFilterIteration
+{
+public:
+  vtkMeshVertex *Verts;
+  vtkIdType *Offsets;
+  vtkIdType *Neighbors;
+  vtkIdType NumberOfPoints;
+  vtkPoints *Points[4]; // the newPts of RequestData
+  int Zero, One, Two, Three;
+  double *C; // Chebyshev coefficients
+  int IterationNumber;
+
+  void Execute(int numThreads);
+};
+
+//----------------------------------------------------------------------------
+template <class T>
+void vtkWindowedSincPolyDataFilterIterate(
+  vtkWindowedSincPolyDataFilterIteration *self, T *pts[4],
+  vtkIdType begin, vtkIdType end)
+{
+  T *x0 = pts[self->Zero];
+  T *x1 = pts[self->One];
+  T *x2 = pts[self->Two];
+  T *x3 = pts[self->Three];
+  double *c = self->C;
+  vtkIdType i, j, npts, *neighbors;
+  double deltaX[3];
+  int k;
+
+  for (i=begin; i < end; i++)
+    {
+    npts = self->Offsets[i+1] - self->Offsets[i];
+    neighbors = self->Neighbors + self->Offsets[i];
+    T *p_x0 = x0 + 3*i;
+    T *p_x1 = x1 + 3*i;
+    T *p_x3 = x3 + 3*i;
+
+    if ( self->IterationNumber == 1 )
+      {
+      if ( npts > 0 )
+        {
+        // point is allowed to move
+        deltaX[0] = deltaX[1] = deltaX[2] = 0.0;
+
+        // calculate the negative of the laplacian
+        for (j=0; j<npts; j++) //for all connected points
+          {
+          const T *y = x0 + 3*neighbors[j];
+          for (k=0; k<3; k++)
+            {
+            deltaX[k] += (static_cast<double>(p_x0[k]) - y[k]) / npts;
+            }
+          }
+        // newPts[one] = newPts[zero] - 0.5 newPts[one]
+        for (k=0; k<3; k++)
+          {
+          deltaX[k] = p_x0[k] - 0.5*deltaX[k];
+          p_x1[k] = static_cast<T>(deltaX[k]);
+          }
+
+        // calculate newPts[three] = c0 newPts[zero] + c1 newPts[one]
+        for (k=0; k<3; k++)
+          {
+          p_x3[k] = (self->Verts[i].type == VTK_FIXED_VERTEX ? p_x0[k] :
+                     static_cast<T>(c[0]*p_x0[k] + c[1]*deltaX[k]));
+          }
+        }
+      else
+        {
+        // point is not allowed to move, just use the old point...
+        // (zero out the Laplacian)
+        for (k=0; k<3; k++)
+          {
+          p_x1[k] = 0.0;
+          p_x3[k] = p_x0[k];
+          }
+        }
+      continue;
+      }
+
+    if ( npts > 0 )
+      {
+      // point is allowed to move
+      deltaX[0] = deltaX[1] = deltaX[2] = 0.0;
+
+      // calculate the negative laplacian of x1
+      for (j=0; j<npts; j++)
+        {
+        const T *y = x1 + 3*neighbors[j];
+        for (k=0; k<3; k++)
+          {
+          deltaX[k] += (static_cast<double>(p_x1[k]) - y[k]) / npts;
+          }
+        }
+
+      // Taubin:  x2 = (x1 - x0) + (x1 - x2)
+      for (k=0; k<3; k++)
+        {
+        deltaX[k] = static_cast<double>(p_x1[k]) - p_x0[k] + p_x1[k] -
+          deltaX[k];
+        x2[3*i+k] = static_cast<T>(deltaX[k]);
+        }
+
+      // smooth the vertex (x3 = x3 + cj x2)
+      if ( self->Verts[i].type != VTK_FIXED_VERTEX )
+        {
+        for (k=0; k<3; k++)
+          {
+          p_x3[k] = static_cast<T>(p_x3[k] + c[self->IterationNumber]*deltaX[k]);
+          }
+        }
+      }
+    else
+      {
+      // point is not allowed to move: its Laplacian is zero. x1 was
+      // already zeroed as the x2 of the previous iteration, and is not
+      // written again since other points may be reading it.
+      for (k=0; k<3; k++)
+        {
+        x2[3*i+k] = 0.0;
+        }
+      }
+    }
+}
+
+//----------------------------------------------------------------------------
+static VTK_THREAD_RETURN_TYPE vtkWindowedSincPolyDataFilterThread(void *arg)
+{
+  vtkMultiThreader::ThreadInfo *info =
+    static_cast<vtkMultiThreader::ThreadInfo *>(arg);
+  vtkWindowedSincPolyDataFilterIteration *self =
+    static_cast<vtkWindowedSincPolyDataFilterIteration *>(info->UserData);
+  vtkIdType numPts = self->NumberOfPoints;
+  vtkIdType begin = numPts * info->ThreadID / info->NumberOfThreads;
+  vtkIdType end = numPts * (info->ThreadID + 1) / info->NumberOfThreads;
+  int i;
+
+  if ( self->Points[0]->GetDataType() == VTK_DOUBLE )
+    {
+    double *pts[4];
+    for (i=0; i < 4; i++)
+      {
+      pts[i] = static_cast<double *>(self->Points[i]->GetVoidPointer(0));
+      }
+    vtkWindowedSincPolyDataFilterIterate(self, pts, begin, end);
+    }
+  else
+    {
+    float *pts[4];
+    for (i=0; i < 4; i++)
+      {
+      pts[i] = static_cast<float *>(self->Points[i]->GetVoidPointer(0));
+      }
+    vtkWindowedSincPolyDataFilterIterate(self, pts, begin, end);
+    }
+  return VTK_THREAD_RETURN_VALUE;
+}
+
+//----------------------------------------------------------------------------
+void vtkWindowedSincPolyDataFilterIteration::Execute(int numThreads)
+{
+  if ( numThreads <= 1 )
+    {
+    vtkMultiThreader::ThreadInfo info;
+    info.ThreadID = 0;
+    info.NumberOfThreads = 1;
+    info.UserData = this;
+    vtkWindowedSincPolyDataFilterThread(&info);
+    return;
+    }
+  vtkMultiThreader *threader = vtkMultiThreader::New();
+  threader->SetNumberOfThreads(numThreads);
+  threader->SetSingleMethod(vtkWindowedSincPolyDataFilterThread, this);
+  threader->SingleMethodExecute();
+  threader->Delete();
+}
+
 int vtkWindowedSincPolyDataFilter::RequestData(
   vtkInformation *vtkNotUsed(request),
   vtkInformationVector **inputVector,
@@ -84,7 +271,6 @@ int vtkWindowedSincPolyDataFilter::RequestData(
   vtkIdType npts = 0;
   vtkIdType *pts = 0;
   vtkIdType p1, p2;
-  double x[3], y[3], deltaX[3], xNew[3];
   double x1[3], x2[3], x3[3], l1[3], l2[3];
   double CosFeatureAngle; //Cosine of angle between adjacent polys
   double CosEdgeAngle; // Cosine of angle between adjacent edges
@@ -98,7 +284,7 @@ int vtkWindowedSincPolyDataFilter::RequestData(
   vtkMeshVertexPtr Verts;
 
   // variables specific to windowed sinc interpolation
-  double theta_pb, k_pb, sigma, p_x0[3], p_x1[3], p_x3[3];
+  double theta_pb, k_pb, sigma;
   double *w, *c, *cprime;
   int zero, one, two, three;
   
@@ -428,22 +614,45 @@ int vtkWindowedSincPolyDataFilter::RequestData(
                 << numFEdges << " feature edge vertices\n\t"
                 << numBEdges << " boundary edge vertices\n\t"
                 << numFixed << " fixed vertices\n\t");
+
+  // Pack the lists of connected vertices into a single array, which is
+  // what the smoothing iterations read.
+  vtkIdType *offsets = new vtkIdType[numPts+1];
+  offsets[0] = 0;
+  for (i=0; i<numPts; i++)
+    {
+    offsets[i+1] = offsets[i] +
+      (Verts[i].edges != NULL ? Verts[i].edges->GetNumberOfIds() : 0);
+    }
+  vtkIdType *neighbors = new vtkIdType[offsets[numPts] > 0 ? offsets[numPts] : 1];
+  for (i=0; i<numPts; i++)
+    {
+    if ( Verts[i].edges != NULL )
+      {
+      memcpy(neighbors + offsets[i], Verts[i].edges->GetPointer(0),
+             (offsets[i+1] - offsets[i]) * sizeof(vtkIdType));
+      Verts[i].edges->Delete();
+      Verts[i].edges = NULL;
+      }
+    }
+
 //
 // Perform Windowed Sinc function interpolation
 //
   vtkDebugMacro(<<"Beginning smoothing iterations...");
 
-  // need 4 vectors of points
+  // need 4 vectors of points, in double precision for double input points
   zero=0; one=1; two=2; three=3;
 
-  newPts[0] = vtkPoints::New();
-  newPts[0]->SetNumberOfPoints(numPts);
-  newPts[1] = vtkPoints::New();
-  newPts[1]->SetNumberOfPoints(numPts);
-  newPts[2] = vtkPoints::New();
-  newPts[2]->SetNumberOfPoints(numPts);
-  newPts[3] = vtkPoints::New();
-  newPts[3]->SetNumberOfPoints(numPts);
+  for (j=0; j < 4; j++)
+    {
+    newPts[j] = vtkPoints::New();
+    if ( inPts->GetDataType() == VTK_DOUBLE )
+      {
+      newPts[j]->SetDataTypeToDouble();
+      }
+    newPts[j]->SetNumberOfPoints(numPts);
+    }
 
   // Get the center and length of the input dataset
   double *inCenter = input->GetCenter();
@@ -490,9 +699,6 @@ int vtkWindowedSincPolyDataFilter::RequestData(
   c = new double[this->NumberOfIterations+1];
   cprime = new double[this->NumberOfIterations+1];
 
-  double zerovector[3];
-  zerovector[0] = zerovector[1] = zerovector[2] = 0.0;    
-
   //
   // Calculate the weights and the Chebychev coefficients c.
   //
@@ -578,55 +784,31 @@ int vtkWindowedSincPolyDataFilter::RequestData(
     vtkErrorMacro(<< "An optimal offset for the smoothing filter could not be found.  Unpredictable smoothing/shrinkage may result.");
     }
   
-  // first iteration
-  for (i=0; i<numPts; i++) 
+  vtkWindowedSincPolyDataFilterIteration iteration;
+  iteration.Verts = Verts;
+  iteration.Offsets = offsets;
+  iteration.Neighbors = neighbors;
+  iteration.NumberOfPoints = numPts;
+  iteration.C = c;
+  for (j=0; j < 4; j++)
     {
-    if ( Verts[i].edges != NULL &&
-         (npts = Verts[i].edges->GetNumberOfIds()) > 0 )
-      {
-      // point is allowed to move
-      newPts[zero]->GetPoint(i, x); //use current points
-      deltaX[0] = deltaX[1] = deltaX[2] = 0.0;
-      
-      // calculate the negative of the laplacian
-      for (j=0; j<npts; j++) //for all connected points
-        {
-        newPts[zero]->GetPoint(Verts[i].edges->GetId(j), y);
-        for (k=0; k<3; k++)
-          {
-          deltaX[k] += (x[k] - y[k]) / npts;
-          }
-        }
-      // newPts[one] = newPts[zero] - 0.5 newPts[one]
-      for (k=0; k<3; k++)
-        {
-        deltaX[k] = x[k] - 0.5*deltaX[k];
-        }
-      newPts[one]->SetPoint(i, deltaX);
-      
-      // calculate newPts[three] = c0 newPts[zero] + c1 newPts[one]
-      for (k=0; k < 3; k++)
-        {
-        deltaX[k] = c[0]*x[k] + c[1]*deltaX[k];
-        }
-      if (Verts[i].type == VTK_FIXED_VERTEX)
-        {
-        newPts[three]->SetPoint(i, newPts[zero]->GetPoint(i));
-        }
-      else
-        {
-        newPts[three]->SetPoint(i, deltaX);
-        }
-      }//if can move point
-    else
-      {
-      // point is not allowed to move, just use the old point...
-      // (zero out the Laplacian)
-      newPts[one]->SetPoint(i, zerovector);
-      newPts[three]->SetPoint(i, newPts[zero]->GetPoint(i));
-      }
-    }//for all points
-  
+    iteration.Points[j] = newPts[j];
+    }
+  vtkIdType maxThreads = numPts / VTK_WINDOWED_SINC_POINTS_PER_THREAD;
+  int numThreads = vtkMultiThreader::GetGlobalDefaultNumberOfThreads();
+  if ( maxThreads < numThreads )
+    {
+    numThreads = (maxThreads > 1 ? static_cast<int>(maxThreads) : 1);
+    }
+
+  // first iteration
+  iteration.Zero = zero;
+  iteration.One = one;
+  iteration.Two = two;
+  iteration.Three = three;
+  iteration.IterationNumber = 1;
+  iteration.Execute(numThreads);
+
   // for the rest of the iterations
   for ( iterationNumber=2, abortExecute=0;
         iterationNumber <= this->NumberOfIterations && !abortExecute;
@@ -641,54 +823,12 @@ int vtkWindowedSincPolyDataFilter::RequestData(
         break;
         }
       }
-    
-    for (i=0; i<numPts; i++) 
-      {
-      if ( Verts[i].edges != NULL &&
-           (npts = Verts[i].edges->GetNumberOfIds()) > 0 )
-        {
-        // point is allowed to move
-        newPts[zero]->GetPoint(i, p_x0); //use current points
-        newPts[one]->GetPoint(i, p_x1);
-        
-        deltaX[0] = deltaX[1] = deltaX[2] = 0.0;
-        
-        // calculate the negative laplacian of x1
-        for (j=0; j<npts; j++)
-          {
-          newPts[one]->GetPoint(Verts[i].edges->GetId(j), y);
-          for (k=0; k<3; k++)
-            {
-            deltaX[k] += (p_x1[k] - y[k]) / npts;
-            }
-          }//for all connected points
-        
-        // Taubin:  x2 = (x1 - x0) + (x1 - x2)
-        for (k=0; k<3; k++)
-          {
-          deltaX[k] = p_x1[k] - p_x0[k] + p_x1[k] - deltaX[k];
-          }
-        newPts[two]->SetPoint(i, deltaX);
 
-        // smooth the vertex (x3 = x3 + cj x2)
-        newPts[three]->GetPoint(i, p_x3);
-        for (k=0;k<3;k++) 
-          {
-          xNew[k] = p_x3[k] + c[iterationNumber] * deltaX[k];
-          }
-        if (Verts[i].type != VTK_FIXED_VERTEX)
-          {
-          newPts[three]->SetPoint(i,xNew);
-          }
-        }//if can move point
-      else
-        {
-        // point is not allowed to move, just use the old point...
-        // (zero out the Laplacian)
-        newPts[one]->SetPoint(i, zerovector);
-        newPts[two]->SetPoint(i, zerovector);
-        }
-      }//for all points
+    iteration.Zero = zero;
+    iteration.One = one;
+    iteration.Two = two;
+    iteration.IterationNumber = iterationNumber;
+    iteration.Execute(numThreads);
 
     // update the pointers. three is always three. all other pointers
     // shift by one and wrap.
@@ -708,6 +848,8 @@ int vtkWindowedSincPolyDataFilter::RequestData(
   delete [] w;
   delete [] c;
   delete [] cprime;
+  delete [] offsets;
+  delete [] neighbors;
   
   vtkDebugMacro(<<"Performed " << iterationNumber << " smoothing passes");
   
@@ -783,11 +925,6 @@ int vtkWindowedSincPolyDataFilter::RequestData(
   // finally delete the constructed (local) mesh
   inMesh->Delete();
   
-  //free up connectivity storage
-  for (i=0; i<numPts; i++)
-    {
-    if ( Verts[i].edges != NULL ) {Verts[i].edges->Delete();}
-    }
   delete [] Verts;
 
   return 1;
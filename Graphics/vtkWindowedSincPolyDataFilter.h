@@ -117,6 +117,11 @@
 // vertices, this limits all the frequency modes in a polyhedral mesh to
 // between 0 and 2.)
 //
+// Each smoothing pass only depends on the point positions of the previous
+// passes, so the points of large meshes are smoothed by several threads.
+// Double precision input points are smoothed and output in double
+// precision.
+//
 // There are two instance variables that control the generation of error
 // data. If the ivar GenerateErrorScalars is on, then a scalar value indicating
 // the distance of each vertex from its original position is computed. If the
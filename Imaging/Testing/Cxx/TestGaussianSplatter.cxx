@@ -0,0 +1,169 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestGaussianSplatter.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Splats random points with vtkGaussianSplatter in every accumulation
+// mode, with and without normals, and resamples them and the points of an
+// image with vtkShepardMethod, on four threads and on one.  The random
+// points cluster around a plane, so the slabs of the threads are uneven.
+// Each voxel combines the points in the same order on any number of
+// threads, so the outputs must be identical.
+
+#include "vtkDataArray.h"
+#include "vtkDoubleArray.h"
+#include "vtkGaussianSplatter.h"
+#include "vtkImageData.h"
+#include "vtkMath.h"
+#include "vtkMultiThreader.h"
+#include "vtkPointData.h"
+#include "vtkPoints.h"
+#include "vtkPolyData.h"
+#include "vtkShepardMethod.h"
+#include "vtkSmartPointer.h"
+
+// The number of voxels that differ between the outputs of two algorithms
+static vtkIdType CountDifferences(vtkAlgorithm *algorithm1,
+                                  vtkAlgorithm *algorithm2)
+{
+  vtkDataArray *scalars1 = vtkImageData::SafeDownCast(
+    algorithm1->GetOutputDataObject(0))->GetPointData()->GetScalars();
+  vtkDataArray *scalars2 = vtkImageData::SafeDownCast(
+    algorithm2->GetOutputDataObject(0))->GetPointData()->GetScalars();
+  vtkIdType n = scalars1->GetNumberOfTuples();
+  if (scalars2->GetNumberOfTuples() != n)
+    {
+    return n;
+    }
+  vtkIdType count = 0;
+  for (vtkIdType i = 0; i < n; i++)
+    {
+    count += (scalars1->GetComponent(i, 0) != scalars2->GetComponent(i, 0));
+    }
+  return count;
+}
+
+static vtkGaussianSplatter *NewSplatter(vtkDataSet *input, int threads,
+                                        int mode, int normalWarping)
+{
+  vtkMultiThreader::SetGlobalDefaultNumberOfThreads(threads);
+  vtkGaussianSplatter *splatter = vtkGaussianSplatter::New();
+  splatter->SetInput(input);
+  splatter->SetSampleDimensions(48, 40, 56);
+  splatter->SetRadius(0.08);
+  splatter->SetAccumulationMode(mode);
+  splatter->SetNormalWarping(normalWarping);
+  splatter->CappingOn();
+  splatter->SetCapValue(-1.0);
+  splatter->Update();
+  return splatter;
+}
+
+static int CheckSplatter(vtkDataSet *input, int mode, int normalWarping)
+{
+  vtkGaussianSplatter *threaded =
+    NewSplatter(input, 4, mode, normalWarping);
+  vtkGaussianSplatter *serial =
+    NewSplatter(input, 1, mode, normalWarping);
+  vtkIdType count = CountDifferences(threaded, serial);
+  threaded->Delete();
+  serial->Delete();
+  if (count != 0)
+    {
+    cerr << count << " voxels differ on four threads in accumulation mode "
+         << mode << " with normal warping " << normalWarping << endl;
+    return 0;
+    }
+  return 1;
+}
+
+static vtkShepardMethod *NewShepard(vtkDataSet *input, int threads)
+{
+  vtkMultiThreader::SetGlobalDefaultNumberOfThreads(threads);
+  vtkShepardMethod *shepard = vtkShepardMethod::New();
+  shepard->SetInput(input);
+  shepard->SetSampleDimensions(24, 20, 28);
+  shepard->SetMaximumDistance(0.1);
+  shepard->SetNullValue(-1.0);
+  shepard->Update();
+  return shepard;
+}
+
+static int CheckShepard(vtkDataSet *input)
+{
+  vtkShepardMethod *threaded = NewShepard(input, 4);
+  vtkShepardMethod *serial = NewShepard(input, 1);
+  vtkIdType count = CountDifferences(threaded, serial);
+  threaded->Delete();
+  serial->Delete();
+  if (count != 0)
+    {
+    cerr << count << " voxels differ on four threads with Shepard's method"
+         << endl;
+    return 0;
+    }
+  return 1;
+}
+
+int TestGaussianSplatter(int, char *[])
+{
+  vtkMath::RandomSeed(4242);
+  int defaultThreads = vtkMultiThreader::GetGlobalDefaultNumberOfThreads();
+
+  vtkSmartPointer<vtkPoints> points = vtkSmartPointer<vtkPoints>::New();
+  vtkSmartPointer<vtkDoubleArray> scalars =
+    vtkSmartPointer<vtkDoubleArray>::New();
+  vtkSmartPointer<vtkDoubleArray> normals =
+    vtkSmartPointer<vtkDoubleArray>::New();
+  normals->SetNumberOfComponents(3);
+  for (int i = 0; i < 4000; i++)
+    {
+    points->InsertNextPoint(vtkMath::Random(-1.0, 1.0),
+                            vtkMath::Random(-1.0, 1.0),
+                            vtkMath::Gaussian(0.0, 0.3));
+    scalars->InsertNextValue(vtkMath::Random(0.0, 2.0));
+    normals->InsertNextTuple3(vtkMath::Random(-1.0, 1.0),
+                              vtkMath::Random(-1.0, 1.0),
+                              vtkMath::Random(-1.0, 1.0));
+    }
+  vtkSmartPointer<vtkPolyData> polyData = vtkSmartPointer<vtkPolyData>::New();
+  polyData->SetPoints(points);
+  polyData->GetPointData()->SetScalars(scalars);
+  polyData->GetPointData()->SetNormals(normals);
+
+  // An image is not a vtkPointSet, so its points are read from a copy.
+  // The filters pass their update extent on to their input, so the image
+  // is as large as the output.
+  vtkSmartPointer<vtkImageData> image = vtkSmartPointer<vtkImageData>::New();
+  image->SetDimensions(24, 20, 28);
+  image->SetSpacing(0.04, 0.06, 0.02);
+  image->SetScalarTypeToDouble();
+  image->AllocateScalars();
+  vtkDataArray *imageScalars = image->GetPointData()->GetScalars();
+  for (vtkIdType i = 0; i < imageScalars->GetNumberOfTuples(); i++)
+    {
+    imageScalars->SetComponent(i, 0, vtkMath::Random(0.0, 2.0));
+    }
+
+  int status = 1;
+  for (int mode = VTK_ACCUMULATION_MODE_MIN;
+       mode <= VTK_ACCUMULATION_MODE_SUM; mode++)
+    {
+    status &= CheckSplatter(polyData, mode, 0);
+    status &= CheckSplatter(polyData, mode, 1);
+    }
+  status &= CheckShepard(polyData);
+  status &= CheckShepard(image);
+  vtkMultiThreader::SetGlobalDefaultNumberOfThreads(defaultThreads);
+
+  return status ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,212 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestImageAccumulate.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Computes the joint histogram of a random 3-component image with
+// vtkImageAccumulate on several threads, as an image and as a table of
+// sparse bins, in one piece and in streamed pieces, and checks the counts
+// and the statistics against a direct count.
+
+#include "vtkDataArray.h"
+#include "vtkIdTypeArray.h"
+#include "vtkImageAccumulate.h"
+#include "vtkImageData.h"
+#include "vtkIntArray.h"
+#include "vtkMath.h"
+#include "vtkMultiThreader.h"
+#include "vtkPointData.h"
+#include "vtkSmartPointer.h"
+#include "vtkTable.h"
+
+#include <vtkstd/map>
+#include <math.h>
+
+typedef vtkstd::map<vtkIdType, vtkIdType> BinMap;
+
+// The histogram and the statistics computed directly.
+struct Reference
+{
+  BinMap Dense;
+  BinMap Sparse;
+  double Min[3];
+  double Max[3];
+  double Mean[3];
+  double StandardDeviation[3];
+};
+
+static void ComputeReference(vtkImageData *image, Reference *ref)
+{
+  vtkDataArray *scalars = image->GetPointData()->GetScalars();
+  vtkIdType n = scalars->GetNumberOfTuples();
+  double sum[3] = { 0.0, 0.0, 0.0 };
+  double sumSqr[3] = { 0.0, 0.0, 0.0 };
+  for (int c = 0; c < 3; c++)
+    {
+    ref->Min[c] = VTK_DOUBLE_MAX;
+    ref->Max[c] = VTK_DOUBLE_MIN;
+    }
+  for (vtkIdType i = 0; i < n; i++)
+    {
+    vtkIdType denseBin = 0;
+    vtkIdType sparseBin = 0;
+    for (int c = 2; c >= 0; c--)
+      {
+      double v = scalars->GetComponent(i, c);
+      sum[c] += v;
+      sumSqr[c] += v*v;
+      ref->Min[c] = (v < ref->Min[c] ? v : ref->Min[c]);
+      ref->Max[c] = (v > ref->Max[c] ? v : ref->Max[c]);
+      denseBin = denseBin*16 + static_cast<vtkIdType>(v)/4096;
+      sparseBin = sparseBin*65536 + static_cast<vtkIdType>(v);
+      }
+    ref->Dense[denseBin]++;
+    ref->Sparse[sparseBin]++;
+    }
+  // the filter counts every component of every voxel
+  double count = 3.0*n;
+  for (int c = 0; c < 3; c++)
+    {
+    ref->Mean[c] = sum[c]/count;
+    ref->StandardDeviation[c] =
+      sqrt((sumSqr[c] - ref->Mean[c]*ref->Mean[c]*count)/(count - 1));
+    }
+}
+
+static int CheckStatistics(vtkImageAccumulate *accumulate, vtkIdType n,
+                           Reference *ref)
+{
+  if (accumulate->GetVoxelCount() != 3*n)
+    {
+    cerr << "VoxelCount is " << accumulate->GetVoxelCount()
+         << " instead of " << 3*n << endl;
+    return 0;
+    }
+  for (int c = 0; c < 3; c++)
+    {
+    if (accumulate->GetMin()[c] != ref->Min[c] ||
+        accumulate->GetMax()[c] != ref->Max[c] ||
+        fabs(accumulate->GetMean()[c] - ref->Mean[c]) > 1e-6 ||
+        fabs(accumulate->GetStandardDeviation()[c] -
+             ref->StandardDeviation[c]) > 1e-6)
+      {
+      cerr << "Wrong statistics for component " << c << endl;
+      return 0;
+      }
+    }
+  return 1;
+}
+
+static int CheckDense(vtkImageData *image, int divisions, Reference *ref)
+{
+  vtkSmartPointer<vtkImageAccumulate> accumulate =
+    vtkSmartPointer<vtkImageAccumulate>::New();
+  accumulate->SetInput(image);
+  accumulate->SetComponentExtent(0, 15, 0, 15, 0, 15);
+  accumulate->SetComponentSpacing(4096, 4096, 4096);
+  accumulate->SetNumberOfStreamDivisions(divisions);
+  accumulate->Update();
+
+  vtkImageData *output = accumulate->GetOutput();
+  int *counts = static_cast<int *>(output->GetScalarPointer());
+  for (vtkIdType bin = 0; bin < 16*16*16; bin++)
+    {
+    BinMap::iterator iter = ref->Dense.find(bin);
+    vtkIdType expected = (iter == ref->Dense.end() ? 0 : iter->second);
+    if (counts[bin] != expected)
+      {
+      cerr << "Bin " << bin << " counts " << counts[bin] << " instead of "
+           << expected << " with " << divisions << " divisions" << endl;
+      return 0;
+      }
+    }
+  return CheckStatistics(accumulate, image->GetNumberOfPoints(), ref);
+}
+
+static int CheckSparse(vtkImageData *image, int divisions, Reference *ref)
+{
+  vtkSmartPointer<vtkImageAccumulate> accumulate =
+    vtkSmartPointer<vtkImageAccumulate>::New();
+  accumulate->SetInput(image);
+  accumulate->SetComponentExtent(0, 65535, 0, 65535, 0, 65535);
+  accumulate->SparseOutputOn();
+  accumulate->SetNumberOfStreamDivisions(divisions);
+  accumulate->Update();
+
+  if (accumulate->GetOutput()->GetNumberOfPoints() != 0)
+    {
+    cerr << "The output image is not empty" << endl;
+    return 0;
+    }
+  vtkTable *table = accumulate->GetSparseHistogram();
+  vtkIntArray *bins[3];
+  bins[0] = vtkIntArray::SafeDownCast(table->GetColumnByName("Bin0"));
+  bins[1] = vtkIntArray::SafeDownCast(table->GetColumnByName("Bin1"));
+  bins[2] = vtkIntArray::SafeDownCast(table->GetColumnByName("Bin2"));
+  vtkIdTypeArray *counts =
+    vtkIdTypeArray::SafeDownCast(table->GetColumnByName("Count"));
+  if (!bins[0] || !bins[1] || !bins[2] || !counts ||
+      table->GetNumberOfRows() != static_cast<vtkIdType>(ref->Sparse.size()))
+    {
+    cerr << "The table has " << table->GetNumberOfRows() << " rows instead of "
+         << ref->Sparse.size() << endl;
+    return 0;
+    }
+  BinMap::iterator iter = ref->Sparse.begin();
+  for (vtkIdType row = 0; row < table->GetNumberOfRows(); row++, ++iter)
+    {
+    vtkIdType bin = bins[0]->GetValue(row) + 65536*(bins[1]->GetValue(row) +
+      static_cast<vtkIdType>(65536)*bins[2]->GetValue(row));
+    if (bin != iter->first || counts->GetValue(row) != iter->second)
+      {
+      cerr << "Row " << row << " has bin " << bin << " with count "
+           << counts->GetValue(row) << " instead of bin " << iter->first
+           << " with count " << iter->second << endl;
+      return 0;
+      }
+    }
+  return CheckStatistics(accumulate, image->GetNumberOfPoints(), ref);
+}
+
+int TestImageAccumulate(int, char *[])
+{
+  vtkMath::RandomSeed(3131);
+  int defaultThreads = vtkMultiThreader::GetGlobalDefaultNumberOfThreads();
+  vtkMultiThreader::SetGlobalDefaultNumberOfThreads(4);
+
+  // A few repeated colors give bins with counts above one
+  vtkSmartPointer<vtkImageData> image = vtkSmartPointer<vtkImageData>::New();
+  image->SetDimensions(80, 70, 40);
+  image->SetScalarTypeToUnsignedShort();
+  image->SetNumberOfScalarComponents(3);
+  image->AllocateScalars();
+  vtkDataArray *scalars = image->GetPointData()->GetScalars();
+  for (vtkIdType i = 0; i < scalars->GetNumberOfTuples(); i++)
+    {
+    int repeated = (vtkMath::Random() < 0.1);
+    for (int c = 0; c < 3; c++)
+      {
+      scalars->SetComponent(i, c, (repeated ? 1000*c + 7 :
+                                   vtkMath::Floor(vtkMath::Random(0, 65536))));
+      }
+    }
+
+  Reference ref;
+  ComputeReference(image, &ref);
+  int status = CheckDense(image, 1, &ref) &&
+    CheckDense(image, 5, &ref) &&
+    CheckSparse(image, 1, &ref) &&
+    CheckSparse(image, 3, &ref);
+  vtkMultiThreader::SetGlobalDefaultNumberOfThreads(defaultThreads);
+
+  return status ? EXIT_SUCCESS : EXIT_FAILURE;
+}
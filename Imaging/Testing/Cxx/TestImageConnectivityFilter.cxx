@@ -0,0 +1,367 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestImageConnectivityFilter.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Labels the regions of a random mask with vtkImageConnectivityFilter for
+// each connectivity and extraction mode, on one and on several threads,
+// and checks the labels and the statistics against a breadth first search.
+// Also checks vtkImageSeedConnectivity against the same search.
+
+#include "vtkDoubleArray.h"
+#include "vtkIdTypeArray.h"
+#include "vtkImageConnectivityFilter.h"
+#include "vtkImageData.h"
+#include "vtkImageSeedConnectivity.h"
+#include "vtkIntArray.h"
+#include "vtkMath.h"
+#include "vtkMultiThreader.h"
+#include "vtkSmartPointer.h"
+
+#include <vtkstd/vector>
+#include <math.h>
+
+// Label the regions in the order of their first voxel, starting at zero.
+static vtkIdType FloodFill(vtkImageData *mask, int connectivity,
+                           vtkstd::vector<vtkIdType> &regions)
+{
+  int dims[3];
+  mask->GetDimensions(dims);
+  unsigned char *ptr = static_cast<unsigned char *>(mask->GetScalarPointer());
+  vtkIdType n = static_cast<vtkIdType>(dims[0])*dims[1]*dims[2];
+  regions.assign(n, -1);
+  vtkIdType numRegions = 0;
+  vtkstd::vector<vtkIdType> stack;
+  for (vtkIdType start = 0; start < n; start++)
+    {
+    if (ptr[start] == 0 || regions[start] >= 0)
+      {
+      continue;
+      }
+    regions[start] = numRegions;
+    stack.push_back(start);
+    while (!stack.empty())
+      {
+      vtkIdType v = stack.back();
+      stack.pop_back();
+      int x = static_cast<int>(v % dims[0]);
+      int y = static_cast<int>((v / dims[0]) % dims[1]);
+      int z = static_cast<int>(v / (dims[0]*dims[1]));
+      for (int k = -1; k <= 1; k++)
+        {
+        for (int j = -1; j <= 1; j++)
+          {
+          for (int i = -1; i <= 1; i++)
+            {
+            int d = (i != 0) + (j != 0) + (k != 0);
+            if (d == 0 || (connectivity == 6 && d > 1) ||
+                (connectivity == 18 && d > 2) ||
+                x + i < 0 || x + i >= dims[0] || y + j < 0 ||
+                y + j >= dims[1] || z + k < 0 || z + k >= dims[2])
+              {
+              continue;
+              }
+            vtkIdType u = v + i + dims[0]*(j + dims[1]*k);
+            if (ptr[u] != 0 && regions[u] < 0)
+              {
+              regions[u] = numRegions;
+              stack.push_back(u);
+              }
+            }
+          }
+        }
+      }
+    numRegions++;
+    }
+  return numRegions;
+}
+
+// Check that the labels split the mask like the flood fill, and that the
+// statistics describe the labels.
+static int CheckAllRegions(vtkImageConnectivityFilter *filter,
+                           vtkImageData *mask,
+                           const vtkstd::vector<vtkIdType> &regions,
+                           vtkIdType numRegions)
+{
+  vtkImageData *output = filter->GetOutput();
+  int *labels = static_cast<int *>(output->GetScalarPointer());
+  if (filter->GetNumberOfExtractedRegions() != numRegions)
+    {
+    cerr << "Connectivity " << filter->GetConnectivity() << " gives "
+         << filter->GetNumberOfExtractedRegions() << " regions instead of "
+         << numRegions << endl;
+    return 0;
+    }
+
+  int dims[3];
+  mask->GetDimensions(dims);
+  double *origin = mask->GetOrigin();
+  double *spacing = mask->GetSpacing();
+  vtkstd::vector<vtkIdType> labelOfRegion(numRegions, -1);
+  vtkstd::vector<vtkIdType> sizes(numRegions + 1, 0);
+  vtkstd::vector<double> sums(3*(numRegions + 1), 0.0);
+  vtkstd::vector<int> extents(6*(numRegions + 1));
+  for (vtkIdType r = 0; r <= numRegions; r++)
+    {
+    for (int axis = 0; axis < 3; axis++)
+      {
+      extents[6*r + 2*axis] = VTK_INT_MAX;
+      extents[6*r + 2*axis + 1] = VTK_INT_MIN;
+      }
+    }
+  vtkIdType v = 0;
+  int idx[3];
+  for (idx[2] = 0; idx[2] < dims[2]; idx[2]++)
+    {
+    for (idx[1] = 0; idx[1] < dims[1]; idx[1]++)
+      {
+      for (idx[0] = 0; idx[0] < dims[0]; idx[0]++, v++)
+        {
+        vtkIdType label = labels[v];
+        vtkIdType region = regions[v];
+        if ((region < 0) != (label == 0) || label < 0 || label > numRegions ||
+            (region >= 0 && labelOfRegion[region] >= 0 &&
+             labelOfRegion[region] != label))
+          {
+          cerr << "Connectivity " << filter->GetConnectivity()
+               << " gives label " << label << " at voxel " << v << endl;
+          return 0;
+          }
+        if (region >= 0)
+          {
+          labelOfRegion[region] = label;
+          }
+        sizes[label]++;
+        for (int axis = 0; axis < 3; axis++)
+          {
+          sums[3*label + axis] += idx[axis];
+          if (idx[axis] < extents[6*label + 2*axis])
+            {
+            extents[6*label + 2*axis] = idx[axis];
+            }
+          if (idx[axis] > extents[6*label + 2*axis + 1])
+            {
+            extents[6*label + 2*axis + 1] = idx[axis];
+            }
+          }
+        }
+      }
+    }
+
+  for (vtkIdType label = 1; label <= numRegions; label++)
+    {
+    vtkIdType size = filter->GetExtractedRegionSizes()->GetValue(label - 1);
+    if (size != sizes[label] ||
+        (label > 1 && size > sizes[label - 1]))
+      {
+      cerr << "Region " << label << " has a size of " << size
+           << " instead of " << sizes[label] << endl;
+      return 0;
+      }
+    for (int c = 0; c < 6; c++)
+      {
+      if (filter->GetExtractedRegionExtents()->GetComponent(label - 1, c) !=
+          extents[6*label + c])
+        {
+        cerr << "Wrong extent for region " << label << endl;
+        return 0;
+        }
+      }
+    for (int axis = 0; axis < 3; axis++)
+      {
+      double centroid = origin[axis] +
+        spacing[axis]*sums[3*label + axis]/sizes[label];
+      if (fabs(filter->GetExtractedRegionCentroids()->GetComponent(
+                 label - 1, axis) - centroid) > 1e-9)
+        {
+        cerr << "Wrong centroid for region " << label << endl;
+        return 0;
+        }
+      }
+    }
+  return 1;
+}
+
+// Check that the output holds the labels of the regions kept by the
+// filter, with the same numbering as when all regions are kept.
+static int CheckKept(vtkImageData *output, vtkImageData *all,
+                     const vtkstd::vector<int> &keep, const char *mode)
+{
+  int *labels = static_cast<int *>(output->GetScalarPointer());
+  int *allLabels = static_cast<int *>(all->GetScalarPointer());
+  vtkIdType n = output->GetNumberOfPoints();
+  for (vtkIdType v = 0; v < n; v++)
+    {
+    int expected = (keep[allLabels[v]] ? allLabels[v] : 0);
+    if (labels[v] != expected)
+      {
+      cerr << mode << " gives label " << labels[v] << " instead of "
+           << expected << " at voxel " << v << endl;
+      return 0;
+      }
+    }
+  return 1;
+}
+
+static int CheckConnectivity(vtkImageData *mask, int connectivity)
+{
+  vtkstd::vector<vtkIdType> regions;
+  vtkIdType numRegions = FloodFill(mask, connectivity, regions);
+
+  // All the regions, on one and on several threads
+  vtkSmartPointer<vtkImageConnectivityFilter> filter =
+    vtkSmartPointer<vtkImageConnectivityFilter>::New();
+  filter->SetInput(mask);
+  filter->SetConnectivity(connectivity);
+  vtkMultiThreader::SetGlobalDefaultNumberOfThreads(1);
+  filter->Update();
+  vtkSmartPointer<vtkImageData> serial = vtkSmartPointer<vtkImageData>::New();
+  serial->DeepCopy(filter->GetOutput());
+  if (!CheckAllRegions(filter, mask, regions, numRegions))
+    {
+    return 0;
+    }
+  vtkMultiThreader::SetGlobalDefaultNumberOfThreads(4);
+  filter->Modified();
+  filter->Update();
+  if (!CheckAllRegions(filter, mask, regions, numRegions))
+    {
+    return 0;
+    }
+  vtkSmartPointer<vtkImageData> all = vtkSmartPointer<vtkImageData>::New();
+  all->DeepCopy(filter->GetOutput());
+  vtkstd::vector<int> keep(numRegions + 1, 0);
+  if (!CheckKept(serial, all, vtkstd::vector<int>(numRegions + 1, 1),
+                 "Threads"))
+    {
+    return 0;
+    }
+
+  // The largest regions
+  filter->SetExtractionModeToLargestRegions();
+  filter->SetNumberOfLargestRegions(3);
+  filter->Update();
+  keep[1] = keep[2] = keep[3] = 1;
+  if (!CheckKept(filter->GetOutput(), all, keep, "LargestRegions"))
+    {
+    return 0;
+    }
+
+  // The regions of at least 5 voxels, which come first
+  filter->SetExtractionModeToAllRegions();
+  filter->SetMinimumRegionSize(5);
+  filter->Update();
+  vtkstd::vector<vtkIdType> sizes(numRegions, 0);
+  for (vtkIdType v = 0; v < all->GetNumberOfPoints(); v++)
+    {
+    if (regions[v] >= 0)
+      {
+      sizes[regions[v]]++;
+      }
+    }
+  vtkIdType numLarge = 0;
+  for (vtkIdType r = 0; r < numRegions; r++)
+    {
+    numLarge += (sizes[r] >= 5);
+    }
+  for (vtkIdType label = 1; label <= numRegions; label++)
+    {
+    keep[label] = (label <= numLarge);
+    }
+  if (filter->GetNumberOfExtractedRegions() != numLarge ||
+      !CheckKept(filter->GetOutput(), all, keep, "MinimumRegionSize"))
+    {
+    return 0;
+    }
+
+  // The regions of two seeds, one of them on the background
+  int *allLabels = static_cast<int *>(all->GetScalarPointer());
+  int seedLabel = 0;
+  int dims[3];
+  mask->GetDimensions(dims);
+  vtkIdType seed = dims[0]*(dims[1]*(dims[2]/2) + dims[1]/2) + dims[0]/2;
+  while (allLabels[seed] == 0)
+    {
+    seed++;
+    }
+  seedLabel = allLabels[seed];
+  filter->SetMinimumRegionSize(1);
+  filter->SetExtractionModeToSeededRegions();
+  filter->AddSeed(static_cast<int>(seed % dims[0]),
+                  static_cast<int>((seed / dims[0]) % dims[1]),
+                  static_cast<int>(seed / (dims[0]*dims[1])));
+  filter->AddSeed(-1, 2, 3);
+  filter->Update();
+  int *labels = static_cast<int *>(filter->GetOutput()->GetScalarPointer());
+  for (vtkIdType v = 0; v < all->GetNumberOfPoints(); v++)
+    {
+    if ((labels[v] != 0) != (allLabels[v] == seedLabel))
+      {
+      cerr << "SeededRegions gives label " << labels[v] << " at voxel "
+           << v << endl;
+      return 0;
+      }
+    }
+
+  // The same seed with vtkImageSeedConnectivity
+  if (connectivity == 6)
+    {
+    vtkSmartPointer<vtkImageSeedConnectivity> seedConnectivity =
+      vtkSmartPointer<vtkImageSeedConnectivity>::New();
+    seedConnectivity->SetInput(mask);
+    seedConnectivity->SetInputConnectValue(1);
+    seedConnectivity->SetOutputConnectedValue(255);
+    seedConnectivity->SetOutputUnconnectedValue(0);
+    seedConnectivity->AddSeed(static_cast<int>(seed % dims[0]),
+                              static_cast<int>((seed / dims[0]) % dims[1]),
+                              static_cast<int>(seed / (dims[0]*dims[1])));
+    seedConnectivity->Update();
+    unsigned char *marks = static_cast<unsigned char *>(
+      seedConnectivity->GetOutput()->GetScalarPointer());
+    for (vtkIdType v = 0; v < all->GetNumberOfPoints(); v++)
+      {
+      if ((marks[v] != 0) != (allLabels[v] == seedLabel))
+        {
+        cerr << "vtkImageSeedConnectivity gives " << int(marks[v])
+             << " at voxel " << v << endl;
+        return 0;
+        }
+      }
+    }
+
+  return 1;
+}
+
+int TestImageConnectivityFilter(int, char *[])
+{
+  vtkMath::RandomSeed(5417);
+  int defaultThreads = vtkMultiThreader::GetGlobalDefaultNumberOfThreads();
+
+  vtkSmartPointer<vtkImageData> mask = vtkSmartPointer<vtkImageData>::New();
+  mask->SetDimensions(96, 64, 48);
+  mask->SetOrigin(-2.0, 1.0, 0.5);
+  mask->SetSpacing(0.5, 1.0, 1.5);
+  mask->SetScalarTypeToUnsignedChar();
+  mask->AllocateScalars();
+  unsigned char *ptr = static_cast<unsigned char *>(mask->GetScalarPointer());
+  for (vtkIdType i = 0; i < mask->GetNumberOfPoints(); i++)
+    {
+    ptr[i] = (vtkMath::Random() < 0.3 ? 1 : 0);
+    }
+
+  int status = CheckConnectivity(mask, 6) &&
+    CheckConnectivity(mask, 18) &&
+    CheckConnectivity(mask, 26);
+  vtkMultiThreader::SetGlobalDefaultNumberOfThreads(defaultThreads);
+
+  return status ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,219 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestImageEuclideanDistance.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Computes the distance maps of random masks with each algorithm of
+// vtkImageEuclideanDistance, with squared, true and signed distances, and
+// checks every voxel against a brute force search of the nearest voxels.
+// A larger mask checks that the threads give the same result as a single
+// thread.
+
+#include "vtkDataArray.h"
+#include "vtkImageData.h"
+#include "vtkImageEuclideanDistance.h"
+#include "vtkMath.h"
+#include "vtkMultiThreader.h"
+#include "vtkPointData.h"
+#include "vtkSmartPointer.h"
+
+#include <vtkstd/vector>
+#include <math.h>
+
+// The squared distances from each voxel to the nearest zero voxel and to
+// the nearest voxel of the mask.
+static void BruteForce(vtkImageData *mask, vtkstd::vector<double> &toZero,
+                       vtkstd::vector<double> &toMask)
+{
+  int dims[3];
+  mask->GetDimensions(dims);
+  double spacing[3];
+  mask->GetSpacing(spacing);
+  unsigned char *ptr = static_cast<unsigned char *>(mask->GetScalarPointer());
+  vtkIdType n = static_cast<vtkIdType>(dims[0])*dims[1]*dims[2];
+  toZero.assign(n, VTK_INT_MAX);
+  toMask.assign(n, VTK_INT_MAX);
+  vtkIdType i = 0;
+  for (int z = 0; z < dims[2]; z++)
+    {
+    for (int y = 0; y < dims[1]; y++)
+      {
+      for (int x = 0; x < dims[0]; x++, i++)
+        {
+        vtkIdType j = 0;
+        for (int k = 0; k < dims[2]; k++)
+          {
+          for (int jj = 0; jj < dims[1]; jj++)
+            {
+            for (int ii = 0; ii < dims[0]; ii++, j++)
+              {
+              double d0 = (ii - x)*spacing[0];
+              double d1 = (jj - y)*spacing[1];
+              double d2 = (k - z)*spacing[2];
+              double d = d0*d0 + d1*d1 + d2*d2;
+              vtkstd::vector<double> &best = (ptr[j] ? toMask : toZero);
+              best[i] = (d < best[i] ? d : best[i]);
+              }
+            }
+          }
+        }
+      }
+    }
+}
+
+static vtkSmartPointer<vtkImageData> ComputeDistance(
+  vtkImageData *mask, int algorithm, int scalarType, int squared,
+  int signedDistance)
+{
+  vtkSmartPointer<vtkImageEuclideanDistance> edt =
+    vtkSmartPointer<vtkImageEuclideanDistance>::New();
+  edt->SetInput(mask);
+  edt->SetAlgorithm(algorithm);
+  edt->SetOutputScalarType(scalarType);
+  edt->SetSquaredDistance(squared);
+  edt->SetSignedDistance(signedDistance);
+  edt->Update();
+  vtkSmartPointer<vtkImageData> output = vtkSmartPointer<vtkImageData>::New();
+  output->ShallowCopy(edt->GetOutput());
+  return output;
+}
+
+static int CheckDistance(vtkImageData *mask, int algorithm, int scalarType,
+                         int squared, int signedDistance,
+                         const vtkstd::vector<double> &toZero,
+                         const vtkstd::vector<double> &toMask)
+{
+  vtkSmartPointer<vtkImageData> output =
+    ComputeDistance(mask, algorithm, scalarType, squared, signedDistance);
+  if (output->GetScalarType() != scalarType ||
+      output->GetNumberOfScalarComponents() != 1)
+    {
+    cerr << "Wrong output type " << output->GetScalarTypeAsString()
+         << " with " << output->GetNumberOfScalarComponents()
+         << " components" << endl;
+    return 0;
+    }
+
+  vtkDataArray *in = mask->GetPointData()->GetScalars();
+  vtkDataArray *out = output->GetPointData()->GetScalars();
+  double tol = (scalarType == VTK_FLOAT ? 1e-5 : 1e-12);
+  for (vtkIdType i = 0; i < in->GetNumberOfTuples(); i++)
+    {
+    // The zero voxels are at distance zero, unless the distance is signed.
+    int inMask = (in->GetComponent(i, 0) != 0);
+    double expected = (inMask ? toZero[i] : toMask[i]);
+    if (!inMask && !signedDistance)
+      {
+      expected = 0;
+      }
+    if (!squared)
+      {
+      expected = sqrt(expected);
+      }
+    if (signedDistance && inMask)
+      {
+      expected = -expected;
+      }
+    double value = out->GetComponent(i, 0);
+    if (fabs(value - expected) > tol*(1.0 + fabs(expected)))
+      {
+      cerr << "Algorithm " << algorithm << " with "
+           << (squared ? "squared " : "") << (signedDistance ? "signed " : "")
+           << "distances gives " << value << " instead of " << expected
+           << " at voxel " << i << endl;
+      return 0;
+      }
+    }
+  return 1;
+}
+
+// Compare the result of several threads with the result of one thread.
+static int CheckThreads(vtkImageData *mask, int algorithm, int signedDistance)
+{
+  vtkMultiThreader::SetGlobalDefaultNumberOfThreads(1);
+  vtkSmartPointer<vtkImageData> serial =
+    ComputeDistance(mask, algorithm, VTK_DOUBLE, 1, signedDistance);
+  vtkMultiThreader::SetGlobalDefaultNumberOfThreads(4);
+  vtkSmartPointer<vtkImageData> threaded =
+    ComputeDistance(mask, algorithm, VTK_DOUBLE, 1, signedDistance);
+  vtkDataArray *a = serial->GetPointData()->GetScalars();
+  vtkDataArray *b = threaded->GetPointData()->GetScalars();
+  for (vtkIdType i = 0; i < a->GetNumberOfTuples(); i++)
+    {
+    if (a->GetComponent(i, 0) != b->GetComponent(i, 0))
+      {
+      cerr << "Algorithm " << algorithm << " gives " << b->GetComponent(i, 0)
+           << " instead of " << a->GetComponent(i, 0) << " at voxel " << i
+           << " with several threads" << endl;
+      return 0;
+      }
+    }
+  return 1;
+}
+
+static vtkSmartPointer<vtkImageData> MakeMask(const int dims[3],
+                                              const double spacing[3],
+                                              double fraction)
+{
+  vtkSmartPointer<vtkImageData> mask = vtkSmartPointer<vtkImageData>::New();
+  mask->SetDimensions(dims[0], dims[1], dims[2]);
+  mask->SetSpacing(spacing[0], spacing[1], spacing[2]);
+  mask->SetScalarTypeToUnsignedChar();
+  mask->SetNumberOfScalarComponents(1);
+  mask->AllocateScalars();
+  vtkDataArray *scalars = mask->GetPointData()->GetScalars();
+  for (vtkIdType i = 0; i < scalars->GetNumberOfTuples(); i++)
+    {
+    scalars->SetComponent(i, 0, vtkMath::Random() < fraction ? 0 : 1);
+    }
+  return mask;
+}
+
+int TestImageEuclideanDistance(int, char *[])
+{
+  vtkMath::RandomSeed(9321);
+  int defaultThreads = vtkMultiThreader::GetGlobalDefaultNumberOfThreads();
+  vtkMultiThreader::SetGlobalDefaultNumberOfThreads(4);
+
+  int dims[2][3] = { { 31, 23, 17 }, { 20, 1, 35 } };
+  double spacings[2][3] = { { 1.0, 1.0, 1.0 }, { 0.7, 1.3, 2.1 } };
+  int status = 1;
+  for (int s = 0; s < 2 && status; s++)
+    {
+    vtkSmartPointer<vtkImageData> mask = MakeMask(dims[s], spacings[s], 0.01);
+    vtkstd::vector<double> toZero, toMask;
+    BruteForce(mask, toZero, toMask);
+    status =
+      CheckDistance(mask, VTK_EDT_SAITO, VTK_DOUBLE, 1, 0, toZero, toMask) &&
+      CheckDistance(mask, VTK_EDT_SAITO_CACHED, VTK_DOUBLE, 0, 0,
+                    toZero, toMask) &&
+      CheckDistance(mask, VTK_EDT_FELZENSZWALB, VTK_DOUBLE, 1, 0,
+                    toZero, toMask) &&
+      CheckDistance(mask, VTK_EDT_FELZENSZWALB, VTK_FLOAT, 0, 0,
+                    toZero, toMask) &&
+      CheckDistance(mask, VTK_EDT_FELZENSZWALB, VTK_DOUBLE, 1, 1,
+                    toZero, toMask) &&
+      CheckDistance(mask, VTK_EDT_FELZENSZWALB, VTK_FLOAT, 0, 1,
+                    toZero, toMask);
+    }
+
+  int largeDims[3] = { 80, 64, 40 };
+  vtkSmartPointer<vtkImageData> largeMask =
+    MakeMask(largeDims, spacings[1], 0.001);
+  status = status &&
+    CheckThreads(largeMask, VTK_EDT_SAITO, 0) &&
+    CheckThreads(largeMask, VTK_EDT_FELZENSZWALB, 0) &&
+    CheckThreads(largeMask, VTK_EDT_FELZENSZWALB, 1);
+  vtkMultiThreader::SetGlobalDefaultNumberOfThreads(defaultThreads);
+
+  return status ? EXIT_SUCCESS : EXIT_FAILURE;
+}
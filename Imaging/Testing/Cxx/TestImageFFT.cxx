@@ -0,0 +1,195 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestImageFFT.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Transforms a real and a complex noise image, with power of two, smooth
+// and prime dimensions, with the fast and the legacy transforms, checks them
+// against a direct discrete Fourier transform, and checks that vtkImageRFFT
+// gives the images back. The fast transform is also asked for a part of the
+// output, which it does not compute in place.
+
+#include "vtkImageData.h"
+#include "vtkImageFFT.h"
+#include "vtkImageRFFT.h"
+#include "vtkMath.h"
+#include "vtkMultiThreader.h"
+#include "vtkPointData.h"
+#include "vtkSmartPointer.h"
+
+#include <vtkstd/vector>
+
+// Direct transform of the complex image data along the first axes in turn.
+static void DirectTransform(vtkstd::vector<double> &data, const int dims[3],
+                            int dimensionality)
+{
+  int inc[3] = { 1, dims[0], dims[0] * dims[1] };
+  for (int axis = 0; axis < dimensionality; axis++)
+    {
+    int n = dims[axis];
+    vtkstd::vector<double> line(2 * n);
+    for (int k = 0; k < dims[2]; k++)
+      {
+      for (int j = 0; j < dims[1]; j++)
+        {
+        for (int i = 0; i < dims[0]; i++)
+          {
+          int idx[3] = { i, j, k };
+          if (idx[axis] != 0)
+            {
+            continue;
+            }
+          int start = i + j * inc[1] + k * inc[2];
+          for (int f = 0; f < n; f++)
+            {
+            double re = 0.0, im = 0.0;
+            for (int t = 0; t < n; t++)
+              {
+              double angle = -2.0 * vtkMath::DoublePi() * ((f * t) % n) / n;
+              double xr = data[2 * (start + t * inc[axis])];
+              double xi = data[2 * (start + t * inc[axis]) + 1];
+              re += xr * cos(angle) - xi * sin(angle);
+              im += xr * sin(angle) + xi * cos(angle);
+              }
+            line[2 * f] = re;
+            line[2 * f + 1] = im;
+            }
+          for (int f = 0; f < n; f++)
+            {
+            data[2 * (start + f * inc[axis])] = line[2 * f];
+            data[2 * (start + f * inc[axis]) + 1] = line[2 * f + 1];
+            }
+          }
+        }
+      }
+    }
+}
+
+static double MaxDifference(vtkImageData *image, const double *values)
+{
+  vtkDataArray *scalars = image->GetPointData()->GetScalars();
+  double maxDiff = 0.0;
+  for (vtkIdType i = 0; i < scalars->GetNumberOfTuples(); i++)
+    {
+    for (int c = 0; c < scalars->GetNumberOfComponents(); c++)
+      {
+      double diff = fabs(scalars->GetComponent(i, c) - values[2 * i + c]);
+      maxDiff = (diff > maxDiff ? diff : maxDiff);
+      }
+    }
+  return maxDiff;
+}
+
+// The largest difference over a part of the output of the fast transform
+static double MaxDifferenceInExtent(vtkImageData *image, const int dims[3],
+                                    int dimensionality, const double *values)
+{
+  int ext[6];
+  for (int axis = 0; axis < 3; axis++)
+    {
+    ext[2 * axis] = (dims[axis] > 1 ? 1 : 0);
+    ext[2 * axis + 1] = (dims[axis] > 2 ? dims[axis] - 2 : ext[2 * axis]);
+    }
+  vtkSmartPointer<vtkImageFFT> fft = vtkSmartPointer<vtkImageFFT>::New();
+  fft->SetInput(image);
+  fft->SetDimensionality(dimensionality);
+  fft->GetOutput()->SetUpdateExtent(ext);
+  fft->GetOutput()->Update();
+
+  vtkImageData *output = fft->GetOutput();
+  double maxDiff = 0.0;
+  for (int k = ext[4]; k <= ext[5]; k++)
+    {
+    for (int j = ext[2]; j <= ext[3]; j++)
+      {
+      for (int i = ext[0]; i <= ext[1]; i++)
+        {
+        double *ptr = static_cast<double *>(output->GetScalarPointer(i, j, k));
+        const double *value = values + 2 * (i + dims[0] * (j + dims[1] * k));
+        double diff = fabs(ptr[0] - value[0]) + fabs(ptr[1] - value[1]);
+        maxDiff = (diff > maxDiff ? diff : maxDiff);
+        }
+      }
+    }
+  return maxDiff;
+}
+
+static int TestDimensions(int nx, int ny, int nz, int components,
+                          int dimensionality = 3)
+{
+  int dims[3] = { nx, ny, nz };
+  vtkSmartPointer<vtkImageData> image = vtkSmartPointer<vtkImageData>::New();
+  image->SetDimensions(dims);
+  image->SetScalarTypeToFloat();
+  image->SetNumberOfScalarComponents(components);
+  image->AllocateScalars();
+  vtkIdType numPts = image->GetNumberOfPoints();
+  vtkstd::vector<double> values(2 * numPts, 0.0);
+  float *ptr = static_cast<float *>(image->GetScalarPointer());
+  for (vtkIdType i = 0; i < numPts; i++)
+    {
+    for (int c = 0; c < components; c++)
+      {
+      ptr[components * i + c] = static_cast<float>(vtkMath::Random(-1, 1));
+      values[2 * i + c] = ptr[components * i + c];
+      }
+    }
+  vtkstd::vector<double> input = values;
+  DirectTransform(values, dims, dimensionality);
+
+  int status = 1;
+  for (int fast = 0; fast < 2 && status; fast++)
+    {
+    vtkSmartPointer<vtkImageFFT> fft = vtkSmartPointer<vtkImageFFT>::New();
+    fft->SetInput(image);
+    fft->SetDimensionality(dimensionality);
+    fft->SetFftAlgorithm(fast ? VTK_IMAGE_FFT_FAST : VTK_IMAGE_FFT_LEGACY);
+    vtkSmartPointer<vtkImageRFFT> rfft = vtkSmartPointer<vtkImageRFFT>::New();
+    rfft->SetInputConnection(fft->GetOutputPort());
+    rfft->SetDimensionality(dimensionality);
+    rfft->SetFftAlgorithm(fft->GetFftAlgorithm());
+    rfft->Update();
+
+    // The legacy transform rounds pi to a float.
+    double tolerance = (fast ? 1e-9 : 1e-4);
+    double fftDiff = MaxDifference(fft->GetOutput(), &values[0]);
+    double rfftDiff = MaxDifference(rfft->GetOutput(), &input[0]);
+    double partDiff = (fast ?
+      MaxDifferenceInExtent(image, dims, dimensionality, &values[0]) : 0.0);
+    cout << (fast ? "Fast" : "Legacy") << " transform of " << nx << "x"
+         << ny << "x" << nz << " along " << dimensionality << " axes ("
+         << components << " components): " << fftDiff << ", inverse "
+         << rfftDiff << ", part " << partDiff << endl;
+    if (fftDiff > tolerance || rfftDiff > tolerance || partDiff > tolerance)
+      {
+      cerr << "Wrong transform" << endl;
+      status = 0;
+      }
+    }
+  return status;
+}
+
+int TestImageFFT(int, char *[])
+{
+  vtkMath::RandomSeed(1234);
+  int defaultThreads = vtkMultiThreader::GetGlobalDefaultNumberOfThreads();
+  vtkMultiThreader::SetGlobalDefaultNumberOfThreads(4);
+  int status = TestDimensions(32, 12, 7, 1) &&
+    TestDimensions(37, 64, 5, 1) &&
+    TestDimensions(30, 17, 1, 2) &&
+    TestDimensions(1, 1, 97, 2) &&
+    TestDimensions(24, 20, 9, 1, 2) &&
+    TestDimensions(19, 6, 4, 2, 1);
+  vtkMultiThreader::SetGlobalDefaultNumberOfThreads(defaultThreads);
+
+  return status ? EXIT_SUCCESS : EXIT_FAILURE;
+}
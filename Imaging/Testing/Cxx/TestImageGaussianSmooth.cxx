@@ -0,0 +1,230 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestImageGaussianSmooth.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Smooths a noise volume with the recursive algorithm of
+// vtkImageGaussianSmooth, and checks it against the convolution away from
+// the boundaries, against itself on one thread and on streamed pieces.
+// Then checks that the gradient filters at a scale match the gradient of
+// the smoothed volume.
+
+#include "vtkDataArray.h"
+#include "vtkImageData.h"
+#include "vtkImageGaussianSmooth.h"
+#include "vtkImageGradient.h"
+#include "vtkImageGradientMagnitude.h"
+#include "vtkMath.h"
+#include "vtkMultiThreader.h"
+#include "vtkPointData.h"
+#include "vtkSmartPointer.h"
+
+#include <math.h>
+
+// The largest difference between two images over an extent
+static double MaximumDifference(vtkImageData *image1, vtkImageData *image2,
+                                const int extent[6])
+{
+  double maxDiff = 0.0;
+  int numComponents = image1->GetNumberOfScalarComponents();
+  for (int k = extent[4]; k <= extent[5]; k++)
+    {
+    for (int j = extent[2]; j <= extent[3]; j++)
+      {
+      for (int i = extent[0]; i <= extent[1]; i++)
+        {
+        for (int c = 0; c < numComponents; c++)
+          {
+          double diff = fabs(image1->GetScalarComponentAsDouble(i, j, k, c) -
+                             image2->GetScalarComponentAsDouble(i, j, k, c));
+          maxDiff = (diff > maxDiff ? diff : maxDiff);
+          }
+        }
+      }
+    }
+  return maxDiff;
+}
+
+static vtkImageGaussianSmooth *NewSmooth(vtkImageData *image,
+                                         const double sigmas[3],
+                                         int algorithm)
+{
+  vtkImageGaussianSmooth *smooth = vtkImageGaussianSmooth::New();
+  smooth->SetInput(image);
+  smooth->SetDimensionality(3);
+  smooth->SetStandardDeviations(sigmas[0], sigmas[1], sigmas[2]);
+  smooth->SetRadiusFactor(4.0);
+  smooth->SetAlgorithm(algorithm);
+  return smooth;
+}
+
+static int CheckSmooth(vtkImageData *image)
+{
+  const double sigmas[3] = { 1.5, 2.5, 4.0 };
+
+  vtkImageGaussianSmooth *convolution =
+    NewSmooth(image, sigmas, VTK_GAUSSIAN_SMOOTH_CONVOLUTION);
+  convolution->Update();
+  vtkImageGaussianSmooth *recursive =
+    NewSmooth(image, sigmas, VTK_GAUSSIAN_SMOOTH_RECURSIVE);
+  recursive->Update();
+
+  // Compare away from the boundaries, which are handled differently
+  int extent[6];
+  image->GetExtent(extent);
+  for (int j = 0; j < 3; j++)
+    {
+    int margin = static_cast<int>(5*sigmas[j]);
+    extent[2*j] += margin;
+    extent[2*j + 1] -= margin;
+    }
+  double diff = MaximumDifference(convolution->GetOutput(),
+                                  recursive->GetOutput(), extent);
+  convolution->Delete();
+  int status = 1;
+  if (diff > 0.5)
+    {
+    cerr << "Recursive smoothing differs by " << diff
+         << " from the convolution" << endl;
+    status = 0;
+    }
+
+  // The result does not depend on the number of threads
+  vtkImageGaussianSmooth *serial =
+    NewSmooth(image, sigmas, VTK_GAUSSIAN_SMOOTH_RECURSIVE);
+  serial->SetNumberOfThreads(1);
+  serial->Update();
+  diff = MaximumDifference(serial->GetOutput(), recursive->GetOutput(),
+                           image->GetExtent());
+  serial->Delete();
+  if (diff != 0.0)
+    {
+    cerr << "Recursive smoothing differs by " << diff
+         << " on one thread" << endl;
+    status = 0;
+    }
+
+  // A piece uses the whole axes, so it matches the whole output
+  int pieceExtent[6] = { 10, 30, 5, 20, 30, 39 };
+  vtkImageGaussianSmooth *piece =
+    NewSmooth(image, sigmas, VTK_GAUSSIAN_SMOOTH_RECURSIVE);
+  piece->UpdateInformation();
+  piece->GetOutput()->SetUpdateExtent(pieceExtent);
+  piece->Update();
+  diff = MaximumDifference(piece->GetOutput(), recursive->GetOutput(),
+                           pieceExtent);
+  piece->Delete();
+  recursive->Delete();
+  if (diff != 0.0)
+    {
+    cerr << "Recursive smoothing differs by " << diff
+         << " on a piece" << endl;
+    status = 0;
+    }
+
+  // In two dimensions, a piece needs only its own slices
+  vtkImageGaussianSmooth *slices =
+    NewSmooth(image, sigmas, VTK_GAUSSIAN_SMOOTH_RECURSIVE);
+  slices->SetDimensionality(2);
+  slices->Update();
+  vtkImageGaussianSmooth *slicesPiece =
+    NewSmooth(image, sigmas, VTK_GAUSSIAN_SMOOTH_RECURSIVE);
+  slicesPiece->SetDimensionality(2);
+  slicesPiece->UpdateInformation();
+  slicesPiece->GetOutput()->SetUpdateExtent(pieceExtent);
+  slicesPiece->Update();
+  diff = MaximumDifference(slicesPiece->GetOutput(), slices->GetOutput(),
+                           pieceExtent);
+  slices->Delete();
+  slicesPiece->Delete();
+  if (diff != 0.0)
+    {
+    cerr << "Recursive smoothing in two dimensions differs by " << diff
+         << " on a piece" << endl;
+    status = 0;
+    }
+
+  return status;
+}
+
+static int CheckGradient(vtkImageData *image)
+{
+  const double sigma = 3.0;
+  const double sigmas[3] = { sigma, sigma, sigma };
+
+  vtkImageGaussianSmooth *smooth =
+    NewSmooth(image, sigmas, VTK_GAUSSIAN_SMOOTH_RECURSIVE);
+  vtkImageGradient *gradient = vtkImageGradient::New();
+  gradient->SetInputConnection(smooth->GetOutputPort());
+  gradient->SetDimensionality(3);
+  gradient->Update();
+  vtkImageGradient *scaledGradient = vtkImageGradient::New();
+  scaledGradient->SetInput(image);
+  scaledGradient->SetDimensionality(3);
+  scaledGradient->SetStandardDeviation(sigma);
+  scaledGradient->Update();
+
+  vtkImageGradientMagnitude *magnitude = vtkImageGradientMagnitude::New();
+  magnitude->SetInputConnection(smooth->GetOutputPort());
+  magnitude->SetDimensionality(3);
+  magnitude->Update();
+  vtkImageGradientMagnitude *scaledMagnitude =
+    vtkImageGradientMagnitude::New();
+  scaledMagnitude->SetInput(image);
+  scaledMagnitude->SetDimensionality(3);
+  scaledMagnitude->SetStandardDeviation(sigma);
+  scaledMagnitude->Update();
+
+  double diff = MaximumDifference(gradient->GetOutput(),
+                                  scaledGradient->GetOutput(),
+                                  image->GetExtent());
+  double magnitudeDiff = MaximumDifference(magnitude->GetOutput(),
+                                           scaledMagnitude->GetOutput(),
+                                           image->GetExtent());
+  smooth->Delete();
+  gradient->Delete();
+  scaledGradient->Delete();
+  magnitude->Delete();
+  scaledMagnitude->Delete();
+
+  if (diff > 1e-10 || magnitudeDiff > 1e-10)
+    {
+    cerr << "The gradients at a scale differ by " << diff << " and "
+         << magnitudeDiff << " from the gradients of the smoothed image"
+         << endl;
+    return 0;
+    }
+  return 1;
+}
+
+int TestImageGaussianSmooth(int, char *[])
+{
+  vtkMath::RandomSeed(1701);
+  int defaultThreads = vtkMultiThreader::GetGlobalDefaultNumberOfThreads();
+  vtkMultiThreader::SetGlobalDefaultNumberOfThreads(4);
+
+  vtkSmartPointer<vtkImageData> image = vtkSmartPointer<vtkImageData>::New();
+  image->SetDimensions(72, 64, 48);
+  image->SetSpacing(1.0, 0.5, 2.0);
+  image->SetScalarTypeToDouble();
+  image->AllocateScalars();
+  vtkDataArray *scalars = image->GetPointData()->GetScalars();
+  for (vtkIdType i = 0; i < scalars->GetNumberOfTuples(); i++)
+    {
+    scalars->SetComponent(i, 0, vtkMath::Random(0, 1000));
+    }
+
+  int status = CheckSmooth(image) && CheckGradient(image);
+  vtkMultiThreader::SetGlobalDefaultNumberOfThreads(defaultThreads);
+
+  return status ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,151 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestImageMedian3D.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Filters noise images of several scalar types with vtkImageMedian3D at
+// several ranks, and checks every pixel against a sort of its neighborhood.
+
+#include "vtkDataArray.h"
+#include "vtkImageData.h"
+#include "vtkImageMedian3D.h"
+#include "vtkMath.h"
+#include "vtkMultiThreader.h"
+#include "vtkPointData.h"
+#include "vtkSmartPointer.h"
+
+#include <vtkstd/algorithm>
+#include <vtkstd/vector>
+
+static int CheckRank(vtkImageData *image, const int kernelSize[3],
+                     double rank)
+{
+  vtkSmartPointer<vtkImageMedian3D> median =
+    vtkSmartPointer<vtkImageMedian3D>::New();
+  median->SetInput(image);
+  median->SetKernelSize(kernelSize[0], kernelSize[1], kernelSize[2]);
+  median->SetRank(rank);
+  median->Update();
+
+  int dims[3];
+  image->GetDimensions(dims);
+  int numComp = image->GetNumberOfScalarComponents();
+  vtkDataArray *in = image->GetPointData()->GetScalars();
+  vtkDataArray *out = median->GetOutput()->GetPointData()->GetScalars();
+  vtkstd::vector<double> hood;
+  for (int k = 0; k < dims[2]; k++)
+    {
+    for (int j = 0; j < dims[1]; j++)
+      {
+      for (int i = 0; i < dims[0]; i++)
+        {
+        int idx[3] = { i, j, k };
+        int hoodMin[3], hoodMax[3];
+        for (int axis = 0; axis < 3; axis++)
+          {
+          hoodMin[axis] = idx[axis] - kernelSize[axis] / 2;
+          hoodMax[axis] = hoodMin[axis] + kernelSize[axis] - 1;
+          hoodMin[axis] = (hoodMin[axis] > 0 ? hoodMin[axis] : 0);
+          hoodMax[axis] = (hoodMax[axis] < dims[axis] - 1 ?
+                           hoodMax[axis] : dims[axis] - 1);
+          }
+        vtkIdType id = i + dims[0] * (j + dims[1] * k);
+        for (int c = 0; c < numComp; c++)
+          {
+          hood.clear();
+          for (int hk = hoodMin[2]; hk <= hoodMax[2]; hk++)
+            {
+            for (int hj = hoodMin[1]; hj <= hoodMax[1]; hj++)
+              {
+              for (int hi = hoodMin[0]; hi <= hoodMax[0]; hi++)
+                {
+                hood.push_back(in->GetComponent(
+                                 hi + dims[0] * (hj + dims[1] * hk), c));
+                }
+              }
+            }
+          vtkstd::sort(hood.begin(), hood.end());
+          double expected = hood[static_cast<int>(
+                                   rank * (hood.size() - 1) + 0.5)];
+          if (out->GetComponent(id, c) != expected)
+            {
+            cerr << "Wrong value at " << i << ", " << j << ", " << k
+                 << " for rank " << rank << " of "
+                 << image->GetScalarTypeAsString() << ": "
+                 << out->GetComponent(id, c) << " instead of " << expected
+                 << endl;
+            return 0;
+            }
+          }
+        }
+      }
+    }
+  return 1;
+}
+
+static int TestType(int scalarType, int numComp, double range[2])
+{
+  vtkSmartPointer<vtkImageData> image = vtkSmartPointer<vtkImageData>::New();
+  image->SetDimensions(23, 17, 9);
+  image->SetScalarType(scalarType);
+  image->SetNumberOfScalarComponents(numComp);
+  image->AllocateScalars();
+  vtkDataArray *scalars = image->GetPointData()->GetScalars();
+  for (vtkIdType i = 0; i < scalars->GetNumberOfTuples(); i++)
+    {
+    for (int c = 0; c < numComp; c++)
+      {
+      scalars->SetComponent(i, c, vtkMath::Floor(
+                              vtkMath::Random(range[0], range[1] + 1)));
+      }
+    }
+
+  int kernels[3][3] = { { 3, 3, 3 }, { 5, 4, 1 }, { 2, 7, 3 } };
+  double ranks[4] = { 0.0, 0.5, 0.3, 1.0 };
+  for (int k = 0; k < 3; k++)
+    {
+    for (int r = 0; r < 4; r++)
+      {
+      if (!CheckRank(image, kernels[k], ranks[r]))
+        {
+        return 0;
+        }
+      }
+    }
+  return 1;
+}
+
+int TestImageMedian3D(int, char *[])
+{
+  vtkMath::RandomSeed(4242);
+  int defaultThreads = vtkMultiThreader::GetGlobalDefaultNumberOfThreads();
+  vtkMultiThreader::SetGlobalDefaultNumberOfThreads(4);
+
+  // Narrow ranges give repeated values, wide ranges give sparse histograms.
+  double wideShort[2] = { VTK_SHORT_MIN, VTK_SHORT_MAX };
+  double narrowShort[2] = { -3, 3 };
+  double wideUnsignedShort[2] = { 0, VTK_UNSIGNED_SHORT_MAX };
+  double signedChar[2] = { VTK_SIGNED_CHAR_MIN, VTK_SIGNED_CHAR_MAX };
+  double unsignedChar[2] = { 0, 20 };
+  double wideFloat[2] = { -1000, 1000 };
+  double wideInt[2] = { -100000, 100000 };
+  int status = TestType(VTK_SHORT, 1, wideShort) &&
+    TestType(VTK_SHORT, 1, narrowShort) &&
+    TestType(VTK_UNSIGNED_SHORT, 2, wideUnsignedShort) &&
+    TestType(VTK_SIGNED_CHAR, 1, signedChar) &&
+    TestType(VTK_UNSIGNED_CHAR, 3, unsignedChar) &&
+    TestType(VTK_FLOAT, 1, wideFloat) &&
+    TestType(VTK_INT, 2, wideInt);
+  vtkMultiThreader::SetGlobalDefaultNumberOfThreads(defaultThreads);
+
+  return status ? EXIT_SUCCESS : EXIT_FAILURE;
+}
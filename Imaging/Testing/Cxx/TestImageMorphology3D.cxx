@@ -0,0 +1,195 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestImageMorphology3D.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Dilates and erodes noise images with vtkImageContinuousDilate3D,
+// vtkImageContinuousErode3D and vtkImageDilateErode3D, with ellipsoid and
+// box kernels, and checks every pixel against a direct evaluation of the
+// kernel.
+
+#include "vtkDataArray.h"
+#include "vtkImageContinuousDilate3D.h"
+#include "vtkImageContinuousErode3D.h"
+#include "vtkImageData.h"
+#include "vtkImageDilateErode3D.h"
+#include "vtkImageEllipsoidSource.h"
+#include "vtkMath.h"
+#include "vtkMultiThreader.h"
+#include "vtkPointData.h"
+#include "vtkSmartPointer.h"
+
+// The kernel as the filters build it, with zero for the voxels outside.
+static vtkSmartPointer<vtkImageData> MakeKernel(const int size[3], int box)
+{
+  vtkSmartPointer<vtkImageEllipsoidSource> ellipse =
+    vtkSmartPointer<vtkImageEllipsoidSource>::New();
+  ellipse->SetWholeExtent(0, size[0] - 1, 0, size[1] - 1, 0, size[2] - 1);
+  ellipse->SetCenter((size[0] - 1)*0.5, (size[1] - 1)*0.5,
+                     (size[2] - 1)*0.5);
+  ellipse->SetRadius(size[0]*0.5, size[1]*0.5, size[2]*0.5);
+  if (box)
+    {
+    ellipse->SetInValue(255);
+    ellipse->SetOutValue(255);
+    }
+  ellipse->Update();
+  vtkSmartPointer<vtkImageData> kernel = vtkSmartPointer<vtkImageData>::New();
+  kernel->ShallowCopy(ellipse->GetOutput());
+  return kernel;
+}
+
+// Mode 0 dilates, mode 1 erodes, mode 2 dilates 255 into 0.
+static double Expected(vtkImageData *image, vtkImageData *kernel,
+                       const int idx[3], int c, int mode)
+{
+  int dims[3], size[3];
+  image->GetDimensions(dims);
+  kernel->GetDimensions(size);
+  double center =
+    image->GetScalarComponentAsDouble(idx[0], idx[1], idx[2], c);
+  double value = center;
+  for (int k = 0; k < size[2]; k++)
+    {
+    for (int j = 0; j < size[1]; j++)
+      {
+      for (int i = 0; i < size[0]; i++)
+        {
+        int n[3] = { idx[0] + i - size[0]/2, idx[1] + j - size[1]/2,
+                     idx[2] + k - size[2]/2 };
+        if (n[0] < 0 || n[0] >= dims[0] || n[1] < 0 || n[1] >= dims[1] ||
+            n[2] < 0 || n[2] >= dims[2] ||
+            kernel->GetScalarComponentAsDouble(i, j, k, 0) == 0)
+          {
+          continue;
+          }
+        double neighbor =
+          image->GetScalarComponentAsDouble(n[0], n[1], n[2], c);
+        if (mode == 0 && neighbor > value)
+          {
+          value = neighbor;
+          }
+        else if (mode == 1 && neighbor < value)
+          {
+          value = neighbor;
+          }
+        else if (mode == 2 && center == 0 && neighbor == 255)
+          {
+          value = 255;
+          }
+        }
+      }
+    }
+  return value;
+}
+
+static int CheckFilter(vtkImageSpatialAlgorithm *filter, vtkImageData *image,
+                       const int size[3], int box, int mode)
+{
+  filter->SetInput(image);
+  filter->Update();
+  vtkSmartPointer<vtkImageData> kernel = MakeKernel(size, box);
+  vtkImageData *output = filter->GetOutput();
+  int dims[3];
+  image->GetDimensions(dims);
+  int numComp = image->GetNumberOfScalarComponents();
+  int idx[3];
+  for (idx[2] = 0; idx[2] < dims[2]; idx[2]++)
+    {
+    for (idx[1] = 0; idx[1] < dims[1]; idx[1]++)
+      {
+      for (idx[0] = 0; idx[0] < dims[0]; idx[0]++)
+        {
+        for (int c = 0; c < numComp; c++)
+          {
+          double expected = Expected(image, kernel, idx, c, mode);
+          double value = output->GetScalarComponentAsDouble(
+            idx[0], idx[1], idx[2], c);
+          if (value != expected)
+            {
+            cerr << filter->GetClassName() << " with a "
+                 << size[0] << "x" << size[1] << "x" << size[2]
+                 << (box ? " box" : " ellipsoid") << " gives " << value
+                 << " instead of " << expected << " at " << idx[0] << ", "
+                 << idx[1] << ", " << idx[2] << endl;
+            return 0;
+            }
+          }
+        }
+      }
+    }
+  return 1;
+}
+
+static vtkSmartPointer<vtkImageData> MakeImage(int scalarType, int numComp,
+                                               double maxValue)
+{
+  vtkSmartPointer<vtkImageData> image = vtkSmartPointer<vtkImageData>::New();
+  image->SetDimensions(21, 17, 12);
+  image->SetScalarType(scalarType);
+  image->SetNumberOfScalarComponents(numComp);
+  image->AllocateScalars();
+  vtkDataArray *scalars = image->GetPointData()->GetScalars();
+  for (vtkIdType i = 0; i < scalars->GetNumberOfTuples(); i++)
+    {
+    for (int c = 0; c < numComp; c++)
+      {
+      double value = vtkMath::Random(0, maxValue);
+      scalars->SetComponent(i, c, (maxValue == 255 ?
+                                   (value > 240 ? 255 : 0) : value));
+      }
+    }
+  return image;
+}
+
+int TestImageMorphology3D(int, char *[])
+{
+  vtkMath::RandomSeed(1771);
+  int defaultThreads = vtkMultiThreader::GetGlobalDefaultNumberOfThreads();
+  vtkMultiThreader::SetGlobalDefaultNumberOfThreads(4);
+
+  vtkSmartPointer<vtkImageData> shortImage = MakeImage(VTK_SHORT, 1, 1000);
+  vtkSmartPointer<vtkImageData> floatImage = MakeImage(VTK_FLOAT, 2, 1);
+  vtkSmartPointer<vtkImageData> binaryImage =
+    MakeImage(VTK_UNSIGNED_CHAR, 1, 255);
+
+  int sizes[4][3] = { { 5, 5, 5 }, { 4, 3, 6 }, { 1, 7, 1 }, { 7, 6, 5 } };
+  int status = 1;
+  for (int s = 0; s < 4 && status; s++)
+    {
+    for (int box = 0; box < 2 && status; box++)
+      {
+      vtkSmartPointer<vtkImageContinuousDilate3D> dilate =
+        vtkSmartPointer<vtkImageContinuousDilate3D>::New();
+      dilate->SetKernelSize(sizes[s][0], sizes[s][1], sizes[s][2]);
+      dilate->SetKernelShape(box);
+      vtkSmartPointer<vtkImageContinuousErode3D> erode =
+        vtkSmartPointer<vtkImageContinuousErode3D>::New();
+      erode->SetKernelSize(sizes[s][0], sizes[s][1], sizes[s][2]);
+      erode->SetKernelShape(box);
+      vtkSmartPointer<vtkImageDilateErode3D> dilateErode =
+        vtkSmartPointer<vtkImageDilateErode3D>::New();
+      dilateErode->SetKernelSize(sizes[s][0], sizes[s][1], sizes[s][2]);
+      dilateErode->SetKernelShape(box);
+      dilateErode->SetDilateValue(255);
+      dilateErode->SetErodeValue(0);
+      status = CheckFilter(dilate, shortImage, sizes[s], box, 0) &&
+        CheckFilter(dilate, floatImage, sizes[s], box, 0) &&
+        CheckFilter(erode, shortImage, sizes[s], box, 1) &&
+        CheckFilter(erode, floatImage, sizes[s], box, 1) &&
+        CheckFilter(dilateErode, binaryImage, sizes[s], box, 2);
+      }
+    }
+  vtkMultiThreader::SetGlobalDefaultNumberOfThreads(defaultThreads);
+
+  return status ? EXIT_SUCCESS : EXIT_FAILURE;
+}
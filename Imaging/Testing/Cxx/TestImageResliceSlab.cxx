@@ -0,0 +1,303 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestImageResliceSlab.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Reslices a random volume along permuted axes with each interpolation mode
+// and each slab mode.  The rows of one-component images are interpolated
+// and composited by their own loops, so they must give the same values as
+// the first component of a two-component image.  Without a slab, they must
+// also agree with the unoptimized path, which interpolates one voxel at a
+// time.  Along oblique axes, the rows are interpolated by the row functions
+// of vtkImageInterpolator, which must match its point function exactly.
+
+#include "vtkDataArray.h"
+#include "vtkImageData.h"
+#include "vtkImageInterpolator.h"
+#include "vtkImageReslice.h"
+#include "vtkMath.h"
+#include "vtkMatrix4x4.h"
+#include "vtkMultiThreader.h"
+#include "vtkPointData.h"
+#include "vtkSmartPointer.h"
+#include "vtkTransform.h"
+
+#include <math.h>
+
+static vtkImageReslice *NewReslice(vtkImageData *image, int interpolation,
+                                   int slabMode, int trapezoid,
+                                   int optimization)
+{
+  const double axes[16] = {
+    0.0, 0.0, 1.0, 0.0,
+    1.0, 0.0, 0.0, 0.0,
+    0.0, 1.0, 0.0, 0.0,
+    0.0, 0.0, 0.0, 1.0 };
+  vtkSmartPointer<vtkMatrix4x4> matrix =
+    vtkSmartPointer<vtkMatrix4x4>::New();
+  matrix->DeepCopy(axes);
+
+  vtkImageReslice *reslice = vtkImageReslice::New();
+  reslice->SetInput(image);
+  reslice->SetResliceAxes(matrix);
+  reslice->SetResliceAxesOrigin(20.3, 17.6, 21.1);
+  reslice->SetOutputSpacing(0.7, 0.9, 1.1);
+  reslice->SetOutputExtent(-20, 20, -20, 20, -6, 6);
+  reslice->SetInterpolationMode(interpolation);
+  reslice->SetOptimization(optimization);
+  if (slabMode >= 0)
+    {
+    reslice->SetSlabNumberOfSlices(5);
+    reslice->SetSlabMode(slabMode);
+    reslice->SetSlabTrapezoidIntegration(trapezoid);
+    }
+  reslice->Update();
+  return reslice;
+}
+
+// The largest difference between a component of the outputs
+static double MaximumDifference(vtkImageReslice *reslice1, int component1,
+                                vtkImageReslice *reslice2, int component2)
+{
+  vtkDataArray *scalars1 =
+    reslice1->GetOutput()->GetPointData()->GetScalars();
+  vtkDataArray *scalars2 =
+    reslice2->GetOutput()->GetPointData()->GetScalars();
+  vtkIdType n = scalars1->GetNumberOfTuples();
+  if (scalars2->GetNumberOfTuples() != n)
+    {
+    return VTK_DOUBLE_MAX;
+    }
+  double maxDiff = 0.0;
+  for (vtkIdType i = 0; i < n; i++)
+    {
+    double diff = fabs(scalars1->GetComponent(i, component1) -
+                       scalars2->GetComponent(i, component2));
+    maxDiff = (diff > maxDiff ? diff : maxDiff);
+    }
+  return maxDiff;
+}
+
+static int CheckReslice(vtkImageData *image, vtkImageData *image2,
+                        int interpolation, int slabMode, int trapezoid)
+{
+  vtkImageReslice *reslice =
+    NewReslice(image, interpolation, slabMode, trapezoid, 1);
+  vtkImageReslice *reslice2 =
+    NewReslice(image2, interpolation, slabMode, trapezoid, 1);
+  double diff = MaximumDifference(reslice, 0, reslice2, 0);
+  double diff2 = 0.0;
+  if (slabMode < 0)
+    {
+    vtkImageReslice *unoptimized =
+      NewReslice(image, interpolation, slabMode, trapezoid, 0);
+    diff2 = MaximumDifference(reslice, 0, unoptimized, 0);
+    unoptimized->Delete();
+    }
+  reslice->Delete();
+  reslice2->Delete();
+
+  if (diff != 0.0 || diff2 > 1e-3)
+    {
+    cerr << "Interpolation mode " << interpolation << " with slab mode "
+         << slabMode << " and trapezoid " << trapezoid << " differs by "
+         << diff << " on two components and by " << diff2
+         << " from the unoptimized path" << endl;
+    return 0;
+    }
+  return 1;
+}
+
+// Compare rows of structured coords with the points along them, for each
+// border mode and for single and double precision
+template<class F>
+static int CheckRows(vtkImageInterpolator *interpolator, const char *type)
+{
+  int numComponents = interpolator->GetNumberOfComponents();
+  F row[100*2];
+  F value[2];
+  int count = 0;
+  for (int border = VTK_IMAGE_BORDER_CLAMP;
+       border <= VTK_IMAGE_BORDER_MIRROR; border++)
+    {
+    interpolator->SetBorderMode(border);
+    interpolator->Update();
+    for (int trial = 0; trial < 20; trial++)
+      {
+      // the rows may leave the extent, to check the border modes
+      F origin[3], step[3];
+      origin[0] = static_cast<F>(vtkMath::Random(-5.0, 45.0));
+      origin[1] = static_cast<F>(vtkMath::Random(-5.0, 40.0));
+      origin[2] = static_cast<F>(vtkMath::Random(-5.0, 35.0));
+      step[0] = static_cast<F>(vtkMath::Random(-0.4, 0.4));
+      step[1] = static_cast<F>(vtkMath::Random(-0.4, 0.4));
+      step[2] = static_cast<F>(vtkMath::Random(-0.4, 0.4));
+      int idX = static_cast<int>(vtkMath::Random(-20.0, 20.0));
+      interpolator->InterpolateRowIJK(origin, step, idX, row, 100);
+      for (int i = 0; i < 100; i++)
+        {
+        F point[3];
+        point[0] = origin[0] + (idX + i)*step[0];
+        point[1] = origin[1] + (idX + i)*step[1];
+        point[2] = origin[2] + (idX + i)*step[2];
+        interpolator->InterpolateIJK(point, value);
+        for (int c = 0; c < numComponents; c++)
+          {
+          count += (row[i*numComponents + c] != value[c]);
+          }
+        }
+      }
+    }
+  interpolator->SetBorderMode(VTK_IMAGE_BORDER_CLAMP);
+
+  if (count != 0)
+    {
+    cerr << count << " " << type << " values of rows with interpolation "
+         << interpolator->GetInterpolationModeAsString() << " and "
+         << numComponents << " components differ from their points" << endl;
+    return 0;
+    }
+  return 1;
+}
+
+// Reslice along oblique axes, where the rows are interpolated at once,
+// and compare with the interpolation of each point
+static int CheckOblique(vtkImageData *image, vtkImageData *image2,
+                        int interpolation)
+{
+  vtkSmartPointer<vtkImageInterpolator> interpolator =
+    vtkSmartPointer<vtkImageInterpolator>::New();
+  interpolator->SetInterpolationMode(interpolation);
+  interpolator->Initialize(image2);
+  interpolator->Update();
+  int status = CheckRows<double>(interpolator, "double");
+  status &= CheckRows<float>(interpolator, "float");
+  interpolator->SetComponentCount(1);
+  interpolator->Update();
+  status &= CheckRows<double>(interpolator, "double");
+  status &= CheckRows<float>(interpolator, "float");
+
+  vtkSmartPointer<vtkTransform> rotation =
+    vtkSmartPointer<vtkTransform>::New();
+  rotation->RotateWXYZ(35.0, 0.3, -0.6, 1.0);
+  vtkSmartPointer<vtkMatrix4x4> matrix =
+    vtkSmartPointer<vtkMatrix4x4>::New();
+  matrix->DeepCopy(rotation->GetMatrix());
+  vtkImageReslice *reslices[2];
+  vtkImageData *images[2] = { image, image2 };
+  for (int i = 0; i < 2; i++)
+    {
+    reslices[i] = vtkImageReslice::New();
+    reslices[i]->SetInput(images[i]);
+    reslices[i]->SetResliceAxes(matrix);
+    reslices[i]->SetResliceAxesOrigin(20.3, 17.6, 21.1);
+    reslices[i]->SetOutputSpacing(0.7, 0.9, 1.1);
+    reslices[i]->SetOutputExtent(-30, 30, -26, 26, -20, 20);
+    reslices[i]->SetInterpolationMode(interpolation);
+    reslices[i]->Update();
+    }
+  double diff = MaximumDifference(reslices[0], 0, reslices[1], 0);
+
+  // the output points that are well inside the input must match the
+  // interpolation of their positions
+  interpolator->SetComponentCount(-1);
+  interpolator->Initialize(image);
+  interpolator->Update();
+  vtkImageData *output = reslices[0]->GetOutput();
+  vtkDataArray *scalars = output->GetPointData()->GetScalars();
+  vtkMatrix4x4 *axes = reslices[0]->GetResliceAxes();
+  double bounds[6];
+  image->GetBounds(bounds);
+  double diff2 = 0.0;
+  vtkIdType inside = 0;
+  for (vtkIdType i = 0; i < scalars->GetNumberOfTuples(); i++)
+    {
+    double point[4];
+    output->GetPoint(i, point);
+    point[3] = 1.0;
+    axes->MultiplyPoint(point, point);
+    if (point[0] < bounds[0] + 2 || point[0] > bounds[1] - 2 ||
+        point[1] < bounds[2] + 2 || point[1] > bounds[3] - 2 ||
+        point[2] < bounds[4] + 3 || point[2] > bounds[5] - 3)
+      {
+      continue;
+      }
+    inside++;
+    double value;
+    interpolator->Interpolate(point, &value);
+    double d = fabs(value - scalars->GetComponent(i, 0));
+    diff2 = (d > diff2 ? d : diff2);
+    }
+  reslices[0]->Delete();
+  reslices[1]->Delete();
+
+  if (diff != 0.0 || diff2 > 1e-3 || inside < 10000)
+    {
+    cerr << "Oblique interpolation mode " << interpolation << " differs by "
+         << diff << " on two components and by " << diff2 << " at "
+         << inside << " points" << endl;
+    status = 0;
+    }
+  return status;
+}
+
+int TestImageResliceSlab(int, char *[])
+{
+  // each reslice splits its output between the threads
+  int defaultThreads = vtkMultiThreader::GetGlobalDefaultNumberOfThreads();
+  vtkMultiThreader::SetGlobalDefaultNumberOfThreads(4);
+  vtkMath::RandomSeed(1618);
+
+  vtkSmartPointer<vtkImageData> image = vtkSmartPointer<vtkImageData>::New();
+  image->SetDimensions(40, 36, 30);
+  image->SetSpacing(1.0, 1.0, 1.5);
+  image->SetScalarTypeToFloat();
+  image->AllocateScalars();
+  vtkSmartPointer<vtkImageData> image2 =
+    vtkSmartPointer<vtkImageData>::New();
+  image2->SetDimensions(40, 36, 30);
+  image2->SetSpacing(1.0, 1.0, 1.5);
+  image2->SetScalarTypeToFloat();
+  image2->SetNumberOfScalarComponents(2);
+  image2->AllocateScalars();
+
+  vtkDataArray *scalars = image->GetPointData()->GetScalars();
+  vtkDataArray *scalars2 = image2->GetPointData()->GetScalars();
+  for (vtkIdType i = 0; i < scalars->GetNumberOfTuples(); i++)
+    {
+    double v = vtkMath::Random(0.0, 100.0);
+    scalars->SetComponent(i, 0, v);
+    scalars2->SetComponent(i, 0, v);
+    scalars2->SetComponent(i, 1, 100.0 - v);
+    }
+
+  int status = 1;
+  for (int interpolation = VTK_RESLICE_NEAREST;
+       interpolation <= VTK_RESLICE_CUBIC; interpolation++)
+    {
+    status &= CheckReslice(image, image2, interpolation, -1, 0);
+    status &= CheckReslice(image, image2, interpolation,
+                           VTK_IMAGE_SLAB_MIN, 0);
+    status &= CheckReslice(image, image2, interpolation,
+                           VTK_IMAGE_SLAB_MAX, 0);
+    status &= CheckReslice(image, image2, interpolation,
+                           VTK_IMAGE_SLAB_MEAN, 0);
+    status &= CheckReslice(image, image2, interpolation,
+                           VTK_IMAGE_SLAB_MEAN, 1);
+    status &= CheckReslice(image, image2, interpolation,
+                           VTK_IMAGE_SLAB_SUM, 1);
+    status &= CheckOblique(image, image2, interpolation);
+    }
+  vtkMultiThreader::SetGlobalDefaultNumberOfThreads(defaultThreads);
+
+  return status ? EXIT_SUCCESS : EXIT_FAILURE;
+}
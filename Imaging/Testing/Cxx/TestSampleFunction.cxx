@@ -0,0 +1,222 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestSampleFunction.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Evaluates a tree of vtkImplicitBoolean functions for an array of points
+// and checks it against the evaluation point by point.  Then samples the
+// tree with vtkSampleFunction on four threads and on one, with and without
+// adaptive sampling, which must cross the same contour edges between the
+// same values as the full sampling.
+
+#include "vtkCylinder.h"
+#include "vtkDataArray.h"
+#include "vtkDoubleArray.h"
+#include "vtkImageData.h"
+#include "vtkImplicitBoolean.h"
+#include "vtkMath.h"
+#include "vtkPlane.h"
+#include "vtkPointData.h"
+#include "vtkQuadric.h"
+#include "vtkSampleFunction.h"
+#include "vtkSmartPointer.h"
+#include "vtkSphere.h"
+#include "vtkTransform.h"
+
+static int CheckFunctionValue(vtkImplicitFunction *function)
+{
+  vtkSmartPointer<vtkDoubleArray> points =
+    vtkSmartPointer<vtkDoubleArray>::New();
+  points->SetNumberOfComponents(3);
+  for (int i = 0; i < 1000; i++)
+    {
+    points->InsertNextTuple3(vtkMath::Random(-1.0, 1.0),
+                             vtkMath::Random(-1.0, 1.0),
+                             vtkMath::Random(-1.0, 1.0));
+    }
+  vtkSmartPointer<vtkDoubleArray> values =
+    vtkSmartPointer<vtkDoubleArray>::New();
+  function->FunctionValue(points, values);
+
+  if (values->GetNumberOfTuples() != points->GetNumberOfTuples())
+    {
+    cerr << "FunctionValue returned " << values->GetNumberOfTuples()
+         << " values for " << points->GetNumberOfTuples() << " points" << endl;
+    return 0;
+    }
+  for (vtkIdType i = 0; i < points->GetNumberOfTuples(); i++)
+    {
+    double value = function->FunctionValue(points->GetTuple3(i));
+    if (values->GetValue(i) != value)
+      {
+      cerr << "Point " << i << " has the value " << values->GetValue(i)
+           << " instead of " << value << endl;
+      return 0;
+      }
+    }
+  return 1;
+}
+
+static vtkSampleFunction *NewSample(vtkImplicitFunction *function,
+                                    int threads, int adaptive)
+{
+  vtkSampleFunction *sample = vtkSampleFunction::New();
+  sample->SetImplicitFunction(function);
+  sample->SetSampleDimensions(61, 53, 47);
+  sample->SetModelBounds(-1.0, 1.0, -1.0, 1.0, -0.8, 0.8);
+  sample->SetNumberOfThreads(threads);
+  sample->SetAdaptiveSampling(adaptive);
+  sample->ComputeNormalsOn();
+  sample->Update();
+  return sample;
+}
+
+// The scalars and normals on four threads must match those on one
+static int CheckThreads(vtkImplicitFunction *function, int adaptive)
+{
+  vtkSampleFunction *threaded = NewSample(function, 4, adaptive);
+  vtkSampleFunction *serial = NewSample(function, 1, adaptive);
+  vtkPointData *pd1 = threaded->GetOutput()->GetPointData();
+  vtkPointData *pd2 = serial->GetOutput()->GetPointData();
+  vtkIdType count = 0;
+  for (vtkIdType i = 0; i < pd1->GetScalars()->GetNumberOfTuples(); i++)
+    {
+    double *n1 = pd1->GetNormals()->GetTuple3(i);
+    double *n2 = pd2->GetNormals()->GetTuple3(i);
+    count += (pd1->GetScalars()->GetComponent(i, 0) !=
+              pd2->GetScalars()->GetComponent(i, 0) ||
+              n1[0] != n2[0] || n1[1] != n2[1] || n1[2] != n2[2]);
+    }
+  threaded->Delete();
+  serial->Delete();
+  if (count != 0)
+    {
+    cerr << count << " voxels differ on four threads with adaptive "
+         << "sampling " << (adaptive ? "on" : "off") << endl;
+    return 0;
+    }
+  return 1;
+}
+
+static int CheckAdaptive(vtkImplicitFunction *function)
+{
+  vtkSampleFunction *full = NewSample(function, 4, 0);
+  vtkSampleFunction *adaptive = NewSample(function, 4, 1);
+  vtkImageData *image = full->GetOutput();
+  vtkDataArray *s1 = image->GetPointData()->GetScalars();
+  vtkDataArray *s2 = adaptive->GetOutput()->GetPointData()->GetScalars();
+  int dims[3];
+  image->GetDimensions(dims);
+  vtkIdType increments[3] = { 1, dims[0], dims[0]*dims[1] };
+
+  // the values differ where the blocks were skipped, but the signs do not,
+  // and the edges that the contour crosses have exact values at both ends
+  vtkIdType skipped = 0;
+  vtkIdType wrong = 0;
+  for (int k = 0; k < dims[2]; k++)
+    {
+    for (int j = 0; j < dims[1]; j++)
+      {
+      for (int i = 0; i < dims[0]; i++)
+        {
+        int ijk[3] = { i, j, k };
+        vtkIdType idx = i + j*increments[1] + k*increments[2];
+        double v1 = s1->GetComponent(idx, 0);
+        double v2 = s2->GetComponent(idx, 0);
+        skipped += (v1 != v2);
+        wrong += ((v1 > 0) != (v2 > 0));
+        for (int axis = 0; axis < 3; axis++)
+          {
+          if (ijk[axis] + 1 < dims[axis])
+            {
+            vtkIdType next = idx + increments[axis];
+            double w1 = s1->GetComponent(next, 0);
+            if ((v1 > 0) != (w1 > 0))
+              {
+              wrong += (v1 != v2 || w1 != s2->GetComponent(next, 0));
+              }
+            }
+          }
+        }
+      }
+    }
+  full->Delete();
+  adaptive->Delete();
+
+  if (wrong != 0 || skipped == 0)
+    {
+    cerr << "Adaptive sampling skipped " << skipped << " voxels and has "
+         << wrong << " wrong signs or edges" << endl;
+    return 0;
+    }
+  return 1;
+}
+
+int TestSampleFunction(int, char *[])
+{
+  vtkMath::RandomSeed(2718);
+
+  vtkSmartPointer<vtkSphere> sphere1 = vtkSmartPointer<vtkSphere>::New();
+  sphere1->SetCenter(0.3, 0.0, 0.1);
+  sphere1->SetRadius(0.45);
+  vtkSmartPointer<vtkTransform> transform =
+    vtkSmartPointer<vtkTransform>::New();
+  transform->Translate(0.4, -0.2, 0.0);
+  transform->RotateZ(30.0);
+  vtkSmartPointer<vtkSphere> sphere2 = vtkSmartPointer<vtkSphere>::New();
+  sphere2->SetRadius(0.35);
+  sphere2->SetTransform(transform);
+  vtkSmartPointer<vtkQuadric> ellipsoid = vtkSmartPointer<vtkQuadric>::New();
+  ellipsoid->SetCoefficients(4.0, 9.0, 16.0, 0, 0, 0, 0, 0, 0, -1.0);
+  vtkSmartPointer<vtkCylinder> cylinder = vtkSmartPointer<vtkCylinder>::New();
+  cylinder->SetRadius(0.15);
+
+  vtkSmartPointer<vtkImplicitBoolean> blobs =
+    vtkSmartPointer<vtkImplicitBoolean>::New();
+  blobs->SetOperationTypeToUnion();
+  blobs->AddFunction(sphere1);
+  blobs->AddFunction(sphere2);
+  blobs->AddFunction(ellipsoid);
+
+  vtkSmartPointer<vtkImplicitBoolean> drilled =
+    vtkSmartPointer<vtkImplicitBoolean>::New();
+  drilled->SetOperationTypeToDifference();
+  drilled->AddFunction(blobs);
+  drilled->AddFunction(cylinder);
+
+  vtkSmartPointer<vtkPlane> plane = vtkSmartPointer<vtkPlane>::New();
+  plane->SetNormal(0.2, 0.3, 1.0);
+  vtkSmartPointer<vtkImplicitBoolean> cut =
+    vtkSmartPointer<vtkImplicitBoolean>::New();
+  cut->SetOperationTypeToIntersection();
+  cut->AddFunction(drilled);
+  cut->AddFunction(plane);
+
+  int status = 1;
+  vtkImplicitFunction *functions[2] = { drilled, cut };
+  for (int f = 0; f < 2; f++)
+    {
+    status &= CheckFunctionValue(functions[f]);
+    status &= CheckThreads(functions[f], 0);
+    status &= CheckThreads(functions[f], 1);
+    status &= CheckAdaptive(functions[f]);
+    }
+
+  vtkSmartPointer<vtkImplicitBoolean> magnitudes =
+    vtkSmartPointer<vtkImplicitBoolean>::New();
+  magnitudes->SetOperationTypeToUnionOfMagnitudes();
+  magnitudes->AddFunction(plane);
+  magnitudes->AddFunction(ellipsoid);
+  status &= CheckFunctionValue(magnitudes);
+
+  return status ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -18,9 +18,13 @@
 #include "vtkImageData.h"
 #include "vtkInformation.h"
 #include "vtkInformationVector.h"
+#include "vtkMultiThreader.h"
 #include "vtkObjectFactory.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
 #include "vtkPointData.h"
+#include "vtkPointSet.h"
+#include "vtkPoints.h"
+#include "vtkSplatBucketsInternals.h"
 
 #include <math.h>
 
@@ -56,6 +60,13 @@ vtkGaussianSplatter::vtkGaussianSplatter()
 
   this->AccumulationMode = VTK_ACCUMULATION_MODE_MAX;
   this->NullValue = 0.0;
+
+  this->Sample = &vtkGaussianSplatter::Gaussian;
+  this->SampleFactor = &vtkGaussianSplatter::PositionSampling;
+  this->Visited = NULL;
+  this->P = NULL;
+  this->N = NULL;
+  this->S = 0.0;
 }
 
 //----------------------------------------------------------------------------
@@ -102,6 +113,260 @@ int vtkGaussianSplatter::RequestInformation (
   return 1;
 }
 
+//----------------------------------------------------------------------------
+// The squared distance from a sample to a point
+static inline double vtkGaussianSplatterDistance2(const double cx[3],
+                                                  const double p[3])
+{
+  return ((cx[0]-p[0])*(cx[0]-p[0]) + (cx[1]-p[1])*(cx[1]-p[1]) +
+          (cx[2]-p[2])*(cx[2]-p[2]) );
+}
+
+//----------------------------------------------------------------------------
+// The magnitude that the dot product with a normal is divided by
+static inline double vtkGaussianSplatterNormalMagnitude(const double n[3])
+{
+  double mag = n[0]*n[0] + n[1]*n[1] + n[2]*n[2];
+  if ( mag != 1.0 )
+    {
+    mag = (mag == 0.0 ? 1.0 : sqrt(mag));
+    }
+  return mag;
+}
+
+//----------------------------------------------------------------------------
+// The squared distance from a sample to a point, scaled across the normal
+// of the point by the squared eccentricity
+static inline double vtkGaussianSplatterEccentricDistance2(
+  const double cx[3], const double p[3], const double n[3], double mag,
+  double eccentricity2)
+{
+  double v[3], r2, z2;
+
+  v[0] = cx[0] - p[0];
+  v[1] = cx[1] - p[1];
+  v[2] = cx[2] - p[2];
+
+  r2 = v[0]*v[0] + v[1]*v[1] + v[2]*v[2];
+
+  z2 = (v[0]*n[0] + v[1]*n[1] + v[2]*n[2])/mag;
+  z2 = z2*z2;
+
+  return ((r2 - z2)/eccentricity2 + z2);
+}
+
+//----------------------------------------------------------------------------
+// Combine the value of a splat into a voxel
+static inline void vtkGaussianSplatterAccumulate(double *scalars,
+                                                 char *visited,
+                                                 vtkIdType idx, double v,
+                                                 int accumulationMode)
+{
+  if ( ! visited[idx] )
+    {
+    visited[idx] = 1;
+    scalars[idx] = v;
+    }
+  else
+    {
+    double s = scalars[idx];
+    switch (accumulationMode)
+      {
+      case VTK_ACCUMULATION_MODE_MIN:
+        scalars[idx] = (s < v ? s : v);
+        break;
+      case VTK_ACCUMULATION_MODE_MAX:
+        scalars[idx] = (s > v ? s : v);
+        break;
+      case VTK_ACCUMULATION_MODE_SUM:
+        scalars[idx] = s + v;
+        break;
+      }
+    }//not first visit
+}
+
+//----------------------------------------------------------------------------
+// The splatting of the points into slabs of the output, one per thread.
+class vtkGaussianSplatterWorker
+{
+public:
+  vtkGaussianSplatter *Self;
+  vtkDataSet *Input;
+  vtkPoints *Points;
+  vtkDataArray *InScalars;
+  vtkDataArray *InNormals;
+  vtkSplatBuckets *Buckets;
+  vtkIdType NumberOfPoints;
+  double *Scalars;
+  char *Visited;
+  int Dimensions[3];
+  double Origin[3];
+  double Spacing[3];
+  double SplatDistance[3];
+  double Radius2;
+  double Eccentricity2;
+  double ExponentFactor;
+  double ScaleFactor;
+  int ScalarWarping;
+  int AccumulationMode;
+  double NullValue;
+
+  // vtkImageData::GetPoint() is not reentrant, so the threads read the
+  // points of datasets that are not vtkPointSets from a copy.
+  void GetPoint(vtkIdType ptId, double p[3])
+    {
+    if (this->Points)
+      {
+      this->Points->GetPoint(ptId, p);
+      }
+    else
+      {
+      this->Input->GetPoint(ptId, p);
+      }
+    }
+
+  // The range of voxels that the splat of a point may reach
+  void Footprint(const double p[3], int min[3], int max[3])
+    {
+    for (int i = 0; i < 3; i++)
+      {
+      double loc = (p[i] - this->Origin[i]) / this->Spacing[i];
+      min[i] = static_cast<int>(floor(loc - this->SplatDistance[i]));
+      max[i] = static_cast<int>(ceil(loc + this->SplatDistance[i]));
+      if ( min[i] < 0 )
+        {
+        min[i] = 0;
+        }
+      if ( max[i] >= this->Dimensions[i] )
+        {
+        max[i] = this->Dimensions[i] - 1;
+        }
+      }
+    }
+
+  void SplatPoint(vtkIdType ptId, int kMin, int kMax);
+
+  void Execute(int threadId);
+
+  static VTK_THREAD_RETURN_TYPE ThreadedExecute(void *arg)
+    {
+    vtkMultiThreader::ThreadInfo *info =
+      static_cast<vtkMultiThreader::ThreadInfo *>(arg);
+    vtkGaussianSplatterWorker *self =
+      static_cast<vtkGaussianSplatterWorker *>(info->UserData);
+    self->Execute(info->ThreadID);
+    return VTK_THREAD_RETURN_VALUE;
+    }
+};
+
+//----------------------------------------------------------------------------
+// Splat one point into the slices kMin to kMax.  The squared distance
+// to the point is scaled across the normal if there are normals, which
+// gives an ellipsoidal splat.
+void vtkGaussianSplatterWorker::SplatPoint(vtkIdType ptId, int kMin, int kMax)
+{
+  double p[3], n[3], cx[3], dist2, mag = 1.0;
+  int min[3], max[3], i, j, k;
+
+  this->GetPoint(ptId, p);
+  this->Footprint(p, min, max);
+  min[2] = (min[2] < kMin ? kMin : min[2]);
+  max[2] = (max[2] > kMax ? kMax : max[2]);
+
+  double factor = this->ScaleFactor;
+  if ( this->ScalarWarping && this->InScalars != NULL )
+    {
+    factor *= this->InScalars->GetComponent(ptId,0);
+    }
+
+  if ( this->InNormals != NULL )
+    {
+    this->InNormals->GetTuple(ptId, n);
+    mag = vtkGaussianSplatterNormalMagnitude(n);
+    }
+
+  vtkIdType sliceSize =
+    static_cast<vtkIdType>(this->Dimensions[0])*this->Dimensions[1];
+
+  // Loop over all sample points in volume within footprint and
+  // evaluate the splat
+  for (k=min[2]; k<=max[2]; k++)
+    {
+    cx[2] = this->Origin[2] + this->Spacing[2]*k;
+    for (j=min[1]; j<=max[1]; j++)
+      {
+      cx[1] = this->Origin[1] + this->Spacing[1]*j;
+      vtkIdType idx = k*sliceSize + j*this->Dimensions[0] + min[0];
+      for (i=min[0]; i<=max[0]; i++, idx++)
+        {
+        cx[0] = this->Origin[0] + this->Spacing[0]*i;
+        if ( this->InNormals != NULL )
+          {
+          dist2 = vtkGaussianSplatterEccentricDistance2(
+            cx, p, n, mag, this->Eccentricity2);
+          }
+        else
+          {
+          dist2 = vtkGaussianSplatterDistance2(cx, p);
+          }
+        if ( dist2 <= this->Radius2 )
+          {
+          vtkGaussianSplatterAccumulate(
+            this->Scalars, this->Visited, idx,
+            factor * exp(this->ExponentFactor*dist2/this->Radius2),
+            this->AccumulationMode);
+          }
+        }
+      }
+    }//within splat footprint
+}
+
+//----------------------------------------------------------------------------
+// Initialize the slab of a thread, then splat the points of its bucket
+// into it.  Without buckets, there is one slab that holds all the points.
+void vtkGaussianSplatterWorker::Execute(int threadId)
+{
+  int kMin = 0;
+  int kMax = this->Dimensions[2] - 1;
+  const vtkIdType *ids = NULL;
+  vtkIdType numIds = this->NumberOfPoints;
+  if (this->Buckets)
+    {
+    kMin = this->Buckets->GetSlabStart(threadId);
+    kMax = this->Buckets->GetSlabStart(threadId + 1) - 1;
+    ids = this->Buckets->GetIds(threadId);
+    numIds = this->Buckets->GetNumberOfIds(threadId);
+    }
+  if (kMin > kMax)
+    {
+    return;
+    }
+
+  vtkIdType sliceSize =
+    static_cast<vtkIdType>(this->Dimensions[0])*this->Dimensions[1];
+  vtkIdType idxEnd = (kMax + 1)*sliceSize;
+  for (vtkIdType idx = kMin*sliceSize; idx < idxEnd; idx++)
+    {
+    this->Scalars[idx] = this->NullValue;
+    this->Visited[idx] = 0;
+    }
+
+  int abortExecute=0;
+  vtkIdType progressInterval = numIds/20 + 1;
+  for (vtkIdType i = 0; i < numIds && !abortExecute; i++)
+    {
+    if ( ! (i % progressInterval) )
+      {
+      if (threadId == 0)
+        {
+        this->Self->UpdateProgress(static_cast<double>(i)/numIds);
+        }
+      abortExecute = this->Self->GetAbortExecute();
+      }
+    this->SplatPoint((ids ? ids[i] : i), kMin, kMax);
+    }
+}
+
 //----------------------------------------------------------------------------
 int vtkGaussianSplatter::RequestData(
   vtkInformation* vtkNotUsed( request ),
@@ -117,12 +382,11 @@ int vtkGaussianSplatter::RequestData(
     outInfo->Get(vtkStreamingDemandDrivenPipeline::WHOLE_EXTENT()));
   output->AllocateScalars();
   
-  vtkIdType numPts, numNewPts, ptId, idx, i;
-  int j, k;
-  int min[3], max[3];
+  vtkIdType numPts, numNewPts, ptId;
+  int i, min[3], max[3];
+  double p[3];
   vtkPointData *pd;
   vtkDataArray *inNormals=NULL;
-  double loc[3], dist2, cx[3];
   vtkDoubleArray *newScalars = 
     vtkDoubleArray::SafeDownCast(output->GetPointData()->GetScalars());  
   newScalars->SetName("SplatterValues");
@@ -130,7 +394,6 @@ int vtkGaussianSplatter::RequestData(
   vtkInformation *inInfo = inputVector[0]->GetInformationObject(0);
   vtkDataSet *input = vtkDataSet::SafeDownCast(
     inInfo->Get(vtkDataObject::DATA_OBJECT()));
-  int sliceSize=this->SampleDimensions[0]*this->SampleDimensions[1];
   
   vtkDebugMacro(<< "Splatting data");
 
@@ -150,15 +413,7 @@ int vtkGaussianSplatter::RequestData(
 
   numNewPts = this->SampleDimensions[0] * this->SampleDimensions[1] *
               this->SampleDimensions[2];
-  for (i=0; i<numNewPts; i++)
-    {
-    newScalars->SetTuple(i,&this->NullValue);
-    }
-  this->Visited = new char[numNewPts];
-  for (i=0; i < numNewPts; i++)
-    {
-    this->Visited[i] = 0;
-    }
+  char *visited = new char[numNewPts];
 
   output->SetDimensions(this->GetSampleDimensions());
   this->ComputeModelBounds(input,output, outInfo);
@@ -173,94 +428,101 @@ int vtkGaussianSplatter::RequestData(
     inScalars = pd->GetScalars();
     }
 
-  //  Set up function pointers to sample functions
+  //  Use elliptical splats if there are normals
   //
-  if ( this->NormalWarping && (inNormals=pd->GetNormals()) != NULL )
-    {
-    this->Sample = &vtkGaussianSplatter::EccentricGaussian;
-    }
-  else
+  if ( this->NormalWarping )
     {
-    this->Sample = &vtkGaussianSplatter::Gaussian;
+    inNormals = pd->GetNormals();
     }
 
-  if ( this->ScalarWarping && inScalars != NULL )
-    {
-    this->SampleFactor = &vtkGaussianSplatter::ScalarSampling;
-    }
-  else
+  vtkGaussianSplatterWorker worker;
+  worker.Self = this;
+  worker.Input = input;
+  worker.Points = NULL;
+  worker.InScalars = inScalars;
+  worker.InNormals = inNormals;
+  worker.Buckets = NULL;
+  worker.NumberOfPoints = numPts;
+  worker.Scalars = newScalars->GetPointer(0);
+  worker.Visited = visited;
+  worker.Radius2 = this->Radius2;
+  worker.Eccentricity2 = this->Eccentricity2;
+  worker.ExponentFactor = this->ExponentFactor;
+  worker.ScaleFactor = this->ScaleFactor;
+  worker.ScalarWarping = this->ScalarWarping;
+  worker.AccumulationMode = this->AccumulationMode;
+  worker.NullValue = this->NullValue;
+  for (i=0; i<3; i++)
     {
-    this->SampleFactor = &vtkGaussianSplatter::PositionSampling;
-    this->S = 0.0; //position sampling does not require S to be defined
-                   //but this makes purify happy.
+    worker.Dimensions[i] = this->SampleDimensions[i];
+    worker.Origin[i] = this->Origin[i];
+    worker.Spacing[i] = this->Spacing[i];
+    worker.SplatDistance[i] = this->SplatDistance[i];
     }
 
-  // Traverse all points - splatting each into the volume.
-  // For each point, determine which voxel it is in.  Then determine
-  // the subvolume that the splat is contained in, and process that.
+  // Traverse all points - splatting each into the volume.  With several
+  // threads, the points are first sorted by the slabs of slices that
+  // their splats overlap, and each thread splats one slab.
   //
-  int abortExecute=0;
-  vtkIdType progressInterval = numPts/20 + 1;
-  for (ptId=0; ptId < numPts && !abortExecute; ptId++)
+  vtkSplatBuckets buckets;
+  int numThreads = vtkMultiThreader::GetGlobalDefaultNumberOfThreads();
+  if (numThreads > this->SampleDimensions[2])
     {
-    if ( ! (ptId % progressInterval) )
-      {
-      vtkDebugMacro(<<"Inserting point #" << ptId);
-      this->UpdateProgress (static_cast<double>(ptId)/numPts);
-      abortExecute = this->GetAbortExecute();
-      }
-
-    this->P = input->GetPoint(ptId);
-    if ( inNormals != NULL )
+    numThreads = this->SampleDimensions[2];
+    }
+  if (numThreads > 1)
+    {
+    buckets.Initialize(this->SampleDimensions[2]);
+    for (ptId=0; ptId < numPts; ptId++)
       {
-      this->N = inNormals->GetTuple(ptId);
+      input->GetPoint(ptId, p);
+      worker.Footprint(p, min, max);
+      buckets.Count(min[2], max[2]);
       }
-    if ( inScalars != NULL )
+    vtkIdType maxThreads =
+      buckets.GetNumberOfFootprintSlices() / VTK_SPLAT_SLICES_PER_THREAD;
+    if (maxThreads < numThreads)
       {
-      this->S = inScalars->GetComponent(ptId,0);
+      numThreads = (maxThreads > 1 ? static_cast<int>(maxThreads) : 1);
       }
+    }
 
-    // Determine the voxel that the point is in
-    for (i=0; i<3; i++)  
+  if (numThreads == 1)
+    {
+    worker.Execute(0);
+    }
+  else
+    {
+    buckets.Partition(numThreads);
+    for (ptId=0; ptId < numPts; ptId++)
       {
-      loc[i] = (this->P[i] - this->Origin[i]) / this->Spacing[i];
+      input->GetPoint(ptId, p);
+      worker.Footprint(p, min, max);
+      buckets.Insert(ptId, min[2], max[2]);
       }
-
-    // Determine splat footprint
-    for (i=0; i<3; i++)
+    worker.Buckets = &buckets;
+    if (!vtkPointSet::SafeDownCast(input))
       {
-      min[i] = static_cast<int>(floor(static_cast<double>(loc[i])-this->SplatDistance[i]));
-      max[i] = static_cast<int>(ceil(static_cast<double>(loc[i])+this->SplatDistance[i]));
-      if ( min[i] < 0 )
-        {
-        min[i] = 0;
-        }
-      if ( max[i] >= this->SampleDimensions[i] )
+      worker.Points = vtkPoints::New(VTK_DOUBLE);
+      worker.Points->SetNumberOfPoints(numPts);
+      for (ptId=0; ptId < numPts; ptId++)
         {
-        max[i] = this->SampleDimensions[i] - 1;
+        input->GetPoint(ptId, p);
+        worker.Points->SetPoint(ptId, p);
         }
       }
-    
-    // Loop over all sample points in volume within footprint and
-    // evaluate the splat
-    for (k=min[2]; k<=max[2]; k++)
+
+    vtkMultiThreader *threader = vtkMultiThreader::New();
+    threader->SetNumberOfThreads(numThreads);
+    threader->SetSingleMethod(vtkGaussianSplatterWorker::ThreadedExecute,
+                              &worker);
+    threader->SingleMethodExecute();
+    threader->Delete();
+    if (worker.Points)
       {
-      cx[2] = this->Origin[2] + this->Spacing[2]*k;
-      for (j=min[1]; j<=max[1]; j++)
-        {
-        cx[1] = this->Origin[1] + this->Spacing[1]*j;
-        for (i=min[0]; i<=max[0]; i++)
-          {
-          cx[0] = this->Origin[0] + this->Spacing[0]*i;
-          if ( (dist2=(this->*Sample)(cx)) <= this->Radius2 ) 
-            {
-            idx = i + j*this->SampleDimensions[0] + k*sliceSize;
-            this->SetScalar(idx,dist2, newScalars);
-            }//if within splat radius
-          }
-        }
-      }//within splat footprint
-    }//for all input points
+      worker.Points->Delete();
+      }
+    }
 
   // If capping is turned on, set the distances of the outside of the volume
   // to the CapValue.
@@ -274,7 +536,7 @@ int vtkGaussianSplatter::RequestData(
 
   // Update self and release memeory
   //
-  delete [] this->Visited;
+  delete [] visited;
 
   return 1;
 }
@@ -469,8 +731,7 @@ void vtkGaussianSplatter::Cap(vtkDoubleArray *s)
 //
 double vtkGaussianSplatter::Gaussian (double cx[3])
 {
-  return ((cx[0]-P[0])*(cx[0]-P[0]) + (cx[1]-P[1])*(cx[1]-P[1]) +
-          (cx[2]-P[2])*(cx[2]-P[2]) );
+  return vtkGaussianSplatterDistance2(cx, this->P);
 }
     
 //----------------------------------------------------------------------------
@@ -479,34 +740,9 @@ double vtkGaussianSplatter::Gaussian (double cx[3])
 //
 double vtkGaussianSplatter::EccentricGaussian (double cx[3])
 {
-  double   v[3], r2, z2, rxy2, mag;
-
-  v[0] = cx[0] - this->P[0];
-  v[1] = cx[1] - this->P[1];
-  v[2] = cx[2] - this->P[2];
-
-  r2 = v[0]*v[0] + v[1]*v[1] + v[2]*v[2];
-
-  if ( (mag=this->N[0]*this->N[0]+
-            this->N[1]*this->N[1]+
-            this->N[2]*this->N[2]) != 1.0  ) 
-    {
-    if ( mag == 0.0 )
-      {
-      mag = 1.0;
-      }
-    else
-      {
-      mag = sqrt(mag);
-      }
-    }
-
-  z2 = (v[0]*this->N[0] + v[1]*this->N[1] + v[2]*this->N[2])/mag;
-  z2 = z2*z2;
-
-  rxy2 = r2 - z2;
-
-  return (rxy2/this->Eccentricity2 + z2);
+  return vtkGaussianSplatterEccentricDistance2(
+    cx, this->P, this->N, vtkGaussianSplatterNormalMagnitude(this->N),
+    this->Eccentricity2);
 }
     
 //----------------------------------------------------------------------------
@@ -517,28 +753,8 @@ void vtkGaussianSplatter::SetScalar(int idx, double dist2,
     static_cast<double>
     (this->ExponentFactor*(dist2)/(this->Radius2)));
 
-  if ( ! this->Visited[idx] )
-    {
-    this->Visited[idx] = 1;
-    newScalars->SetTuple(idx,&v);
-    }
-  else
-    {
-    double s = newScalars->GetValue(idx);
-    switch (this->AccumulationMode)
-      {
-      case VTK_ACCUMULATION_MODE_MIN:
-        newScalars->SetTuple(idx,(s < v ? &s : &v));
-        break;
-      case VTK_ACCUMULATION_MODE_MAX:
-        newScalars->SetTuple(idx,(s > v ? &s : &v));
-        break;
-      case VTK_ACCUMULATION_MODE_SUM:
-        s += v;
-        newScalars->SetTuple(idx,&s);
-        break;
-      }
-    }//not first visit
+  vtkGaussianSplatterAccumulate(newScalars->GetPointer(0), this->Visited,
+                                idx, v, this->AccumulationMode);
 }
 
 //----------------------------------------------------------------------------
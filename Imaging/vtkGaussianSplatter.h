@@ -57,6 +57,13 @@
 // Some voxels may never receive a contribution during the splatting process.
 // The final value of these points can be specified with the "NullValue" 
 // instance variable.
+//
+// The points are splatted on the global default number of threads of
+// vtkMultiThreader.  The output is split into slabs of slices, and the
+// points are sorted by the slabs that their splats overlap, so that each
+// thread writes only into its own slab.  Each voxel combines its splats
+// in the order of the input points, so the output does not depend on the
+// number of threads.
 
 // .SECTION See Also
 // vtkShepardMethod
@@ -210,6 +217,11 @@ protected:
   double CapValue; // value to use for capping
   int AccumulationMode; // how to combine scalar values
 
+  // Description:
+  // Sample the splat of the point P with normal N and scalar S, and
+  // combine it into a voxel that has been visited or not.  RequestData()
+  // splats on several threads, so it does not use this state; its threads
+  // call the same inline functions as these methods.
   double Gaussian(double x[3]);  
   double EccentricGaussian(double x[3]);  
   double ScalarSampling(double s) 
@@ -14,19 +14,41 @@
 =========================================================================*/
 #include "vtkImageAccumulate.h"
 
+#include "vtkExtentTranslator.h"
+#include "vtkIdTypeArray.h"
 #include "vtkImageData.h"
 #include "vtkImageStencilData.h"
 #include "vtkImageStencilIterator.h"
 #include "vtkInformation.h"
 #include "vtkInformationVector.h"
+#include "vtkIntArray.h"
 #include "vtkMath.h"
+#include "vtkMultiThreader.h"
 #include "vtkObjectFactory.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
+#include "vtkTable.h"
 
+#include <vtksys/hash_map.hxx> // sparse bins
+#include <vtkstd/algorithm>
+#include <vtkstd/vector>
 #include <math.h>
 
+// The number of voxels accumulated by each thread
+#define VTK_ACCUMULATE_VOXELS_PER_THREAD 65536
+
 vtkStandardNewMacro(vtkImageAccumulate);
 
+//----------------------------------------------------------------------------
+// The counts of the non-empty bins, by bin index.
+struct vtkImageAccumulateIdTypeHash
+{
+  size_t operator()(vtkIdType val) const { return static_cast<size_t>(val); }
+};
+class vtkImageAccumulateSparseBins :
+  public vtksys::hash_map<vtkIdType, vtkIdType, vtkImageAccumulateIdTypeHash>
+{
+};
+
 //----------------------------------------------------------------------------
 // Constructor sets default values
 vtkImageAccumulate::vtkImageAccumulate()
@@ -50,14 +72,24 @@ vtkImageAccumulate::vtkImageAccumulate()
   this->VoxelCount = 0;
   this->IgnoreZero = 0;
 
+  this->SparseOutput = 0;
+  this->NumberOfStreamDivisions = 1;
+  this->CurrentStreamDivision = 0;
+  this->Sum[0] = this->Sum[1] = this->Sum[2] = 0.0;
+  this->SumOfSquares[0] = this->SumOfSquares[1] = this->SumOfSquares[2] = 0.0;
+  this->SparseBins = new vtkImageAccumulateSparseBins;
+
   // we have the image input and the optional stencil input
   this->SetNumberOfInputPorts(2);
+  // the image output and the table of sparse bins
+  this->SetNumberOfOutputPorts(2);
 }
 
 
 //----------------------------------------------------------------------------
 vtkImageAccumulate::~vtkImageAccumulate()
 {
+  delete this->SparseBins;
 }
 
 //----------------------------------------------------------------------------
@@ -123,56 +155,71 @@ vtkImageStencilData *vtkImageAccumulate::GetStencil()
 }
 
 
+//----------------------------------------------------------------------------
+vtkTable *vtkImageAccumulate::GetSparseHistogram()
+{
+  return vtkTable::SafeDownCast(this->GetOutputDataObject(1));
+}
+
+
+//----------------------------------------------------------------------------
+// The layout of the bins: the bin of a pixel is computed from its
+// components with the origin and spacing, and must lie within the extent.
+struct vtkImageAccumulateBins
+{
+  int NumberOfComponents;
+  double Origin[3];
+  double Spacing[3];
+  int Extent[6];
+  vtkIdType Increments[3];
+};
+
+//----------------------------------------------------------------------------
+// The part of the input accumulated by one thread, with its statistics and
+// its own histogram.
+struct vtkImageAccumulatePiece
+{
+  int Extent[6];
+  double Sum[3];
+  double SumOfSquares[3];
+  double Min[3];
+  double Max[3];
+  vtkIdType VoxelCount;
+  vtkstd::vector<int> Dense;
+  vtkImageAccumulateSparseBins Sparse;
+};
+
 //----------------------------------------------------------------------------
 // This templated function executes the filter for any type of data.
+// The counts are added to the histogram, or to the sparse bins of the
+// piece when the histogram is NULL.
 template <class T>
 void vtkImageAccumulateExecute(vtkImageAccumulate *self,
                                vtkImageData *inData, T *,
-                               vtkImageData *outData, int *outPtr,
-                               double min[3], double max[3],
-                               double mean[3],
-                               double standardDeviation[3],
-                               vtkIdType *voxelCount,
-                               int* updateExtent)
+                               vtkImageStencilData *stencil,
+                               const vtkImageAccumulateBins *bins,
+                               vtkImageAccumulatePiece *piece,
+                               int *outPtr, int threadId)
 {
   // variables used to compute statistics (filter handles max 3 components)
-  double sum[3];
-  sum[0] = sum[1] = sum[2] = 0.0;
-  double sumSqr[3];
-  sumSqr[0] = sumSqr[1] = sumSqr[2] = 0.0;
-  min[0] = min[1] = min[2] = VTK_DOUBLE_MAX;
-  max[0] = max[1] = max[2] = VTK_DOUBLE_MIN;
-  standardDeviation[0] = standardDeviation[1] = standardDeviation[2] = 0.0;
-  *voxelCount = 0;
+  double *sum = piece->Sum;
+  double *sumSqr = piece->SumOfSquares;
+  double *min = piece->Min;
+  double *max = piece->Max;
+  vtkIdType *voxelCount = &piece->VoxelCount;
 
   // input's number of components is used as output dimensionality
-  int numC = inData->GetNumberOfScalarComponents();
+  int numC = bins->NumberOfComponents;
+  const int *outExtent = bins->Extent;
+  const vtkIdType *outIncs = bins->Increments;
+  const double *origin = bins->Origin;
+  const double *spacing = bins->Spacing;
 
-  // get information for output data
-  int outExtent[6];
-  outData->GetExtent(outExtent);
-  vtkIdType outIncs[3];
-  outData->GetIncrements(outIncs);
-  double origin[3];
-  outData->GetOrigin(origin);
-  double spacing[3];
-  outData->GetSpacing(spacing);
-
-  // zero count in every bin
-  vtkIdType size = 1;
-  size *= (outExtent[1] - outExtent[0] + 1);
-  size *= (outExtent[3] - outExtent[2] + 1);
-  size *= (outExtent[5] - outExtent[4] + 1);
-  for (vtkIdType j = 0; j < size; j++)
-    {
-    outPtr[j] = 0;
-    }
-
-  vtkImageStencilData *stencil = self->GetStencil();
   bool reverseStencil = (self->GetReverseStencil() != 0);
   bool ignoreZero = (self->GetIgnoreZero() != 0);
 
-  vtkImageStencilIterator<T> inIter(inData, stencil, updateExtent, self);
+  vtkImageStencilIterator<T> inIter(inData, stencil, piece->Extent, self,
+                                    threadId);
 
   while (!inIter.IsAtEnd())
     {
@@ -185,7 +232,7 @@ void vtkImageAccumulateExecute(vtkImageAccumulate *self,
         {
         // find the bin for this pixel.
         bool outOfBounds = false;
-        int *outPtrC = outPtr;
+        vtkIdType binId = 0;
         for (int idxC = 0; idxC < numC; ++idxC)
           {
           double v = static_cast<double>(*inPtr++);
@@ -211,7 +258,7 @@ void vtkImageAccumulateExecute(vtkImageAccumulate *self,
           // verify that it is in range
           if (outIdx >= outExtent[idxC*2] && outIdx <= outExtent[idxC*2+1])
             {
-            outPtrC += (outIdx - outExtent[idxC*2]) * outIncs[idxC];
+            binId += (outIdx - outExtent[idxC*2]) * outIncs[idxC];
             }
           else
             {
@@ -222,55 +269,82 @@ void vtkImageAccumulateExecute(vtkImageAccumulate *self,
         // increment the bin
         if (!outOfBounds)
           {
-          ++(*outPtrC);
+          if (outPtr)
+            {
+            ++outPtr[binId];
+            }
+          else
+            {
+            ++piece->Sparse[binId];
+            }
           }
         }
       }
 
     inIter.NextSpan();
     }
+}
 
-  // initialize the statistics
-  mean[0] = 0;
-  mean[1] = 0;
-  mean[2] = 0;
-
-  standardDeviation[0] = 0;
-  standardDeviation[1] = 0;
-  standardDeviation[2] = 0;
-
-  if (*voxelCount != 0) // avoid the div0
+//----------------------------------------------------------------------------
+// The pieces of the input, one per thread.
+class vtkImageAccumulateWorker
+{
+public:
+  vtkImageAccumulate *Self;
+  vtkImageData *InData;
+  vtkImageStencilData *Stencil;
+  vtkImageAccumulateBins Bins;
+  vtkstd::vector<vtkImageAccumulatePiece> Pieces;
+  int *Histogram;
+
+  void Execute(int threadId)
     {
-    double n = static_cast<double>(*voxelCount);
-    mean[0] = sum[0]/n;
-    mean[1] = sum[1]/n;
-    mean[2] = sum[2]/n;
-
-    if (*voxelCount - 1 != 0) // avoid the div0
+    vtkImageAccumulatePiece *piece = &this->Pieces[threadId];
+    if (piece->Extent[0] > piece->Extent[1] ||
+        piece->Extent[2] > piece->Extent[3] ||
+        piece->Extent[4] > piece->Extent[5])
       {
-      double m = static_cast<double>(*voxelCount - 1);
-      standardDeviation[0] = sqrt((sumSqr[0] - mean[0]*mean[0]*n)/m);
-      standardDeviation[1] = sqrt((sumSqr[1] - mean[1]*mean[1]*n)/m);
-      standardDeviation[2] = sqrt((sumSqr[2] - mean[2]*mean[2]*n)/m);
+      return;
+      }
+    // the first thread counts directly into the output
+    int *outPtr = NULL;
+    if (this->Histogram)
+      {
+      outPtr = (threadId == 0 ? this->Histogram : &piece->Dense[0]);
+      }
+    void *inPtr = this->InData->GetScalarPointerForExtent(piece->Extent);
+    switch (this->InData->GetScalarType())
+      {
+      vtkTemplateMacro(
+        vtkImageAccumulateExecute(this->Self, this->InData,
+                                  static_cast<VTK_TT *>(inPtr),
+                                  this->Stencil, &this->Bins, piece,
+                                  outPtr, threadId));
       }
     }
 
-}
+  static VTK_THREAD_RETURN_TYPE ThreadedExecute(void *arg)
+    {
+    vtkMultiThreader::ThreadInfo *info =
+      static_cast<vtkMultiThreader::ThreadInfo *>(arg);
+    vtkImageAccumulateWorker *self =
+      static_cast<vtkImageAccumulateWorker *>(info->UserData);
+    self->Execute(info->ThreadID);
+    return VTK_THREAD_RETURN_VALUE;
+    }
+};
 
 
 //----------------------------------------------------------------------------
 // This method is passed a input and output Data, and executes the filter
-// algorithm to fill the output from the input.
-// It just executes a switch statement to call the correct function for
-// the Datas data types.
+// algorithm to fill the output from the input.  When the input is read
+// in several pieces, it is called once per piece, and the statistics are
+// computed after the last one.
 int vtkImageAccumulate::RequestData(
-  vtkInformation* vtkNotUsed( request ),
+  vtkInformation* request,
   vtkInformationVector** inputVector,
   vtkInformationVector* outputVector)
 {
-  void *inPtr;
-  void *outPtr;
-
   // get the input
   vtkInformation* in1Info = inputVector[0]->GetInformationObject(0);
   vtkImageData *inData = vtkImageData::SafeDownCast(
@@ -284,45 +358,274 @@ int vtkImageAccumulate::RequestData(
 
   vtkDebugMacro(<<"Executing image accumulate");
 
-  // We need to allocate our own scalars since we are overriding
-  // the superclasses "Execute()" method.
-  outData->SetExtent(outData->GetWholeExtent());
-  outData->AllocateScalars();
-
-  vtkDataArray *inArray = this->GetInputArrayToProcess(0,inputVector);
-  inPtr = inData->GetArrayPointerForExtent(inArray, uExt);
-  outPtr = outData->GetScalarPointer();
+  int idx;
+  int numC = inData->GetNumberOfScalarComponents();
 
   // Components turned into x, y and z
-  if (inData->GetNumberOfScalarComponents() > 3)
+  if (numC > 3)
     {
     vtkErrorMacro("This filter can handle up to 3 components");
     return 1;
     }
 
-  // this filter expects that output is type int.
-  if (outData->GetScalarType() != VTK_INT)
+  // The first piece starts the histogram and the statistics
+  if (this->CurrentStreamDivision == 0)
+    {
+    // We need to allocate our own scalars since we are overriding
+    // the superclasses "Execute()" method.
+    outData->SetExtent(outData->GetWholeExtent());
+    outData->AllocateScalars();
+
+    // this filter expects that output is type int.
+    if (outData->GetScalarType() != VTK_INT)
+      {
+      vtkErrorMacro(<< "Execute: out ScalarType " << outData->GetScalarType()
+                    << " must be int\n");
+      return 1;
+      }
+
+    // zero count in every bin
+    int *outPtr = static_cast<int *>(outData->GetScalarPointer());
+    vtkIdType size = outData->GetNumberOfPoints();
+    for (vtkIdType j = 0; j < size; j++)
+      {
+      outPtr[j] = 0;
+      }
+    this->SparseBins->clear();
+
+    for (idx = 0; idx < 3; ++idx)
+      {
+      this->Sum[idx] = 0.0;
+      this->SumOfSquares[idx] = 0.0;
+      this->Min[idx] = VTK_DOUBLE_MAX;
+      this->Max[idx] = VTK_DOUBLE_MIN;
+      }
+    this->VoxelCount = 0;
+
+    if (this->NumberOfStreamDivisions > 1)
+      {
+      // Tell the pipeline to start looping.
+      request->Set(vtkStreamingDemandDrivenPipeline::CONTINUE_EXECUTING(), 1);
+      }
+    }
+
+  vtkImageAccumulateWorker worker;
+  worker.Self = this;
+  worker.InData = inData;
+  worker.Stencil = this->GetStencil();
+  worker.Histogram = NULL;
+  if (!this->SparseOutput)
+    {
+    worker.Histogram = static_cast<int *>(outData->GetScalarPointer());
+    }
+
+  // The layout of the bins is the one of the output image
+  vtkImageAccumulateBins *bins = &worker.Bins;
+  bins->NumberOfComponents = numC;
+  vtkIdType numBins = 1;
+  for (idx = 0; idx < 3; ++idx)
+    {
+    bins->Origin[idx] = this->ComponentOrigin[idx];
+    bins->Spacing[idx] = this->ComponentSpacing[idx];
+    bins->Extent[2*idx] = this->ComponentExtent[2*idx];
+    bins->Extent[2*idx+1] = this->ComponentExtent[2*idx+1];
+    bins->Increments[idx] = numBins;
+    numBins *= (this->ComponentExtent[2*idx+1] -
+                this->ComponentExtent[2*idx] + 1);
+    }
+
+  // Split the piece among the threads.  Dense histograms need enough
+  // voxels per thread to pay for their own copy of the bins.
+  vtkIdType numVoxels = 0;
+  if (uExt[0] <= uExt[1] && uExt[2] <= uExt[3] && uExt[4] <= uExt[5])
+    {
+    numVoxels = static_cast<vtkIdType>(uExt[1] - uExt[0] + 1)*
+      (uExt[3] - uExt[2] + 1)*(uExt[5] - uExt[4] + 1);
+    }
+  int numThreads = vtkMultiThreader::GetGlobalDefaultNumberOfThreads();
+  vtkIdType voxelsPerThread = VTK_ACCUMULATE_VOXELS_PER_THREAD;
+  if (worker.Histogram && numBins > voxelsPerThread)
+    {
+    voxelsPerThread = numBins;
+    }
+  vtkIdType maxThreads = numVoxels / voxelsPerThread;
+  if (maxThreads < numThreads)
+    {
+    numThreads = (maxThreads > 1 ? static_cast<int>(maxThreads) : 1);
+    }
+
+  worker.Pieces.resize(numThreads);
+  vtkExtentTranslator *translator = vtkExtentTranslator::New();
+  translator->SetWholeExtent(uExt);
+  translator->SetNumberOfPieces(numThreads);
+  int i;
+  for (i = 0; i < numThreads; i++)
+    {
+    vtkImageAccumulatePiece *piece = &worker.Pieces[i];
+    translator->SetPiece(i);
+    if (numVoxels > 0 && translator->PieceToExtentByPoints())
+      {
+      translator->GetExtent(piece->Extent);
+      }
+    else
+      {
+      piece->Extent[0] = piece->Extent[2] = piece->Extent[4] = 0;
+      piece->Extent[1] = piece->Extent[3] = piece->Extent[5] = -1;
+      }
+    for (idx = 0; idx < 3; ++idx)
+      {
+      piece->Sum[idx] = 0.0;
+      piece->SumOfSquares[idx] = 0.0;
+      piece->Min[idx] = VTK_DOUBLE_MAX;
+      piece->Max[idx] = VTK_DOUBLE_MIN;
+      }
+    piece->VoxelCount = 0;
+    if (worker.Histogram && i > 0)
+      {
+      piece->Dense.resize(numBins, 0);
+      }
+    }
+  translator->Delete();
+
+  if (numThreads == 1)
+    {
+    worker.Execute(0);
+    }
+  else
+    {
+    vtkMultiThreader *threader = vtkMultiThreader::New();
+    threader->SetNumberOfThreads(numThreads);
+    threader->SetSingleMethod(vtkImageAccumulateWorker::ThreadedExecute,
+                              &worker);
+    threader->SingleMethodExecute();
+    threader->Delete();
+    }
+
+  // Add the histograms and the statistics of the threads
+  for (i = 0; i < numThreads; i++)
+    {
+    vtkImageAccumulatePiece *piece = &worker.Pieces[i];
+    for (idx = 0; idx < 3; ++idx)
+      {
+      this->Sum[idx] += piece->Sum[idx];
+      this->SumOfSquares[idx] += piece->SumOfSquares[idx];
+      if (piece->Min[idx] < this->Min[idx])
+        {
+        this->Min[idx] = piece->Min[idx];
+        }
+      if (piece->Max[idx] > this->Max[idx])
+        {
+        this->Max[idx] = piece->Max[idx];
+        }
+      }
+    this->VoxelCount += piece->VoxelCount;
+    if (worker.Histogram && i > 0)
+      {
+      for (vtkIdType j = 0; j < numBins; j++)
+        {
+        worker.Histogram[j] += piece->Dense[j];
+        }
+      }
+    vtkImageAccumulateSparseBins::iterator iter;
+    for (iter = piece->Sparse.begin(); iter != piece->Sparse.end(); ++iter)
+      {
+      (*this->SparseBins)[iter->first] += iter->second;
+      }
+    }
+
+  if (this->NumberOfStreamDivisions > 1)
+    {
+    this->UpdateProgress(
+      static_cast<double>(this->CurrentStreamDivision + 1.0)/
+      static_cast<double>(this->NumberOfStreamDivisions));
+    }
+  this->CurrentStreamDivision++;
+  if (this->CurrentStreamDivision < this->NumberOfStreamDivisions)
     {
-    vtkErrorMacro(<< "Execute: out ScalarType " << outData->GetScalarType()
-                  << " must be int\n");
     return 1;
     }
 
-  switch (inData->GetScalarType())
+  // This was the last piece
+  if (this->NumberOfStreamDivisions > 1)
     {
-    vtkTemplateMacro(vtkImageAccumulateExecute( this,
-                                                inData,
-                                                static_cast<VTK_TT *>(inPtr),
-                                                outData,
-                                                static_cast<int *>(outPtr),
-                                                this->Min, this->Max,
-                                                this->Mean,
-                                                this->StandardDeviation,
-                                                &this->VoxelCount,
-                                                uExt ));
-    default:
-      vtkErrorMacro(<< "Execute: Unknown ScalarType");
-      return 1;
+    // Tell the pipeline to stop looping.
+    request->Remove(vtkStreamingDemandDrivenPipeline::CONTINUE_EXECUTING());
+    }
+  this->CurrentStreamDivision = 0;
+
+  // compute the statistics
+  for (idx = 0; idx < 3; ++idx)
+    {
+    this->Mean[idx] = 0.0;
+    this->StandardDeviation[idx] = 0.0;
+    }
+  if (this->VoxelCount != 0) // avoid the div0
+    {
+    double n = static_cast<double>(this->VoxelCount);
+    for (idx = 0; idx < 3; ++idx)
+      {
+      this->Mean[idx] = this->Sum[idx]/n;
+      }
+
+    if (this->VoxelCount - 1 != 0) // avoid the div0
+      {
+      double m = static_cast<double>(this->VoxelCount - 1);
+      for (idx = 0; idx < 3; ++idx)
+        {
+        this->StandardDeviation[idx] = sqrt(
+          (this->SumOfSquares[idx] - this->Mean[idx]*this->Mean[idx]*n)/m);
+        }
+      }
+    }
+
+  // list the non-empty bins, sorted by index
+  vtkTable *table = this->GetSparseHistogram();
+  table->Initialize();
+  if (this->SparseOutput)
+    {
+    vtkstd::vector<vtkIdType> binIds;
+    binIds.reserve(this->SparseBins->size());
+    vtkImageAccumulateSparseBins::iterator iter;
+    for (iter = this->SparseBins->begin(); iter != this->SparseBins->end();
+         ++iter)
+      {
+      binIds.push_back(iter->first);
+      }
+    vtkstd::sort(binIds.begin(), binIds.end());
+
+    vtkIdType numNonEmpty = static_cast<vtkIdType>(binIds.size());
+    vtkIntArray *binColumns[3];
+    for (idx = 0; idx < numC; ++idx)
+      {
+      char name[8] = "Bin0";
+      name[3] = static_cast<char>('0' + idx);
+      binColumns[idx] = vtkIntArray::New();
+      binColumns[idx]->SetName(name);
+      binColumns[idx]->SetNumberOfTuples(numNonEmpty);
+      }
+    vtkIdTypeArray *counts = vtkIdTypeArray::New();
+    counts->SetName("Count");
+    counts->SetNumberOfTuples(numNonEmpty);
+    for (vtkIdType j = 0; j < numNonEmpty; j++)
+      {
+      vtkIdType binId = binIds[j];
+      for (idx = 0; idx < numC; ++idx)
+        {
+        int dim = bins->Extent[2*idx+1] - bins->Extent[2*idx] + 1;
+        binColumns[idx]->SetValue(
+          j, static_cast<int>(binId % dim) + bins->Extent[2*idx]);
+        binId /= dim;
+        }
+      counts->SetValue(j, (*this->SparseBins)[binIds[j]]);
+      }
+    for (idx = 0; idx < numC; ++idx)
+      {
+      table->AddColumn(binColumns[idx]);
+      binColumns[idx]->Delete();
+      }
+    table->AddColumn(counts);
+    counts->Delete();
+    this->SparseBins->clear();
     }
 
   return 1;
@@ -338,8 +641,10 @@ int vtkImageAccumulate::RequestInformation (
   // get the info objects
   vtkInformation* outInfo = outputVector->GetInformationObject(0);
 
+  // the output image is empty when the bins are listed in the table
+  int emptyExtent[6] = {0,-1,0,-1,0,-1};
   outInfo->Set(vtkStreamingDemandDrivenPipeline::WHOLE_EXTENT(),
-               this->ComponentExtent,6);
+               (this->SparseOutput ? emptyExtent : this->ComponentExtent),6);
   outInfo->Set(vtkDataObject::ORIGIN(),this->ComponentOrigin,3);
   outInfo->Set(vtkDataObject::SPACING(),this->ComponentSpacing,3);
 
@@ -348,7 +653,7 @@ int vtkImageAccumulate::RequestInformation (
 }
 
 //----------------------------------------------------------------------------
-// Get ALL of the input.
+// Get ALL of the input, or the current piece of it when streaming.
 int vtkImageAccumulate::RequestUpdateExtent (
   vtkInformation* vtkNotUsed(request),
   vtkInformationVector** inputVector,
@@ -367,6 +672,23 @@ int vtkImageAccumulate::RequestUpdateExtent (
   // input.
   int extent[6] = {0,-1,0,-1,0,-1};
   inInfo->Get(vtkStreamingDemandDrivenPipeline::WHOLE_EXTENT(), extent);
+  if (this->NumberOfStreamDivisions > 1)
+    {
+    vtkExtentTranslator *translator = vtkExtentTranslator::New();
+    translator->SetWholeExtent(extent);
+    translator->SetNumberOfPieces(this->NumberOfStreamDivisions);
+    translator->SetPiece(this->CurrentStreamDivision);
+    if (translator->PieceToExtentByPoints())
+      {
+      translator->GetExtent(extent);
+      }
+    else
+      {
+      extent[0] = extent[2] = extent[4] = 0;
+      extent[1] = extent[3] = extent[5] = -1;
+      }
+    translator->Delete();
+    }
   inInfo->Set(vtkStreamingDemandDrivenPipeline::UPDATE_EXTENT(), extent, 6);
   if(stencilInfo)
     {
@@ -393,6 +715,18 @@ int vtkImageAccumulate::FillInputPortInformation(
   return 1;
 }
 
+//----------------------------------------------------------------------------
+int vtkImageAccumulate::FillOutputPortInformation(
+  int port, vtkInformation* info)
+{
+  if (port == 1)
+    {
+    info->Set(vtkDataObject::DATA_TYPE_NAME(), "vtkTable");
+    return 1;
+    }
+  return this->Superclass::FillOutputPortInformation(port, info);
+}
+
 //----------------------------------------------------------------------------
 void vtkImageAccumulate::PrintSelf(ostream& os, vtkIndent indent)
 {
@@ -419,6 +753,10 @@ void vtkImageAccumulate::PrintSelf(ostream& os, vtkIndent indent)
   os << indent << "ReverseStencil: " << (this->ReverseStencil ?
                                          "On\n" : "Off\n");
   os << indent << "IgnoreZero: " << (this->IgnoreZero ? "On" : "Off") << "\n";
+  os << indent << "SparseOutput: "
+     << (this->SparseOutput ? "On" : "Off") << "\n";
+  os << indent << "NumberOfStreamDivisions: "
+     << this->NumberOfStreamDivisions << "\n";
 
   os << indent << "ComponentOrigin: ( "
      << this->ComponentOrigin[0] << ", "
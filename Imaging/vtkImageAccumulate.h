@@ -31,6 +31,13 @@
 // option with vtkImageMask may result in results being slightly off since 0
 // could be a valid value from your input.
 //
+// The input is split among several threads, each with its own histogram,
+// and the histograms are summed at the end.  The input can also be read
+// in several pieces, one pipeline pass each, so that the histograms of
+// volumes that do not fit in memory can be computed.  For joint
+// histograms with many bins, the non-empty bins can be listed in a
+// vtkTable on the second output instead of filling the output image.
+//
 // .SECTION see also vtkImageMask
 
 #ifndef __vtkImageAccumulate_h
@@ -39,6 +46,10 @@
 #include "vtkImageAlgorithm.h"
 
 class vtkImageStencilData;
+class vtkTable;
+//BTX
+class vtkImageAccumulateSparseBins;
+//ETX
 
 class VTK_IMAGING_EXPORT vtkImageAccumulate : public vtkImageAlgorithm
 {
@@ -113,6 +124,27 @@ public:
   vtkGetMacro(IgnoreZero, int);
   vtkBooleanMacro(IgnoreZero, int);
 
+  // Description:
+  // When on, the non-empty bins are listed in the vtkTable of the second
+  // output, and the output image is left empty.  The table has one
+  // column of bin indices for each input component, named "Bin0", "Bin1"
+  // and "Bin2", and a "Count" column, with the bins sorted by index.
+  // Initial value is false.
+  vtkSetMacro(SparseOutput, int);
+  vtkGetMacro(SparseOutput, int);
+  vtkBooleanMacro(SparseOutput, int);
+
+  // Description:
+  // Get the table of non-empty bins computed when SparseOutput is on.
+  vtkTable *GetSparseHistogram();
+
+  // Description:
+  // Read the input in this many pieces, one pipeline pass each, and
+  // accumulate the histogram and the statistics across the pieces.
+  // Initial value is 1, which reads the whole input at once.
+  vtkSetClampMacro(NumberOfStreamDivisions, int, 1, VTK_INT_MAX);
+  vtkGetMacro(NumberOfStreamDivisions, int);
+
 protected:
   vtkImageAccumulate();
   ~vtkImageAccumulate();
@@ -140,7 +172,17 @@ protected:
 
   int ReverseStencil;
 
+  int SparseOutput;
+  int NumberOfStreamDivisions;
+  int CurrentStreamDivision;
+
+  // The sums and the sparse bins of the pieces read so far.
+  double Sum[3];
+  double SumOfSquares[3];
+  vtkImageAccumulateSparseBins *SparseBins;
+
   virtual int FillInputPortInformation(int port, vtkInformation* info);
+  virtual int FillOutputPortInformation(int port, vtkInformation* info);
 
 private:
   vtkImageAccumulate(const vtkImageAccumulate&);  // Not implemented.
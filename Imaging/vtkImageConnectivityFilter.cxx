@@ -0,0 +1,638 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkImageConnectivityFilter.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+#include "vtkImageConnectivityFilter.h"
+
+#include "vtkDataObject.h"
+#include "vtkDoubleArray.h"
+#include "vtkIdTypeArray.h"
+#include "vtkImageData.h"
+#include "vtkInformation.h"
+#include "vtkInformationVector.h"
+#include "vtkIntArray.h"
+#include "vtkMultiThreader.h"
+#include "vtkObjectFactory.h"
+#include "vtkStreamingDemandDrivenPipeline.h"
+
+#include <vtkstd/algorithm>
+#include <vtkstd/vector>
+
+// The number of voxels labeled by each thread
+#define VTK_CONNECTIVITY_VOXELS_PER_THREAD 65536
+
+vtkStandardNewMacro(vtkImageConnectivityFilter);
+
+//----------------------------------------------------------------------------
+vtkImageConnectivityFilter::vtkImageConnectivityFilter()
+{
+  this->ScalarRange[0] = 0.5;
+  this->ScalarRange[1] = VTK_DOUBLE_MAX;
+  this->Connectivity = 6;
+  this->ExtractionMode = VTK_IMAGE_CONNECTIVITY_ALL_REGIONS;
+  this->NumberOfLargestRegions = 1;
+  this->MinimumRegionSize = 1;
+  this->LabelScalarType = VTK_INT;
+
+  this->Seeds = vtkIntArray::New();
+  this->Seeds->SetNumberOfComponents(3);
+  this->ExtractedRegionSizes = vtkIdTypeArray::New();
+  this->ExtractedRegionExtents = vtkIntArray::New();
+  this->ExtractedRegionExtents->SetNumberOfComponents(6);
+  this->ExtractedRegionCentroids = vtkDoubleArray::New();
+  this->ExtractedRegionCentroids->SetNumberOfComponents(3);
+}
+
+//----------------------------------------------------------------------------
+vtkImageConnectivityFilter::~vtkImageConnectivityFilter()
+{
+  this->Seeds->Delete();
+  this->ExtractedRegionSizes->Delete();
+  this->ExtractedRegionExtents->Delete();
+  this->ExtractedRegionCentroids->Delete();
+}
+
+//----------------------------------------------------------------------------
+void vtkImageConnectivityFilter::AddSeed(int i, int j, int k)
+{
+  int seed[3] = { i, j, k };
+  this->Seeds->InsertNextTupleValue(seed);
+  this->Modified();
+}
+
+//----------------------------------------------------------------------------
+void vtkImageConnectivityFilter::RemoveAllSeeds()
+{
+  if (this->Seeds->GetNumberOfTuples() > 0)
+    {
+    this->Seeds->Reset();
+    this->Modified();
+    }
+}
+
+//----------------------------------------------------------------------------
+vtkIdType vtkImageConnectivityFilter::GetNumberOfExtractedRegions()
+{
+  return this->ExtractedRegionSizes->GetNumberOfTuples();
+}
+
+//----------------------------------------------------------------------------
+const char *vtkImageConnectivityFilter::GetExtractionModeAsString()
+{
+  switch (this->ExtractionMode)
+    {
+    case VTK_IMAGE_CONNECTIVITY_LARGEST_REGIONS:
+      return "LargestRegions";
+    case VTK_IMAGE_CONNECTIVITY_SEEDED_REGIONS:
+      return "SeededRegions";
+    default:
+      return "AllRegions";
+    }
+}
+
+//----------------------------------------------------------------------------
+int vtkImageConnectivityFilter::RequestInformation(
+  vtkInformation *vtkNotUsed(request),
+  vtkInformationVector **vtkNotUsed(inputVector),
+  vtkInformationVector *outputVector)
+{
+  vtkInformation *outInfo = outputVector->GetInformationObject(0);
+  vtkDataObject::SetPointDataActiveScalarInfo(outInfo, this->LabelScalarType,
+                                              1);
+  return 1;
+}
+
+//----------------------------------------------------------------------------
+// The whole input is needed to label any part of the output.
+int vtkImageConnectivityFilter::RequestUpdateExtent(
+  vtkInformation *vtkNotUsed(request),
+  vtkInformationVector **inputVector,
+  vtkInformationVector *vtkNotUsed(outputVector))
+{
+  vtkInformation *inInfo = inputVector[0]->GetInformationObject(0);
+  inInfo->Set(vtkStreamingDemandDrivenPipeline::UPDATE_EXTENT(),
+              inInfo->Get(vtkStreamingDemandDrivenPipeline::WHOLE_EXTENT()),
+              6);
+  return 1;
+}
+
+//----------------------------------------------------------------------------
+// The union-find works on the voxel indices: each labeled voxel points to
+// a voxel of its region with a smaller index, the root of the region
+// points to itself, and the other voxels are set to -1.  Since parents
+// always have smaller indices, the regions of separate slabs can be
+// labeled at the same time.
+static inline vtkIdType vtkImageConnectivityFilterFind(vtkIdType *parent,
+                                                       vtkIdType v)
+{
+  while (parent[v] != v)
+    {
+    // path halving
+    parent[v] = parent[parent[v]];
+    v = parent[v];
+    }
+  return v;
+}
+
+//----------------------------------------------------------------------------
+static inline void vtkImageConnectivityFilterUnion(vtkIdType *parent,
+                                                   vtkIdType a, vtkIdType b)
+{
+  a = vtkImageConnectivityFilterFind(parent, a);
+  b = vtkImageConnectivityFilterFind(parent, b);
+  if (a < b)
+    {
+    parent[b] = a;
+    }
+  else if (b < a)
+    {
+    parent[a] = b;
+    }
+}
+
+//----------------------------------------------------------------------------
+// The neighbors of a voxel that come before it in the volume.
+class vtkImageConnectivityFilterNeighbors
+{
+public:
+  int Count;
+  int Delta[13][3];
+  vtkIdType Offset[13];
+
+  void Build(int connectivity, const int dims[3])
+    {
+    int maxDistance = (connectivity == 26 ? 3 : (connectivity == 18 ? 2 : 1));
+    this->Count = 0;
+    for (int k = -1; k <= 0; k++)
+      {
+      for (int j = -1; j <= 1; j++)
+        {
+        for (int i = -1; i <= 1; i++)
+          {
+          if ((k == 0 && (j > 0 || (j == 0 && i >= 0))) ||
+              (i != 0) + (j != 0) + (k != 0) > maxDistance)
+            {
+            continue;
+            }
+          this->Delta[this->Count][0] = i;
+          this->Delta[this->Count][1] = j;
+          this->Delta[this->Count][2] = k;
+          this->Offset[this->Count] =
+            i + static_cast<vtkIdType>(dims[0])*(j + dims[1]*k);
+          this->Count++;
+          }
+        }
+      }
+    }
+
+  // Join voxel v at (x,y,z) to its neighbors, with slices below zMin
+  // left out.
+  void Join(vtkIdType *parent, vtkIdType v, int x, int y, int z, int zMin,
+            const int dims[3], int onlyBelow) const
+    {
+    for (int n = 0; n < this->Count; n++)
+      {
+      const int *d = this->Delta[n];
+      if ((onlyBelow && d[2] == 0) ||
+          x + d[0] < 0 || x + d[0] >= dims[0] ||
+          y + d[1] < 0 || y + d[1] >= dims[1] || z + d[2] < zMin)
+        {
+        continue;
+        }
+      vtkIdType u = v + this->Offset[n];
+      if (parent[u] >= 0)
+        {
+        vtkImageConnectivityFilterUnion(parent, v, u);
+        }
+      }
+    }
+};
+
+//----------------------------------------------------------------------------
+// Label the slices zMin to zMax on their own.
+template <class T>
+void vtkImageConnectivityFilterScan(
+  const T *inPtr, const vtkIdType inInc[3], const int dims[3],
+  const double range[2], const vtkImageConnectivityFilterNeighbors &hood,
+  vtkIdType *parent, int zMin, int zMax)
+{
+  for (int z = zMin; z <= zMax; z++)
+    {
+    for (int y = 0; y < dims[1]; y++)
+      {
+      const T *inPtr0 = inPtr + z*inInc[2] + y*inInc[1];
+      vtkIdType v = static_cast<vtkIdType>(dims[0])*(y + dims[1]*z);
+      for (int x = 0; x < dims[0]; x++, v++, inPtr0 += inInc[0])
+        {
+        double value = static_cast<double>(*inPtr0);
+        if (value < range[0] || value > range[1])
+          {
+          parent[v] = -1;
+          continue;
+          }
+        parent[v] = v;
+        hood.Join(parent, v, x, y, z, zMin, dims, 0);
+        }
+      }
+    }
+}
+
+//----------------------------------------------------------------------------
+// Write the labels of the slices zMin to zMax, where the parents have been
+// replaced by region ids.
+template <class OT>
+void vtkImageConnectivityFilterLabel(
+  OT *outPtr, const int dims[3], const vtkIdType *region,
+  const vtkIdType *labels, int zMin, int zMax)
+{
+  vtkIdType sliceSize = static_cast<vtkIdType>(dims[0])*dims[1];
+  vtkIdType v = sliceSize*zMin;
+  vtkIdType vMax = sliceSize*(zMax + 1);
+  for (; v < vMax; v++)
+    {
+    outPtr[v] = static_cast<OT>(region[v] < 0 ? 0 : labels[region[v]]);
+    }
+}
+
+//----------------------------------------------------------------------------
+// The slabs processed by the threads.
+class vtkImageConnectivityFilterWorker
+{
+public:
+  vtkImageData *InData;
+  vtkImageData *OutData;
+  void *InPtr;
+  void *OutPtr;
+  vtkIdType InInc[3];
+  int Dims[3];
+  double Range[2];
+  vtkImageConnectivityFilterNeighbors Neighbors;
+  vtkIdType *Parent;
+  const vtkIdType *Labels;
+  int NumberOfSlabs;
+  int Pass;
+
+  void GetSlab(int slab, int &zMin, int &zMax) const
+    {
+    zMin = static_cast<int>(
+      static_cast<vtkIdType>(this->Dims[2])*slab/this->NumberOfSlabs);
+    zMax = static_cast<int>(
+      static_cast<vtkIdType>(this->Dims[2])*(slab + 1)/this->NumberOfSlabs) - 1;
+    }
+
+  void Execute(int slab)
+    {
+    int zMin, zMax;
+    this->GetSlab(slab, zMin, zMax);
+    if (this->Pass == 0)
+      {
+      switch (this->InData->GetScalarType())
+        {
+        vtkTemplateMacro(
+          vtkImageConnectivityFilterScan(
+            static_cast<VTK_TT *>(this->InPtr), this->InInc, this->Dims,
+            this->Range, this->Neighbors, this->Parent, zMin, zMax));
+        }
+      }
+    else
+      {
+      switch (this->OutData->GetScalarType())
+        {
+        vtkTemplateMacro(
+          vtkImageConnectivityFilterLabel(
+            static_cast<VTK_TT *>(this->OutPtr), this->Dims, this->Parent,
+            this->Labels, zMin, zMax));
+        }
+      }
+    }
+
+  void Run()
+    {
+    if (this->NumberOfSlabs <= 1)
+      {
+      this->Execute(0);
+      return;
+      }
+    vtkMultiThreader *threader = vtkMultiThreader::New();
+    threader->SetNumberOfThreads(this->NumberOfSlabs);
+    threader->SetSingleMethod(
+      vtkImageConnectivityFilterWorker::ThreadedExecute, this);
+    threader->SingleMethodExecute();
+    threader->Delete();
+    }
+
+  static VTK_THREAD_RETURN_TYPE ThreadedExecute(void *arg)
+    {
+    vtkMultiThreader::ThreadInfo *info =
+      static_cast<vtkMultiThreader::ThreadInfo *>(arg);
+    vtkImageConnectivityFilterWorker *self =
+      static_cast<vtkImageConnectivityFilterWorker *>(info->UserData);
+    self->Execute(info->ThreadID);
+    return VTK_THREAD_RETURN_VALUE;
+    }
+};
+
+//----------------------------------------------------------------------------
+// The statistics of a region.
+struct vtkImageConnectivityFilterRegion
+{
+  vtkIdType Size;
+  int Extent[6];
+  double Sum[3];
+  int Seeded;
+};
+
+//----------------------------------------------------------------------------
+// Sort the regions by decreasing size, then by position.
+class vtkImageConnectivityFilterCompare
+{
+public:
+  const vtkstd::vector<vtkImageConnectivityFilterRegion> *Regions;
+
+  bool operator()(vtkIdType a, vtkIdType b) const
+    {
+    vtkIdType sizeA = (*this->Regions)[a].Size;
+    vtkIdType sizeB = (*this->Regions)[b].Size;
+    return (sizeA > sizeB || (sizeA == sizeB && a < b));
+    }
+};
+
+//----------------------------------------------------------------------------
+int vtkImageConnectivityFilter::RequestData(
+  vtkInformation *vtkNotUsed(request),
+  vtkInformationVector **inputVector,
+  vtkInformationVector *outputVector)
+{
+  vtkInformation *inInfo = inputVector[0]->GetInformationObject(0);
+  vtkInformation *outInfo = outputVector->GetInformationObject(0);
+  vtkImageData *inData = vtkImageData::SafeDownCast(
+    inInfo->Get(vtkDataObject::DATA_OBJECT()));
+  vtkImageData *outData = vtkImageData::SafeDownCast(
+    outInfo->Get(vtkDataObject::DATA_OBJECT()));
+
+  this->ExtractedRegionSizes->Reset();
+  this->ExtractedRegionExtents->Reset();
+  this->ExtractedRegionCentroids->Reset();
+
+  int extent[6];
+  outInfo->Get(vtkStreamingDemandDrivenPipeline::WHOLE_EXTENT(), extent);
+  outData->SetExtent(extent);
+  outData->AllocateScalars();
+
+  if (this->Connectivity != 6 && this->Connectivity != 18 &&
+      this->Connectivity != 26)
+    {
+    vtkErrorMacro("Execute: Connectivity must be 6, 18 or 26.");
+    return 1;
+    }
+
+  int labelType = outData->GetScalarType();
+  vtkIdType maxLabel;
+  switch (labelType)
+    {
+    case VTK_UNSIGNED_CHAR:
+      maxLabel = VTK_UNSIGNED_CHAR_MAX;
+      break;
+    case VTK_SHORT:
+      maxLabel = VTK_SHORT_MAX;
+      break;
+    case VTK_UNSIGNED_SHORT:
+      maxLabel = VTK_UNSIGNED_SHORT_MAX;
+      break;
+    case VTK_INT:
+      maxLabel = VTK_INT_MAX;
+      break;
+    default:
+      vtkErrorMacro("Execute: LabelScalarType must be unsigned char, "
+                    "short, unsigned short or int.");
+      return 1;
+    }
+
+  vtkImageConnectivityFilterWorker worker;
+  worker.InData = inData;
+  worker.OutData = outData;
+  worker.InPtr = inData->GetScalarPointerForExtent(extent);
+  worker.OutPtr = outData->GetScalarPointerForExtent(extent);
+  if (worker.InPtr == NULL)
+    {
+    vtkErrorMacro("Execute: No input scalars.");
+    return 1;
+    }
+  inData->GetIncrements(worker.InInc);
+  int *dims = worker.Dims;
+  dims[0] = extent[1] - extent[0] + 1;
+  dims[1] = extent[3] - extent[2] + 1;
+  dims[2] = extent[5] - extent[4] + 1;
+  worker.Range[0] = this->ScalarRange[0];
+  worker.Range[1] = this->ScalarRange[1];
+  worker.Neighbors.Build(this->Connectivity, dims);
+
+  vtkIdType sliceSize = static_cast<vtkIdType>(dims[0])*dims[1];
+  vtkIdType numVoxels = sliceSize*dims[2];
+  if (numVoxels <= 0)
+    {
+    return 1;
+    }
+  vtkstd::vector<vtkIdType> parent(numVoxels);
+  worker.Parent = &parent[0];
+
+  int numThreads = vtkMultiThreader::GetGlobalDefaultNumberOfThreads();
+  vtkIdType maxThreads = numVoxels / VTK_CONNECTIVITY_VOXELS_PER_THREAD;
+  if (maxThreads < numThreads)
+    {
+    numThreads = (maxThreads > 1 ? static_cast<int>(maxThreads) : 1);
+    }
+  worker.NumberOfSlabs = (numThreads < dims[2] ? numThreads : dims[2]);
+
+  // Label the slabs on their own
+  worker.Pass = 0;
+  worker.Run();
+  this->UpdateProgress(0.4);
+
+  // Join the first slice of each slab to the slice below
+  int slab, zMin, zMax;
+  for (slab = 1; slab < worker.NumberOfSlabs; slab++)
+    {
+    worker.GetSlab(slab, zMin, zMax);
+    vtkIdType v = sliceSize*zMin;
+    for (int y = 0; y < dims[1]; y++)
+      {
+      for (int x = 0; x < dims[0]; x++, v++)
+        {
+        if (parent[v] >= 0)
+          {
+          worker.Neighbors.Join(worker.Parent, v, x, y, zMin, 0, dims, 1);
+          }
+        }
+      }
+    }
+
+  // Replace the parents with region ids, and compute the statistics.  The
+  // parents come first, so they already hold their region id.
+  vtkstd::vector<vtkImageConnectivityFilterRegion> regions;
+  vtkIdType v = 0;
+  int idx[3];
+  for (idx[2] = 0; idx[2] < dims[2]; idx[2]++)
+    {
+    for (idx[1] = 0; idx[1] < dims[1]; idx[1]++)
+      {
+      for (idx[0] = 0; idx[0] < dims[0]; idx[0]++, v++)
+        {
+        vtkIdType p = parent[v];
+        if (p < 0)
+          {
+          continue;
+          }
+        vtkImageConnectivityFilterRegion *region;
+        if (p == v)
+          {
+          parent[v] = static_cast<vtkIdType>(regions.size());
+          vtkImageConnectivityFilterRegion newRegion;
+          newRegion.Size = 0;
+          for (int axis = 0; axis < 3; axis++)
+            {
+            newRegion.Extent[2*axis] = idx[axis];
+            newRegion.Extent[2*axis + 1] = idx[axis];
+            newRegion.Sum[axis] = 0.0;
+            }
+          newRegion.Seeded = 0;
+          regions.push_back(newRegion);
+          region = &regions.back();
+          }
+        else
+          {
+          parent[v] = parent[p];
+          region = &regions[parent[v]];
+          }
+        region->Size++;
+        for (int axis = 0; axis < 3; axis++)
+          {
+          if (idx[axis] < region->Extent[2*axis])
+            {
+            region->Extent[2*axis] = idx[axis];
+            }
+          if (idx[axis] > region->Extent[2*axis + 1])
+            {
+            region->Extent[2*axis + 1] = idx[axis];
+            }
+          region->Sum[axis] += idx[axis];
+          }
+        }
+      }
+    }
+  this->UpdateProgress(0.7);
+
+  // Select the regions to keep
+  vtkIdType numRegions = static_cast<vtkIdType>(regions.size());
+  if (this->ExtractionMode == VTK_IMAGE_CONNECTIVITY_SEEDED_REGIONS)
+    {
+    for (vtkIdType i = 0; i < this->Seeds->GetNumberOfTuples(); i++)
+      {
+      int seed[3];
+      this->Seeds->GetTupleValue(i, seed);
+      for (int axis = 0; axis < 3; axis++)
+        {
+        seed[axis] -= extent[2*axis];
+        }
+      if (seed[0] >= 0 && seed[0] < dims[0] &&
+          seed[1] >= 0 && seed[1] < dims[1] &&
+          seed[2] >= 0 && seed[2] < dims[2])
+        {
+        vtkIdType r = parent[seed[0] + dims[0]*seed[1] + sliceSize*seed[2]];
+        if (r >= 0)
+          {
+          regions[r].Seeded = 1;
+          }
+        }
+      }
+    }
+  vtkstd::vector<vtkIdType> kept;
+  for (vtkIdType r = 0; r < numRegions; r++)
+    {
+    if (regions[r].Size >= this->MinimumRegionSize &&
+        (regions[r].Seeded ||
+         this->ExtractionMode != VTK_IMAGE_CONNECTIVITY_SEEDED_REGIONS))
+      {
+      kept.push_back(r);
+      }
+    }
+  vtkImageConnectivityFilterCompare compare;
+  compare.Regions = &regions;
+  vtkstd::sort(kept.begin(), kept.end(), compare);
+  if (this->ExtractionMode == VTK_IMAGE_CONNECTIVITY_LARGEST_REGIONS &&
+      static_cast<vtkIdType>(kept.size()) > this->NumberOfLargestRegions)
+    {
+    kept.resize(this->NumberOfLargestRegions);
+    }
+  if (static_cast<vtkIdType>(kept.size()) > maxLabel)
+    {
+    vtkWarningMacro("Execute: " << kept.size() << " regions do not fit in "
+                    << outData->GetScalarTypeAsString() << ", only the "
+                    << maxLabel << " largest ones are labeled.");
+    kept.resize(maxLabel);
+    }
+
+  // Write the labels and the statistics
+  vtkstd::vector<vtkIdType> labels(numRegions + 1, 0);
+  double origin[3], spacing[3];
+  outData->GetOrigin(origin);
+  outData->GetSpacing(spacing);
+  vtkIdType numKept = static_cast<vtkIdType>(kept.size());
+  this->ExtractedRegionSizes->SetNumberOfTuples(numKept);
+  this->ExtractedRegionExtents->SetNumberOfTuples(numKept);
+  this->ExtractedRegionCentroids->SetNumberOfTuples(numKept);
+  for (vtkIdType i = 0; i < numKept; i++)
+    {
+    const vtkImageConnectivityFilterRegion &region = regions[kept[i]];
+    labels[kept[i]] = i + 1;
+    int regionExtent[6];
+    double centroid[3];
+    for (int axis = 0; axis < 3; axis++)
+      {
+      regionExtent[2*axis] = region.Extent[2*axis] + extent[2*axis];
+      regionExtent[2*axis + 1] = region.Extent[2*axis + 1] + extent[2*axis];
+      centroid[axis] = origin[axis] + spacing[axis]*
+        (region.Sum[axis]/region.Size + extent[2*axis]);
+      }
+    this->ExtractedRegionSizes->SetValue(i, region.Size);
+    this->ExtractedRegionExtents->SetTupleValue(i, regionExtent);
+    this->ExtractedRegionCentroids->SetTupleValue(i, centroid);
+    }
+
+  worker.Labels = &labels[0];
+  worker.Pass = 1;
+  worker.Run();
+
+  return 1;
+}
+
+//----------------------------------------------------------------------------
+void vtkImageConnectivityFilter::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os,indent);
+
+  os << indent << "ScalarRange: " << this->ScalarRange[0] << " "
+     << this->ScalarRange[1] << "\n";
+  os << indent << "Connectivity: " << this->Connectivity << "\n";
+  os << indent << "ExtractionMode: "
+     << this->GetExtractionModeAsString() << "\n";
+  os << indent << "NumberOfLargestRegions: "
+     << this->NumberOfLargestRegions << "\n";
+  os << indent << "MinimumRegionSize: " << this->MinimumRegionSize << "\n";
+  os << indent << "NumberOfSeeds: "
+     << this->Seeds->GetNumberOfTuples() << "\n";
+  os << indent << "LabelScalarType: "
+     << vtkImageScalarTypeNameMacro(this->LabelScalarType) << "\n";
+  os << indent << "NumberOfExtractedRegions: "
+     << this->GetNumberOfExtractedRegions() << "\n";
+}
@@ -0,0 +1,158 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkImageConnectivityFilter.h
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// .NAME vtkImageConnectivityFilter - label the connected regions of a volume
+// .SECTION Description
+// vtkImageConnectivityFilter labels the connected regions of the voxels
+// whose first scalar component lies within ScalarRange.  The regions can
+// be connected by faces (6-connectivity), by faces and edges
+// (18-connectivity) or by faces, edges and corners (26-connectivity).
+//
+// The regions are labeled 1, 2, 3... by decreasing size, and the other
+// voxels are set to zero.  All the regions can be kept, or only the
+// largest ones, or only the ones that contain a seed, and regions smaller
+// than MinimumRegionSize can be removed.  The size, the extent and the
+// centroid of each labeled region are available after the update.
+//
+// The volume is split into slabs that are labeled on several threads with
+// a union-find on the voxels, and the slabs are then merged along their
+// boundaries.
+// .SECTION See Also
+// vtkImageSeedConnectivity vtkImageThresholdConnectivity
+// vtkImageIslandRemoval2D
+
+#ifndef __vtkImageConnectivityFilter_h
+#define __vtkImageConnectivityFilter_h
+
+#include "vtkImageAlgorithm.h"
+
+#define VTK_IMAGE_CONNECTIVITY_ALL_REGIONS 0
+#define VTK_IMAGE_CONNECTIVITY_LARGEST_REGIONS 1
+#define VTK_IMAGE_CONNECTIVITY_SEEDED_REGIONS 2
+
+class vtkDoubleArray;
+class vtkIdTypeArray;
+class vtkIntArray;
+
+class VTK_IMAGING_EXPORT vtkImageConnectivityFilter : public vtkImageAlgorithm
+{
+public:
+  static vtkImageConnectivityFilter *New();
+  vtkTypeMacro(vtkImageConnectivityFilter,vtkImageAlgorithm);
+  void PrintSelf(ostream& os, vtkIndent indent);
+
+  // Description:
+  // The voxels whose first component lies within this range are labeled.
+  // The default range is [0.5, VTK_DOUBLE_MAX], which labels the non-zero
+  // voxels of unsigned masks.
+  vtkSetVector2Macro(ScalarRange, double);
+  vtkGetVector2Macro(ScalarRange, double);
+
+  // Description:
+  // The number of neighbors of each voxel: 6 (faces, the default), 18
+  // (faces and edges) or 26 (faces, edges and corners).
+  vtkSetMacro(Connectivity, int);
+  vtkGetMacro(Connectivity, int);
+  void SetConnectivityTo6() { this->SetConnectivity(6); }
+  void SetConnectivityTo18() { this->SetConnectivity(18); }
+  void SetConnectivityTo26() { this->SetConnectivity(26); }
+
+  // Description:
+  // Keep all the regions (the default), only the largest ones, or only the
+  // ones that contain a seed.
+  vtkSetClampMacro(ExtractionMode, int,
+                   VTK_IMAGE_CONNECTIVITY_ALL_REGIONS,
+                   VTK_IMAGE_CONNECTIVITY_SEEDED_REGIONS);
+  vtkGetMacro(ExtractionMode, int);
+  void SetExtractionModeToAllRegions()
+    { this->SetExtractionMode(VTK_IMAGE_CONNECTIVITY_ALL_REGIONS); }
+  void SetExtractionModeToLargestRegions()
+    { this->SetExtractionMode(VTK_IMAGE_CONNECTIVITY_LARGEST_REGIONS); }
+  void SetExtractionModeToSeededRegions()
+    { this->SetExtractionMode(VTK_IMAGE_CONNECTIVITY_SEEDED_REGIONS); }
+  const char *GetExtractionModeAsString();
+
+  // Description:
+  // The number of regions kept by the LargestRegions mode.  The default
+  // is one.
+  vtkSetClampMacro(NumberOfLargestRegions, int, 1, VTK_INT_MAX);
+  vtkGetMacro(NumberOfLargestRegions, int);
+
+  // Description:
+  // Regions with fewer voxels than this are removed, in every mode.  The
+  // default is one, which keeps all the regions.
+  vtkSetClampMacro(MinimumRegionSize, vtkIdType, 1, VTK_LARGE_ID);
+  vtkGetMacro(MinimumRegionSize, vtkIdType);
+
+  // Description:
+  // The seeds of the SeededRegions mode, as structured coordinates.
+  void AddSeed(int i, int j, int k);
+  void RemoveAllSeeds();
+
+  // Description:
+  // The scalar type of the labels: VTK_UNSIGNED_CHAR, VTK_SHORT,
+  // VTK_UNSIGNED_SHORT or VTK_INT (the default).  The smallest regions
+  // are dropped, with a warning, if there are more than the type can hold.
+  vtkSetMacro(LabelScalarType, int);
+  vtkGetMacro(LabelScalarType, int);
+  void SetLabelScalarTypeToUnsignedChar()
+    { this->SetLabelScalarType(VTK_UNSIGNED_CHAR); }
+  void SetLabelScalarTypeToShort()
+    { this->SetLabelScalarType(VTK_SHORT); }
+  void SetLabelScalarTypeToUnsignedShort()
+    { this->SetLabelScalarType(VTK_UNSIGNED_SHORT); }
+  void SetLabelScalarTypeToInt()
+    { this->SetLabelScalarType(VTK_INT); }
+
+  // Description:
+  // The number of labeled regions after the update.
+  vtkIdType GetNumberOfExtractedRegions();
+
+  // Description:
+  // The statistics of the labeled regions after the update: tuple i
+  // describes the region labeled i + 1.  The sizes are voxel counts, the
+  // extents are structured coordinates, and the centroids are in world
+  // coordinates.
+  vtkGetObjectMacro(ExtractedRegionSizes, vtkIdTypeArray);
+  vtkGetObjectMacro(ExtractedRegionExtents, vtkIntArray);
+  vtkGetObjectMacro(ExtractedRegionCentroids, vtkDoubleArray);
+
+protected:
+  vtkImageConnectivityFilter();
+  ~vtkImageConnectivityFilter();
+
+  double ScalarRange[2];
+  int Connectivity;
+  int ExtractionMode;
+  int NumberOfLargestRegions;
+  vtkIdType MinimumRegionSize;
+  int LabelScalarType;
+  vtkIntArray *Seeds;
+  vtkIdTypeArray *ExtractedRegionSizes;
+  vtkIntArray *ExtractedRegionExtents;
+  vtkDoubleArray *ExtractedRegionCentroids;
+
+  virtual int RequestInformation(vtkInformation *, vtkInformationVector **,
+                                 vtkInformationVector *);
+  virtual int RequestUpdateExtent(vtkInformation *, vtkInformationVector **,
+                                  vtkInformationVector *);
+  virtual int RequestData(vtkInformation *, vtkInformationVector **,
+                          vtkInformationVector *);
+
+private:
+  vtkImageConnectivityFilter(const vtkImageConnectivityFilter&);  // Not implemented.
+  void operator=(const vtkImageConnectivityFilter&);  // Not implemented.
+};
+
+#endif
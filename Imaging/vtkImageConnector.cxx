@@ -17,6 +17,15 @@
 #include "vtkImageData.h"
 #include "vtkObjectFactory.h"
 
+#include <vtkstd/vector>
+
+// A pixel waiting to be visited by MarkData
+struct vtkImageConnectorPixel
+{
+  unsigned char *Pointer;
+  int Index[3];
+};
+
 vtkStandardNewMacro(vtkImageConnector);
 
 //----------------------------------------------------------------------------
@@ -113,64 +122,69 @@ vtkImageConnectorSeed *vtkImageConnector::PopSeed()
 // used to find connected pixels.
 // All pixels connected to seeds are set to ConnectedValue.  
 // The data has to be unsigned char.
+// The pixels waiting to be visited are kept on a plain array instead of
+// the seed list, so that nothing is allocated for each marked pixel.
 void vtkImageConnector::MarkData(vtkImageData *data, int numberOfAxes, int extent[6])
 {
-  vtkIdType *incs, *pIncs;
-  int *pExtent;
+  vtkIdType *incs;
   vtkImageConnectorSeed *seed;
   unsigned char *ptr;
-  int newIndex[3], *pIndex, idx;
+  int idx;
   long count = 0;
+  vtkstd::vector<vtkImageConnectorPixel> stack;
+  vtkImageConnectorPixel pixel;
 
+  if (numberOfAxes > 3)
+    {
+    numberOfAxes = 3;
+    }
   incs = data->GetIncrements();
   while (this->Seeds)
     {
-    ++count;
     seed = this->PopSeed();
     // just in case the seed has not been marked visited.
     *(static_cast<unsigned char *>(seed->Pointer)) = this->ConnectedValue;
+    pixel.Pointer = static_cast<unsigned char *>(seed->Pointer);
+    pixel.Index[0] = seed->Index[0];
+    pixel.Index[1] = seed->Index[1];
+    pixel.Index[2] = seed->Index[2];
+    stack.push_back(pixel);
+    delete seed;
+    }
+
+  while (!stack.empty())
+    {
+    ++count;
+    pixel = stack.back();
+    stack.pop_back();
     // Add neighbors 
-    newIndex[0] = seed->Index[0];
-    newIndex[1] = seed->Index[1];
-    newIndex[2] = seed->Index[2];
-    pExtent = extent;
-    pIncs = incs;
-    pIndex = newIndex;
     for (idx = 0; idx < numberOfAxes; ++idx)
       {
       // check pixel below
-      if (*pExtent < *pIndex)
+      if (extent[2*idx] < pixel.Index[idx])
         {
-        ptr = static_cast<unsigned char *>(seed->Pointer) - *pIncs;
+        ptr = pixel.Pointer - incs[idx];
         if (*ptr == this->UnconnectedValue)
-          { // add a new seed
-          --(*pIndex);
+          { // add a new pixel
           *ptr = this->ConnectedValue;
-          this->AddSeedToEnd(this->NewSeed(newIndex, ptr));
-          ++(*pIndex);
+          stack.push_back(pixel);
+          stack.back().Pointer = ptr;
+          --stack.back().Index[idx];
           }
         }
-      ++pExtent;
       // check above pixel
-      if (*pExtent > *pIndex)
+      if (extent[2*idx + 1] > pixel.Index[idx])
         {
-        ptr = static_cast<unsigned char *>(seed->Pointer) + *pIncs;
+        ptr = pixel.Pointer + incs[idx];
         if (*ptr == this->UnconnectedValue)
-          { // add a new seed
-          ++(*pIndex);
+          { // add a new pixel
           *ptr = this->ConnectedValue;
-          this->AddSeedToEnd(this->NewSeed(newIndex, ptr));
-          --(*pIndex);
+          stack.push_back(pixel);
+          stack.back().Pointer = ptr;
+          ++stack.back().Index[idx];
           }
         }
-      ++pExtent;
-      // move to next axis
-      ++pIncs;
-      ++pIndex;
       }
-    
-    // Delete seed
-    delete seed;
     }
   vtkDebugMacro("Marked " << count << " pixels");
 }
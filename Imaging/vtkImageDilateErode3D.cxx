@@ -15,6 +15,7 @@
 #include "vtkImageDilateErode3D.h"
 #include "vtkImageData.h"
 #include "vtkImageEllipsoidSource.h"
+#include "vtkImageMorphologyInternals.h"
 #include "vtkInformation.h"
 #include "vtkInformationVector.h"
 #include "vtkObjectFactory.h"
@@ -28,6 +29,7 @@ vtkStandardNewMacro(vtkImageDilateErode3D);
 vtkImageDilateErode3D::vtkImageDilateErode3D()
 {
   this->HandleBoundaries = 1;
+  this->KernelShape = VTK_IMAGE_KERNEL_ELLIPSOID;
   this->KernelSize[0] = 1;
   this->KernelSize[1] = 1;
   this->KernelSize[2] = 1;
@@ -57,6 +59,9 @@ void vtkImageDilateErode3D::PrintSelf(ostream& os, vtkIndent indent)
 
   os << indent << "DilateValue: " << this->DilateValue << "\n";
   os << indent << "ErodeValue: " << this->ErodeValue << "\n";
+  os << indent << "KernelShape: "
+     << (this->KernelShape == VTK_IMAGE_KERNEL_BOX ? "Box" : "Ellipsoid")
+     << "\n";
 }
 
 //----------------------------------------------------------------------------
@@ -109,163 +114,100 @@ void vtkImageDilateErode3D::SetKernelSize(int size0, int size1, int size2)
 }
 
 //----------------------------------------------------------------------------
-// This templated function executes the filter on any region,
-// whether it needs boundary checking or not.
-// If the filter needs to be faster, the function could be duplicated
-// for strictly center (no boundary ) processing.
+// This templated function executes the filter on any region, one
+// component at a time.  The pixels with the dilate value are marked in a
+// buffer, the marks are dilated with the kernel, and the pixels with the
+// erode value that are reached by the marks take the dilate value.
 template <class T>
 void vtkImageDilateErode3DExecute(vtkImageDilateErode3D *self,
-                                  vtkImageData *mask,
-                                  vtkImageData *inData, T *inPtr, 
+                                  const vtkImageMorphologyKernel &kernel,
+                                  vtkImageData *inData,
                                   vtkImageData *outData, int *outExt, 
                                   T *outPtr, int id, vtkInformation *inInfo)
 {
-  int *kernelMiddle, *kernelSize;
-  // For looping though output (and input) pixels.
-  int outMin0, outMax0, outMin1, outMax1, outMin2, outMax2;
-  int outIdx0, outIdx1, outIdx2;
-  vtkIdType inInc0, inInc1, inInc2;
-  vtkIdType outInc0, outInc1, outInc2;
-  T *inPtr0, *inPtr1, *inPtr2;
-  T *outPtr0, *outPtr1, *outPtr2;
-  int numComps, outIdxC;
-  // For looping through hood pixels
-  int hoodMin0, hoodMax0, hoodMin1, hoodMax1, hoodMin2, hoodMax2;
-  int hoodIdx0, hoodIdx1, hoodIdx2;
-  T *hoodPtr0, *hoodPtr1, *hoodPtr2;
-  // For looping through the mask.
-  unsigned char *maskPtr, *maskPtr0, *maskPtr1, *maskPtr2;
-  vtkIdType maskInc0, maskInc1, maskInc2;
-  // The extent of the whole input image
-  int inImageMin0, inImageMin1, inImageMin2;
-  int inImageMax0, inImageMax1, inImageMax2;
+  int *inExt = inData->GetExtent();
   int inImageExt[6];
-  // dilate/erode
-  T erodeValue, dilateValue;
-  unsigned long count = 0;
-  unsigned long target;
+  int ext[6];
+  int idx0, idx1, idx2;
+  int numComps = outData->GetNumberOfScalarComponents();
 
-  // Get information to march through data
-  inData->GetIncrements(inInc0, inInc1, inInc2);
+  // Get ivars of this object (easier than making friends)
+  T erodeValue = static_cast<T>(self->GetErodeValue());
+  T dilateValue = static_cast<T>(self->GetDilateValue());
+
+  // The neighbors are taken from the whole extent of the input
   inInfo->Get(vtkStreamingDemandDrivenPipeline::WHOLE_EXTENT(), inImageExt);
-  inImageMin0 = inImageExt[0];
-  inImageMax0 = inImageExt[1];
-  inImageMin1 = inImageExt[2];
-  inImageMax1 = inImageExt[3];
-  inImageMin2 = inImageExt[4];
-  inImageMax2 = inImageExt[5];
-  outData->GetIncrements(outInc0, outInc1, outInc2);
-  outMin0 = outExt[0];   outMax0 = outExt[1];
-  outMin1 = outExt[2];   outMax1 = outExt[3];
-  outMin2 = outExt[4];   outMax2 = outExt[5];
-  numComps = outData->GetNumberOfScalarComponents();
+  for (int i = 0; i < 3; i++)
+    {
+    ext[2*i] = (inImageExt[2*i] > inExt[2*i] ? inImageExt[2*i] : inExt[2*i]);
+    ext[2*i+1] = (inImageExt[2*i+1] < inExt[2*i+1] ?
+                  inImageExt[2*i+1] : inExt[2*i+1]);
+    }
 
-  // Get ivars of this object (easier than making friends)
-  erodeValue = static_cast<T>(self->GetErodeValue());
-  dilateValue = static_cast<T>(self->GetDilateValue());
-  kernelSize = self->GetKernelSize();
-  kernelMiddle = self->GetKernelMiddle();
-  hoodMin0 = - kernelMiddle[0];
-  hoodMin1 = - kernelMiddle[1];
-  hoodMin2 = - kernelMiddle[2];
-  hoodMax0 = hoodMin0 + kernelSize[0] - 1;
-  hoodMax1 = hoodMin1 + kernelSize[1] - 1;
-  hoodMax2 = hoodMin2 + kernelSize[2] - 1;
+  vtkIdType inInc[3], outInc[3];
+  inData->GetIncrements(inInc[0], inInc[1], inInc[2]);
+  outData->GetIncrements(outInc[0], outInc[1], outInc[2]);
+  T *inPtr = static_cast<T *>(
+    inData->GetScalarPointer(ext[0], ext[2], ext[4]));
 
-  // Setup mask info
-  maskPtr = static_cast<unsigned char *>(mask->GetScalarPointer());
-  mask->GetIncrements(maskInc0, maskInc1, maskInc2);
-  
-  // in and out should be marching through corresponding pixels.
-  inPtr = static_cast<T *>(inData->GetScalarPointer(outMin0, outMin1, outMin2));
+  // The marks of the input, and the dilated marks of the output
+  vtkIdType markInc[3];
+  markInc[0] = 1;
+  markInc[1] = ext[1] - ext[0] + 1;
+  markInc[2] = markInc[1]*(ext[3] - ext[2] + 1);
+  vtkstd::vector<unsigned char> marks(markInc[2]*(ext[5] - ext[4] + 1));
+  vtkIdType dilatedInc[3];
+  dilatedInc[0] = 1;
+  dilatedInc[1] = outExt[1] - outExt[0] + 1;
+  dilatedInc[2] = dilatedInc[1]*(outExt[3] - outExt[2] + 1);
+  vtkstd::vector<unsigned char> dilated(
+    dilatedInc[2]*(outExt[5] - outExt[4] + 1));
 
-  target = static_cast<unsigned long>(numComps*(outMax2-outMin2+1)*
-                                      (outMax1-outMin1+1)/50.0);
-  target++;
-  
-  // loop through components
-  for (outIdxC = 0; outIdxC < numComps; ++outIdxC)
+  for (int idxC = 0; idxC < numComps && !self->AbortExecute; ++idxC)
     {
-    // loop through pixels of output
-    outPtr2 = outPtr;
-    inPtr2 = inPtr;
-    for (outIdx2 = outMin2; outIdx2 <= outMax2; ++outIdx2)
+    unsigned char *markPtr = &marks[0];
+    for (idx2 = ext[4]; idx2 <= ext[5]; ++idx2)
       {
-      outPtr1 = outPtr2;
-      inPtr1 = inPtr2;
-      for (outIdx1 = outMin1; 
-           !self->AbortExecute && outIdx1 <= outMax1; ++outIdx1)
+      for (idx1 = ext[2]; idx1 <= ext[3]; ++idx1)
         {
-        if (!id) 
+        T *inPtr0 = inPtr + (idx1 - ext[2])*inInc[1] +
+          (idx2 - ext[4])*inInc[2] + idxC;
+        for (idx0 = ext[0]; idx0 <= ext[1]; ++idx0)
           {
-          if (!(count%target))
-            {
-            self->UpdateProgress(count/(50.0*target));
-            }
-          count++;
+          *markPtr++ = (*inPtr0 == dilateValue);
+          inPtr0 += inInc[0];
           }
+        }
+      }
+
+    vtkImageMorphologyExecute<unsigned char,
+      vtkImageMorphologyMaximum<unsigned char> >(
+        &marks[0], markInc, ext, &dilated[0], dilatedInc, outExt, kernel);
 
-        outPtr0 = outPtr1;
-        inPtr0 = inPtr1;
-        for (outIdx0 = outMin0; outIdx0 <= outMax0; ++outIdx0)
+    const unsigned char *dilatedPtr = &dilated[0];
+    for (idx2 = outExt[4]; idx2 <= outExt[5]; ++idx2)
+      {
+      for (idx1 = outExt[2]; idx1 <= outExt[3]; ++idx1)
+        {
+        T *inPtr0 = inPtr + (outExt[0] - ext[0])*inInc[0] +
+          (idx1 - ext[2])*inInc[1] + (idx2 - ext[4])*inInc[2] + idxC;
+        T *outPtr0 = outPtr + (idx1 - outExt[2])*outInc[1] +
+          (idx2 - outExt[4])*outInc[2] + idxC;
+        for (idx0 = outExt[0]; idx0 <= outExt[1]; ++idx0)
           {
-          
-          // Default behavior (copy input pixel)
-          *outPtr0 = *inPtr0;
-          if (*inPtr0 == erodeValue)
-            {
-            // loop through neighborhood pixels
-            // as sort of a hack to handle boundaries, 
-            // input pointer will be marching through data that does not exist.
-            hoodPtr2 = inPtr0 - kernelMiddle[0] * inInc0 
-              - kernelMiddle[1] * inInc1 - kernelMiddle[2] * inInc2;
-            maskPtr2 = maskPtr;
-            for (hoodIdx2 = hoodMin2; hoodIdx2 <= hoodMax2; ++hoodIdx2)
-              {
-              hoodPtr1 = hoodPtr2;
-              maskPtr1 = maskPtr2;
-              for (hoodIdx1 = hoodMin1; hoodIdx1 <= hoodMax1; ++hoodIdx1)
-                {
-                hoodPtr0 = hoodPtr1;
-                maskPtr0 = maskPtr1;
-                for (hoodIdx0 = hoodMin0; hoodIdx0 <= hoodMax0; ++hoodIdx0)
-                  {
-                  // A quick but rather expensive way to handle boundaries
-                  if ( outIdx0 + hoodIdx0 >= inImageMin0 &&
-                       outIdx0 + hoodIdx0 <= inImageMax0 &&
-                       outIdx1 + hoodIdx1 >= inImageMin1 &&
-                       outIdx1 + hoodIdx1 <= inImageMax1 &&
-                       outIdx2 + hoodIdx2 >= inImageMin2 &&
-                       outIdx2 + hoodIdx2 <= inImageMax2)
-                    {
-                    if (*hoodPtr0 == dilateValue && *maskPtr0)
-                      {
-                      *outPtr0 = dilateValue;
-                      }
-                    }
-                
-                  hoodPtr0 += inInc0;
-                  maskPtr0 += maskInc0;
-                  }
-                hoodPtr1 += inInc1;
-                maskPtr1 += maskInc1;
-                }
-              hoodPtr2 += inInc2;
-              maskPtr2 += maskInc2;
-              }
-            }
-          
-          inPtr0 += inInc0;
-          outPtr0 += outInc0;
+          *outPtr0 = ((*inPtr0 == erodeValue && *dilatedPtr) ?
+                      dilateValue : *inPtr0);
+          ++dilatedPtr;
+          inPtr0 += inInc[0];
+          outPtr0 += outInc[0];
           }
-        inPtr1 += inInc1;
-        outPtr1 += outInc1;
         }
-      inPtr2 += inInc2;
-      outPtr2 += outInc2;
       }
-    ++inPtr;
-    ++outPtr;
+
+    if (!id)
+      {
+      self->UpdateProgress((idxC + 1.0)/numComps);
+      }
     }
 }
 
@@ -281,11 +223,7 @@ void vtkImageDilateErode3D::ThreadedRequestData(
   vtkImageData **outData, 
   int outExt[6], int id)
 {
-  int inExt[6], wholeExt[6];
   vtkInformation *inInfo = inputVector[0]->GetInformationObject(0);
-  inInfo->Get(vtkStreamingDemandDrivenPipeline::WHOLE_EXTENT(), wholeExt);
-  this->InternalRequestUpdateExtent(inExt,outExt,wholeExt);
-  void *inPtr = inData[0][0]->GetScalarPointerForExtent(inExt);
   void *outPtr = outData[0]->GetScalarPointerForExtent(outExt);
   vtkImageData *mask;
 
@@ -306,11 +244,21 @@ void vtkImageDilateErode3D::ThreadedRequestData(
     return;
     }
 
+  vtkImageMorphologyKernel kernel;
+  if (this->KernelShape == VTK_IMAGE_KERNEL_BOX)
+    {
+    vtkImageMorphologyKernelFromBox(this->KernelSize, this->KernelMiddle,
+                                    kernel);
+    }
+  else
+    {
+    vtkImageMorphologyKernelFromMask(mask, this->KernelMiddle, kernel);
+    }
+
   switch (inData[0][0]->GetScalarType())
     {
     vtkTemplateMacro(
-      vtkImageDilateErode3DExecute(this, mask, inData[0][0],
-                                   static_cast<VTK_TT *>(inPtr),outData[0],
+      vtkImageDilateErode3DExecute(this, kernel, inData[0][0], outData[0],
                                    outExt, 
                                    static_cast<VTK_TT *>(outPtr),id, inInfo));
     default:
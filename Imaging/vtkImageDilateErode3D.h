@@ -44,6 +44,17 @@ public:
   // default middle of the neighborhood and computes the elliptical foot print.
   void SetKernelSize(int size0, int size1, int size2);
 
+  // Description:
+  // Set/Get the shape of the kernel, an ellipsoid (the default) or a box
+  // that fills the kernel size.  A box is applied as three line kernels,
+  // one along each axis, which is much faster for large kernels.
+  vtkSetClampMacro(KernelShape, int, VTK_IMAGE_KERNEL_ELLIPSOID,
+                   VTK_IMAGE_KERNEL_BOX);
+  vtkGetMacro(KernelShape, int);
+  void SetKernelShapeToEllipsoid()
+    {this->SetKernelShape(VTK_IMAGE_KERNEL_ELLIPSOID);};
+  void SetKernelShapeToBox() {this->SetKernelShape(VTK_IMAGE_KERNEL_BOX);};
+
   
   // Description:
   // Set/Get the Dilate and Erode values to be used by this filter.
@@ -57,6 +68,7 @@ protected:
   ~vtkImageDilateErode3D();
 
   vtkImageEllipsoidSource *Ellipse;
+  int KernelShape;
   double DilateValue;
   double ErodeValue;
     
@@ -17,11 +17,16 @@
 #include "vtkImageData.h"
 #include "vtkInformation.h"
 #include "vtkInformationVector.h"
+#include "vtkMultiThreader.h"
 #include "vtkObjectFactory.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
 
+#include <vtkstd/vector>
 #include <math.h>
 
+// The number of voxels processed by each thread
+#define VTK_EDT_VOXELS_PER_THREAD 32768
+
 vtkStandardNewMacro(vtkImageEuclideanDistance);
 
 //----------------------------------------------------------------------------
@@ -31,15 +36,34 @@ vtkImageEuclideanDistance::vtkImageEuclideanDistance()
   this->MaximumDistance = VTK_INT_MAX;
   this->Initialize = 1;
   this->ConsiderAnisotropy = 1;
-  this->Algorithm = VTK_EDT_SAITO;
+  this->Algorithm = VTK_EDT_FELZENSZWALB;
+  this->OutputScalarType = VTK_DOUBLE;
+  this->SquaredDistance = 1;
+  this->SignedDistance = 0;
 }
 
 //----------------------------------------------------------------------------
-// This extent of the components changes to real and imaginary values.
+// The output holds doubles, or floats for Felzenszwalb's algorithm.  The
+// intermediate results of signed distances have two components.
 int vtkImageEuclideanDistance::IterativeRequestInformation(
   vtkInformation* vtkNotUsed(input), vtkInformation* output)
 {
-  vtkDataObject::SetPointDataActiveScalarInfo(output, VTK_DOUBLE, 1);
+  int scalarType = VTK_DOUBLE;
+  int numComponents = 1;
+  if ( this->Algorithm == VTK_EDT_FELZENSZWALB )
+    {
+    if ( this->OutputScalarType == VTK_FLOAT )
+      {
+      scalarType = VTK_FLOAT;
+      }
+    if ( this->SignedDistance &&
+         this->Iteration < this->NumberOfIterations - 1 )
+      {
+      numComponents = 2;
+      }
+    }
+  vtkDataObject::SetPointDataActiveScalarInfo(output, scalarType,
+                                              numComponents);
   return 1;
 }
 
@@ -561,6 +585,294 @@ void vtkImageEuclideanDistance::AllocateOutputScalars(vtkImageData *outData)
   outData->AllocateScalars();
 }
 
+//----------------------------------------------------------------------------
+// Compute the lower envelope of the parabolas w*(x-q)^2 + f[q] at every
+// sample of a line of n samples.  v holds the roots of the parabolas of
+// the envelope and z the abscissas where they start.
+//
+// P. F. Felzenszwalb and D. P. Huttenlocher. Distance transforms of sampled
+// functions. Technical Report TR2004-1963, Cornell University, 2004.
+static void vtkImageEuclideanDistanceEnvelope(const double *f, double *d,
+                                              int *v, double *z, int n,
+                                              double w)
+{
+  int k = 0;
+  int q;
+  v[0] = 0;
+  z[0] = -VTK_DOUBLE_MAX;
+  z[1] = VTK_DOUBLE_MAX;
+  for (q = 1; q < n; q++)
+    {
+    int r = v[k];
+    double s = ((f[q] + w*q*q) - (f[r] + w*r*r))/(2.0*w*(q - r));
+    while (s <= z[k])
+      {
+      k--;
+      r = v[k];
+      s = ((f[q] + w*q*q) - (f[r] + w*r*r))/(2.0*w*(q - r));
+      }
+    k++;
+    v[k] = q;
+    z[k] = s;
+    z[k+1] = VTK_DOUBLE_MAX;
+    }
+
+  k = 0;
+  for (q = 0; q < n; q++)
+    {
+    while (z[k+1] < q)
+      {
+      k++;
+      }
+    double dq = q - v[k];
+    d[q] = w*(dq*dq) + f[v[k]];
+    }
+}
+
+//----------------------------------------------------------------------------
+// Execute Felzenszwalb's algorithm along the axis of the current iteration.
+// The lines are read from the input, transformed, and written to the
+// output.  For signed distances the intermediate results hold two
+// components: the squared distance to the background, and the squared
+// distance to the mask.
+template <class TIn, class TOut>
+void vtkImageEuclideanDistanceExecuteFelzenszwalb(
+  vtkImageEuclideanDistance *self, vtkImageData *inData, TIn *inPtr,
+  vtkImageData *outData, int outExt[6], TOut *outPtr)
+{
+  int outMin0, outMax0, outMin1, outMax1, outMin2, outMax2;
+  vtkIdType inInc0, inInc1, inInc2;
+  vtkIdType outInc0, outInc1, outInc2;
+  int idx0, idx1, idx2, idxC;
+
+  self->PermuteExtent(outExt, outMin0,outMax0,outMin1,outMax1,outMin2,outMax2);
+  self->PermuteIncrements(inData->GetIncrements(), inInc0, inInc1, inInc2);
+  self->PermuteIncrements(outData->GetIncrements(), outInc0, outInc1, outInc2);
+
+  int iteration = self->GetIteration();
+  int last = (iteration == self->GetNumberOfIterations() - 1);
+  int signedDistance = self->GetSignedDistance();
+  int initialize = self->GetInitialize();
+  int squared = self->GetSquaredDistance();
+  int numTransforms = (signedDistance ? 2 : 1);
+  double maxDist = self->GetMaximumDistance();
+  double spacing = 1.0;
+  if ( self->GetConsiderAnisotropy() )
+    {
+    spacing = outData->GetSpacing()[iteration];
+    }
+  double w = spacing*spacing;
+
+  int n = outMax0 - outMin0 + 1;
+  vtkstd::vector<double> f(n);
+  vtkstd::vector<double> d(2*n);
+  vtkstd::vector<int> v(n);
+  vtkstd::vector<double> z(n + 1);
+
+  for (idx2 = outMin2; idx2 <= outMax2; ++idx2)
+    {
+    for (idx1 = outMin1; idx1 <= outMax1; ++idx1)
+      {
+      TIn *inPtr0 = inPtr + (idx1 - outMin1)*inInc1 +
+        (idx2 - outMin2)*inInc2;
+      TOut *outPtr0 = outPtr + (idx1 - outMin1)*outInc1 +
+        (idx2 - outMin2)*outInc2;
+      for (idxC = 0; idxC < numTransforms; idxC++)
+        {
+        // Read the line
+        for (idx0 = 0; idx0 < n; ++idx0)
+          {
+          double value;
+          if (iteration > 0)
+            {
+            value = static_cast<double>(inPtr0[idx0*inInc0 + idxC]);
+            }
+          else
+            {
+            value = static_cast<double>(inPtr0[idx0*inInc0]);
+            if (signedDistance)
+              {
+              // The first transform measures the distance to the
+              // background, the second one the distance to the mask.
+              value = (((value != 0) == (idxC == 0)) ? maxDist : 0);
+              }
+            else if (initialize)
+              {
+              value = (value != 0 ? maxDist : 0);
+              }
+            }
+          f[idx0] = value;
+          }
+        vtkImageEuclideanDistanceEnvelope(&f[0], &d[idxC*n], &v[0], &z[0],
+                                          n, w);
+        }
+
+      // Write the line
+      for (idx0 = 0; idx0 < n; ++idx0)
+        {
+        TOut *outPtrC = outPtr0 + idx0*outInc0;
+        if (!last)
+          {
+          for (idxC = 0; idxC < numTransforms; idxC++)
+            {
+            outPtrC[idxC] = static_cast<TOut>(d[idxC*n + idx0]);
+            }
+          }
+        else if (signedDistance)
+          {
+          // Only one of the two distances is not zero
+          double inside = d[idx0];
+          double outside = d[n + idx0];
+          if (!squared)
+            {
+            inside = sqrt(inside);
+            outside = sqrt(outside);
+            }
+          *outPtrC = static_cast<TOut>(inside > 0 ? -inside : outside);
+          }
+        else
+          {
+          *outPtrC = static_cast<TOut>(squared ? d[idx0] : sqrt(d[idx0]));
+          }
+        }
+      }
+    }
+}
+
+//----------------------------------------------------------------------------
+// Replace the squared distances with distances, after the last iteration
+// of Saito's algorithms.
+static void vtkImageEuclideanDistanceSquareRoot(vtkImageData *outData,
+                                                int outExt[6], double *outPtr)
+{
+  vtkIdType outIncX, outIncY, outIncZ;
+  outData->GetContinuousIncrements(outExt, outIncX, outIncY, outIncZ);
+  for (int idx2 = outExt[4]; idx2 <= outExt[5]; ++idx2)
+    {
+    for (int idx1 = outExt[2]; idx1 <= outExt[3]; ++idx1)
+      {
+      for (int idx0 = outExt[0]; idx0 <= outExt[1]; ++idx0)
+        {
+        *outPtr = sqrt(*outPtr);
+        outPtr++;
+        }
+      outPtr += outIncY;
+      }
+    outPtr += outIncZ;
+    }
+}
+
+//----------------------------------------------------------------------------
+// Run one iteration on a piece of the output extent.  The pieces are
+// split by SplitExtent, so they hold whole lines along the current axis.
+static void vtkImageEuclideanDistanceExecutePiece(
+  vtkImageEuclideanDistance *self, vtkImageData *inData,
+  vtkImageData *outData, int outExt[6])
+{
+  void *inPtr = inData->GetScalarPointerForExtent(outExt);
+  void *outPtr = outData->GetScalarPointerForExtent(outExt);
+
+  if ( self->GetAlgorithm() == VTK_EDT_FELZENSZWALB )
+    {
+    if ( outData->GetScalarType() == VTK_FLOAT )
+      {
+      switch (inData->GetScalarType())
+        {
+        vtkTemplateMacro(
+          vtkImageEuclideanDistanceExecuteFelzenszwalb(
+            self, inData, static_cast<VTK_TT *>(inPtr),
+            outData, outExt, static_cast<float *>(outPtr)));
+        }
+      }
+    else
+      {
+      switch (inData->GetScalarType())
+        {
+        vtkTemplateMacro(
+          vtkImageEuclideanDistanceExecuteFelzenszwalb(
+            self, inData, static_cast<VTK_TT *>(inPtr),
+            outData, outExt, static_cast<double *>(outPtr)));
+        }
+      }
+    return;
+    }
+
+  if ( self->GetIteration() == 0 )
+    {
+    switch (inData->GetScalarType())
+      {
+      vtkTemplateMacro(
+        vtkImageEuclideanDistanceInitialize(self,
+                                            inData,
+                                            static_cast<VTK_TT *>(inPtr),
+                                            outData, outExt,
+                                            static_cast<double *>(outPtr) ));
+      }
+    }
+  else
+    {
+    if( inData != outData )
+      switch (inData->GetScalarType())
+        {
+        vtkTemplateMacro(
+          vtkImageEuclideanDistanceCopyData(self,
+                                            inData,
+                                            static_cast<VTK_TT *>(inPtr),
+                                            outData, outExt,
+                                            static_cast<double *>(outPtr) ));
+        }
+    }
+
+  // Call the specific algorithms.
+  switch( self->GetAlgorithm() )
+    {
+    case VTK_EDT_SAITO:
+      vtkImageEuclideanDistanceExecuteSaito( self, outData, outExt,
+                                             static_cast<double *>(outPtr) );
+      break;
+    case VTK_EDT_SAITO_CACHED:
+      vtkImageEuclideanDistanceExecuteSaitoCached( self, outData, outExt,
+                                                   static_cast<double *>(outPtr) );
+      break;
+    }
+
+  if ( !self->GetSquaredDistance() &&
+       self->GetIteration() == self->GetNumberOfIterations() - 1 )
+    {
+    vtkImageEuclideanDistanceSquareRoot(outData, outExt,
+                                        static_cast<double *>(outPtr));
+    }
+}
+
+//----------------------------------------------------------------------------
+// The pieces of an iteration, one per thread.
+class vtkImageEuclideanDistanceWorker
+{
+public:
+  vtkImageEuclideanDistance *Self;
+  vtkImageData *InData;
+  vtkImageData *OutData;
+  int Extent[6];
+  int NumberOfPieces;
+
+  static VTK_THREAD_RETURN_TYPE ThreadedExecute(void *arg)
+    {
+    vtkMultiThreader::ThreadInfo *info =
+      static_cast<vtkMultiThreader::ThreadInfo *>(arg);
+    vtkImageEuclideanDistanceWorker *self =
+      static_cast<vtkImageEuclideanDistanceWorker *>(info->UserData);
+    int pieceExt[6];
+    if (info->ThreadID < self->Self->SplitExtent(pieceExt, self->Extent,
+                                                 info->ThreadID,
+                                                 self->NumberOfPieces))
+      {
+      vtkImageEuclideanDistanceExecutePiece(self->Self, self->InData,
+                                            self->OutData, pieceExt);
+      }
+    return VTK_THREAD_RETURN_VALUE;
+    }
+};
+
 //----------------------------------------------------------------------------
 // This method is passed input and output Datas, and executes the
 // EuclideanDistance algorithm to fill the output from the input.
@@ -578,81 +890,75 @@ int vtkImageEuclideanDistance::IterativeRequestData(
 
   this->AllocateOutputScalars(outData);
   
-  void *inPtr;
-  void *outPtr;
-
   vtkDebugMacro(<<"Executing image euclidean distance");
   
   int outExt[6];
   outData->GetWholeExtent( outExt );
   
-  inPtr = inData->GetScalarPointerForExtent(
-    inInfo->Get(vtkStreamingDemandDrivenPipeline::UPDATE_EXTENT()));
-  outPtr = outData->GetScalarPointer();
-   
-  if (!inPtr)
+  if (!inData->GetScalarPointerForExtent(
+        inInfo->Get(vtkStreamingDemandDrivenPipeline::UPDATE_EXTENT())))
     {
     vtkErrorMacro(<< "Execute: No scalars for update extent.")
     return 1;
     }
-   
   
-  // this filter expects that the output be doubles.
-  if (outData->GetScalarType() != VTK_DOUBLE)
+  if ( this->Algorithm != VTK_EDT_FELZENSZWALB &&
+       this->Algorithm != VTK_EDT_SAITO &&
+       this->Algorithm != VTK_EDT_SAITO_CACHED )
+    {
+    vtkErrorMacro(<< "Execute: Unknown Algorithm");
+    return 1;
+    }
+
+  // this filter expects that the output be doubles, or floats for
+  // Felzenszwalb's algorithm.
+  if (outData->GetScalarType() != VTK_DOUBLE &&
+      (outData->GetScalarType() != VTK_FLOAT ||
+       this->Algorithm != VTK_EDT_FELZENSZWALB))
     {
     vtkErrorMacro(<< "Execute: Output must be be type double.");
     return 1;
     }
   
-  // this filter expects input to have 1 components
-  if (outData->GetNumberOfScalarComponents() != 1 )
+  // this filter expects input to have 1 components, except for the
+  // intermediate results of signed distances
+  if (outData->GetNumberOfScalarComponents() != 1 &&
+      !(this->SignedDistance && this->Algorithm == VTK_EDT_FELZENSZWALB))
     {
     vtkErrorMacro(<< "Execute: Cannot handle more than 1 components");
     return 1;
     }
-  
-  if ( this->GetIteration() == 0 )
+
+  // The lines along the current axis are split among the threads.
+  vtkImageEuclideanDistanceWorker worker;
+  worker.Self = this;
+  worker.InData = inData;
+  worker.OutData = outData;
+  memcpy(worker.Extent, outExt, 6 * sizeof(int));
+
+  vtkIdType numVoxels = static_cast<vtkIdType>(outExt[1] - outExt[0] + 1)*
+    (outExt[3] - outExt[2] + 1)*(outExt[5] - outExt[4] + 1);
+  int numThreads = vtkMultiThreader::GetGlobalDefaultNumberOfThreads();
+  vtkIdType maxThreads = numVoxels / VTK_EDT_VOXELS_PER_THREAD;
+  if ( maxThreads < numThreads )
     {
-    switch (inData->GetScalarType())
-      {
-      vtkTemplateMacro(
-        vtkImageEuclideanDistanceInitialize(this, 
-                                            inData,
-                                            static_cast<VTK_TT *>(inPtr), 
-                                            outData, outExt, 
-                                            static_cast<double *>(outPtr) ));
-      default:
-        vtkErrorMacro(<< "Execute: Unknown ScalarType");
-        return 1;
-      } 
-    } 
-  else 
-    { 
-    if( inData != outData )
-      switch (inData->GetScalarType())
-        {    
-        vtkTemplateMacro(
-          vtkImageEuclideanDistanceCopyData(this, 
-                                            inData,
-                                            static_cast<VTK_TT *>(inPtr), 
-                                            outData, outExt, 
-                                            static_cast<double *>(outPtr) ));
-        }
+    numThreads = ( maxThreads > 1 ? static_cast<int>(maxThreads) : 1 );
     }
-  
-  // Call the specific algorithms. 
-  switch( this->GetAlgorithm() ) 
+  int pieceExt[6];
+  worker.NumberOfPieces = this->SplitExtent(pieceExt, outExt, 0, numThreads);
+
+  if ( worker.NumberOfPieces <= 1 )
     {
-    case VTK_EDT_SAITO:
-      vtkImageEuclideanDistanceExecuteSaito( this, outData, outExt, 
-                                             static_cast<double *>(outPtr) );
-      break;
-    case VTK_EDT_SAITO_CACHED:
-      vtkImageEuclideanDistanceExecuteSaitoCached( this, outData, outExt, 
-                                                   static_cast<double *>(outPtr) );
-      break;
-    default:
-      vtkErrorMacro(<< "Execute: Unknown Algorithm");
+    vtkImageEuclideanDistanceExecutePiece(this, inData, outData, outExt);
+    }
+  else
+    {
+    vtkMultiThreader *threader = vtkMultiThreader::New();
+    threader->SetNumberOfThreads(worker.NumberOfPieces);
+    threader->SetSingleMethod(vtkImageEuclideanDistanceWorker::ThreadedExecute,
+                              &worker);
+    threader->SingleMethodExecute();
+    threader->Delete();
     }
   
   this->UpdateProgress((this->GetIteration()+1.0)/3.0);
@@ -746,10 +1052,21 @@ void vtkImageEuclideanDistance::PrintSelf(ostream& os, vtkIndent indent)
     {
     os << "Saito\n";
     }
+  else if ( this->Algorithm == VTK_EDT_FELZENSZWALB )
+    {
+    os << "Felzenszwalb\n";
+    }
   else 
     {
     os << "Saito Cached\n";
     }
+
+  os << indent << "OutputScalarType: " 
+     << vtkImageScalarTypeNameMacro(this->OutputScalarType) << "\n";
+  os << indent << "SquaredDistance: " 
+     << (this->SquaredDistance ? "On\n" : "Off\n");
+  os << indent << "SignedDistance: " 
+     << (this->SignedDistance ? "On\n" : "Off\n");
 }
   
 
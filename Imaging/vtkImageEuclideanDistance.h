@@ -15,13 +15,17 @@
 // .NAME vtkImageEuclideanDistance - computes 3D Euclidean DT 
 // .SECTION Description
 // vtkImageEuclideanDistance implements the Euclidean DT using
-// Saito's algorithm. The distance map produced contains the square of the
-// Euclidean distance values. 
+// Felzenszwalb's or Saito's algorithm. By default, the distance map 
+// produced contains the square of the Euclidean distance values. 
 //
-// The algorithm has a o(n^(D+1)) complexity over nxnx...xn images in D 
-// dimensions. It is very efficient on relatively small images. Cuisenaire's
-// algorithms should be used instead if n >> 500. These are not implemented
-// yet.
+// Felzenszwalb's algorithm, the default, computes the lower envelope of
+// the parabolas rooted at the samples of each line, which takes a time
+// linear in the number of samples. The lines of each axis are processed
+// on several threads. Only this algorithm can produce float output, true
+// distances instead of squared ones, and signed distances.
+//
+// Saito's algorithm has a o(n^(D+1)) complexity over nxnx...xn images in D 
+// dimensions. It is very efficient on relatively small images.
 //
 // For the special case of images where the slice-size is a multiple of 
 // 2^N with a large N (typically for 256x256 slices), Saito's algorithm 
@@ -31,6 +35,9 @@
 //
 // References:
 //
+// P. F. Felzenszwalb and D. P. Huttenlocher. Distance transforms of sampled
+// functions. Technical Report TR2004-1963, Cornell University, 2004.
+//
 // T. Saito and J.I. Toriwaki. New algorithms for Euclidean distance 
 // transformations of an n-dimensional digitised picture with applications.
 // Pattern Recognition, 27(11). pp. 1551--1565, 1994. 
@@ -47,6 +54,7 @@
 
 #define VTK_EDT_SAITO_CACHED 0
 #define VTK_EDT_SAITO 1 
+#define VTK_EDT_FELZENSZWALB 2
 
 class VTK_IMAGING_EXPORT vtkImageEuclideanDistance : public vtkImageDecomposeFilter
 {
@@ -92,13 +100,43 @@ public:
   // Selects a Euclidean DT algorithm. 
   // 1. Saito
   // 2. Saito-cached 
-  // More algorithms will be added later on. 
+  // 3. Felzenszwalb (the default)
   vtkSetMacro(Algorithm, int);
   vtkGetMacro(Algorithm, int);
   void SetAlgorithmToSaito () 
     { this->SetAlgorithm(VTK_EDT_SAITO); } 
   void SetAlgorithmToSaitoCached () 
     { this->SetAlgorithm(VTK_EDT_SAITO_CACHED); }   
+  void SetAlgorithmToFelzenszwalb () 
+    { this->SetAlgorithm(VTK_EDT_FELZENSZWALB); }   
+
+  // Description:
+  // Set the scalar type of the output, VTK_DOUBLE (the default) or
+  // VTK_FLOAT.  Saito's algorithms always produce doubles.
+  vtkSetMacro(OutputScalarType, int);
+  vtkGetMacro(OutputScalarType, int);
+  void SetOutputScalarTypeToFloat() 
+    { this->SetOutputScalarType(VTK_FLOAT); }
+  void SetOutputScalarTypeToDouble() 
+    { this->SetOutputScalarType(VTK_DOUBLE); }
+
+  // Description:
+  // When on (the default), the output contains squared distances.  When
+  // off, it contains the distances themselves.
+  vtkSetMacro(SquaredDistance, int);
+  vtkGetMacro(SquaredDistance, int);
+  vtkBooleanMacro(SquaredDistance, int);
+
+  // Description:
+  // When on, the input is used as a binary mask and the output is the
+  // signed distance to its boundary: the voxels of the mask (non-zero
+  // values) get minus their distance to the nearest zero voxel, and the
+  // other voxels get their distance to the nearest voxel of the mask.
+  // Initialize is ignored.  Only Felzenszwalb's algorithm supports it.
+  // Off by default.
+  vtkSetMacro(SignedDistance, int);
+  vtkGetMacro(SignedDistance, int);
+  vtkBooleanMacro(SignedDistance, int);
 
   virtual int IterativeRequestData(vtkInformation*,
                                    vtkInformationVector**,
@@ -112,6 +150,9 @@ protected:
   int Initialize;
   int ConsiderAnisotropy;
   int Algorithm;
+  int OutputScalarType;
+  int SquaredDistance;
+  int SignedDistance;
 
   // Replaces "EnlargeOutputUpdateExtent"
   virtual void AllocateOutputScalars(vtkImageData *outData);
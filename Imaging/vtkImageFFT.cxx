@@ -68,6 +68,7 @@ void vtkImageFFTExecute(vtkImageFFT *self,
   vtkImageComplex *inComplex;
   vtkImageComplex *outComplex;
   vtkImageComplex *pComplex;
+  vtkImageComplex *qComplex;
   //
   int inMin0, inMax0;
   vtkIdType inInc0, inInc1, inInc2;
@@ -78,6 +79,7 @@ void vtkImageFFTExecute(vtkImageFFT *self,
   double *outPtr0, *outPtr1, *outPtr2;
   //
   int idx0, idx1, idx2, inSize0, numberOfComponents;
+  int line, numLines = 0;
   unsigned long count = 0;
   unsigned long target;
   double startProgress;
@@ -101,9 +103,12 @@ void vtkImageFFTExecute(vtkImageFFT *self,
     return;
     }
 
-  // Allocate the arrays of complex numbers
-  inComplex = new vtkImageComplex[inSize0];
-  outComplex = new vtkImageComplex[inSize0];
+  // Allocate the arrays of complex numbers for a block of lines. The lines
+  // of a block are next to each other along axis 1, which is the x axis for
+  // the second and third iterations, so that they are copied in and out
+  // a few contiguous values at a time instead of one value per line.
+  inComplex = new vtkImageComplex[inSize0 * VTK_IMAGE_FFT_BLOCK_SIZE];
+  outComplex = new vtkImageComplex[inSize0 * VTK_IMAGE_FFT_BLOCK_SIZE];
 
   target = static_cast<unsigned long>((outMax2-outMin2+1)*(outMax1-outMin1+1)
                                       * self->GetNumberOfIterations() / 50.0);
@@ -116,9 +121,15 @@ void vtkImageFFTExecute(vtkImageFFT *self,
     {
     inPtr1 = inPtr2;
     outPtr1 = outPtr2;
-    for (idx1 = outMin1; !self->AbortExecute && idx1 <= outMax1; ++idx1)
+    for (idx1 = outMin1; !self->AbortExecute && idx1 <= outMax1;
+         idx1 += numLines)
       {
-      if (!id) 
+      numLines = outMax1 - idx1 + 1;
+      if (numLines > VTK_IMAGE_FFT_BLOCK_SIZE)
+        {
+        numLines = VTK_IMAGE_FFT_BLOCK_SIZE;
+        }
+      for (line = 0; !id && line < numLines; ++line)
         {
         if (!(count%target))
           {
@@ -128,34 +139,48 @@ void vtkImageFFTExecute(vtkImageFFT *self,
         }
       // copy into complex numbers
       inPtr0 = inPtr1;
-      pComplex = inComplex;
-      for (idx0 = inMin0; idx0 <= inMax0; ++idx0)
+      for (idx0 = 0; idx0 < inSize0; ++idx0)
         {
-        pComplex->Real = static_cast<double>(*inPtr0);
-        pComplex->Imag = 0.0;
-        if (numberOfComponents > 1)
-          { // yes we have an imaginary input
-          pComplex->Imag = static_cast<double>(inPtr0[1]);;
+        T *inPtrLine = inPtr0;
+        pComplex = inComplex + idx0;
+        for (line = 0; line < numLines; ++line)
+          {
+          pComplex->Real = static_cast<double>(*inPtrLine);
+          pComplex->Imag = 0.0;
+          if (numberOfComponents > 1)
+            { // yes we have an imaginary input
+            pComplex->Imag = static_cast<double>(inPtrLine[1]);
+            }
+          inPtrLine += inInc1;
+          pComplex += inSize0;
           }
         inPtr0 += inInc0;
-        ++pComplex;
         }
       
       // Call the method that performs the fft
-      self->ExecuteFft(inComplex, outComplex, inSize0);
-
+      for (line = 0; line < numLines; ++line)
+        {
+        pComplex = inComplex + line * inSize0;
+        qComplex = outComplex + line * inSize0;
+        self->ExecuteFft(pComplex, qComplex, inSize0);
+        }
       // copy into output
       outPtr0 = outPtr1;
-      pComplex = outComplex + (outMin0 - inMin0);
       for (idx0 = outMin0; idx0 <= outMax0; ++idx0)
         {
-        *outPtr0 = static_cast<double>(pComplex->Real);
-        outPtr0[1] = static_cast<double>(pComplex->Imag);
+        double *outPtrLine = outPtr0;
+        pComplex = outComplex + (idx0 - inMin0);
+        for (line = 0; line < numLines; ++line)
+          {
+          *outPtrLine = pComplex->Real;
+          outPtrLine[1] = pComplex->Imag;
+          outPtrLine += outInc1;
+          pComplex += inSize0;
+          }
         outPtr0 += outInc0;
-        ++pComplex;
         }
-      inPtr1 += inInc1;
-      outPtr1 += outInc1;
+      inPtr1 += numLines * inInc1;
+      outPtr1 += numLines * outInc1;
       }
     inPtr2 += inInc2;
     outPtr2 += outInc2;
@@ -14,8 +14,383 @@
 =========================================================================*/
 #include "vtkImageFourierFilter.h"
 
+#include "vtkCriticalSection.h"
+#include "vtkDataArray.h"
+#include "vtkImageData.h"
+#include "vtkInformation.h"
+#include "vtkInformationVector.h"
+#include "vtkMath.h"
+#include "vtkMultiThreader.h"
+#include "vtkStreamingDemandDrivenPipeline.h"
+
+#include <vtkstd/vector>
+
 #include <math.h>
 
+// The lengths with a prime factor larger than this are transformed with the
+// Bluestein algorithm.
+#define VTK_IMAGE_FFT_MAX_RADIX 32
+
+//----------------------------------------------------------------------------
+// The plan of the fast transforms of one length. The transforms are
+// self-sorting (Stockham) mixed radix transforms, which alternate between the
+// data and a work array and need no bit reversal. The lengths with a large
+// prime factor are computed as a convolution (Bluestein) with the transforms
+// of a power of two length.
+class vtkImageFourierFilterPlan
+{
+public:
+  vtkImageFourierFilterPlan(int n);
+  ~vtkImageFourierFilterPlan();
+
+  // Forward transform of N numbers in place.
+  void Forward(vtkImageComplex *x);
+
+  int N;
+
+protected:
+  void Stage2(int m, int s, const vtkImageComplex *x, vtkImageComplex *y);
+  void Stage4(int m, int s, const vtkImageComplex *x, vtkImageComplex *y);
+  void StageN(int r, int m, int s, const vtkImageComplex *x,
+              vtkImageComplex *y);
+
+  vtkstd::vector<int> Factors;
+  // Roots[t] = exp(-2*pi*i*t/N)
+  vtkstd::vector<vtkImageComplex> Roots;
+  vtkstd::vector<vtkImageComplex> Work;
+
+  // Bluestein: the chirp exp(-pi*i*k^2/N), the transform of its conjugate
+  // and the plan of the convolutions.
+  vtkImageFourierFilterPlan *Convolution;
+  vtkstd::vector<vtkImageComplex> Chirp;
+  vtkstd::vector<vtkImageComplex> ChirpFft;
+  vtkstd::vector<vtkImageComplex> ConvolutionWork;
+
+private:
+  vtkImageFourierFilterPlan(const vtkImageFourierFilterPlan&);  // Not implemented.
+  void operator=(const vtkImageFourierFilterPlan&);  // Not implemented.
+};
+
+//----------------------------------------------------------------------------
+vtkImageFourierFilterPlan::vtkImageFourierFilterPlan(int n)
+{
+  int idx;
+  this->N = n;
+  this->Convolution = NULL;
+
+  // Factor N, with the factors of 4 first.
+  int rest = n;
+  while (rest % 4 == 0)
+    {
+    this->Factors.push_back(4);
+    rest /= 4;
+    }
+  int f = 2;
+  while (rest > 1 && f <= VTK_IMAGE_FFT_MAX_RADIX)
+    {
+    if (rest % f == 0)
+      {
+      this->Factors.push_back(f);
+      rest /= f;
+      }
+    else
+      {
+      ++f;
+      }
+    }
+
+  if (rest > 1)
+    {
+    // Convolve with the chirp over a power of two length.
+    this->Factors.clear();
+    int m = 1;
+    while (m < 2 * n - 1)
+      {
+      m *= 2;
+      }
+    this->Convolution = new vtkImageFourierFilterPlan(m);
+    this->Chirp.resize(n);
+    this->ChirpFft.resize(m);
+    this->ConvolutionWork.resize(m);
+    for (idx = 0; idx < m; ++idx)
+      {
+      vtkImageComplexEuclidSet(this->ChirpFft[idx], 0.0, 0.0);
+      }
+    for (idx = 0; idx < n; ++idx)
+      {
+      // k^2 mod 2N keeps the angle accurate for long lines.
+      double k2 = static_cast<double>(
+        (static_cast<vtkTypeInt64>(idx) * idx) %
+        (2 * static_cast<vtkTypeInt64>(n)));
+      double angle = -vtkMath::DoublePi() * k2 / n;
+      vtkImageComplexEuclidSet(this->Chirp[idx], cos(angle), sin(angle));
+      vtkImageComplexConjugate(this->Chirp[idx], this->ChirpFft[idx]);
+      if (idx > 0)
+        {
+        this->ChirpFft[m - idx] = this->ChirpFft[idx];
+        }
+      }
+    this->Convolution->Forward(&this->ChirpFft[0]);
+    return;
+    }
+
+  this->Roots.resize(n);
+  for (idx = 0; idx < n; ++idx)
+    {
+    double angle = -2.0 * vtkMath::DoublePi() * idx / n;
+    vtkImageComplexEuclidSet(this->Roots[idx], cos(angle), sin(angle));
+    }
+  this->Work.resize(n);
+}
+
+//----------------------------------------------------------------------------
+vtkImageFourierFilterPlan::~vtkImageFourierFilterPlan()
+{
+  delete this->Convolution;
+}
+
+//----------------------------------------------------------------------------
+// One radix-2 stage: x holds s interleaved transforms of length 2m.
+void vtkImageFourierFilterPlan::Stage2(int m, int s, const vtkImageComplex *x,
+                                       vtkImageComplex *y)
+{
+  for (int p = 0; p < m; ++p)
+    {
+    const vtkImageComplex w = this->Roots[p * s];
+    const vtkImageComplex *x0 = x + s * p;
+    const vtkImageComplex *x1 = x + s * (p + m);
+    vtkImageComplex *y0 = y + s * 2 * p;
+    vtkImageComplex *y1 = y0 + s;
+    for (int q = 0; q < s; ++q)
+      {
+      double ar = x0[q].Real, ai = x0[q].Imag;
+      double br = x1[q].Real, bi = x1[q].Imag;
+      double dr = ar - br, di = ai - bi;
+      y0[q].Real = ar + br;
+      y0[q].Imag = ai + bi;
+      y1[q].Real = dr * w.Real - di * w.Imag;
+      y1[q].Imag = dr * w.Imag + di * w.Real;
+      }
+    }
+}
+
+//----------------------------------------------------------------------------
+// One radix-4 stage: x holds s interleaved transforms of length 4m.
+void vtkImageFourierFilterPlan::Stage4(int m, int s, const vtkImageComplex *x,
+                                       vtkImageComplex *y)
+{
+  for (int p = 0; p < m; ++p)
+    {
+    const vtkImageComplex w1 = this->Roots[p * s];
+    const vtkImageComplex w2 = this->Roots[2 * p * s];
+    const vtkImageComplex w3 = this->Roots[3 * p * s];
+    const vtkImageComplex *x0 = x + s * p;
+    const vtkImageComplex *x1 = x + s * (p + m);
+    const vtkImageComplex *x2 = x + s * (p + 2 * m);
+    const vtkImageComplex *x3 = x + s * (p + 3 * m);
+    vtkImageComplex *y0 = y + s * 4 * p;
+    vtkImageComplex *y1 = y0 + s;
+    vtkImageComplex *y2 = y1 + s;
+    vtkImageComplex *y3 = y2 + s;
+    for (int q = 0; q < s; ++q)
+      {
+      double s02r = x0[q].Real + x2[q].Real, s02i = x0[q].Imag + x2[q].Imag;
+      double d02r = x0[q].Real - x2[q].Real, d02i = x0[q].Imag - x2[q].Imag;
+      double s13r = x1[q].Real + x3[q].Real, s13i = x1[q].Imag + x3[q].Imag;
+      double d13r = x1[q].Real - x3[q].Real, d13i = x1[q].Imag - x3[q].Imag;
+      // (a0 - a2) -/+ i (a1 - a3)
+      double t1r = d02r + d13i, t1i = d02i - d13r;
+      double t3r = d02r - d13i, t3i = d02i + d13r;
+      double t2r = s02r - s13r, t2i = s02i - s13i;
+      y0[q].Real = s02r + s13r;
+      y0[q].Imag = s02i + s13i;
+      y1[q].Real = t1r * w1.Real - t1i * w1.Imag;
+      y1[q].Imag = t1r * w1.Imag + t1i * w1.Real;
+      y2[q].Real = t2r * w2.Real - t2i * w2.Imag;
+      y2[q].Imag = t2r * w2.Imag + t2i * w2.Real;
+      y3[q].Real = t3r * w3.Real - t3i * w3.Imag;
+      y3[q].Imag = t3r * w3.Imag + t3i * w3.Real;
+      }
+    }
+}
+
+//----------------------------------------------------------------------------
+// One stage of any radix r: x holds s interleaved transforms of length rm.
+void vtkImageFourierFilterPlan::StageN(int r, int m, int s,
+                                       const vtkImageComplex *x,
+                                       vtkImageComplex *y)
+{
+  vtkImageComplex a[VTK_IMAGE_FFT_MAX_RADIX];
+  int rootStep = this->N / r;
+  for (int p = 0; p < m; ++p)
+    {
+    for (int q = 0; q < s; ++q)
+      {
+      int j, k;
+      for (j = 0; j < r; ++j)
+        {
+        a[j] = x[q + s * (p + j * m)];
+        }
+      for (k = 0; k < r; ++k)
+        {
+        double sumr = 0.0, sumi = 0.0;
+        for (j = 0; j < r; ++j)
+          {
+          const vtkImageComplex &w = this->Roots[((j * k) % r) * rootStep];
+          sumr += a[j].Real * w.Real - a[j].Imag * w.Imag;
+          sumi += a[j].Real * w.Imag + a[j].Imag * w.Real;
+          }
+        const vtkImageComplex &w = this->Roots[k * p * s];
+        y[q + s * (r * p + k)].Real = sumr * w.Real - sumi * w.Imag;
+        y[q + s * (r * p + k)].Imag = sumr * w.Imag + sumi * w.Real;
+        }
+      }
+    }
+}
+
+//----------------------------------------------------------------------------
+void vtkImageFourierFilterPlan::Forward(vtkImageComplex *x)
+{
+  int idx;
+  if (this->Convolution)
+    {
+    // X[k] = c[k] * sum_j (x[j] c[j]) conj(c[k - j])
+    int m = this->Convolution->N;
+    vtkImageComplex *a = &this->ConvolutionWork[0];
+    for (idx = 0; idx < this->N; ++idx)
+      {
+      vtkImageComplexMultiply(x[idx], this->Chirp[idx], a[idx]);
+      }
+    for (idx = this->N; idx < m; ++idx)
+      {
+      vtkImageComplexEuclidSet(a[idx], 0.0, 0.0);
+      }
+    this->Convolution->Forward(a);
+    // The inverse transform is the conjugate of the forward transform of
+    // the conjugate.
+    for (idx = 0; idx < m; ++idx)
+      {
+      vtkImageComplexMultiply(a[idx], this->ChirpFft[idx], a[idx]);
+      a[idx].Imag = -a[idx].Imag;
+      }
+    this->Convolution->Forward(a);
+    double scale = 1.0 / m;
+    for (idx = 0; idx < this->N; ++idx)
+      {
+      a[idx].Real *= scale;
+      a[idx].Imag *= -scale;
+      vtkImageComplexMultiply(a[idx], this->Chirp[idx], x[idx]);
+      }
+    return;
+    }
+
+  vtkImageComplex *in = x;
+  vtkImageComplex *out = &this->Work[0];
+  int n = this->N;
+  int s = 1;
+  for (size_t f = 0; f < this->Factors.size(); ++f)
+    {
+    int r = this->Factors[f];
+    int m = n / r;
+    if (r == 4)
+      {
+      this->Stage4(m, s, in, out);
+      }
+    else if (r == 2)
+      {
+      this->Stage2(m, s, in, out);
+      }
+    else
+      {
+      this->StageN(r, m, s, in, out);
+      }
+    vtkImageComplex *tmp = in;
+    in = out;
+    out = tmp;
+    n = m;
+    s *= r;
+    }
+  if (in != x)
+    {
+    for (idx = 0; idx < this->N; ++idx)
+      {
+      x[idx] = in[idx];
+      }
+    }
+}
+
+//----------------------------------------------------------------------------
+// The plans used by ExecuteFft(in, out, N) and ExecuteRfft(in, out, N). A
+// plan holds work space, so a thread takes a plan out of the cache for the
+// time of a transform and puts it back after.
+#define VTK_IMAGE_FFT_CACHED_PLANS 16
+
+class vtkImageFourierFilterPlanCache
+{
+public:
+  ~vtkImageFourierFilterPlanCache()
+    {
+    for (size_t i = 0; i < this->Plans.size(); ++i)
+      {
+      delete this->Plans[i];
+      }
+    }
+
+  vtkSimpleCriticalSection Lock;
+  vtkstd::vector<vtkImageFourierFilterPlan *> Plans;
+};
+
+//----------------------------------------------------------------------------
+vtkImageFourierFilter::vtkImageFourierFilter()
+{
+  this->FftAlgorithm = VTK_IMAGE_FFT_FAST;
+  this->InverseTransform = 0;
+  this->PlanCache = new vtkImageFourierFilterPlanCache;
+}
+
+//----------------------------------------------------------------------------
+vtkImageFourierFilter::~vtkImageFourierFilter()
+{
+  delete this->PlanCache;
+}
+
+//----------------------------------------------------------------------------
+vtkImageFourierFilterPlan *vtkImageFourierFilter::TakeCachedPlan(int N)
+{
+  vtkImageFourierFilterPlan *plan = NULL;
+  this->PlanCache->Lock.Lock();
+  vtkstd::vector<vtkImageFourierFilterPlan *> &plans = this->PlanCache->Plans;
+  for (size_t i = plans.size(); i > 0; --i)
+    {
+    if (plans[i - 1]->N == N)
+      {
+      plan = plans[i - 1];
+      plans.erase(plans.begin() + (i - 1));
+      break;
+      }
+    }
+  this->PlanCache->Lock.Unlock();
+
+  return (plan ? plan : new vtkImageFourierFilterPlan(N));
+}
+
+//----------------------------------------------------------------------------
+void vtkImageFourierFilter::ReturnCachedPlan(vtkImageFourierFilterPlan *plan)
+{
+  vtkImageFourierFilterPlan *oldest = NULL;
+  this->PlanCache->Lock.Lock();
+  vtkstd::vector<vtkImageFourierFilterPlan *> &plans = this->PlanCache->Plans;
+  plans.push_back(plan);
+  if (plans.size() > VTK_IMAGE_FFT_CACHED_PLANS)
+    {
+    oldest = plans[0];
+    plans.erase(plans.begin());
+    }
+  this->PlanCache->Lock.Unlock();
+
+  delete oldest;
+}
+
 
 
 /*=========================================================================
@@ -218,6 +593,13 @@ void vtkImageFourierFilter::ExecuteFftForwardBackward(vtkImageComplex *in,
 void vtkImageFourierFilter::ExecuteFft(vtkImageComplex *in, 
                                        vtkImageComplex *out, int N)
 {
+  if (this->FftAlgorithm == VTK_IMAGE_FFT_FAST)
+    {
+    vtkImageFourierFilterPlan *plan = this->TakeCachedPlan(N);
+    this->ExecuteFft(plan, in, out);
+    this->ReturnCachedPlan(plan);
+    return;
+    }
   this->ExecuteFftForwardBackward(in, out, N, 1);
 }
 
@@ -228,7 +610,489 @@ void vtkImageFourierFilter::ExecuteFft(vtkImageComplex *in,
 void vtkImageFourierFilter::ExecuteRfft(vtkImageComplex *in, 
                                         vtkImageComplex *out, int N)
 {
+  if (this->FftAlgorithm == VTK_IMAGE_FFT_FAST)
+    {
+    vtkImageFourierFilterPlan *plan = this->TakeCachedPlan(N);
+    this->ExecuteRfft(plan, in, out);
+    this->ReturnCachedPlan(plan);
+    return;
+    }
   this->ExecuteFftForwardBackward(in, out, N, -1);
 }
+
+//----------------------------------------------------------------------------
+vtkImageFourierFilterPlan *vtkImageFourierFilter::NewFftPlan(int N)
+{
+  return new vtkImageFourierFilterPlan(N);
+}
+
+//----------------------------------------------------------------------------
+void vtkImageFourierFilter::DeleteFftPlan(vtkImageFourierFilterPlan *plan)
+{
+  delete plan;
+}
+
+//----------------------------------------------------------------------------
+void vtkImageFourierFilter::ExecuteFft(vtkImageFourierFilterPlan *plan,
+                                       vtkImageComplex *in,
+                                       vtkImageComplex *out)
+{
+  if (out != in)
+    {
+    for (int idx = 0; idx < plan->N; ++idx)
+      {
+      out[idx] = in[idx];
+      }
+    }
+  plan->Forward(out);
+}
+
+//----------------------------------------------------------------------------
+// The inverse transform is the conjugate of the forward transform of the
+// conjugate, scaled by 1/N.
+void vtkImageFourierFilter::ExecuteRfft(vtkImageFourierFilterPlan *plan,
+                                        vtkImageComplex *in,
+                                        vtkImageComplex *out)
+{
+  int idx, N = plan->N;
+  for (idx = 0; idx < N; ++idx)
+    {
+    vtkImageComplexConjugate(in[idx], out[idx]);
+    }
+  plan->Forward(out);
+  double scale = 1.0 / N;
+  for (idx = 0; idx < N; ++idx)
+    {
+    out[idx].Real *= scale;
+    out[idx].Imag *= -scale;
+    }
+}
+
+//----------------------------------------------------------------------------
+// With z = a + i b, A[k] = (Z[k] + conj(Z[N-k])) / 2 and
+// B[k] = (Z[k] - conj(Z[N-k])) / 2i.
+void vtkImageFourierFilter::ExecuteFftOfRealPair(
+  vtkImageFourierFilterPlan *plan, vtkImageComplex *in,
+  vtkImageComplex *out1, vtkImageComplex *out2)
+{
+  int N = plan->N;
+  this->ExecuteFft(plan, in, out1);
+  for (int k = 0; k <= N / 2; ++k)
+    {
+    int mk = (N - k) % N;
+    vtkImageComplex zk = out1[k];
+    vtkImageComplex zm = out1[mk];
+    vtkImageComplexEuclidSet(out1[k], 0.5 * (zk.Real + zm.Real),
+                             0.5 * (zk.Imag - zm.Imag));
+    vtkImageComplexEuclidSet(out2[k], 0.5 * (zk.Imag + zm.Imag),
+                             0.5 * (zm.Real - zk.Real));
+    vtkImageComplexConjugate(out1[k], out1[mk]);
+    vtkImageComplexConjugate(out2[k], out2[mk]);
+    }
+}
+
+/*=========================================================================
+        Transform of all the axes in a single execution.
+=========================================================================*/
+
+//----------------------------------------------------------------------------
+// The lines along one axis. The axes are permuted so that axis 0 is along
+// the lines and axis 1 is the other axis with the lowest index, so that the
+// lines of a block are next to each other along x for the y and z axes.
+// The input lines have Size0 numbers, of which OutSize0 from OutOffset0 are
+// written to the output.
+class vtkImageFourierFilterPass
+{
+public:
+  vtkImageFourierFilter *Filter;
+  int Inverse;
+  int Pass;
+  int NumberOfPasses;
+
+  int InScalarType;
+  int InComponents;
+  void *InPtr;
+  vtkIdType InIncrements[3];
+
+  double *OutPtr;
+  vtkIdType OutIncrements[3];
+
+  int Size0;
+  int OutOffset0;
+  int OutSize0;
+  int Size1;
+  int Size2;
+};
+
+//----------------------------------------------------------------------------
+template <class T>
+void vtkImageFourierFilterExecutePass(vtkImageFourierFilterPass *pass, T *,
+                                      int id, int numThreads)
+{
+  vtkImageFourierFilter *self = pass->Filter;
+  int size0 = pass->Size0;
+  vtkIdType *inInc = pass->InIncrements;
+  vtkIdType *outInc = pass->OutIncrements;
+  // transform two real lines at once
+  int realPairs = (!pass->Inverse && pass->InComponents == 1);
+
+  vtkImageFourierFilterPlan *plan = self->NewFftPlan(size0);
+  vtkImageComplex *inComplex =
+    new vtkImageComplex[size0 * VTK_IMAGE_FFT_BLOCK_SIZE];
+  vtkImageComplex *outComplex =
+    new vtkImageComplex[size0 * VTK_IMAGE_FFT_BLOCK_SIZE];
+
+  // split the blocks of lines between the threads
+  vtkIdType blocks1 =
+    (pass->Size1 + VTK_IMAGE_FFT_BLOCK_SIZE - 1) / VTK_IMAGE_FFT_BLOCK_SIZE;
+  vtkIdType numBlocks = blocks1 * pass->Size2;
+  vtkIdType beginBlock = numBlocks * id / numThreads;
+  vtkIdType endBlock = numBlocks * (id + 1) / numThreads;
+  vtkIdType target = (endBlock - beginBlock) / 50 + 1;
+
+  for (vtkIdType block = beginBlock;
+       block < endBlock && !self->AbortExecute; ++block)
+    {
+    if (id == 0 && (block - beginBlock) % target == 0)
+      {
+      self->UpdateProgress(
+        (pass->Pass + static_cast<double>(block - beginBlock) /
+         (endBlock - beginBlock)) / pass->NumberOfPasses);
+      }
+    vtkIdType idx2 = block / blocks1;
+    int idx1 = static_cast<int>(block % blocks1) * VTK_IMAGE_FFT_BLOCK_SIZE;
+    int numLines = pass->Size1 - idx1;
+    if (numLines > VTK_IMAGE_FFT_BLOCK_SIZE)
+      {
+      numLines = VTK_IMAGE_FFT_BLOCK_SIZE;
+      }
+    int idx0, line;
+    vtkImageComplex *pComplex;
+    vtkImageComplex *qComplex;
+
+    // copy into complex numbers
+    T *inPtr0 = static_cast<T *>(pass->InPtr) + idx2 * inInc[2] +
+      idx1 * inInc[1];
+    for (idx0 = 0; idx0 < size0; ++idx0)
+      {
+      T *inPtrLine = inPtr0;
+      pComplex = inComplex + idx0;
+      for (line = 0; line < numLines; ++line)
+        {
+        pComplex->Real = static_cast<double>(*inPtrLine);
+        pComplex->Imag = 0.0;
+        if (pass->InComponents > 1)
+          {
+          pComplex->Imag = static_cast<double>(inPtrLine[1]);
+          }
+        inPtrLine += inInc[1];
+        pComplex += size0;
+        }
+      inPtr0 += inInc[0];
+      }
+
+    // transform
+    for (line = 0; line < numLines; ++line)
+      {
+      pComplex = inComplex + line * size0;
+      qComplex = outComplex + line * size0;
+      if (pass->Inverse)
+        {
+        self->ExecuteRfft(plan, pComplex, qComplex);
+        }
+      else if (realPairs && line + 1 < numLines)
+        {
+        for (idx0 = 0; idx0 < size0; ++idx0)
+          {
+          pComplex[idx0].Imag = pComplex[idx0 + size0].Real;
+          }
+        self->ExecuteFftOfRealPair(plan, pComplex, qComplex,
+                                   qComplex + size0);
+        ++line;
+        }
+      else
+        {
+        self->ExecuteFft(plan, pComplex, qComplex);
+        }
+      }
+
+    // copy into the output, which may be the input
+    double *outPtr0 = pass->OutPtr + idx2 * outInc[2] + idx1 * outInc[1];
+    for (idx0 = 0; idx0 < pass->OutSize0; ++idx0)
+      {
+      double *outPtrLine = outPtr0;
+      pComplex = outComplex + pass->OutOffset0 + idx0;
+      for (line = 0; line < numLines; ++line)
+        {
+        outPtrLine[0] = pComplex->Real;
+        outPtrLine[1] = pComplex->Imag;
+        outPtrLine += outInc[1];
+        pComplex += size0;
+        }
+      outPtr0 += outInc[0];
+      }
+    }
+
+  self->DeleteFftPlan(plan);
+  delete [] inComplex;
+  delete [] outComplex;
+}
+
+//----------------------------------------------------------------------------
+static VTK_THREAD_RETURN_TYPE vtkImageFourierFilterPassThread(void *arg)
+{
+  vtkMultiThreader::ThreadInfo *info =
+    static_cast<vtkMultiThreader::ThreadInfo *>(arg);
+  vtkImageFourierFilterPass *pass =
+    static_cast<vtkImageFourierFilterPass *>(info->UserData);
+
+  switch (pass->InScalarType)
+    {
+    vtkTemplateMacro(
+      vtkImageFourierFilterExecutePass(pass, static_cast<VTK_TT *>(0),
+                                       info->ThreadID,
+                                       info->NumberOfThreads));
+    }
+
+  return VTK_THREAD_RETURN_VALUE;
+}
+
+//----------------------------------------------------------------------------
+// The input extent needed for an output extent: the whole extent along the
+// transformed axes.
+static void vtkImageFourierFilterInputExtent(int dimensionality,
+                                             const int outExt[6],
+                                             const int wholeExt[6],
+                                             int inExt[6])
+{
+  for (int axis = 0; axis < 3; ++axis)
+    {
+    inExt[2*axis] = outExt[2*axis];
+    inExt[2*axis+1] = outExt[2*axis+1];
+    if (axis < dimensionality)
+      {
+      inExt[2*axis] = wholeExt[2*axis];
+      inExt[2*axis+1] = wholeExt[2*axis+1];
+      }
+    }
+}
+
+//----------------------------------------------------------------------------
+int vtkImageFourierFilter::RequestUpdateExtent(
+  vtkInformation* request,
+  vtkInformationVector** inputVector,
+  vtkInformationVector* outputVector)
+{
+  if (this->FftAlgorithm != VTK_IMAGE_FFT_FAST)
+    {
+    return this->Superclass::RequestUpdateExtent(request, inputVector,
+                                                 outputVector);
+    }
+
+  vtkInformation* inInfo = inputVector[0]->GetInformationObject(0);
+  vtkInformation* outInfo = outputVector->GetInformationObject(0);
+  int *outExt = outInfo->Get(vtkStreamingDemandDrivenPipeline::UPDATE_EXTENT());
+  int *wholeExt = inInfo->Get(vtkStreamingDemandDrivenPipeline::WHOLE_EXTENT());
+  int inExt[6];
+  vtkImageFourierFilterInputExtent(this->Dimensionality, outExt, wholeExt,
+                                   inExt);
+  inInfo->Set(vtkStreamingDemandDrivenPipeline::UPDATE_EXTENT(), inExt, 6);
+
+  return 1;
+}
+
+//----------------------------------------------------------------------------
+// Transform the axes one after the other. The first axis reads the input and
+// the last one writes the output. In between, the lines are transformed in
+// place in a double image of the input extent, which is the output itself
+// when the extents are the same. Each axis only computes the numbers that
+// the next axes use: the lines over the whole extent of the axes that are
+// still to be transformed, and over the output extent of the others.
+int vtkImageFourierFilter::RequestData(vtkInformation* request,
+                                       vtkInformationVector** inputVector,
+                                       vtkInformationVector* outputVector)
+{
+  if (this->FftAlgorithm != VTK_IMAGE_FFT_FAST)
+    {
+    return this->Superclass::RequestData(request, inputVector, outputVector);
+    }
+
+  vtkInformation* inInfo = inputVector[0]->GetInformationObject(0);
+  vtkInformation* outInfo = outputVector->GetInformationObject(0);
+  vtkImageData *inData =
+    vtkImageData::SafeDownCast(inInfo->Get(vtkDataObject::DATA_OBJECT()));
+  vtkImageData *outData =
+    vtkImageData::SafeDownCast(outInfo->Get(vtkDataObject::DATA_OBJECT()));
+
+  int outExt[6];
+  outInfo->Get(vtkStreamingDemandDrivenPipeline::UPDATE_EXTENT(), outExt);
+  this->AllocateOutputData(outData, outExt);
+
+  // this filter expects that the output be doubles.
+  if (outData->GetScalarType() != VTK_DOUBLE ||
+      outData->GetNumberOfScalarComponents() != 2)
+    {
+    vtkErrorMacro(<< "Execute: Output must be complex doubles.");
+    return 0;
+    }
+  if (inData->GetNumberOfScalarComponents() < 1)
+    {
+    vtkErrorMacro(<< "Execute: No real components");
+    return 0;
+    }
+
+  int inExt[6];
+  vtkImageFourierFilterInputExtent(this->Dimensionality, outExt,
+                                   inData->GetWholeExtent(), inExt);
+  int workExt[6];
+  int inPlace = 1;
+  int axis;
+  for (axis = 0; axis < 6; ++axis)
+    {
+    workExt[axis] = inExt[axis];
+    inPlace = (inPlace && inExt[axis] == outExt[axis]);
+    }
+
+  // the image of the intermediate transforms
+  double *outPtr = static_cast<double *>(outData->GetScalarPointer());
+  vtkIdType *outIncrements = outData->GetIncrements();
+  double *workPtr = outPtr;
+  vtkIdType workIncrements[3] = { outIncrements[0], outIncrements[1],
+                                  outIncrements[2] };
+  if (!inPlace && this->Dimensionality > 1)
+    {
+    workIncrements[0] = 2;
+    workIncrements[1] = 2 * static_cast<vtkIdType>(inExt[1] - inExt[0] + 1);
+    workIncrements[2] =
+      workIncrements[1] * static_cast<vtkIdType>(inExt[3] - inExt[2] + 1);
+    workPtr = new double[
+      workIncrements[2] * static_cast<vtkIdType>(inExt[5] - inExt[4] + 1)];
+    }
+
+  vtkImageFourierFilterPass pass;
+  pass.Filter = this;
+  pass.Inverse = this->InverseTransform;
+  pass.NumberOfPasses = this->Dimensionality;
+
+  for (axis = 0; axis < this->Dimensionality && !this->AbortExecute; ++axis)
+    {
+    // the axes of the lines, of the blocks and of the rest
+    int axes[3] = { axis, (axis == 0 ? 1 : 0), (axis == 2 ? 1 : 2) };
+
+    // the first index of the lines to compute, and their numbers
+    int lineMin[3];
+    int lineSize[3];
+    for (int i = 0; i < 3; ++i)
+      {
+      int a = axes[i];
+      const int *ext = (a > axis ? inExt : outExt);
+      lineMin[a] = ext[2*a];
+      lineSize[a] = ext[2*a+1] - ext[2*a] + 1;
+      }
+    lineMin[axis] = inExt[2*axis];
+    lineSize[axis] = inExt[2*axis+1] - inExt[2*axis] + 1;
+
+    // read the input, or the transforms of the previous axis
+    const int *srcExt = inExt;
+    char *srcPtr;
+    vtkIdType *srcIncrements;
+    vtkIdType inIncrements[3];
+    if (axis == 0)
+      {
+      pass.InScalarType = inData->GetScalarType();
+      pass.InComponents = inData->GetNumberOfScalarComponents();
+      inData->GetIncrements(inIncrements);
+      srcIncrements = inIncrements;
+      srcPtr = static_cast<char *>(inData->GetScalarPointerForExtent(inExt));
+      }
+    else
+      {
+      pass.InScalarType = VTK_DOUBLE;
+      pass.InComponents = 2;
+      srcIncrements = workIncrements;
+      srcPtr = reinterpret_cast<char *>(workPtr);
+      }
+    int scalarSize = vtkDataArray::GetDataTypeSize(pass.InScalarType);
+    for (int i = 0; i < 3; ++i)
+      {
+      int a = axes[i];
+      pass.InIncrements[i] = srcIncrements[a];
+      srcPtr += (lineMin[a] - srcExt[2*a]) * srcIncrements[a] * scalarSize;
+      }
+    pass.InPtr = srcPtr;
+
+    // write the output, or the intermediate image
+    const int *dstExt = outExt;
+    double *dstPtr = outPtr;
+    vtkIdType *dstIncrements = outIncrements;
+    if (axis + 1 < this->Dimensionality)
+      {
+      dstExt = workExt;
+      dstPtr = workPtr;
+      dstIncrements = workIncrements;
+      }
+    for (int i = 0; i < 3; ++i)
+      {
+      int a = axes[i];
+      int first = (a == axis ? outExt[2*a] : lineMin[a]);
+      pass.OutIncrements[i] = dstIncrements[a];
+      dstPtr += (first - dstExt[2*a]) * dstIncrements[a];
+      }
+    pass.OutPtr = dstPtr;
+
+    pass.Pass = axis;
+    pass.Size0 = lineSize[axis];
+    pass.OutOffset0 = outExt[2*axis] - inExt[2*axis];
+    pass.OutSize0 = outExt[2*axis+1] - outExt[2*axis] + 1;
+    pass.Size1 = lineSize[axes[1]];
+    pass.Size2 = lineSize[axes[2]];
+
+    vtkIdType numBlocks = pass.Size2 *
+      ((pass.Size1 + VTK_IMAGE_FFT_BLOCK_SIZE - 1) / VTK_IMAGE_FFT_BLOCK_SIZE);
+    int numThreads = this->NumberOfThreads;
+    if (numBlocks < numThreads)
+      {
+      numThreads = static_cast<int>(numBlocks);
+      }
+    if (numThreads <= 1)
+      {
+      switch (pass.InScalarType)
+        {
+        vtkTemplateMacro(
+          vtkImageFourierFilterExecutePass(&pass, static_cast<VTK_TT *>(0),
+                                           0, 1));
+        default:
+          vtkErrorMacro(<< "Execute: Unknown ScalarType");
+        }
+      }
+    else
+      {
+      this->Threader->SetNumberOfThreads(numThreads);
+      this->Threader->SetSingleMethod(vtkImageFourierFilterPassThread, &pass);
+      this->Threader->SingleMethodExecute();
+      }
+    }
+
+  if (workPtr != outPtr)
+    {
+    delete [] workPtr;
+    }
+
+  if (inInfo->Get(vtkDemandDrivenPipeline::RELEASE_DATA()))
+    {
+    inData->ReleaseData();
+    }
+
+  return 1;
+}
+
+//----------------------------------------------------------------------------
+void vtkImageFourierFilter::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os,indent);
+
+  os << indent << "FftAlgorithm: "
+     << (this->FftAlgorithm == VTK_IMAGE_FFT_FAST ? "Fast" : "Legacy") << "\n";
+}
  
 
@@ -81,14 +81,42 @@ typedef struct{
 }
 
 /******************* End of COMPLEX number stuff ********************/
+
+class vtkImageFourierFilterPlan;
+class vtkImageFourierFilterPlanCache;
 //ETX
 
+#define VTK_IMAGE_FFT_LEGACY 0
+#define VTK_IMAGE_FFT_FAST   1
+
+// Number of lines that the subclasses copy and transform together.
+#define VTK_IMAGE_FFT_BLOCK_SIZE 8
+
 class VTK_IMAGING_EXPORT vtkImageFourierFilter : public vtkImageDecomposeFilter
 {
 public:
   vtkTypeMacro(vtkImageFourierFilter,vtkImageDecomposeFilter);
-  
-  
+  void PrintSelf(ostream& os, vtkIndent indent);
+
+  // Description:
+  // Select how the lines are transformed. The fast transform (the default)
+  // precomputes the twiddle factors of each line length once per axis, uses
+  // radix-4 and radix-2 butterflies for the powers of two, small radix
+  // butterflies for the other smooth lengths and the Bluestein algorithm for
+  // the lengths with large prime factors, and transforms two real lines with
+  // a single complex transform. It also transforms all the axes in a single
+  // execution, in place in the output when the output extent covers the
+  // whole extent along the transformed axes, instead of one execution and
+  // one intermediate image per axis. The legacy transform is the mixed
+  // radix transform of the earlier versions, which is O(N^2) for prime
+  // lengths.
+  vtkSetClampMacro(FftAlgorithm, int, VTK_IMAGE_FFT_LEGACY, VTK_IMAGE_FFT_FAST);
+  vtkGetMacro(FftAlgorithm, int);
+  void SetFftAlgorithmToLegacy()
+    { this->SetFftAlgorithm(VTK_IMAGE_FFT_LEGACY); }
+  void SetFftAlgorithmToFast()
+    { this->SetFftAlgorithm(VTK_IMAGE_FFT_FAST); }
+
   // public for templated functions of this object
   //BTX
 
@@ -96,6 +124,9 @@ public:
   // This function calculates the whole fft of an array.
   // The contents of the input array are changed.
   // (It is engineered for no decimation)
+  // With the fast transform, the plans of the recent lengths are kept by
+  // the filter, so calling this for many lines of the same length builds
+  // the plan only once.
   void ExecuteFft(vtkImageComplex *in, vtkImageComplex *out, int N);
 
 
@@ -105,11 +136,57 @@ public:
   // (It is engineered for no decimation)
   void ExecuteRfft(vtkImageComplex *in, vtkImageComplex *out, int N);
 
+  // Description:
+  // Create the plan of the fast transforms of N complex numbers. The plan
+  // holds the twiddle factors and the work space of the transforms, so a
+  // thread can reuse it for all its lines, but it cannot be shared by
+  // several threads. It must be deleted with DeleteFftPlan().
+  vtkImageFourierFilterPlan *NewFftPlan(int N);
+  void DeleteFftPlan(vtkImageFourierFilterPlan *plan);
+
+  // Description:
+  // These functions calculate the fft and the rfft of an array with a plan.
+  // The input array is not changed, and may be the output array.
+  void ExecuteFft(vtkImageFourierFilterPlan *plan,
+                  vtkImageComplex *in, vtkImageComplex *out);
+  void ExecuteRfft(vtkImageFourierFilterPlan *plan,
+                   vtkImageComplex *in, vtkImageComplex *out);
+
+  // Description:
+  // This function calculates the fft of two real arrays with a single
+  // complex fft. The first array is given in the real parts of in and the
+  // second in the imaginary parts, and their transforms are returned in
+  // out1 and out2. Either output may be the input array.
+  void ExecuteFftOfRealPair(vtkImageFourierFilterPlan *plan,
+                            vtkImageComplex *in, vtkImageComplex *out1,
+                            vtkImageComplex *out2);
+
   //ETX
   
 protected:
-  vtkImageFourierFilter() {};
-  ~vtkImageFourierFilter() {};
+  vtkImageFourierFilter();
+  ~vtkImageFourierFilter();
+
+  // Description:
+  // With the fast transform, these transform all the axes in one
+  // execution. The legacy transform executes once per axis.
+  virtual int RequestUpdateExtent(vtkInformation*,
+                                  vtkInformationVector**,
+                                  vtkInformationVector*);
+  virtual int RequestData(vtkInformation*,
+                          vtkInformationVector**,
+                          vtkInformationVector*);
+
+  int FftAlgorithm;
+
+  // Set by the subclasses that compute the inverse transform.
+  int InverseTransform;
+
+  //BTX
+  vtkImageFourierFilterPlanCache *PlanCache;
+  vtkImageFourierFilterPlan *TakeCachedPlan(int N);
+  void ReturnCachedPlan(vtkImageFourierFilterPlan *plan);
+  //ETX
 
   //BTX
   void ExecuteFftStep2(vtkImageComplex *p_in, vtkImageComplex *p_out, 
@@ -15,9 +15,11 @@
 #include "vtkImageGaussianSmooth.h"
 
 #include "vtkImageData.h"
+#include "vtkImageRecursiveGaussianInternals.h"
 #include "vtkInformation.h"
 #include "vtkInformationVector.h"
 #include "vtkObjectFactory.h"
+#include "vtkPointData.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
 
 #include <math.h>
@@ -34,6 +36,7 @@ vtkImageGaussianSmooth::vtkImageGaussianSmooth()
   this->RadiusFactors[0] = 1.5;
   this->RadiusFactors[1] = 1.5;
   this->RadiusFactors[2] = 1.5;
+  this->Algorithm = VTK_GAUSSIAN_SMOOTH_CONVOLUTION;
 }
 
 //----------------------------------------------------------------------------
@@ -61,6 +64,10 @@ void vtkImageGaussianSmooth::PrintSelf(ostream& os, vtkIndent indent)
      << this->StandardDeviations[0] << ", "
      << this->StandardDeviations[1] << ", "
      << this->StandardDeviations[2] << " )\n";
+
+  os << indent << "Algorithm: "
+     << (this->Algorithm == VTK_GAUSSIAN_SMOOTH_RECURSIVE ?
+         "Recursive\n" : "Convolution\n");
 }
 
 //----------------------------------------------------------------------------
@@ -125,6 +132,14 @@ void vtkImageGaussianSmooth::InternalRequestUpdateExtent(int *inExt,
   // Expand filtered axes
   for (idx = 0; idx < this->Dimensionality; ++idx)
     {
+    // the recursive filters need the whole axis
+    if (this->Algorithm == VTK_GAUSSIAN_SMOOTH_RECURSIVE &&
+        this->StandardDeviations[idx] != 0.0)
+      {
+      inExt[idx*2] = wholeExtent[idx*2];
+      inExt[idx*2+1] = wholeExtent[idx*2+1];
+      continue;
+      }
     radius = static_cast<int>(this->StandardDeviations[idx]
                               * this->RadiusFactors[idx]);
     inExt[idx*2] -= radius;
@@ -464,3 +479,61 @@ void vtkImageGaussianSmooth::ThreadedRequestData(
       break;
     }  
 }
+
+//----------------------------------------------------------------------------
+// The recursive algorithm smooths a copy of the input in doubles.  Rather
+// than splitting the output extent, each axis is filtered by all the
+// threads at once, since every output pixel depends on whole lines.
+int vtkImageGaussianSmooth::RequestData(vtkInformation *request,
+                                        vtkInformationVector **inputVector,
+                                        vtkInformationVector *outputVector)
+{
+  if (this->Algorithm != VTK_GAUSSIAN_SMOOTH_RECURSIVE)
+    {
+    return this->Superclass::RequestData(request, inputVector, outputVector);
+    }
+
+  vtkInformation *inInfo = inputVector[0]->GetInformationObject(0);
+  vtkInformation *outInfo = outputVector->GetInformationObject(0);
+  vtkImageData *inData = vtkImageData::SafeDownCast(
+    inInfo->Get(vtkDataObject::DATA_OBJECT()));
+  vtkImageData *outData = vtkImageData::SafeDownCast(
+    outInfo->Get(vtkDataObject::DATA_OBJECT()));
+
+  int outExt[6];
+  outInfo->Get(vtkStreamingDemandDrivenPipeline::UPDATE_EXTENT(), outExt);
+  this->AllocateOutputData(outData, outExt);
+  this->CopyAttributeData(inData, outData, inputVector);
+
+  // this filter expects that input is the same type as output.
+  if (inData->GetScalarType() != outData->GetScalarType())
+    {
+    vtkErrorMacro("Execute: input ScalarType, "
+                  << inData->GetScalarType()
+                  << ", must match out ScalarType "
+                  << outData->GetScalarType());
+    return 0;
+    }
+
+  double sigmas[3];
+  for (int idx = 0; idx < 3; ++idx)
+    {
+    sigmas[idx] = (idx < this->Dimensionality ?
+                   this->StandardDeviations[idx] : 0.0);
+    }
+  // only the input needed for outExt is copied and smoothed
+  int inExt[6];
+  int *wholeExt = inData->GetExtent();
+  for (int idx = 0; idx < 6; ++idx)
+    {
+    inExt[idx] = outExt[idx];
+    }
+  this->InternalRequestUpdateExtent(inExt, wholeExt);
+  vtkImageData *smoothed = vtkImageRecursiveGaussianSmoothArray(
+    this, inData, inData->GetPointData()->GetScalars(), inExt, outExt,
+    sigmas, this->NumberOfThreads);
+  outData->CopyAndCastFrom(smoothed, outExt);
+  smoothed->Delete();
+
+  return 1;
+}
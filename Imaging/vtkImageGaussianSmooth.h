@@ -16,6 +16,12 @@
 // .SECTION Description
 // vtkImageGaussianSmooth implements a convolution of the input image
 // with a gaussian. Supports from one to three dimensional convolutions.
+//
+// By default the gaussian is truncated at RadiusFactors times the
+// StandardDeviations, so the cost per pixel grows with the standard
+// deviation.  The recursive algorithm instead approximates the gaussian
+// with recursive filters whose cost per pixel does not depend on the
+// standard deviation, which is much faster for large standard deviations.
 
 #ifndef __vtkImageGaussianSmooth_h
 #define __vtkImageGaussianSmooth_h
@@ -23,6 +29,9 @@
 
 #include "vtkThreadedImageAlgorithm.h"
 
+#define VTK_GAUSSIAN_SMOOTH_CONVOLUTION 0
+#define VTK_GAUSSIAN_SMOOTH_RECURSIVE 1
+
 class VTK_IMAGING_EXPORT vtkImageGaussianSmooth : public vtkThreadedImageAlgorithm
 {
 public:
@@ -69,6 +78,22 @@ public:
   vtkSetMacro(Dimensionality, int);
   vtkGetMacro(Dimensionality, int);
 
+  // Description:
+  // Set/Get the algorithm.  The default is Convolution, which convolves
+  // with the truncated gaussian kernel.  Recursive filters each axis with
+  // the fourth order recursive filters of Deriche, and ignores the
+  // RadiusFactors: the gaussian is not truncated, the boundary pixels are
+  // repeated instead of renormalizing the kernel, and the whole input
+  // extent is needed along the smoothed axes.  Standard deviations between
+  // zero and 0.5 pixels are raised to 0.5 by the recursive algorithm.
+  vtkSetClampMacro(Algorithm, int, VTK_GAUSSIAN_SMOOTH_CONVOLUTION,
+                   VTK_GAUSSIAN_SMOOTH_RECURSIVE);
+  vtkGetMacro(Algorithm, int);
+  void SetAlgorithmToConvolution()
+    { this->SetAlgorithm(VTK_GAUSSIAN_SMOOTH_CONVOLUTION); }
+  void SetAlgorithmToRecursive()
+    { this->SetAlgorithm(VTK_GAUSSIAN_SMOOTH_RECURSIVE); }
+
 protected:
   vtkImageGaussianSmooth();
   ~vtkImageGaussianSmooth();
@@ -76,10 +101,13 @@ protected:
   int Dimensionality;
   double StandardDeviations[3];
   double RadiusFactors[3];
+  int Algorithm;
   
   void ComputeKernel(double *kernel, int min, int max, double std);
   virtual int RequestUpdateExtent (vtkInformation *, vtkInformationVector **, vtkInformationVector *);
   void InternalRequestUpdateExtent(int *, int*);
+  virtual int RequestData(vtkInformation *, vtkInformationVector **,
+                          vtkInformationVector *);
   void ExecuteAxis(int axis, vtkImageData *inData, int inExt[6],
                    vtkImageData *outData, int outExt[6],
                    int *pcycle, int target, int *pcount, int total,
@@ -16,6 +16,7 @@
 
 #include "vtkDataArray.h"
 #include "vtkImageData.h"
+#include "vtkImageRecursiveGaussianInternals.h"
 #include "vtkInformation.h"
 #include "vtkInformationVector.h"
 #include "vtkObjectFactory.h"
@@ -33,6 +34,8 @@ vtkImageGradient::vtkImageGradient()
 {
   this->HandleBoundaries = 1;
   this->Dimensionality = 2;
+  this->StandardDeviation = 0.0;
+  this->SmoothedInput = 0;
   
   // by default process active point scalars
   this->SetInputArrayToProcess(0,0,0,vtkDataObject::FIELD_ASSOCIATION_POINTS,
@@ -45,6 +48,7 @@ void vtkImageGradient::PrintSelf(ostream& os, vtkIndent indent)
   this->Superclass::PrintSelf(os, indent);
   os << indent << "HandleBoundaries: " << this->HandleBoundaries << "\n";
   os << indent << "Dimensionality: " << this->Dimensionality << "\n";
+  os << indent << "StandardDeviation: " << this->StandardDeviation << "\n";
 }
 
 //----------------------------------------------------------------------------
@@ -103,6 +107,14 @@ int vtkImageGradient::RequestUpdateExtent(vtkInformation*,
   // input pixels than we are producing output pixels.
   for(int idx = 0; idx < this->Dimensionality; ++idx)
     {
+    // Smoothing the input needs the whole axis.
+    if (this->StandardDeviation > 0.0)
+      {
+      inUExt[idx*2] = wholeExtent[idx*2];
+      inUExt[idx*2+1] = wholeExtent[idx*2+1];
+      continue;
+      }
+
     inUExt[idx*2] -= 1;
     inUExt[idx*2+1] += 1;
 
@@ -241,7 +253,30 @@ int vtkImageGradient::RequestData(
   vtkInformationVector** inputVector,
   vtkInformationVector* outputVector)
 {
-  if (!this->Superclass::RequestData(request, inputVector, outputVector))
+  // Smooth the input once for all the threads
+  vtkDataArray* inputArray = this->GetInputArrayToProcess(0, inputVector);
+  if (this->StandardDeviation > 0.0 && inputArray)
+    {
+    double sigmas[3];
+    for (int idx = 0; idx < 3; ++idx)
+      {
+      sigmas[idx] =
+        (idx < this->Dimensionality ? this->StandardDeviation : 0.0);
+      }
+    vtkImageData* input = vtkImageData::GetData(inputVector[0]);
+    this->SmoothedInput = vtkImageRecursiveGaussianSmoothArray(
+      this, input, inputArray, input->GetExtent(), input->GetExtent(),
+      sigmas, this->NumberOfThreads);
+    }
+
+  int status = this->Superclass::RequestData(request, inputVector,
+                                             outputVector);
+  if (this->SmoothedInput)
+    {
+    this->SmoothedInput->Delete();
+    this->SmoothedInput = 0;
+    }
+  if (!status)
     {
     return 0;
     }
@@ -275,6 +310,14 @@ void vtkImageGradient::ThreadedRequestData(vtkInformation*,
   // Get the input and output data objects.
   vtkImageData* input = inData[0][0];
   vtkImageData* output = outData[0];
+  vtkDataArray* inputArray = this->GetInputArrayToProcess(0, inputVector);
+
+  // Use the smoothed input when computing the gradient at a scale
+  if (this->SmoothedInput)
+    {
+    input = this->SmoothedInput;
+    inputArray = input->GetPointData()->GetScalars();
+    }
 
   // The ouptut scalar type must be double to store proper gradients.
   if(output->GetScalarType() != VTK_DOUBLE)
@@ -284,7 +327,6 @@ void vtkImageGradient::ThreadedRequestData(vtkInformation*,
     return;
     }
 
-  vtkDataArray* inputArray = this->GetInputArrayToProcess(0, inputVector);
   if (!inputArray)
     {
     vtkErrorMacro("No input array was found. Cannot execute");
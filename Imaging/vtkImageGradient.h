@@ -19,6 +19,11 @@
 // determines whether to perform a 2d or 3d gradient. The default is
 // two dimensional XY gradient.  OutputScalarType is always
 // double. Gradient is computed using central differences.
+//
+// The gradient can be computed at a larger scale by setting a standard
+// deviation, in which case the input is first smoothed with the recursive
+// gaussian filters of vtkImageGaussianSmooth, so the cost does not grow
+// with the scale.
 
 #ifndef __vtkImageGradient_h
 #define __vtkImageGradient_h
@@ -46,12 +51,24 @@ public:
   vtkGetMacro(HandleBoundaries, int);
   vtkBooleanMacro(HandleBoundaries, int);
 
+  // Description:
+  // Get/Set the scale of the gradient, as the standard deviation in pixels
+  // of a gaussian that smooths the input before the central differences.
+  // The default is zero, which does not smooth the input.  Smoothing needs
+  // the whole input extent along the axes of the gradient.
+  vtkSetClampMacro(StandardDeviation, double, 0.0, VTK_DOUBLE_MAX);
+  vtkGetMacro(StandardDeviation, double);
+
 protected:
   vtkImageGradient();
   ~vtkImageGradient() {};
 
   int HandleBoundaries;
   int Dimensionality;
+  double StandardDeviation;
+
+  // The smoothed input, while the filter executes at a scale
+  vtkImageData *SmoothedInput;
 
   virtual int RequestInformation (vtkInformation*,
                                   vtkInformationVector**,
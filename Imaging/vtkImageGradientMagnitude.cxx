@@ -16,6 +16,7 @@
 
 #include "vtkDataArray.h"
 #include "vtkImageData.h"
+#include "vtkImageRecursiveGaussianInternals.h"
 #include "vtkInformation.h"
 #include "vtkInformationVector.h"
 #include "vtkObjectFactory.h"
@@ -34,6 +35,8 @@ vtkImageGradientMagnitude::vtkImageGradientMagnitude()
   this->SetNumberOfOutputPorts(1);
   this->Dimensionality = 2;
   this->HandleBoundaries = 1;
+  this->StandardDeviation = 0.0;
+  this->SmoothedInput = 0;
 }
 
 
@@ -43,6 +46,7 @@ void vtkImageGradientMagnitude::PrintSelf(ostream& os, vtkIndent indent)
   this->Superclass::PrintSelf(os, indent);
   os << indent << "HandleBoundaries: " << this->HandleBoundaries << "\n";
   os << indent << "Dimensionality: " << this->Dimensionality << "\n";
+  os << indent << "StandardDeviation: " << this->StandardDeviation << "\n";
 }
 
 //----------------------------------------------------------------------------
@@ -105,6 +109,13 @@ int vtkImageGradientMagnitude::RequestUpdateExtent (
   // grow input whole extent.
   for (idx = 0; idx < this->Dimensionality; ++idx)
     {
+    // smoothing the input needs the whole axis.
+    if (this->StandardDeviation > 0.0)
+      {
+      inUExt[idx*2] = wholeExtent[idx*2];
+      inUExt[idx*2+1] = wholeExtent[idx*2+1];
+      continue;
+      }
     inUExt[idx*2] -= 1;
     inUExt[idx*2+1] += 1;
     if (this->HandleBoundaries)
@@ -129,9 +140,9 @@ int vtkImageGradientMagnitude::RequestUpdateExtent (
 // This execute method handles boundaries.
 // it handles boundaries. Pixels are just replicated to get values 
 // out of extent.
-template <class T>
+template <class IT, class T>
 void vtkImageGradientMagnitudeExecute(vtkImageGradientMagnitude *self,
-                                      vtkImageData *inData, T *inPtr,
+                                      vtkImageData *inData, IT *inPtr,
                                       vtkImageData *outData, T *outPtr,
                                       int outExt[6], int id)
 {
@@ -233,6 +244,40 @@ void vtkImageGradientMagnitudeExecute(vtkImageGradientMagnitude *self,
 }
 
 
+//----------------------------------------------------------------------------
+// The input is smoothed once for all the threads when computing the
+// gradient at a scale.
+int vtkImageGradientMagnitude::RequestData(
+  vtkInformation* request,
+  vtkInformationVector** inputVector,
+  vtkInformationVector* outputVector)
+{
+  vtkImageData *input = vtkImageData::GetData(inputVector[0]);
+  if (this->StandardDeviation > 0.0 && input &&
+      input->GetPointData()->GetScalars())
+    {
+    double sigmas[3];
+    for (int idx = 0; idx < 3; ++idx)
+      {
+      sigmas[idx] =
+        (idx < this->Dimensionality ? this->StandardDeviation : 0.0);
+      }
+    this->SmoothedInput = vtkImageRecursiveGaussianSmoothArray(
+      this, input, input->GetPointData()->GetScalars(), input->GetExtent(),
+      input->GetExtent(), sigmas, this->NumberOfThreads);
+    }
+
+  int status = this->Superclass::RequestData(request, inputVector,
+                                             outputVector);
+  if (this->SmoothedInput)
+    {
+    this->SmoothedInput->Delete();
+    this->SmoothedInput = 0;
+    }
+
+  return status;
+}
+
 //----------------------------------------------------------------------------
 // This method contains a switch statement that calls the correct
 // templated function for the input data type.  The output data
@@ -254,6 +299,26 @@ void vtkImageGradientMagnitude::ThreadedExecute (vtkImageData *inData,
                   << outData->GetScalarType());
     return;
     }
+
+  // use the smoothed input when computing the gradient at a scale
+  if (this->SmoothedInput)
+    {
+    double *smoothedPtr =
+      static_cast<double *>(this->SmoothedInput->GetScalarPointer());
+    switch (outData->GetScalarType())
+      {
+      vtkTemplateMacro(
+        vtkImageGradientMagnitudeExecute(this,
+                                         this->SmoothedInput, smoothedPtr,
+                                         outData,
+                                         static_cast<VTK_TT *>(outPtr),
+                                         outExt, id));
+      default:
+        vtkErrorMacro(<< "Execute: Unknown ScalarType");
+        return;
+      }
+    return;
+    }
   
   switch (inData->GetScalarType())
     {
@@ -18,6 +18,11 @@
 // vtkImageGradientMagnitude computes the gradient magnitude of an image.
 // Setting the dimensionality determines whether the gradient is computed on
 // 2D images, or 3D volumes.  The default is two dimensional XY images.
+//
+// The gradient can be computed at a larger scale by setting a standard
+// deviation, in which case the input is first smoothed with the recursive
+// gaussian filters of vtkImageGaussianSmooth, so the cost does not grow
+// with the scale.
 
 // .SECTION See Also
 // vtkImageGradient vtkImageMagnitude
@@ -46,6 +51,14 @@ public:
   // Determines how the input is interpreted (set of 2d slices ...)
   vtkSetClampMacro(Dimensionality,int,2,3);
   vtkGetMacro(Dimensionality,int);
+
+  // Description:
+  // Get/Set the scale of the gradient, as the standard deviation in pixels
+  // of a gaussian that smooths the input before the central differences.
+  // The default is zero, which does not smooth the input.  Smoothing needs
+  // the whole input extent along the axes of the gradient.
+  vtkSetClampMacro(StandardDeviation, double, 0.0, VTK_DOUBLE_MAX);
+  vtkGetMacro(StandardDeviation, double);
   
 protected:
   vtkImageGradientMagnitude();
@@ -53,6 +66,10 @@ protected:
 
   int HandleBoundaries;
   int Dimensionality;
+  double StandardDeviation;
+
+  // The smoothed input, while the filter executes at a scale
+  vtkImageData *SmoothedInput;
 
   virtual int RequestInformation (vtkInformation*,
                                   vtkInformationVector**,
@@ -60,6 +77,9 @@ protected:
   virtual int RequestUpdateExtent(vtkInformation*,
                                   vtkInformationVector**,
                                   vtkInformationVector*);
+  virtual int RequestData(vtkInformation*,
+                          vtkInformationVector**,
+                          vtkInformationVector*);
 
   void ThreadedExecute (vtkImageData *inData, vtkImageData *outData,
                        int extent[6], int id);
@@ -22,6 +22,10 @@
 #include "vtkObjectFactory.h"
 #include "vtkPointData.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
+#include "vtkTypeTraits.h"
+
+#include <vtkstd/algorithm>
+#include <vtkstd/vector>
 
 vtkStandardNewMacro(vtkImageMedian3D);
 
@@ -32,6 +36,7 @@ vtkImageMedian3D::vtkImageMedian3D()
   this->NumberOfElements = 0;
   this->SetKernelSize(1,1,1);
   this->HandleBoundaries = 1;
+  this->Rank = 0.5;
 }
 
 //-----------------------------------------------------------------------------
@@ -45,6 +50,7 @@ void vtkImageMedian3D::PrintSelf(ostream& os, vtkIndent indent)
   this->Superclass::PrintSelf(os, indent);
 
   os << indent << "NumberOfElements: " << this->NumberOfElements << endl;
+  os << indent << "Rank: " << this->Rank << endl;
 }
 
 //-----------------------------------------------------------------------------
@@ -81,203 +87,281 @@ void vtkImageMedian3D::SetKernelSize(int size0, int size1, int size2)
 }
 
 //-----------------------------------------------------------------------------
-// Add a sample to the median computation
-double *vtkImageMedian3DAccumulateMedian(int &UpNum, int &DownNum,
-                                         int &UpMax, int &DownMax,
-                                         int &NumNeighborhood,
-                                         double *Median, double val)
+// A histogram of integer samples, with one level of coarse bins that count
+// the samples in blocks of fine bins.  The bin that holds the requested
+// rank is tracked as samples come and go, so that consecutive queries only
+// move it by a few bins, or skip whole blocks.
+class vtkImageMedian3DHistogram
 {
-  int idx, max;
-  double temp, *ptr;
+public:
+  vtkImageMedian3DHistogram(int numberOfBins, int blockSize)
+    : Bins(numberOfBins, 0), Blocks(numberOfBins / blockSize, 0)
+    {
+    this->BlockSize = blockSize;
+    this->Position = 0;
+    this->Below = 0;
+    }
 
-  // special case: no samples yet 
-  if (UpNum == 0)
+  void Add(int bin)
     {
-    *(Median) = val;
-    // length of up and down arrays inclusive of current 
-    UpNum = DownNum = 1; 
-    // median is gaurenteed to be in this range (length of array) 
-    DownMax = UpMax = (NumNeighborhood + 1) / 2;
-    return Median;
+    ++this->Bins[bin];
+    ++this->Blocks[bin / this->BlockSize];
+    if (bin < this->Position)
+      {
+      ++this->Below;
+      }
     }
 
-  // Case: value is above median 
-  if (val >= *(Median))
+  void Remove(int bin)
     {
-    // move the median if necessary
-    if (UpNum > DownNum)
+    --this->Bins[bin];
+    --this->Blocks[bin / this->BlockSize];
+    if (bin < this->Position)
       {
-      // Move the median Up one 
-      ++Median;
-      --UpNum;
-      ++DownNum;
-      --UpMax;
-      ++DownMax;
+      --this->Below;
       }
-    // find the position for val in the sorted array
-    max = (UpNum < UpMax) ? UpNum : UpMax;
-    ptr = Median;
-    idx = 0;
-    while (idx < max && val >= *ptr)
+    }
+
+  // Return the bin of the sample at index "rank" in sorted order.  The
+  // histogram must hold more than "rank" samples.
+  int GetBin(int rank)
+    {
+    int blockSize = this->BlockSize;
+    int pos = this->Position;
+    int below = this->Below;
+    while (below > rank)
       {
-      ++ptr;
-      ++idx;
+      while (pos % blockSize == 0 &&
+             below - this->Blocks[pos / blockSize - 1] > rank)
+        {
+        pos -= blockSize;
+        below -= this->Blocks[pos / blockSize];
+        }
+      if (below > rank)
+        {
+        --pos;
+        below -= this->Bins[pos];
+        }
       }
-    // place val and move all others up
-    while (idx < max)
+    while (below + this->Bins[pos] <= rank)
       {
-      temp = *ptr;
-      *ptr = val;
-      val = temp;
-      ++ptr;
-      ++idx;
+      below += this->Bins[pos];
+      ++pos;
+      while (pos % blockSize == 0 &&
+             below + this->Blocks[pos / blockSize] <= rank)
+        {
+        below += this->Blocks[pos / blockSize];
+        pos += blockSize;
+        }
       }
-    *ptr = val;
-    // Update counts
-    ++UpNum;
-    --DownMax;
-    return Median;
+    this->Position = pos;
+    this->Below = below;
+    return pos;
     }
 
-  // Case: value is below median 
-  // If we got here, val < *(Median)
+private:
+  vtkstd::vector<int> Bins;
+  vtkstd::vector<int> Blocks;
+  int BlockSize;
+  // The bin of the last query, and the number of samples below it.
+  int Position;
+  int Below;
+};
 
-  // move the median if necessary
-  if (DownNum > UpNum)
-    {
-    // Move the median Down one 
-    --Median;
-    --DownNum;
-    ++UpNum;
-    --DownMax;
-    ++UpMax;
-    }
-  // find the position for val in the sorted array
-  max = (DownNum < DownMax) ? DownNum : DownMax;
-  ptr = Median;
-  idx = 0;
-  while (idx < max && val <= *ptr)
-    {
-    --ptr;
-    ++idx;
-    }
-  // place val and move all others up
-  while (idx < max)
+//-----------------------------------------------------------------------------
+// Compute the neighborhood of an output index along one axis, clipped by
+// the input extent.
+static inline void vtkImageMedian3DHood(int idx, int axis, int *kernelMiddle,
+                                        int *kernelSize, int *inExt,
+                                        int &hoodMin, int &hoodMax)
+{
+  hoodMin = idx - kernelMiddle[axis];
+  hoodMax = hoodMin + kernelSize[axis] - 1;
+  hoodMin = (hoodMin > inExt[2*axis]) ? hoodMin : inExt[2*axis];
+  hoodMax = (hoodMax < inExt[2*axis+1]) ? hoodMax : inExt[2*axis+1];
+}
+
+//-----------------------------------------------------------------------------
+// Index of the requested rank in a sorted neighborhood of "count" samples.
+static inline int vtkImageMedian3DRankIndex(double rank, int count)
+{
+  return static_cast<int>(rank*(count - 1) + 0.5);
+}
+
+//-----------------------------------------------------------------------------
+// Rank filter for 8-bit and 16-bit scalars.  Each row of the output is
+// computed with a histogram of the neighborhood: as the neighborhood moves
+// along the row, the column of pixels that leaves it is removed from the
+// histogram and the column that enters it is added.
+template <class T>
+void vtkImageMedian3DHistogramExecute(vtkImageMedian3D *self,
+                                      vtkImageData *outData, T *outPtr,
+                                      int outExt[6], int inExt[6], int id,
+                                      vtkDataArray *inArray)
+{
+  int *kernelMiddle = self->GetKernelMiddle();
+  int *kernelSize = self->GetKernelSize();
+  double rank = self->GetRank();
+  int numComp = inArray->GetNumberOfComponents();
+  int outIdx0, outIdx1, outIdx2, outIdxC;
+  int hoodMin0, hoodMax0, hoodMin1, hoodMax1, hoodMin2, hoodMax2;
+  int hoodIdx1, hoodIdx2;
+  int colMin, colMax;
+  T *inPtr1, *inPtr2;
+  unsigned long count = 0;
+  unsigned long target;
+
+  // The input array is indexed from the start of the input extent.
+  T *inPtr = static_cast<T *>(inArray->GetVoidPointer(0));
+  vtkIdType inInc0 = numComp;
+  vtkIdType inInc1 = inInc0*(inExt[1] - inExt[0] + 1);
+  vtkIdType inInc2 = inInc1*(inExt[3] - inExt[2] + 1);
+  vtkIdType outInc0, outInc1, outInc2;
+  outData->GetIncrements(outInc0, outInc1, outInc2);
+
+  // The bins are the values shifted by the minimum of the type, in blocks
+  // of the square root of the number of bins.
+  int bits = 8*static_cast<int>(sizeof(T));
+  vtkImageMedian3DHistogram histogram(1 << bits, 1 << (bits/2));
+  int shift = static_cast<int>(vtkTypeTraits<T>::Min());
+
+  target = static_cast<unsigned long>((outExt[5] - outExt[4] + 1)*
+                                      (outExt[3] - outExt[2] + 1)/50.0);
+  target++;
+
+  for (outIdx2 = outExt[4]; outIdx2 <= outExt[5]; ++outIdx2)
     {
-    temp = *ptr;
-    *ptr = val;
-    val = temp;
-    --ptr;
-    ++idx;
-    }
-  *ptr = val;
-  // Update counts
-  ++DownNum;
-  --UpMax;
+    vtkImageMedian3DHood(outIdx2, 2, kernelMiddle, kernelSize, inExt,
+                         hoodMin2, hoodMax2);
+    for (outIdx1 = outExt[2];
+         !self->AbortExecute && outIdx1 <= outExt[3]; ++outIdx1)
+      {
+      if (!id)
+        {
+        if (!(count%target))
+          {
+          self->UpdateProgress(count/(50.0*target));
+          }
+        count++;
+        }
+      vtkImageMedian3DHood(outIdx1, 1, kernelMiddle, kernelSize, inExt,
+                           hoodMin1, hoodMax1);
+      int crossSection = (hoodMax1 - hoodMin1 + 1)*(hoodMax2 - hoodMin2 + 1);
+      T *colPtr = inPtr + (hoodMin1 - inExt[2])*inInc1 +
+        (hoodMin2 - inExt[4])*inInc2;
+      T *outPtr0 = outPtr + (outIdx1 - outExt[2])*outInc1 +
+        (outIdx2 - outExt[4])*outInc2;
 
-  return Median;
+      for (outIdxC = 0; outIdxC < numComp; ++outIdxC)
+        {
+        // The columns that are in the histogram.
+        vtkImageMedian3DHood(outExt[0], 0, kernelMiddle, kernelSize, inExt,
+                             colMin, colMax);
+        colMax = colMin - 1;
+        for (outIdx0 = outExt[0]; outIdx0 <= outExt[1]; ++outIdx0)
+          {
+          vtkImageMedian3DHood(outIdx0, 0, kernelMiddle, kernelSize, inExt,
+                               hoodMin0, hoodMax0);
+          while (colMax < hoodMax0)
+            {
+            ++colMax;
+            inPtr2 = colPtr + (colMax - inExt[0])*inInc0 + outIdxC;
+            for (hoodIdx2 = hoodMin2; hoodIdx2 <= hoodMax2; ++hoodIdx2)
+              {
+              inPtr1 = inPtr2;
+              for (hoodIdx1 = hoodMin1; hoodIdx1 <= hoodMax1; ++hoodIdx1)
+                {
+                histogram.Add(static_cast<int>(*inPtr1) - shift);
+                inPtr1 += inInc1;
+                }
+              inPtr2 += inInc2;
+              }
+            }
+          while (colMin < hoodMin0)
+            {
+            inPtr2 = colPtr + (colMin - inExt[0])*inInc0 + outIdxC;
+            for (hoodIdx2 = hoodMin2; hoodIdx2 <= hoodMax2; ++hoodIdx2)
+              {
+              inPtr1 = inPtr2;
+              for (hoodIdx1 = hoodMin1; hoodIdx1 <= hoodMax1; ++hoodIdx1)
+                {
+                histogram.Remove(static_cast<int>(*inPtr1) - shift);
+                inPtr1 += inInc1;
+                }
+              inPtr2 += inInc2;
+              }
+            ++colMin;
+            }
+
+          int index = vtkImageMedian3DRankIndex(
+            rank, (hoodMax0 - hoodMin0 + 1)*crossSection);
+          outPtr0[(outIdx0 - outExt[0])*outInc0 + outIdxC] =
+            static_cast<T>(histogram.GetBin(index) + shift);
+          }
+
+        // Empty the histogram for the next row.
+        for (; colMin <= colMax; ++colMin)
+          {
+          inPtr2 = colPtr + (colMin - inExt[0])*inInc0 + outIdxC;
+          for (hoodIdx2 = hoodMin2; hoodIdx2 <= hoodMax2; ++hoodIdx2)
+            {
+            inPtr1 = inPtr2;
+            for (hoodIdx1 = hoodMin1; hoodIdx1 <= hoodMax1; ++hoodIdx1)
+              {
+              histogram.Remove(static_cast<int>(*inPtr1) - shift);
+              inPtr1 += inInc1;
+              }
+            inPtr2 += inInc2;
+            }
+          }
+        }
+      }
+    }
 }
 
 //-----------------------------------------------------------------------------
-// This method contains the second switch statement that calls the correct
-// templated function for the mask types.
+// Rank filter for the other scalar types.  The neighborhood of each pixel
+// is copied into a buffer, where the value of the requested rank is
+// selected in linear time.
 template <class T>
 void vtkImageMedian3DExecute(vtkImageMedian3D *self,
-                             vtkImageData *inData, T *inPtr, 
                              vtkImageData *outData, T *outPtr,
-                             int outExt[6], int id,
+                             int outExt[6], int inExt[6], int id,
                              vtkDataArray *inArray)
 {
-  int *kernelMiddle, *kernelSize;
-  int NumberOfElements;
-  // For looping though output (and input) pixels.
-  int outIdx0, outIdx1, outIdx2;
-  vtkIdType inInc0, inInc1, inInc2;
-  int outIdxC;
-  vtkIdType outIncX, outIncY, outIncZ;
-  T *inPtr0, *inPtr1, *inPtr2;
-  // For looping through hood pixels
+  int *kernelMiddle = self->GetKernelMiddle();
+  int *kernelSize = self->GetKernelSize();
+  double rank = self->GetRank();
+  int numComp = inArray->GetNumberOfComponents();
+  int outIdx0, outIdx1, outIdx2, outIdxC;
   int hoodMin0, hoodMax0, hoodMin1, hoodMax1, hoodMin2, hoodMax2;
-  int hoodStartMin0, hoodStartMax0, hoodStartMin1, hoodStartMax1;
   int hoodIdx0, hoodIdx1, hoodIdx2;
-  T *tmpPtr0, *tmpPtr1, *tmpPtr2;
-  // The portion of the out image that needs no boundary processing.
-  int middleMin0, middleMax0, middleMin1, middleMax1, middleMin2, middleMax2;
-  int numComp;
-  // variables for the median calc
-  int UpNum = 0;
-  int DownNum = 0;
-  int UpMax = 0;
-  int DownMax = 0;
-  double *Median;
-  int *inExt;
+  T *inPtr0, *inPtr1, *inPtr2;
   unsigned long count = 0;
   unsigned long target;
 
-  if (!inArray)
-    {
-    return;
-    }
-  
-  double *Sort = new double[(self->GetNumberOfElements() + 8)];
-  
-  // Get information to march through data
-  inData->GetIncrements(inInc0, inInc1, inInc2); 
+  // The input array is indexed from the start of the input extent.
+  T *inPtr = static_cast<T *>(inArray->GetVoidPointer(0));
+  vtkIdType inInc0 = numComp;
+  vtkIdType inInc1 = inInc0*(inExt[1] - inExt[0] + 1);
+  vtkIdType inInc2 = inInc1*(inExt[3] - inExt[2] + 1);
+  vtkIdType outIncX, outIncY, outIncZ;
   outData->GetContinuousIncrements(outExt, outIncX, outIncY, outIncZ);
-  kernelMiddle = self->GetKernelMiddle();
-  kernelSize = self->GetKernelSize();
-  
-  numComp = inArray->GetNumberOfComponents();
-
-  hoodMin0 = outExt[0] - kernelMiddle[0]; 
-  hoodMin1 = outExt[2] - kernelMiddle[1]; 
-  hoodMin2 = outExt[4] - kernelMiddle[2]; 
-  hoodMax0 = kernelSize[0] + hoodMin0 - 1;
-  hoodMax1 = kernelSize[1] + hoodMin1 - 1;
-  hoodMax2 = kernelSize[2] + hoodMin2 - 1;
-  
-  // Clip by the input image extent
-  inExt = inData->GetExtent();
-  hoodMin0 = (hoodMin0 > inExt[0]) ? hoodMin0 : inExt[0];
-  hoodMin1 = (hoodMin1 > inExt[2]) ? hoodMin1 : inExt[2];
-  hoodMin2 = (hoodMin2 > inExt[4]) ? hoodMin2 : inExt[4];
-  hoodMax0 = (hoodMax0 < inExt[1]) ? hoodMax0 : inExt[1];
-  hoodMax1 = (hoodMax1 < inExt[3]) ? hoodMax1 : inExt[3];
-  hoodMax2 = (hoodMax2 < inExt[5]) ? hoodMax2 : inExt[5];
-
-  // Save the starting neighborhood dimensions (2 loops only once)
-  hoodStartMin0 = hoodMin0;    hoodStartMax0 = hoodMax0;
-  hoodStartMin1 = hoodMin1;    hoodStartMax1 = hoodMax1;
-  
-  // The portion of the output that needs no boundary computation.
-  middleMin0 = inExt[0] + kernelMiddle[0];
-  middleMax0 = inExt[1] - (kernelSize[0] - 1) + kernelMiddle[0];
-  middleMin1 = inExt[2] + kernelMiddle[1];
-  middleMax1 = inExt[3] - (kernelSize[1] - 1) + kernelMiddle[1];
-  middleMin2 = inExt[4] + kernelMiddle[2];
-  middleMax2 = inExt[5] - (kernelSize[2] - 1) + kernelMiddle[2];
-  
+
+  vtkstd::vector<T> hood(self->GetNumberOfElements());
+
   target = static_cast<unsigned long>((outExt[5] - outExt[4] + 1)*
                                       (outExt[3] - outExt[2] + 1)/50.0);
   target++;
-  
-  NumberOfElements = self->GetNumberOfElements();
-
-  // loop through pixel of output
-  inPtr = static_cast<T *>(
-    inArray->GetVoidPointer((hoodMin0 - inExt[0])* inInc0 + 
-                            (hoodMin1 - inExt[2])* inInc1 +
-                            (hoodMin2 - inExt[4])* inInc2));
-  inPtr2 = inPtr;
+
   for (outIdx2 = outExt[4]; outIdx2 <= outExt[5]; ++outIdx2)
     {
-    inPtr1 = inPtr2;
-    hoodMin1 = hoodStartMin1;
-    hoodMax1 = hoodStartMax1;
-    for (outIdx1 = outExt[2]; 
+    vtkImageMedian3DHood(outIdx2, 2, kernelMiddle, kernelSize, inExt,
+                         hoodMin2, hoodMax2);
+    for (outIdx1 = outExt[2];
          !self->AbortExecute && outIdx1 <= outExt[3]; ++outIdx1)
       {
-      if (!id) 
+      if (!id)
         {
         if (!(count%target))
           {
@@ -285,84 +369,47 @@ void vtkImageMedian3DExecute(vtkImageMedian3D *self,
           }
         count++;
         }
-      inPtr0 = inPtr1;
-      hoodMin0 = hoodStartMin0;
-      hoodMax0 = hoodStartMax0;
+      vtkImageMedian3DHood(outIdx1, 1, kernelMiddle, kernelSize, inExt,
+                           hoodMin1, hoodMax1);
       for (outIdx0 = outExt[0]; outIdx0 <= outExt[1]; ++outIdx0)
         {
-        for (outIdxC = 0; outIdxC < numComp; outIdxC++)
+        vtkImageMedian3DHood(outIdx0, 0, kernelMiddle, kernelSize, inExt,
+                             hoodMin0, hoodMax0);
+        for (outIdxC = 0; outIdxC < numComp; ++outIdxC)
           {
-          // Compute median of neighborhood
-          // Note: For boundary, NumNeighborhood could be changed for
-          // a faster sort.
-          DownNum = UpNum = 0;
-          Median = Sort + (NumberOfElements / 2) + 4;
-          // loop through neighborhood pixels
-          tmpPtr2 = inPtr0 + outIdxC;
+          // Copy the neighborhood into the buffer
+          int numHood = 0;
+          inPtr2 = inPtr + (hoodMin0 - inExt[0])*inInc0 +
+            (hoodMin1 - inExt[2])*inInc1 + (hoodMin2 - inExt[4])*inInc2 +
+            outIdxC;
           for (hoodIdx2 = hoodMin2; hoodIdx2 <= hoodMax2; ++hoodIdx2)
             {
-            tmpPtr1 = tmpPtr2;
+            inPtr1 = inPtr2;
             for (hoodIdx1 = hoodMin1; hoodIdx1 <= hoodMax1; ++hoodIdx1)
               {
-              tmpPtr0 = tmpPtr1;
+              inPtr0 = inPtr1;
               for (hoodIdx0 = hoodMin0; hoodIdx0 <= hoodMax0; ++hoodIdx0)
                 {
-                // Add this pixel to the median
-                Median = vtkImageMedian3DAccumulateMedian(UpNum, DownNum, 
-                                                          UpMax, DownMax,
-                                                          NumberOfElements,
-                                                          Median,
-                                                          double(*tmpPtr0));
-                
-                tmpPtr0 += inInc0;
+                hood[numHood++] = *inPtr0;
+                inPtr0 += inInc0;
                 }
-              tmpPtr1 += inInc1;
+              inPtr1 += inInc1;
               }
-            tmpPtr2 += inInc2;
+            inPtr2 += inInc2;
             }
-        
-          // Replace this pixel with the hood median
-          *outPtr = static_cast<T>(*Median);
+
+          // Replace this pixel with the value of the requested rank
+          typename vtkstd::vector<T>::iterator selected =
+            hood.begin() + vtkImageMedian3DRankIndex(rank, numHood);
+          vtkstd::nth_element(hood.begin(), selected, hood.begin() + numHood);
+          *outPtr = *selected;
           outPtr++;
           }
-        
-        // shift neighborhood considering boundaries
-        if (outIdx0 >= middleMin0)
-          {
-          inPtr0 += inInc0;
-          ++hoodMin0;
-          }
-        if (outIdx0 < middleMax0)
-          {
-          ++hoodMax0;
-          }
-        }
-      // shift neighborhood considering boundaries
-      if (outIdx1 >= middleMin1)
-        {
-        inPtr1 += inInc1;
-        ++hoodMin1;
-        }
-      if (outIdx1 < middleMax1)
-        {
-        ++hoodMax1;
         }
       outPtr += outIncY;
       }
-    // shift neighborhood considering boundaries
-    if (outIdx2 >= middleMin2)
-      {
-      inPtr2 += inInc2;
-      ++hoodMin2;
-      }
-    if (outIdx2 < middleMax2)
-      {
-      ++hoodMax2;
-      }
     outPtr += outIncZ;
     }
-
-  delete [] Sort;
 }
 
 //-----------------------------------------------------------------------------
@@ -376,17 +423,19 @@ void vtkImageMedian3D::ThreadedRequestData(
   vtkImageData **outData,
   int outExt[6], int id)
 {
-  void *inPtr;
   void *outPtr = outData[0]->GetScalarPointerForExtent(outExt);
+  int *inExt = inData[0][0]->GetExtent();
 
   vtkDataArray *inArray = this->GetInputArrayToProcess(0,inputVector);
+  if (!inArray)
+    {
+    return;
+    }
   if (id == 0)
     {
     outData[0]->GetPointData()->GetScalars()->SetName(inArray->GetName());
     }
 
-  inPtr = inArray->GetVoidPointer(0); 
-
   // this filter expects that input is the same type as output.
   if (inArray->GetDataType() != outData[0]->GetScalarType())
     {
@@ -398,13 +447,43 @@ void vtkImageMedian3D::ThreadedRequestData(
   
   switch (inArray->GetDataType())
     {
-    vtkTemplateMacro(
-      vtkImageMedian3DExecute(this,inData[0][0],
-                              static_cast<VTK_TT *>(inPtr), 
-                              outData[0], static_cast<VTK_TT *>(outPtr),
-                              outExt, id,inArray));
+    // The 8-bit and 16-bit types use sliding histograms
+    case VTK_CHAR:
+      vtkImageMedian3DHistogramExecute(this, outData[0],
+                                       static_cast<char *>(outPtr),
+                                       outExt, inExt, id, inArray);
+      break;
+    case VTK_SIGNED_CHAR:
+      vtkImageMedian3DHistogramExecute(this, outData[0],
+                                       static_cast<signed char *>(outPtr),
+                                       outExt, inExt, id, inArray);
+      break;
+    case VTK_UNSIGNED_CHAR:
+      vtkImageMedian3DHistogramExecute(this, outData[0],
+                                       static_cast<unsigned char *>(outPtr),
+                                       outExt, inExt, id, inArray);
+      break;
+    case VTK_SHORT:
+      vtkImageMedian3DHistogramExecute(this, outData[0],
+                                       static_cast<short *>(outPtr),
+                                       outExt, inExt, id, inArray);
+      break;
+    case VTK_UNSIGNED_SHORT:
+      vtkImageMedian3DHistogramExecute(this, outData[0],
+                                       static_cast<unsigned short *>(outPtr),
+                                       outExt, inExt, id, inArray);
+      break;
     default:
-      vtkErrorMacro(<< "Execute: Unknown input ScalarType");
-      return;
+      // The other types select the rank from a sorted buffer
+      switch (inArray->GetDataType())
+        {
+        vtkTemplateMacro(
+          vtkImageMedian3DExecute(this, outData[0],
+                                  static_cast<VTK_TT *>(outPtr),
+                                  outExt, inExt, id, inArray));
+        default:
+          vtkErrorMacro(<< "Execute: Unknown input ScalarType");
+          return;
+        }
     }
 }
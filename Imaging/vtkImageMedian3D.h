@@ -19,6 +19,14 @@
 // Neighborhoods can be no more than 3 dimensional.  Setting one
 // axis of the neighborhood kernelSize to 1 changes the filter
 // into a 2D median.  
+//
+// The filter can also act as a rank filter: with SetRank() each pixel is
+// replaced with the value of the given rank in its sorted neighborhood,
+// from the minimum (rank 0) through the median (rank 0.5, the default) to
+// the maximum (rank 1).  For 8-bit and 16-bit integer scalars the ranks
+// are found with a sliding histogram that is updated incrementally as the
+// neighborhood moves along the rows, so that the cost per pixel grows
+// with the area of the kernel cross section rather than with its volume.
 
 
 #ifndef __vtkImageMedian3D_h
@@ -43,11 +51,23 @@ public:
   // Return the number of elements in the median mask
   vtkGetMacro(NumberOfElements,int);
 
+  // Description:
+  // Set/Get the rank of the output value in the sorted neighborhood, as a
+  // fraction between 0 (minimum) and 1 (maximum).  The default is 0.5,
+  // which gives the median.  For a neighborhood of n pixels the value at
+  // index rank*(n-1), rounded to the nearest integer, is used.
+  vtkSetClampMacro(Rank,double,0.0,1.0);
+  vtkGetMacro(Rank,double);
+  void SetRankToMinimum() {this->SetRank(0.0);};
+  void SetRankToMedian() {this->SetRank(0.5);};
+  void SetRankToMaximum() {this->SetRank(1.0);};
+
 protected:
   vtkImageMedian3D();
   ~vtkImageMedian3D();
 
   int NumberOfElements;
+  double Rank;
 
   void ThreadedRequestData(vtkInformation *request,
                            vtkInformationVector **inputVector,
@@ -0,0 +1,411 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkImageMorphologyInternals.h
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// .NAME vtkImageMorphologyInternals - internals for the morphology filters
+// .SECTION Description
+// Running minimum and maximum filters shared by vtkImageContinuousDilate3D,
+// vtkImageContinuousErode3D and vtkImageDilateErode3D.  Lines are filtered
+// with the van Herk/Gil-Werman algorithm, which needs three comparisons per
+// sample whatever the length of the line kernel.  A box kernel is applied
+// as a line kernel along each axis in turn.  An ellipsoid is split into
+// one line kernel along X for each of its rows, and the output is the
+// maximum (or minimum) of the filtered rows.  The inner loops run along
+// contiguous rows of samples, so that the compiler can vectorize them.
+
+#ifndef __vtkImageMorphologyInternals_h
+#define __vtkImageMorphologyInternals_h
+
+#include "vtkImageData.h"
+
+#include <vtkstd/vector>
+#include <limits>
+
+// A kernel for the morphology filters.  The neighborhood of a pixel is
+// the union of line segments along X, each given by its Y and Z offsets
+// and by the range of its X offsets.
+struct vtkImageMorphologyKernel
+{
+  struct Run
+  {
+    int Offset1;
+    int Offset2;
+    int Min0;
+    int Max0;
+  };
+
+  // The range of offsets along each axis.
+  int HoodMin[3];
+  int HoodMax[3];
+  // Whether the kernel is the whole box given by the ranges, otherwise the
+  // kernel is given by the runs.
+  int Box;
+  vtkstd::vector<Run> Runs;
+};
+
+//--------------------------------------------------------------------------
+// Make all defined methods invisible outside current translation unit
+namespace {
+
+//--------------------------------------------------------------------------
+// Operators for dilation and erosion, with the value that pads the lines.
+template <class T>
+struct vtkImageMorphologyMaximum
+{
+  static inline T Apply(T a, T b) { return (a > b ? a : b); }
+  static inline T Identity()
+  {
+    return (std::numeric_limits<T>::has_infinity ?
+            -std::numeric_limits<T>::infinity() :
+            (std::numeric_limits<T>::is_integer ?
+             std::numeric_limits<T>::min() :
+             -std::numeric_limits<T>::max()));
+  }
+};
+
+template <class T>
+struct vtkImageMorphologyMinimum
+{
+  static inline T Apply(T a, T b) { return (a < b ? a : b); }
+  static inline T Identity()
+  {
+    return (std::numeric_limits<T>::has_infinity ?
+            std::numeric_limits<T>::infinity() :
+            std::numeric_limits<T>::max());
+  }
+};
+
+//--------------------------------------------------------------------------
+// Build a kernel from the rows of a mask, such as the output of a
+// vtkImageEllipsoidSource, whose voxel "kernelMiddle" is the origin.
+void vtkImageMorphologyKernelFromMask(vtkImageData *mask,
+                                      const int kernelMiddle[3],
+                                      vtkImageMorphologyKernel &kernel)
+{
+  int size[3];
+  vtkIdType inc[3];
+  mask->GetDimensions(size);
+  mask->GetIncrements(inc);
+  const unsigned char *maskPtr =
+    static_cast<unsigned char *>(mask->GetScalarPointer());
+
+  kernel.Box = 0;
+  kernel.Runs.clear();
+  for (int i = 0; i < 3; i++)
+    {
+    kernel.HoodMin[i] = -kernelMiddle[i];
+    kernel.HoodMax[i] = size[i] - 1 - kernelMiddle[i];
+    }
+  for (int idx2 = 0; idx2 < size[2]; idx2++)
+    {
+    for (int idx1 = 0; idx1 < size[1]; idx1++)
+      {
+      const unsigned char *rowPtr = maskPtr + idx1*inc[1] + idx2*inc[2];
+      int idx0 = 0;
+      while (idx0 < size[0])
+        {
+        if (!rowPtr[idx0*inc[0]])
+          {
+          idx0++;
+          continue;
+          }
+        vtkImageMorphologyKernel::Run run;
+        run.Offset1 = idx1 - kernelMiddle[1];
+        run.Offset2 = idx2 - kernelMiddle[2];
+        run.Min0 = idx0 - kernelMiddle[0];
+        while (idx0 < size[0] && rowPtr[idx0*inc[0]])
+          {
+          idx0++;
+          }
+        run.Max0 = idx0 - 1 - kernelMiddle[0];
+        kernel.Runs.push_back(run);
+        }
+      }
+    }
+}
+
+//--------------------------------------------------------------------------
+// Build a box kernel, whose voxel "kernelMiddle" is the origin.
+void vtkImageMorphologyKernelFromBox(const int kernelSize[3],
+                                     const int kernelMiddle[3],
+                                     vtkImageMorphologyKernel &kernel)
+{
+  kernel.Box = 1;
+  kernel.Runs.clear();
+  for (int i = 0; i < 3; i++)
+    {
+    kernel.HoodMin[i] = -kernelMiddle[i];
+    kernel.HoodMax[i] = kernelSize[i] - 1 - kernelMiddle[i];
+    }
+}
+
+//--------------------------------------------------------------------------
+// Filter "numberOfLines" lines at once with a line kernel.  Sample "j" of
+// line "l" is read from in[(j - inMin)*inStep + l*inLineStep] for "j" from
+// "inMin" to "inMax".  Sample "i" of the output, for "i" from "outMin" to
+// "outMax", is the operator applied to the input samples from "i + hoodMin"
+// to "i + hoodMax", and is written to out[(i - outMin)*outStep + l].  The
+// buffers are resized as needed.
+template <class T, class TOp>
+void vtkImageMorphologyLines(const T *in, vtkIdType inStep,
+                             vtkIdType inLineStep, int inMin, int inMax,
+                             T *out, vtkIdType outStep, int outMin,
+                             int outMax, int hoodMin, int hoodMax,
+                             int numberOfLines, vtkstd::vector<T> &buffer0,
+                             vtkstd::vector<T> &buffer1)
+{
+  const int m = numberOfLines;
+  const int length = hoodMax - hoodMin + 1;
+  const int n = outMax - outMin + length;
+  buffer0.resize(static_cast<size_t>(n)*m);
+  buffer1.resize(static_cast<size_t>(n)*m);
+  T *x = &buffer0[0];
+  T *g = &buffer1[0];
+  const T identity = TOp::Identity();
+  int t, l;
+
+  // Gather the samples from outMin + hoodMin to outMax + hoodMax, padded
+  // beyond the input range.
+  for (t = 0; t < n; t++)
+    {
+    int j = outMin + hoodMin + t;
+    T *xPtr = x + static_cast<size_t>(t)*m;
+    if (j < inMin || j > inMax)
+      {
+      for (l = 0; l < m; l++)
+        {
+        xPtr[l] = identity;
+        }
+      }
+    else
+      {
+      const T *inPtr = in + (j - inMin)*inStep;
+      for (l = 0; l < m; l++)
+        {
+        xPtr[l] = inPtr[l*inLineStep];
+        }
+      }
+    }
+
+  // Running values from the start of each block of "length" samples
+  for (t = 0; t < n; t++)
+    {
+    T *gPtr = g + static_cast<size_t>(t)*m;
+    const T *xPtr = x + static_cast<size_t>(t)*m;
+    if (t % length == 0)
+      {
+      for (l = 0; l < m; l++)
+        {
+        gPtr[l] = xPtr[l];
+        }
+      }
+    else
+      {
+      for (l = 0; l < m; l++)
+        {
+        gPtr[l] = TOp::Apply(gPtr[l - m], xPtr[l]);
+        }
+      }
+    }
+
+  // Running values to the end of each block, in place
+  for (t = n - 2; t >= 0; t--)
+    {
+    if ((t + 1) % length != 0)
+      {
+      T *hPtr = x + static_cast<size_t>(t)*m;
+      for (l = 0; l < m; l++)
+        {
+        hPtr[l] = TOp::Apply(hPtr[l], hPtr[l + m]);
+        }
+      }
+    }
+
+  // Each window covers the end of one block and the start of the next.
+  for (t = 0; t <= outMax - outMin; t++)
+    {
+    const T *hPtr = x + static_cast<size_t>(t)*m;
+    const T *gPtr = g + static_cast<size_t>(t + length - 1)*m;
+    T *outPtr = out + t*outStep;
+    for (l = 0; l < m; l++)
+      {
+      outPtr[l] = TOp::Apply(hPtr[l], gPtr[l]);
+      }
+    }
+}
+
+//--------------------------------------------------------------------------
+// Apply the kernel to one component of the input.  The input pointer is at
+// the first voxel of "inExt", which is the region where the input can be
+// read, and the output pointer is at the first voxel of "outExt".  The
+// increments are given in samples.  The center voxel of each neighborhood
+// is always used.
+template <class T, class TOp>
+void vtkImageMorphologyExecute(const T *inPtr, const vtkIdType inInc[3],
+                               const int inExt[6], T *outPtr,
+                               const vtkIdType outInc[3], const int outExt[6],
+                               const vtkImageMorphologyKernel &kernel)
+{
+  int idx0, idx1, idx2;
+  int outSize0 = outExt[1] - outExt[0] + 1;
+  int outSize1 = outExt[3] - outExt[2] + 1;
+  int outSize2 = outExt[5] - outExt[4] + 1;
+
+  // The rows of the input that the output needs.
+  int min1 = outExt[2] + kernel.HoodMin[1];
+  int max1 = outExt[3] + kernel.HoodMax[1];
+  int min2 = outExt[4] + kernel.HoodMin[2];
+  int max2 = outExt[5] + kernel.HoodMax[2];
+  min1 = (min1 > inExt[2] ? min1 : inExt[2]);
+  max1 = (max1 < inExt[3] ? max1 : inExt[3]);
+  min2 = (min2 > inExt[4] ? min2 : inExt[4]);
+  max2 = (max2 < inExt[5] ? max2 : inExt[5]);
+  int size1 = max1 - min1 + 1;
+  int size2 = max2 - min2 + 1;
+
+  // Rows filtered along X, from "min1" to "max1" and "min2" to "max2",
+  // and the result for the whole output extent.
+  vtkstd::vector<T> rows(static_cast<size_t>(outSize0)*size1*size2);
+  vtkstd::vector<T> result(static_cast<size_t>(outSize0)*outSize1*outSize2);
+  vtkstd::vector<T> buffer0, buffer1;
+  vtkIdType rowInc1 = outSize0;
+  vtkIdType rowInc2 = rowInc1*size1;
+  vtkIdType resultInc1 = outSize0;
+  vtkIdType resultInc2 = resultInc1*outSize1;
+
+  if (kernel.Box)
+    {
+    for (idx2 = 0; idx2 < size2; idx2++)
+      {
+      for (idx1 = 0; idx1 < size1; idx1++)
+        {
+        vtkImageMorphologyLines<T, TOp>(
+          inPtr + (min1 + idx1 - inExt[2])*inInc[1] +
+          (min2 + idx2 - inExt[4])*inInc[2], inInc[0], 0, inExt[0],
+          inExt[1], &rows[idx1*rowInc1 + idx2*rowInc2], 1, outExt[0],
+          outExt[1], kernel.HoodMin[0], kernel.HoodMax[0], 1, buffer0,
+          buffer1);
+        }
+      }
+    // Filter along Y, all the samples of a row at once
+    vtkstd::vector<T> columns(static_cast<size_t>(outSize0)*outSize1*size2);
+    for (idx2 = 0; idx2 < size2; idx2++)
+      {
+      vtkImageMorphologyLines<T, TOp>(
+        &rows[idx2*rowInc2], rowInc1, 1, min1, max1,
+        &columns[idx2*resultInc2], resultInc1, outExt[2], outExt[3],
+        kernel.HoodMin[1], kernel.HoodMax[1], outSize0, buffer0, buffer1);
+      }
+    // Filter along Z, all the samples of a row at once
+    for (idx1 = 0; idx1 < outSize1; idx1++)
+      {
+      vtkImageMorphologyLines<T, TOp>(
+        &columns[idx1*resultInc1], resultInc2, 1, min2, max2,
+        &result[idx1*resultInc1], resultInc2, outExt[4], outExt[5],
+        kernel.HoodMin[2], kernel.HoodMax[2], outSize0, buffer0, buffer1);
+      }
+    }
+  else
+    {
+    // Start from the center voxels
+    for (idx2 = 0; idx2 < outSize2; idx2++)
+      {
+      for (idx1 = 0; idx1 < outSize1; idx1++)
+        {
+        const T *inRow = inPtr + (outExt[0] - inExt[0])*inInc[0] +
+          (outExt[2] + idx1 - inExt[2])*inInc[1] +
+          (outExt[4] + idx2 - inExt[4])*inInc[2];
+        T *resultRow = &result[idx1*resultInc1 + idx2*resultInc2];
+        for (idx0 = 0; idx0 < outSize0; idx0++)
+          {
+          resultRow[idx0] = inRow[idx0*inInc[0]];
+          }
+        }
+      }
+
+    // Filter the rows once for each distinct range of X offsets, and
+    // combine them with the output rows of every run with this range.
+    size_t numRuns = kernel.Runs.size();
+    vtkstd::vector<char> done(numRuns, 0);
+    for (size_t r = 0; r < numRuns; r++)
+      {
+      if (done[r])
+        {
+        continue;
+        }
+      int hoodMin0 = kernel.Runs[r].Min0;
+      int hoodMax0 = kernel.Runs[r].Max0;
+      for (idx2 = 0; idx2 < size2; idx2++)
+        {
+        for (idx1 = 0; idx1 < size1; idx1++)
+          {
+          vtkImageMorphologyLines<T, TOp>(
+            inPtr + (min1 + idx1 - inExt[2])*inInc[1] +
+            (min2 + idx2 - inExt[4])*inInc[2], inInc[0], 0, inExt[0],
+            inExt[1], &rows[idx1*rowInc1 + idx2*rowInc2], 1, outExt[0],
+            outExt[1], hoodMin0, hoodMax0, 1, buffer0, buffer1);
+          }
+        }
+      for (size_t s = r; s < numRuns; s++)
+        {
+        const vtkImageMorphologyKernel::Run &run = kernel.Runs[s];
+        if (done[s] || run.Min0 != hoodMin0 || run.Max0 != hoodMax0)
+          {
+          continue;
+          }
+        done[s] = 1;
+        for (idx2 = 0; idx2 < outSize2; idx2++)
+          {
+          int rowIdx2 = outExt[4] + idx2 + run.Offset2;
+          if (rowIdx2 < min2 || rowIdx2 > max2)
+            {
+            continue;
+            }
+          for (idx1 = 0; idx1 < outSize1; idx1++)
+            {
+            int rowIdx1 = outExt[2] + idx1 + run.Offset1;
+            if (rowIdx1 < min1 || rowIdx1 > max1)
+              {
+              continue;
+              }
+            const T *row = &rows[(rowIdx1 - min1)*rowInc1 +
+                                 (rowIdx2 - min2)*rowInc2];
+            T *resultRow = &result[idx1*resultInc1 + idx2*resultInc2];
+            for (idx0 = 0; idx0 < outSize0; idx0++)
+              {
+              resultRow[idx0] = TOp::Apply(resultRow[idx0], row[idx0]);
+              }
+            }
+          }
+        }
+      }
+    }
+
+  // Copy the result to the output
+  for (idx2 = 0; idx2 < outSize2; idx2++)
+    {
+    for (idx1 = 0; idx1 < outSize1; idx1++)
+      {
+      const T *resultRow = &result[idx1*resultInc1 + idx2*resultInc2];
+      T *outRow = outPtr + idx1*outInc[1] + idx2*outInc[2];
+      for (idx0 = 0; idx0 < outSize0; idx0++)
+        {
+        outRow[idx0*outInc[0]] = resultRow[idx0];
+        }
+      }
+    }
+}
+
+}
+
+#endif
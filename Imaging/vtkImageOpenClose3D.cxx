@@ -245,6 +245,44 @@ void vtkImageOpenClose3D::SetKernelSize(int size0, int size1, int size2)
   // Sub filters take care of modified.
 }
 
+//----------------------------------------------------------------------------
+// Selects the shape of the kernel of both sub filters.
+void vtkImageOpenClose3D::SetKernelShape(int shape)
+{
+  if ( ! this->Filter0 || ! this->Filter1)
+    {
+    vtkErrorMacro(<< "SetKernelShape: Sub filter not created yet.");
+    return;
+    }
+  
+  this->Filter0->SetKernelShape(shape);
+  this->Filter1->SetKernelShape(shape);
+}
+
+//----------------------------------------------------------------------------
+int vtkImageOpenClose3D::GetKernelShape()
+{
+  if ( ! this->Filter0)
+    {
+    vtkErrorMacro(<< "GetKernelShape: Sub filter not created yet.");
+    return VTK_IMAGE_KERNEL_ELLIPSOID;
+    }
+  
+  return this->Filter0->GetKernelShape();
+}
+
+//----------------------------------------------------------------------------
+void vtkImageOpenClose3D::SetKernelShapeToEllipsoid()
+{
+  this->SetKernelShape(VTK_IMAGE_KERNEL_ELLIPSOID);
+}
+
+//----------------------------------------------------------------------------
+void vtkImageOpenClose3D::SetKernelShapeToBox()
+{
+  this->SetKernelShape(VTK_IMAGE_KERNEL_BOX);
+}
+
 //----------------------------------------------------------------------------
 // Determines the value that will closed.
 // Close value is first dilated, and then eroded
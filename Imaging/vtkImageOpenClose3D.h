@@ -65,6 +65,14 @@ public:
   // Selects the size of gaps or objects removed.
   void SetKernelSize(int size0, int size1, int size2);
 
+  // Description:
+  // Selects the shape of the kernel, an ellipsoid (the default) or a box.
+  // See vtkImageDilateErode3D.
+  void SetKernelShape(int shape);
+  int GetKernelShape();
+  void SetKernelShapeToEllipsoid();
+  void SetKernelShapeToBox();
+
   // Description:
   // Determines the value that will opened.  
   // Open value is first eroded, and then dilated.
@@ -55,7 +55,7 @@ public:
                   int num, int total);
 
 protected:
-  vtkImageRFFT() {};
+  vtkImageRFFT() { this->InverseTransform = 1; };
   ~vtkImageRFFT() {};
 
   virtual int IterativeRequestInformation(vtkInformation* in,
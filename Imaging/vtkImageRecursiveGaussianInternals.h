@@ -0,0 +1,476 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkImageRecursiveGaussianInternals.h
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// .NAME vtkImageRecursiveGaussianInternals - recursive gaussian smoothing
+// .SECTION Description
+// Recursive (IIR) gaussian smoothing shared by vtkImageGaussianSmooth,
+// vtkImageGradient and vtkImageGradientMagnitude.  Each line is filtered
+// with the fourth order causal and anti-causal filters of Deriche, so the
+// cost per sample does not depend on the standard deviation.  Several
+// lines are filtered at once with their samples interleaved, so that the
+// compiler can vectorize the recursions.
+
+#ifndef __vtkImageRecursiveGaussianInternals_h
+#define __vtkImageRecursiveGaussianInternals_h
+
+#include "vtkAlgorithm.h"
+#include "vtkDataArray.h"
+#include "vtkImageData.h"
+#include "vtkMultiThreader.h"
+#include "vtkPointData.h"
+
+#include <vtkstd/vector>
+#include <math.h>
+
+// The number of lines that are filtered at once.
+#define VTK_RECURSIVE_GAUSSIAN_LINES 8
+
+// The minimum number of samples that each thread filters.
+#define VTK_RECURSIVE_GAUSSIAN_SAMPLES_PER_THREAD 65536
+
+// The coefficients of the recursive filters for one standard deviation.
+// The causal filter is y[i] = N[0]*x[i] + ... + N[3]*x[i-3] - D[0]*y[i-1]
+// - ... - D[3]*y[i-4], the anti-causal filter is z[i] = M[0]*x[i+1] + ...
+// + M[3]*x[i+4] - D[0]*z[i+1] - ... - D[3]*z[i+4], and the result is the
+// sum of y and z.
+struct vtkImageRecursiveGaussianCoefficients
+{
+  double N[4];
+  double M[4];
+  double D[4];
+};
+
+//--------------------------------------------------------------------------
+// Make all defined methods invisible outside current translation unit
+namespace {
+
+//--------------------------------------------------------------------------
+// Compute the coefficients for a standard deviation given in samples, from
+// the fourth order approximation of the gaussian by Deriche with the
+// parameters of Farneback and Westin.  The filter is not accurate below
+// half a sample, so smaller standard deviations are raised to 0.5.
+void vtkImageRecursiveGaussianComputeCoefficients(
+  double sigma, vtkImageRecursiveGaussianCoefficients &coeffs)
+{
+  const double a1 = 1.3530;
+  const double b1 = 1.8151;
+  const double w1 = 0.6681;
+  const double l1 = -1.3932;
+  const double a2 = -0.3531;
+  const double b2 = 0.0902;
+  const double w2 = 2.0787;
+  const double l2 = -1.3732;
+
+  sigma = (sigma > 0.5 ? sigma : 0.5);
+  double sin1 = sin(w1/sigma);
+  double sin2 = sin(w2/sigma);
+  double cos1 = cos(w1/sigma);
+  double cos2 = cos(w2/sigma);
+  double exp1 = exp(l1/sigma);
+  double exp2 = exp(l2/sigma);
+
+  double *N = coeffs.N;
+  N[0] = a1 + a2;
+  N[1] = exp2*(b2*sin2 - (a2 + 2*a1)*cos2) +
+    exp1*(b1*sin1 - (a1 + 2*a2)*cos1);
+  N[2] = 2*exp1*exp2*((a1 + a2)*cos2*cos1 - b1*cos2*sin1 - b2*cos1*sin2) +
+    a2*exp1*exp1 + a1*exp2*exp2;
+  N[3] = exp2*exp1*exp1*(b2*sin2 - a2*cos2) +
+    exp1*exp2*exp2*(b1*sin1 - a1*cos1);
+
+  double *D = coeffs.D;
+  D[0] = -2*(exp2*cos2 + exp1*cos1);
+  D[1] = 4*cos2*cos1*exp1*exp2 + exp1*exp1 + exp2*exp2;
+  D[2] = -2*cos1*exp1*exp2*exp2 - 2*cos2*exp2*exp1*exp1;
+  D[3] = exp1*exp1*exp2*exp2;
+
+  // Normalize the sum of the causal and anti-causal filters
+  double sumN = N[0] + N[1] + N[2] + N[3];
+  double sumD = 1.0 + D[0] + D[1] + D[2] + D[3];
+  double gain = 2*sumN/sumD - N[0];
+  int j;
+  for (j = 0; j < 4; j++)
+    {
+    N[j] /= gain;
+    }
+
+  // The anti-causal filter mirrors the causal one
+  double *M = coeffs.M;
+  for (j = 0; j < 3; j++)
+    {
+    M[j] = N[j + 1] - D[j]*N[0];
+    }
+  M[3] = -D[3]*N[0];
+}
+
+//--------------------------------------------------------------------------
+// Smooth "m" lines of "n" samples in place.  Sample "i" of line "l" is at
+// data[i*step + l*lineStep].  The lines are padded by repeating their end
+// samples, and both filters start at rest on the padding.  The buffer is
+// resized as needed.
+void vtkImageRecursiveGaussianLines(
+  const vtkImageRecursiveGaussianCoefficients &coeffs, double *data,
+  vtkIdType step, vtkIdType lineStep, int n, int m,
+  vtkstd::vector<double> &buffer)
+{
+  const double *N = coeffs.N;
+  const double *M = coeffs.M;
+  const double *D = coeffs.D;
+  const double sumD = 1.0 + D[0] + D[1] + D[2] + D[3];
+  const double restN = (N[0] + N[1] + N[2] + N[3])/sumD;
+  const double restM = (M[0] + M[1] + M[2] + M[3])/sumD;
+  int i, l;
+
+  // The input with four samples of padding at each end, and the output
+  // of each filter with four samples of padding where it starts.
+  buffer.resize(static_cast<size_t>(3*n + 16)*m);
+  double *x = &buffer[4*m];
+  double *y = x + static_cast<size_t>(n + 8)*m;
+  double *z = y + static_cast<size_t>(n)*m;
+
+  // Gather the samples
+  for (i = 0; i < n; i++)
+    {
+    const double *inPtr = data + i*step;
+    double *xPtr = x + i*m;
+    for (l = 0; l < m; l++)
+      {
+      xPtr[l] = inPtr[l*lineStep];
+      }
+    }
+  for (l = 0; l < m; l++)
+    {
+    double first = x[l];
+    double last = x[(n - 1)*m + l];
+    for (i = 1; i <= 4; i++)
+      {
+      x[l - i*m] = first;
+      x[(n - 1 + i)*m + l] = last;
+      y[l - i*m] = first*restN;
+      z[(n - 1 + i)*m + l] = last*restM;
+      }
+    }
+
+  // The causal filter
+  for (i = 0; i < n; i++)
+    {
+    const double *xPtr = x + i*m;
+    double *yPtr = y + i*m;
+    for (l = 0; l < m; l++)
+      {
+      yPtr[l] = N[0]*xPtr[l] + N[1]*xPtr[l - m] + N[2]*xPtr[l - 2*m] +
+        N[3]*xPtr[l - 3*m] - D[0]*yPtr[l - m] - D[1]*yPtr[l - 2*m] -
+        D[2]*yPtr[l - 3*m] - D[3]*yPtr[l - 4*m];
+      }
+    }
+
+  // The anti-causal filter
+  for (i = n - 1; i >= 0; i--)
+    {
+    const double *xPtr = x + i*m;
+    double *zPtr = z + i*m;
+    for (l = 0; l < m; l++)
+      {
+      zPtr[l] = M[0]*xPtr[l + m] + M[1]*xPtr[l + 2*m] + M[2]*xPtr[l + 3*m] +
+        M[3]*xPtr[l + 4*m] - D[0]*zPtr[l + m] - D[1]*zPtr[l + 2*m] -
+        D[2]*zPtr[l + 3*m] - D[3]*zPtr[l + 4*m];
+      }
+    }
+
+  // Scatter the sum
+  for (i = 0; i < n; i++)
+    {
+    double *outPtr = data + i*step;
+    const double *yPtr = y + i*m;
+    const double *zPtr = z + i*m;
+    for (l = 0; l < m; l++)
+      {
+      outPtr[l*lineStep] = yPtr[l] + zPtr[l];
+      }
+    }
+}
+
+//--------------------------------------------------------------------------
+// The lines of one pass along an axis.  The lines are laid out as
+// "Lanes" lines that are "LaneStep" apart, repeated along two outer
+// dimensions, and are split into blocks of VTK_RECURSIVE_GAUSSIAN_LINES
+// neighboring lines that the threads filter one at a time.
+class vtkImageRecursiveGaussianPass
+{
+public:
+  vtkAlgorithm *Self;
+  double *Data;
+  vtkImageRecursiveGaussianCoefficients Coefficients;
+  int Length;
+  vtkIdType Step;
+  vtkIdType LaneStep;
+  int Lanes;
+  int NumberOfLaneBlocks;
+  vtkIdType OuterStep[2];
+  int OuterCount[2];
+  vtkIdType NumberOfBlocks;
+  int NumberOfThreads;
+
+  static VTK_THREAD_RETURN_TYPE ThreadedExecute(void *arg);
+};
+
+//--------------------------------------------------------------------------
+VTK_THREAD_RETURN_TYPE vtkImageRecursiveGaussianPass::ThreadedExecute(
+  void *arg)
+{
+  vtkMultiThreader::ThreadInfo *info =
+    static_cast<vtkMultiThreader::ThreadInfo *>(arg);
+  vtkImageRecursiveGaussianPass *self =
+    static_cast<vtkImageRecursiveGaussianPass *>(info->UserData);
+  vtkIdType numBlocks = self->NumberOfBlocks;
+  vtkIdType begin = numBlocks*info->ThreadID/self->NumberOfThreads;
+  vtkIdType end = numBlocks*(info->ThreadID + 1)/self->NumberOfThreads;
+  vtkstd::vector<double> buffer;
+
+  for (vtkIdType b = begin; b < end; b++)
+    {
+    if (self->Self->GetAbortExecute())
+      {
+      break;
+      }
+    int laneBlock = static_cast<int>(b % self->NumberOfLaneBlocks);
+    vtkIdType outer = b / self->NumberOfLaneBlocks;
+    int outer0 = static_cast<int>(outer % self->OuterCount[0]);
+    int outer1 = static_cast<int>(outer / self->OuterCount[0]);
+    int firstLine = laneBlock*VTK_RECURSIVE_GAUSSIAN_LINES;
+    int numLines = self->Lanes - firstLine;
+    numLines = (numLines < VTK_RECURSIVE_GAUSSIAN_LINES ?
+                numLines : VTK_RECURSIVE_GAUSSIAN_LINES);
+    vtkImageRecursiveGaussianLines(
+      self->Coefficients,
+      self->Data + firstLine*self->LaneStep + outer0*self->OuterStep[0] +
+      outer1*self->OuterStep[1], self->Step, self->LaneStep, self->Length,
+      numLines, buffer);
+    }
+
+  return VTK_THREAD_RETURN_VALUE;
+}
+
+//--------------------------------------------------------------------------
+// Smooth an image of doubles in place along each axis whose standard
+// deviation, in samples, is not zero.  Each of these axes is filtered
+// over the whole extent of the image, but the result is only complete
+// within "outExt", whose other axes can be smaller than the image.
+void vtkImageRecursiveGaussianExecute(vtkAlgorithm *self,
+                                      vtkImageData *data,
+                                      const int outExt[6],
+                                      const double sigmas[3],
+                                      int maxThreads)
+{
+  int ext[6];
+  vtkIdType inc[3];
+  data->GetExtent(ext);
+  data->GetIncrements(inc);
+  int numComponents = data->GetNumberOfScalarComponents();
+
+  // The range of the lines along each axis, which shrinks to the output
+  // extent once the axis has been filtered.
+  int range[6];
+  for (int j = 0; j < 6; j++)
+    {
+    range[j] = ext[j];
+    }
+
+  // Filter Z first like the convolution, then Y and X
+  for (int axis = 2; axis >= 0; axis--)
+    {
+    if (sigmas[axis] == 0.0 || ext[2*axis] > ext[2*axis + 1])
+      {
+      continue;
+      }
+
+    vtkImageRecursiveGaussianPass pass;
+    pass.Self = self;
+    vtkImageRecursiveGaussianComputeCoefficients(sigmas[axis],
+                                                 pass.Coefficients);
+    pass.Length = ext[2*axis + 1] - ext[2*axis] + 1;
+    pass.Step = inc[axis];
+
+    int size[3];
+    for (int j = 0; j < 3; j++)
+      {
+      size[j] = range[2*j + 1] - range[2*j] + 1;
+      }
+    pass.Data = static_cast<double *>(data->GetScalarPointer(
+      range[0], range[2], range[4]));
+
+    if (axis != 0)
+      {
+      // The lines across X and the components are contiguous
+      int other = 3 - axis;
+      pass.LaneStep = 1;
+      pass.Lanes = size[0]*numComponents;
+      pass.OuterStep[0] = inc[other];
+      pass.OuterCount[0] = size[other];
+      pass.OuterStep[1] = 0;
+      pass.OuterCount[1] = 1;
+      }
+    else
+      {
+      // The rows are filtered a few at a time along Y
+      pass.LaneStep = inc[1];
+      pass.Lanes = size[1];
+      pass.OuterStep[0] = 1;
+      pass.OuterCount[0] = numComponents;
+      pass.OuterStep[1] = inc[2];
+      pass.OuterCount[1] = size[2];
+      }
+    pass.NumberOfLaneBlocks =
+      (pass.Lanes + VTK_RECURSIVE_GAUSSIAN_LINES - 1)/
+      VTK_RECURSIVE_GAUSSIAN_LINES;
+    pass.NumberOfBlocks = static_cast<vtkIdType>(pass.NumberOfLaneBlocks)*
+      pass.OuterCount[0]*pass.OuterCount[1];
+
+    // Use fewer threads for small images
+    vtkIdType numSamples = static_cast<vtkIdType>(pass.Length)*pass.Lanes*
+      pass.OuterCount[0]*pass.OuterCount[1];
+    int numThreads = maxThreads;
+    vtkIdType maxUsefulThreads =
+      numSamples/VTK_RECURSIVE_GAUSSIAN_SAMPLES_PER_THREAD;
+    if (maxUsefulThreads < numThreads)
+      {
+      numThreads = static_cast<int>(maxUsefulThreads > 1 ?
+                                    maxUsefulThreads : 1);
+      }
+    if (pass.NumberOfBlocks < numThreads)
+      {
+      numThreads = static_cast<int>(pass.NumberOfBlocks);
+      }
+    pass.NumberOfThreads = numThreads;
+
+    if (numThreads <= 1)
+      {
+      pass.NumberOfThreads = 1;
+      vtkMultiThreader::ThreadInfo info;
+      info.ThreadID = 0;
+      info.NumberOfThreads = 1;
+      info.UserData = &pass;
+      vtkImageRecursiveGaussianPass::ThreadedExecute(&info);
+      }
+    else
+      {
+      vtkMultiThreader *threader = vtkMultiThreader::New();
+      threader->SetNumberOfThreads(numThreads);
+      threader->SetSingleMethod(
+        vtkImageRecursiveGaussianPass::ThreadedExecute, &pass);
+      threader->SingleMethodExecute();
+      threader->Delete();
+      }
+
+    range[2*axis] = outExt[2*axis];
+    range[2*axis + 1] = outExt[2*axis + 1];
+    }
+}
+
+//--------------------------------------------------------------------------
+// Copy the samples of an array within an extent into doubles.  The array
+// pointer is at the first sample of the extent, and the increments are
+// those of the image that owns the array.
+template <class T>
+void vtkImageRecursiveGaussianCopy(const T *inPtr, const vtkIdType inInc[3],
+                                   double *outPtr, const int ext[6],
+                                   int numComponents)
+{
+  vtkIdType rowLength =
+    static_cast<vtkIdType>(ext[1] - ext[0] + 1)*numComponents;
+  for (int k = ext[4]; k <= ext[5]; ++k)
+    {
+    const T *inPtr1 = inPtr;
+    for (int j = ext[2]; j <= ext[3]; ++j)
+      {
+      for (vtkIdType i = 0; i < rowLength; ++i)
+        {
+        outPtr[i] = static_cast<double>(inPtr1[i]);
+        }
+      outPtr += rowLength;
+      inPtr1 += inInc[1];
+      }
+    inPtr += inInc[2];
+    }
+}
+
+//--------------------------------------------------------------------------
+// Copy the part of a point data array of an image that lies within an
+// extent into a new image of doubles with the same origin and spacing, and
+// smooth it.  Only the samples within outExt are smoothed along each axis
+// after that axis has been filtered, so outExt must lie within extent, and
+// extent must cover the smoothed axes entirely.  The caller deletes the
+// image.
+vtkImageData *vtkImageRecursiveGaussianSmoothArray(vtkAlgorithm *self,
+                                                   vtkImageData *input,
+                                                   vtkDataArray *array,
+                                                   const int extent[6],
+                                                   const int outExt[6],
+                                                   const double sigmas[3],
+                                                   int maxThreads)
+{
+  int numComponents = array->GetNumberOfComponents();
+  vtkImageData *output = vtkImageData::New();
+  output->SetExtent(const_cast<int *>(extent));
+  output->SetSpacing(input->GetSpacing());
+  output->SetOrigin(input->GetOrigin());
+  output->SetScalarTypeToDouble();
+  output->SetNumberOfScalarComponents(numComponents);
+  output->AllocateScalars();
+  double *outPtr = static_cast<double *>(output->GetScalarPointer());
+
+  int *inExt = input->GetExtent();
+  vtkIdType inInc[3];
+  inInc[0] = numComponents;
+  inInc[1] = inInc[0]*(inExt[1] - inExt[0] + 1);
+  inInc[2] = inInc[1]*(inExt[3] - inExt[2] + 1);
+  vtkIdType offset = (extent[0] - inExt[0])*inInc[0] +
+    (extent[2] - inExt[2])*inInc[1] + (extent[4] - inExt[4])*inInc[2];
+
+  switch (array->GetDataType())
+    {
+    vtkTemplateMacro(
+      vtkImageRecursiveGaussianCopy(
+        static_cast<VTK_TT *>(array->GetVoidPointer(0)) + offset,
+        inInc, outPtr, extent, numComponents));
+    default:
+      {
+      // arrays without contiguous samples go one value at a time
+      vtkIdType outId = 0;
+      for (int k = extent[4]; k <= extent[5]; ++k)
+        {
+        for (int j = extent[2]; j <= extent[3]; ++j)
+          {
+          vtkIdType inId = (offset + (k - extent[4])*inInc[2] +
+                            (j - extent[2])*inInc[1])/numComponents;
+          for (int i = extent[0]; i <= extent[1]; ++i, ++inId)
+            {
+            for (int c = 0; c < numComponents; ++c)
+              {
+              outPtr[outId++] = array->GetComponent(inId, c);
+              }
+            }
+          }
+        }
+      }
+    }
+
+  vtkImageRecursiveGaussianExecute(self, output, outExt, sigmas, maxThreads);
+
+  return output;
+}
+
+} // end anonymous namespace
+
+#endif
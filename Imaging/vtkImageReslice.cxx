@@ -2001,6 +2001,13 @@ void vtkImageResliceExecute(vtkImageReslice *self,
     optimizeNearest = 1;
     }
 
+  // can a whole row be interpolated at once?
+  bool interpolateRows = 0;
+  if (!(newtrans || perspective) && nsamples <= 1)
+    {
+    interpolateRows = 1;
+    }
+
   // get Increments to march through data
   vtkIdType outIncX, outIncY, outIncZ;
   outData->GetContinuousIncrements(outExt, outIncX, outIncY, outIncZ);
@@ -2098,7 +2105,65 @@ void vtkImageResliceExecute(vtkImageReslice *self,
                                      outPtr, background, outComponents,
                                      setpixels, iter))
         {
-        if (!optimizeNearest)
+        if (!optimizeNearest && interpolateRows)
+          {
+          // interpolate each run of in-bounds pixels as a row
+          int startIdX = idXmin;
+          while (startIdX <= idXmax)
+            {
+            F inPoint[3];
+            inPoint[0] = inPoint1[0] + startIdX*xAxis[0];
+            inPoint[1] = inPoint1[1] + startIdX*xAxis[1];
+            inPoint[2] = inPoint1[2] + startIdX*xAxis[2];
+            bool isInBounds = interpolator->CheckBoundsIJK(inPoint);
+            int endIdX = startIdX;
+            while (endIdX < idXmax)
+              {
+              inPoint[0] = inPoint1[0] + (endIdX + 1)*xAxis[0];
+              inPoint[1] = inPoint1[1] + (endIdX + 1)*xAxis[1];
+              inPoint[2] = inPoint1[2] + (endIdX + 1)*xAxis[2];
+              if (interpolator->CheckBoundsIJK(inPoint) != isInBounds)
+                {
+                break;
+                }
+              endIdX++;
+              }
+            int numpixels = endIdX - startIdX + 1;
+
+            if (isInBounds)
+              {
+              if (outputStencil)
+                {
+                outputStencil->InsertNextExtent(startIdX, endIdX, idY, idZ);
+                }
+
+              interpolator->InterpolateRowIJK(inPoint1, xAxis, startIdX,
+                                              floatPtr, numpixels);
+
+              if (convertScalars)
+                {
+                (self->*convertScalars)(floatPtr, outPtr,
+                                        vtkTypeTraits<F>::VTKTypeID(),
+                                        inComponents, numpixels,
+                                        startIdX, idY, idZ, threadId);
+
+                outPtr = static_cast<void *>(static_cast<char *>(outPtr)
+                           + numpixels*outComponents*scalarSize);
+                }
+              else
+                {
+                convertpixels(outPtr, floatPtr, outComponents, numpixels);
+                }
+              }
+            else
+              {
+              setpixels(outPtr, background, outComponents, numpixels);
+              }
+
+            startIdX += numpixels;
+            }
+          }
+        else if (!optimizeNearest)
           {
           bool wasInBounds = 1;
           bool isInBounds = 1;
@@ -2503,20 +2568,25 @@ struct vtkImageResliceRowComp
   static void MaxRow(F *op, const F *ip, int nc, int m, int i, int n);
 };
 
+// The compositors are simple loops over the row, so that the compiler
+// can vectorize them.
 template<class F>
 void vtkImageResliceRowComp<F>::SumRow(
   F *outPtr, const F *inPtr, int numComp, int count, int i, int)
 {
   int m = count*numComp;
-  if (m)
+  if (i == 0)
     {
-    if (i == 0)
+    for (int k = 0; k < m; k++)
       {
-      do { *outPtr++ = *inPtr++; } while (--m);
+      outPtr[k] = inPtr[k];
       }
-    else
+    }
+  else
+    {
+    for (int k = 0; k < m; k++)
       {
-      do { *outPtr++ += *inPtr++; } while (--m);
+      outPtr[k] += inPtr[k];
       }
     }
 }
@@ -2526,19 +2596,26 @@ void vtkImageResliceRowComp<F>::SumRowTrap(
   F *outPtr, const F *inPtr, int numComp, int count, int i, int n)
 {
   int m = count*numComp;
-  if (m)
+  F half = static_cast<F>(0.5);
+  if (i == 0)
     {
-    if (i == 0)
+    for (int k = 0; k < m; k++)
       {
-      do { *outPtr++ = 0.5*(*inPtr++); } while (--m);
+      outPtr[k] = half*inPtr[k];
       }
-    else if (i == n-1)
+    }
+  else if (i == n-1)
+    {
+    for (int k = 0; k < m; k++)
       {
-      do { *outPtr++ += 0.5*(*inPtr++); } while (--m);
+      outPtr[k] += half*inPtr[k];
       }
-    else
+    }
+  else
+    {
+    for (int k = 0; k < m; k++)
       {
-      do { *outPtr++ += *inPtr++; } while (--m);
+      outPtr[k] += inPtr[k];
       }
     }
 }
@@ -2548,20 +2625,26 @@ void vtkImageResliceRowComp<F>::MeanRow(
   F *outPtr, const F *inPtr, int numComp, int count, int i, int n)
 {
   int m = count*numComp;
-  if (m)
+  if (i == 0)
     {
-    if (i == 0)
+    for (int k = 0; k < m; k++)
       {
-      do { *outPtr++ = *inPtr++; } while (--m);
+      outPtr[k] = inPtr[k];
       }
-    else if (i == n-1)
+    }
+  else if (i == n-1)
+    {
+    F f = F(1.0/n);
+    for (int k = 0; k < m; k++)
       {
-      F f = F(1.0/n);
-      do { *outPtr += *inPtr++; *outPtr *= f; outPtr++; } while (--m);
+      outPtr[k] = (outPtr[k] + inPtr[k])*f;
       }
-    else
+    }
+  else
+    {
+    for (int k = 0; k < m; k++)
       {
-      do { *outPtr++ += *inPtr++; } while (--m);
+      outPtr[k] += inPtr[k];
       }
     }
 }
@@ -2571,20 +2654,27 @@ void vtkImageResliceRowComp<F>::MeanRowTrap(
   F *outPtr, const F *inPtr, int numComp, int count, int i, int n)
 {
   int m = count*numComp;
-  if (m)
+  F half = static_cast<F>(0.5);
+  if (i == 0)
     {
-    if (i == 0)
+    for (int k = 0; k < m; k++)
       {
-      do { *outPtr++ = 0.5*(*inPtr++); } while (--m);
+      outPtr[k] = half*inPtr[k];
       }
-    else if (i == n-1)
+    }
+  else if (i == n-1)
+    {
+    F f = F(1.0/(n-1));
+    for (int k = 0; k < m; k++)
       {
-      F f = F(1.0/(n-1));
-      do { *outPtr += 0.5*(*inPtr++); *outPtr *= f; outPtr++; } while (--m);
+      outPtr[k] = (outPtr[k] + half*inPtr[k])*f;
       }
-    else
+    }
+  else
+    {
+    for (int k = 0; k < m; k++)
       {
-      do { *outPtr++ += *inPtr++; } while (--m);
+      outPtr[k] += inPtr[k];
       }
     }
 }
@@ -2594,20 +2684,18 @@ void vtkImageResliceRowComp<F>::MinRow(
   F *outPtr, const F *inPtr, int numComp, int count, int i, int)
 {
   int m = count*numComp;
-  if (m)
+  if (i == 0)
     {
-    if (i == 0)
+    for (int k = 0; k < m; k++)
       {
-      do { *outPtr++ = *inPtr++; } while (--m);
+      outPtr[k] = inPtr[k];
       }
-    else
+    }
+  else
+    {
+    for (int k = 0; k < m; k++)
       {
-      do
-        {
-        *outPtr = ((*outPtr < *inPtr) ? *outPtr : *inPtr);
-        outPtr++; inPtr++;
-        }
-      while (--m);
+      outPtr[k] = ((outPtr[k] < inPtr[k]) ? outPtr[k] : inPtr[k]);
       }
     }
 }
@@ -2617,20 +2705,18 @@ void vtkImageResliceRowComp<F>::MaxRow(
   F *outPtr, const F *inPtr, int numComp, int count, int i, int)
 {
   int m = count*numComp;
-  if (m)
+  if (i == 0)
     {
-    if (i == 0)
+    for (int k = 0; k < m; k++)
       {
-      do { *outPtr++ = *inPtr++; } while (--m);
+      outPtr[k] = inPtr[k];
       }
-    else
+    }
+  else
+    {
+    for (int k = 0; k < m; k++)
       {
-      do
-        {
-        *outPtr = ((*outPtr > *inPtr) ? *outPtr : *inPtr);
-        outPtr++; inPtr++;
-        }
-      while (--m);
+      outPtr[k] = ((outPtr[k] > inPtr[k]) ? outPtr[k] : inPtr[k]);
       }
     }
 }
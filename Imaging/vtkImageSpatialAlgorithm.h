@@ -28,6 +28,10 @@
 
 #include "vtkThreadedImageAlgorithm.h"
 
+// Kernel shapes of the morphology filters
+#define VTK_IMAGE_KERNEL_ELLIPSOID 0
+#define VTK_IMAGE_KERNEL_BOX       1
+
 class VTK_IMAGING_EXPORT vtkImageSpatialAlgorithm : public vtkThreadedImageAlgorithm
 {
 public:
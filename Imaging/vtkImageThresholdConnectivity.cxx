@@ -29,6 +29,7 @@
 #include "vtkTemplateAliasMacro.h"
 
 #include <stack>
+#include <vtkstd/vector>
 
 vtkStandardNewMacro(vtkImageThresholdConnectivity);
 vtkCxxSetObjectMacro(vtkImageThresholdConnectivity, SeedPoints, vtkPoints);
@@ -471,7 +472,9 @@ void vtkImageThresholdConnectivityExecute(
 
   // create the seed stack:
   // stack has methods empty(), top(), push(), and pop()
-  vtkstd::stack<vtkFloodFillSeed> seedStack;
+  // (a vector grows in place, where the default deque allocates blocks)
+  vtkstd::stack<vtkFloodFillSeed, vtkstd::vector<vtkFloodFillSeed> >
+    seedStack;
 
   // initialize with the seeds provided by the user
   vtkPoints *points = self->GetSeedPoints();
@@ -22,10 +22,14 @@
 #include "vtkMath.h"
 #include "vtkInformation.h"
 #include "vtkInformationVector.h"
+#include "vtkMultiThreader.h"
 #include "vtkObjectFactory.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
 #include "vtkPointData.h"
 
+#include <vtkstd/vector>
+#include <math.h>
+
 vtkStandardNewMacro(vtkSampleFunction);
 vtkCxxSetObjectMacro(vtkSampleFunction,ImplicitFunction,vtkImplicitFunction);
 
@@ -56,6 +60,10 @@ vtkSampleFunction::vtkSampleFunction()
   this->NormalArrayName=0;
   this->SetNormalArrayName("normals");
 
+  this->NumberOfThreads = 1;
+  this->AdaptiveSampling = 0;
+  this->AdaptiveBlockSize = 8;
+  this->AdaptiveContourValue = 0.0;
   
   this->SetNumberOfInputPorts(0);
 }
@@ -138,12 +146,395 @@ int vtkSampleFunction::RequestInformation (
 }
 
 
+//----------------------------------------------------------------------------
+template <class T>
+void vtkSampleFunctionStore(T *scalars, const double *values, int n)
+{
+  for (int i = 0; i < n; i++)
+    {
+    scalars[i] = static_cast<T>(values[i]);
+    }
+}
+
+//----------------------------------------------------------------------------
+template <class T>
+void vtkSampleFunctionFill(T *scalars, double value, int n)
+{
+  T v = static_cast<T>(value);
+  for (int i = 0; i < n; i++)
+    {
+    scalars[i] = v;
+    }
+}
+
+//----------------------------------------------------------------------------
+// Samples the implicit function over the slabs of the output, either at
+// every voxel, or at the corners of the blocks and then at every voxel of
+// the blocks near the contour value.
+class vtkSampleFunctionWorker
+{
+public:
+  enum { SAMPLE_ALL, SAMPLE_NODES, SAMPLE_BLOCKS };
+
+  vtkSampleFunction *Self;
+  vtkImplicitFunction *Function;
+  int Pass;
+  int NumberOfThreads;
+  int Extent[6];
+  int Increments[3];
+  double Origin[3];
+  double Spacing[3];
+  void *Scalars;
+  int ScalarType;
+  float *Normals;
+
+  // the adaptive sampling
+  int BlockSize;
+  double ContourValue;
+  int NumberOfBlocks[3];
+  vtkstd::vector<double> NodeValues;
+  vtkstd::vector<double> NodeGradients;
+  vtkstd::vector<char> Refine;
+
+  // The index of the first voxel of node or block b along an axis.
+  int GetNodeIndex(int axis, int b)
+    {
+    int idx = this->Extent[2*axis] + b*this->BlockSize;
+    return (idx < this->Extent[2*axis+1] ? idx : this->Extent[2*axis+1]);
+    }
+
+  // The end of the voxels that block b owns along an axis, so that the
+  // last block owns the upper boundary.
+  int GetOwnedEnd(int axis, int b)
+    {
+    return (b == this->NumberOfBlocks[axis] - 1 ?
+            this->Extent[2*axis+1] + 1 : this->GetNodeIndex(axis, b + 1));
+    }
+
+  int IsRefined(int bi, int bj, int bk)
+    {
+    return this->Refine[bi + this->NumberOfBlocks[0]*
+                        (bj + this->NumberOfBlocks[1]*bk)];
+    }
+
+  // Whether a block below a voxel on the lower faces of block (bi,bj,bk)
+  // is refined, so that the voxel is a corner of its cells.
+  int IsLowerRefined(int bi, int bj, int bk, int li, int lj, int lk)
+    {
+    for (int dk = 0; dk <= lk; dk++)
+      {
+      for (int dj = 0; dj <= lj; dj++)
+        {
+        for (int di = 0; di <= li; di++)
+          {
+          if ((di || dj || dk) && this->IsRefined(bi - di, bj - dj, bk - dk))
+            {
+            return 1;
+            }
+          }
+        }
+      }
+    return 0;
+    }
+
+  void SampleRow(int i0, int i1, int j, int k,
+                 vtkDoubleArray *points, vtkDoubleArray *values);
+  void FillRow(int i0, int i1, int j, int k, double value);
+  void SampleNodes(int ck, vtkDoubleArray *points, vtkDoubleArray *values);
+  void SampleBlocks(int bk, vtkDoubleArray *points, vtkDoubleArray *values);
+  void Execute(int threadId);
+  static VTK_THREAD_RETURN_TYPE ThreadedExecute(void *arg);
+  void Run(int pass, int numLayers);
+};
+
+//----------------------------------------------------------------------------
+// Evaluate the function and the normals from voxel i0 to voxel i1 of a row.
+void vtkSampleFunctionWorker::SampleRow(int i0, int i1, int j, int k,
+                                        vtkDoubleArray *points,
+                                        vtkDoubleArray *values)
+{
+  int n = i1 - i0 + 1;
+  points->SetNumberOfTuples(n);
+  double *p = points->GetPointer(0);
+  double y = this->Origin[1] + j*this->Spacing[1];
+  double z = this->Origin[2] + k*this->Spacing[2];
+  for (int i = i0; i <= i1; i++, p += 3)
+    {
+    p[0] = this->Origin[0] + i*this->Spacing[0];
+    p[1] = y;
+    p[2] = z;
+    }
+  this->Function->FunctionValue(points, values);
+
+  vtkIdType idx = (i0 - this->Extent[0]) +
+    (j - this->Extent[2])*static_cast<vtkIdType>(this->Increments[1]) +
+    (k - this->Extent[4])*static_cast<vtkIdType>(this->Increments[2]);
+  switch (this->ScalarType)
+    {
+    vtkTemplateMacro(
+      vtkSampleFunctionStore(static_cast<VTK_TT *>(this->Scalars) + idx,
+                             values->GetPointer(0), n));
+    }
+
+  if (this->Normals)
+    {
+    float *normal = this->Normals + 3*idx;
+    p = points->GetPointer(0);
+    for (int i = 0; i < n; i++, p += 3, normal += 3)
+      {
+      double g[3];
+      this->Function->FunctionGradient(p, g);
+      g[0] *= -1;
+      g[1] *= -1;
+      g[2] *= -1;
+      vtkMath::Normalize(g);
+      normal[0] = static_cast<float>(g[0]);
+      normal[1] = static_cast<float>(g[1]);
+      normal[2] = static_cast<float>(g[2]);
+      }
+    }
+}
+
+//----------------------------------------------------------------------------
+// Set voxels i0 to i1 of a row to a value, with null normals.
+void vtkSampleFunctionWorker::FillRow(int i0, int i1, int j, int k,
+                                      double value)
+{
+  int n = i1 - i0 + 1;
+  vtkIdType idx = (i0 - this->Extent[0]) +
+    (j - this->Extent[2])*static_cast<vtkIdType>(this->Increments[1]) +
+    (k - this->Extent[4])*static_cast<vtkIdType>(this->Increments[2]);
+  switch (this->ScalarType)
+    {
+    vtkTemplateMacro(
+      vtkSampleFunctionFill(static_cast<VTK_TT *>(this->Scalars) + idx,
+                            value, n));
+    }
+
+  if (this->Normals)
+    {
+    float *normal = this->Normals + 3*idx;
+    for (int i = 0; i < 3*n; i++)
+      {
+      normal[i] = 0.0f;
+      }
+    }
+}
+
+//----------------------------------------------------------------------------
+// Evaluate the function and the magnitude of its gradient at the block
+// corners of a layer of nodes.
+void vtkSampleFunctionWorker::SampleNodes(int ck, vtkDoubleArray *points,
+                                          vtkDoubleArray *values)
+{
+  int numNodes[3];
+  for (int axis = 0; axis < 3; axis++)
+    {
+    numNodes[axis] = this->NumberOfBlocks[axis] + 1;
+    }
+  points->SetNumberOfTuples(numNodes[0]);
+  double z = this->Origin[2] + this->GetNodeIndex(2, ck)*this->Spacing[2];
+  for (int cj = 0; cj < numNodes[1]; cj++)
+    {
+    double y = this->Origin[1] + this->GetNodeIndex(1, cj)*this->Spacing[1];
+    double *p = points->GetPointer(0);
+    for (int ci = 0; ci < numNodes[0]; ci++, p += 3)
+      {
+      p[0] = this->Origin[0] + this->GetNodeIndex(0, ci)*this->Spacing[0];
+      p[1] = y;
+      p[2] = z;
+      }
+    this->Function->FunctionValue(points, values);
+
+    vtkIdType node = numNodes[0]*(cj + numNodes[1]*ck);
+    p = points->GetPointer(0);
+    for (int ci = 0; ci < numNodes[0]; ci++, p += 3)
+      {
+      double g[3];
+      this->Function->FunctionGradient(p, g);
+      this->NodeValues[node + ci] = values->GetValue(ci);
+      this->NodeGradients[node + ci] = vtkMath::Norm(g);
+      }
+    }
+}
+
+//----------------------------------------------------------------------------
+// Sample the voxels that a layer of blocks owns, at every voxel of the
+// refined blocks and of the faces that skipped blocks share with them.
+void vtkSampleFunctionWorker::SampleBlocks(int bk, vtkDoubleArray *points,
+                                           vtkDoubleArray *values)
+{
+  int numNodes[2];
+  numNodes[0] = this->NumberOfBlocks[0] + 1;
+  numNodes[1] = this->NumberOfBlocks[1] + 1;
+  int k0 = this->GetNodeIndex(2, bk);
+  int k1 = this->GetOwnedEnd(2, bk);
+
+  for (int bj = 0; bj < this->NumberOfBlocks[1]; bj++)
+    {
+    int j0 = this->GetNodeIndex(1, bj);
+    int j1 = this->GetOwnedEnd(1, bj);
+    for (int bi = 0; bi < this->NumberOfBlocks[0]; bi++)
+      {
+      int i0 = this->GetNodeIndex(0, bi);
+      int i1 = this->GetOwnedEnd(0, bi) - 1;
+      if (this->IsRefined(bi, bj, bk))
+        {
+        for (int k = k0; k < k1; k++)
+          {
+          for (int j = j0; j < j1; j++)
+            {
+            this->SampleRow(i0, i1, j, k, points, values);
+            }
+          }
+        continue;
+        }
+
+      // fill with the corner value that is nearest to the contour value
+      double fill = 0.0;
+      double nearest = VTK_DOUBLE_MAX;
+      for (int c = 0; c < 8; c++)
+        {
+        double v = this->NodeValues[(bi + (c & 1)) + numNodes[0]*
+          ((bj + ((c >> 1) & 1)) + numNodes[1]*(bk + ((c >> 2) & 1)))];
+        double d = fabs(v - this->ContourValue);
+        if (d < nearest)
+          {
+          nearest = d;
+          fill = v;
+          }
+        }
+
+      int li = (bi > 0);
+      for (int k = k0; k < k1; k++)
+        {
+        int lk = (k == k0 && bk > 0);
+        for (int j = j0; j < j1; j++)
+          {
+          int lj = (j == j0 && bj > 0);
+          int first = i0;
+          if (li && this->IsLowerRefined(bi, bj, bk, 1, lj, lk))
+            {
+            this->SampleRow(i0, i0, j, k, points, values);
+            first = i0 + 1;
+            }
+          if ((lj || lk) && first <= i1 &&
+              this->IsLowerRefined(bi, bj, bk, 0, lj, lk))
+            {
+            this->SampleRow(first, i1, j, k, points, values);
+            }
+          else if (first <= i1)
+            {
+            this->FillRow(first, i1, j, k, fill);
+            }
+          }
+        }
+      }
+    }
+}
+
+//----------------------------------------------------------------------------
+void vtkSampleFunctionWorker::Execute(int threadId)
+{
+  int numLayers;
+  if (this->Pass == SAMPLE_ALL)
+    {
+    numLayers = this->Extent[5] - this->Extent[4] + 1;
+    }
+  else if (this->Pass == SAMPLE_NODES)
+    {
+    numLayers = this->NumberOfBlocks[2] + 1;
+    }
+  else
+    {
+    numLayers = this->NumberOfBlocks[2];
+    }
+  int first = static_cast<int>(
+    static_cast<vtkIdType>(numLayers)*threadId/this->NumberOfThreads);
+  int last = static_cast<int>(
+    static_cast<vtkIdType>(numLayers)*(threadId + 1)/this->NumberOfThreads);
+
+  vtkDoubleArray *points = vtkDoubleArray::New();
+  points->SetNumberOfComponents(3);
+  vtkDoubleArray *values = vtkDoubleArray::New();
+
+  for (int layer = first; layer < last; layer++)
+    {
+    if (this->Self->GetAbortExecute())
+      {
+      break;
+      }
+    if (threadId == 0 && this->Pass != SAMPLE_NODES)
+      {
+      this->Self->UpdateProgress(
+        static_cast<double>(layer - first)/(last - first));
+      }
+
+    if (this->Pass == SAMPLE_ALL)
+      {
+      int k = this->Extent[4] + layer;
+      for (int j = this->Extent[2]; j <= this->Extent[3]; j++)
+        {
+        this->SampleRow(this->Extent[0], this->Extent[1], j, k,
+                        points, values);
+        }
+      }
+    else if (this->Pass == SAMPLE_NODES)
+      {
+      this->SampleNodes(layer, points, values);
+      }
+    else
+      {
+      this->SampleBlocks(layer, points, values);
+      }
+    }
+
+  points->Delete();
+  values->Delete();
+}
+
+//----------------------------------------------------------------------------
+VTK_THREAD_RETURN_TYPE vtkSampleFunctionWorker::ThreadedExecute(void *arg)
+{
+  vtkMultiThreader::ThreadInfo *info =
+    static_cast<vtkMultiThreader::ThreadInfo *>(arg);
+  vtkSampleFunctionWorker *worker =
+    static_cast<vtkSampleFunctionWorker *>(info->UserData);
+  worker->Execute(info->ThreadID);
+  return VTK_THREAD_RETURN_VALUE;
+}
+
+//----------------------------------------------------------------------------
+// Run a pass over numLayers layers, split among the threads.
+void vtkSampleFunctionWorker::Run(int pass, int numLayers)
+{
+  this->Pass = pass;
+  this->NumberOfThreads = this->Self->GetNumberOfThreads();
+  if (this->NumberOfThreads > numLayers)
+    {
+    this->NumberOfThreads = numLayers;
+    }
+
+  if (this->NumberOfThreads <= 1)
+    {
+    this->NumberOfThreads = 1;
+    this->Execute(0);
+    }
+  else
+    {
+    vtkMultiThreader *threader = vtkMultiThreader::New();
+    threader->SetNumberOfThreads(this->NumberOfThreads);
+    threader->SetSingleMethod(vtkSampleFunctionWorker::ThreadedExecute, this);
+    threader->SingleMethodExecute();
+    threader->Delete();
+    }
+}
+
+//----------------------------------------------------------------------------
 void vtkSampleFunction::ExecuteData(vtkDataObject *outp)
 {
-  vtkIdType idx, i, j, k;
-  vtkFloatArray *newNormals=NULL;
   vtkIdType numPts;
-  double p[3], s;
+  vtkFloatArray *newNormals=NULL;
   vtkImageData *output=this->GetOutput();
 
   output->SetExtent(output->GetUpdateExtent());
@@ -162,56 +553,99 @@ void vtkSampleFunction::ExecuteData(vtkDataObject *outp)
 
   numPts = newScalars->GetNumberOfTuples();
 
-  // Traverse all points evaluating implicit function at each point
-  //
-  int extent[6];
-  output->GetUpdateExtent(extent);
-  double spacing[3];
-  output->GetSpacing(spacing);
-
-  for ( idx=0, k=extent[4]; k <= extent[5]; k++ )
-    {
-    p[2] = this->ModelBounds[4] + k*spacing[2];
-    for ( j=extent[2]; j <= extent[3]; j++ )
-      {
-      p[1] = this->ModelBounds[2] + j*spacing[1];
-      for ( i=extent[0]; i <= extent[1]; i++ )
-        {
-        p[0] = this->ModelBounds[0] + i*spacing[0];
-        s = this->ImplicitFunction->FunctionValue(p);
-        newScalars->SetTuple1(idx++,s);
-        }
-      }
-    }
-
-  // If normal computation turned on, compute them
+  // If normal computation turned on, they are computed with the scalars
   //
   if ( this->ComputeNormals )
     {
-    double n[3];
     newNormals = vtkFloatArray::New(); 
     newNormals->SetNumberOfComponents(3);
     newNormals->SetNumberOfTuples(numPts);
-    for ( idx=0, k=extent[4]; k <= extent[5]; k++ )
+    }
+
+  // Traverse all points evaluating implicit function at each point
+  //
+  vtkSampleFunctionWorker worker;
+  worker.Self = this;
+  worker.Function = this->ImplicitFunction;
+  output->GetUpdateExtent(worker.Extent);
+  output->GetSpacing(worker.Spacing);
+  worker.Increments[0] = 1;
+  worker.Increments[1] = worker.Extent[1] - worker.Extent[0] + 1;
+  worker.Increments[2] =
+    worker.Increments[1]*(worker.Extent[3] - worker.Extent[2] + 1);
+  for (int i = 0; i < 3; i++)
+    {
+    worker.Origin[i] = this->ModelBounds[2*i];
+    }
+  worker.Scalars = newScalars->GetVoidPointer(0);
+  worker.ScalarType = newScalars->GetDataType();
+  worker.Normals = (newNormals ? newNormals->GetPointer(0) : NULL);
+  worker.BlockSize = this->AdaptiveBlockSize;
+  worker.ContourValue = this->AdaptiveContourValue;
+
+  if ( !this->AdaptiveSampling )
+    {
+    worker.Run(vtkSampleFunctionWorker::SAMPLE_ALL,
+               worker.Extent[5] - worker.Extent[4] + 1);
+    }
+  else
+    {
+    // Sample the corners of the blocks
+    int numNodes[3];
+    for (int axis = 0; axis < 3; axis++)
+      {
+      int n = worker.Extent[2*axis+1] - worker.Extent[2*axis];
+      worker.NumberOfBlocks[axis] = (n > 0 ? (n - 1)/this->AdaptiveBlockSize + 1
+                                     : 1);
+      numNodes[axis] = worker.NumberOfBlocks[axis] + 1;
+      }
+    vtkIdType numNodePts =
+      static_cast<vtkIdType>(numNodes[0])*numNodes[1]*numNodes[2];
+    worker.NodeValues.resize(numNodePts);
+    worker.NodeGradients.resize(numNodePts);
+    worker.Run(vtkSampleFunctionWorker::SAMPLE_NODES, numNodes[2]);
+
+    // Refine the blocks whose corners are on both sides of the contour
+    // value, or that the level set may reach according to the gradient
+    worker.Refine.resize(static_cast<vtkIdType>(worker.NumberOfBlocks[0])*
+                         worker.NumberOfBlocks[1]*worker.NumberOfBlocks[2]);
+    vtkIdType block = 0;
+    for (int bk = 0; bk < worker.NumberOfBlocks[2]; bk++)
       {
-      p[2] = this->ModelBounds[4] + k*spacing[2];
-      for ( j=extent[2]; j <= extent[3]; j++ )
+      for (int bj = 0; bj < worker.NumberOfBlocks[1]; bj++)
         {
-        p[1] = this->ModelBounds[2] + j*spacing[1];
-        for ( i=extent[0]; i <= extent[1]; i++ )
+        for (int bi = 0; bi < worker.NumberOfBlocks[0]; bi++, block++)
           {
-          p[0] = this->ModelBounds[0] + i*spacing[0];
-          this->ImplicitFunction->FunctionGradient(p, n);
-          n[0] *= -1;
-          n[1] *= -1;
-          n[2] *= -1;
-          vtkMath::Normalize(n);
-          newNormals->SetTuple(idx++,n);
+          int b[3] = { bi, bj, bk };
+          double diagonal = 0.0;
+          for (int axis = 0; axis < 3; axis++)
+            {
+            double d = (worker.GetNodeIndex(axis, b[axis] + 1) -
+                        worker.GetNodeIndex(axis, b[axis]))*
+              worker.Spacing[axis];
+            diagonal += d*d;
+            }
+          diagonal = sqrt(diagonal);
+
+          int above = 0;
+          int refine = 0;
+          for (int c = 0; c < 8; c++)
+            {
+            vtkIdType node = (bi + (c & 1)) + numNodes[0]*
+              ((bj + ((c >> 1) & 1)) + numNodes[1]*(bk + ((c >> 2) & 1)));
+            double d = worker.NodeValues[node] - this->AdaptiveContourValue;
+            above += (d > 0);
+            refine |= (fabs(d) <= worker.NodeGradients[node]*diagonal);
+            }
+          worker.Refine[block] = (refine || (above != 0 && above != 8));
           }
         }
       }
+
+    worker.Run(vtkSampleFunctionWorker::SAMPLE_BLOCKS,
+               worker.NumberOfBlocks[2]);
     }
-  
+
   newScalars->SetName(this->ScalarArrayName);
   
   
@@ -378,6 +812,13 @@ void vtkSampleFunction::PrintSelf(ostream& os, vtkIndent indent)
     {
     os  << "(none)" << endl;
     }
+
+  os << indent << "NumberOfThreads: " << this->NumberOfThreads << "\n";
+  os << indent << "AdaptiveSampling: "
+     << (this->AdaptiveSampling ? "On\n" : "Off\n");
+  os << indent << "AdaptiveBlockSize: " << this->AdaptiveBlockSize << "\n";
+  os << indent << "AdaptiveContourValue: "
+     << this->AdaptiveContourValue << "\n";
 }
 
 //----------------------------------------------------------------------------
@@ -20,6 +20,22 @@
 // create closed surfaces (in conjunction with the vtkContourFilter), capping
 // can be turned on to set a particular value on the boundaries of the sample
 // space.
+//
+// The implicit function is evaluated for a row of points at a time through
+// vtkImplicitFunction::FunctionValue(vtkDataArray *, vtkDataArray *), and
+// the slices of the volume can be split among several threads with
+// SetNumberOfThreads().  An adaptive mode first samples the function at the
+// corners of blocks of AdaptiveBlockSize voxels, and only samples every
+// voxel of the blocks that the AdaptiveContourValue level set may cross.
+// The other blocks are filled with the corner value nearest the contour
+// value, so they contour the same but do not hold the function values.
+//
+// .SECTION Caveats
+// In adaptive mode, a block is skipped when the function is on the same
+// side of the contour value at its corners, and the gradient at the
+// corners says that the level set is farther away than the block diagonal.
+// Features that are smaller than a block and that do not reach its
+// corners may be missed.
 
 // .SECTION See Also
 // vtkImplicitModeller
@@ -124,7 +140,36 @@ public:
   // "normals".
   vtkSetStringMacro(NormalArrayName);
   vtkGetStringMacro(NormalArrayName);
-  
+
+  // Description:
+  // Set the number of threads that evaluate the implicit function.  The
+  // default is one, because some implicit functions such as
+  // vtkImplicitDataSet and vtkImplicitVolume cannot be evaluated from
+  // several threads at once.  The analytic functions and their
+  // vtkImplicitBoolean combinations can.
+  vtkSetClampMacro(NumberOfThreads,int,1,VTK_MAX_THREADS);
+  vtkGetMacro(NumberOfThreads,int);
+
+  // Description:
+  // Turn on/off adaptive sampling.  When it is on, only the blocks of
+  // voxels that the AdaptiveContourValue level set may cross are sampled
+  // at every voxel.  It is off by default.
+  vtkSetMacro(AdaptiveSampling,int);
+  vtkGetMacro(AdaptiveSampling,int);
+  vtkBooleanMacro(AdaptiveSampling,int);
+
+  // Description:
+  // Set the number of voxel spacings along each side of the blocks of the
+  // adaptive sampling.  The default is 8.
+  vtkSetClampMacro(AdaptiveBlockSize,int,2,256);
+  vtkGetMacro(AdaptiveBlockSize,int);
+
+  // Description:
+  // Set the level set that adaptive sampling refines around, usually the
+  // value that the output will be contoured at.  The default is 0.
+  vtkSetMacro(AdaptiveContourValue,double);
+  vtkGetMacro(AdaptiveContourValue,double);
+
   // Description:
   // Return the MTime also considering the implicit function.
   unsigned long GetMTime();
@@ -135,7 +180,8 @@ protected:
   // Construct with ModelBounds=(-1,1,-1,1,-1,1), SampleDimensions=(50,50,50),
   // Capping turned off, CapValue=VTK_DOUBLE_MAX, normal generation on,
   // OutputScalarType set to VTK_DOUBLE, ImplicitFunction set to NULL,
-  // ScalarArrayName is "" and NormalArrayName is "".
+  // ScalarArrayName is "" and NormalArrayName is "", one thread and
+  // adaptive sampling off with blocks of 8 voxels around the value 0.
   vtkSampleFunction();
   
   ~vtkSampleFunction();
@@ -157,7 +203,11 @@ protected:
   int ComputeNormals;
   char *ScalarArrayName;
   char *NormalArrayName;
-  
+  int NumberOfThreads;
+  int AdaptiveSampling;
+  int AdaptiveBlockSize;
+  double AdaptiveContourValue;
+
 private:
   vtkSampleFunction(const vtkSampleFunction&);  // Not implemented.
   void operator=(const vtkSampleFunction&);  // Not implemented.
@@ -19,9 +19,13 @@
 #include "vtkMath.h"
 #include "vtkInformation.h"
 #include "vtkInformationVector.h"
+#include "vtkMultiThreader.h"
 #include "vtkObjectFactory.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
 #include "vtkPointData.h"
+#include "vtkPointSet.h"
+#include "vtkPoints.h"
+#include "vtkSplatBucketsInternals.h"
 
 vtkStandardNewMacro(vtkShepardMethod);
 
@@ -134,6 +138,187 @@ int vtkShepardMethod::RequestInformation (
   return 1;
 }
 
+//----------------------------------------------------------------------------
+// The resampling of the points into slabs of the output, one per thread.
+class vtkShepardMethodWorker
+{
+public:
+  vtkShepardMethod *Self;
+  vtkDataSet *Input;
+  vtkPoints *Points;
+  vtkDataArray *InScalars;
+  vtkSplatBuckets *Buckets;
+  vtkIdType NumberOfPoints;
+  float *Scalars;
+  double *Sum;
+  int Dimensions[3];
+  double Origin[3];
+  double Spacing[3];
+  double MaximumDistance;
+  double NullValue;
+
+  // vtkImageData::GetPoint() is not reentrant, so the threads read the
+  // points of datasets that are not vtkPointSets from a copy.
+  void GetPoint(vtkIdType ptId, double p[3])
+    {
+    if (this->Points)
+      {
+      this->Points->GetPoint(ptId, p);
+      }
+    else
+      {
+      this->Input->GetPoint(ptId, p);
+      }
+    }
+
+  // The range of voxels within the maximum distance of a point
+  void Footprint(const double px[3], int min[3], int max[3])
+    {
+    for (int i=0; i<3; i++) //compute dimensional bounds in data set
+      {
+      min[i] = static_cast<int>(static_cast<double>(
+        (px[i] - this->MaximumDistance) - this->Origin[i]) / this->Spacing[i]);
+      max[i] = static_cast<int>(static_cast<double>(
+        (px[i] + this->MaximumDistance) - this->Origin[i]) / this->Spacing[i]);
+      if (min[i] < 0)
+        {
+        min[i] = 0;
+        }
+      if (max[i] >= this->Dimensions[i]) 
+        {
+        max[i] = this->Dimensions[i] - 1;
+        }
+      }
+    }
+
+  void SplatPoint(vtkIdType ptId, int kMin, int kMax);
+
+  void Execute(int threadId);
+
+  static VTK_THREAD_RETURN_TYPE ThreadedExecute(void *arg)
+    {
+    vtkMultiThreader::ThreadInfo *info =
+      static_cast<vtkMultiThreader::ThreadInfo *>(arg);
+    vtkShepardMethodWorker *self =
+      static_cast<vtkShepardMethodWorker *>(info->UserData);
+    self->Execute(info->ThreadID);
+    return VTK_THREAD_RETURN_VALUE;
+    }
+};
+
+//----------------------------------------------------------------------------
+// Add the inverse distance weighted value of one point to the voxels of
+// the slices kMin to kMax that are within the maximum distance.
+void vtkShepardMethodWorker::SplatPoint(vtkIdType ptId, int kMin, int kMax)
+{
+  double px[3], x[3], distance2;
+  int i, j, k, min[3], max[3];
+
+  this->GetPoint(ptId, px);
+  double inScalar = this->InScalars->GetComponent(ptId,0);
+  this->Footprint(px, min, max);
+  min[2] = (min[2] < kMin ? kMin : min[2]);
+  max[2] = (max[2] > kMax ? kMax : max[2]);
+
+  vtkIdType jkFactor =
+    static_cast<vtkIdType>(this->Dimensions[0])*this->Dimensions[1];
+  for (k = min[2]; k <= max[2]; k++) 
+    {
+    x[2] = this->Spacing[2] * k + this->Origin[2];
+    for (j = min[1]; j <= max[1]; j++)
+      {
+      x[1] = this->Spacing[1] * j + this->Origin[1];
+      vtkIdType idx = jkFactor*k + this->Dimensions[0]*j + min[0];
+      for (i = min[0]; i <= max[0]; i++, idx++) 
+        {
+        x[0] = this->Spacing[0] * i + this->Origin[0];
+
+        distance2 = vtkMath::Distance2BetweenPoints(x,px);
+
+        if ( distance2 == 0.0 )
+          {
+          this->Sum[idx] = VTK_DOUBLE_MAX;
+          this->Scalars[idx] = VTK_FLOAT_MAX;
+          }
+        else
+          {
+          this->Sum[idx] += 1.0 / distance2;
+          this->Scalars[idx] = static_cast<float>(
+            this->Scalars[idx] + inScalar/distance2);
+          }
+        }
+      }
+    }
+}
+
+//----------------------------------------------------------------------------
+// Initialize the slab of a thread, resample the points of its bucket into
+// it and compute its final values.  Without buckets, there is one slab
+// that holds all the points.
+void vtkShepardMethodWorker::Execute(int threadId)
+{
+  int kMin = 0;
+  int kMax = this->Dimensions[2] - 1;
+  const vtkIdType *ids = NULL;
+  vtkIdType numIds = this->NumberOfPoints;
+  if (this->Buckets)
+    {
+    kMin = this->Buckets->GetSlabStart(threadId);
+    kMax = this->Buckets->GetSlabStart(threadId + 1) - 1;
+    ids = this->Buckets->GetIds(threadId);
+    numIds = this->Buckets->GetNumberOfIds(threadId);
+    }
+  if (kMin > kMax)
+    {
+    return;
+    }
+
+  vtkIdType idx;
+  vtkIdType jkFactor =
+    static_cast<vtkIdType>(this->Dimensions[0])*this->Dimensions[1];
+  vtkIdType idxBegin = kMin*jkFactor;
+  vtkIdType idxEnd = (kMax + 1)*jkFactor;
+  for (idx = idxBegin; idx < idxEnd; idx++)
+    {
+    this->Scalars[idx] = 0.0;
+    this->Sum[idx] = 0.0;
+    }
+
+  // Traverse the input points. 
+  // Each input point affects voxels within maxDistance.
+  //
+  int abortExecute=0;
+  vtkIdType progressInterval = numIds/20 + 1;
+  for (vtkIdType i = 0; i < numIds && !abortExecute; i++)
+    {
+    if ( ! (i % progressInterval) )
+      {
+      if (threadId == 0)
+        {
+        this->Self->UpdateProgress(static_cast<double>(i)/numIds);
+        }
+      abortExecute = this->Self->GetAbortExecute();
+      }
+    this->SplatPoint((ids ? ids[i] : i), kMin, kMax);
+    }
+
+  // Run through scalars and compute final values
+  //
+  for (idx = idxBegin; idx < idxEnd; idx++)
+    {
+    if ( this->Sum[idx] != 0.0 )
+      {
+      this->Scalars[idx] = static_cast<float>(
+        this->Scalars[idx]/this->Sum[idx]);
+      }
+    else
+      {
+      this->Scalars[idx] = static_cast<float>(this->NullValue);
+      }
+    }
+}
+
+//----------------------------------------------------------------------------
 int vtkShepardMethod::RequestData(
   vtkInformation* vtkNotUsed( request ),
   vtkInformationVector** inputVector,
@@ -154,15 +339,13 @@ int vtkShepardMethod::RequestData(
   output->SetExtent(output->GetWholeExtent());
   output->AllocateScalars();
   
-  vtkIdType ptId, i;
-  int j, k;
-  double *px, x[3], s, *sum, spacing[3], origin[3];
+  vtkIdType ptId;
+  int i, min[3], max[3];
+  double px[3], spacing[3], origin[3];
   
-  double maxDistance, distance2, inScalar;
+  double maxDistance;
   vtkDataArray *inScalars;
-  vtkIdType numPts, numNewPts, idx;
-  int min[3], max[3];
-  int jkFactor;
+  vtkIdType numPts, numNewPts;
   vtkFloatArray *newScalars = 
     vtkFloatArray::SafeDownCast(output->GetPointData()->GetScalars());
 
@@ -189,124 +372,90 @@ int vtkShepardMethod::RequestData(
   numNewPts = this->SampleDimensions[0] * this->SampleDimensions[1] 
               * this->SampleDimensions[2];
 
-  sum = new double[numNewPts];
-  for (i=0; i<numNewPts; i++) 
-    {
-    newScalars->SetComponent(i,0,0.0);
-    sum[i] = 0.0;
-    }
+  double *sum = new double[numNewPts];
 
   maxDistance = this->ComputeModelBounds(origin,spacing);
   outInfo->Set(vtkDataObject::ORIGIN(),origin,3);
   outInfo->Set(vtkDataObject::SPACING(),spacing,3);
 
+  vtkShepardMethodWorker worker;
+  worker.Self = this;
+  worker.Input = input;
+  worker.Points = NULL;
+  worker.InScalars = inScalars;
+  worker.Buckets = NULL;
+  worker.NumberOfPoints = numPts;
+  worker.Scalars = newScalars->GetPointer(0);
+  worker.Sum = sum;
+  worker.MaximumDistance = maxDistance;
+  worker.NullValue = this->NullValue;
+  for (i=0; i<3; i++)
+    {
+    worker.Dimensions[i] = this->SampleDimensions[i];
+    worker.Origin[i] = origin[i];
+    worker.Spacing[i] = spacing[i];
+    }
 
-  // Traverse all input points. 
-  // Each input point affects voxels within maxDistance.
+  // With several threads, the points are first sorted by the slabs of
+  // slices that they affect, and each thread resamples one slab.
   //
-  int abortExecute=0;
-  for (ptId=0; ptId < numPts && !abortExecute; ptId++)
+  vtkSplatBuckets buckets;
+  int numThreads = vtkMultiThreader::GetGlobalDefaultNumberOfThreads();
+  if (numThreads > this->SampleDimensions[2])
+    {
+    numThreads = this->SampleDimensions[2];
+    }
+  if (numThreads > 1)
     {
-    if ( ! (ptId % 1000) )
+    buckets.Initialize(this->SampleDimensions[2]);
+    for (ptId=0; ptId < numPts; ptId++)
       {
-      vtkDebugMacro(<<"Inserting point #" << ptId);
-      this->UpdateProgress (ptId/numPts);
-      if (this->GetAbortExecute())
-        {
-        abortExecute = 1;
-        break;
-        }
+      input->GetPoint(ptId, px);
+      worker.Footprint(px, min, max);
+      buckets.Count(min[2], max[2]);
       }
-
-    px = input->GetPoint(ptId);
-    inScalar = inScalars->GetComponent(ptId,0);
-    
-    for (i=0; i<3; i++) //compute dimensional bounds in data set
+    vtkIdType maxThreads =
+      buckets.GetNumberOfFootprintSlices() / VTK_SPLAT_SLICES_PER_THREAD;
+    if (maxThreads < numThreads)
       {
-      double amin = static_cast<double>(
-        (px[i] - maxDistance) - origin[i]) / spacing[i];
-      double amax = static_cast<double>(
-        (px[i] + maxDistance) - origin[i]) / spacing[i];
-      min[i] = static_cast<int>(amin);
-      max[i] = static_cast<int>(amax);
-      
-      if (min[i] < amin)
-        {
-        min[i]++; // round upward to nearest integer to get min[i]
-        }
-      if (max[i] > amax)
-        {
-        max[i]--; // round downward to nearest integer to get max[i]
-        }
-
-      if (min[i] < 0)
-        {
-        min[i] = 0; // valid range check
-        }
-      if (max[i] >= this->SampleDimensions[i]) 
-        {
-        max[i] = this->SampleDimensions[i] - 1;
-        }
+      numThreads = (maxThreads > 1 ? static_cast<int>(maxThreads) : 1);
       }
+    }
 
-    for (i=0; i<3; i++) //compute dimensional bounds in data set
+  if (numThreads == 1)
+    {
+    worker.Execute(0);
+    }
+  else
+    {
+    buckets.Partition(numThreads);
+    for (ptId=0; ptId < numPts; ptId++)
       {
-      min[i] = static_cast<int>(
-        static_cast<double>((px[i] - maxDistance) - origin[i]) / spacing[i]);
-      max[i] = static_cast<int>(
-        static_cast<double>((px[i] + maxDistance) - origin[i]) / spacing[i]);
-      if (min[i] < 0)
-        {
-        min[i] = 0;
-        }
-      if (max[i] >= this->SampleDimensions[i]) 
-        {
-        max[i] = this->SampleDimensions[i] - 1;
-        }
+      input->GetPoint(ptId, px);
+      worker.Footprint(px, min, max);
+      buckets.Insert(ptId, min[2], max[2]);
       }
-  
-    jkFactor = this->SampleDimensions[0]*this->SampleDimensions[1];
-    for (k = min[2]; k <= max[2]; k++) 
+    worker.Buckets = &buckets;
+    if (!vtkPointSet::SafeDownCast(input))
       {
-      x[2] = spacing[2] * k + origin[2];
-      for (j = min[1]; j <= max[1]; j++)
+      worker.Points = vtkPoints::New(VTK_DOUBLE);
+      worker.Points->SetNumberOfPoints(numPts);
+      for (ptId=0; ptId < numPts; ptId++)
         {
-        x[1] = spacing[1] * j + origin[1];
-        for (i = min[0]; i <= max[0]; i++) 
-          {
-          x[0] = spacing[0] * i + origin[0];
-          idx = jkFactor*k + this->SampleDimensions[0]*j + i;
-
-          distance2 = vtkMath::Distance2BetweenPoints(x,px);
-
-          if ( distance2 == 0.0 )
-            {
-            sum[idx] = VTK_DOUBLE_MAX;
-            newScalars->SetComponent(idx,0,VTK_FLOAT_MAX);
-            }
-          else
-            {
-            s = newScalars->GetComponent(idx,0);
-            sum[idx] += 1.0 / distance2;
-            newScalars->SetComponent(idx,0,s+(inScalar/distance2));
-            }
-          }
+        input->GetPoint(ptId, px);
+        worker.Points->SetPoint(ptId, px);
         }
       }
-    }
 
-  // Run through scalars and compute final values
-  //
-  for (ptId=0; ptId<numNewPts; ptId++)
-    {
-    s = newScalars->GetComponent(ptId,0);
-    if ( sum[ptId] != 0.0 )
-      {
-      newScalars->SetComponent(ptId,0,s/sum[ptId]);
-      }
-    else
+    vtkMultiThreader *threader = vtkMultiThreader::New();
+    threader->SetNumberOfThreads(numThreads);
+    threader->SetSingleMethod(vtkShepardMethodWorker::ThreadedExecute,
+                              &worker);
+    threader->SingleMethodExecute();
+    threader->Delete();
+    if (worker.Points)
       {
-      newScalars->SetComponent(ptId,0,this->NullValue);
+      worker.Points->Delete();
       }
     }
 
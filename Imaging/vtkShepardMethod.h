@@ -31,6 +31,12 @@
 // If you use a maximum distance less than 1.0, some output points may
 // never receive a contribution. The final value of these points can be 
 // specified with the "NullValue" instance variable.
+//
+// The points are resampled on the global default number of threads of
+// vtkMultiThreader.  The output is split into slabs of slices, and the
+// points are sorted by the slabs within their maximum distance, so that
+// each thread writes only into its own slab.  The result does not depend
+// on the number of threads.
 
 #ifndef __vtkShepardMethod_h
 #define __vtkShepardMethod_h
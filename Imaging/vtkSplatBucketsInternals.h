@@ -0,0 +1,175 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkSplatBucketsInternals.h
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// .NAME vtkSplatBucketsInternals - sort splatted points by output slab
+// .SECTION Description
+// Bucketing of the input points shared by vtkGaussianSplatter and
+// vtkShepardMethod.  The slices of the output volume are split into slabs,
+// one per thread, with about the same number of footprint slices in each,
+// and the ids of the points are sorted into one bucket per slab that their
+// footprint overlaps.  Each thread then splats its bucket into its own
+// slab, so no two threads write the same voxel.  The ids stay in
+// increasing order in each bucket, so every voxel receives its
+// contributions in the same order as on one thread.
+
+#ifndef __vtkSplatBucketsInternals_h
+#define __vtkSplatBucketsInternals_h
+
+#include "vtkType.h"
+
+#include <vtkstd/vector>
+
+// The minimum number of footprint slices that each thread splats.
+#define VTK_SPLAT_SLICES_PER_THREAD 256
+
+//--------------------------------------------------------------------------
+// Make all defined methods invisible outside current translation unit
+namespace {
+
+//--------------------------------------------------------------------------
+class vtkSplatBuckets
+{
+public:
+  // Start counting the footprints over numSlices slices.
+  void Initialize(int numSlices)
+    {
+    this->First.assign(numSlices, 0);
+    this->Last.assign(numSlices, 0);
+    this->NumberOfFootprintSlices = 0;
+    }
+
+  // Count a footprint that covers the slices kMin to kMax.
+  void Count(int kMin, int kMax)
+    {
+    if (kMin <= kMax)
+      {
+      this->First[kMin]++;
+      this->Last[kMax]++;
+      this->NumberOfFootprintSlices += kMax - kMin + 1;
+      }
+    }
+
+  // The number of slices covered by all the footprints counted.
+  vtkIdType GetNumberOfFootprintSlices()
+    {
+    return this->NumberOfFootprintSlices;
+    }
+
+  // Split the slices into numSlabs slabs that cover about the same number
+  // of footprint slices, and make room in the buckets for the points.
+  void Partition(int numSlabs)
+    {
+    int numSlices = static_cast<int>(this->First.size());
+    this->SlabStart.assign(numSlabs + 1, numSlices);
+    this->SliceSlab.resize(numSlices);
+    this->SlabStart[0] = 0;
+
+    // the footprints over slice k are those that start at or before k,
+    // less those that end before k
+    double total = static_cast<double>(this->NumberOfFootprintSlices);
+    vtkIdType started = 0;
+    vtkIdType ended = 0;
+    vtkIdType covered = 0;
+    int slab = 0;
+    for (int k = 0; k < numSlices; k++)
+      {
+      this->SliceSlab[k] = slab;
+      started += this->First[k];
+      covered += started - ended;
+      ended += this->Last[k];
+      while (slab < numSlabs - 1 &&
+             covered*static_cast<double>(numSlabs) >= total*(slab + 1))
+        {
+        this->SlabStart[++slab] = k + 1;
+        }
+      }
+
+    // the footprints that overlap a slab are those that start before its
+    // end, less those that end before its start
+    vtkIdType numIds = 0;
+    this->Offsets.resize(numSlabs + 1);
+    this->Offsets[0] = 0;
+    started = 0;
+    ended = 0;
+    int k = 0;
+    for (slab = 0; slab < numSlabs; slab++)
+      {
+      for (; k < this->SlabStart[slab]; k++)
+        {
+        ended += this->Last[k];
+        }
+      vtkIdType endedBefore = ended;
+      for (int kk = this->SlabStart[slab]; kk < this->SlabStart[slab+1]; kk++)
+        {
+        started += this->First[kk];
+        }
+      numIds += (this->SlabStart[slab] < this->SlabStart[slab+1] ?
+                 started - endedBefore : 0);
+      this->Offsets[slab + 1] = numIds;
+      }
+    this->Ids.resize(numIds);
+    this->Next.assign(this->Offsets.begin(), this->Offsets.end() - 1);
+
+    this->First.clear();
+    this->Last.clear();
+    }
+
+  // Add a point to the buckets of the slabs that its footprint overlaps.
+  // The points must be added in the order that they will be splatted.
+  void Insert(vtkIdType id, int kMin, int kMax)
+    {
+    if (kMin <= kMax)
+      {
+      int lastSlab = this->SliceSlab[kMax];
+      for (int slab = this->SliceSlab[kMin]; slab <= lastSlab; slab++)
+        {
+        if (this->SlabStart[slab] < this->SlabStart[slab + 1])
+          {
+          this->Ids[this->Next[slab]++] = id;
+          }
+        }
+      }
+    }
+
+  // The slices from GetSlabStart(slab) to GetSlabStart(slab+1)-1 form
+  // each slab.
+  int GetSlabStart(int slab)
+    {
+    return this->SlabStart[slab];
+    }
+
+  // The ids of the points whose footprints overlap a slab.
+  const vtkIdType *GetIds(int slab)
+    {
+    return (this->Ids.empty() ? NULL : &this->Ids[this->Offsets[slab]]);
+    }
+  vtkIdType GetNumberOfIds(int slab)
+    {
+    return this->Offsets[slab + 1] - this->Offsets[slab];
+    }
+
+private:
+  vtkstd::vector<vtkIdType> First;
+  vtkstd::vector<vtkIdType> Last;
+  vtkIdType NumberOfFootprintSlices;
+  vtkstd::vector<int> SlabStart;
+  vtkstd::vector<int> SliceSlab;
+  vtkstd::vector<vtkIdType> Offsets;
+  vtkstd::vector<vtkIdType> Next;
+  vtkstd::vector<vtkIdType> Ids;
+};
+
+} // end anonymous namespace
+
+#endif